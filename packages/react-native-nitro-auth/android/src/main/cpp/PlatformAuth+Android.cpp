@@ -2,21 +2,27 @@
 #include "AuthUser.hpp"
 #include "AuthTokens.hpp"
 #include "AuthCache.hpp"
+#include "AuthResult.hpp"
+#include "MicrosoftAuthority.hpp"
 #include "MicrosoftPrompt.hpp"
 #include <fbjni/fbjni.h>
 #include <NitroModules/NitroLogger.hpp>
 #include <NitroModules/Promise.hpp>
+#include <atomic>
 #include <exception>
+#include <limits>
 #include <stdexcept>
+#include <unordered_map>
 
 namespace margelo::nitro::NitroAuth {
 
 using namespace facebook::jni;
 
-static std::shared_ptr<Promise<AuthUser>> gLoginPromise;
-static std::shared_ptr<Promise<AuthUser>> gScopesPromise;
-static std::shared_ptr<Promise<AuthTokens>> gRefreshPromise;
-static std::shared_ptr<Promise<std::optional<AuthUser>>> gSilentPromise;
+static std::shared_ptr<Promise<Result<AuthUser>>> gLoginPromise;
+static std::shared_ptr<Promise<Result<AuthUser>>> gScopesPromise;
+static std::shared_ptr<Promise<Result<AuthTokens>>> gRefreshPromise;
+static std::shared_ptr<Promise<Result<std::optional<AuthUser>>>> gSilentPromise;
+static std::shared_ptr<Promise<Result<std::string>>> gBrowserPromise;
 static std::mutex gMutex;
 static jclass gAuthAdapterClass = nullptr;
 static jmethodID gLoginMethod = nullptr;
@@ -26,6 +32,15 @@ static jmethodID gRestoreMethod = nullptr;
 static jmethodID gHasPlayMethod = nullptr;
 static jmethodID gLogoutMethod = nullptr;
 static jmethodID gRevokeAccessMethod = nullptr;
+static jmethodID gDiscoveryAuthoritiesMethod = nullptr;
+static jmethodID gCacheDirectoryMethod = nullptr;
+static jmethodID gHttpRequestMethod = nullptr;
+static jmethodID gAuthorizeInBrowserMethod = nullptr;
+
+// In-flight native HTTP requests, answered by nativeOnHttpResponse.
+static std::mutex gHttpMutex;
+static std::unordered_map<jlong, HttpClient::Completion> gHttpRequests;
+static std::atomic<jlong> gNextHttpRequestId{1};
 
 // Call from JNI_OnUnload or dispose to prevent stale refs after a module reload.
 static void clearCachedJniRefs(JNIEnv* env) {
@@ -40,13 +55,19 @@ static void clearCachedJniRefs(JNIEnv* env) {
     gHasPlayMethod = nullptr;
     gLogoutMethod = nullptr;
     gRevokeAccessMethod = nullptr;
+    gDiscoveryAuthoritiesMethod = nullptr;
+    gCacheDirectoryMethod = nullptr;
+    gHttpRequestMethod = nullptr;
+    gAuthorizeInBrowserMethod = nullptr;
 }
 
 static void ensureAuthAdapterMethods(JNIEnv* env) {
     if (gAuthAdapterClass != nullptr && gLoginMethod != nullptr
         && gRequestScopesMethod != nullptr && gRefreshMethod != nullptr
         && gRestoreMethod != nullptr && gHasPlayMethod != nullptr
-        && gLogoutMethod != nullptr && gRevokeAccessMethod != nullptr) {
+        && gLogoutMethod != nullptr && gRevokeAccessMethod != nullptr
+        && gDiscoveryAuthoritiesMethod != nullptr && gCacheDirectoryMethod != nullptr
+        && gHttpRequestMethod != nullptr && gAuthorizeInBrowserMethod != nullptr) {
         return;
     }
 
@@ -77,7 +98,7 @@ static void ensureAuthAdapterMethods(JNIEnv* env) {
         gRefreshMethod = env->GetStaticMethodID(
             gAuthAdapterClass,
             "refreshTokenSync",
-            "(Landroid/content/Context;)V"
+            "(Landroid/content/Context;Ljava/lang/String;[Ljava/lang/String;)V"
         );
     }
     if (gRestoreMethod == nullptr) {
@@ -108,20 +129,141 @@ static void ensureAuthAdapterMethods(JNIEnv* env) {
             "(Landroid/content/Context;)V"
         );
     }
+    if (gDiscoveryAuthoritiesMethod == nullptr) {
+        gDiscoveryAuthoritiesMethod = env->GetStaticMethodID(
+            gAuthAdapterClass,
+            "discoveryAuthorities",
+            "(Landroid/content/Context;)[Ljava/lang/String;"
+        );
+    }
+    if (gCacheDirectoryMethod == nullptr) {
+        gCacheDirectoryMethod = env->GetStaticMethodID(
+            gAuthAdapterClass,
+            "cacheDirectory",
+            "(Landroid/content/Context;)Ljava/lang/String;"
+        );
+    }
+    if (gHttpRequestMethod == nullptr) {
+        gHttpRequestMethod = env->GetStaticMethodID(
+            gAuthAdapterClass,
+            "httpRequest",
+            "(JLjava/lang/String;Ljava/lang/String;[Ljava/lang/String;[Ljava/lang/String;Ljava/lang/String;J)V"
+        );
+    }
+    if (gAuthorizeInBrowserMethod == nullptr) {
+        gAuthorizeInBrowserMethod = env->GetStaticMethodID(
+            gAuthAdapterClass,
+            "authorizeInBrowser",
+            "(Landroid/content/Context;Ljava/lang/String;Ljava/lang/String;)V"
+        );
+    }
+}
+
+static jobjectArray toJavaStringArray(JNIEnv* env, const std::vector<std::string>& values) {
+    if (values.size() > static_cast<size_t>(std::numeric_limits<jsize>::max())) {
+        throw std::length_error("too many strings for a Java array");
+    }
+    jclass stringClass = env->FindClass("java/lang/String");
+    jobjectArray array = env->NewObjectArray(static_cast<jsize>(values.size()), stringClass, nullptr);
+    for (size_t i = 0; i < values.size(); i++) {
+        jstring value = env->NewStringUTF(values[i].c_str());
+        env->SetObjectArrayElement(array, static_cast<jsize>(i), value);
+        env->DeleteLocalRef(value);
+    }
+    env->DeleteLocalRef(stringClass);
+    return array;
+}
+
+static std::vector<std::string> fromJavaStringArray(JNIEnv* env, jobjectArray array) {
+    std::vector<std::string> values;
+    if (!array) return values;
+    const jsize length = env->GetArrayLength(array);
+    values.reserve(static_cast<size_t>(length));
+    for (jsize i = 0; i < length; i++) {
+        auto value = static_cast<jstring>(env->GetObjectArrayElement(array, i));
+        const char* chars = env->GetStringUTFChars(value, nullptr);
+        values.emplace_back(chars);
+        env->ReleaseStringUTFChars(value, chars);
+        env->DeleteLocalRef(value);
+    }
+    return values;
 }
 
-std::shared_ptr<Promise<AuthUser>> PlatformAuth::login(AuthProvider provider, const std::optional<LoginOptions>& options) {
-    auto promise = Promise<AuthUser>::create();
+// Forwards to AuthAdapter.httpRequest (HttpURLConnection on the adapter's IO scope).
+class AndroidHttpClient final : public HttpClient {
+public:
+    void send(const HttpRequest& request, Completion completion) override {
+        // Callers include the timer thread, which may not be attached to the JVM yet.
+        ThreadScope scope;
+        JNIEnv* env = Environment::current();
+        try {
+            ensureAuthAdapterMethods(env);
+        } catch (...) {
+            completion(HttpResponse{});
+            return;
+        }
+
+        const jlong requestId = gNextHttpRequestId++;
+        {
+            std::lock_guard<std::mutex> lock(gHttpMutex);
+            gHttpRequests.emplace(requestId, std::move(completion));
+        }
+
+        std::vector<std::string> names;
+        std::vector<std::string> values;
+        for (const auto& [name, value] : request.headers) {
+            names.push_back(name);
+            values.push_back(value);
+        }
+        jstring jMethod = env->NewStringUTF(request.method.c_str());
+        jstring jUrl = env->NewStringUTF(request.url.c_str());
+        jobjectArray jNames = toJavaStringArray(env, names);
+        jobjectArray jValues = toJavaStringArray(env, values);
+        jstring jBody = request.body.empty() ? nullptr : env->NewStringUTF(request.body.c_str());
+        env->CallStaticVoidMethod(gAuthAdapterClass, gHttpRequestMethod, requestId, jMethod, jUrl, jNames, jValues, jBody,
+                                  static_cast<jlong>(request.timeoutMs));
+        const bool failed = env->ExceptionCheck();
+        if (failed) {
+            env->ExceptionDescribe();
+            env->ExceptionClear();
+        }
+        env->DeleteLocalRef(jMethod);
+        env->DeleteLocalRef(jUrl);
+        env->DeleteLocalRef(jNames);
+        env->DeleteLocalRef(jValues);
+        if (jBody) env->DeleteLocalRef(jBody);
+
+        if (failed) {
+            HttpClient::Completion pending;
+            {
+                std::lock_guard<std::mutex> lock(gHttpMutex);
+                auto it = gHttpRequests.find(requestId);
+                if (it == gHttpRequests.end()) return;
+                pending = std::move(it->second);
+                gHttpRequests.erase(it);
+            }
+            pending(HttpResponse{});
+        }
+    }
+};
+
+std::shared_ptr<Promise<Result<AuthUser>>> PlatformAuth::login(AuthProvider provider, const std::optional<LoginOptions>& options) {
+    auto promise = Promise<Result<AuthUser>>::create();
+    // Generic OIDC runs in the core; only authorizeInBrowser() reaches the platform.
+    if (provider == AuthProvider::OIDC) {
+        promise->resolve(AuthErrorCode::UNSUPPORTED_PROVIDER);
+        return promise;
+    }
     auto contextPtr = static_cast<jobject>(AuthCache::getAndroidContext());
     if (!contextPtr) {
-        promise->reject(std::make_exception_ptr(std::runtime_error("Android Context not initialized")));
+        promise->resolve(AuthError("Android Context not initialized"));
         return promise;
     }
 
     {
         std::lock_guard<std::mutex> lock(gMutex);
         if (gLoginPromise) {
-            promise->reject(std::make_exception_ptr(std::runtime_error("operation_in_progress")));
+            promise->resolve(AuthErrorCode::OPERATION_IN_PROGRESS);
             return promise;
         }
         gLoginPromise = promise;
@@ -132,6 +274,7 @@ std::shared_ptr<Promise<AuthUser>> PlatformAuth::login(AuthProvider provider, co
         case AuthProvider::GOOGLE: providerStr = "google"; break;
         case AuthProvider::APPLE: providerStr = "apple"; break;
         case AuthProvider::MICROSOFT: providerStr = "microsoft"; break;
+        case AuthProvider::OIDC: break;
     }
     
     std::vector<std::string> scopes = {"email", "profile"};
@@ -172,22 +315,18 @@ std::shared_ptr<Promise<AuthUser>> PlatformAuth::login(AuthProvider provider, co
     }
 
     JNIEnv* env = Environment::current();
+    jobjectArray jScopes = nullptr;
     try {
         ensureAuthAdapterMethods(env);
-    } catch (...) {
+        jScopes = toJavaStringArray(env, scopes);
+    } catch (const std::exception& e) {
         {
             std::lock_guard<std::mutex> lock(gMutex);
             gLoginPromise = nullptr;
         }
-        promise->reject(std::current_exception());
+        promise->resolve(AuthError(e.what()));
         return promise;
     }
-    jclass stringClass = env->FindClass("java/lang/String");
-    jobjectArray jScopes = env->NewObjectArray(scopes.size(), stringClass, nullptr);
-    for (size_t i = 0; i < scopes.size(); i++) {
-        auto jstr = make_jstring(scopes[i]);
-        env->SetObjectArrayElement(jScopes, i, jstr.get());
-    }
 
     local_ref<JString> providerRef = make_jstring(providerStr);
     local_ref<JString> loginHintRef;
@@ -235,7 +374,6 @@ std::shared_ptr<Promise<AuthUser>> PlatformAuth::login(AuthProvider provider, co
         openIDRealmRef.get());
 
     env->DeleteLocalRef(jScopes);
-    env->DeleteLocalRef(stringClass);
 
     if (env->ExceptionCheck()) {
         env->ExceptionDescribe();
@@ -244,51 +382,46 @@ std::shared_ptr<Promise<AuthUser>> PlatformAuth::login(AuthProvider provider, co
             std::lock_guard<std::mutex> lock(gMutex);
             gLoginPromise = nullptr;
         }
-        promise->reject(std::make_exception_ptr(std::runtime_error("JNI call failed")));
+        promise->resolve(AuthError("JNI call failed"));
         return promise;
     }
 
     return promise;
 }
 
-std::shared_ptr<Promise<AuthUser>> PlatformAuth::requestScopes(const std::vector<std::string>& scopes) {
-    auto promise = Promise<AuthUser>::create();
+std::shared_ptr<Promise<Result<AuthUser>>> PlatformAuth::requestScopes(const std::vector<std::string>& scopes) {
+    auto promise = Promise<Result<AuthUser>>::create();
     auto contextPtr = static_cast<jobject>(AuthCache::getAndroidContext());
     if (!contextPtr) {
-        promise->reject(std::make_exception_ptr(std::runtime_error("Android Context not initialized")));
+        promise->resolve(AuthError("Android Context not initialized"));
         return promise;
     }
     
     {
         std::lock_guard<std::mutex> lock(gMutex);
         if (gScopesPromise) {
-            promise->reject(std::make_exception_ptr(std::runtime_error("operation_in_progress")));
+            promise->resolve(AuthErrorCode::OPERATION_IN_PROGRESS);
             return promise;
         }
         gScopesPromise = promise;
     }
     
     JNIEnv* env = Environment::current();
+    jobjectArray jScopes = nullptr;
     try {
         ensureAuthAdapterMethods(env);
-    } catch (...) {
+        jScopes = toJavaStringArray(env, scopes);
+    } catch (const std::exception& e) {
         {
             std::lock_guard<std::mutex> lock(gMutex);
             gScopesPromise = nullptr;
         }
-        promise->reject(std::current_exception());
+        promise->resolve(AuthError(e.what()));
         return promise;
     }
-    jclass stringClass = env->FindClass("java/lang/String");
-    jobjectArray jScopes = env->NewObjectArray(scopes.size(), stringClass, nullptr);
-    for (size_t i = 0; i < scopes.size(); i++) {
-        auto jstr = make_jstring(scopes[i]);
-        env->SetObjectArrayElement(jScopes, i, jstr.get());
-    }
 
     env->CallStaticVoidMethod(gAuthAdapterClass, gRequestScopesMethod, contextPtr, jScopes);
     env->DeleteLocalRef(jScopes);
-    env->DeleteLocalRef(stringClass);
 
     if (env->ExceptionCheck()) {
         env->ExceptionDescribe();
@@ -297,43 +430,61 @@ std::shared_ptr<Promise<AuthUser>> PlatformAuth::requestScopes(const std::vector
             std::lock_guard<std::mutex> lock(gMutex);
             gScopesPromise = nullptr;
         }
-        promise->reject(std::make_exception_ptr(std::runtime_error("JNI call failed")));
+        promise->resolve(AuthError("JNI call failed"));
         return promise;
     }
 
     return promise;
 }
 
-std::shared_ptr<Promise<AuthTokens>> PlatformAuth::refreshToken() {
-    auto promise = Promise<AuthTokens>::create();
+std::shared_ptr<Promise<Result<AuthTokens>>> PlatformAuth::refreshToken(const std::optional<AuthProvider>& provider,
+                                                                        const std::vector<std::string>& scopes) {
+    auto promise = Promise<Result<AuthTokens>>::create();
+    if (provider == AuthProvider::OIDC) {
+        promise->resolve(AuthErrorCode::UNSUPPORTED_PROVIDER);
+        return promise;
+    }
     auto contextPtr = static_cast<jobject>(AuthCache::getAndroidContext());
     if (!contextPtr) {
-        promise->reject(std::make_exception_ptr(std::runtime_error("Android Context not initialized")));
+        promise->resolve(AuthError("Android Context not initialized"));
         return promise;
     }
     
     {
         std::lock_guard<std::mutex> lock(gMutex);
         if (gRefreshPromise) {
-            promise->reject(std::make_exception_ptr(std::runtime_error("operation_in_progress")));
+            promise->resolve(AuthErrorCode::OPERATION_IN_PROGRESS);
             return promise;
         }
         gRefreshPromise = promise;
     }
     
     JNIEnv* env = Environment::current();
+    jobjectArray jScopes = nullptr;
     try {
         ensureAuthAdapterMethods(env);
-    } catch (...) {
+        // null asks for the session token.
+        if (!scopes.empty()) jScopes = toJavaStringArray(env, scopes);
+    } catch (const std::exception& e) {
         {
             std::lock_guard<std::mutex> lock(gMutex);
             gRefreshPromise = nullptr;
         }
-        promise->reject(std::current_exception());
+        promise->resolve(AuthError(e.what()));
         return promise;
     }
 
-    env->CallStaticVoidMethod(gAuthAdapterClass, gRefreshMethod, contextPtr);
+    local_ref<JString> providerRef;
+    if (provider) {
+        switch (*provider) {
+            case AuthProvider::GOOGLE: providerRef = make_jstring("google"); break;
+            case AuthProvider::APPLE: providerRef = make_jstring("apple"); break;
+            case AuthProvider::MICROSOFT: providerRef = make_jstring("microsoft"); break;
+            case AuthProvider::OIDC: break;
+        }
+    }
+    env->CallStaticVoidMethod(gAuthAdapterClass, gRefreshMethod, contextPtr, providerRef.get(), jScopes);
+    if (jScopes) env->DeleteLocalRef(jScopes);
 
     if (env->ExceptionCheck()) {
         env->ExceptionDescribe();
@@ -342,25 +493,25 @@ std::shared_ptr<Promise<AuthTokens>> PlatformAuth::refreshToken() {
             std::lock_guard<std::mutex> lock(gMutex);
             gRefreshPromise = nullptr;
         }
-        promise->reject(std::make_exception_ptr(std::runtime_error("JNI call failed")));
+        promise->resolve(AuthError("JNI call failed"));
         return promise;
     }
 
     return promise;
 }
 
-std::shared_ptr<Promise<std::optional<AuthUser>>> PlatformAuth::silentRestore() {
-    auto promise = Promise<std::optional<AuthUser>>::create();
+std::shared_ptr<Promise<Result<std::optional<AuthUser>>>> PlatformAuth::silentRestore() {
+    auto promise = Promise<Result<std::optional<AuthUser>>>::create();
     auto contextPtr = static_cast<jobject>(AuthCache::getAndroidContext());
     if (!contextPtr) {
-        promise->resolve(std::nullopt);
+        promise->resolve(std::optional<AuthUser>());
         return promise;
     }
 
     {
         std::lock_guard<std::mutex> lock(gMutex);
         if (gSilentPromise) {
-            promise->reject(std::make_exception_ptr(std::runtime_error("operation_in_progress")));
+            promise->resolve(AuthErrorCode::OPERATION_IN_PROGRESS);
             return promise;
         }
         gSilentPromise = promise;
@@ -369,12 +520,12 @@ std::shared_ptr<Promise<std::optional<AuthUser>>> PlatformAuth::silentRestore()
     JNIEnv* env = Environment::current();
     try {
         ensureAuthAdapterMethods(env);
-    } catch (...) {
+    } catch (const std::exception& e) {
         {
             std::lock_guard<std::mutex> lock(gMutex);
             gSilentPromise = nullptr;
         }
-        promise->reject(std::current_exception());
+        promise->resolve(AuthError(e.what()));
         return promise;
     }
 
@@ -387,7 +538,7 @@ std::shared_ptr<Promise<std::optional<AuthUser>>> PlatformAuth::silentRestore()
             std::lock_guard<std::mutex> lock(gMutex);
             gSilentPromise = nullptr;
         }
-        promise->reject(std::make_exception_ptr(std::runtime_error("JNI call failed")));
+        promise->resolve(AuthError("JNI call failed"));
         return promise;
     }
 
@@ -416,6 +567,107 @@ bool PlatformAuth::hasPlayServices() {
     return result;
 }
 
+std::shared_ptr<Promise<Result<std::string>>> PlatformAuth::authorizeInBrowser(const std::string& url,
+                                                                               const std::string& redirectUri) {
+    auto promise = Promise<Result<std::string>>::create();
+    auto contextPtr = static_cast<jobject>(AuthCache::getAndroidContext());
+    if (!contextPtr) {
+        promise->resolve(AuthError("Android Context not initialized"));
+        return promise;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(gMutex);
+        if (gBrowserPromise) {
+            promise->resolve(AuthErrorCode::OPERATION_IN_PROGRESS);
+            return promise;
+        }
+        gBrowserPromise = promise;
+    }
+
+    JNIEnv* env = Environment::current();
+    try {
+        ensureAuthAdapterMethods(env);
+    } catch (const std::exception& e) {
+        {
+            std::lock_guard<std::mutex> lock(gMutex);
+            gBrowserPromise = nullptr;
+        }
+        promise->resolve(AuthError(e.what()));
+        return promise;
+    }
+
+    auto urlRef = make_jstring(url);
+    auto redirectUriRef = make_jstring(redirectUri);
+    env->CallStaticVoidMethod(gAuthAdapterClass, gAuthorizeInBrowserMethod, contextPtr, urlRef.get(), redirectUriRef.get());
+
+    if (env->ExceptionCheck()) {
+        env->ExceptionDescribe();
+        env->ExceptionClear();
+        {
+            std::lock_guard<std::mutex> lock(gMutex);
+            gBrowserPromise = nullptr;
+        }
+        promise->resolve(AuthError("JNI call failed"));
+        return promise;
+    }
+
+    return promise;
+}
+
+std::shared_ptr<HttpClient> PlatformAuth::httpClient() {
+    static auto client = std::make_shared<AndroidHttpClient>();
+    return client;
+}
+
+std::string PlatformAuth::cacheDirectory() {
+    auto contextPtr = static_cast<jobject>(AuthCache::getAndroidContext());
+    if (!contextPtr) return "";
+
+    JNIEnv* env = Environment::current();
+    try {
+        ensureAuthAdapterMethods(env);
+    } catch (...) {
+        return "";
+    }
+
+    auto directory = static_cast<jstring>(env->CallStaticObjectMethod(gAuthAdapterClass, gCacheDirectoryMethod, contextPtr));
+    if (env->ExceptionCheck()) {
+        env->ExceptionDescribe();
+        env->ExceptionClear();
+        return "";
+    }
+    if (!directory) return "";
+    const char* chars = env->GetStringUTFChars(directory, nullptr);
+    std::string result(chars);
+    env->ReleaseStringUTFChars(directory, chars);
+    env->DeleteLocalRef(directory);
+    return result;
+}
+
+std::vector<std::string> PlatformAuth::discoveryAuthorities() {
+    auto contextPtr = static_cast<jobject>(AuthCache::getAndroidContext());
+    if (!contextPtr) return {};
+
+    JNIEnv* env = Environment::current();
+    try {
+        ensureAuthAdapterMethods(env);
+    } catch (...) {
+        return {};
+    }
+
+    auto authorities = static_cast<jobjectArray>(
+        env->CallStaticObjectMethod(gAuthAdapterClass, gDiscoveryAuthoritiesMethod, contextPtr));
+    if (env->ExceptionCheck()) {
+        env->ExceptionDescribe();
+        env->ExceptionClear();
+        return {};
+    }
+    auto result = fromJavaStringArray(env, authorities);
+    if (authorities) env->DeleteLocalRef(authorities);
+    return result;
+}
+
 void PlatformAuth::logout() {
     auto contextPtr = static_cast<jobject>(AuthCache::getAndroidContext());
     if (!contextPtr) return;
@@ -435,19 +687,19 @@ void PlatformAuth::logout() {
     }
 }
 
-std::shared_ptr<Promise<void>> PlatformAuth::revokeAccess() {
-    auto promise = Promise<void>::create();
+std::shared_ptr<Promise<Result<void>>> PlatformAuth::revokeAccess() {
+    auto promise = Promise<Result<void>>::create();
     auto contextPtr = static_cast<jobject>(AuthCache::getAndroidContext());
     if (!contextPtr) {
-        promise->resolve();
+        promise->resolve(Result<void>());
         return promise;
     }
 
     JNIEnv* env = Environment::current();
     try {
         ensureAuthAdapterMethods(env);
-    } catch (...) {
-        promise->reject(std::current_exception());
+    } catch (const std::exception& e) {
+        promise->resolve(AuthError(e.what()));
         return promise;
     }
 
@@ -456,16 +708,131 @@ std::shared_ptr<Promise<void>> PlatformAuth::revokeAccess() {
     if (env->ExceptionCheck()) {
         env->ExceptionDescribe();
         env->ExceptionClear();
-        promise->reject(std::make_exception_ptr(std::runtime_error("JNI call failed")));
+        promise->resolve(AuthError("JNI call failed"));
         return promise;
     }
 
-    promise->resolve();
+    promise->resolve(Result<void>());
     return promise;
 }
 
-extern "C" JNIEXPORT void JNICALL Java_com_auth_AuthAdapter_nativeInitialize(JNIEnv*, jclass, jobject context) {
+void PlatformAuth::cancel(PlatformOperation operation, const std::string& reason) {
+    std::shared_ptr<Promise<Result<AuthUser>>> userPromise;
+    std::shared_ptr<Promise<Result<AuthTokens>>> refreshPromise;
+    std::shared_ptr<Promise<Result<std::optional<AuthUser>>>> silentPromise;
+    std::shared_ptr<Promise<Result<std::string>>> browserPromise;
+    {
+        std::lock_guard<std::mutex> lock(gMutex);
+        switch (operation) {
+            case PlatformOperation::LOGIN:
+                userPromise = std::move(gLoginPromise);
+                gLoginPromise = nullptr;
+                browserPromise = std::move(gBrowserPromise);
+                gBrowserPromise = nullptr;
+                break;
+            case PlatformOperation::REQUEST_SCOPES:
+                userPromise = std::move(gScopesPromise);
+                gScopesPromise = nullptr;
+                browserPromise = std::move(gBrowserPromise);
+                gBrowserPromise = nullptr;
+                break;
+            case PlatformOperation::REFRESH_TOKEN:
+                refreshPromise = std::move(gRefreshPromise);
+                gRefreshPromise = nullptr;
+                break;
+            case PlatformOperation::SILENT_RESTORE:
+                silentPromise = std::move(gSilentPromise);
+                gSilentPromise = nullptr;
+                break;
+        }
+    }
+
+    // The AuthAdapter callback may still arrive later; it finds an empty slot and is dropped.
+    const AuthError error(reason);
+    if (userPromise) userPromise->resolve(error);
+    if (refreshPromise) refreshPromise->resolve(error);
+    if (silentPromise) silentPromise->resolve(error);
+    if (browserPromise) browserPromise->resolve(error);
+}
+
+extern "C" JNIEXPORT void JNICALL Java_com_auth_AuthAdapter_nativeInitialize(JNIEnv* env, jclass, jobject context) {
     AuthCache::setAndroidContext(context);
+    // Resolve the adapter on a JVM thread: FindClass from a natively attached
+    // thread (the metadata prefetch) cannot see app classes.
+    try {
+        ensureAuthAdapterMethods(env);
+    } catch (...) {
+        env->ExceptionClear();
+    }
+}
+
+extern "C" JNIEXPORT void JNICALL Java_com_auth_AuthAdapter_nativeOnHttpResponse(
+    JNIEnv* env, jclass, jlong requestId, jint status, jstring body, jobjectArray headerNames, jobjectArray headerValues) {
+
+    HttpClient::Completion completion;
+    {
+        std::lock_guard<std::mutex> lock(gHttpMutex);
+        auto it = gHttpRequests.find(requestId);
+        if (it == gHttpRequests.end()) return;
+        completion = std::move(it->second);
+        gHttpRequests.erase(it);
+    }
+
+    HttpResponse response;
+    response.status = status;
+    if (body) {
+        const char* chars = env->GetStringUTFChars(body, nullptr);
+        response.body = chars;
+        env->ReleaseStringUTFChars(body, chars);
+    }
+    auto names = fromJavaStringArray(env, headerNames);
+    auto values = fromJavaStringArray(env, headerValues);
+    for (size_t i = 0; i < names.size() && i < values.size(); i++) {
+        response.headers[names[i]] = values[i];
+    }
+    completion(std::move(response));
+}
+
+extern "C" JNIEXPORT void JNICALL Java_com_auth_AuthAdapter_nativeOnBrowserRedirect(
+    JNIEnv* env, jclass, jstring url, jstring error) {
+    std::shared_ptr<Promise<Result<std::string>>> browserPromise;
+    {
+        std::lock_guard<std::mutex> lock(gMutex);
+        browserPromise = std::move(gBrowserPromise);
+        gBrowserPromise = nullptr;
+    }
+    if (!browserPromise) return;
+
+    auto read = [env](jstring value) {
+        std::string result;
+        if (value) {
+            const char* chars = env->GetStringUTFChars(value, nullptr);
+            result = chars;
+            env->ReleaseStringUTFChars(value, chars);
+        }
+        return result;
+    };
+    if (error || !url) {
+        const std::string code = error ? read(error) : "unknown";
+        browserPromise->resolve(AuthError(code));
+        return;
+    }
+    browserPromise->resolve(read(url));
+}
+
+extern "C" JNIEXPORT jstring JNICALL Java_com_auth_AuthAdapter_nativeMicrosoftAuthBaseUrl(
+    JNIEnv* env, jclass, jstring tenant, jstring b2cDomain) {
+    auto read = [env](jstring value) {
+        std::string result;
+        if (value) {
+            const char* chars = env->GetStringUTFChars(value, nullptr);
+            result = chars;
+            env->ReleaseStringUTFChars(value, chars);
+        }
+        return result;
+    };
+    auto url = MicrosoftAuthority::authBaseUrl(read(tenant), read(b2cDomain));
+    return url ? env->NewStringUTF(url->c_str()) : nullptr;
 }
 
 extern "C" JNIEXPORT void JNICALL Java_com_auth_AuthAdapter_nativeOnLoginSuccess(
@@ -476,9 +843,9 @@ extern "C" JNIEXPORT void JNICALL Java_com_auth_AuthAdapter_nativeOnLoginSuccess
     std::string originStr(originCStr);
     env->ReleaseStringUTFChars(origin, originCStr);
 
-    std::shared_ptr<Promise<AuthUser>> loginPromise;
-    std::shared_ptr<Promise<AuthUser>> scopesPromise;
-    std::shared_ptr<Promise<std::optional<AuthUser>>> silentPromise;
+    std::shared_ptr<Promise<Result<AuthUser>>> loginPromise;
+    std::shared_ptr<Promise<Result<AuthUser>>> scopesPromise;
+    std::shared_ptr<Promise<Result<std::optional<AuthUser>>>> silentPromise;
     {
         std::lock_guard<std::mutex> lock(gMutex);
         if (originStr == "login") {
@@ -571,7 +938,7 @@ extern "C" JNIEXPORT void JNICALL Java_com_auth_AuthAdapter_nativeOnLoginSuccess
     
     if (loginPromise) loginPromise->resolve(user);
     if (scopesPromise) scopesPromise->resolve(user);
-    if (silentPromise) silentPromise->resolve(user);
+    if (silentPromise) silentPromise->resolve(std::make_optional(user));
 }
 
 extern "C" JNIEXPORT void JNICALL Java_com_auth_AuthAdapter_nativeOnLoginError(
@@ -581,9 +948,9 @@ extern "C" JNIEXPORT void JNICALL Java_com_auth_AuthAdapter_nativeOnLoginError(
     std::string originStr(originCStr);
     env->ReleaseStringUTFChars(origin, originCStr);
 
-    std::shared_ptr<Promise<AuthUser>> loginPromise;
-    std::shared_ptr<Promise<AuthUser>> scopesPromise;
-    std::shared_ptr<Promise<std::optional<AuthUser>>> silentPromise;
+    std::shared_ptr<Promise<Result<AuthUser>>> loginPromise;
+    std::shared_ptr<Promise<Result<AuthUser>>> scopesPromise;
+    std::shared_ptr<Promise<Result<std::optional<AuthUser>>>> silentPromise;
     {
         std::lock_guard<std::mutex> lock(gMutex);
         if (originStr == "login") {
@@ -611,18 +978,21 @@ extern "C" JNIEXPORT void JNICALL Java_com_auth_AuthAdapter_nativeOnLoginError(
         // for consumers. If richer debugging is needed, add it to the AuthUser.underlyingError field.
     }
 
-    if (loginPromise) loginPromise->reject(std::make_exception_ptr(std::runtime_error(errorStr)));
-    if (scopesPromise) scopesPromise->reject(std::make_exception_ptr(std::runtime_error(errorStr)));
-    if (silentPromise) {
-        if (errorStr == "not_signed_in") silentPromise->resolve(std::nullopt);
-        else silentPromise->reject(std::make_exception_ptr(std::runtime_error(errorStr)));
-    }
+    const AuthError authError(errorStr);
+    if (silentPromise && authError.code() == AuthErrorCode::NOT_SIGNED_IN) {
+        silentPromise->resolve(std::optional<AuthUser>());
+        silentPromise = nullptr;
+    }
+    if (!loginPromise && !scopesPromise && !silentPromise) return;
+    if (loginPromise) loginPromise->resolve(authError);
+    if (scopesPromise) scopesPromise->resolve(authError);
+    if (silentPromise) silentPromise->resolve(authError);
 }
 
 extern "C" JNIEXPORT void JNICALL Java_com_auth_AuthAdapter_nativeOnRefreshSuccess(
-    JNIEnv* env, jclass, jstring idToken, jstring accessToken, jobject expirationTime) {
+    JNIEnv* env, jclass, jstring idToken, jstring accessToken, jstring refreshToken, jobject expirationTime) {
     
-    std::shared_ptr<Promise<AuthTokens>> refreshPromise;
+    std::shared_ptr<Promise<Result<AuthTokens>>> refreshPromise;
     {
         std::lock_guard<std::mutex> lock(gMutex);
         refreshPromise = gRefreshPromise;
@@ -641,6 +1011,11 @@ extern "C" JNIEXPORT void JNICALL Java_com_auth_AuthAdapter_nativeOnRefreshSucce
             tokens.accessToken = std::string(s);
             env->ReleaseStringUTFChars(accessToken, s);
         }
+        if (refreshToken) {
+            const char* s = env->GetStringUTFChars(refreshToken, nullptr);
+            tokens.refreshToken = std::string(s);
+            env->ReleaseStringUTFChars(refreshToken, s);
+        }
         if (expirationTime) {
             jclass longClass = env->FindClass("java/lang/Long");
             jmethodID longValueMethod = env->GetMethodID(longClass, "longValue", "()J");
@@ -654,7 +1029,7 @@ extern "C" JNIEXPORT void JNICALL Java_com_auth_AuthAdapter_nativeOnRefreshSucce
 extern "C" JNIEXPORT void JNICALL Java_com_auth_AuthAdapter_nativeOnRefreshError(
     JNIEnv* env, jclass, jstring error, jstring underlyingError) {
     
-    std::shared_ptr<Promise<AuthTokens>> refreshPromise;
+    std::shared_ptr<Promise<Result<AuthTokens>>> refreshPromise;
     {
         std::lock_guard<std::mutex> lock(gMutex);
         refreshPromise = gRefreshPromise;
@@ -669,15 +1044,16 @@ extern "C" JNIEXPORT void JNICALL Java_com_auth_AuthAdapter_nativeOnRefreshError
             const char* uCStr = env->GetStringUTFChars(underlyingError, nullptr);
             env->ReleaseStringUTFChars(underlyingError, uCStr);
         }
-        refreshPromise->reject(std::make_exception_ptr(std::runtime_error(errorStr)));
+        refreshPromise->resolve(AuthError(errorStr));
     }
 }
 
 extern "C" JNIEXPORT void JNICALL Java_com_auth_AuthAdapter_nativeDispose(JNIEnv* env, jclass) {
-    std::shared_ptr<Promise<AuthUser>> loginPromise;
-    std::shared_ptr<Promise<AuthUser>> scopesPromise;
-    std::shared_ptr<Promise<AuthTokens>> refreshPromise;
-    std::shared_ptr<Promise<std::optional<AuthUser>>> silentPromise;
+    std::shared_ptr<Promise<Result<AuthUser>>> loginPromise;
+    std::shared_ptr<Promise<Result<AuthUser>>> scopesPromise;
+    std::shared_ptr<Promise<Result<AuthTokens>>> refreshPromise;
+    std::shared_ptr<Promise<Result<std::optional<AuthUser>>>> silentPromise;
+    std::shared_ptr<Promise<Result<std::string>>> browserPromise;
     {
         std::lock_guard<std::mutex> lock(gMutex);
         loginPromise = std::move(gLoginPromise);
@@ -688,13 +1064,23 @@ extern "C" JNIEXPORT void JNICALL Java_com_auth_AuthAdapter_nativeDispose(JNIEnv
         gScopesPromise = nullptr;
         gRefreshPromise = nullptr;
         gSilentPromise = nullptr;
+        browserPromise = std::move(gBrowserPromise);
+        gBrowserPromise = nullptr;
+    }
+
+    std::unordered_map<jlong, HttpClient::Completion> httpRequests;
+    {
+        std::lock_guard<std::mutex> lock(gHttpMutex);
+        httpRequests.swap(gHttpRequests);
     }
+    for (auto& [requestId, completion] : httpRequests) completion(HttpResponse{});
 
-    auto disposed = std::make_exception_ptr(std::runtime_error("disposed"));
-    if (loginPromise) loginPromise->reject(disposed);
-    if (scopesPromise) scopesPromise->reject(disposed);
-    if (refreshPromise) refreshPromise->reject(disposed);
-    if (silentPromise) silentPromise->reject(disposed);
+    const AuthError disposed(AuthErrorCode::DISPOSED);
+    if (loginPromise) loginPromise->resolve(disposed);
+    if (scopesPromise) scopesPromise->resolve(disposed);
+    if (refreshPromise) refreshPromise->resolve(disposed);
+    if (silentPromise) silentPromise->resolve(disposed);
+    if (browserPromise) browserPromise->resolve(disposed);
 
     clearCachedJniRefs(env);
 }
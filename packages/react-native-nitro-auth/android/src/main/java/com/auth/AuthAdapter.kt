@@ -8,6 +8,8 @@ import android.content.Context
 import android.content.Intent
 import android.net.Uri
 import android.os.Bundle
+import android.os.Handler
+import android.os.Looper
 import android.util.Base64
 import android.util.Log
 import androidx.browser.customtabs.CustomTabsIntent
@@ -36,6 +38,8 @@ import java.util.UUID
 
 object AuthAdapter {
     private const val TAG = "AuthAdapter"
+    // How long a resumed app waits for OidcRedirectActivity before treating the browser as closed.
+    private const val BROWSER_DISMISS_GRACE_MS = 500L
     private val defaultMicrosoftScopes =
         listOf("openid", "email", "profile", "offline_access", "User.Read")
 
@@ -67,6 +71,13 @@ object AuthAdapter {
     private var microsoftAuthInProgress = false
     @Volatile
     private var hasLegacyGoogleSession = false
+    @Volatile
+    private var pendingBrowserRedirectUri: String? = null
+    @Volatile
+    private var browserAttempt = 0L
+    @Volatile
+    private var browserLeftApp = false
+    private val mainHandler = Handler(Looper.getMainLooper())
 
     @Volatile
     private var inMemoryMicrosoftRefreshToken: String? = null
@@ -102,11 +113,31 @@ object AuthAdapter {
     private external fun nativeOnLoginError(origin: String, error: String, underlyingError: String?)
 
     @JvmStatic
-    private external fun nativeOnRefreshSuccess(idToken: String?, accessToken: String?, expirationTime: Long?)
+    private external fun nativeOnRefreshSuccess(
+        idToken: String?,
+        accessToken: String?,
+        refreshToken: String?,
+        expirationTime: Long?
+    )
 
     @JvmStatic
     private external fun nativeOnRefreshError(error: String, underlyingError: String?)
 
+    @JvmStatic
+    private external fun nativeOnHttpResponse(
+        requestId: Long,
+        status: Int,
+        body: String?,
+        headerNames: Array<String>,
+        headerValues: Array<String>
+    )
+
+    @JvmStatic
+    private external fun nativeOnBrowserRedirect(url: String?, error: String?)
+
+    @JvmStatic
+    private external fun nativeMicrosoftAuthBaseUrl(tenant: String, b2cDomain: String?): String?
+
     @Synchronized
     fun initialize(context: Context) {
         if (isInitialized) return
@@ -119,8 +150,14 @@ object AuthAdapter {
             lifecycleCallbacks = object : Application.ActivityLifecycleCallbacks {
                 override fun onActivityCreated(activity: Activity, savedInstanceState: Bundle?) { currentActivity = activity }
                 override fun onActivityStarted(activity: Activity) { currentActivity = activity }
-                override fun onActivityResumed(activity: Activity) { currentActivity = activity }
-                override fun onActivityPaused(activity: Activity) { if (currentActivity == activity) currentActivity = null }
+                override fun onActivityResumed(activity: Activity) {
+                    currentActivity = activity
+                    if (activity !is OidcRedirectActivity) checkBrowserDismissed()
+                }
+                override fun onActivityPaused(activity: Activity) {
+                    if (currentActivity == activity) currentActivity = null
+                    if (pendingBrowserRedirectUri != null) browserLeftApp = true
+                }
                 override fun onActivityStopped(activity: Activity) { if (currentActivity == activity) currentActivity = null }
                 override fun onActivitySaveInstanceState(activity: Activity, outState: Bundle) {}
                 override fun onActivityDestroyed(activity: Activity) { if (currentActivity == activity) currentActivity = null }
@@ -138,6 +175,8 @@ object AuthAdapter {
 
     fun dispose() {
         clearPkceState()
+        mainHandler.removeCallbacksAndMessages(null)
+        pendingBrowserRedirectUri = null
         moduleScope.cancel()
         moduleScope = CoroutineScope(SupervisorJob() + Dispatchers.IO)
         runCatching { nativeDispose() }
@@ -544,49 +583,133 @@ object AuthAdapter {
         return if (resId != 0) context.getString(resId) else null
     }
 
-    private fun getMicrosoftAuthBaseUrl(tenant: String, b2cDomain: String?): String? {
-        val trimmedTenant = tenant.trim()
-
-        return if (!b2cDomain.isNullOrBlank()) {
-            val trimmedDomain = b2cDomain.trim().lowercase()
-            if (!isValidMicrosoftDomain(trimmedDomain)) return null
-            val b2cTenantPath = getMicrosoftB2cTenantPath(trimmedTenant, trimmedDomain) ?: return null
-            "https://$trimmedDomain/$b2cTenantPath/"
-        } else {
-            if (!isValidMicrosoftTenant(trimmedTenant)) return null
-            "https://login.microsoftonline.com/$trimmedTenant/"
+    // OpenID authorities of the configured providers, prefetched by the native metadata cache.
+    @JvmStatic
+    fun discoveryAuthorities(context: Context): Array<String> {
+        val ctx = appContext ?: context.applicationContext
+        val authorities = mutableListOf<String>()
+        if (!getClientIdFromResources(ctx).isNullOrEmpty()) {
+            authorities.add("https://accounts.google.com")
+        }
+        if (!getMicrosoftClientIdFromResources(ctx).isNullOrEmpty()) {
+            val tenant = getMicrosoftTenantFromResources(ctx) ?: "common"
+            getMicrosoftAuthBaseUrl(tenant, getMicrosoftB2cDomainFromResources(ctx))?.let {
+                authorities.add("${it}v2.0")
+            }
         }
+        return authorities.toTypedArray()
     }
 
-    private fun isValidMicrosoftTenant(value: String): Boolean {
-        return Regex("^(common|organizations|consumers|[0-9a-fA-F]{8}-[0-9a-fA-F]{4}-[0-9a-fA-F]{4}-[0-9a-fA-F]{4}-[0-9a-fA-F]{12}|[A-Za-z0-9][A-Za-z0-9._-]{0,127})$").matches(value)
+    @JvmStatic
+    fun cacheDirectory(context: Context): String {
+        val ctx = appContext ?: context.applicationContext
+        return java.io.File(ctx.cacheDir, "nitro-auth").absolutePath
     }
 
-    private fun getMicrosoftB2cTenantPath(value: String, domain: String): String? {
-        if (isValidMicrosoftB2cTenantPath(value)) return value
-        if (!isValidMicrosoftB2cPolicy(value)) return null
-        val tenantName = getMicrosoftB2cTenantName(domain) ?: return null
-        return "$tenantName.onmicrosoft.com/$value"
+    // Transport for the native core's own requests; always answers through nativeOnHttpResponse.
+    @JvmStatic
+    fun httpRequest(
+        requestId: Long,
+        method: String,
+        url: String,
+        headerNames: Array<String>,
+        headerValues: Array<String>,
+        body: String?,
+        timeoutMs: Long
+    ) {
+        moduleScope.launch {
+            var status = 0
+            var responseBody: String? = null
+            val names = mutableListOf<String>()
+            val values = mutableListOf<String>()
+            try {
+                val connection = java.net.URL(url).openConnection() as java.net.HttpURLConnection
+                try {
+                    connection.connectTimeout = timeoutMs.toInt()
+                    connection.readTimeout = timeoutMs.toInt()
+                    connection.requestMethod = method
+                    headerNames.forEachIndexed { index, name -> connection.setRequestProperty(name, headerValues[index]) }
+                    if (body != null) {
+                        connection.doOutput = true
+                        connection.outputStream.use { it.write(body.toByteArray()) }
+                    }
+                    status = connection.responseCode
+                    val stream = if (status in 200..399) connection.inputStream else connection.errorStream
+                    responseBody = stream?.bufferedReader()?.use { it.readText() }
+                    connection.headerFields.forEach { (name, headerValue) ->
+                        if (name != null && headerValue.isNotEmpty()) {
+                            names.add(name.lowercase())
+                            values.add(headerValue.joinToString(", "))
+                        }
+                    }
+                } finally {
+                    connection.disconnect()
+                }
+            } catch (e: Exception) {
+                Log.w(TAG, "Native HTTP request failed: ${e.message}")
+                status = 0
+            }
+            nativeOnHttpResponse(requestId, status, responseBody, names.toTypedArray(), values.toTypedArray())
+        }
     }
 
-    private fun getMicrosoftB2cTenantName(domain: String): String? {
-        val suffix = ".b2clogin.com"
-        if (!domain.endsWith(suffix)) return null
-        val tenantName = domain.removeSuffix(suffix)
-        return if (Regex("^[A-Za-z0-9](?:[A-Za-z0-9-]{0,61}[A-Za-z0-9])?$").matches(tenantName)) tenantName else null
+    // Browser half of the native OIDC client (cpp/OidcClient): the code exchange and
+    // token checks run natively once OidcRedirectActivity hands back the redirect.
+    @JvmStatic
+    fun authorizeInBrowser(context: Context, url: String, redirectUri: String) {
+        val ctx = appContext ?: context.applicationContext
+        synchronized(this) {
+            browserAttempt++
+            browserLeftApp = false
+            pendingBrowserRedirectUri = redirectUri
+        }
+        try {
+            val uri = Uri.parse(url)
+            val activity = currentActivity
+            if (activity != null) {
+                CustomTabsIntent.Builder().build().launchUrl(activity, uri)
+            } else {
+                val browserIntent = Intent(Intent.ACTION_VIEW, uri)
+                browserIntent.addFlags(Intent.FLAG_ACTIVITY_NEW_TASK)
+                ctx.startActivity(browserIntent)
+            }
+        } catch (e: Exception) {
+            Log.w(TAG, "Unable to open authorization URL: ${e.message}")
+            pendingBrowserRedirectUri = null
+            nativeOnBrowserRedirect(null, "unknown")
+        }
     }
 
-    private fun isValidMicrosoftB2cTenantPath(value: String): Boolean {
-        return Regex("^([0-9a-fA-F]{8}-[0-9a-fA-F]{4}-[0-9a-fA-F]{4}-[0-9a-fA-F]{4}-[0-9a-fA-F]{12}|[A-Za-z0-9][A-Za-z0-9._-]{0,127})/[A-Za-z0-9][A-Za-z0-9._-]{0,127}$").matches(value)
+    @JvmStatic
+    fun handleBrowserRedirect(uri: Uri): Boolean {
+        val url = uri.toString()
+        synchronized(this) {
+            val expected = pendingBrowserRedirectUri ?: return false
+            if (!url.startsWith(expected)) return false
+            pendingBrowserRedirectUri = null
+        }
+        nativeOnBrowserRedirect(url, null)
+        return true
     }
 
-    private fun isValidMicrosoftB2cPolicy(value: String): Boolean {
-        return Regex("^[A-Za-z0-9][A-Za-z0-9._-]{0,127}$").matches(value)
+    // A Custom Tab reports nothing when the user closes it. If the app comes back
+    // and OidcRedirectActivity has not delivered the redirect by then, the
+    // sign-in was abandoned; without this it would hold the native slot until its deadline.
+    private fun checkBrowserDismissed() {
+        if (pendingBrowserRedirectUri == null || !browserLeftApp) return
+        val attempt = browserAttempt
+        mainHandler.postDelayed({
+            synchronized(this) {
+                if (browserAttempt != attempt || pendingBrowserRedirectUri == null) return@postDelayed
+                pendingBrowserRedirectUri = null
+            }
+            nativeOnBrowserRedirect(null, "cancelled")
+        }, BROWSER_DISMISS_GRACE_MS)
     }
 
-    private fun isValidMicrosoftDomain(value: String): Boolean {
-        return Regex("^(?=.{1,253}$)(?:[A-Za-z0-9](?:[A-Za-z0-9-]{0,61}[A-Za-z0-9])?\\.)+[A-Za-z]{2,63}$").matches(value)
-    }
+    // Validated and cached by the shared native implementation (cpp/MicrosoftAuthority).
+    private fun getMicrosoftAuthBaseUrl(tenant: String, b2cDomain: String?): String? =
+        nativeMicrosoftAuthBaseUrl(tenant, b2cDomain)
 
     private fun loginOneTap(
         context: Context,
@@ -721,9 +844,24 @@ object AuthAdapter {
     }
 
     @JvmStatic
-    fun refreshTokenSync(context: Context) {
+    fun refreshTokenSync(context: Context, provider: String?, scopes: Array<String>?) {
         val ctx = appContext ?: context.applicationContext
-        val account = GoogleSignIn.getLastSignedInAccount(ctx)
+        if (provider == "apple") {
+            nativeOnRefreshError("unsupported_provider", "Apple refresh is not supported on Android")
+            return
+        }
+        // Resource tokens (explicit scopes) come from the Microsoft token endpoint only.
+        if (scopes != null) {
+            val refreshToken = inMemoryMicrosoftRefreshToken
+            when {
+                provider == "google" -> nativeOnRefreshError("unsupported_provider", "Resource tokens require Microsoft")
+                refreshToken == null -> nativeOnRefreshError("not_signed_in", "No Microsoft session")
+                else -> refreshMicrosoftTokenForRefresh(ctx, refreshToken, scopes)
+            }
+            return
+        }
+        // A provider pins the refresh to that account's session; null keeps the Google-then-Microsoft order.
+        val account = if (provider == "microsoft") null else GoogleSignIn.getLastSignedInAccount(ctx)
         if (account != null) {
             val client = googleSignInClient ?: run {
                 val clientId = getClientIdFromResources(ctx)
@@ -743,14 +881,14 @@ object AuthAdapter {
             client.silentSignIn().addOnCompleteListener { task ->
                 if (task.isSuccessful) {
                     val acc = task.result
-                    nativeOnRefreshSuccess(acc?.idToken, null, getJwtExpirationTimeMs(acc?.idToken))
+                    nativeOnRefreshSuccess(acc?.idToken, null, null, getJwtExpirationTimeMs(acc?.idToken))
                 } else {
                     nativeOnRefreshError("network_error", task.exception?.message ?: "Silent sign-in failed")
                 }
             }
             return
         }
-        val refreshToken = inMemoryMicrosoftRefreshToken
+        val refreshToken = if (provider == "google") null else inMemoryMicrosoftRefreshToken
         if (refreshToken != null) {
             refreshMicrosoftTokenForRefresh(ctx, refreshToken)
             return
@@ -904,7 +1042,7 @@ object AuthAdapter {
         }
     }
 
-    private fun refreshMicrosoftTokenForRefresh(context: Context, refreshToken: String) {
+    private fun refreshMicrosoftTokenForRefresh(context: Context, refreshToken: String, resourceScopes: Array<String>? = null) {
         val clientId = getMicrosoftClientIdFromResources(context)
         val tenant = getMicrosoftTenantFromResources(context) ?: "common"
         val b2cDomain = getMicrosoftB2cDomainFromResources(context)
@@ -937,6 +1075,10 @@ object AuthAdapter {
                         append("client_id=${java.net.URLEncoder.encode(clientId, "UTF-8")}")
                         append("&grant_type=refresh_token")
                         append("&refresh_token=${java.net.URLEncoder.encode(refreshToken, "UTF-8")}")
+                        if (resourceScopes != null) {
+                            val scope = (resourceScopes.toList() + "offline_access").distinct().joinToString(" ")
+                            append("&scope=${java.net.URLEncoder.encode(scope, "UTF-8")}")
+                        }
                     }
                     connection.outputStream.use { it.write(postData.toByteArray()) }
 
@@ -957,15 +1099,16 @@ object AuthAdapter {
                             val expirationTime = if (expiresIn > 0) System.currentTimeMillis() + expiresIn * 1000 else null
 
                             if (newRefreshToken.isNotEmpty()) inMemoryMicrosoftRefreshToken = newRefreshToken
-                            inMemoryMicrosoftScopes = effectiveScopes
+                            if (resourceScopes == null) inMemoryMicrosoftScopes = effectiveScopes
 
                             nativeOnRefreshSuccess(
                                 newIdToken.ifEmpty { null },
                                 newAccessToken.ifEmpty { null },
+                                newRefreshToken.ifEmpty { null },
                                 expirationTime
                             )
                         } else {
-                            if (responseCode in 400..499) {
+                            if (resourceScopes == null && responseCode in 400..499) {
                                 inMemoryMicrosoftRefreshToken = null
                             }
                             val errorBody = responseBody
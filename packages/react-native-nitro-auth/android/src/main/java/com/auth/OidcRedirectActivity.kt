@@ -0,0 +1,24 @@
+package com.auth
+
+import android.app.Activity
+import android.content.Intent
+import android.os.Bundle
+
+// Receives the redirect of a generic OIDC sign-in. The app registers its redirect
+// scheme on this activity (see the `oidcRedirectScheme` config plugin option).
+class OidcRedirectActivity : Activity() {
+    override fun onCreate(savedInstanceState: Bundle?) {
+        super.onCreate(savedInstanceState)
+        handleIntent(intent)
+    }
+
+    override fun onNewIntent(intent: Intent?) {
+        super.onNewIntent(intent)
+        intent?.let { handleIntent(it) }
+    }
+
+    private fun handleIntent(intent: Intent) {
+        intent.data?.let { AuthAdapter.handleBrowserRedirect(it) }
+        finish()
+    }
+}
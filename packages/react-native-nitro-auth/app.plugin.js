@@ -28,6 +28,27 @@ function getNitroAuthIosExtraPods(extraPods = []) {
   return pods;
 }
 
+// Receives the redirect of the generic OIDC provider; iOS needs no registration
+// because ASWebAuthenticationSession captures the callback scheme itself.
+function getOidcRedirectActivity(scheme) {
+  return {
+    $: {
+      "android:name": "com.auth.OidcRedirectActivity",
+      "android:exported": "true",
+    },
+    "intent-filter": [
+      {
+        action: [{ $: { "android:name": "android.intent.action.VIEW" } }],
+        category: [
+          { $: { "android:name": "android.intent.category.DEFAULT" } },
+          { $: { "android:name": "android.intent.category.BROWSABLE" } },
+        ],
+        data: [{ $: { "android:scheme": scheme } }],
+      },
+    ],
+  };
+}
+
 const withNitroAuth = (config, props = {}) => {
   const { ios = {}, android = {} } = props;
 
@@ -186,6 +207,24 @@ const withNitroAuth = (config, props = {}) => {
     });
   }
 
+  if (android.oidcRedirectScheme) {
+    config = withAndroidManifest(config, (config) => {
+      const application = config.modResults.manifest.application?.[0];
+      if (application) {
+        application.activity = application.activity || [];
+        const existingOidcActivity = application.activity.find(
+          (a) => a.$?.["android:name"] === "com.auth.OidcRedirectActivity",
+        );
+        if (!existingOidcActivity) {
+          application.activity.push(
+            getOidcRedirectActivity(android.oidcRedirectScheme),
+          );
+        }
+      }
+      return config;
+    });
+  }
+
   return config;
 };
 
@@ -193,5 +232,6 @@ module.exports = createRunOncePlugin(withNitroAuth, pkg.name, pkg.version);
 module.exports.withNitroAuth = withNitroAuth;
 module.exports._internal = {
   getNitroAuthIosExtraPods,
+  getOidcRedirectActivity,
   googleSignInIosPods,
 };
@@ -0,0 +1,130 @@
+#include "AccessTokenCache.hpp"
+#include "MemoryAccounting.hpp"
+#include <algorithm>
+
+namespace margelo::nitro::NitroAuth {
+
+namespace {
+
+// OpenID Connect scopes are never resource-qualified.
+bool isBareScope(const std::string& scope) {
+  return scope == "openid" || scope == "profile" || scope == "email" || scope == "offline_access";
+}
+
+bool isAbsoluteScope(const std::string& scope) {
+  return scope.find("://") != std::string::npos;
+}
+
+size_t entryBytes(const std::string& key, const CachedAccessToken& token) {
+  // Key stored twice (list entry and index), plus list and hash node overhead.
+  return 2 * key.size() + token.accessToken.size() + 96;
+}
+
+} // namespace
+
+AccessTokenCache::AccessTokenCache(AccessTokenCacheLimits limits) : _limits(limits) {}
+
+AccessTokenCache::~AccessTokenCache() {
+  clear();
+}
+
+std::vector<std::string> AccessTokenCache::scopesFor(const AccessTokenRequest& request) {
+  std::string resource = request.resource.value_or("");
+  while (!resource.empty() && resource.back() == '/') resource.pop_back();
+
+  std::vector<std::string> scopes;
+  if (request.scopes) {
+    for (const auto& scope : *request.scopes) {
+      if (scope.empty()) continue;
+      if (resource.empty() || isBareScope(scope) || isAbsoluteScope(scope)) {
+        scopes.push_back(scope);
+      } else {
+        scopes.push_back(resource + "/" + scope);
+      }
+    }
+  }
+  if (!resource.empty() && scopes.empty()) {
+    scopes.push_back(resource + "/.default");
+  }
+  std::sort(scopes.begin(), scopes.end());
+  scopes.erase(std::unique(scopes.begin(), scopes.end()), scopes.end());
+  return scopes;
+}
+
+std::string AccessTokenCache::keyFor(const std::string& accountId, const std::vector<std::string>& scopes) {
+  std::string key = accountId;
+  key += '\n';
+  for (size_t i = 0; i < scopes.size(); ++i) {
+    if (i > 0) key += ' ';
+    key += scopes[i];
+  }
+  return key;
+}
+
+std::optional<CachedAccessToken> AccessTokenCache::find(const std::string& key) {
+  auto it = _index.find(key);
+  if (it == _index.end()) {
+    _stats.misses++;
+    return std::nullopt;
+  }
+  _stats.hits++;
+  _entries.splice(_entries.begin(), _entries, it->second);
+  return it->second->token;
+}
+
+void AccessTokenCache::put(const std::string& key, CachedAccessToken token) {
+  if (auto it = _index.find(key); it != _index.end()) {
+    erase(it->second);
+  }
+  const size_t bytes = entryBytes(key, token);
+  // A token that alone exceeds the budget is handed to the caller but not kept.
+  if (_limits.maxEntries == 0 || bytes > _limits.maxBytes) return;
+  _entries.push_front(Entry{key, std::move(token), bytes});
+  _index.emplace(key, _entries.begin());
+  _stats.bytes += bytes;
+  MemoryAccounting::allocated(MemorySubsystem::CACHES, bytes);
+  evictToLimits();
+}
+
+void AccessTokenCache::eraseAccount(const std::string& accountId) {
+  const std::string prefix = accountId + '\n';
+  for (auto it = _entries.begin(); it != _entries.end();) {
+    auto next = std::next(it);
+    if (it->key.compare(0, prefix.size(), prefix) == 0) erase(it);
+    it = next;
+  }
+}
+
+void AccessTokenCache::clear() {
+  for (const auto& entry : _entries) MemoryAccounting::released(MemorySubsystem::CACHES, entry.bytes);
+  _entries.clear();
+  _index.clear();
+  _stats.bytes = 0;
+}
+
+void AccessTokenCache::setLimits(AccessTokenCacheLimits limits) {
+  _limits = limits;
+  evictToLimits();
+}
+
+AccessTokenCacheStats AccessTokenCache::stats() const {
+  auto stats = _stats;
+  stats.entries = _entries.size();
+  return stats;
+}
+
+void AccessTokenCache::erase(std::list<Entry>::iterator entry) {
+  _stats.bytes -= entry->bytes;
+  MemoryAccounting::released(MemorySubsystem::CACHES, entry->bytes);
+  _index.erase(entry->key);
+  _entries.erase(entry);
+}
+
+void AccessTokenCache::evictToLimits() {
+  while (!_entries.empty() && (_entries.size() > _limits.maxEntries || _stats.bytes > _limits.maxBytes)) {
+    erase(std::prev(_entries.end()));
+    _stats.evictions++;
+  }
+}
+
+} // namespace margelo::nitro::NitroAuth
@@ -0,0 +1,78 @@
+#pragma once
+
+#include "AccessTokenRequest.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace margelo::nitro::NitroAuth {
+
+struct CachedAccessToken {
+  std::string accessToken;
+  std::optional<double> expirationTime;
+};
+
+struct AccessTokenCacheLimits {
+  size_t maxEntries = 64;
+  // Approximate heap footprint of keys, tokens and bookkeeping.
+  size_t maxBytes = 256 * 1024;
+};
+
+struct AccessTokenCacheStats {
+  uint64_t hits = 0;
+  uint64_t misses = 0;
+  uint64_t evictions = 0;
+  size_t entries = 0;
+  size_t bytes = 0;
+};
+
+// LRU of access tokens keyed by account and normalized scope set, so tokens for
+// different resources (Graph, SharePoint, a custom API) live side by side
+// instead of overwriting `AuthUser::accessToken`. Not thread-safe; HybridAuth
+// guards it with its own mutex. Entry sizes are booked to
+// MemorySubsystem::CACHES.
+class AccessTokenCache {
+public:
+  explicit AccessTokenCache(AccessTokenCacheLimits limits = {});
+  ~AccessTokenCache();
+  AccessTokenCache(const AccessTokenCache&) = delete;
+  AccessTokenCache& operator=(const AccessTokenCache&) = delete;
+
+  // The scope list sent to the platform for `request`, sorted and deduplicated.
+  // Scopes are qualified with `resource` unless already absolute; a bare
+  // resource asks for `<resource>/.default`. Empty means "the session token".
+  static std::vector<std::string> scopesFor(const AccessTokenRequest& request);
+  static std::string keyFor(const std::string& accountId, const std::vector<std::string>& scopes);
+
+  // Marks the entry as most recently used.
+  std::optional<CachedAccessToken> find(const std::string& key);
+  void put(const std::string& key, CachedAccessToken token);
+  void eraseAccount(const std::string& accountId);
+  void clear();
+
+  void setLimits(AccessTokenCacheLimits limits);
+  AccessTokenCacheStats stats() const;
+
+private:
+  struct Entry {
+    std::string key;
+    CachedAccessToken token;
+    size_t bytes;
+  };
+
+  void erase(std::list<Entry>::iterator entry);
+  void evictToLimits();
+
+private:
+  AccessTokenCacheLimits _limits;
+  // Most recently used first.
+  std::list<Entry> _entries;
+  std::unordered_map<std::string, std::list<Entry>::iterator> _index;
+  AccessTokenCacheStats _stats;
+};
+
+} // namespace margelo::nitro::NitroAuth
@@ -0,0 +1,109 @@
+#include "AccountRegistry.hpp"
+#include "MemoryAccounting.hpp"
+#include <algorithm>
+
+namespace margelo::nitro::NitroAuth {
+
+namespace {
+
+const char* providerName(AuthProvider provider) {
+  switch (provider) {
+    case AuthProvider::GOOGLE: return "google";
+    case AuthProvider::APPLE: return "apple";
+    case AuthProvider::MICROSOFT: return "microsoft";
+    case AuthProvider::OIDC: return "oidc";
+  }
+  return "unknown";
+}
+
+} // namespace
+
+std::string AccountRegistry::accountIdFor(const AuthUser& user) {
+  std::string id = providerName(user.provider);
+  if (user.userId && !user.userId->empty()) {
+    id += ":" + *user.userId;
+  } else if (user.email && !user.email->empty()) {
+    id += ":" + *user.email;
+  }
+  return id;
+}
+
+std::shared_ptr<AccountSession> AccountRegistry::upsert(const AuthUser& user, const RefreshBackoffPolicy& policy,
+                                                        std::shared_ptr<Promise<AuthTokens>>* retiredRefresh) {
+  auto id = accountIdFor(user);
+  _platformSessions[user.provider] = id;
+  auto& slot = _accounts[id];
+  uint64_t order = _nextOrder++;
+  RefreshTokenLedger refreshTokens;
+  if (slot) {
+    auto refreshInFlight = slot->refresh.retire();
+    if (retiredRefresh) *retiredRefresh = std::move(refreshInFlight);
+    order = slot->order;
+    // The account's rotation history outlives a restored or re-signed-in user.
+    refreshTokens = std::move(slot->refreshTokens);
+  }
+  slot = std::allocate_shared<AccountSession>(TrackedAllocator<AccountSession, MemorySubsystem::SESSIONS>(),
+                                              std::move(id), user, order, policy);
+  slot->refreshTokens = std::move(refreshTokens);
+  _active = slot;
+  return slot;
+}
+
+std::shared_ptr<AccountSession> AccountRegistry::find(const std::string& id) const {
+  auto it = _accounts.find(id);
+  return it == _accounts.end() ? nullptr : it->second;
+}
+
+bool AccountRegistry::activate(const std::string& id) {
+  auto it = _accounts.find(id);
+  if (it == _accounts.end()) return false;
+  _active = it->second;
+  return true;
+}
+
+void AccountRegistry::markPlatformSession(AccountSession& account) {
+  auto& holder = _platformSessions[account.user.provider()];
+  if (holder == account.id) return;
+  holder = account.id;
+  // Failures cached while another account held the session say nothing about this one.
+  account.refresh.backoff.reset();
+}
+
+bool AccountRegistry::isPlatformSession(const AccountSession& account) const {
+  auto it = _platformSessions.find(account.user.provider());
+  return it != _platformSessions.end() && it->second == account.id;
+}
+
+std::vector<std::shared_ptr<Promise<AuthTokens>>> AccountRegistry::clear() {
+  std::vector<std::shared_ptr<Promise<AuthTokens>>> refreshes;
+  for (auto& [id, account] : _accounts) {
+    if (auto refreshInFlight = account->refresh.retire()) refreshes.push_back(std::move(refreshInFlight));
+  }
+  _accounts.clear();
+  _active = nullptr;
+  _platformSessions.clear();
+  return refreshes;
+}
+
+void AccountRegistry::forEach(const std::function<void(AccountSession&)>& visit) {
+  for (auto& [id, account] : _accounts) visit(*account);
+}
+
+std::vector<AuthAccount> AccountRegistry::list() const {
+  std::vector<const AccountSession*> ordered;
+  ordered.reserve(_accounts.size());
+  for (const auto& [id, account] : _accounts) ordered.push_back(account.get());
+  std::sort(ordered.begin(), ordered.end(), [](const AccountSession* a, const AccountSession* b) {
+    return a->order < b->order;
+  });
+
+  std::vector<AuthAccount> accounts;
+  accounts.reserve(ordered.size());
+  for (const auto* account : ordered) {
+    accounts.emplace_back(account->id, account->user.provider(), account->user.get(AuthUserField::EMAIL),
+                          account->user.get(AuthUserField::NAME), account == _active.get());
+  }
+  return accounts;
+}
+
+} // namespace margelo::nitro::NitroAuth
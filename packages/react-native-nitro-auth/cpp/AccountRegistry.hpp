@@ -0,0 +1,95 @@
+#pragma once
+
+#include "AuthAccount.hpp"
+#include "AuthTokens.hpp"
+#include "AuthUser.hpp"
+#include "PackedAuthUser.hpp"
+#include "RefreshBackoff.hpp"
+#include "RefreshTokenLedger.hpp"
+#include <NitroModules/Promise.hpp>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace margelo::nitro::NitroAuth {
+
+using namespace margelo::nitro;
+
+// Refresh single-flight plus its failure backoff.
+struct RefreshSlot {
+  explicit RefreshSlot(const RefreshBackoffPolicy& policy) : backoff(policy) {}
+
+  // Invalidates the refresh in flight, returning it for the caller to settle,
+  // and forgets cached failures.
+  std::shared_ptr<Promise<AuthTokens>> retire() {
+    generation++;
+    backoff.reset();
+    auto promise = std::move(inFlight);
+    inFlight = nullptr;
+    return promise;
+  }
+
+  // Refresh results captured under an older generation are dropped.
+  uint64_t generation = 0;
+  std::shared_ptr<Promise<AuthTokens>> inFlight;
+  RefreshBackoff backoff;
+};
+
+// One signed-in account with its own tokens, scopes and refresh slot, so
+// refreshing or replacing one account never disturbs another.
+struct AccountSession {
+  AccountSession(std::string id, const AuthUser& user, uint64_t order, const RefreshBackoffPolicy& policy)
+    : id(std::move(id)), user(user), order(order), refresh(policy) {}
+
+  const std::string id;
+  // Packed; unpacked only when handed out as an AuthUser.
+  PackedAuthUser user;
+  std::vector<std::string> grantedScopes;
+  // Sign-in order, used to list accounts stably.
+  const uint64_t order;
+  RefreshSlot refresh;
+  RefreshTokenLedger refreshTokens;
+  // `user.expirationTime` is the id_token `exp`, stamped by the server's clock.
+  bool expiresInServerTime = false;
+};
+
+// Keyed store of signed-in accounts plus the active one. Not thread-safe;
+// HybridAuth guards it with its own mutex.
+class AccountRegistry {
+public:
+  // "<provider>:<userId>", falling back to the email, then to the provider alone.
+  static std::string accountIdFor(const AuthUser& user);
+
+  // Inserts or replaces the account for `user` and makes it active. A replaced
+  // account is retired; its in-flight refresh is handed back through `retiredRefresh`,
+  // and its refresh-token ledger carries over. `user` came from the platform, so
+  // it also becomes the platform session for its provider.
+  std::shared_ptr<AccountSession> upsert(const AuthUser& user, const RefreshBackoffPolicy& policy,
+                                         std::shared_ptr<Promise<AuthTokens>>* retiredRefresh = nullptr);
+  std::shared_ptr<AccountSession> find(const std::string& id) const;
+  const std::shared_ptr<AccountSession>& active() const { return _active; }
+  // O(1) and local: the account keeps its tokens and any refresh in flight.
+  bool activate(const std::string& id);
+  // The native SDKs hold one session per provider, the last account they signed
+  // in or restored; a platform refresh acts on that session, whoever asks.
+  // Handing the session to another account clears that account's refresh backoff.
+  void markPlatformSession(AccountSession& account);
+  bool isPlatformSession(const AccountSession& account) const;
+  // Retires every account and returns their in-flight refreshes for the caller to settle.
+  std::vector<std::shared_ptr<Promise<AuthTokens>>> clear();
+
+  void forEach(const std::function<void(AccountSession&)>& visit);
+  std::vector<AuthAccount> list() const;
+  size_t size() const { return _accounts.size(); }
+
+private:
+  std::unordered_map<std::string, std::shared_ptr<AccountSession>> _accounts;
+  std::shared_ptr<AccountSession> _active;
+  std::unordered_map<AuthProvider, std::string> _platformSessions;
+  uint64_t _nextOrder = 0;
+};
+
+} // namespace margelo::nitro::NitroAuth
@@ -0,0 +1,22 @@
+#include "AuthClock.hpp"
+#include <chrono>
+
+namespace margelo::nitro::NitroAuth {
+
+namespace {
+
+class SystemAuthClock final : public AuthClock {
+public:
+  int64_t nowMs() override {
+    return std::chrono::system_clock::now().time_since_epoch() / std::chrono::milliseconds(1);
+  }
+};
+
+} // namespace
+
+std::shared_ptr<AuthClock> AuthClock::system() {
+  static auto clock = std::make_shared<SystemAuthClock>();
+  return clock;
+}
+
+} // namespace margelo::nitro::NitroAuth
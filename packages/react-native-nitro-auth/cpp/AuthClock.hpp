@@ -0,0 +1,20 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+
+namespace margelo::nitro::NitroAuth {
+
+// Wall-clock source for token expiry and refresh decisions. Injectable so
+// long token lifecycles can be driven in virtual time.
+class AuthClock {
+public:
+  virtual ~AuthClock() = default;
+
+  // Milliseconds since the Unix epoch, the unit used by `expirationTime`.
+  virtual int64_t nowMs() = 0;
+
+  static std::shared_ptr<AuthClock> system();
+};
+
+} // namespace margelo::nitro::NitroAuth
@@ -0,0 +1,30 @@
+#include "AuthResult.hpp"
+#include <stdexcept>
+
+namespace margelo::nitro::NitroAuth {
+
+namespace {
+
+using PreallocatedErrors = std::array<std::exception_ptr, kAuthErrorCodeNames.size()>;
+
+// Rejections only ever read `what()`, so one immutable exception per code can
+// be shared by every promise, on every thread.
+const PreallocatedErrors& preallocatedErrors() {
+  static const PreallocatedErrors errors = [] {
+    PreallocatedErrors result;
+    for (size_t i = 0; i < result.size(); i++) {
+      result[i] = std::make_exception_ptr(std::runtime_error(std::string(kAuthErrorCodeNames[i])));
+    }
+    return result;
+  }();
+  return errors;
+}
+
+} // namespace
+
+std::exception_ptr AuthError::toException() const {
+  if (!_message.empty()) return std::make_exception_ptr(std::runtime_error(_message));
+  return preallocatedErrors()[static_cast<size_t>(_code)];
+}
+
+} // namespace margelo::nitro::NitroAuth
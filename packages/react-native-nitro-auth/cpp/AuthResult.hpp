@@ -0,0 +1,142 @@
+#pragma once
+
+#include <array>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <variant>
+
+namespace margelo::nitro::NitroAuth {
+
+// Mirrors `AuthErrorCode` in Auth.nitro.ts, followed by the internal codes
+// that can still surface as a rejection message.
+enum class AuthErrorCode : uint8_t {
+  CANCELLED,
+  TIMEOUT,
+  POPUP_BLOCKED,
+  NETWORK_ERROR,
+  CONFIGURATION_ERROR,
+  NOT_SIGNED_IN,
+  OPERATION_IN_PROGRESS,
+  UNSUPPORTED_PROVIDER,
+  INVALID_STATE,
+  INVALID_NONCE,
+  TOKEN_ERROR,
+  NO_ID_TOKEN,
+  PARSE_ERROR,
+  REFRESH_FAILED,
+  UNKNOWN,
+  INVALID_GRANT,
+  DISPOSED,
+  INTERNAL_ERROR,
+  STORAGE_ERROR,
+};
+
+inline constexpr std::array<std::string_view, 19> kAuthErrorCodeNames = {
+  "cancelled",          "timeout",       "popup_blocked",  "network_error",        "configuration_error",
+  "not_signed_in",      "operation_in_progress",           "unsupported_provider", "invalid_state",
+  "invalid_nonce",      "token_error",   "no_id_token",    "parse_error",          "refresh_failed",
+  "unknown",            "invalid_grant", "disposed",       "internal_error",       "storage_error",
+};
+
+constexpr std::string_view toString(AuthErrorCode code) {
+  return kAuthErrorCodeNames[static_cast<size_t>(code)];
+}
+
+constexpr std::optional<AuthErrorCode> parseAuthErrorCode(std::string_view name) {
+  for (size_t i = 0; i < kAuthErrorCodeNames.size(); i++) {
+    if (kAuthErrorCodeNames[i] == name) return static_cast<AuthErrorCode>(i);
+  }
+  return std::nullopt;
+}
+
+// A failure inside the core. Known codes are a single byte; a platform message
+// outside the table (an Android or iOS SDK error string) keeps its text and
+// classifies as UNKNOWN, so it still reaches JS unchanged.
+class AuthError {
+public:
+  constexpr AuthError(AuthErrorCode code) : _code(code) {}
+  AuthError(std::string_view message) : _code(parseAuthErrorCode(message).value_or(AuthErrorCode::UNKNOWN)) {
+    if (_code == AuthErrorCode::UNKNOWN && message != toString(AuthErrorCode::UNKNOWN)) _message = message;
+  }
+  AuthError(const char* message) : AuthError(std::string_view(message)) {}
+  AuthError(const std::string& message) : AuthError(std::string_view(message)) {}
+
+  AuthErrorCode code() const { return _code; }
+  // The rejection message JS sees.
+  std::string_view message() const { return _message.empty() ? toString(_code) : std::string_view(_message); }
+
+  friend bool operator==(const AuthError& a, const AuthError& b) {
+    return a._code == b._code && a._message == b._message;
+  }
+
+  // The JSI boundary, defined in AuthResult.cpp, which is the only part of
+  // this header that needs exceptions. Known codes share one preallocated
+  // exception each, so a cancellation storm rejects without allocating.
+  std::exception_ptr toException() const;
+
+private:
+  AuthErrorCode _code;
+  std::string _message;
+};
+
+// The value of a core operation or the AuthError it failed with. Platform and
+// OIDC calls settle their promises with one, so only a promise handed to JS
+// ever rejects. Never throws: reading the wrong alternative is a programming
+// error and asserts.
+template <typename T>
+class Result {
+public:
+  Result(T value) : _state(std::in_place_index<0>, std::move(value)) {}
+  Result(AuthError error) : _state(std::in_place_index<1>, std::move(error)) {}
+  Result(AuthErrorCode code) : Result(AuthError(code)) {}
+
+  bool ok() const { return _state.index() == 0; }
+  explicit operator bool() const { return ok(); }
+
+  T& value() & {
+    assert(ok());
+    return *std::get_if<0>(&_state);
+  }
+  const T& value() const& {
+    assert(ok());
+    return *std::get_if<0>(&_state);
+  }
+  T&& value() && {
+    assert(ok());
+    return std::move(*std::get_if<0>(&_state));
+  }
+  const AuthError& error() const {
+    assert(!ok());
+    return *std::get_if<1>(&_state);
+  }
+
+private:
+  std::variant<T, AuthError> _state;
+};
+
+template <>
+class Result<void> {
+public:
+  Result() = default;
+  Result(AuthError error) : _error(std::move(error)) {}
+  Result(AuthErrorCode code) : _error(code) {}
+
+  bool ok() const { return !_error.has_value(); }
+  explicit operator bool() const { return ok(); }
+
+  const AuthError& error() const {
+    assert(!ok());
+    return *_error;
+  }
+
+private:
+  std::optional<AuthError> _error;
+};
+
+} // namespace margelo::nitro::NitroAuth
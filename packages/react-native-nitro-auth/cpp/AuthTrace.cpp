@@ -0,0 +1,194 @@
+#include "AuthTrace.hpp"
+
+namespace margelo::nitro::NitroAuth {
+
+namespace {
+
+constexpr std::string_view kMagic = "NATR";
+constexpr AuthProvider kLastProvider = AuthProvider::OIDC;
+// Field mask bits, in encoding order.
+constexpr uint8_t kHasProvider = 1 << 0;
+constexpr uint8_t kHasError = 1 << 1;
+constexpr uint8_t kHasAccount = 1 << 2;
+constexpr uint8_t kHasLifetime = 1 << 3;
+constexpr uint8_t kHasScopes = 1 << 4;
+constexpr uint8_t kKnownFields = (1 << 5) - 1;
+// A scope list longer than this is a corrupt trace, not a request.
+constexpr uint64_t kMaxScopes = 256;
+
+void writeVarint(std::string& out, uint64_t value) {
+  while (value >= 0x80) {
+    out.push_back(static_cast<char>((value & 0x7F) | 0x80));
+    value >>= 7;
+  }
+  out.push_back(static_cast<char>(value));
+}
+
+void writeSigned(std::string& out, int64_t value) {
+  writeVarint(out, (static_cast<uint64_t>(value) << 1) ^ static_cast<uint64_t>(value >> 63));
+}
+
+class Reader {
+public:
+  explicit Reader(std::string_view data) : _data(data) {}
+
+  bool atEnd() const { return _data.empty(); }
+
+  bool byte(uint8_t& out) {
+    if (_data.empty()) return false;
+    out = static_cast<uint8_t>(_data.front());
+    _data.remove_prefix(1);
+    return true;
+  }
+
+  bool varint(uint64_t& out) {
+    out = 0;
+    for (int shift = 0; shift < 64; shift += 7) {
+      uint8_t next;
+      if (!byte(next)) return false;
+      out |= static_cast<uint64_t>(next & 0x7F) << shift;
+      if ((next & 0x80) == 0) return true;
+    }
+    return false;
+  }
+
+  bool signedVarint(int64_t& out) {
+    uint64_t raw;
+    if (!varint(raw)) return false;
+    out = static_cast<int64_t>(raw >> 1) ^ -static_cast<int64_t>(raw & 1);
+    return true;
+  }
+
+  bool string(std::string& out) {
+    uint64_t size;
+    if (!varint(size) || size > _data.size()) return false;
+    out.assign(_data.substr(0, size));
+    _data.remove_prefix(size);
+    return true;
+  }
+
+private:
+  std::string_view _data;
+};
+
+} // namespace
+
+std::string AuthTraceFormat::encode(const std::vector<AuthTraceEvent>& events) {
+  std::string out(kMagic);
+  out.push_back(static_cast<char>(kVersion));
+  int64_t previousMs = 0;
+  for (const auto& event : events) {
+    writeSigned(out, event.atMs - previousMs);
+    previousMs = event.atMs;
+    out.push_back(static_cast<char>(event.op));
+    uint8_t fields = 0;
+    if (event.provider) fields |= kHasProvider;
+    if (event.error) fields |= kHasError;
+    if (event.account) fields |= kHasAccount;
+    if (event.lifetimeMs) fields |= kHasLifetime;
+    if (!event.scopes.empty()) fields |= kHasScopes;
+    out.push_back(static_cast<char>(fields));
+    if (event.provider) out.push_back(static_cast<char>(*event.provider));
+    if (event.error) out.push_back(static_cast<char>(*event.error));
+    if (event.account) writeVarint(out, *event.account);
+    if (event.lifetimeMs) writeSigned(out, *event.lifetimeMs);
+    if (!event.scopes.empty()) {
+      writeVarint(out, event.scopes.size());
+      for (const auto& scope : event.scopes) {
+        writeVarint(out, scope.size());
+        out += scope;
+      }
+    }
+  }
+  return out;
+}
+
+std::optional<std::vector<AuthTraceEvent>> AuthTraceFormat::decode(std::string_view data) {
+  if (data.substr(0, kMagic.size()) != kMagic) return std::nullopt;
+  Reader reader(data.substr(kMagic.size()));
+  uint8_t version;
+  if (!reader.byte(version) || version != kVersion) return std::nullopt;
+
+  std::vector<AuthTraceEvent> events;
+  int64_t atMs = 0;
+  while (!reader.atEnd()) {
+    AuthTraceEvent event;
+    int64_t delta;
+    uint8_t op, fields;
+    if (!reader.signedVarint(delta) || !reader.byte(op) || !reader.byte(fields)) return std::nullopt;
+    if (op >= kAuthTraceOpCount || (fields & ~kKnownFields) != 0) return std::nullopt;
+    atMs += delta;
+    event.atMs = atMs;
+    event.op = static_cast<AuthTraceOp>(op);
+    if (fields & kHasProvider) {
+      uint8_t provider;
+      if (!reader.byte(provider) || provider > static_cast<uint8_t>(kLastProvider)) return std::nullopt;
+      event.provider = static_cast<AuthProvider>(provider);
+    }
+    if (fields & kHasError) {
+      uint8_t error;
+      if (!reader.byte(error) || error >= kAuthErrorCodeNames.size()) return std::nullopt;
+      event.error = static_cast<AuthErrorCode>(error);
+    }
+    if (fields & kHasAccount) {
+      uint64_t account;
+      if (!reader.varint(account) || account > UINT32_MAX) return std::nullopt;
+      event.account = static_cast<uint32_t>(account);
+    }
+    if (fields & kHasLifetime) {
+      int64_t lifetime;
+      if (!reader.signedVarint(lifetime)) return std::nullopt;
+      event.lifetimeMs = lifetime;
+    }
+    if (fields & kHasScopes) {
+      uint64_t count;
+      if (!reader.varint(count) || count == 0 || count > kMaxScopes) return std::nullopt;
+      event.scopes.resize(count);
+      for (auto& scope : event.scopes) {
+        if (!reader.string(scope)) return std::nullopt;
+      }
+    }
+    events.push_back(std::move(event));
+  }
+  return events;
+}
+
+AuthTraceRecorder::AuthTraceRecorder(size_t maxEvents) : _maxEvents(maxEvents) {}
+
+void AuthTraceRecorder::record(AuthTraceEvent event) {
+  std::lock_guard<std::mutex> lock(_mutex);
+  if (_events.size() >= _maxEvents) {
+    _dropped++;
+    return;
+  }
+  _events.push_back(std::move(event));
+}
+
+uint32_t AuthTraceRecorder::accountOrdinal(const std::string& accountId) {
+  std::lock_guard<std::mutex> lock(_mutex);
+  return _accounts.try_emplace(accountId, static_cast<uint32_t>(_accounts.size())).first->second;
+}
+
+std::vector<AuthTraceEvent> AuthTraceRecorder::events() {
+  std::lock_guard<std::mutex> lock(_mutex);
+  return _events;
+}
+
+std::string AuthTraceRecorder::encode() {
+  std::lock_guard<std::mutex> lock(_mutex);
+  return AuthTraceFormat::encode(_events);
+}
+
+AuthTraceRecorderStats AuthTraceRecorder::stats() {
+  std::lock_guard<std::mutex> lock(_mutex);
+  return AuthTraceRecorderStats{_events.size(), _dropped, _accounts.size()};
+}
+
+void AuthTraceRecorder::clear() {
+  std::lock_guard<std::mutex> lock(_mutex);
+  _events.clear();
+  _accounts.clear();
+  _dropped = 0;
+}
+
+} // namespace margelo::nitro::NitroAuth
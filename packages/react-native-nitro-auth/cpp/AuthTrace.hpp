@@ -0,0 +1,102 @@
+#pragma once
+
+#include "AuthProvider.hpp"
+#include "AuthResult.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace margelo::nitro::NitroAuth {
+
+enum class AuthTraceOp : uint8_t {
+  // Core API calls, recorded when they are made.
+  LOGIN,
+  LOGOUT,
+  SILENT_RESTORE,
+  GET_ACCESS_TOKEN,
+  REFRESH_TOKEN,
+  SWITCH_ACCOUNT,
+  REQUEST_SCOPES,
+  REVOKE_ACCESS,
+  // Platform outcomes, recorded when the platform settles.
+  PLATFORM_LOGIN,
+  PLATFORM_REFRESH,
+  PLATFORM_RESTORE,
+};
+
+inline constexpr size_t kAuthTraceOpCount = static_cast<size_t>(AuthTraceOp::PLATFORM_RESTORE) + 1;
+
+constexpr bool isPlatformOutcome(AuthTraceOp op) {
+  return op >= AuthTraceOp::PLATFORM_LOGIN;
+}
+
+// One recorded call or outcome. Never holds tokens, emails or account ids:
+// accounts are numbered in the order the trace first saw them.
+struct AuthTraceEvent {
+  int64_t atMs = 0;
+  AuthTraceOp op = AuthTraceOp::LOGIN;
+  std::optional<AuthProvider> provider;
+  // Outcomes only: the error the platform settled with, nullopt for success.
+  // A restore that found no session is recorded as NOT_SIGNED_IN.
+  std::optional<AuthErrorCode> error;
+  // Calls: the account addressed, nullopt for the active one. Outcomes: the
+  // account signed in or refreshed.
+  std::optional<uint32_t> account;
+  // Successful outcomes: lifetime of the issued access token.
+  std::optional<int64_t> lifetimeMs;
+  // Resource token and incremental consent scopes.
+  std::vector<std::string> scopes;
+
+  friend bool operator==(const AuthTraceEvent&, const AuthTraceEvent&) = default;
+};
+
+// Compact binary trace: "NATR", a version byte, then per event a zigzag
+// varint time delta, the op, a field mask and the present fields (varints and
+// length-prefixed strings). A few bytes per event, so hours of traffic stay
+// small enough to ship from a device.
+class AuthTraceFormat {
+public:
+  static constexpr uint8_t kVersion = 1;
+
+  static std::string encode(const std::vector<AuthTraceEvent>& events);
+  // nullopt for anything that is not a complete trace of this version.
+  static std::optional<std::vector<AuthTraceEvent>> decode(std::string_view data);
+};
+
+struct AuthTraceRecorderStats {
+  size_t events = 0;
+  // Events refused because the recorder was full.
+  uint64_t dropped = 0;
+  size_t accounts = 0;
+};
+
+// Opt-in, thread-safe recorder installed with HybridAuth::setTraceRecorder().
+// Keeps the first `maxEvents` events and counts the rest as dropped.
+class AuthTraceRecorder {
+public:
+  explicit AuthTraceRecorder(size_t maxEvents = 64 * 1024);
+
+  void record(AuthTraceEvent event);
+  // The trace ordinal for `accountId`, assigned on first sight.
+  uint32_t accountOrdinal(const std::string& accountId);
+
+  std::vector<AuthTraceEvent> events();
+  std::string encode();
+  AuthTraceRecorderStats stats();
+  // Forgets events and account ordinals.
+  void clear();
+
+private:
+  const size_t _maxEvents;
+  std::mutex _mutex;
+  std::vector<AuthTraceEvent> _events;
+  std::unordered_map<std::string, uint32_t> _accounts;
+  uint64_t _dropped = 0;
+};
+
+} // namespace margelo::nitro::NitroAuth
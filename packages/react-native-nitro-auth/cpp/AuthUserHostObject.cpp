@@ -0,0 +1,86 @@
+#include "AuthUserHostObject.hpp"
+#include <string>
+
+namespace margelo::nitro::NitroAuth {
+
+namespace {
+
+enum class PropertyKind : uint8_t { PROVIDER, FIELD, SCOPES, EXPIRATION_TIME };
+
+struct Property {
+  const char* name;
+  PropertyKind kind;
+  AuthUserField field;
+};
+
+// The generated AuthUser's keys, in its order.
+constexpr std::array<Property, AuthUserHostObject::kPropertyCount> kProperties = {{
+  {"provider", PropertyKind::PROVIDER, AuthUserField::EMAIL},
+  {"email", PropertyKind::FIELD, AuthUserField::EMAIL},
+  {"name", PropertyKind::FIELD, AuthUserField::NAME},
+  {"photo", PropertyKind::FIELD, AuthUserField::PHOTO},
+  {"idToken", PropertyKind::FIELD, AuthUserField::ID_TOKEN},
+  {"accessToken", PropertyKind::FIELD, AuthUserField::ACCESS_TOKEN},
+  {"refreshToken", PropertyKind::FIELD, AuthUserField::REFRESH_TOKEN},
+  {"serverAuthCode", PropertyKind::FIELD, AuthUserField::SERVER_AUTH_CODE},
+  {"authorizationCode", PropertyKind::FIELD, AuthUserField::AUTHORIZATION_CODE},
+  {"userId", PropertyKind::FIELD, AuthUserField::USER_ID},
+  {"phoneNumber", PropertyKind::FIELD, AuthUserField::PHONE_NUMBER},
+  {"hostedDomain", PropertyKind::FIELD, AuthUserField::HOSTED_DOMAIN},
+  {"scopes", PropertyKind::SCOPES, AuthUserField::EMAIL},
+  {"expirationTime", PropertyKind::EXPIRATION_TIME, AuthUserField::EMAIL},
+  {"underlyingError", PropertyKind::FIELD, AuthUserField::UNDERLYING_ERROR},
+}};
+
+std::optional<size_t> propertyIndex(const std::string& name) {
+  for (size_t i = 0; i < kProperties.size(); i++) {
+    if (name == kProperties[i].name) return i;
+  }
+  return std::nullopt;
+}
+
+} // namespace
+
+jsi::Value AuthUserHostObject::get(jsi::Runtime& runtime, const jsi::PropNameID& name) {
+  const auto index = propertyIndex(name.utf8(runtime));
+  if (!index) return jsi::Value::undefined();
+  auto& value = _values[*index];
+  if (!value) value.emplace(convert(runtime, *index));
+  return jsi::Value(runtime, *value);
+}
+
+void AuthUserHostObject::set(jsi::Runtime& runtime, const jsi::PropNameID& name, const jsi::Value&) {
+  throw jsi::JSError(runtime, "Cannot assign to '" + name.utf8(runtime) + "': the current user is read-only");
+}
+
+std::vector<jsi::PropNameID> AuthUserHostObject::getPropertyNames(jsi::Runtime& runtime) {
+  std::vector<jsi::PropNameID> names;
+  names.reserve(kProperties.size());
+  for (const auto& property : kProperties) names.push_back(jsi::PropNameID::forAscii(runtime, property.name));
+  return names;
+}
+
+size_t AuthUserHostObject::materializedCount() const {
+  size_t count = 0;
+  for (const auto& value : _values) count += value.has_value();
+  return count;
+}
+
+jsi::Value AuthUserHostObject::convert(jsi::Runtime& runtime, size_t index) const {
+  const auto& property = kProperties[index];
+  switch (property.kind) {
+    case PropertyKind::PROVIDER:
+      return JSIConverter<AuthProvider>::toJSI(runtime, _user.provider());
+    case PropertyKind::FIELD: {
+      const auto view = _user.view(property.field);
+      return view ? JSIConverter<std::string>::toJSI(runtime, std::string(*view)) : jsi::Value::undefined();
+    }
+    case PropertyKind::SCOPES:
+      return JSIConverter<std::optional<std::vector<std::string>>>::toJSI(runtime, _user.scopes());
+    case PropertyKind::EXPIRATION_TIME:
+      return JSIConverter<std::optional<double>>::toJSI(runtime, _user.expirationTime());
+  }
+  return jsi::Value::undefined();
+}
+
+} // namespace margelo::nitro::NitroAuth
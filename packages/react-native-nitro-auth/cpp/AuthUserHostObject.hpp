@@ -0,0 +1,40 @@
+#pragma once
+
+#include "PackedAuthUser.hpp"
+#include <NitroModules/JSIConverter.hpp>
+#include <array>
+#include <cstddef>
+#include <optional>
+#include <vector>
+
+namespace margelo::nitro::NitroAuth {
+
+using namespace facebook;
+
+// Read-only JS view of one immutable session snapshot, returned by
+// `getCurrentUserView()` instead of a converted AuthUser object. A property is
+// converted on its first read and reused after that, so a render that reads
+// `email` and `name` pays for two strings instead of the whole user. Lists the
+// same keys as the converted object. JS thread only.
+class AuthUserHostObject final : public jsi::HostObject {
+public:
+  static constexpr size_t kPropertyCount = kAuthUserFieldCount + 3;
+
+  explicit AuthUserHostObject(PackedAuthUser user) : _user(std::move(user)) {}
+
+  jsi::Value get(jsi::Runtime& runtime, const jsi::PropNameID& name) override;
+  void set(jsi::Runtime& runtime, const jsi::PropNameID& name, const jsi::Value& value) override;
+  std::vector<jsi::PropNameID> getPropertyNames(jsi::Runtime& runtime) override;
+
+  const PackedAuthUser& user() const { return _user; }
+  size_t materializedCount() const;
+
+private:
+  jsi::Value convert(jsi::Runtime& runtime, size_t property) const;
+
+private:
+  const PackedAuthUser _user;
+  std::array<std::optional<jsi::Value>, kPropertyCount> _values;
+};
+
+} // namespace margelo::nitro::NitroAuth
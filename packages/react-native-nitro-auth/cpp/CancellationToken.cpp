@@ -0,0 +1,63 @@
+#include "CancellationToken.hpp"
+#include <vector>
+
+namespace margelo::nitro::NitroAuth {
+
+std::shared_ptr<CancellationToken> CancellationToken::create() {
+  return std::make_shared<CancellationToken>();
+}
+
+void CancellationToken::cancel(const std::string& reason) {
+  std::vector<Listener> listeners;
+  {
+    std::lock_guard<std::mutex> lock(_mutex);
+    if (_reason) {
+      return;
+    }
+    _reason = reason;
+    listeners.reserve(_listeners.size());
+    for (auto& [id, listener] : _listeners) {
+      listeners.push_back(std::move(listener));
+    }
+    _listeners.clear();
+  }
+  for (const auto& listener : listeners) {
+    try {
+      listener(reason);
+    } catch (...) {
+      // Listener failures are isolated so every operation bound to the token is released.
+    }
+  }
+}
+
+bool CancellationToken::isCancelled() const {
+  std::lock_guard<std::mutex> lock(_mutex);
+  return _reason.has_value();
+}
+
+std::optional<std::string> CancellationToken::reason() const {
+  std::lock_guard<std::mutex> lock(_mutex);
+  return _reason;
+}
+
+CancellationToken::ListenerId CancellationToken::onCancelled(Listener listener) {
+  std::optional<std::string> reason;
+  {
+    std::lock_guard<std::mutex> lock(_mutex);
+    if (!_reason) {
+      ListenerId id = _nextListenerId++;
+      _listeners.emplace(id, std::move(listener));
+      return id;
+    }
+    reason = _reason;
+  }
+  listener(*reason);
+  return 0;
+}
+
+void CancellationToken::removeListener(ListenerId id) {
+  std::lock_guard<std::mutex> lock(_mutex);
+  _listeners.erase(id);
+}
+
+} // namespace margelo::nitro::NitroAuth
@@ -0,0 +1,38 @@
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+
+namespace margelo::nitro::NitroAuth {
+
+// Caller-owned handle that aborts a native auth operation. Cancelling releases
+// the platform slot held by the operation and settles its promise.
+class CancellationToken {
+public:
+  using Listener = std::function<void(const std::string& /* reason */)>;
+  using ListenerId = uint64_t;
+
+  static std::shared_ptr<CancellationToken> create();
+
+  // Only the first call has an effect; later calls keep the original reason.
+  void cancel(const std::string& reason = "cancelled");
+  bool isCancelled() const;
+  std::optional<std::string> reason() const;
+
+  // Runs `listener` immediately (and returns 0) if the token is already cancelled.
+  ListenerId onCancelled(Listener listener);
+  void removeListener(ListenerId id);
+
+private:
+  mutable std::mutex _mutex;
+  std::optional<std::string> _reason;
+  std::map<ListenerId, Listener> _listeners;
+  ListenerId _nextListenerId = 1;
+};
+
+} // namespace margelo::nitro::NitroAuth
@@ -0,0 +1,59 @@
+#include "ClockSkew.hpp"
+#include <algorithm>
+#include <utility>
+
+namespace margelo::nitro::NitroAuth {
+
+ClockSkewEstimator::ClockSkewEstimator(std::shared_ptr<AuthClock> clock) : _clock(std::move(clock)) {}
+
+void ClockSkewEstimator::observe(int64_t serverTimeMs) {
+  std::lock_guard<std::mutex> lock(_mutex);
+  const int64_t sampleMs = serverTimeMs - _clock->nowMs();
+  if (sampleMs > kMaxSkewMs || sampleMs < -kMaxSkewMs) {
+    _rejectedSamples++;
+    return;
+  }
+  _samples.push_back(sampleMs);
+  if (_samples.size() > kMaxSamples) _samples.pop_front();
+  _skewMs = *std::max_element(_samples.begin(), _samples.end());
+}
+
+int64_t ClockSkewEstimator::skewMs() {
+  std::lock_guard<std::mutex> lock(_mutex);
+  return _skewMs;
+}
+
+ClockSkewEstimate ClockSkewEstimator::estimate() {
+  std::lock_guard<std::mutex> lock(_mutex);
+  return ClockSkewEstimate{_skewMs, _samples.size(), _rejectedSamples};
+}
+
+void ClockSkewEstimator::setClock(std::shared_ptr<AuthClock> clock) {
+  std::lock_guard<std::mutex> lock(_mutex);
+  _clock = std::move(clock);
+  // Samples taken against another clock say nothing about this one.
+  _samples.clear();
+  _skewMs = 0;
+}
+
+ClockSkewSamplingHttpClient::ClockSkewSamplingHttpClient(std::shared_ptr<HttpClient> inner,
+                                                         std::shared_ptr<ClockSkewEstimator> clockSkew)
+  : _inner(std::move(inner)), _clockSkew(std::move(clockSkew)) {}
+
+std::shared_ptr<HttpClient> ClockSkewSamplingHttpClient::wrap(std::shared_ptr<HttpClient> inner,
+                                                              std::shared_ptr<ClockSkewEstimator> clockSkew) {
+  if (!inner) return nullptr;
+  return std::make_shared<ClockSkewSamplingHttpClient>(std::move(inner), std::move(clockSkew));
+}
+
+void ClockSkewSamplingHttpClient::send(const HttpRequest& request, Completion completion) {
+  _inner->send(request, [clockSkew = _clockSkew, completion = std::move(completion)](HttpResponse response) {
+    auto date = response.headers.find("date");
+    if (date != response.headers.end()) {
+      if (auto serverTimeMs = parseHttpDateMs(date->second)) clockSkew->observe(*serverTimeMs);
+    }
+    completion(std::move(response));
+  });
+}
+
+} // namespace margelo::nitro::NitroAuth
@@ -0,0 +1,74 @@
+#pragma once
+
+#include "AuthClock.hpp"
+#include "HttpClient.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+
+namespace margelo::nitro::NitroAuth {
+
+struct RefreshTimingPolicy {
+  // Tokens are refreshed this long before they expire.
+  int64_t refreshWindowMs = 5 * 60 * 1000;
+  // Expiries stamped by the server's clock (an id_token `exp`) are moved onto
+  // the device clock using the estimated skew before they are compared.
+  bool correctClockSkew = true;
+};
+
+struct ClockSkewEstimate {
+  // Server clock minus device clock; 0 until a sample arrives.
+  int64_t skewMs = 0;
+  size_t samples = 0;
+  // Samples further than `ClockSkewEstimator::kMaxSkewMs` from the device clock.
+  uint64_t rejectedSamples = 0;
+};
+
+// Estimates how far the device clock is from the servers' from timestamps the
+// servers stamped themselves: the `iat` of freshly issued tokens and HTTP
+// `Date` headers. Each sample was taken before it reached the device, so it
+// only bounds the skew from below; the estimate is the largest of the recent
+// samples, which discards old cached tokens and network latency alike.
+// Thread-safe: HTTP completions report samples from other threads.
+class ClockSkewEstimator {
+public:
+  static constexpr size_t kMaxSamples = 8;
+  // A clock off by more than a day is more likely a bogus timestamp than a bad device.
+  static constexpr int64_t kMaxSkewMs = 24 * 60 * 60 * 1000;
+
+  explicit ClockSkewEstimator(std::shared_ptr<AuthClock> clock = AuthClock::system());
+
+  // `serverTimeMs` was read off a server clock no later than now.
+  void observe(int64_t serverTimeMs);
+  int64_t skewMs();
+  ClockSkewEstimate estimate();
+  void setClock(std::shared_ptr<AuthClock> clock);
+
+private:
+  std::mutex _mutex;
+  std::shared_ptr<AuthClock> _clock;
+  // Oldest first.
+  std::deque<int64_t> _samples;
+  int64_t _skewMs = 0;
+  uint64_t _rejectedSamples = 0;
+};
+
+// Reports the `Date` header of every response to a skew estimator.
+class ClockSkewSamplingHttpClient final : public HttpClient {
+public:
+  ClockSkewSamplingHttpClient(std::shared_ptr<HttpClient> inner, std::shared_ptr<ClockSkewEstimator> clockSkew);
+
+  // nullptr when there is no transport to wrap.
+  static std::shared_ptr<HttpClient> wrap(std::shared_ptr<HttpClient> inner,
+                                          std::shared_ptr<ClockSkewEstimator> clockSkew);
+
+  void send(const HttpRequest& request, Completion completion) override;
+
+private:
+  const std::shared_ptr<HttpClient> _inner;
+  const std::shared_ptr<ClockSkewEstimator> _clockSkew;
+};
+
+} // namespace margelo::nitro::NitroAuth
@@ -0,0 +1,71 @@
+#pragma once
+
+#include <cstdint>
+#include <cstdio>
+#include <functional>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace margelo::nitro::NitroAuth {
+
+struct HttpRequest {
+  std::string method = "GET";
+  std::string url;
+  std::vector<std::pair<std::string, std::string>> headers;
+  std::string body;
+  int64_t timeoutMs = 15 * 1000;
+};
+
+struct HttpResponse {
+  // 0 when no HTTP response arrived (DNS, TLS, timeout, offline).
+  int status = 0;
+  std::string body;
+  // Header names are lower-cased.
+  std::unordered_map<std::string, std::string> headers;
+};
+
+// Days since 1970-01-01 for a proleptic Gregorian date.
+inline int64_t daysFromCivil(int64_t year, unsigned month, unsigned day) {
+  year -= month <= 2;
+  const int64_t era = (year >= 0 ? year : year - 399) / 400;
+  const auto yearOfEra = static_cast<unsigned>(year - era * 400);
+  const unsigned dayOfYear = (153 * (month > 2 ? month - 3 : month + 9) + 2) / 5 + day - 1;
+  const unsigned dayOfEra = yearOfEra * 365 + yearOfEra / 4 - yearOfEra / 100 + dayOfYear;
+  return era * 146097 + static_cast<int64_t>(dayOfEra) - 719468;
+}
+
+// IMF-fixdate ("Sun, 06 Nov 1994 08:49:37 GMT"), the only format servers may send.
+inline std::optional<int64_t> parseHttpDateMs(const std::string& value) {
+  static constexpr const char* kMonths[] = {"Jan", "Feb", "Mar", "Apr", "May", "Jun",
+                                            "Jul", "Aug", "Sep", "Oct", "Nov", "Dec"};
+  int day = 0, year = 0, hour = 0, minute = 0, second = 0;
+  char month[4] = {};
+  if (std::sscanf(value.c_str(), "%*3s, %2d %3s %4d %2d:%2d:%2d GMT", &day, month, &year, &hour, &minute, &second) != 6) {
+    return std::nullopt;
+  }
+  for (unsigned index = 0; index < 12; ++index) {
+    if (std::string_view(month) == kMonths[index]) {
+      const int64_t days = daysFromCivil(year, index + 1, static_cast<unsigned>(day));
+      return ((days * 24 + hour) * 60 + minute) * 60000 + second * 1000;
+    }
+  }
+  return std::nullopt;
+}
+
+// Minimal transport for the native core's own HTTP calls (OpenID discovery,
+// JWKS). The platform bindings back it with NSURLSession / HttpURLConnection.
+class HttpClient {
+public:
+  using Completion = std::function<void(HttpResponse)>;
+
+  virtual ~HttpClient() = default;
+
+  // `completion` runs exactly once, possibly on another thread.
+  virtual void send(const HttpRequest& request, Completion completion) = 0;
+};
+
+} // namespace margelo::nitro::NitroAuth
@@ -1,10 +1,14 @@
 #include "HybridAuth.hpp"
+#include "AuthResult.hpp"
 #include "PlatformAuth.hpp"
+#include "MicrosoftAuthority.hpp"
 #include <algorithm>
-#include <chrono>
+#include <atomic>
+#include <cstdlib>
 #include <exception>
 #include <iostream>
 #include <stdexcept>
+#include <string_view>
 #include <unordered_set>
 
 #if defined(__ANDROID__)
@@ -15,19 +19,62 @@ namespace margelo::nitro::NitroAuth {
 
 namespace {
 
-std::exception_ptr makeAuthError(const char* message) {
-  return std::make_exception_ptr(std::runtime_error(message));
+constexpr auto kGoogleAuthority = "https://accounts.google.com";
+constexpr auto kAppleAuthority = "https://appleid.apple.com";
+
+// Failures stay AuthErrors inside the core; this is where they become the
+// exception_ptr a Nitro promise rejects with.
+std::exception_ptr makeAuthError(const AuthError& error) {
+  return error.toException();
+}
+
+// The authority whose JWKS signs `provider`'s id_tokens. Microsoft keys are per
+// tenant, so its authority is the (not yet verified) issuer of the token itself;
+// a generic OIDC provider's is the configured issuer.
+std::optional<std::string> idTokenAuthorityFor(AuthProvider provider, const std::string& issuer,
+                                               const std::optional<OidcProviderConfig>& oidc) {
+  switch (provider) {
+    case AuthProvider::GOOGLE:
+      return kGoogleAuthority;
+    case AuthProvider::APPLE:
+      return kAppleAuthority;
+    case AuthProvider::MICROSOFT:
+      if (MicrosoftAuthority::isEntraIssuer(issuer)) return issuer;
+      return std::nullopt;
+    case AuthProvider::OIDC:
+      if (oidc) return oidc->issuer;
+      return std::nullopt;
+  }
+  return std::nullopt;
 }
 
-void rejectIfPending(const std::shared_ptr<Promise<AuthTokens>>& promise, const char* message) {
+IdTokenClaims toIdTokenClaims(const IdTokenPayload& payload) {
+  IdTokenClaims claims;
+  claims.issuer = payload.issuer;
+  claims.subject = payload.subject;
+  claims.audience = payload.audiences;
+  claims.expiresAt = static_cast<double>(payload.expiresAtMs);
+  if (payload.issuedAtMs) claims.issuedAt = static_cast<double>(*payload.issuedAtMs);
+  claims.nonce = payload.nonce;
+  claims.email = payload.email;
+  return claims;
+}
+
+void rejectIfPending(const std::shared_ptr<Promise<AuthTokens>>& promise, const AuthError& error) {
   if (promise && promise->isPending()) {
-    promise->reject(makeAuthError(message));
+    promise->reject(makeAuthError(error));
+  }
+}
+
+void rejectIfPending(const std::vector<std::shared_ptr<Promise<AuthTokens>>>& promises, const AuthError& error) {
+  for (const auto& promise : promises) {
+    rejectIfPending(promise, error);
   }
 }
 
-void rejectIfPending(const std::shared_ptr<Promise<void>>& promise, const char* message) {
+void rejectIfPending(const std::shared_ptr<Promise<void>>& promise, const AuthError& error) {
   if (promise && promise->isPending()) {
-    promise->reject(makeAuthError(message));
+    promise->reject(makeAuthError(error));
   }
 }
 
@@ -37,9 +84,9 @@ void resolveIfPending(const std::shared_ptr<Promise<void>>& promise) {
   }
 }
 
-void rejectPendingSessionPromises(const std::vector<std::shared_ptr<Promise<void>>>& promises, const char* message) {
+void rejectPendingSessionPromises(const std::vector<std::shared_ptr<Promise<void>>>& promises, const AuthError& error) {
   for (const auto& promise : promises) {
-    rejectIfPending(promise, message);
+    rejectIfPending(promise, error);
   }
 }
 
@@ -77,6 +124,21 @@ void removeGrantedScopes(std::vector<std::string>& grantedScopes, const std::vec
   );
 }
 
+// The `sub` of an id_token, unverified; nullopt when there is none to compare.
+std::optional<std::string> subjectOf(const std::optional<std::string>& idToken) {
+  if (!idToken || idToken->empty()) return std::nullopt;
+  auto payload = IdTokenVerifier::decodeUnverified(*idToken);
+  if (!payload || payload->subject.empty()) return std::nullopt;
+  return payload->subject;
+}
+
+// An id_token returned by a refresh must name the user the account already holds.
+bool idTokenMatchesAccount(const AccountSession& account, const std::optional<std::string>& idToken) {
+  auto refreshed = subjectOf(idToken);
+  auto current = subjectOf(account.user.get(AuthUserField::ID_TOKEN));
+  return !refreshed || !current || *refreshed == *current;
+}
+
 template <typename TCallback, typename TValue>
 void invokeListenersSafely(const std::vector<TCallback>& listeners, const TValue& value) {
   for (const auto& listener : listeners) {
@@ -90,30 +152,395 @@ void invokeListenersSafely(const std::vector<TCallback>& listeners, const TValue
 
 } // namespace
 
-HybridAuth::HybridAuth() : HybridObject(TAG) {
-  // In-memory only - no internal persistence.
+// Binds one platform operation to its deadline and cancellation token. The first
+// of settle()/abort() wins; abort() releases the platform slot before settling.
+class OperationWatch : public std::enable_shared_from_this<OperationWatch> {
+public:
+  OperationWatch(PlatformOperation operation, std::shared_ptr<TimerService> timerService,
+                 std::shared_ptr<CancellationToken> cancellation)
+    : _operation(operation), _timerService(std::move(timerService)), _cancellation(std::move(cancellation)) {}
+
+  void arm(int64_t deadlineMs, std::function<void(const std::string&)> onAbort) {
+    _onAbort = std::move(onAbort);
+    std::weak_ptr<OperationWatch> weak = shared_from_this();
+    if (deadlineMs > 0 && _timerService) {
+      auto timerId = _timerService->schedule(deadlineMs, [weak]() {
+        if (auto watch = weak.lock()) watch->abort("timeout");
+      });
+      std::lock_guard<std::mutex> lock(_mutex);
+      _timerId = timerId;
+    }
+    if (_cancellation) {
+      auto listenerId = _cancellation->onCancelled([weak](const std::string& reason) {
+        if (auto watch = weak.lock()) watch->abort(reason);
+      });
+      std::lock_guard<std::mutex> lock(_mutex);
+      _listenerId = listenerId;
+    }
+  }
+
+  // Returns false when the operation was already aborted and its result must be dropped.
+  bool settle() {
+    if (_finished.exchange(true)) {
+      return false;
+    }
+    disarm();
+    return true;
+  }
+
+  void abort(const std::string& reason) {
+    if (_finished.exchange(true)) {
+      return;
+    }
+    disarm();
+    PlatformAuth::cancel(_operation, reason);
+    if (_onAbort) {
+      _onAbort(reason);
+    }
+  }
+
+private:
+  void disarm() {
+    std::optional<TimerService::TimerId> timerId;
+    CancellationToken::ListenerId listenerId = 0;
+    {
+      std::lock_guard<std::mutex> lock(_mutex);
+      timerId = _timerId;
+      listenerId = _listenerId;
+    }
+    if (timerId && _timerService) _timerService->cancel(*timerId);
+    if (listenerId != 0 && _cancellation) _cancellation->removeListener(listenerId);
+  }
+
+private:
+  PlatformOperation _operation;
+  std::shared_ptr<TimerService> _timerService;
+  std::shared_ptr<CancellationToken> _cancellation;
+  std::function<void(const std::string&)> _onAbort;
+  std::mutex _mutex;
+  std::optional<TimerService::TimerId> _timerId;
+  CancellationToken::ListenerId _listenerId = 0;
+  std::atomic<bool> _finished{false};
+};
+
+HybridAuth::HybridAuth()
+  : HybridObject(TAG), _timerService(TimerService::shared()), _clock(AuthClock::system()) {
+  // In-memory only unless a native SessionStore is installed.
+  OidcMetadataOptions metadataOptions;
+  metadataOptions.cacheDirectory = PlatformAuth::cacheDirectory();
+  _metadata = std::make_shared<OidcMetadataCache>(
+      ClockSkewSamplingHttpClient::wrap(PlatformAuth::httpClient(), _clockSkew), metadataOptions);
+  // Warm discovery and JWKS off-thread so later sign-ins skip that round trip.
+  _metadata->prefetch(PlatformAuth::discoveryAuthorities());
+}
+
+void HybridAuth::setOperationDeadlines(const OperationDeadlines& deadlines) {
+  std::lock_guard<std::recursive_mutex> lock(_mutex);
+  _deadlines = deadlines;
+}
+
+void HybridAuth::setTimerService(const std::shared_ptr<TimerService>& timerService) {
+  std::lock_guard<std::recursive_mutex> lock(_mutex);
+  _timerService = timerService;
+  _oidc = nullptr;
+}
+
+void HybridAuth::setClock(const std::shared_ptr<AuthClock>& clock) {
+  std::lock_guard<std::recursive_mutex> lock(_mutex);
+  _clock = clock;
+  _clockSkew->setClock(clock);
+  _oidc = nullptr;
+}
+
+void HybridAuth::setRefreshTimingPolicy(const RefreshTimingPolicy& policy) {
+  std::lock_guard<std::recursive_mutex> lock(_mutex);
+  _refreshTiming = policy;
+}
+
+ClockSkewEstimate HybridAuth::getClockSkewEstimate() {
+  return _clockSkew->estimate();
+}
+
+void HybridAuth::setRefreshBackoffPolicy(const RefreshBackoffPolicy& policy) {
+  std::lock_guard<std::recursive_mutex> lock(_mutex);
+  _refreshBackoffPolicy = policy;
+  _signedOutRefresh.backoff = RefreshBackoff(policy);
+  _accounts.forEach([&policy](AccountSession& account) { account.refresh.backoff = RefreshBackoff(policy); });
+}
+
+void HybridAuth::setSessionStore(const std::shared_ptr<SessionStore>& store) {
+  bool restored = false;
+  {
+    std::lock_guard<std::recursive_mutex> lock(_mutex);
+    _sessionStore = store;
+    if (!_sessionStore) return;
+    if (_accounts.active()) {
+      persistSessionLocked();
+    } else if (auto user = _sessionStore->load()) {
+      auto grantedScopes = user->scopes.value_or(std::vector<std::string>{});
+      auto account = _accounts.upsert(std::move(*user), _refreshBackoffPolicy);
+      account->grantedScopes = std::move(grantedScopes);
+      observeIssuedTokensLocked(*account, false);
+      restored = true;
+    }
+  }
+  if (restored) notifyAuthStateChanged();
+}
+
+// Called with _mutex held so the store sees changes in session order; stores only queue.
+void HybridAuth::persistSessionLocked() {
+  publishSharedSessionLocked();
+  if (!_sessionStore) return;
+  const auto& active = _accounts.active();
+  _sessionStore->saveUser(active ? std::make_optional(active->user.unpack()) : std::nullopt);
+}
+
+void HybridAuth::setSharedSession(const std::shared_ptr<SharedSessionSegment>& segment) {
+  std::lock_guard<std::recursive_mutex> lock(_mutex);
+  _sharedSession = segment;
+  publishSharedSessionLocked();
+}
+
+// Under _mutex, so other processes see tokens in the order this one adopted them.
+void HybridAuth::publishSharedSessionLocked() {
+  if (!_sharedSession) return;
+  const auto& active = _accounts.active();
+  const auto accessToken = active ? active->user.view(AuthUserField::ACCESS_TOKEN) : std::nullopt;
+  if (!accessToken) {
+    _sharedSession->clear();
+    return;
+  }
+  SharedSession session;
+  session.accountId = active->id;
+  session.accessToken = std::string(*accessToken);
+  if (const auto expirationTime = active->user.expirationTime()) {
+    session.expirationTime = static_cast<double>(deviceExpiryLocked(*expirationTime, active->expiresInServerTime));
+  }
+  if (!_sharedSession->publish(session)) {
+    // Never leave readers with the previous token once this one is current.
+    _sharedSession->clear();
+    log("shared session token too large to publish");
+  }
+}
+
+RefreshTokenUpdate HybridAuth::adoptRefreshTokenLocked(AccountSession& account,
+                                                       const std::optional<std::string>& refreshToken) {
+  auto current = account.user.get(AuthUserField::REFRESH_TOKEN);
+  auto update = account.refreshTokens.apply(current, refreshToken);
+  if (update == RefreshTokenUpdate::ROTATED) {
+    account.user = account.user.with(AuthUserField::REFRESH_TOKEN, current);
+    _refreshTokenStats.rotations++;
+  } else if (update == RefreshTokenUpdate::REUSED) {
+    _refreshTokenStats.reusesRejected++;
+    log("refresh token reuse rejected");
+  }
+  return update;
+}
+
+void HybridAuth::observeIssuedTokensLocked(AccountSession& account, bool isFresh) {
+  account.expiresInServerTime = false;
+  const auto idToken = account.user.view(AuthUserField::ID_TOKEN);
+  if (!idToken) return;
+  auto claims = IdTokenVerifier::decodeUnverified(std::string(*idToken));
+  if (!claims) return;
+  // Only a token the server just issued says what its clock reads now; a restored one is hours old.
+  if (isFresh && claims->issuedAtMs) _clockSkew->observe(*claims->issuedAtMs);
+  if (const auto expirationTime = account.user.expirationTime()) {
+    const auto expirationMs = static_cast<int64_t>(*expirationTime);
+    account.expiresInServerTime = std::abs(expirationMs - claims->expiresAtMs) < 1000;
+  }
+}
+
+int64_t HybridAuth::deviceExpiryLocked(double expirationTime, bool isServerTime) {
+  const auto expiryMs = static_cast<int64_t>(expirationTime);
+  if (!isServerTime || !_refreshTiming.correctClockSkew) return expiryMs;
+  return expiryMs - _clockSkew->skewMs();
+}
+
+int64_t HybridAuth::nowMs() {
+  std::shared_ptr<AuthClock> clock;
+  {
+    std::lock_guard<std::recursive_mutex> lock(_mutex);
+    clock = _clock;
+  }
+  return clock->nowMs();
+}
+
+std::shared_ptr<OperationWatch> HybridAuth::watchOperation(
+  PlatformOperation operation,
+  const std::shared_ptr<CancellationToken>& cancellation,
+  std::function<void(const std::string&)> onAbort
+) {
+  int64_t deadlineMs = 0;
+  std::shared_ptr<TimerService> timerService;
+  {
+    std::lock_guard<std::recursive_mutex> lock(_mutex);
+    timerService = _timerService;
+    switch (operation) {
+      case PlatformOperation::LOGIN: deadlineMs = _deadlines.loginMs; break;
+      case PlatformOperation::REQUEST_SCOPES: deadlineMs = _deadlines.requestScopesMs; break;
+      case PlatformOperation::REFRESH_TOKEN: deadlineMs = _deadlines.refreshTokenMs; break;
+      case PlatformOperation::SILENT_RESTORE: deadlineMs = _deadlines.silentRestoreMs; break;
+    }
+  }
+  // Lives as long as the platform call it watches, so it also counts calls in flight.
+  auto watch = std::allocate_shared<OperationWatch>(
+    TrackedAllocator<OperationWatch, MemorySubsystem::PLATFORM_OPERATIONS>(), operation, std::move(timerService),
+    cancellation);
+  watch->arm(deadlineMs, std::move(onAbort));
+  return watch;
+}
+
+void HybridAuth::abortInteractiveOperation(PlatformOperation operation) {
+  std::shared_ptr<OperationWatch> watch;
+  {
+    std::lock_guard<std::recursive_mutex> lock(_mutex);
+    auto& slot = operation == PlatformOperation::LOGIN ? _loginWatch : _scopesWatch;
+    watch = slot.lock();
+    slot.reset();
+  }
+  if (watch) watch->abort("cancelled");
+}
+
+void HybridAuth::forgetInteractiveOperation(PlatformOperation operation, const std::shared_ptr<OperationWatch>& watch) {
+  std::lock_guard<std::recursive_mutex> lock(_mutex);
+  auto& slot = operation == PlatformOperation::LOGIN ? _loginWatch : _scopesWatch;
+  if (slot.lock() == watch) slot.reset();
+}
+
+void HybridAuth::loadHybridMethods() {
+  HybridAuthSpec::loadHybridMethods();
+  registerHybrids(this, [](Prototype& prototype) {
+    // Not in the nitro spec: it returns a HostObject, not a converted struct.
+    prototype.registerRawHybridMethod("getCurrentUserView", 0, &HybridAuth::getCurrentUserView);
+  });
+}
+
+std::optional<PackedAuthUser> HybridAuth::getCurrentUserSnapshot() {
+  std::lock_guard<std::recursive_mutex> lock(_mutex);
+  const auto& active = _accounts.active();
+  if (!active) return std::nullopt;
+  return active->user;
+}
+
+jsi::Value HybridAuth::getCurrentUserView(jsi::Runtime& runtime, const jsi::Value&, const jsi::Value*, size_t) {
+  std::shared_ptr<AuthUserHostObject> view;
+  {
+    std::lock_guard<std::recursive_mutex> lock(_mutex);
+    const auto& active = _accounts.active();
+    if (!active) return jsi::Value::undefined();
+    view = _userView.lock();
+    if (!view || !view->user().isSameSnapshot(active->user)) {
+      view = std::make_shared<AuthUserHostObject>(active->user);
+      _userView = view;
+    }
+  }
+  return jsi::Object::createFromHostObject(runtime, view);
 }
 
 std::optional<AuthUser> HybridAuth::getCurrentUser() {
   std::lock_guard<std::recursive_mutex> lock(_mutex);
-  return _currentUser;
+  const auto& active = _accounts.active();
+  if (!active) return std::nullopt;
+  return active->user.unpack();
 }
 
 std::vector<std::string> HybridAuth::getGrantedScopes() {
   std::lock_guard<std::recursive_mutex> lock(_mutex);
-  return _grantedScopes;
+  const auto& active = _accounts.active();
+  if (!active) return {};
+  return active->grantedScopes;
+}
+
+SessionSnapshot HybridAuth::getSessionSnapshot() {
+  std::lock_guard<std::recursive_mutex> lock(_mutex);
+  SessionSnapshot snapshot;
+  snapshot.hasValidAccessToken = false;
+  snapshot.version = static_cast<double>(sessionVersionLocked());
+  const auto& active = _accounts.active();
+  if (!active) return snapshot;
+  snapshot.user = active->user.unpack();
+  snapshot.scopes = active->grantedScopes;
+  if (active->user.has(AuthUserField::ACCESS_TOKEN)) {
+    snapshot.hasValidAccessToken = true;
+    if (const auto expirationTime = active->user.expirationTime()) {
+      const int64_t remainingMs = deviceExpiryLocked(*expirationTime, active->expiresInServerTime) - nowMs();
+      snapshot.hasValidAccessToken = remainingMs > 0;
+      snapshot.accessTokenExpiresIn = static_cast<double>(std::max<int64_t>(remainingMs, 0));
+    }
+  }
+  return snapshot;
+}
+
+double HybridAuth::getSessionVersion() {
+  std::lock_guard<std::recursive_mutex> lock(_mutex);
+  return static_cast<double>(sessionVersionLocked());
+}
+
+std::optional<UserChange> HybridAuth::getCurrentUserIfChanged(double sinceVersion) {
+  std::lock_guard<std::recursive_mutex> lock(_mutex);
+  const auto version = static_cast<double>(sessionVersionLocked());
+  if (version == sinceVersion) return std::nullopt;
+  UserChange change;
+  change.version = version;
+  if (const auto& active = _accounts.active()) change.user = active->user.unpack();
+  return change;
+}
+
+MemoryStats HybridAuth::getMemoryStats() {
+  // Process-wide counters, so no lock: other instances and threads may move them mid-read.
+  const auto usage = [](MemorySubsystem subsystem) {
+    const auto tracked = MemoryAccounting::usage(subsystem);
+    return MemoryUsage(static_cast<double>(tracked.bytes), static_cast<double>(tracked.allocations),
+                       static_cast<double>(tracked.peakBytes));
+  };
+  const auto total = MemoryAccounting::total();
+  return MemoryStats(usage(MemorySubsystem::SESSIONS), usage(MemorySubsystem::LISTENERS),
+                     usage(MemorySubsystem::PENDING_OPERATIONS), usage(MemorySubsystem::PLATFORM_OPERATIONS),
+                     usage(MemorySubsystem::CACHES), static_cast<double>(total.bytes),
+                     static_cast<double>(total.peakBytes));
+}
+
+uint64_t HybridAuth::sessionVersionLocked() {
+  const auto& active = _accounts.active();
+  const uint64_t revision = active ? active->user.revision() : 0;
+  if (revision != _versionedRevision) {
+    _versionedRevision = revision;
+    _sessionVersion++;
+  }
+  return _sessionVersion;
 }
 
 bool HybridAuth::getHasPlayServices() {
   return PlatformAuth::hasPlayServices();
 }
 
+std::vector<AuthAccount> HybridAuth::getAccounts() {
+  std::lock_guard<std::recursive_mutex> lock(_mutex);
+  return _accounts.list();
+}
+
+void HybridAuth::switchAccount(const std::string& accountId) {
+  log("switchAccount");
+  traceCall(AuthTraceOp::SWITCH_ACCOUNT, std::nullopt, accountId);
+  {
+    std::lock_guard<std::recursive_mutex> lock(_mutex);
+    const auto& active = _accounts.active();
+    if (active && active->id == accountId) return;
+    if (!_accounts.activate(accountId)) {
+      throw std::runtime_error("not_signed_in");
+    }
+    persistSessionLocked();
+  }
+  notifyAuthStateChanged();
+}
+
 void HybridAuth::notifyAuthStateChanged() {
   std::optional<AuthUser> user;
   std::vector<std::function<void(const std::optional<AuthUser>&)>> listeners;
   {
     std::lock_guard<std::recursive_mutex> lock(_mutex);
-    user = _currentUser;
+    if (const auto& active = _accounts.active()) user = active->user.unpack();
     listeners.reserve(_listeners.size());
     for (auto const& [id, listener] : _listeners) {
       listeners.push_back(listener);
@@ -154,34 +581,87 @@ std::function<void()> HybridAuth::onTokensRefreshed(const std::function<void(con
   };
 }
 
+std::function<void()> HybridAuth::onDeviceCode(const std::function<void(const DeviceAuthorization&)>& callback) {
+  std::lock_guard<std::recursive_mutex> lock(_mutex);
+  uint64_t id = _nextDeviceCodeListenerId++;
+  _deviceCodeListeners[id] = callback;
+
+  auto weak = weak_from_this();
+  return [weak, id]() {
+    auto self = weak.lock();
+    if (!self) return;
+    auto* auth = dynamic_cast<HybridAuth*>(self.get());
+    if (!auth) return;
+    std::lock_guard<std::recursive_mutex> lock(auth->_mutex);
+    auth->_deviceCodeListeners.erase(id);
+  };
+}
+
+// Session-wide changes only invalidate the signed-out refresh; each account's
+// refresh is retired when that account is replaced or removed.
 std::shared_ptr<Promise<AuthTokens>> HybridAuth::advanceSessionGenerationLocked() {
   _sessionGeneration++;
-  auto refreshInFlight = _refreshInFlight;
-  _refreshInFlight = nullptr;
-  return refreshInFlight;
-}
-
-void HybridAuth::trackSessionPromiseLocked(const std::shared_ptr<Promise<void>>& promise) {
-  _sessionPromises.erase(
-    std::remove_if(_sessionPromises.begin(), _sessionPromises.end(), [](const std::weak_ptr<Promise<void>>& weak) {
-      auto promise = weak.lock();
-      return !promise || !promise->isPending();
-    }),
-    _sessionPromises.end()
-  );
-  _sessionPromises.push_back(promise);
+  return _signedOutRefresh.retire();
 }
 
-std::vector<std::shared_ptr<Promise<void>>> HybridAuth::takePendingSessionPromisesLocked() {
-  std::vector<std::shared_ptr<Promise<void>>> pending;
-  for (const auto& weak : _sessionPromises) {
-    auto promise = weak.lock();
-    if (promise && promise->isPending()) {
-      pending.push_back(promise);
-    }
+RefreshSlot& HybridAuth::refreshSlotLocked(const std::shared_ptr<AccountSession>& account) {
+  return account ? account->refresh : _signedOutRefresh;
+}
+
+void HybridAuth::setTraceRecorder(const std::shared_ptr<AuthTraceRecorder>& recorder) {
+  std::lock_guard<std::recursive_mutex> lock(_mutex);
+  _trace = recorder;
+  _tracing = recorder != nullptr;
+}
+
+void HybridAuth::traceCall(AuthTraceOp op, std::optional<AuthProvider> provider,
+                           const std::optional<std::string>& accountId, std::vector<std::string> scopes) {
+  if (!_tracing) return;
+  std::shared_ptr<AuthTraceRecorder> recorder;
+  {
+    std::lock_guard<std::recursive_mutex> lock(_mutex);
+    recorder = _trace;
   }
-  _sessionPromises.clear();
-  return pending;
+  if (!recorder) return;
+  AuthTraceEvent event;
+  event.atMs = nowMs();
+  event.op = op;
+  event.provider = provider;
+  if (accountId) event.account = recorder->accountOrdinal(*accountId);
+  event.scopes = std::move(scopes);
+  recorder->record(std::move(event));
+}
+
+void HybridAuth::traceSuccess(AuthTraceOp op, const std::optional<std::string>& accountId,
+                              const std::optional<double>& expirationTime) {
+  if (!_tracing) return;
+  std::shared_ptr<AuthTraceRecorder> recorder;
+  {
+    std::lock_guard<std::recursive_mutex> lock(_mutex);
+    recorder = _trace;
+  }
+  if (!recorder) return;
+  AuthTraceEvent event;
+  event.atMs = nowMs();
+  event.op = op;
+  if (accountId) event.account = recorder->accountOrdinal(*accountId);
+  if (expirationTime) event.lifetimeMs = static_cast<int64_t>(*expirationTime) - event.atMs;
+  recorder->record(std::move(event));
+}
+
+void HybridAuth::traceFailure(AuthTraceOp op, const AuthError& error) {
+  if (!_tracing) return;
+  std::shared_ptr<AuthTraceRecorder> recorder;
+  {
+    std::lock_guard<std::recursive_mutex> lock(_mutex);
+    recorder = _trace;
+  }
+  if (!recorder) return;
+  AuthTraceEvent event;
+  event.atMs = nowMs();
+  event.op = op;
+  event.error = error.code();
+  recorder->record(std::move(event));
 }
 
 void HybridAuth::log(const std::string& message) {
@@ -197,39 +677,72 @@ void HybridAuth::log(const std::string& message) {
 
 void HybridAuth::logout() {
   log("logout");
-  std::shared_ptr<Promise<AuthTokens>> refreshInFlight;
+  traceCall(AuthTraceOp::LOGOUT);
+  std::vector<std::shared_ptr<Promise<AuthTokens>>> refreshes;
   std::vector<std::shared_ptr<Promise<void>>> sessionPromises;
   {
     std::lock_guard<std::recursive_mutex> lock(_mutex);
-    sessionPromises = takePendingSessionPromisesLocked();
-    refreshInFlight = advanceSessionGenerationLocked();
-    _currentUser = std::nullopt;
-    _grantedScopes.clear();
+    sessionPromises = _sessionPromises->takeAll();
+    refreshes = _accounts.clear();
+    refreshes.push_back(advanceSessionGenerationLocked());
+    retireAccessTokensLocked(std::nullopt, refreshes);
+    persistSessionLocked();
   }
-  rejectIfPending(refreshInFlight, "not_signed_in");
-  rejectPendingSessionPromises(sessionPromises, "cancelled");
+  rejectIfPending(refreshes, AuthErrorCode::NOT_SIGNED_IN);
+  rejectPendingSessionPromises(sessionPromises, AuthErrorCode::CANCELLED);
+  abortInteractiveOperation(PlatformOperation::LOGIN);
+  abortInteractiveOperation(PlatformOperation::REQUEST_SCOPES);
+  cancelDeviceLogin("cancelled");
   PlatformAuth::logout();
   notifyAuthStateChanged();
 }
 
 std::shared_ptr<Promise<void>> HybridAuth::silentRestore() {
+  return silentRestore(nullptr);
+}
+
+std::shared_ptr<Promise<void>> HybridAuth::silentRestore(const std::shared_ptr<CancellationToken>& cancellation) {
   log("silentRestore start");
+  traceCall(AuthTraceOp::SILENT_RESTORE);
   auto promise = Promise<void>::create();
+  if (cancellation && cancellation->isCancelled()) {
+    promise->resolve();
+    return promise;
+  }
   uint64_t generation;
   {
     std::lock_guard<std::recursive_mutex> lock(_mutex);
     generation = _sessionGeneration;
-    trackSessionPromiseLocked(promise);
+    _sessionPromises->track(promise);
   }
   auto silentPromise = PlatformAuth::silentRestore();
   auto self = shared_from_this();
-  silentPromise->addOnResolvedListener([self, promise, generation](const std::optional<AuthUser>& user) {
+  auto watch = watchOperation(PlatformOperation::SILENT_RESTORE, cancellation, [promise](const std::string&) {
+    resolveIfPending(promise);
+  });
+  silentPromise->addOnResolvedListener([self, promise, generation, watch](const Result<std::optional<AuthUser>>& result) {
+    const bool settled = watch->settle();
     auto* auth = dynamic_cast<HybridAuth*>(self.get());
+    if (!result) {
+      if (auth) {
+        auth->traceFailure(AuthTraceOp::PLATFORM_RESTORE, result.error());
+        auth->log("silentRestore rejected");
+      }
+      resolveIfPending(promise);
+      return;
+    }
+    if (!settled) return;
     if (!auth) {
-      promise->reject(makeAuthError("internal_error"));
+      promise->reject(makeAuthError(AuthErrorCode::INTERNAL_ERROR));
       return;
     }
-    std::shared_ptr<Promise<AuthTokens>> refreshInFlight;
+    const auto& user = result.value();
+    if (user) {
+      auth->traceSuccess(AuthTraceOp::PLATFORM_RESTORE, AccountRegistry::accountIdFor(*user), user->expirationTime);
+    } else {
+      auth->traceFailure(AuthTraceOp::PLATFORM_RESTORE, AuthErrorCode::NOT_SIGNED_IN);
+    }
+    std::vector<std::shared_ptr<Promise<AuthTokens>>> refreshes;
     {
       std::lock_guard<std::recursive_mutex> lock(auth->_mutex);
       if (auth->_sessionGeneration != generation) {
@@ -237,154 +750,229 @@ std::shared_ptr<Promise<void>> HybridAuth::silentRestore() {
         resolveIfPending(promise);
         return;
       }
-      refreshInFlight = auth->advanceSessionGenerationLocked();
-      auth->_currentUser = user;
+      refreshes.push_back(auth->advanceSessionGenerationLocked());
       if (user) {
-        if (user->scopes) {
-          auth->_grantedScopes = *user->scopes;
-        } else {
-          auth->_grantedScopes.clear();
-        }
+        std::shared_ptr<Promise<AuthTokens>> replacedRefresh;
+        auto account = auth->_accounts.upsert(*user, auth->_refreshBackoffPolicy, &replacedRefresh);
+        account->grantedScopes = user->scopes.value_or(std::vector<std::string>{});
+        auth->observeIssuedTokensLocked(*account, true);
+        refreshes.push_back(std::move(replacedRefresh));
+        auth->retireAccessTokensLocked(account->id, refreshes);
       } else {
-        auth->_grantedScopes.clear();
+        for (auto& refresh : auth->_accounts.clear()) refreshes.push_back(std::move(refresh));
+        auth->retireAccessTokensLocked(std::nullopt, refreshes);
       }
+      auth->persistSessionLocked();
     }
-    rejectIfPending(refreshInFlight, "cancelled");
+    rejectIfPending(refreshes, AuthErrorCode::CANCELLED);
     auth->notifyAuthStateChanged();
     auth->log(user ? "silentRestore resolved with session" : "silentRestore resolved without session");
     resolveIfPending(promise);
   });
-  
-  silentPromise->addOnRejectedListener([self, promise](const std::exception_ptr&) {
-    auto* auth = dynamic_cast<HybridAuth*>(self.get());
-    if (auth) {
-      auth->log("silentRestore rejected");
-    }
-    resolveIfPending(promise);
-  });
   return promise;
 }
 
 std::shared_ptr<Promise<void>> HybridAuth::login(AuthProvider provider, const std::optional<LoginOptions>& options) {
+  return login(provider, options, nullptr);
+}
+
+std::shared_ptr<Promise<void>> HybridAuth::login(AuthProvider provider, const std::optional<LoginOptions>& options,
+                                                 const std::shared_ptr<CancellationToken>& cancellation) {
   log("login start");
+  traceCall(AuthTraceOp::LOGIN, provider);
   auto promise = Promise<void>::create();
+  if (cancellation && cancellation->isCancelled()) {
+    promise->reject(makeAuthError(cancellation->reason().value_or("cancelled")));
+    return promise;
+  }
   uint64_t generation;
   std::shared_ptr<Promise<AuthTokens>> refreshInFlight;
   std::vector<std::shared_ptr<Promise<void>>> sessionPromises;
   {
     std::lock_guard<std::recursive_mutex> lock(_mutex);
-    sessionPromises = takePendingSessionPromisesLocked();
+    sessionPromises = _sessionPromises->takeAll();
     refreshInFlight = advanceSessionGenerationLocked();
     generation = _sessionGeneration;
-    trackSessionPromiseLocked(promise);
+    _sessionPromises->track(promise);
   }
-  rejectIfPending(refreshInFlight, "cancelled");
-  rejectPendingSessionPromises(sessionPromises, "cancelled");
+  rejectIfPending(refreshInFlight, AuthErrorCode::CANCELLED);
+  rejectPendingSessionPromises(sessionPromises, AuthErrorCode::CANCELLED);
+  // Before the new call claims the platform: cancelling afterwards would hit it instead.
+  abortInteractiveOperation(PlatformOperation::LOGIN);
+  abortInteractiveOperation(PlatformOperation::REQUEST_SCOPES);
   
   auto self = shared_from_this();
-  auto loginPromise = PlatformAuth::login(provider, options);
-  loginPromise->addOnResolvedListener([self, promise, options, generation](const AuthUser& user) {
+  auto loginPromise = startLogin(provider, options);
+  auto watch = watchOperation(PlatformOperation::LOGIN, cancellation, [self, promise](const std::string& reason) {
+    if (auto* auth = dynamic_cast<HybridAuth*>(self.get())) auth->cancelDeviceLogin(reason);
+    rejectIfPending(promise, reason);
+  });
+  {
+    std::lock_guard<std::recursive_mutex> lock(_mutex);
+    _loginWatch = watch;
+  }
+  loginPromise->addOnResolvedListener([self, promise, options, generation, watch](const Result<AuthUser>& result) {
+    const bool settled = watch->settle();
     auto* auth = dynamic_cast<HybridAuth*>(self.get());
+    if (auth) auth->forgetInteractiveOperation(PlatformOperation::LOGIN, watch);
+    if (!result) {
+      if (auth) {
+        auth->traceFailure(AuthTraceOp::PLATFORM_LOGIN, result.error());
+        auth->log("login rejected");
+      }
+      rejectIfPending(promise, result.error());
+      return;
+    }
+    if (!settled) return;
     if (!auth) {
-      rejectIfPending(promise, "internal_error");
+      rejectIfPending(promise, AuthErrorCode::INTERNAL_ERROR);
       return;
     }
-    std::shared_ptr<Promise<AuthTokens>> refreshInFlight;
+    const AuthUser& user = result.value();
+    auth->traceSuccess(AuthTraceOp::PLATFORM_LOGIN, AccountRegistry::accountIdFor(user), user.expirationTime);
+    std::vector<std::shared_ptr<Promise<AuthTokens>>> refreshes;
     {
       std::lock_guard<std::recursive_mutex> lock(auth->_mutex);
       if (auth->_sessionGeneration != generation) {
         auth->log("login cancelled");
-        rejectIfPending(promise, "cancelled");
+        rejectIfPending(promise, AuthErrorCode::CANCELLED);
         return;
       }
-      refreshInFlight = auth->advanceSessionGenerationLocked();
-      auth->_currentUser = user;
+      refreshes.push_back(auth->advanceSessionGenerationLocked());
+      std::vector<std::string> grantedScopes;
       if (user.scopes && !user.scopes->empty()) {
-        auth->_grantedScopes = *user.scopes;
+        grantedScopes = *user.scopes;
       } else if (options && options->scopes && !options->scopes->empty()) {
-        auth->_grantedScopes = *options->scopes;
-      } else {
-        auth->_grantedScopes.clear();
-      }
-      if (auth->_currentUser) {
-        auth->_currentUser->scopes = auth->_grantedScopes.empty()
-          ? std::nullopt
-          : std::make_optional(auth->_grantedScopes);
+        grantedScopes = *options->scopes;
       }
+      AuthUser signedIn = user;
+      signedIn.scopes = grantedScopes.empty() ? std::nullopt : std::make_optional(grantedScopes);
+      // Signing in to another account adds it; signing in to a known one replaces its session.
+      std::shared_ptr<Promise<AuthTokens>> replacedRefresh;
+      auto account = auth->_accounts.upsert(std::move(signedIn), auth->_refreshBackoffPolicy, &replacedRefresh);
+      account->grantedScopes = std::move(grantedScopes);
+      auth->observeIssuedTokensLocked(*account, true);
+      refreshes.push_back(std::move(replacedRefresh));
+      auth->retireAccessTokensLocked(account->id, refreshes);
+      auth->persistSessionLocked();
     }
-    rejectIfPending(refreshInFlight, "cancelled");
+    rejectIfPending(refreshes, AuthErrorCode::CANCELLED);
     auth->notifyAuthStateChanged();
     auth->log("login resolved");
     resolveIfPending(promise);
   });
-  
-  loginPromise->addOnRejectedListener([self, promise](const std::exception_ptr& error) {
-    auto* auth = dynamic_cast<HybridAuth*>(self.get());
-    if (auth) {
-      auth->log("login rejected");
-    }
-    if (promise->isPending()) {
-      promise->reject(error);
-    }
-  });
   return promise;
 }
 
 std::shared_ptr<Promise<void>> HybridAuth::requestScopes(const std::vector<std::string>& scopes) {
+  return requestScopes(scopes, nullptr);
+}
+
+std::shared_ptr<Promise<void>> HybridAuth::requestScopes(const std::vector<std::string>& scopes,
+                                                         const std::shared_ptr<CancellationToken>& cancellation) {
   log("requestScopes start");
+  traceCall(AuthTraceOp::REQUEST_SCOPES, std::nullopt, std::nullopt, scopes);
   auto promise = Promise<void>::create();
+  if (cancellation && cancellation->isCancelled()) {
+    promise->reject(makeAuthError(cancellation->reason().value_or("cancelled")));
+    return promise;
+  }
   uint64_t generation;
+  std::optional<LoginOptions> oidcOptions;
   {
     std::lock_guard<std::recursive_mutex> lock(_mutex);
     generation = _sessionGeneration;
-    trackSessionPromiseLocked(promise);
+    _sessionPromises->track(promise);
+    // The core owns OIDC sessions, so more scopes means a new authorization for the union.
+    const auto& account = _accounts.active();
+    if (account && account->user.provider() == AuthProvider::OIDC) {
+      std::vector<std::string> requested = account->grantedScopes;
+      mergeGrantedScopes(requested, scopes);
+      oidcOptions.emplace();
+      oidcOptions->scopes = std::move(requested);
+      oidcOptions->loginHint = account->user.get(AuthUserField::EMAIL);
+    }
   }
+  abortInteractiveOperation(PlatformOperation::REQUEST_SCOPES);
   auto self = shared_from_this();
-  auto requestPromise = PlatformAuth::requestScopes(scopes);
-  requestPromise->addOnResolvedListener([self, promise, scopes, generation](const AuthUser& user) {
+  auto requestPromise =
+    oidcOptions ? startLogin(AuthProvider::OIDC, oidcOptions) : PlatformAuth::requestScopes(scopes);
+  auto watch = watchOperation(PlatformOperation::REQUEST_SCOPES, cancellation, [promise](const std::string& reason) {
+    rejectIfPending(promise, reason);
+  });
+  {
+    std::lock_guard<std::recursive_mutex> lock(_mutex);
+    _scopesWatch = watch;
+  }
+  requestPromise->addOnResolvedListener([self, promise, scopes, generation, watch](const Result<AuthUser>& result) {
+    const bool settled = watch->settle();
     auto* auth = dynamic_cast<HybridAuth*>(self.get());
+    if (auth) auth->forgetInteractiveOperation(PlatformOperation::REQUEST_SCOPES, watch);
+    if (!result) {
+      if (auth) {
+        auth->traceFailure(AuthTraceOp::PLATFORM_LOGIN, result.error());
+        auth->log("requestScopes rejected");
+      }
+      rejectIfPending(promise, result.error());
+      return;
+    }
+    if (!settled) return;
     if (!auth) {
-      rejectIfPending(promise, "internal_error");
+      rejectIfPending(promise, AuthErrorCode::INTERNAL_ERROR);
       return;
     }
+    const AuthUser& user = result.value();
+    auth->traceSuccess(AuthTraceOp::PLATFORM_LOGIN, AccountRegistry::accountIdFor(user), user.expirationTime);
+    std::vector<std::shared_ptr<Promise<AuthTokens>>> replacedRefreshes;
     {
       std::lock_guard<std::recursive_mutex> lock(auth->_mutex);
       if (auth->_sessionGeneration != generation) {
         auth->log("requestScopes cancelled");
-        rejectIfPending(promise, "cancelled");
+        rejectIfPending(promise, AuthErrorCode::CANCELLED);
         return;
       }
-      auth->_currentUser = user;
-      mergeGrantedScopes(auth->_grantedScopes, scopes);
-      if (auth->_currentUser) auth->_currentUser->scopes = auth->_grantedScopes;
+      auto account = auth->_accounts.active();
+      if (account && account->id == AccountRegistry::accountIdFor(user)) {
+        // Same account: its tokens and any refresh in flight stay valid.
+        AuthUser replaced = user;
+        replaced.refreshToken = account->user.get(AuthUserField::REFRESH_TOKEN);
+        account->user = PackedAuthUser(replaced);
+        auth->adoptRefreshTokenLocked(*account, user.refreshToken);
+        auth->_accounts.markPlatformSession(*account);
+      } else {
+        std::shared_ptr<Promise<AuthTokens>> replacedRefresh;
+        account = auth->_accounts.upsert(user, auth->_refreshBackoffPolicy, &replacedRefresh);
+        replacedRefreshes.push_back(std::move(replacedRefresh));
+        auth->retireAccessTokensLocked(account->id, replacedRefreshes);
+      }
+      mergeGrantedScopes(account->grantedScopes, scopes);
+      account->user = account->user.withScopes(account->grantedScopes);
+      auth->observeIssuedTokensLocked(*account, true);
+      auth->persistSessionLocked();
     }
+    rejectIfPending(replacedRefreshes, AuthErrorCode::CANCELLED);
     auth->notifyAuthStateChanged();
     auth->log("requestScopes resolved");
     resolveIfPending(promise);
   });
-  
-  requestPromise->addOnRejectedListener([self, promise](const std::exception_ptr& error) {
-    auto* auth = dynamic_cast<HybridAuth*>(self.get());
-    if (auth) {
-      auth->log("requestScopes rejected");
-    }
-    if (promise->isPending()) {
-      promise->reject(error);
-    }
-  });
   return promise;
 }
 
 std::shared_ptr<Promise<void>> HybridAuth::revokeScopes(const std::vector<std::string>& scopes) {
   log("revokeScopes");
   auto promise = Promise<void>::create();
+  std::vector<std::shared_ptr<Promise<AuthTokens>>> scopedRefreshes;
   {
     std::lock_guard<std::recursive_mutex> lock(_mutex);
-    removeGrantedScopes(_grantedScopes, scopes);
-    if (_currentUser) {
-      _currentUser->scopes = _grantedScopes;
+    if (const auto& active = _accounts.active()) {
+      removeGrantedScopes(active->grantedScopes, scopes);
+      active->user = active->user.withScopes(active->grantedScopes);
+      // Resource tokens may carry the revoked scopes; fetch them again on next use.
+      retireAccessTokensLocked(active->id, scopedRefreshes);
     }
+    persistSessionLocked();
   }
+  rejectIfPending(scopedRefreshes, AuthErrorCode::CANCELLED);
   notifyAuthStateChanged();
   promise->resolve();
   return promise;
@@ -392,168 +980,643 @@ std::shared_ptr<Promise<void>> HybridAuth::revokeScopes(const std::vector<std::s
 
 std::shared_ptr<Promise<void>> HybridAuth::revokeAccess() {
   log("revokeAccess start");
+  traceCall(AuthTraceOp::REVOKE_ACCESS);
   auto promise = Promise<void>::create();
-  std::shared_ptr<Promise<AuthTokens>> refreshInFlight;
+  std::vector<std::shared_ptr<Promise<AuthTokens>>> refreshes;
   std::vector<std::shared_ptr<Promise<void>>> sessionPromises;
   {
     std::lock_guard<std::recursive_mutex> lock(_mutex);
-    sessionPromises = takePendingSessionPromisesLocked();
-    refreshInFlight = advanceSessionGenerationLocked();
-    trackSessionPromiseLocked(promise);
-    _currentUser = std::nullopt;
-    _grantedScopes.clear();
+    sessionPromises = _sessionPromises->takeAll();
+    refreshes = _accounts.clear();
+    refreshes.push_back(advanceSessionGenerationLocked());
+    retireAccessTokensLocked(std::nullopt, refreshes);
+    _sessionPromises->track(promise);
+    persistSessionLocked();
   }
-  rejectIfPending(refreshInFlight, "cancelled");
-  rejectPendingSessionPromises(sessionPromises, "cancelled");
+  rejectIfPending(refreshes, AuthErrorCode::CANCELLED);
+  rejectPendingSessionPromises(sessionPromises, AuthErrorCode::CANCELLED);
 
   auto platformPromise = PlatformAuth::revokeAccess();
   auto self = shared_from_this();
-  platformPromise->addOnResolvedListener([self, promise]() {
+  platformPromise->addOnResolvedListener([self, promise](const Result<void>& result) {
     auto* auth = dynamic_cast<HybridAuth*>(self.get());
+    if (!result) {
+      if (auth) {
+        auth->log("revokeAccess rejected");
+      }
+      rejectIfPending(promise, result.error());
+      return;
+    }
     if (!auth) {
-      rejectIfPending(promise, "internal_error");
+      rejectIfPending(promise, AuthErrorCode::INTERNAL_ERROR);
       return;
     }
     auth->notifyAuthStateChanged();
     auth->log("revokeAccess resolved");
     resolveIfPending(promise);
   });
-  platformPromise->addOnRejectedListener([self, promise](const std::exception_ptr& error) {
+  return promise;
+}
+
+std::shared_ptr<Promise<std::optional<std::string>>> HybridAuth::getAccessToken() {
+  return getAccessToken(std::nullopt);
+}
+
+std::shared_ptr<Promise<std::optional<std::string>>> HybridAuth::getAccessToken(const std::optional<AccessTokenRequest>& request) {
+  log("getAccessToken");
+  traceCall(AuthTraceOp::GET_ACCESS_TOKEN, std::nullopt, std::nullopt,
+            request ? AccessTokenCache::scopesFor(*request) : std::vector<std::string>{});
+  std::shared_ptr<AccountSession> account;
+  {
+    std::lock_guard<std::recursive_mutex> lock(_mutex);
+    account = _accounts.active();
+  }
+  if (!account) {
+    auto promise = Promise<std::optional<std::string>>::create();
+    promise->resolve(std::nullopt);
+    return promise;
+  }
+  return accessTokenFor(account, request);
+}
+
+std::shared_ptr<Promise<std::optional<std::string>>> HybridAuth::getAccessTokenForAccount(const std::string& accountId,
+                                                                                         const std::optional<AccessTokenRequest>& request) {
+  log("getAccessTokenForAccount");
+  traceCall(AuthTraceOp::GET_ACCESS_TOKEN, std::nullopt, accountId,
+            request ? AccessTokenCache::scopesFor(*request) : std::vector<std::string>{});
+  std::shared_ptr<AccountSession> account;
+  {
+    std::lock_guard<std::recursive_mutex> lock(_mutex);
+    account = _accounts.find(accountId);
+  }
+  if (!account) {
+    auto promise = Promise<std::optional<std::string>>::create();
+    promise->reject(makeAuthError(AuthErrorCode::NOT_SIGNED_IN));
+    return promise;
+  }
+  return accessTokenFor(account, request);
+}
+
+void HybridAuth::setAccessTokenCacheLimits(const AccessTokenCacheLimits& limits) {
+  std::lock_guard<std::recursive_mutex> lock(_mutex);
+  _accessTokens.setLimits(limits);
+}
+
+AccessTokenCacheStats HybridAuth::getAccessTokenCacheStats() {
+  std::lock_guard<std::recursive_mutex> lock(_mutex);
+  return _accessTokens.stats();
+}
+
+std::shared_ptr<OidcMetadataCache> HybridAuth::getMetadataCache() {
+  std::lock_guard<std::recursive_mutex> lock(_mutex);
+  return _metadata;
+}
+
+void HybridAuth::setMetadataCache(const std::shared_ptr<OidcMetadataCache>& metadata) {
+  std::lock_guard<std::recursive_mutex> lock(_mutex);
+  _metadata = metadata;
+  _oidc = nullptr;
+}
+
+void HybridAuth::configureOidc(const OidcProviderConfig& config) {
+  std::shared_ptr<OidcMetadataCache> metadata;
+  {
+    std::lock_guard<std::recursive_mutex> lock(_mutex);
+    _oidcConfig = config;
+    _oidc = nullptr;
+    metadata = _metadata;
+  }
+  if (metadata && !config.issuer.empty()) metadata->prefetch({config.issuer});
+}
+
+std::shared_ptr<OidcClient> HybridAuth::oidcClientLocked() {
+  if (!_oidc && _oidcConfig) {
+    _oidc = std::make_shared<OidcClient>(*_oidcConfig,
+                                         ClockSkewSamplingHttpClient::wrap(PlatformAuth::httpClient(), _clockSkew),
+                                         _metadata,
+                                         &PlatformAuth::authorizeInBrowser, _clock, _timerService);
+  }
+  return _oidc;
+}
+
+std::shared_ptr<Promise<Result<AuthUser>>> HybridAuth::startLogin(AuthProvider provider,
+                                                                  const std::optional<LoginOptions>& options) {
+  // A new sign-in supersedes a device code still waiting for approval.
+  cancelDeviceLogin("cancelled");
+  const bool useDeviceCode = options && options->useDeviceCode.value_or(false);
+  if (provider != AuthProvider::OIDC) {
+    if (!useDeviceCode) return PlatformAuth::login(provider, options);
+    auto rejected = Promise<Result<AuthUser>>::create();
+    rejected->resolve(AuthErrorCode::UNSUPPORTED_PROVIDER);
+    return rejected;
+  }
+  std::shared_ptr<OidcClient> client;
+  std::shared_ptr<CancellationToken> deviceLogin;
+  {
+    std::lock_guard<std::recursive_mutex> lock(_mutex);
+    client = oidcClientLocked();
+    if (client && useDeviceCode) {
+      deviceLogin = CancellationToken::create();
+      _deviceLogin = deviceLogin;
+    }
+  }
+  if (!client) {
+    auto rejected = Promise<Result<AuthUser>>::create();
+    rejected->resolve(AuthErrorCode::CONFIGURATION_ERROR);
+    return rejected;
+  }
+  if (!useDeviceCode) return client->login(options);
+
+  auto weak = weak_from_this();
+  auto onUserCode = [weak](const DeviceAuthorization& authorization) {
+    auto self = weak.lock();
+    if (auto* auth = dynamic_cast<HybridAuth*>(self.get())) auth->notifyDeviceCode(authorization);
+  };
+  auto promise = client->loginWithDeviceCode(options, std::move(onUserCode), deviceLogin);
+  auto release = [weak, deviceLogin]() {
+    auto self = weak.lock();
     auto* auth = dynamic_cast<HybridAuth*>(self.get());
-    if (auth) {
-      auth->log("revokeAccess rejected");
+    if (!auth) return;
+    std::lock_guard<std::recursive_mutex> lock(auth->_mutex);
+    if (auth->_deviceLogin == deviceLogin) auth->_deviceLogin = nullptr;
+  };
+  promise->addOnResolvedListener([release](const Result<AuthUser>&) { release(); });
+  return promise;
+}
+
+void HybridAuth::cancelDeviceLogin(const std::string& reason) {
+  std::shared_ptr<CancellationToken> deviceLogin;
+  {
+    std::lock_guard<std::recursive_mutex> lock(_mutex);
+    deviceLogin = std::move(_deviceLogin);
+    _deviceLogin = nullptr;
+  }
+  if (deviceLogin) deviceLogin->cancel(reason);
+}
+
+std::shared_ptr<Promise<Result<AuthTokens>>> HybridAuth::startRefresh(const RefreshJob& job) {
+  std::shared_ptr<OidcClient> client;
+  std::string refreshToken;
+  bool superseded = false;
+  {
+    std::lock_guard<std::recursive_mutex> lock(_mutex);
+    if (job.account) {
+      refreshToken = job.account->user.get(AuthUserField::REFRESH_TOKEN).value_or("");
+      // A restored or replaced session can carry a token this account already
+      // rotated away from; presenting it would read as a replay and revoke the grant.
+      superseded = !refreshToken.empty() && job.account->refreshTokens.isSuperseded(refreshToken);
+      if (superseded) _refreshTokenStats.reusesRejected++;
+    }
+    if (job.provider == AuthProvider::OIDC) client = oidcClientLocked();
+  }
+  if (superseded) {
+    log("superseded refresh token not sent");
+    auto rejected = Promise<Result<AuthTokens>>::create();
+    rejected->resolve(AuthErrorCode::INVALID_GRANT);
+    return rejected;
+  }
+  if (job.provider != AuthProvider::OIDC) return PlatformAuth::refreshToken(job.provider, job.scopes);
+  if (!client) {
+    auto rejected = Promise<Result<AuthTokens>>::create();
+    rejected->resolve(AuthErrorCode::CONFIGURATION_ERROR);
+    return rejected;
+  }
+  return client->refresh(refreshToken, job.scopes);
+}
+
+IdTokenVerifierStats HybridAuth::getIdTokenVerifierStats() {
+  return _idTokens.stats();
+}
+
+RefreshTokenStats HybridAuth::getRefreshTokenStats() {
+  std::lock_guard<std::recursive_mutex> lock(_mutex);
+  return _refreshTokenStats;
+}
+
+std::shared_ptr<Promise<IdTokenClaims>> HybridAuth::verifyIdToken(const IdTokenVerificationOptions& options) {
+  log("verifyIdToken");
+  auto promise = Promise<IdTokenClaims>::create();
+  std::optional<AuthUser> user;
+  std::shared_ptr<OidcMetadataCache> metadata;
+  std::optional<OidcProviderConfig> oidc;
+  {
+    std::lock_guard<std::recursive_mutex> lock(_mutex);
+    if (const auto& account = _accounts.active()) user = account->user.unpack();
+    metadata = _metadata;
+    oidc = _oidcConfig;
+  }
+  if (!user) {
+    promise->reject(makeAuthError(AuthErrorCode::NOT_SIGNED_IN));
+    return promise;
+  }
+  if (!user->idToken || user->idToken->empty()) {
+    promise->reject(makeAuthError(AuthErrorCode::NO_ID_TOKEN));
+    return promise;
+  }
+
+  const std::string& token = *user->idToken;
+  auto unverified = IdTokenVerifier::decodeUnverified(token);
+  auto authority = unverified ? idTokenAuthorityFor(user->provider, unverified->issuer, oidc) : std::nullopt;
+  if (!authority) {
+    promise->reject(makeAuthError(AuthErrorCode::TOKEN_ERROR));
+    return promise;
+  }
+  if (!metadata) {
+    promise->reject(makeAuthError(AuthErrorCode::CONFIGURATION_ERROR));
+    return promise;
+  }
+
+  IdTokenExpectations expectations;
+  expectations.audience = options.audience;
+  expectations.nonce = options.nonce;
+  // Google still issues some tokens with the scheme-less legacy issuer.
+  if (user->provider == AuthProvider::GOOGLE) expectations.issuers.push_back("accounts.google.com");
+  verifyIdTokenWith(promise, metadata, *authority, token, std::move(expectations), false);
+  return promise;
+}
+
+void HybridAuth::verifyIdTokenWith(const std::shared_ptr<Promise<IdTokenClaims>>& promise,
+                                   const std::shared_ptr<OidcMetadataCache>& metadata, const std::string& authority,
+                                   const std::string& token, IdTokenExpectations expectations, bool retried) {
+  auto self = shared_from_this();
+  auto lookup = metadata->get(authority);
+  lookup->addOnResolvedListener([self, promise, metadata, authority, token, expectations,
+                                 retried](const Result<std::shared_ptr<const OidcMetadata>>& fetched) {
+    if (!fetched) {
+      promise->reject(makeAuthError(fetched.error()));
+      return;
     }
-    if (promise->isPending()) {
-      promise->reject(error);
+    auto* auth = dynamic_cast<HybridAuth*>(self.get());
+    if (!auth) {
+      promise->reject(makeAuthError(AuthErrorCode::INTERNAL_ERROR));
+      return;
+    }
+    const auto& entry = fetched.value();
+    auto accepted = expectations;
+    accepted.issuers.push_back(entry->provider.issuer);
+    auto result = auth->_idTokens.verify(token, *entry, accepted, auth->nowMs());
+    if (!result.claims && result.unknownKey && !retried) {
+      // The provider may have rotated its signing keys since the JWKS was cached.
+      metadata->invalidate(authority);
+      auth->verifyIdTokenWith(promise, metadata, authority, token, expectations, true);
+      return;
+    }
+    if (!result.claims) {
+      auth->log("verifyIdToken rejected: " + result.reason);
+      promise->reject(makeAuthError(result.error));
+      return;
     }
+    promise->resolve(toIdTokenClaims(*result.claims));
   });
-  return promise;
 }
 
-std::shared_ptr<Promise<std::optional<std::string>>> HybridAuth::getAccessToken() {
-  log("getAccessToken");
+std::shared_ptr<Promise<std::optional<std::string>>> HybridAuth::accessTokenFor(const std::shared_ptr<AccountSession>& account,
+                                                                               const std::optional<AccessTokenRequest>& request) {
+  auto scopes = request ? AccessTokenCache::scopesFor(*request) : std::vector<std::string>{};
+  if (!scopes.empty()) {
+    return resourceAccessTokenFor(account, std::move(scopes));
+  }
+
   auto promise = Promise<std::optional<std::string>>::create();
-  bool needsRefresh = false;
   std::optional<std::string> cachedAccessToken;
   {
     std::lock_guard<std::recursive_mutex> lock(_mutex);
-    if (_currentUser && _currentUser->accessToken) {
-      cachedAccessToken = _currentUser->accessToken;
-      if (_currentUser->expirationTime) {
-        auto now = std::chrono::system_clock::now().time_since_epoch() / std::chrono::milliseconds(1);
-        if (now + 300000 > *_currentUser->expirationTime) needsRefresh = true;
-      }
-      if (!needsRefresh) {
-        promise->resolve(*_currentUser->accessToken);
-        return promise;
-      }
-    } else {
+    const auto& user = account->user;
+    cachedAccessToken = user.get(AuthUserField::ACCESS_TOKEN);
+    if (!cachedAccessToken) {
       promise->resolve(std::nullopt);
       return promise;
     }
+    auto now = nowMs();
+    bool needsRefresh = false;
+    bool isExpired = false;
+    if (const auto expirationTime = user.expirationTime()) {
+      const int64_t expiryMs = deviceExpiryLocked(*expirationTime, account->expiresInServerTime);
+      needsRefresh = now + _refreshTiming.refreshWindowMs > expiryMs;
+      isExpired = now >= expiryMs;
+    }
+    // While refreshes are backing off, a token that has not actually expired is still usable.
+    if (needsRefresh && !isExpired && account->refresh.backoff.blockingError(now)) {
+      needsRefresh = false;
+    }
+    if (!needsRefresh) {
+      promise->resolve(cachedAccessToken);
+      return promise;
+    }
   }
 
-  if (needsRefresh) {
-    auto refreshPromise = refreshToken();
-    refreshPromise->addOnResolvedListener([promise, cachedAccessToken](const AuthTokens& tokens) {
-      promise->resolve(tokens.accessToken.has_value() ? tokens.accessToken : cachedAccessToken);
-    });
-    refreshPromise->addOnRejectedListener([promise](const std::exception_ptr& error) {
-      promise->reject(error);
-    });
+  auto refreshPromise = refreshAccount(account, nullptr);
+  refreshPromise->addOnResolvedListener([promise, cachedAccessToken](const AuthTokens& tokens) {
+    promise->resolve(tokens.accessToken.has_value() ? tokens.accessToken : cachedAccessToken);
+  });
+  refreshPromise->addOnRejectedListener([promise](const std::exception_ptr& error) {
+    promise->reject(error);
+  });
+  return promise;
+}
+
+// Tokens for a specific resource/scope set come from the LRU cache; a miss runs
+// a scoped platform refresh, single-flight per cache key. The result is cached
+// only, never merged into the account's session tokens.
+std::shared_ptr<Promise<std::optional<std::string>>> HybridAuth::resourceAccessTokenFor(const std::shared_ptr<AccountSession>& account,
+                                                                                       std::vector<std::string> scopes) {
+  auto promise = Promise<std::optional<std::string>>::create();
+  std::shared_ptr<Promise<AuthTokens>> refreshPromise;
+  RefreshJob job;
+  bool launchNow = false;
+  {
+    std::lock_guard<std::recursive_mutex> lock(_mutex);
+    auto key = AccessTokenCache::keyFor(account->id, scopes);
+    if (auto cached = _accessTokens.find(key)) {
+      if (!cached->expirationTime || nowMs() + _refreshTiming.refreshWindowMs <= *cached->expirationTime) {
+        promise->resolve(cached->accessToken);
+        return promise;
+      }
+    }
+    if (auto it = _resourceRefreshes.find(key); it != _resourceRefreshes.end()) {
+      refreshPromise = it->second;
+    } else {
+      job.account = account;
+      job.provider = account->user.provider();
+      job.generation = account->refresh.generation;
+      job.scopes = std::move(scopes);
+      job.cacheKey = key;
+      job.promise = Promise<AuthTokens>::create();
+      _resourceRefreshes.emplace(std::move(key), job.promise);
+      refreshPromise = job.promise;
+      launchNow = scheduleRefreshLocked(job);
+    }
   }
+  if (launchNow) launchRefresh(std::move(job));
+
+  refreshPromise->addOnResolvedListener([promise](const AuthTokens& tokens) {
+    promise->resolve(tokens.accessToken);
+  });
+  refreshPromise->addOnRejectedListener([promise](const std::exception_ptr& error) {
+    promise->reject(error);
+  });
   return promise;
 }
 
+void HybridAuth::retireAccessTokensLocked(const std::optional<std::string>& accountId,
+                                          std::vector<std::shared_ptr<Promise<AuthTokens>>>& retired) {
+  if (!accountId) {
+    _accessTokens.clear();
+    for (auto& [key, refresh] : _resourceRefreshes) retired.push_back(std::move(refresh));
+    _resourceRefreshes.clear();
+    return;
+  }
+  _accessTokens.eraseAccount(*accountId);
+  const std::string prefix = *accountId + '\n';
+  for (auto it = _resourceRefreshes.begin(); it != _resourceRefreshes.end();) {
+    if (it->first.compare(0, prefix.size(), prefix) == 0) {
+      retired.push_back(std::move(it->second));
+      it = _resourceRefreshes.erase(it);
+    } else {
+      ++it;
+    }
+  }
+}
+
 std::shared_ptr<Promise<AuthTokens>> HybridAuth::refreshToken() {
+  return refreshToken(nullptr);
+}
+
+// Refreshes the active account. Joining callers share the in-flight refresh;
+// cancelling the token that started it aborts the shared platform refresh for everyone.
+std::shared_ptr<Promise<AuthTokens>> HybridAuth::refreshToken(const std::shared_ptr<CancellationToken>& cancellation) {
+  traceCall(AuthTraceOp::REFRESH_TOKEN);
+  std::shared_ptr<AccountSession> account;
+  {
+    std::lock_guard<std::recursive_mutex> lock(_mutex);
+    account = _accounts.active();
+  }
+  return refreshAccount(account, cancellation);
+}
+
+std::shared_ptr<Promise<AuthTokens>> HybridAuth::refreshAccount(const std::shared_ptr<AccountSession>& account,
+                                                                const std::shared_ptr<CancellationToken>& cancellation) {
   log("refreshToken start");
-  std::shared_ptr<Promise<AuthTokens>> promise;
-  uint64_t generation;
+  if (cancellation && cancellation->isCancelled()) {
+    auto rejected = Promise<AuthTokens>::create();
+    rejected->reject(makeAuthError(cancellation->reason().value_or("cancelled")));
+    return rejected;
+  }
+  RefreshJob job;
+  bool launchNow = false;
   {
     std::lock_guard<std::recursive_mutex> lock(_mutex);
-    if (_refreshInFlight) {
-      return _refreshInFlight;
+    auto& slot = refreshSlotLocked(account);
+    if (slot.inFlight) {
+      return slot.inFlight;
     }
-    generation = _sessionGeneration;
-    promise = Promise<AuthTokens>::create();
-    _refreshInFlight = promise;
+    if (auto blockingError = slot.backoff.blockingError(nowMs())) {
+      log("refreshToken backing off");
+      auto rejected = Promise<AuthTokens>::create();
+      rejected->reject(makeAuthError(*blockingError));
+      return rejected;
+    }
+    job.account = account;
+    if (account) job.provider = account->user.provider();
+    job.generation = slot.generation;
+    job.promise = Promise<AuthTokens>::create();
+    job.cancellation = cancellation;
+    slot.inFlight = job.promise;
+    launchNow = scheduleRefreshLocked(job);
   }
+  auto promise = job.promise;
+  if (launchNow) launchRefresh(std::move(job));
+  return promise;
+}
 
+// Claims the platform refresh for `job`, or queues it behind the refresh in flight.
+bool HybridAuth::scheduleRefreshLocked(RefreshJob& job) {
+  if (_platformRefreshTicket) {
+    log("refreshToken queued behind another refresh");
+    _refreshQueue.push_back(job);
+    return false;
+  }
+  job.ticket = _nextRefreshTicket++;
+  _platformRefreshTicket = job.ticket;
+  return true;
+}
+
+// Detaches `job` from its single-flight slot. Returns false when its result must
+// be dropped because the account was replaced, removed or (for resource tokens) retired.
+bool HybridAuth::finishRefreshLocked(const RefreshJob& job) {
+  auto& slot = refreshSlotLocked(job.account);
+  bool isCurrent = slot.generation == job.generation;
+  if (job.cacheKey.empty()) {
+    if (slot.inFlight == job.promise) slot.inFlight = nullptr;
+    return isCurrent;
+  }
+  auto it = _resourceRefreshes.find(job.cacheKey);
+  if (it == _resourceRefreshes.end() || it->second != job.promise) return false;
+  _resourceRefreshes.erase(it);
+  return isCurrent;
+}
+
+// Starts the platform half of `job`, which must hold the platform refresh ticket.
+// The deadline covers the platform call only, not time spent queued.
+void HybridAuth::launchRefresh(RefreshJob job) {
+  bool otherSession = false;
+  bool isCurrent = false;
+  {
+    std::lock_guard<std::recursive_mutex> lock(_mutex);
+    // The platform refreshes whichever account it signed in last for the
+    // provider; asking it on behalf of another would hand that one's tokens over.
+    otherSession = job.account && job.provider != AuthProvider::OIDC && !_accounts.isPlatformSession(*job.account);
+    if (otherSession) isCurrent = finishRefreshLocked(job);
+  }
+  if (otherSession) {
+    // Refused locally: the account's grant is untouched, so the refusal stays out
+    // of its backoff and the refresh works again once the platform holds it.
+    log("refresh refused: the platform holds another account's session");
+    rejectIfPending(job.promise, isCurrent ? AuthErrorCode::NOT_SIGNED_IN : AuthErrorCode::CANCELLED);
+    releasePlatformRefresh(job.ticket);
+    return;
+  }
   auto self = shared_from_this();
-  auto refreshPromise = PlatformAuth::refreshToken();
-  refreshPromise->addOnResolvedListener([self, promise, generation](const AuthTokens& tokens) {
+  auto refreshPromise = startRefresh(job);
+  std::weak_ptr<HybridObject> weakSelf = self;
+  auto cancellation = std::move(job.cancellation);
+  auto shared = std::make_shared<const RefreshJob>(std::move(job));
+  auto watch = watchOperation(PlatformOperation::REFRESH_TOKEN, cancellation,
+                              [weakSelf, shared](const std::string& reason) {
+    const auto& job = *shared;
+    auto self = weakSelf.lock();
+    auto* auth = self ? dynamic_cast<HybridAuth*>(self.get()) : nullptr;
+    if (auth) {
+      {
+        std::lock_guard<std::recursive_mutex> lock(auth->_mutex);
+        if (job.promise->isPending() && auth->finishRefreshLocked(job) && job.cacheKey.empty()) {
+          auth->refreshSlotLocked(job.account).backoff.recordFailure(reason, auth->nowMs());
+        }
+      }
+      rejectIfPending(job.promise, reason);
+      auth->releasePlatformRefresh(job.ticket);
+      return;
+    }
+    rejectIfPending(job.promise, reason);
+  });
+  refreshPromise->addOnResolvedListener([self, shared, watch](const Result<AuthTokens>& result) {
+    const bool settled = watch->settle();
+    const auto& job = *shared;
     auto* auth = dynamic_cast<HybridAuth*>(self.get());
     if (!auth) {
-      promise->reject(makeAuthError("internal_error"));
+      if (settled || !result) rejectIfPending(job.promise, AuthErrorCode::INTERNAL_ERROR);
       return;
     }
+    if (!result) {
+      auth->traceFailure(AuthTraceOp::PLATFORM_REFRESH, result.error());
+      bool isStale = false;
+      {
+        std::lock_guard<std::recursive_mutex> lock(auth->_mutex);
+        if (!auth->finishRefreshLocked(job)) {
+          isStale = true;
+        } else if (job.cacheKey.empty()) {
+          auth->refreshSlotLocked(job.account).backoff.recordFailure(result.error(), auth->nowMs());
+        }
+      }
+      if (isStale) {
+        auth->log("refreshToken cancelled");
+        rejectIfPending(job.promise, AuthErrorCode::CANCELLED);
+      } else {
+        auth->log("refreshToken rejected");
+        rejectIfPending(job.promise, result.error());
+      }
+      auth->releasePlatformRefresh(job.ticket);
+      return;
+    }
+    if (!settled) return;
+    auth->traceSuccess(AuthTraceOp::PLATFORM_REFRESH,
+                       job.account ? std::make_optional(job.account->id) : std::nullopt, result.value().expirationTime);
+    auto tokens = result.value();
     bool isStale = false;
+    bool isMismatched = false;
+    bool isActive = false;
     {
       std::lock_guard<std::recursive_mutex> lock(auth->_mutex);
-      if (auth->_sessionGeneration != generation) {
-        if (auth->_refreshInFlight == promise) {
-          auth->_refreshInFlight = nullptr;
-        }
+      // The rotated refresh token replaces the old one in the session and the
+      // store under one lock, so no reader or later refresh sees the old one.
+      if (!auth->finishRefreshLocked(job)) {
         isStale = true;
+      } else if (job.account && !idTokenMatchesAccount(*job.account, tokens.idToken)) {
+        // Tokens for another user never land in this account.
+        isMismatched = true;
+        if (job.cacheKey.empty()) {
+          auth->refreshSlotLocked(job.account).backoff.recordFailure(AuthErrorCode::TOKEN_ERROR, auth->nowMs());
+        }
+      } else if (!job.cacheKey.empty()) {
+        if (tokens.accessToken) {
+          auth->_accessTokens.put(job.cacheKey, CachedAccessToken{*tokens.accessToken, tokens.expirationTime});
+        }
+        auto update = job.account ? auth->adoptRefreshTokenLocked(*job.account, tokens.refreshToken)
+                                  : RefreshTokenUpdate::UNCHANGED;
+        if (update == RefreshTokenUpdate::REUSED) tokens.refreshToken.reset();
+        if (update == RefreshTokenUpdate::ROTATED && job.account == auth->_accounts.active() && auth->_sessionStore) {
+          auth->_sessionStore->saveTokens(AuthTokens(std::nullopt, std::nullopt, tokens.refreshToken, std::nullopt));
+        }
       } else {
-        if (auth->_currentUser) {
-          if (tokens.accessToken.has_value()) {
-            auth->_currentUser->accessToken = tokens.accessToken;
-          }
-          if (tokens.idToken.has_value()) {
-            auth->_currentUser->idToken = tokens.idToken;
-          }
-          if (tokens.refreshToken.has_value()) {
-            auth->_currentUser->refreshToken = tokens.refreshToken;
-          }
-          if (tokens.expirationTime.has_value()) {
-            auth->_currentUser->expirationTime = tokens.expirationTime;
+        auth->refreshSlotLocked(job.account).backoff.recordSuccess();
+        isActive = !job.account || job.account == auth->_accounts.active();
+        if (job.account) {
+          if (auth->adoptRefreshTokenLocked(*job.account, tokens.refreshToken) == RefreshTokenUpdate::REUSED) {
+            tokens.refreshToken.reset();
           }
-        }
-        if (auth->_refreshInFlight == promise) {
-          auth->_refreshInFlight = nullptr;
+          job.account->user = job.account->user.withTokens(tokens);
+          auth->observeIssuedTokensLocked(*job.account, tokens.idToken.has_value());
+          // Token rotation only journals the delta, not the whole user.
+          if (isActive && auth->_sessionStore) auth->_sessionStore->saveTokens(tokens);
+          if (isActive) auth->publishSharedSessionLocked();
         }
       }
     }
     if (isStale) {
-      rejectIfPending(promise, "cancelled");
-      return;
+      rejectIfPending(job.promise, AuthErrorCode::CANCELLED);
+    } else if (isMismatched) {
+      auth->log("refreshToken rejected: id_token subject does not match the account");
+      rejectIfPending(job.promise, AuthErrorCode::TOKEN_ERROR);
+    } else {
+      if (isActive) {
+        auth->notifyTokensRefreshed(tokens);
+        auth->notifyAuthStateChanged();
+      }
+      auth->log("refreshToken resolved");
+      job.promise->resolve(tokens);
     }
-    auth->notifyTokensRefreshed(tokens);
-    auth->notifyAuthStateChanged();
-    auth->log("refreshToken resolved");
-    promise->resolve(tokens);
+    // Last: starting the next refresh may release the platform promise that owns this listener.
+    auth->releasePlatformRefresh(job.ticket);
   });
+}
 
-  refreshPromise->addOnRejectedListener([self, promise, generation](const std::exception_ptr& error) {
-    auto* auth = dynamic_cast<HybridAuth*>(self.get());
-    if (!auth) {
-      promise->reject(makeAuthError("internal_error"));
-      return;
-    }
-    bool isStale = false;
-    {
-      std::lock_guard<std::recursive_mutex> lock(auth->_mutex);
-      if (auth->_sessionGeneration != generation) {
-        if (auth->_refreshInFlight == promise) {
-          auth->_refreshInFlight = nullptr;
-        }
-        isStale = true;
-      } else if (auth->_refreshInFlight == promise) {
-        auth->_refreshInFlight = nullptr;
+// Hands the platform to the next queued refresh whose account is still current.
+void HybridAuth::releasePlatformRefresh(uint64_t ticket) {
+  std::optional<RefreshJob> next;
+  std::vector<std::shared_ptr<Promise<AuthTokens>>> dropped;
+  {
+    std::lock_guard<std::recursive_mutex> lock(_mutex);
+    if (_platformRefreshTicket != ticket) return;
+    _platformRefreshTicket.reset();
+    while (!_refreshQueue.empty()) {
+      auto job = std::move(_refreshQueue.front());
+      _refreshQueue.pop_front();
+      if (!job.promise->isPending()) continue;
+      if (refreshSlotLocked(job.account).generation != job.generation) {
+        finishRefreshLocked(job);
+        dropped.push_back(std::move(job.promise));
+        continue;
       }
+      job.ticket = _nextRefreshTicket++;
+      _platformRefreshTicket = job.ticket;
+      next = std::move(job);
+      break;
     }
-    if (isStale) {
-      auth->log("refreshToken cancelled");
-      rejectIfPending(promise, "cancelled");
-      return;
-    }
-    auth->log("refreshToken rejected");
-    promise->reject(error);
-  });
-  return promise;
+  }
+  rejectIfPending(dropped, AuthErrorCode::CANCELLED);
+  if (next) launchRefresh(std::move(*next));
 }
- 
+
 void HybridAuth::setLoggingEnabled(bool enabled) {
   {
     std::lock_guard<std::recursive_mutex> lock(_mutex);
@@ -564,6 +1627,18 @@ void HybridAuth::setLoggingEnabled(bool enabled) {
   }
 }
 
+void HybridAuth::notifyDeviceCode(const DeviceAuthorization& authorization) {
+  std::vector<std::function<void(const DeviceAuthorization&)>> listeners;
+  {
+    std::lock_guard<std::recursive_mutex> lock(_mutex);
+    listeners.reserve(_deviceCodeListeners.size());
+    for (auto const& [id, listener] : _deviceCodeListeners) {
+      listeners.push_back(listener);
+    }
+  }
+  invokeListenersSafely(listeners, authorization);
+}
+
 void HybridAuth::notifyTokensRefreshed(const AuthTokens& tokens) {
   std::vector<std::function<void(const AuthTokens&)>> listeners;
   {
@@ -1,11 +1,33 @@
 #pragma once
 
 #include "HybridAuthSpec.hpp"
+#include "AccessTokenCache.hpp"
+#include "AccountRegistry.hpp"
 #include "AuthUser.hpp"
 #include "LoginOptions.hpp"
 #include "AuthTokens.hpp"
+#include "IdTokenVerifier.hpp"
+#include "MemoryAccounting.hpp"
+#include "OidcClient.hpp"
+#include "OidcMetadataCache.hpp"
+#include "OidcProviderConfig.hpp"
+#include "AuthClock.hpp"
+#include "AuthTrace.hpp"
+#include "AuthUserHostObject.hpp"
+#include "CancellationToken.hpp"
+#include "ClockSkew.hpp"
+#include "PendingOperationRegistry.hpp"
+#include "PlatformAuth.hpp"
+#include "RefreshBackoff.hpp"
+#include "RefreshTokenLedger.hpp"
+#include "SessionStore.hpp"
+#include "SharedSessionSegment.hpp"
+#include "TimerService.hpp"
+#include <atomic>
 #include <cstdint>
+#include <deque>
 #include <optional>
+#include <unordered_map>
 #include <mutex>
 #include <memory>
 #include <string>
@@ -14,6 +36,16 @@
 
 namespace margelo::nitro::NitroAuth {
 
+// Upper bounds for platform operations; a value <= 0 disables the deadline.
+struct OperationDeadlines {
+  int64_t loginMs = 10 * 60 * 1000;
+  int64_t requestScopesMs = 10 * 60 * 1000;
+  int64_t refreshTokenMs = 60 * 1000;
+  int64_t silentRestoreMs = 60 * 1000;
+};
+
+class OperationWatch;
+
 class HybridAuth: public HybridAuthSpec {
 public:
   HybridAuth();
@@ -21,12 +53,18 @@ public:
   std::optional<AuthUser> getCurrentUser() override;
   std::vector<std::string> getGrantedScopes() override;
   bool getHasPlayServices() override;
+  std::vector<AuthAccount> getAccounts() override;
+  double getSessionVersion() override;
+  SessionSnapshot getSessionSnapshot() override;
+  std::optional<UserChange> getCurrentUserIfChanged(double sinceVersion) override;
+  MemoryStats getMemoryStats() override;
 
   std::shared_ptr<Promise<void>> login(AuthProvider provider, const std::optional<LoginOptions>& options) override;
   std::shared_ptr<Promise<void>> requestScopes(const std::vector<std::string>& scopes) override;
   std::shared_ptr<Promise<void>> revokeScopes(const std::vector<std::string>& scopes) override;
   std::shared_ptr<Promise<void>> revokeAccess() override;
-  std::shared_ptr<Promise<std::optional<std::string>>> getAccessToken() override;
+  std::shared_ptr<Promise<std::optional<std::string>>> getAccessToken(const std::optional<AccessTokenRequest>& request) override;
+  std::shared_ptr<Promise<IdTokenClaims>> verifyIdToken(const IdTokenVerificationOptions& options) override;
   std::shared_ptr<Promise<AuthTokens>> refreshToken() override;
 
   void logout() override;
@@ -34,29 +72,185 @@ public:
   std::function<void()> onAuthStateChanged(const std::function<void(const std::optional<AuthUser>&)>& callback) override;
   std::function<void()> onTokensRefreshed(const std::function<void(const AuthTokens&)>& callback) override;
   void setLoggingEnabled(bool enabled) override;
-  // Note: setStorageAdapter is kept internally but not exposed in public API
-  // Storage is in-memory only by default
+  void switchAccount(const std::string& accountId) override;
+  std::shared_ptr<Promise<std::optional<std::string>>> getAccessTokenForAccount(const std::string& accountId,
+                                                                               const std::optional<AccessTokenRequest>& request) override;
+  void configureOidc(const OidcProviderConfig& config) override;
+  std::function<void()> onDeviceCode(const std::function<void(const DeviceAuthorization&)>& callback) override;
+
+  // Native entry points that bind the operation to a caller-owned cancellation token.
+  std::shared_ptr<Promise<void>> login(AuthProvider provider, const std::optional<LoginOptions>& options,
+                                       const std::shared_ptr<CancellationToken>& cancellation);
+  std::shared_ptr<Promise<void>> requestScopes(const std::vector<std::string>& scopes,
+                                               const std::shared_ptr<CancellationToken>& cancellation);
+  std::shared_ptr<Promise<AuthTokens>> refreshToken(const std::shared_ptr<CancellationToken>& cancellation);
+  std::shared_ptr<Promise<void>> silentRestore(const std::shared_ptr<CancellationToken>& cancellation);
+  // The session access token of the active account.
+  std::shared_ptr<Promise<std::optional<std::string>>> getAccessToken();
+
+  void setOperationDeadlines(const OperationDeadlines& deadlines);
+  void setTimerService(const std::shared_ptr<TimerService>& timerService);
+  void setClock(const std::shared_ptr<AuthClock>& clock);
+  void setRefreshBackoffPolicy(const RefreshBackoffPolicy& policy);
+  void setRefreshTimingPolicy(const RefreshTimingPolicy& policy);
+  // Opt-in native persistence; never installed by the platform bindings, so the
+  // session is in-memory only by default. Adopts the stored session when signed out.
+  void setSessionStore(const std::shared_ptr<SessionStore>& store);
+  // Opt-in: publishes the active access token to `segment` for the app's other
+  // processes. Only the primary process may install one.
+  void setSharedSession(const std::shared_ptr<SharedSessionSegment>& segment);
+  void setAccessTokenCacheLimits(const AccessTokenCacheLimits& limits);
+  // Opt-in: records API calls and platform outcomes for replay; nullptr stops recording.
+  void setTraceRecorder(const std::shared_ptr<AuthTraceRecorder>& recorder);
+  // The active account's packed user; copying it shares the buffer.
+  std::optional<PackedAuthUser> getCurrentUserSnapshot();
+  // JS-only, registered as a raw method: the current user as an AuthUserHostObject
+  // that converts properties on read. Views of an unchanged session share one host object.
+  jsi::Value getCurrentUserView(jsi::Runtime& runtime, const jsi::Value& thisValue, const jsi::Value* args, size_t count);
+  // Discovery and JWKS cache, prefetched for the configured providers on construction.
+  std::shared_ptr<OidcMetadataCache> getMetadataCache();
+  void setMetadataCache(const std::shared_ptr<OidcMetadataCache>& metadata);
+  AccessTokenCacheStats getAccessTokenCacheStats();
+  IdTokenVerifierStats getIdTokenVerifierStats();
+  RefreshTokenStats getRefreshTokenStats();
+  ClockSkewEstimate getClockSkewEstimate();
+
+protected:
+  void loadHybridMethods() override;
 
 private:
+  struct RefreshJob {
+    // nullptr for a refresh started while signed out.
+    std::shared_ptr<AccountSession> account;
+    std::optional<AuthProvider> provider;
+    uint64_t generation = 0;
+    std::shared_ptr<Promise<AuthTokens>> promise;
+    std::shared_ptr<CancellationToken> cancellation;
+    uint64_t ticket = 0;
+    // Set for resource token requests: the platform scopes and the cache entry to fill.
+    std::vector<std::string> scopes;
+    std::string cacheKey;
+  };
+
+  // Interactive sign-in: the core's OIDC client for `AuthProvider::OIDC`, the platform otherwise.
+  std::shared_ptr<Promise<Result<AuthUser>>> startLogin(AuthProvider provider, const std::optional<LoginOptions>& options);
+  std::shared_ptr<Promise<Result<AuthTokens>>> startRefresh(const RefreshJob& job);
+  // nullptr until configureOidc(); rebuilt after the clock or metadata cache changes.
+  std::shared_ptr<OidcClient> oidcClientLocked();
   void notifyAuthStateChanged();
   void notifyTokensRefreshed(const AuthTokens& tokens);
+  void notifyDeviceCode(const DeviceAuthorization& authorization);
+  // Stops the device-code polling of a superseded or aborted login.
+  void cancelDeviceLogin(const std::string& reason);
+  void persistSessionLocked();
+  void publishSharedSessionLocked();
+  // Adopts a refresh token returned for `account`; a superseded one is refused and left out.
+  RefreshTokenUpdate adoptRefreshTokenLocked(AccountSession& account, const std::optional<std::string>& refreshToken);
+  // Samples the clock skew from a just-issued id_token and notes whether the
+  // account's expiry was copied from its `exp`.
+  void observeIssuedTokensLocked(AccountSession& account, bool isFresh);
+  // `expirationTime` on the device clock.
+  int64_t deviceExpiryLocked(double expirationTime, bool isServerTime);
+  uint64_t sessionVersionLocked();
   std::shared_ptr<Promise<AuthTokens>> advanceSessionGenerationLocked();
-  void trackSessionPromiseLocked(const std::shared_ptr<Promise<void>>& promise);
-  std::vector<std::shared_ptr<Promise<void>>> takePendingSessionPromisesLocked();
+  RefreshSlot& refreshSlotLocked(const std::shared_ptr<AccountSession>& account);
+  std::shared_ptr<Promise<std::optional<std::string>>> accessTokenFor(const std::shared_ptr<AccountSession>& account,
+                                                                     const std::optional<AccessTokenRequest>& request);
+  std::shared_ptr<Promise<std::optional<std::string>>> resourceAccessTokenFor(const std::shared_ptr<AccountSession>& account,
+                                                                             std::vector<std::string> scopes);
+  void verifyIdTokenWith(const std::shared_ptr<Promise<IdTokenClaims>>& promise,
+                         const std::shared_ptr<OidcMetadataCache>& metadata, const std::string& authority,
+                         const std::string& token, IdTokenExpectations expectations, bool retried);
+  // Drops cached resource tokens for `accountId` (all accounts when nullopt) and
+  // hands back their in-flight refreshes for the caller to settle.
+  void retireAccessTokensLocked(const std::optional<std::string>& accountId,
+                                std::vector<std::shared_ptr<Promise<AuthTokens>>>& retired);
+  std::shared_ptr<Promise<AuthTokens>> refreshAccount(const std::shared_ptr<AccountSession>& account,
+                                                      const std::shared_ptr<CancellationToken>& cancellation);
+  bool scheduleRefreshLocked(RefreshJob& job);
+  bool finishRefreshLocked(const RefreshJob& job);
+  void launchRefresh(RefreshJob job);
+  void releasePlatformRefresh(uint64_t ticket);
+  std::shared_ptr<OperationWatch> watchOperation(PlatformOperation operation,
+                                                 const std::shared_ptr<CancellationToken>& cancellation,
+                                                 std::function<void(const std::string&)> onAbort);
+  // Aborts the interactive `operation` a new call or logout supersedes, freeing
+  // its platform slot; no-op when none is in flight.
+  void abortInteractiveOperation(PlatformOperation operation);
+  // Drops a settled `watch` from its slot; the weak_ptr alone would keep its allocation.
+  void forgetInteractiveOperation(PlatformOperation operation, const std::shared_ptr<OperationWatch>& watch);
+  int64_t nowMs();
   void log(const std::string& message);
+  void traceCall(AuthTraceOp op, std::optional<AuthProvider> provider = std::nullopt,
+                 const std::optional<std::string>& accountId = std::nullopt, std::vector<std::string> scopes = {});
+  void traceSuccess(AuthTraceOp op, const std::optional<std::string>& accountId,
+                    const std::optional<double>& expirationTime);
+  void traceFailure(AuthTraceOp op, const AuthError& error);
 
 private:
-  std::optional<AuthUser> _currentUser;
-  std::vector<std::string> _grantedScopes;
-  std::map<uint64_t, std::function<void(const std::optional<AuthUser>&)>> _listeners;
+  template <typename Callback>
+  using ListenerMap =
+    std::map<uint64_t, Callback, std::less<uint64_t>,
+             TrackedAllocator<std::pair<const uint64_t, Callback>, MemorySubsystem::LISTENERS>>;
+  template <typename T>
+  using PendingAllocator = TrackedAllocator<T, MemorySubsystem::PENDING_OPERATIONS>;
+
+  AccountRegistry _accounts;
+  ListenerMap<std::function<void(const std::optional<AuthUser>&)>> _listeners;
   uint64_t _nextListenerId = 0;
 
-  std::map<uint64_t, std::function<void(const AuthTokens&)>> _tokenListeners;
+  ListenerMap<std::function<void(const AuthTokens&)>> _tokenListeners;
   uint64_t _nextTokenListenerId = 0;
-  std::shared_ptr<Promise<AuthTokens>> _refreshInFlight;
-  std::vector<std::weak_ptr<Promise<void>>> _sessionPromises;
+
+  ListenerMap<std::function<void(const DeviceAuthorization&)>> _deviceCodeListeners;
+  uint64_t _nextDeviceCodeListenerId = 0;
+  RefreshBackoffPolicy _refreshBackoffPolicy;
+  RefreshTimingPolicy _refreshTiming;
+  // Refresh state while no account is signed in.
+  RefreshSlot _signedOutRefresh{RefreshBackoffPolicy{}};
+  // Platforms run one refresh at a time; other accounts' refreshes wait here.
+  std::deque<RefreshJob, PendingAllocator<RefreshJob>> _refreshQueue;
+  std::optional<uint64_t> _platformRefreshTicket;
+  uint64_t _nextRefreshTicket = 0;
+  AccessTokenCache _accessTokens;
+  RefreshTokenStats _refreshTokenStats;
+  // Single-flight resource token refreshes, keyed like `_accessTokens`.
+  std::unordered_map<std::string, std::shared_ptr<Promise<AuthTokens>>, std::hash<std::string>,
+                     std::equal_to<std::string>,
+                     PendingAllocator<std::pair<const std::string, std::shared_ptr<Promise<AuthTokens>>>>>
+    _resourceRefreshes;
+  OperationDeadlines _deadlines;
+  std::shared_ptr<TimerService> _timerService;
+  std::shared_ptr<AuthClock> _clock;
+  // Thread-safe on its own; also fed from HTTP completions.
+  std::shared_ptr<ClockSkewEstimator> _clockSkew = std::make_shared<ClockSkewEstimator>();
+  std::shared_ptr<SessionStore> _sessionStore;
+  std::shared_ptr<SharedSessionSegment> _sharedSession;
+  std::shared_ptr<OidcMetadataCache> _metadata;
+  std::optional<OidcProviderConfig> _oidcConfig;
+  std::shared_ptr<OidcClient> _oidc;
+  // Set while a device-code login is polling.
+  std::shared_ptr<CancellationToken> _deviceLogin;
+  // The interactive platform calls in flight; owned by their platform promises.
+  std::weak_ptr<OperationWatch> _loginWatch;
+  std::weak_ptr<OperationWatch> _scopesWatch;
+  // Thread-safe on its own; used without holding _mutex.
+  IdTokenVerifier _idTokens;
+  // Thread-safe on its own; settle listeners never take _mutex.
+  std::shared_ptr<PendingOperationRegistry> _sessionPromises = std::make_shared<PendingOperationRegistry>();
   uint64_t _sessionGeneration = 0;
+  // _sessionGeneration only moves when the session is replaced, to strand
+  // in-flight operations. The version also follows refreshes and scope edits:
+  // it advances when a read finds the active user's revision changed, and every
+  // user, scope and account change packs a new user, so nothing else bumps it.
+  uint64_t _sessionVersion = 0;
+  uint64_t _versionedRevision = 0;
   bool _loggingEnabled = false;
+  std::shared_ptr<AuthTraceRecorder> _trace;
+  // Owned by the JS objects wrapping it, so it never outlives the runtime.
+  std::weak_ptr<AuthUserHostObject> _userView;
+  // Lets untraced calls skip the lock.
+  std::atomic<bool> _tracing{false};
   
   // recursive_mutex: listeners resolved inside a lock scope may re-enter Auth methods
   // that also acquire _mutex, causing deadlock with a non-recursive mutex.
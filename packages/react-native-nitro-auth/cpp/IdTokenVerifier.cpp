@@ -0,0 +1,294 @@
+#include "IdTokenVerifier.hpp"
+#include "JSONReader.hpp"
+#include "JwsCrypto.hpp"
+#include <cmath>
+
+namespace margelo::nitro::NitroAuth {
+
+namespace {
+
+constexpr std::string_view kTenantPlaceholder = "{tenantid}";
+
+// Claim values of an unexpected type are ignored rather than failing the whole payload.
+bool readStringClaim(JSONReader& reader, std::optional<std::string>& field) {
+  if (reader.peek() != '"') return reader.skipValue();
+  field.emplace();
+  return reader.readString(*field);
+}
+
+bool readSecondsClaim(JSONReader& reader, std::optional<int64_t>& field) {
+  const char next = reader.peek();
+  if (next != '-' && (next < '0' || next > '9')) return reader.skipValue();
+  double seconds = 0;
+  if (!reader.readNumber(seconds)) return false;
+  if (std::isfinite(seconds) && std::fabs(seconds) < 1e13) field = static_cast<int64_t>(seconds * 1000);
+  return true;
+}
+
+std::optional<IdTokenPayload> parseClaims(std::string_view payload) {
+  IdTokenPayload claims;
+  std::optional<std::string> issuer;
+  std::optional<std::string> subject;
+  std::optional<int64_t> expiresAtMs;
+  bool hasAudience = false;
+  const bool ok = readJSONObject(payload, [&](std::string_view key, JSONReader& reader) {
+    if (key == "iss") return readStringClaim(reader, issuer);
+    if (key == "sub") return readStringClaim(reader, subject);
+    if (key == "aud") {
+      hasAudience = true;
+      if (reader.peek() == '[') return reader.readStringArray(claims.audiences);
+      claims.audiences.emplace_back();
+      return reader.readString(claims.audiences.back());
+    }
+    if (key == "azp") return readStringClaim(reader, claims.authorizedParty);
+    if (key == "exp") return readSecondsClaim(reader, expiresAtMs);
+    if (key == "iat") return readSecondsClaim(reader, claims.issuedAtMs);
+    if (key == "nbf") return readSecondsClaim(reader, claims.notBeforeMs);
+    if (key == "nonce") return readStringClaim(reader, claims.nonce);
+    if (key == "email") return readStringClaim(reader, claims.email);
+    if (key == "name") return readStringClaim(reader, claims.name);
+    if (key == "picture") return readStringClaim(reader, claims.picture);
+    if (key == "tid") return readStringClaim(reader, claims.tenantId);
+    return reader.skipValue();
+  });
+  if (!ok || !issuer || !subject || !expiresAtMs || !hasAudience || claims.audiences.empty()) return std::nullopt;
+  claims.issuer = std::move(*issuer);
+  claims.subject = std::move(*subject);
+  claims.expiresAtMs = *expiresAtMs;
+  return claims;
+}
+
+bool issuerMatches(const std::string& expected, const IdTokenPayload& claims) {
+  const size_t placeholder = expected.find(kTenantPlaceholder);
+  if (placeholder == std::string::npos) return expected == claims.issuer;
+  if (!claims.tenantId || claims.tenantId->empty()) return false;
+  std::string resolved = expected;
+  resolved.replace(placeholder, kTenantPlaceholder.size(), *claims.tenantId);
+  return resolved == claims.issuer;
+}
+
+IdTokenVerification invalid(std::string error, std::string reason) {
+  IdTokenVerification result;
+  result.error = std::move(error);
+  result.reason = std::move(reason);
+  return result;
+}
+
+} // namespace
+
+IdTokenVerifier::IdTokenVerifier(size_t memoCapacity) : _memoCapacity(memoCapacity) {}
+
+std::optional<IdTokenPayload> IdTokenVerifier::decodeUnverified(const std::string& token) {
+  const size_t first = token.find('.');
+  const size_t second = first == std::string::npos ? first : token.find('.', first + 1);
+  if (second == std::string::npos) return std::nullopt;
+  auto payload = JwsCrypto::base64UrlDecode(std::string_view(token).substr(first + 1, second - first - 1));
+  if (!payload) return std::nullopt;
+  return parseClaims(*payload);
+}
+
+std::vector<JsonWebKey> IdTokenVerifier::parseKeySet(const std::string& jwks) {
+  std::vector<JsonWebKey> keys;
+  readJSONObject(jwks, [&](std::string_view key, JSONReader& reader) {
+    if (key != "keys") return reader.skipValue();
+    return reader.readArray([&](JSONReader& element) {
+      std::optional<std::string> kty, kid, alg, use, crv, n, e, x, y;
+      const bool parsed = element.readObject([&](std::string_view field, JSONReader& value) {
+        if (field == "kty") return readStringClaim(value, kty);
+        if (field == "kid") return readStringClaim(value, kid);
+        if (field == "alg") return readStringClaim(value, alg);
+        if (field == "use") return readStringClaim(value, use);
+        if (field == "crv") return readStringClaim(value, crv);
+        if (field == "n") return readStringClaim(value, n);
+        if (field == "e") return readStringClaim(value, e);
+        if (field == "x") return readStringClaim(value, x);
+        if (field == "y") return readStringClaim(value, y);
+        return value.skipValue();
+      });
+      if (!parsed) return false;
+      if (!kty || (use && *use != "sig")) return true;
+
+      JsonWebKey jwk;
+      jwk.kid = kid.value_or("");
+      jwk.kty = *kty;
+      jwk.alg = alg;
+      if (*kty == "RSA" && n && e && (!alg || *alg == "RS256")) {
+        auto modulus = JwsCrypto::base64UrlDecode(*n);
+        auto exponent = JwsCrypto::base64UrlDecode(*e);
+        if (!modulus || !exponent) return true;
+        jwk.n = std::move(*modulus);
+        jwk.e = std::move(*exponent);
+      } else if (*kty == "EC" && crv && *crv == "P-256" && x && y && (!alg || *alg == "ES256")) {
+        auto pointX = JwsCrypto::base64UrlDecode(*x);
+        auto pointY = JwsCrypto::base64UrlDecode(*y);
+        if (!pointX || !pointY || pointX->size() != 32 || pointY->size() != 32) return true;
+        jwk.x = std::move(*pointX);
+        jwk.y = std::move(*pointY);
+      } else {
+        return true;
+      }
+      keys.push_back(std::move(jwk));
+      return true;
+    });
+  });
+  return keys;
+}
+
+IdTokenVerification IdTokenVerifier::verify(const std::string& token, const OidcMetadata& metadata,
+                                            const IdTokenExpectations& expectations, int64_t nowMs) {
+  Signed result;
+  std::shared_ptr<const std::vector<JsonWebKey>> keys;
+  {
+    std::lock_guard<std::mutex> lock(_mutex);
+    _stats.verifications++;
+    auto it = _memoIndex.find(token);
+    if (it != _memoIndex.end() && it->second->authority == metadata.authority &&
+        it->second->fetchedAtMs == metadata.fetchedAtMs) {
+      _stats.memoHits++;
+      _memo.splice(_memo.begin(), _memo, it->second);
+      result = it->second->result;
+    } else {
+      keys = keysLocked(metadata);
+    }
+  }
+
+  if (keys) {
+    result = checkSignature(token, *keys);
+    std::lock_guard<std::mutex> lock(_mutex);
+    _stats.signatureChecks++;
+    if (auto it = _memoIndex.find(token); it != _memoIndex.end()) {
+      _memo.erase(it->second);
+      _memoIndex.erase(it);
+    }
+    if (_memoCapacity > 0) {
+      _memo.push_front(MemoEntry{token, metadata.authority, metadata.fetchedAtMs, result});
+      _memoIndex.emplace(token, _memo.begin());
+      while (_memo.size() > _memoCapacity) {
+        _memoIndex.erase(_memo.back().token);
+        _memo.pop_back();
+      }
+    }
+  }
+
+  if (!result.claims) {
+    auto failure = invalid("token_error", result.reason);
+    failure.unknownKey = result.unknownKey;
+    return failure;
+  }
+
+  const IdTokenPayload& claims = *result.claims;
+  bool issuerAccepted = false;
+  for (const auto& issuer : expectations.issuers) {
+    if (issuerMatches(issuer, claims)) {
+      issuerAccepted = true;
+      break;
+    }
+  }
+  if (!issuerAccepted) return invalid("token_error", "issuer_mismatch");
+
+  bool audienceAccepted = false;
+  for (const auto& audience : claims.audiences) {
+    if (!expectations.audience.empty() && audience == expectations.audience) {
+      audienceAccepted = true;
+      break;
+    }
+  }
+  if (!audienceAccepted) return invalid("token_error", "audience_mismatch");
+  // OpenID Connect Core §3.1.3.7: with several audiences, `azp` names the client the token was issued to.
+  if (claims.audiences.size() > 1 && claims.authorizedParty != expectations.audience) {
+    return invalid("token_error", "authorized_party_mismatch");
+  }
+
+  if (nowMs > claims.expiresAtMs + expectations.clockSkewMs) return invalid("token_error", "expired");
+  if (claims.notBeforeMs && nowMs + expectations.clockSkewMs < *claims.notBeforeMs) {
+    return invalid("token_error", "not_yet_valid");
+  }
+  if (claims.issuedAtMs && nowMs + expectations.clockSkewMs < *claims.issuedAtMs) {
+    return invalid("token_error", "issued_in_future");
+  }
+  if (expectations.nonce && claims.nonce != expectations.nonce) return invalid("invalid_nonce", "nonce_mismatch");
+
+  IdTokenVerification verification;
+  verification.claims = claims;
+  return verification;
+}
+
+IdTokenVerifierStats IdTokenVerifier::stats() {
+  std::lock_guard<std::mutex> lock(_mutex);
+  return _stats;
+}
+
+IdTokenVerifier::Signed IdTokenVerifier::checkSignature(const std::string& token, const std::vector<JsonWebKey>& keys) {
+  Signed result;
+  const size_t first = token.find('.');
+  const size_t second = first == std::string::npos ? first : token.find('.', first + 1);
+  if (second == std::string::npos || token.find('.', second + 1) != std::string::npos) {
+    result.reason = "malformed";
+    return result;
+  }
+  const std::string_view view(token);
+  auto header = JwsCrypto::base64UrlDecode(view.substr(0, first));
+  auto signature = JwsCrypto::base64UrlDecode(view.substr(second + 1));
+  if (!header || !signature) {
+    result.reason = "malformed";
+    return result;
+  }
+
+  std::optional<std::string> alg;
+  std::optional<std::string> kid;
+  bool critical = false;
+  const bool parsed = readJSONObject(*header, [&](std::string_view key, JSONReader& reader) {
+    if (key == "alg") return readStringClaim(reader, alg);
+    if (key == "kid") return readStringClaim(reader, kid);
+    // RFC 7515 §4.1.11: no extensions are understood, so any `crit` header is fatal.
+    if (key == "crit") critical = true;
+    return reader.skipValue();
+  });
+  if (!parsed || !alg) {
+    result.reason = "malformed";
+    return result;
+  }
+  if (critical || (*alg != "RS256" && *alg != "ES256")) {
+    result.reason = "unsupported_algorithm";
+    return result;
+  }
+
+  const std::string kty = *alg == "RS256" ? "RSA" : "EC";
+  const JsonWebKey* key = nullptr;
+  size_t candidates = 0;
+  for (const auto& candidate : keys) {
+    if (candidate.kty != kty || (candidate.alg && *candidate.alg != *alg)) continue;
+    if (kid && candidate.kid != *kid) continue;
+    key = &candidate;
+    candidates++;
+  }
+  // Without a `kid` the key must be unambiguous.
+  if (key == nullptr || (!kid && candidates > 1)) {
+    result.reason = "unknown_key";
+    result.unknownKey = kid.has_value();
+    return result;
+  }
+
+  const auto digest = JwsCrypto::sha256(view.substr(0, second));
+  const bool valid = kty == "RSA" ? JwsCrypto::verifyRs256(key->n, key->e, digest, *signature)
+                                  : JwsCrypto::verifyEs256(key->x, key->y, digest, *signature);
+  if (!valid) {
+    result.reason = "bad_signature";
+    return result;
+  }
+
+  auto payload = JwsCrypto::base64UrlDecode(view.substr(first + 1, second - first - 1));
+  if (payload) result.claims = parseClaims(*payload);
+  if (!result.claims) result.reason = "malformed_claims";
+  return result;
+}
+
+std::shared_ptr<const std::vector<JsonWebKey>> IdTokenVerifier::keysLocked(const OidcMetadata& metadata) {
+  auto it = _keySets.find(metadata.authority);
+  if (it != _keySets.end() && it->second.fetchedAtMs == metadata.fetchedAtMs) return it->second.keys;
+  auto keys = std::make_shared<const std::vector<JsonWebKey>>(parseKeySet(metadata.jwks));
+  _keySets[metadata.authority] = KeySet{metadata.fetchedAtMs, keys};
+  return keys;
+}
+
+} // namespace margelo::nitro::NitroAuth
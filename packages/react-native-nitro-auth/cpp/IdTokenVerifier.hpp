@@ -0,0 +1,119 @@
+#pragma once
+
+#include "OidcMetadataCache.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace margelo::nitro::NitroAuth {
+
+struct JsonWebKey {
+  std::string kid;
+  // "RSA" or "EC"; other key types are dropped when the set is parsed.
+  std::string kty;
+  std::optional<std::string> alg;
+  // Decoded big-endian integers: n/e for RSA, x/y for EC (P-256 only).
+  std::string n;
+  std::string e;
+  std::string x;
+  std::string y;
+};
+
+struct IdTokenPayload {
+  std::string issuer;
+  std::string subject;
+  std::vector<std::string> audiences;
+  std::optional<std::string> authorizedParty;
+  int64_t expiresAtMs = 0;
+  std::optional<int64_t> issuedAtMs;
+  std::optional<int64_t> notBeforeMs;
+  std::optional<std::string> nonce;
+  std::optional<std::string> email;
+  std::optional<std::string> name;
+  std::optional<std::string> picture;
+  // Microsoft `tid`, substituted for `{tenantid}` in expected issuers.
+  std::optional<std::string> tenantId;
+};
+
+struct IdTokenExpectations {
+  // Accepted `iss` values.
+  std::vector<std::string> issuers;
+  std::string audience;
+  // Checked only when set.
+  std::optional<std::string> nonce;
+  int64_t clockSkewMs = 5 * 60 * 1000;
+};
+
+struct IdTokenVerification {
+  // Set only when the token is valid.
+  std::optional<IdTokenPayload> claims;
+  // AuthErrorCode (`token_error` or `invalid_nonce`) when invalid.
+  std::string error;
+  std::string reason;
+  // The token names a `kid` missing from the key set; a refetched JWKS may have it.
+  bool unknownKey = false;
+};
+
+struct IdTokenVerifierStats {
+  uint64_t verifications = 0;
+  uint64_t memoHits = 0;
+  uint64_t signatureChecks = 0;
+};
+
+// Offline id_token verification (RS256 / ES256) against the JWKS held by an
+// OidcMetadata entry.
+//
+// Parsing and the signature check are memoized per token and key set, so
+// repeated trust decisions about the same session cost a hash lookup. The
+// time, issuer, audience and nonce checks run on every call.
+class IdTokenVerifier {
+public:
+  explicit IdTokenVerifier(size_t memoCapacity = 32);
+
+  // Parses the payload without checking anything, e.g. to pick the authority.
+  static std::optional<IdTokenPayload> decodeUnverified(const std::string& token);
+  // Keys with an unsupported type, curve or algorithm are skipped.
+  static std::vector<JsonWebKey> parseKeySet(const std::string& jwks);
+
+  IdTokenVerification verify(const std::string& token, const OidcMetadata& metadata,
+                             const IdTokenExpectations& expectations, int64_t nowMs);
+
+  IdTokenVerifierStats stats();
+
+private:
+  struct Signed {
+    std::optional<IdTokenPayload> claims;
+    std::string reason;
+    bool unknownKey = false;
+  };
+  struct MemoEntry {
+    std::string token;
+    std::string authority;
+    int64_t fetchedAtMs;
+    Signed result;
+  };
+  struct KeySet {
+    int64_t fetchedAtMs;
+    std::shared_ptr<const std::vector<JsonWebKey>> keys;
+  };
+
+  Signed checkSignature(const std::string& token, const std::vector<JsonWebKey>& keys);
+  std::shared_ptr<const std::vector<JsonWebKey>> keysLocked(const OidcMetadata& metadata);
+
+private:
+  const size_t _memoCapacity;
+  std::mutex _mutex;
+  // Most recently used first.
+  std::list<MemoEntry> _memo;
+  std::unordered_map<std::string, std::list<MemoEntry>::iterator> _memoIndex;
+  std::unordered_map<std::string, KeySet> _keySets;
+  IdTokenVerifierStats _stats;
+};
+
+} // namespace margelo::nitro::NitroAuth
@@ -0,0 +1,386 @@
+#pragma once
+
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <string>
+#include <string_view>
+#include <optional>
+#include <vector>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+#include <arm_neon.h>
+#endif
+
+namespace margelo::nitro::NitroAuth {
+
+// Low-level JSON primitives shared by the codecs in this directory. Header-only
+// so the hot string-scanning paths inline into each caller.
+
+constexpr int kMaxJSONSkipDepth = 64;
+
+// Offset of the first byte that is '"', '\\' or a control character, or `size`.
+// Both the writer (bytes to escape) and the reader (end of a plain run) stop there.
+inline size_t findJSONSpecial(const char* data, size_t size) {
+  size_t i = 0;
+#if defined(__SSE2__)
+  const __m128i quote = _mm_set1_epi8('"');
+  const __m128i backslash = _mm_set1_epi8('\\');
+  const __m128i controlMax = _mm_set1_epi8(0x1F);
+  for (; i + 16 <= size; i += 16) {
+    const __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i));
+    const __m128i isControl = _mm_cmpeq_epi8(_mm_min_epu8(chunk, controlMax), chunk);
+    const __m128i special =
+      _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(chunk, quote), _mm_cmpeq_epi8(chunk, backslash)), isControl);
+    const int mask = _mm_movemask_epi8(special);
+    if (mask != 0) {
+      return i + static_cast<size_t>(__builtin_ctz(static_cast<unsigned>(mask)));
+    }
+  }
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+  const uint8x16_t quote = vdupq_n_u8('"');
+  const uint8x16_t backslash = vdupq_n_u8('\\');
+  const uint8x16_t controlEnd = vdupq_n_u8(0x20);
+  for (; i + 16 <= size; i += 16) {
+    const uint8x16_t chunk = vld1q_u8(reinterpret_cast<const uint8_t*>(data + i));
+    const uint8x16_t special =
+      vorrq_u8(vorrq_u8(vceqq_u8(chunk, quote), vceqq_u8(chunk, backslash)), vcltq_u8(chunk, controlEnd));
+    if (vmaxvq_u8(special) != 0) {
+      break; // The scalar tail below pinpoints the byte inside this block.
+    }
+  }
+#endif
+  for (; i < size; ++i) {
+    const auto c = static_cast<unsigned char>(data[i]);
+    if (c == '"' || c == '\\' || c < 0x20) {
+      return i;
+    }
+  }
+  return size;
+}
+
+// Appends `value` as a quoted JSON string.
+inline void appendJSONString(std::string& out, std::string_view value) {
+  static constexpr char kHex[] = "0123456789abcdef";
+  out.push_back('"');
+  size_t start = 0;
+  while (start < value.size()) {
+    const size_t end = start + findJSONSpecial(value.data() + start, value.size() - start);
+    out.append(value.data() + start, end - start);
+    if (end == value.size()) {
+      break;
+    }
+    const auto c = static_cast<unsigned char>(value[end]);
+    switch (c) {
+      case '"': out.append("\\\""); break;
+      case '\\': out.append("\\\\"); break;
+      case '\b': out.append("\\b"); break;
+      case '\f': out.append("\\f"); break;
+      case '\n': out.append("\\n"); break;
+      case '\r': out.append("\\r"); break;
+      case '\t': out.append("\\t"); break;
+      default: {
+        const char escape[] = {'\\', 'u', '0', '0', kHex[c >> 4], kHex[c & 0xF]};
+        out.append(escape, sizeof(escape));
+        break;
+      }
+    }
+    start = end + 1;
+  }
+  out.push_back('"');
+}
+
+class JSONReader {
+public:
+  explicit JSONReader(std::string_view input) : _data(input.data()), _end(input.data() + input.size()) {}
+
+  bool atEnd() {
+    skipWhitespace();
+    return _data == _end;
+  }
+
+  bool consume(char expected) {
+    skipWhitespace();
+    if (_data == _end || *_data != expected) return false;
+    ++_data;
+    return true;
+  }
+
+  char peek() {
+    skipWhitespace();
+    return _data == _end ? '\0' : *_data;
+  }
+
+  // Decodes a JSON string into `out`; plain runs are copied in bulk.
+  bool readString(std::string& out) {
+    out.clear();
+    if (!consume('"')) return false;
+    while (true) {
+      const size_t run = findJSONSpecial(_data, static_cast<size_t>(_end - _data));
+      out.append(_data, run);
+      _data += run;
+      if (_data == _end) return false;
+      const char c = *_data++;
+      if (c == '"') return true;
+      if (c != '\\') return false; // Raw control characters are not allowed in JSON strings.
+      if (!readEscape(out)) return false;
+    }
+  }
+
+  // Keys without escapes are returned as a view into the input, avoiding a copy.
+  bool readKey(std::string_view& key, std::string& scratch) {
+    if (!consume('"')) return false;
+    const size_t run = findJSONSpecial(_data, static_cast<size_t>(_end - _data));
+    if (_data + run < _end && _data[run] == '"') {
+      key = std::string_view(_data, run);
+      _data += run + 1;
+      return consume(':');
+    }
+    --_data;
+    if (!readString(scratch)) return false;
+    key = scratch;
+    return consume(':');
+  }
+
+  bool readNull() {
+    skipWhitespace();
+    if (_end - _data < 4 || std::string_view(_data, 4) != "null") return false;
+    _data += 4;
+    return true;
+  }
+
+  bool readNumber(double& out) {
+    skipWhitespace();
+    const char* start = _data;
+    const char* cursor = _data;
+    bool negative = false;
+    if (cursor < _end && *cursor == '-') {
+      negative = true;
+      ++cursor;
+    }
+    if (cursor == _end || !isDigit(*cursor)) return false;
+    int64_t integer = 0;
+    int digits = 0;
+    if (*cursor == '0') {
+      ++cursor;
+    } else {
+      while (cursor < _end && isDigit(*cursor)) {
+        if (digits < 18) integer = integer * 10 + (*cursor - '0');
+        ++digits;
+        ++cursor;
+      }
+    }
+    bool isInteger = digits <= 18;
+    if (cursor < _end && *cursor == '.') {
+      isInteger = false;
+      ++cursor;
+      if (cursor == _end || !isDigit(*cursor)) return false;
+      while (cursor < _end && isDigit(*cursor)) ++cursor;
+    }
+    if (cursor < _end && (*cursor == 'e' || *cursor == 'E')) {
+      isInteger = false;
+      ++cursor;
+      if (cursor < _end && (*cursor == '+' || *cursor == '-')) ++cursor;
+      if (cursor == _end || !isDigit(*cursor)) return false;
+      while (cursor < _end && isDigit(*cursor)) ++cursor;
+    }
+    _data = cursor;
+    if (isInteger) {
+      out = static_cast<double>(negative ? -integer : integer);
+      return true;
+    }
+    // Rare path (fractions, exponents, >18 digits): the grammar is already validated.
+    const std::string text(start, static_cast<size_t>(cursor - start));
+    out = std::strtod(text.c_str(), nullptr);
+    return std::isfinite(out);
+  }
+
+  // Walks the object at the cursor, handing each key to `onField(key, reader)`;
+  // the value is left for it to consume.
+  template <typename OnField>
+  bool readObject(OnField&& onField) {
+    if (!consume('{')) return false;
+    if (consume('}')) return true;
+    std::string scratch;
+    do {
+      std::string_view key;
+      if (!readKey(key, scratch) || !onField(key, *this)) return false;
+    } while (consume(','));
+    return consume('}');
+  }
+
+  // Calls `onElement(reader)` for each element of the array at the cursor.
+  template <typename OnElement>
+  bool readArray(OnElement&& onElement) {
+    if (!consume('[')) return false;
+    if (consume(']')) return true;
+    do {
+      if (!onElement(*this)) return false;
+    } while (consume(','));
+    return consume(']');
+  }
+
+  bool readStringArray(std::vector<std::string>& out) {
+    out.clear();
+    if (!consume('[')) return false;
+    if (consume(']')) return true;
+    do {
+      out.emplace_back();
+      if (!readString(out.back())) return false;
+    } while (consume(','));
+    return consume(']');
+  }
+
+  bool skipValue(int depth = 0) {
+    if (depth > kMaxJSONSkipDepth) return false;
+    switch (peek()) {
+      case '"': {
+        std::string ignored;
+        return readString(ignored);
+      }
+      case '{': {
+        ++_data;
+        if (consume('}')) return true;
+        std::string scratch;
+        do {
+          std::string_view key;
+          if (!readKey(key, scratch) || !skipValue(depth + 1)) return false;
+        } while (consume(','));
+        return consume('}');
+      }
+      case '[': {
+        ++_data;
+        if (consume(']')) return true;
+        do {
+          if (!skipValue(depth + 1)) return false;
+        } while (consume(','));
+        return consume(']');
+      }
+      case 't': return readLiteral("true");
+      case 'f': return readLiteral("false");
+      case 'n': return readNull();
+      default: {
+        double ignored;
+        return readNumber(ignored);
+      }
+    }
+  }
+
+private:
+  static bool isDigit(char c) { return c >= '0' && c <= '9'; }
+
+  void skipWhitespace() {
+    while (_data < _end && (*_data == ' ' || *_data == '\n' || *_data == '\r' || *_data == '\t')) ++_data;
+  }
+
+  bool readLiteral(std::string_view literal) {
+    if (static_cast<size_t>(_end - _data) < literal.size() || std::string_view(_data, literal.size()) != literal) {
+      return false;
+    }
+    _data += literal.size();
+    return true;
+  }
+
+  bool readHex4(uint32_t& out) {
+    if (_end - _data < 4) return false;
+    out = 0;
+    for (int i = 0; i < 4; ++i) {
+      const char c = *_data++;
+      out <<= 4;
+      if (c >= '0' && c <= '9') out |= static_cast<uint32_t>(c - '0');
+      else if (c >= 'a' && c <= 'f') out |= static_cast<uint32_t>(c - 'a' + 10);
+      else if (c >= 'A' && c <= 'F') out |= static_cast<uint32_t>(c - 'A' + 10);
+      else return false;
+    }
+    return true;
+  }
+
+  bool readEscape(std::string& out) {
+    if (_data == _end) return false;
+    switch (*_data++) {
+      case '"': out.push_back('"'); return true;
+      case '\\': out.push_back('\\'); return true;
+      case '/': out.push_back('/'); return true;
+      case 'b': out.push_back('\b'); return true;
+      case 'f': out.push_back('\f'); return true;
+      case 'n': out.push_back('\n'); return true;
+      case 'r': out.push_back('\r'); return true;
+      case 't': out.push_back('\t'); return true;
+      case 'u': break;
+      default: return false;
+    }
+    uint32_t codePoint;
+    if (!readHex4(codePoint)) return false;
+    if (codePoint >= 0xDC00 && codePoint <= 0xDFFF) return false; // Lone low surrogate.
+    if (codePoint >= 0xD800 && codePoint <= 0xDBFF) {
+      uint32_t low;
+      if (_end - _data < 2 || _data[0] != '\\' || _data[1] != 'u') return false;
+      _data += 2;
+      if (!readHex4(low) || low < 0xDC00 || low > 0xDFFF) return false;
+      codePoint = 0x10000 + ((codePoint - 0xD800) << 10) + (low - 0xDC00);
+    }
+    appendUtf8(out, codePoint);
+    return true;
+  }
+
+  static void appendUtf8(std::string& out, uint32_t codePoint) {
+    if (codePoint < 0x80) {
+      out.push_back(static_cast<char>(codePoint));
+    } else if (codePoint < 0x800) {
+      out.push_back(static_cast<char>(0xC0 | (codePoint >> 6)));
+      out.push_back(static_cast<char>(0x80 | (codePoint & 0x3F)));
+    } else if (codePoint < 0x10000) {
+      out.push_back(static_cast<char>(0xE0 | (codePoint >> 12)));
+      out.push_back(static_cast<char>(0x80 | ((codePoint >> 6) & 0x3F)));
+      out.push_back(static_cast<char>(0x80 | (codePoint & 0x3F)));
+    } else {
+      out.push_back(static_cast<char>(0xF0 | (codePoint >> 18)));
+      out.push_back(static_cast<char>(0x80 | ((codePoint >> 12) & 0x3F)));
+      out.push_back(static_cast<char>(0x80 | ((codePoint >> 6) & 0x3F)));
+      out.push_back(static_cast<char>(0x80 | (codePoint & 0x3F)));
+    }
+  }
+
+  const char* _data;
+  const char* _end;
+};
+
+inline bool readOptionalString(JSONReader& reader, std::optional<std::string>& field) {
+  if (reader.peek() == 'n') {
+    field = std::nullopt;
+    return reader.readNull();
+  }
+  if (!field) field.emplace();
+  return reader.readString(*field);
+}
+
+inline bool readOptionalNumber(JSONReader& reader, std::optional<double>& field) {
+  if (reader.peek() == 'n') {
+    field = std::nullopt;
+    return reader.readNull();
+  }
+  double value;
+  if (!reader.readNumber(value)) return false;
+  field = value;
+  return true;
+}
+
+inline bool readOptionalStrings(JSONReader& reader, std::optional<std::vector<std::string>>& field) {
+  if (reader.peek() == 'n') {
+    field = std::nullopt;
+    return reader.readNull();
+  }
+  if (!field) field.emplace();
+  return reader.readStringArray(*field);
+}
+
+// Walks one top-level object, handing each key to `onField`; the value is left for it to consume.
+template <typename OnField>
+inline bool readJSONObject(std::string_view json, OnField&& onField) {
+  JSONReader reader(json);
+  return reader.readObject(onField) && reader.atEnd();
+}
+
+} // namespace margelo::nitro::NitroAuth
@@ -0,0 +1,203 @@
+#include "JSONSerializer.hpp"
+#include "JSONReader.hpp"
+#include <charconv>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <initializer_list>
+#include <vector>
+
+namespace margelo::nitro::NitroAuth {
+
+namespace {
+
+// Callers only pass finite values; JSON has no representation for NaN or infinity.
+void appendNumber(std::string& out, double value) {
+  char buffer[32];
+  // Epoch milliseconds are integral; print them exactly without going through printf.
+  if (value == std::trunc(value) && std::fabs(value) < 9007199254740992.0) {
+    auto result = std::to_chars(buffer, buffer + sizeof(buffer), static_cast<int64_t>(value));
+    out.append(buffer, static_cast<size_t>(result.ptr - buffer));
+    return;
+  }
+  const int length = std::snprintf(buffer, sizeof(buffer), "%.17g", value);
+  out.append(buffer, static_cast<size_t>(length));
+}
+
+const char* providerName(AuthProvider provider) {
+  switch (provider) {
+    case AuthProvider::GOOGLE: return "google";
+    case AuthProvider::APPLE: return "apple";
+    case AuthProvider::MICROSOFT: return "microsoft";
+    case AuthProvider::OIDC: return "oidc";
+  }
+  return "google";
+}
+
+std::optional<AuthProvider> providerFromName(std::string_view name) {
+  if (name == "google") return AuthProvider::GOOGLE;
+  if (name == "apple") return AuthProvider::APPLE;
+  if (name == "microsoft") return AuthProvider::MICROSOFT;
+  if (name == "oidc") return AuthProvider::OIDC;
+  return std::nullopt;
+}
+
+class ObjectWriter {
+public:
+  explicit ObjectWriter(std::string& out) : _out(out) { _out.push_back('{'); }
+
+  void field(std::string_view key, std::string_view value) {
+    appendKey(key);
+    appendJSONString(_out, value);
+  }
+
+  void field(std::string_view key, const std::optional<std::string>& value) {
+    if (value) field(key, std::string_view(*value));
+  }
+
+  void field(std::string_view key, const std::optional<double>& value) {
+    if (!value || !std::isfinite(*value)) return;
+    appendKey(key);
+    appendNumber(_out, *value);
+  }
+
+  void field(std::string_view key, const std::optional<std::vector<std::string>>& values) {
+    if (!values) return;
+    appendKey(key);
+    _out.push_back('[');
+    for (size_t i = 0; i < values->size(); ++i) {
+      if (i > 0) _out.push_back(',');
+      appendJSONString(_out, (*values)[i]);
+    }
+    _out.push_back(']');
+  }
+
+  void finish() { _out.push_back('}'); }
+
+private:
+  // Keys are fixed ASCII identifiers and never need escaping.
+  void appendKey(std::string_view key) {
+    if (!_first) _out.push_back(',');
+    _first = false;
+    _out.push_back('"');
+    _out.append(key);
+    _out.append("\":");
+  }
+
+  std::string& _out;
+  bool _first = true;
+};
+
+// Upper-bound-ish output size so serialize() allocates once for typical payloads.
+size_t estimateSize(std::initializer_list<const std::optional<std::string>*> fields) {
+  size_t size = 64;
+  for (const auto* field : fields) {
+    if (*field) size += (*field)->size() + 24;
+  }
+  return size;
+}
+
+bool readTokenField(std::string_view key, JSONReader& reader, AuthTokens& tokens) {
+  if (key == "accessToken") return readOptionalString(reader, tokens.accessToken);
+  if (key == "idToken") return readOptionalString(reader, tokens.idToken);
+  if (key == "refreshToken") return readOptionalString(reader, tokens.refreshToken);
+  if (key == "expirationTime") return readOptionalNumber(reader, tokens.expirationTime);
+  return reader.skipValue();
+}
+
+} // namespace
+
+void JSONSerializer::serialize(const AuthUser& user, std::string& out) {
+  ObjectWriter writer(out);
+  writer.field("provider", std::string_view(providerName(user.provider)));
+  writer.field("email", user.email);
+  writer.field("name", user.name);
+  writer.field("photo", user.photo);
+  writer.field("idToken", user.idToken);
+  writer.field("accessToken", user.accessToken);
+  writer.field("refreshToken", user.refreshToken);
+  writer.field("serverAuthCode", user.serverAuthCode);
+  writer.field("authorizationCode", user.authorizationCode);
+  writer.field("userId", user.userId);
+  writer.field("phoneNumber", user.phoneNumber);
+  writer.field("hostedDomain", user.hostedDomain);
+  writer.field("scopes", user.scopes);
+  writer.field("expirationTime", user.expirationTime);
+  writer.field("underlyingError", user.underlyingError);
+  writer.finish();
+}
+
+void JSONSerializer::serialize(const AuthTokens& tokens, std::string& out) {
+  ObjectWriter writer(out);
+  writer.field("accessToken", tokens.accessToken);
+  writer.field("idToken", tokens.idToken);
+  writer.field("refreshToken", tokens.refreshToken);
+  writer.field("expirationTime", tokens.expirationTime);
+  writer.finish();
+}
+
+std::string JSONSerializer::serialize(const AuthUser& user) {
+  size_t size = estimateSize({&user.email, &user.name, &user.photo, &user.idToken, &user.accessToken,
+                              &user.refreshToken, &user.serverAuthCode, &user.authorizationCode, &user.userId,
+                              &user.phoneNumber, &user.hostedDomain, &user.underlyingError});
+  if (user.scopes) {
+    for (const auto& scope : *user.scopes) size += scope.size() + 3;
+  }
+  std::string out;
+  out.reserve(size);
+  serialize(user, out);
+  return out;
+}
+
+std::string JSONSerializer::serialize(const AuthTokens& tokens) {
+  std::string out;
+  out.reserve(estimateSize({&tokens.accessToken, &tokens.idToken, &tokens.refreshToken}));
+  serialize(tokens, out);
+  return out;
+}
+
+std::optional<AuthUser> JSONSerializer::deserialize(std::string_view json) {
+  AuthUser user;
+  // Users stored before `provider` was written decode as Apple, as they always did.
+  user.provider = AuthProvider::APPLE;
+  std::string providerValue;
+  const bool ok = readJSONObject(json, [&](std::string_view key, JSONReader& reader) {
+    if (key == "provider") {
+      if (!reader.readString(providerValue)) return false;
+      auto provider = providerFromName(providerValue);
+      if (!provider) return false;
+      user.provider = *provider;
+      return true;
+    }
+    if (key == "email") return readOptionalString(reader, user.email);
+    if (key == "name") return readOptionalString(reader, user.name);
+    if (key == "photo") return readOptionalString(reader, user.photo);
+    if (key == "idToken") return readOptionalString(reader, user.idToken);
+    if (key == "accessToken") return readOptionalString(reader, user.accessToken);
+    if (key == "refreshToken") return readOptionalString(reader, user.refreshToken);
+    if (key == "serverAuthCode") return readOptionalString(reader, user.serverAuthCode);
+    if (key == "authorizationCode") return readOptionalString(reader, user.authorizationCode);
+    if (key == "userId") return readOptionalString(reader, user.userId);
+    if (key == "phoneNumber") return readOptionalString(reader, user.phoneNumber);
+    if (key == "hostedDomain") return readOptionalString(reader, user.hostedDomain);
+    if (key == "scopes") return readOptionalStrings(reader, user.scopes);
+    if (key == "expirationTime") return readOptionalNumber(reader, user.expirationTime);
+    if (key == "underlyingError") return readOptionalString(reader, user.underlyingError);
+    return reader.skipValue();
+  });
+  if (!ok) {
+    return std::nullopt;
+  }
+  return user;
+}
+
+std::optional<AuthTokens> JSONSerializer::deserializeTokens(std::string_view json) {
+  AuthTokens tokens;
+  const bool ok = readJSONObject(json, [&](std::string_view key, JSONReader& reader) { return readTokenField(key, reader, tokens); });
+  if (!ok) {
+    return std::nullopt;
+  }
+  return tokens;
+}
+
+} // namespace margelo::nitro::NitroAuth
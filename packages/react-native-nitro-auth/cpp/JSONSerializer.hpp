@@ -1,62 +1,31 @@
-// ⚠️ TEST-ONLY: This serializer is used exclusively by unit tests.
-// It does NOT escape strings and does NOT handle all providers.
-// Do NOT use in production code — platform-native JSON APIs are used instead.
 #pragma once
 
 #include "AuthUser.hpp"
-#include <string>
+#include "AuthTokens.hpp"
 #include <optional>
-#include <vector>
+#include <string>
+#include <string_view>
 
 namespace margelo::nitro::NitroAuth {
 
+// Streaming JSON codec for AuthUser / AuthTokens.
+//
+// Writing escapes quotes, backslashes and control characters and passes UTF-8
+// through unchanged; unset fields are omitted. Reading is a single pass straight
+// into the target struct: \u escapes (including surrogate pairs) are decoded to
+// UTF-8, unknown keys are skipped, and any malformed or mistyped input yields
+// std::nullopt. String scanning uses SSE2/NEON where available.
 class JSONSerializer {
 public:
-    static std::string serialize(const AuthUser& user) {
-        std::string json = "{";
-        json += "\"provider\":\"" + (user.provider == AuthProvider::GOOGLE ? std::string("google") : std::string("apple")) + "\",";
-        if (user.email) json += "\"email\":\"" + *user.email + "\",";
-        if (user.name) json += "\"name\":\"" + *user.name + "\",";
-        if (user.photo) json += "\"photo\":\"" + *user.photo + "\",";
-        if (user.idToken) json += "\"idToken\":\"" + *user.idToken + "\",";
-        if (user.serverAuthCode) json += "\"serverAuthCode\":\"" + *user.serverAuthCode + "\",";
-        if (user.scopes) {
-            json += "\"scopes\":[";
-            for (size_t i = 0; i < user.scopes->size(); ++i) {
-                json += "\"" + (*user.scopes)[i] + "\"";
-                if (i < user.scopes->size() - 1) json += ",";
-            }
-            json += "],";
-        }
-        if (json.back() == ',') json.pop_back();
-        json += "}";
-        return json;
-    }
-
-    static std::optional<AuthUser> deserialize(const std::string& json) {
-        if (json.find("{") == std::string::npos) return std::nullopt;
-        
-        AuthUser user;
-        user.provider = (json.find("\"provider\":\"google\"") != std::string::npos) ? AuthProvider::GOOGLE : AuthProvider::APPLE;
-        
-        auto extract = [&](const std::string& key) -> std::optional<std::string> {
-            std::string searchKey = "\"" + key + "\":\"";
-            size_t start = json.find(searchKey);
-            if (start == std::string::npos) return std::nullopt;
-            start += searchKey.length();
-            size_t end = json.find("\"", start);
-            if (end == std::string::npos) return std::nullopt;
-            return json.substr(start, end - start);
-        };
+  static std::string serialize(const AuthUser& user);
+  static std::string serialize(const AuthTokens& tokens);
+  // Append variants let callers reuse one output buffer.
+  static void serialize(const AuthUser& user, std::string& out);
+  static void serialize(const AuthTokens& tokens, std::string& out);
 
-        user.email = extract("email");
-        user.name = extract("name");
-        user.photo = extract("photo");
-        user.idToken = extract("idToken");
-        user.serverAuthCode = extract("serverAuthCode");
-        
-        return user;
-    }
+  // A missing `provider` decodes as APPLE; a present one must be a known value.
+  static std::optional<AuthUser> deserialize(std::string_view json);
+  static std::optional<AuthTokens> deserializeTokens(std::string_view json);
 };
 
 } // namespace margelo::nitro::NitroAuth
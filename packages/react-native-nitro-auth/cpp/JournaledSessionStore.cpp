@@ -0,0 +1,357 @@
+#include "JournaledSessionStore.hpp"
+#include "JSONSerializer.hpp"
+#include <array>
+#include <cerrno>
+#include <cstring>
+#include <stdexcept>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace margelo::nitro::NitroAuth {
+
+namespace {
+
+constexpr char kJournalMagic[4] = {'N', 'A', 'J', '1'};
+constexpr char kSnapshotMagic[4] = {'N', 'A', 'S', '1'};
+// payload size (4) + crc (4) + type (1) + sequence (8)
+constexpr size_t kRecordHeaderSize = 17;
+constexpr uint32_t kMaxPayloadSize = 1 << 20;
+
+enum class RecordType : uint8_t {
+  USER = 1,
+  SIGNED_OUT = 2,
+  TOKENS = 3,
+};
+
+uint32_t crc32(const char* data, size_t size) {
+  static const auto table = []() {
+    std::array<uint32_t, 256> values{};
+    for (uint32_t i = 0; i < 256; ++i) {
+      uint32_t crc = i;
+      for (int bit = 0; bit < 8; ++bit) crc = (crc >> 1) ^ (0xEDB88320u & (0u - (crc & 1u)));
+      values[i] = crc;
+    }
+    return values;
+  }();
+  uint32_t crc = 0xFFFFFFFFu;
+  for (size_t i = 0; i < size; ++i) {
+    crc = table[(crc ^ static_cast<uint8_t>(data[i])) & 0xFFu] ^ (crc >> 8);
+  }
+  return crc ^ 0xFFFFFFFFu;
+}
+
+void appendLittleEndian(std::string& out, uint64_t value, int bytes) {
+  for (int i = 0; i < bytes; ++i) out.push_back(static_cast<char>((value >> (8 * i)) & 0xFFu));
+}
+
+uint64_t readLittleEndian(const char* data, int bytes) {
+  uint64_t value = 0;
+  for (int i = 0; i < bytes; ++i) value |= static_cast<uint64_t>(static_cast<uint8_t>(data[i])) << (8 * i);
+  return value;
+}
+
+void encodeRecord(std::string& out, RecordType type, uint64_t sequence, const std::string& payload) {
+  const size_t start = out.size();
+  appendLittleEndian(out, payload.size(), 4);
+  appendLittleEndian(out, 0, 4); // CRC placeholder.
+  out.push_back(static_cast<char>(type));
+  appendLittleEndian(out, sequence, 8);
+  out.append(payload);
+  const uint32_t crc = crc32(out.data() + start + 8, out.size() - start - 8);
+  for (int i = 0; i < 4; ++i) out[start + 4 + i] = static_cast<char>((crc >> (8 * i)) & 0xFFu);
+}
+
+struct DecodedRecord {
+  RecordType type;
+  uint64_t sequence;
+  std::string_view payload;
+  size_t size;
+};
+
+// Returns std::nullopt for a torn (short) or corrupt record.
+std::optional<DecodedRecord> decodeRecord(std::string_view data) {
+  if (data.size() < kRecordHeaderSize) return std::nullopt;
+  const auto payloadSize = static_cast<uint32_t>(readLittleEndian(data.data(), 4));
+  if (payloadSize > kMaxPayloadSize || data.size() - kRecordHeaderSize < payloadSize) return std::nullopt;
+  const auto crc = static_cast<uint32_t>(readLittleEndian(data.data() + 4, 4));
+  if (crc32(data.data() + 8, kRecordHeaderSize - 8 + payloadSize) != crc) return std::nullopt;
+  const auto type = static_cast<RecordType>(data[8]);
+  if (type != RecordType::USER && type != RecordType::SIGNED_OUT && type != RecordType::TOKENS) return std::nullopt;
+  return DecodedRecord{type, readLittleEndian(data.data() + 9, 8), data.substr(kRecordHeaderSize, payloadSize),
+                       kRecordHeaderSize + payloadSize};
+}
+
+// Applies a decoded record to `session`; false if the payload does not parse.
+bool applyRecord(const DecodedRecord& record, std::optional<AuthUser>& session) {
+  switch (record.type) {
+    case RecordType::USER: {
+      auto user = JSONSerializer::deserialize(record.payload);
+      if (!user) return false;
+      session = std::move(user);
+      return true;
+    }
+    case RecordType::SIGNED_OUT:
+      session = std::nullopt;
+      return true;
+    case RecordType::TOKENS: {
+      auto tokens = JSONSerializer::deserializeTokens(record.payload);
+      if (!tokens) return false;
+      if (session) mergeTokens(*session, *tokens);
+      return true;
+    }
+  }
+  return false;
+}
+
+bool writeAll(int fd, const std::string& data) {
+  size_t written = 0;
+  while (written < data.size()) {
+    const ssize_t result = ::write(fd, data.data() + written, data.size() - written);
+    if (result < 0) {
+      if (errno == EINTR) continue;
+      return false;
+    }
+    written += static_cast<size_t>(result);
+  }
+  return true;
+}
+
+bool syncFile(int fd) {
+#if defined(__APPLE__)
+  return ::fsync(fd) == 0;
+#else
+  return ::fdatasync(fd) == 0;
+#endif
+}
+
+std::optional<std::string> readFile(const std::string& path) {
+  const int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+  if (fd < 0) return std::nullopt;
+  std::string contents;
+  char buffer[16 * 1024];
+  while (true) {
+    const ssize_t result = ::read(fd, buffer, sizeof(buffer));
+    if (result < 0 && errno == EINTR) continue;
+    if (result <= 0) break;
+    contents.append(buffer, static_cast<size_t>(result));
+  }
+  ::close(fd);
+  return contents;
+}
+
+bool syncDirectory(const std::string& directory) {
+  const int fd = ::open(directory.c_str(), O_RDONLY | O_CLOEXEC);
+  if (fd < 0) return false;
+  const bool ok = ::fsync(fd) == 0;
+  ::close(fd);
+  return ok;
+}
+
+} // namespace
+
+std::shared_ptr<JournaledSessionStore> JournaledSessionStore::open(const JournalOptions& options) {
+  return std::make_shared<JournaledSessionStore>(options);
+}
+
+JournaledSessionStore::JournaledSessionStore(const JournalOptions& options)
+  : _options(options),
+    _snapshotPath(options.directory + "/session.snapshot"),
+    _journalPath(options.directory + "/session.journal") {
+  recover();
+  _thread = std::thread([this]() { run(); });
+}
+
+JournaledSessionStore::~JournaledSessionStore() {
+  {
+    std::lock_guard<std::mutex> lock(_mutex);
+    _stopping = true;
+  }
+  _workAvailable.notify_all();
+  if (_thread.joinable()) _thread.join();
+  if (_journalFd >= 0) ::close(_journalFd);
+}
+
+void JournaledSessionStore::recover() {
+  if (::mkdir(_options.directory.c_str(), 0700) != 0 && errno != EEXIST) {
+    throw std::runtime_error("storage_error");
+  }
+
+  if (auto snapshot = readFile(_snapshotPath)) {
+    std::string_view data(*snapshot);
+    if (data.size() > sizeof(kSnapshotMagic) && std::memcmp(data.data(), kSnapshotMagic, sizeof(kSnapshotMagic)) == 0) {
+      auto record = decodeRecord(data.substr(sizeof(kSnapshotMagic)));
+      std::optional<AuthUser> session;
+      if (record && applyRecord(*record, session)) {
+        _session = std::move(session);
+        _sequence = record->sequence;
+      }
+    }
+  }
+
+  _journalFd = ::open(_journalPath.c_str(), O_RDWR | O_CREAT | O_APPEND | O_CLOEXEC, 0600);
+  if (_journalFd < 0) {
+    throw std::runtime_error("storage_error");
+  }
+  const std::string journal = readFile(_journalPath).value_or("");
+  std::string_view data(journal);
+  size_t validEnd = 0;
+  if (data.size() >= sizeof(kJournalMagic) && std::memcmp(data.data(), kJournalMagic, sizeof(kJournalMagic)) == 0) {
+    validEnd = sizeof(kJournalMagic);
+    while (auto record = decodeRecord(data.substr(validEnd))) {
+      std::optional<AuthUser> session = _session;
+      if (record->sequence > _sequence) {
+        if (!applyRecord(*record, session)) break;
+        _session = std::move(session);
+        _sequence = record->sequence;
+        _stats.recoveredRecords++;
+      }
+      validEnd += record->size;
+      _journalRecords++;
+    }
+  }
+
+  if (validEnd < data.size() || validEnd == 0) {
+    _stats.discardedTailBytes = data.size() - validEnd;
+    bool ok = ::ftruncate(_journalFd, static_cast<off_t>(validEnd)) == 0;
+    if (ok && validEnd == 0) {
+      ok = writeAll(_journalFd, std::string(kJournalMagic, sizeof(kJournalMagic)));
+      validEnd = sizeof(kJournalMagic);
+    }
+    if (!ok || !syncFile(_journalFd)) {
+      throw std::runtime_error("storage_error");
+    }
+  }
+  _journalBytes = validEnd;
+  _flushedSequence = _sequence;
+}
+
+void JournaledSessionStore::saveUser(const std::optional<AuthUser>& user) {
+  {
+    std::lock_guard<std::mutex> lock(_mutex);
+    _session = user;
+    _pending.push_back(Record{++_sequence, user});
+  }
+  _workAvailable.notify_one();
+}
+
+void JournaledSessionStore::saveTokens(const AuthTokens& tokens) {
+  {
+    std::lock_guard<std::mutex> lock(_mutex);
+    if (!_session) return;
+    mergeTokens(*_session, tokens);
+    _pending.push_back(Record{++_sequence, tokens});
+  }
+  _workAvailable.notify_one();
+}
+
+std::optional<AuthUser> JournaledSessionStore::load() {
+  std::lock_guard<std::mutex> lock(_mutex);
+  return _session;
+}
+
+void JournaledSessionStore::flush() {
+  std::unique_lock<std::mutex> lock(_mutex);
+  const uint64_t target = _sequence;
+  _durable.wait(lock, [&]() { return _flushedSequence >= target; });
+}
+
+JournalStats JournaledSessionStore::stats() const {
+  std::lock_guard<std::mutex> lock(_mutex);
+  return _stats;
+}
+
+void JournaledSessionStore::run() {
+  std::unique_lock<std::mutex> lock(_mutex);
+  while (true) {
+    _workAvailable.wait(lock, [&]() { return _stopping || !_pending.empty(); });
+    if (_pending.empty()) break;
+    auto batch = std::move(_pending);
+    _pending.clear();
+    lock.unlock();
+
+    const bool appended = appendBatch(batch);
+    // A failed append was rolled back; a snapshot still captures the state it carried.
+    const bool needsCompaction = !appended || _journalRecords >= _options.compactAfterRecords ||
+                                 _journalBytes >= _options.compactAfterBytes;
+    const bool compacted = needsCompaction && compact();
+
+    lock.lock();
+    if (appended) {
+      _stats.appendedRecords += batch.size();
+      _stats.appendedBatches++;
+    } else {
+      _stats.writeErrors++;
+    }
+    if (compacted) {
+      _stats.compactions++;
+    } else if (needsCompaction && !appended) {
+      _stats.writeErrors++;
+    }
+    _flushedSequence = batch.back().sequence;
+    _durable.notify_all();
+  }
+}
+
+bool JournaledSessionStore::appendBatch(const std::vector<Record>& batch) {
+  std::string buffer;
+  for (const auto& record : batch) {
+    if (const auto* user = std::get_if<std::optional<AuthUser>>(&record.change)) {
+      if (*user) {
+        encodeRecord(buffer, RecordType::USER, record.sequence, JSONSerializer::serialize(**user));
+      } else {
+        encodeRecord(buffer, RecordType::SIGNED_OUT, record.sequence, std::string());
+      }
+    } else {
+      encodeRecord(buffer, RecordType::TOKENS, record.sequence,
+                   JSONSerializer::serialize(std::get<AuthTokens>(record.change)));
+    }
+  }
+  if (!writeAll(_journalFd, buffer) || (_options.syncWrites && !syncFile(_journalFd))) {
+    // Drop any partial write so later appends stay reachable during recovery.
+    (void)::ftruncate(_journalFd, static_cast<off_t>(_journalBytes));
+    return false;
+  }
+  _journalBytes += buffer.size();
+  _journalRecords += static_cast<uint32_t>(batch.size());
+  return true;
+}
+
+bool JournaledSessionStore::compact() {
+  std::optional<AuthUser> session;
+  uint64_t sequence;
+  {
+    // Queued records with a sequence <= this one are skipped on replay.
+    std::lock_guard<std::mutex> lock(_mutex);
+    session = _session;
+    sequence = _sequence;
+  }
+
+  std::string snapshot(kSnapshotMagic, sizeof(kSnapshotMagic));
+  if (session) {
+    encodeRecord(snapshot, RecordType::USER, sequence, JSONSerializer::serialize(*session));
+  } else {
+    encodeRecord(snapshot, RecordType::SIGNED_OUT, sequence, std::string());
+  }
+
+  const std::string temporaryPath = _snapshotPath + ".tmp";
+  const int fd = ::open(temporaryPath.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0600);
+  if (fd < 0) return false;
+  const bool written = writeAll(fd, snapshot) && ::fsync(fd) == 0;
+  ::close(fd);
+  if (!written || ::rename(temporaryPath.c_str(), _snapshotPath.c_str()) != 0) {
+    ::unlink(temporaryPath.c_str());
+    return false;
+  }
+  syncDirectory(_options.directory);
+
+  // A crash before this truncate leaves only records the snapshot already covers.
+  if (::ftruncate(_journalFd, static_cast<off_t>(sizeof(kJournalMagic))) != 0 || !syncFile(_journalFd)) {
+    return false;
+  }
+  _journalBytes = sizeof(kJournalMagic);
+  _journalRecords = 0;
+  return true;
+}
+
+} // namespace margelo::nitro::NitroAuth
@@ -0,0 +1,99 @@
+#pragma once
+
+#include "SessionStore.hpp"
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <thread>
+#include <variant>
+#include <vector>
+
+namespace margelo::nitro::NitroAuth {
+
+struct JournalOptions {
+  // Directory holding `session.snapshot` and `session.journal`; created if missing.
+  std::string directory;
+  // The journal is folded into a fresh snapshot once it exceeds either bound.
+  uint32_t compactAfterRecords = 256;
+  uint64_t compactAfterBytes = 64 * 1024;
+  // fdatasync after every batch; only disable for throwaway stores.
+  bool syncWrites = true;
+};
+
+struct JournalStats {
+  uint64_t appendedRecords = 0;
+  uint64_t appendedBatches = 0;
+  uint64_t compactions = 0;
+  uint64_t recoveredRecords = 0;
+  // Bytes dropped from a torn or corrupt journal tail during recovery.
+  uint64_t discardedTailBytes = 0;
+  uint64_t writeErrors = 0;
+};
+
+// File-backed SessionStore with a write-behind journal.
+//
+// saveUser/saveTokens update the in-memory session and queue a record; a
+// background thread appends queued records to an append-only journal in one
+// write + fdatasync per batch. Every record carries a sequence number and a
+// CRC. Compaction writes the current session to a snapshot via
+// write-to-temp + rename, then truncates the journal. Recovery loads the
+// snapshot, replays journal records newer than it and cuts off the first torn
+// or corrupt record, so a crash at any point loses at most the batch in flight.
+class JournaledSessionStore final : public SessionStore {
+public:
+  // Recovers synchronously; throws std::runtime_error("storage_error") if the
+  // directory or journal cannot be opened.
+  static std::shared_ptr<JournaledSessionStore> open(const JournalOptions& options);
+
+  explicit JournaledSessionStore(const JournalOptions& options);
+  ~JournaledSessionStore() override;
+
+  JournaledSessionStore(const JournaledSessionStore&) = delete;
+  JournaledSessionStore& operator=(const JournaledSessionStore&) = delete;
+
+  void saveUser(const std::optional<AuthUser>& user) override;
+  void saveTokens(const AuthTokens& tokens) override;
+  std::optional<AuthUser> load() override;
+  void flush() override;
+
+  JournalStats stats() const;
+
+private:
+  struct Record {
+    uint64_t sequence;
+    std::variant<std::optional<AuthUser>, AuthTokens> change;
+  };
+
+  void recover();
+  void run();
+  bool appendBatch(const std::vector<Record>& batch);
+  bool compact();
+
+private:
+  const JournalOptions _options;
+  const std::string _snapshotPath;
+  const std::string _journalPath;
+  int _journalFd = -1;
+
+  mutable std::mutex _mutex;
+  std::condition_variable _workAvailable;
+  std::condition_variable _durable;
+  std::optional<AuthUser> _session;
+  uint64_t _sequence = 0;
+  // Highest sequence the writer has finished with (written, or counted in writeErrors).
+  uint64_t _flushedSequence = 0;
+  std::vector<Record> _pending;
+  bool _stopping = false;
+  JournalStats _stats;
+
+  // Touched only by the writer thread after construction.
+  uint64_t _journalBytes = 0;
+  uint32_t _journalRecords = 0;
+
+  std::thread _thread;
+};
+
+} // namespace margelo::nitro::NitroAuth
@@ -0,0 +1,570 @@
+#include "JwsCrypto.hpp"
+#include <algorithm>
+#include <cstring>
+#include <type_traits>
+#include <vector>
+
+namespace margelo::nitro::NitroAuth {
+
+namespace {
+
+// ---- SHA-256 (FIPS 180-4) ----
+
+constexpr uint32_t kSha256Rounds[64] = {
+  0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,
+  0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3, 0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174,
+  0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc, 0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+  0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7, 0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967,
+  0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13, 0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85,
+  0xa2bfe8a1, 0xa81a664b, 0xc24b8b70, 0xc76c51a3, 0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+  0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
+  0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208, 0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2,
+};
+
+inline uint32_t rotateRight(uint32_t value, int bits) {
+  return (value >> bits) | (value << (32 - bits));
+}
+
+void sha256Block(uint32_t state[8], const uint8_t* block) {
+  uint32_t w[64];
+  for (int i = 0; i < 16; ++i) {
+    w[i] = (uint32_t(block[i * 4]) << 24) | (uint32_t(block[i * 4 + 1]) << 16) | (uint32_t(block[i * 4 + 2]) << 8) |
+           uint32_t(block[i * 4 + 3]);
+  }
+  for (int i = 16; i < 64; ++i) {
+    const uint32_t s0 = rotateRight(w[i - 15], 7) ^ rotateRight(w[i - 15], 18) ^ (w[i - 15] >> 3);
+    const uint32_t s1 = rotateRight(w[i - 2], 17) ^ rotateRight(w[i - 2], 19) ^ (w[i - 2] >> 10);
+    w[i] = w[i - 16] + s0 + w[i - 7] + s1;
+  }
+
+  uint32_t a = state[0], b = state[1], c = state[2], d = state[3];
+  uint32_t e = state[4], f = state[5], g = state[6], h = state[7];
+  for (int i = 0; i < 64; ++i) {
+    const uint32_t s1 = rotateRight(e, 6) ^ rotateRight(e, 11) ^ rotateRight(e, 25);
+    const uint32_t choose = (e & f) ^ (~e & g);
+    const uint32_t t1 = h + s1 + choose + kSha256Rounds[i] + w[i];
+    const uint32_t s0 = rotateRight(a, 2) ^ rotateRight(a, 13) ^ rotateRight(a, 22);
+    const uint32_t majority = (a & b) ^ (a & c) ^ (b & c);
+    const uint32_t t2 = s0 + majority;
+    h = g;
+    g = f;
+    f = e;
+    e = d + t1;
+    d = c;
+    c = b;
+    b = a;
+    a = t1 + t2;
+  }
+  state[0] += a;
+  state[1] += b;
+  state[2] += c;
+  state[3] += d;
+  state[4] += e;
+  state[5] += f;
+  state[6] += g;
+  state[7] += h;
+}
+
+// ---- Multi-precision arithmetic: little-endian 32-bit limbs ----
+
+using Limb = uint32_t;
+using Wide = uint64_t;
+
+constexpr size_t kMaxLimbs = 4096 / 32;
+
+bool loadBigEndian(std::string_view bytes, Limb* out, size_t limbs) {
+  std::fill(out, out + limbs, 0);
+  for (size_t index = 0; index < bytes.size(); ++index) {
+    const auto byte = static_cast<uint8_t>(bytes[bytes.size() - 1 - index]);
+    if (index / 4 >= limbs) {
+      if (byte != 0) return false;
+      continue;
+    }
+    out[index / 4] |= Limb(byte) << (8 * (index % 4));
+  }
+  return true;
+}
+
+void storeBigEndian(const Limb* limbs, size_t count, uint8_t* out, size_t size) {
+  for (size_t index = 0; index < size; ++index) {
+    const size_t limb = index / 4;
+    out[size - 1 - index] = limb < count ? static_cast<uint8_t>(limbs[limb] >> (8 * (index % 4))) : 0;
+  }
+}
+
+int compare(const Limb* a, const Limb* b, size_t n) {
+  for (size_t i = n; i-- > 0;) {
+    if (a[i] != b[i]) return a[i] < b[i] ? -1 : 1;
+  }
+  return 0;
+}
+
+bool isZero(const Limb* a, size_t n) {
+  for (size_t i = 0; i < n; ++i) {
+    if (a[i] != 0) return false;
+  }
+  return true;
+}
+
+Limb addInPlace(Limb* a, const Limb* b, size_t n) {
+  Wide carry = 0;
+  for (size_t i = 0; i < n; ++i) {
+    const Wide sum = Wide(a[i]) + b[i] + carry;
+    a[i] = Limb(sum);
+    carry = sum >> 32;
+  }
+  return Limb(carry);
+}
+
+Limb subtractInPlace(Limb* a, const Limb* b, size_t n) {
+  Limb borrow = 0;
+  for (size_t i = 0; i < n; ++i) {
+    const Wide difference = Wide(a[i]) - b[i] - borrow;
+    a[i] = Limb(difference);
+    borrow = Limb(difference >> 63);
+  }
+  return borrow;
+}
+
+bool testBit(const Limb* a, size_t bit) {
+  return (a[bit / 32] >> (bit % 32)) & 1;
+}
+
+size_t bitLength(const Limb* a, size_t n) {
+  for (size_t i = n; i-- > 0;) {
+    if (a[i] != 0) return i * 32 + (32 - static_cast<size_t>(__builtin_clz(a[i])));
+  }
+  return 0;
+}
+
+// CIOS Montgomery product a * b * 2^(-32n) mod m for inputs < m. `Size` is
+// either size_t or an integral_constant, which lets the compiler unroll the
+// fixed 8-limb P-256 case.
+template <typename Size>
+void montgomeryMultiply(Limb* out, const Limb* a, const Limb* b, const Limb* m, Limb m0inv, Size n) {
+  Limb t[kMaxLimbs + 2];
+  std::fill(t, t + n + 2, 0);
+  for (size_t i = 0; i < n; ++i) {
+    Wide carry = 0;
+    for (size_t j = 0; j < n; ++j) {
+      const Wide sum = Wide(t[j]) + Wide(a[j]) * b[i] + carry;
+      t[j] = Limb(sum);
+      carry = sum >> 32;
+    }
+    Wide sum = Wide(t[n]) + carry;
+    t[n] = Limb(sum);
+    t[n + 1] = Limb(sum >> 32);
+
+    const Limb u = t[0] * m0inv;
+    carry = (Wide(t[0]) + Wide(u) * m[0]) >> 32;
+    for (size_t j = 1; j < n; ++j) {
+      sum = Wide(t[j]) + Wide(u) * m[j] + carry;
+      t[j - 1] = Limb(sum);
+      carry = sum >> 32;
+    }
+    sum = Wide(t[n]) + carry;
+    t[n - 1] = Limb(sum);
+    t[n] = t[n + 1] + Limb(sum >> 32);
+    t[n + 1] = 0;
+  }
+  if (t[n] != 0 || compare(t, m, n) >= 0) subtractInPlace(t, m, n);
+  std::copy(t, t + n, out);
+}
+
+using P256Size = std::integral_constant<size_t, 8>;
+
+// Arithmetic modulo an odd modulus of up to kMaxLimbs limbs, in Montgomery form (R = 2^(32 * limbs)).
+class Montgomery {
+public:
+  Montgomery(const Limb* modulus, size_t limbs)
+      : _modulus(modulus, modulus + limbs), _limbs(limbs), _r2(limbs), _one(limbs) {
+    // -m^-1 mod 2^32 by Newton iteration; m * m == 1 mod 8 seeds three correct bits.
+    Limb inverse = modulus[0];
+    for (int i = 0; i < 4; ++i) inverse *= 2 - modulus[0] * inverse;
+    _m0inv = 0u - inverse;
+
+    // R^2 mod m: double 2^(bits - 1) up to 2^(32n + n) = 2^n in Montgomery
+    // form, then five Montgomery squarings give 2^(32n) * R.
+    const size_t bits = bitLength(modulus, limbs);
+    _r2[(bits - 1) / 32] = Limb(1) << ((bits - 1) % 32);
+    for (size_t exponent = bits - 1; exponent < 33 * limbs; ++exponent) {
+      const Limb carry = addInPlace(_r2.data(), _r2.data(), limbs);
+      if (carry != 0 || compare(_r2.data(), _modulus.data(), limbs) >= 0) {
+        subtractInPlace(_r2.data(), _modulus.data(), limbs);
+      }
+    }
+    for (int i = 0; i < 5; ++i) multiply(_r2.data(), _r2.data(), _r2.data());
+    std::vector<Limb> one(limbs);
+    one[0] = 1;
+    toMontgomery(_one.data(), one.data());
+  }
+
+  size_t limbs() const { return _limbs; }
+  const Limb* modulus() const { return _modulus.data(); }
+  // R mod m, i.e. 1 in Montgomery form.
+  const Limb* one() const { return _one.data(); }
+
+  // out = a * b * R^-1 mod m. Inputs must be < m; out may alias either input.
+  void multiply(Limb* out, const Limb* a, const Limb* b) const {
+    if (_limbs == P256Size::value) {
+      montgomeryMultiply(out, a, b, _modulus.data(), _m0inv, P256Size{});
+    } else {
+      montgomeryMultiply(out, a, b, _modulus.data(), _m0inv, _limbs);
+    }
+  }
+
+  void toMontgomery(Limb* out, const Limb* a) const { multiply(out, a, _r2.data()); }
+
+  void fromMontgomery(Limb* out, const Limb* a) const {
+    std::vector<Limb> one(_limbs);
+    one[0] = 1;
+    multiply(out, a, one.data());
+  }
+
+  // out = base^exponent, with base and out in Montgomery form.
+  void power(Limb* out, const Limb* base, const Limb* exponent, size_t exponentLimbs) const {
+    Limb accumulator[kMaxLimbs];
+    std::copy(_one.begin(), _one.end(), accumulator);
+    for (size_t bit = bitLength(exponent, exponentLimbs); bit-- > 0;) {
+      multiply(accumulator, accumulator, accumulator);
+      if (testBit(exponent, bit)) multiply(accumulator, accumulator, base);
+    }
+    std::copy(accumulator, accumulator + _limbs, out);
+  }
+
+  void add(Limb* out, const Limb* a, const Limb* b) const {
+    Limb sum[kMaxLimbs];
+    std::copy(a, a + _limbs, sum);
+    const Limb carry = addInPlace(sum, b, _limbs);
+    if (carry != 0 || compare(sum, _modulus.data(), _limbs) >= 0) subtractInPlace(sum, _modulus.data(), _limbs);
+    std::copy(sum, sum + _limbs, out);
+  }
+
+  void subtract(Limb* out, const Limb* a, const Limb* b) const {
+    Limb difference[kMaxLimbs];
+    std::copy(a, a + _limbs, difference);
+    if (subtractInPlace(difference, b, _limbs) != 0) addInPlace(difference, _modulus.data(), _limbs);
+    std::copy(difference, difference + _limbs, out);
+  }
+
+private:
+  std::vector<Limb> _modulus;
+  size_t _limbs;
+  Limb _m0inv = 0;
+  std::vector<Limb> _r2;
+  std::vector<Limb> _one;
+};
+
+// ---- RSASSA-PKCS1-v1_5 ----
+
+// DER DigestInfo prefix for SHA-256 (RFC 8017 §9.2, note 1).
+constexpr uint8_t kSha256DigestInfo[] = {0x30, 0x31, 0x30, 0x0d, 0x06, 0x09, 0x60, 0x86, 0x48, 0x01,
+                                         0x65, 0x03, 0x04, 0x02, 0x01, 0x05, 0x00, 0x04, 0x20};
+
+std::string_view stripLeadingZeros(std::string_view value) {
+  while (!value.empty() && value.front() == '\0') value.remove_prefix(1);
+  return value;
+}
+
+// ---- P-256 (FIPS 186-4 D.1.2.3) ----
+
+constexpr size_t kP256Limbs = P256Size::value;
+using FieldElement = std::array<Limb, kP256Limbs>;
+
+FieldElement loadHex(const char* hex) {
+  FieldElement out{};
+  for (size_t i = 0; i < 64; ++i) {
+    const char c = hex[63 - i];
+    const Limb digit = c <= '9' ? Limb(c - '0') : Limb(c - 'a' + 10);
+    out[i / 8] |= digit << (4 * (i % 8));
+  }
+  return out;
+}
+
+struct JacobianPoint {
+  FieldElement x{};
+  FieldElement y{};
+  // Zero for the point at infinity.
+  FieldElement z{};
+};
+
+class P256 {
+public:
+  static const P256& instance() {
+    static const P256 curve;
+    return curve;
+  }
+
+  const Montgomery field;
+  const Montgomery order;
+  const FieldElement p;
+  const FieldElement n;
+  FieldElement b{};
+  JacobianPoint generator;
+
+  bool isInfinity(const JacobianPoint& point) const { return isZero(point.z.data(), kP256Limbs); }
+
+  FieldElement mul(const FieldElement& a, const FieldElement& b) const {
+    FieldElement out;
+    field.multiply(out.data(), a.data(), b.data());
+    return out;
+  }
+  FieldElement add(const FieldElement& a, const FieldElement& b) const {
+    FieldElement out;
+    field.add(out.data(), a.data(), b.data());
+    return out;
+  }
+  FieldElement sub(const FieldElement& a, const FieldElement& b) const {
+    FieldElement out;
+    field.subtract(out.data(), a.data(), b.data());
+    return out;
+  }
+
+  // dbl-2001-b (a = -3).
+  JacobianPoint doublePoint(const JacobianPoint& point) const {
+    if (isInfinity(point)) return point;
+    const FieldElement delta = mul(point.z, point.z);
+    const FieldElement gamma = mul(point.y, point.y);
+    const FieldElement beta = mul(point.x, gamma);
+    FieldElement alpha = mul(sub(point.x, delta), add(point.x, delta));
+    alpha = add(add(alpha, alpha), alpha);
+    const FieldElement beta4 = add(add(beta, beta), add(beta, beta));
+
+    JacobianPoint out;
+    out.x = sub(mul(alpha, alpha), add(beta4, beta4));
+    const FieldElement yz = add(point.y, point.z);
+    out.z = sub(sub(mul(yz, yz), gamma), delta);
+    const FieldElement gamma2 = mul(gamma, gamma);
+    const FieldElement gamma8 = add(add(add(gamma2, gamma2), add(gamma2, gamma2)), add(add(gamma2, gamma2), add(gamma2, gamma2)));
+    out.y = sub(mul(alpha, sub(beta4, out.x)), gamma8);
+    return out;
+  }
+
+  // add-2007-bl.
+  JacobianPoint addPoints(const JacobianPoint& a, const JacobianPoint& b) const {
+    if (isInfinity(a)) return b;
+    if (isInfinity(b)) return a;
+    const FieldElement z1z1 = mul(a.z, a.z);
+    const FieldElement z2z2 = mul(b.z, b.z);
+    const FieldElement u1 = mul(a.x, z2z2);
+    const FieldElement u2 = mul(b.x, z1z1);
+    const FieldElement s1 = mul(mul(a.y, b.z), z2z2);
+    const FieldElement s2 = mul(mul(b.y, a.z), z1z1);
+    const FieldElement h = sub(u2, u1);
+    FieldElement r = sub(s2, s1);
+    if (isZero(h.data(), kP256Limbs)) {
+      if (isZero(r.data(), kP256Limbs)) return doublePoint(a);
+      return JacobianPoint{};
+    }
+    r = add(r, r);
+    const FieldElement h2 = add(h, h);
+    const FieldElement i = mul(h2, h2);
+    const FieldElement j = mul(h, i);
+    const FieldElement v = mul(u1, i);
+
+    JacobianPoint out;
+    out.x = sub(sub(sub(mul(r, r), j), v), v);
+    const FieldElement s1j = mul(s1, j);
+    out.y = sub(mul(r, sub(v, out.x)), add(s1j, s1j));
+    const FieldElement z12 = add(a.z, b.z);
+    out.z = mul(sub(sub(mul(z12, z12), z1z1), z2z2), h);
+    return out;
+  }
+
+private:
+  P256()
+      : field(loadHex("ffffffff00000001000000000000000000000000ffffffffffffffffffffffff").data(), kP256Limbs),
+        order(loadHex("ffffffff00000000ffffffffffffffffbce6faada7179e84f3b9cac2fc632551").data(), kP256Limbs),
+        p(loadHex("ffffffff00000001000000000000000000000000ffffffffffffffffffffffff")),
+        n(loadHex("ffffffff00000000ffffffffffffffffbce6faada7179e84f3b9cac2fc632551")) {
+    const FieldElement rawB = loadHex("5ac635d8aa3a93e7b3ebbd55769886bc651d06b0cc53b0f63bce3c3e27d2604b");
+    const FieldElement gx = loadHex("6b17d1f2e12c4247f8bce6e563a440f277037d812deb33a0f4a13945d898c296");
+    const FieldElement gy = loadHex("4fe342e2fe1a7f9b8ee7eb4a7c0f9e162bce33576b315ececbb6406837bf51f5");
+    field.toMontgomery(b.data(), rawB.data());
+    field.toMontgomery(generator.x.data(), gx.data());
+    field.toMontgomery(generator.y.data(), gy.data());
+    std::copy(field.one(), field.one() + kP256Limbs, generator.z.begin());
+  }
+};
+
+} // namespace
+
+Sha256Digest JwsCrypto::sha256(std::string_view data) {
+  uint32_t state[8] = {0x6a09e667, 0xbb67ae85, 0x3c6ef372, 0xa54ff53a, 0x510e527f, 0x9b05688c, 0x1f83d9ab, 0x5be0cd19};
+  const auto* bytes = reinterpret_cast<const uint8_t*>(data.data());
+  size_t offset = 0;
+  for (; offset + 64 <= data.size(); offset += 64) sha256Block(state, bytes + offset);
+
+  uint8_t tail[128] = {};
+  const size_t remaining = data.size() - offset;
+  if (remaining > 0) std::memcpy(tail, bytes + offset, remaining);
+  tail[remaining] = 0x80;
+  const size_t tailSize = remaining < 56 ? 64 : 128;
+  const uint64_t bitCount = static_cast<uint64_t>(data.size()) * 8;
+  for (int i = 0; i < 8; ++i) tail[tailSize - 1 - i] = static_cast<uint8_t>(bitCount >> (8 * i));
+  sha256Block(state, tail);
+  if (tailSize == 128) sha256Block(state, tail + 64);
+
+  Sha256Digest digest;
+  for (int i = 0; i < 8; ++i) {
+    digest[i * 4] = static_cast<uint8_t>(state[i] >> 24);
+    digest[i * 4 + 1] = static_cast<uint8_t>(state[i] >> 16);
+    digest[i * 4 + 2] = static_cast<uint8_t>(state[i] >> 8);
+    digest[i * 4 + 3] = static_cast<uint8_t>(state[i]);
+  }
+  return digest;
+}
+
+std::optional<std::string> JwsCrypto::base64UrlDecode(std::string_view input) {
+  while (!input.empty() && input.back() == '=') input.remove_suffix(1);
+  if (input.size() % 4 == 1) return std::nullopt;
+
+  std::string out;
+  out.reserve(input.size() * 3 / 4);
+  uint32_t buffer = 0;
+  int bits = 0;
+  for (char c : input) {
+    uint32_t value;
+    if (c >= 'A' && c <= 'Z') value = static_cast<uint32_t>(c - 'A');
+    else if (c >= 'a' && c <= 'z') value = static_cast<uint32_t>(c - 'a' + 26);
+    else if (c >= '0' && c <= '9') value = static_cast<uint32_t>(c - '0' + 52);
+    else if (c == '-') value = 62;
+    else if (c == '_') value = 63;
+    else return std::nullopt;
+    buffer = (buffer << 6) | value;
+    bits += 6;
+    if (bits >= 8) {
+      bits -= 8;
+      out.push_back(static_cast<char>((buffer >> bits) & 0xFF));
+    }
+  }
+  return out;
+}
+
+std::string JwsCrypto::base64UrlEncode(std::string_view input) {
+  static constexpr char kAlphabet[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789-_";
+  std::string out;
+  out.reserve((input.size() * 4 + 2) / 3);
+  uint32_t buffer = 0;
+  int bits = 0;
+  for (char c : input) {
+    buffer = (buffer << 8) | static_cast<uint8_t>(c);
+    bits += 8;
+    while (bits >= 6) {
+      bits -= 6;
+      out.push_back(kAlphabet[(buffer >> bits) & 0x3F]);
+    }
+  }
+  if (bits > 0) out.push_back(kAlphabet[(buffer << (6 - bits)) & 0x3F]);
+  return out;
+}
+
+bool JwsCrypto::verifyRs256(std::string_view modulus, std::string_view exponent, const Sha256Digest& digest,
+                            std::string_view signature) {
+  modulus = stripLeadingZeros(modulus);
+  exponent = stripLeadingZeros(exponent);
+  const size_t size = modulus.size();
+  if (size < 256 || size > 512 || signature.size() != size) return false;
+  if ((static_cast<uint8_t>(modulus.back()) & 1) == 0) return false;
+  if (exponent.empty() || exponent.size() > 8 || (static_cast<uint8_t>(exponent.back()) & 1) == 0) return false;
+
+  const size_t limbs = (size + 3) / 4;
+  Limb n[kMaxLimbs];
+  Limb s[kMaxLimbs];
+  Limb e[2];
+  loadBigEndian(modulus, n, limbs);
+  loadBigEndian(signature, s, limbs);
+  loadBigEndian(exponent, e, 2);
+  if (compare(s, n, limbs) >= 0) return false;
+  if (e[1] == 0 && e[0] < 3) return false;
+
+  const Montgomery mont(n, limbs);
+  Limb m[kMaxLimbs];
+  mont.toMontgomery(m, s);
+  mont.power(m, m, e, 2);
+  mont.fromMontgomery(m, m);
+
+  uint8_t encoded[512];
+  storeBigEndian(m, limbs, encoded, size);
+
+  // EM = 0x00 || 0x01 || PS (0xFF...) || 0x00 || DigestInfo || H
+  const size_t suffix = sizeof(kSha256DigestInfo) + digest.size();
+  if (size < suffix + 11) return false;
+  const size_t padding = size - suffix - 3;
+  if (encoded[0] != 0x00 || encoded[1] != 0x01) return false;
+  for (size_t i = 0; i < padding; ++i) {
+    if (encoded[2 + i] != 0xFF) return false;
+  }
+  if (encoded[2 + padding] != 0x00) return false;
+  const uint8_t* info = encoded + 3 + padding;
+  return std::memcmp(info, kSha256DigestInfo, sizeof(kSha256DigestInfo)) == 0 &&
+         std::memcmp(info + sizeof(kSha256DigestInfo), digest.data(), digest.size()) == 0;
+}
+
+bool JwsCrypto::verifyEs256(std::string_view x, std::string_view y, const Sha256Digest& digest,
+                            std::string_view signature) {
+  if (x.size() != 32 || y.size() != 32 || signature.size() != 64) return false;
+  const P256& curve = P256::instance();
+
+  FieldElement qx, qy, r, s, e;
+  loadBigEndian(x, qx.data(), kP256Limbs);
+  loadBigEndian(y, qy.data(), kP256Limbs);
+  loadBigEndian(signature.substr(0, 32), r.data(), kP256Limbs);
+  loadBigEndian(signature.substr(32), s.data(), kP256Limbs);
+  loadBigEndian(std::string_view(reinterpret_cast<const char*>(digest.data()), digest.size()), e.data(), kP256Limbs);
+
+  if (compare(qx.data(), curve.p.data(), kP256Limbs) >= 0 || compare(qy.data(), curve.p.data(), kP256Limbs) >= 0) {
+    return false;
+  }
+  if (isZero(r.data(), kP256Limbs) || compare(r.data(), curve.n.data(), kP256Limbs) >= 0) return false;
+  if (isZero(s.data(), kP256Limbs) || compare(s.data(), curve.n.data(), kP256Limbs) >= 0) return false;
+  if (compare(e.data(), curve.n.data(), kP256Limbs) >= 0) subtractInPlace(e.data(), curve.n.data(), kP256Limbs);
+
+  // The public key must lie on the curve: y^2 = x^3 - 3x + b.
+  JacobianPoint q;
+  curve.field.toMontgomery(q.x.data(), qx.data());
+  curve.field.toMontgomery(q.y.data(), qy.data());
+  std::copy(curve.field.one(), curve.field.one() + kP256Limbs, q.z.begin());
+  const FieldElement x3 = curve.mul(curve.mul(q.x, q.x), q.x);
+  const FieldElement threeX = curve.add(curve.add(q.x, q.x), q.x);
+  const FieldElement rhs = curve.add(curve.sub(x3, threeX), curve.b);
+  if (curve.mul(q.y, q.y) != rhs) return false;
+
+  // w = s^-1 mod n (Fermat); u1 = e * w, u2 = r * w.
+  FieldElement exponent = curve.n;
+  const Limb two[kP256Limbs] = {2};
+  subtractInPlace(exponent.data(), two, kP256Limbs);
+  FieldElement w;
+  curve.order.toMontgomery(w.data(), s.data());
+  curve.order.power(w.data(), w.data(), exponent.data(), kP256Limbs);
+  FieldElement u1, u2;
+  curve.order.multiply(u1.data(), e.data(), w.data());
+  curve.order.multiply(u2.data(), r.data(), w.data());
+
+  // Shamir's trick: one shared double-and-add pass for u1 * G + u2 * Q.
+  const JacobianPoint sum = curve.addPoints(curve.generator, q);
+  JacobianPoint point;
+  for (size_t bit = 256; bit-- > 0;) {
+    point = curve.doublePoint(point);
+    const bool b1 = testBit(u1.data(), bit);
+    const bool b2 = testBit(u2.data(), bit);
+    if (b1 && b2) point = curve.addPoints(point, sum);
+    else if (b1) point = curve.addPoints(point, curve.generator);
+    else if (b2) point = curve.addPoints(point, q);
+  }
+  if (curve.isInfinity(point)) return false;
+
+  // Affine x = X / Z^2, reduced mod n, must equal r.
+  exponent = curve.p;
+  subtractInPlace(exponent.data(), two, kP256Limbs);
+  FieldElement zInverse;
+  curve.field.power(zInverse.data(), point.z.data(), exponent.data(), kP256Limbs);
+  FieldElement affineX = curve.mul(point.x, curve.mul(zInverse, zInverse));
+  curve.field.fromMontgomery(affineX.data(), affineX.data());
+  if (compare(affineX.data(), curve.n.data(), kP256Limbs) >= 0) {
+    subtractInPlace(affineX.data(), curve.n.data(), kP256Limbs);
+  }
+  return affineX == r;
+}
+
+} // namespace margelo::nitro::NitroAuth
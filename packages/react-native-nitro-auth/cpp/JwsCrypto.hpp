@@ -0,0 +1,33 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <string_view>
+
+namespace margelo::nitro::NitroAuth {
+
+using Sha256Digest = std::array<uint8_t, 32>;
+
+// Verification primitives for JWS signatures (RFC 7518 RS256 / ES256).
+//
+// Everything here operates on public data, so none of it is constant-time.
+// Integers are unsigned big-endian byte strings, as they appear in a JWK.
+class JwsCrypto {
+public:
+  static Sha256Digest sha256(std::string_view data);
+  // Unpadded base64url (RFC 4648 §5); trailing '=' is tolerated. nullopt on any other character.
+  static std::optional<std::string> base64UrlDecode(std::string_view input);
+  static std::string base64UrlEncode(std::string_view input);
+
+  // RSASSA-PKCS1-v1_5 with SHA-256. Moduli outside 2048..4096 bits are rejected.
+  static bool verifyRs256(std::string_view modulus, std::string_view exponent, const Sha256Digest& digest,
+                          std::string_view signature);
+  // ECDSA over P-256 with SHA-256. `signature` is the 64-byte JWS form r || s.
+  static bool verifyEs256(std::string_view x, std::string_view y, const Sha256Digest& digest,
+                          std::string_view signature);
+};
+
+} // namespace margelo::nitro::NitroAuth
@@ -0,0 +1,65 @@
+#include "MemoryAccounting.hpp"
+#include <array>
+#include <atomic>
+
+namespace margelo::nitro::NitroAuth {
+
+namespace {
+
+struct Counters {
+  std::atomic<size_t> bytes{0};
+  std::atomic<size_t> allocations{0};
+  std::atomic<size_t> peakBytes{0};
+};
+
+// One slot per subsystem plus the total.
+std::array<Counters, kMemorySubsystemCount + 1>& counters() {
+  static std::array<Counters, kMemorySubsystemCount + 1> instance;
+  return instance;
+}
+
+void raisePeak(Counters& slot, size_t bytes) {
+  size_t peak = slot.peakBytes.load(std::memory_order_relaxed);
+  while (bytes > peak && !slot.peakBytes.compare_exchange_weak(peak, bytes, std::memory_order_relaxed)) {
+  }
+}
+
+void add(Counters& slot, size_t bytes) {
+  slot.allocations.fetch_add(1, std::memory_order_relaxed);
+  raisePeak(slot, slot.bytes.fetch_add(bytes, std::memory_order_relaxed) + bytes);
+}
+
+void subtract(Counters& slot, size_t bytes) {
+  slot.allocations.fetch_sub(1, std::memory_order_relaxed);
+  slot.bytes.fetch_sub(bytes, std::memory_order_relaxed);
+}
+
+TrackedMemory read(const Counters& slot) {
+  TrackedMemory usage;
+  usage.bytes = slot.bytes.load(std::memory_order_relaxed);
+  usage.allocations = slot.allocations.load(std::memory_order_relaxed);
+  usage.peakBytes = slot.peakBytes.load(std::memory_order_relaxed);
+  return usage;
+}
+
+} // namespace
+
+void MemoryAccounting::allocated(MemorySubsystem subsystem, size_t bytes) noexcept {
+  add(counters()[static_cast<size_t>(subsystem)], bytes);
+  add(counters()[kMemorySubsystemCount], bytes);
+}
+
+void MemoryAccounting::released(MemorySubsystem subsystem, size_t bytes) noexcept {
+  subtract(counters()[static_cast<size_t>(subsystem)], bytes);
+  subtract(counters()[kMemorySubsystemCount], bytes);
+}
+
+TrackedMemory MemoryAccounting::usage(MemorySubsystem subsystem) noexcept {
+  return read(counters()[static_cast<size_t>(subsystem)]);
+}
+
+TrackedMemory MemoryAccounting::total() noexcept {
+  return read(counters()[kMemorySubsystemCount]);
+}
+
+} // namespace margelo::nitro::NitroAuth
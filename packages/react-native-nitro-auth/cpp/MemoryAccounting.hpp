@@ -0,0 +1,75 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+namespace margelo::nitro::NitroAuth {
+
+// Owners of the native memory reported by HybridAuth::getMemoryStats().
+enum class MemorySubsystem : uint8_t {
+  // Account sessions and their packed users, tokens included.
+  SESSIONS,
+  // Auth state, token and device-code listener registrations.
+  LISTENERS,
+  // Session promises awaiting the platform, queued and single-flight refreshes.
+  PENDING_OPERATIONS,
+  // Watches of platform calls in flight.
+  PLATFORM_OPERATIONS,
+  // Cached resource access tokens.
+  CACHES,
+};
+
+inline constexpr size_t kMemorySubsystemCount = static_cast<size_t>(MemorySubsystem::CACHES) + 1;
+
+struct TrackedMemory {
+  size_t bytes = 0;
+  size_t allocations = 0;
+  // High-water mark of `bytes`.
+  size_t peakBytes = 0;
+};
+
+// Process-wide, lock-free counters fed by TrackedAllocator and by caches that
+// size their own entries. Peaks are high-water marks since process start.
+class MemoryAccounting {
+public:
+  static void allocated(MemorySubsystem subsystem, size_t bytes) noexcept;
+  static void released(MemorySubsystem subsystem, size_t bytes) noexcept;
+  static TrackedMemory usage(MemorySubsystem subsystem) noexcept;
+  // Across all subsystems.
+  static TrackedMemory total() noexcept;
+};
+
+// std::allocator that books every allocation to `Subsystem`. Stateless, so
+// containers and shared_ptr control blocks using it stay the same size.
+template <typename T, MemorySubsystem Subsystem>
+struct TrackedAllocator {
+  using value_type = T;
+
+  template <typename U>
+  struct rebind {
+    using other = TrackedAllocator<U, Subsystem>;
+  };
+
+  TrackedAllocator() noexcept = default;
+  template <typename U>
+  TrackedAllocator(const TrackedAllocator<U, Subsystem>&) noexcept {}
+
+  T* allocate(size_t count) {
+    T* pointer = std::allocator<T>().allocate(count);
+    MemoryAccounting::allocated(Subsystem, count * sizeof(T));
+    return pointer;
+  }
+
+  void deallocate(T* pointer, size_t count) noexcept {
+    MemoryAccounting::released(Subsystem, count * sizeof(T));
+    std::allocator<T>().deallocate(pointer, count);
+  }
+
+  template <typename U>
+  bool operator==(const TrackedAllocator<U, Subsystem>&) const noexcept {
+    return true;
+  }
+};
+
+} // namespace margelo::nitro::NitroAuth
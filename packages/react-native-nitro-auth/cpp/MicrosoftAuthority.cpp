@@ -0,0 +1,183 @@
+#include "MicrosoftAuthority.hpp"
+#include <array>
+#include <cstdint>
+#include <mutex>
+#include <unordered_map>
+
+namespace margelo::nitro::NitroAuth {
+
+namespace {
+
+constexpr std::string_view kEntraBaseUrl = "https://login.microsoftonline.com/";
+constexpr std::string_view kB2cLoginSuffix = ".b2clogin.com";
+constexpr std::string_view kIssuerVersionSuffix = "/v2.0";
+constexpr size_t kMaxSegmentLength = 128;
+constexpr size_t kMaxLabelLength = 63;
+constexpr size_t kMaxDomainLength = 253;
+constexpr size_t kMaxCachedAuthorities = 32;
+
+enum CharClass : uint8_t {
+  kAlpha = 1 << 0,
+  kAlnum = 1 << 1,
+  // [A-Za-z0-9._-]
+  kSegment = 1 << 2,
+  // [A-Za-z0-9-]
+  kLabel = 1 << 3,
+};
+
+constexpr std::array<uint8_t, 256> makeCharClasses() {
+  std::array<uint8_t, 256> table{};
+  for (int c = 0; c < 256; ++c) {
+    const bool alpha = (c >= 'A' && c <= 'Z') || (c >= 'a' && c <= 'z');
+    const bool alnum = alpha || (c >= '0' && c <= '9');
+    uint8_t flags = 0;
+    if (alpha) flags |= kAlpha;
+    if (alnum) flags |= kAlnum | kSegment | kLabel;
+    if (c == '.' || c == '_') flags |= kSegment;
+    if (c == '-') flags |= kSegment | kLabel;
+    table[c] = flags;
+  }
+  return table;
+}
+
+constexpr auto kCharClasses = makeCharClasses();
+
+constexpr bool is(char c, uint8_t flags) {
+  return (kCharClasses[static_cast<uint8_t>(c)] & flags) != 0;
+}
+
+constexpr bool isAsciiSpace(char c) {
+  return c == ' ' || c == '\t' || c == '\n' || c == '\r' || c == '\f' || c == '\v';
+}
+
+std::string_view trim(std::string_view value) {
+  while (!value.empty() && isAsciiSpace(value.front())) value.remove_prefix(1);
+  while (!value.empty() && isAsciiSpace(value.back())) value.remove_suffix(1);
+  return value;
+}
+
+bool allOf(std::string_view value, uint8_t flags) {
+  for (char c : value) {
+    if (!is(c, flags)) return false;
+  }
+  return true;
+}
+
+// [A-Za-z0-9][A-Za-z0-9._-]{0,127}
+bool isSegment(std::string_view value) {
+  return !value.empty() && value.size() <= kMaxSegmentLength && is(value.front(), kAlnum) &&
+         allOf(value.substr(1), kSegment);
+}
+
+// [A-Za-z0-9](?:[A-Za-z0-9-]{0,61}[A-Za-z0-9])?
+bool isLabel(std::string_view value) {
+  return !value.empty() && value.size() <= kMaxLabelLength && is(value.front(), kAlnum) &&
+         is(value.back(), kAlnum) && allOf(value, kLabel);
+}
+
+} // namespace
+
+bool MicrosoftAuthority::isValidTenant(std::string_view value) {
+  // `common`, `organizations`, `consumers` and tenant IDs are all segments too.
+  return isSegment(value);
+}
+
+bool MicrosoftAuthority::isValidB2cPolicy(std::string_view value) {
+  return isSegment(value);
+}
+
+bool MicrosoftAuthority::isValidB2cTenantPath(std::string_view value) {
+  const size_t slash = value.find('/');
+  if (slash == std::string_view::npos) return false;
+  return isSegment(value.substr(0, slash)) && isSegment(value.substr(slash + 1));
+}
+
+bool MicrosoftAuthority::isValidDomain(std::string_view value) {
+  if (value.empty() || value.size() > kMaxDomainLength) return false;
+  const size_t lastDot = value.rfind('.');
+  if (lastDot == std::string_view::npos) return false;
+
+  const std::string_view topLevel = value.substr(lastDot + 1);
+  if (topLevel.size() < 2 || topLevel.size() > kMaxLabelLength || !allOf(topLevel, kAlpha)) return false;
+
+  std::string_view labels = value.substr(0, lastDot);
+  while (true) {
+    const size_t dot = labels.find('.');
+    if (!isLabel(labels.substr(0, dot))) return false;
+    if (dot == std::string_view::npos) return true;
+    labels.remove_prefix(dot + 1);
+  }
+}
+
+std::optional<std::string_view> MicrosoftAuthority::b2cTenantName(std::string_view domain) {
+  if (domain.size() <= kB2cLoginSuffix.size() ||
+      domain.substr(domain.size() - kB2cLoginSuffix.size()) != kB2cLoginSuffix) {
+    return std::nullopt;
+  }
+  const std::string_view tenantName = domain.substr(0, domain.size() - kB2cLoginSuffix.size());
+  if (!isLabel(tenantName)) return std::nullopt;
+  return tenantName;
+}
+
+std::optional<std::string> MicrosoftAuthority::b2cTenantPath(std::string_view tenant, std::string_view domain) {
+  if (isValidB2cTenantPath(tenant)) return std::string(tenant);
+  if (!isValidB2cPolicy(tenant)) return std::nullopt;
+  const auto tenantName = b2cTenantName(domain);
+  if (!tenantName) return std::nullopt;
+
+  std::string path;
+  path.reserve(tenantName->size() + tenant.size() + 17);
+  path.append(*tenantName).append(".onmicrosoft.com/").append(tenant);
+  return path;
+}
+
+std::optional<std::string> MicrosoftAuthority::resolveBaseUrl(std::string_view tenant, std::string_view b2cDomain) {
+  tenant = trim(tenant);
+  b2cDomain = trim(b2cDomain);
+
+  if (!b2cDomain.empty()) {
+    std::string domain(b2cDomain);
+    for (char& c : domain) {
+      if (c >= 'A' && c <= 'Z') c = static_cast<char>(c - 'A' + 'a');
+    }
+    if (!isValidDomain(domain)) return std::nullopt;
+    const auto path = b2cTenantPath(tenant, domain);
+    if (!path) return std::nullopt;
+    return "https://" + domain + "/" + *path + "/";
+  }
+
+  if (!isValidTenant(tenant)) return std::nullopt;
+  std::string url;
+  url.reserve(kEntraBaseUrl.size() + tenant.size() + 1);
+  url.append(kEntraBaseUrl).append(tenant).push_back('/');
+  return url;
+}
+
+std::optional<std::string> MicrosoftAuthority::authBaseUrl(std::string_view tenant, std::string_view b2cDomain) {
+  static std::mutex mutex;
+  static std::unordered_map<std::string, std::optional<std::string>> cache;
+
+  std::string key;
+  key.reserve(tenant.size() + b2cDomain.size() + 1);
+  key.append(tenant).push_back('\0');
+  key.append(b2cDomain);
+
+  std::lock_guard<std::mutex> lock(mutex);
+  if (auto it = cache.find(key); it != cache.end()) return it->second;
+  // Apps configure a handful of authorities; a full table means callers are
+  // passing arbitrary input, so start over rather than grow without bound.
+  if (cache.size() >= kMaxCachedAuthorities) cache.clear();
+  return cache.emplace(std::move(key), resolveBaseUrl(tenant, b2cDomain)).first->second;
+}
+
+bool MicrosoftAuthority::isEntraIssuer(std::string_view issuer) {
+  if (issuer.size() <= kEntraBaseUrl.size() + kIssuerVersionSuffix.size() ||
+      issuer.substr(0, kEntraBaseUrl.size()) != kEntraBaseUrl ||
+      issuer.substr(issuer.size() - kIssuerVersionSuffix.size()) != kIssuerVersionSuffix) {
+    return false;
+  }
+  return isValidTenant(
+      issuer.substr(kEntraBaseUrl.size(), issuer.size() - kEntraBaseUrl.size() - kIssuerVersionSuffix.size()));
+}
+
+} // namespace margelo::nitro::NitroAuth
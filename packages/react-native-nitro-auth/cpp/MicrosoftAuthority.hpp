@@ -0,0 +1,40 @@
+#pragma once
+
+#include <optional>
+#include <string>
+#include <string_view>
+
+namespace margelo::nitro::NitroAuth {
+
+// Validation and canonicalisation of Microsoft identity platform authorities
+// (Entra ID tenants and Azure AD B2C domains / policies). This is the single
+// implementation behind the Android and iOS adapters; the matchers are
+// hand-written scanners over a constexpr character table, equivalent to the
+// patterns the adapters used to compile on every call.
+class MicrosoftAuthority {
+public:
+  // `common`, `organizations`, `consumers`, a tenant ID or a tenant domain.
+  static bool isValidTenant(std::string_view value);
+  // A B2C user flow / custom policy name.
+  static bool isValidB2cPolicy(std::string_view value);
+  // `<tenant>/<policy>` for B2C custom domains.
+  static bool isValidB2cTenantPath(std::string_view value);
+  // A DNS hostname with an alphabetic top-level label.
+  static bool isValidDomain(std::string_view value);
+  // `<tenant>` of `<tenant>.b2clogin.com`, if `domain` has that shape.
+  static std::optional<std::string_view> b2cTenantName(std::string_view domain);
+  static std::optional<std::string> b2cTenantPath(std::string_view tenant, std::string_view domain);
+
+  // `https://login.microsoftonline.com/<tenant>/` or `https://<b2cDomain>/<tenant path>/`.
+  // Inputs are trimmed and the domain lowercased; nullopt for an invalid configuration.
+  static std::optional<std::string> resolveBaseUrl(std::string_view tenant, std::string_view b2cDomain = {});
+
+  // resolveBaseUrl() memoized per (tenant, b2cDomain) in a process-wide table;
+  // a configuration is resolved once no matter how many logins and refreshes use it.
+  static std::optional<std::string> authBaseUrl(std::string_view tenant, std::string_view b2cDomain = {});
+
+  // Whether `issuer` is `https://login.microsoftonline.com/<valid tenant>/v2.0`.
+  static bool isEntraIssuer(std::string_view issuer);
+};
+
+} // namespace margelo::nitro::NitroAuth
@@ -0,0 +1,644 @@
+#include "OidcClient.hpp"
+#include "JSONReader.hpp"
+#include "JwsCrypto.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <random>
+
+namespace margelo::nitro::NitroAuth {
+
+namespace {
+
+bool isUnreserved(char c) {
+  return (c >= 'A' && c <= 'Z') || (c >= 'a' && c <= 'z') || (c >= '0' && c <= '9') || c == '-' || c == '.' ||
+         c == '_' || c == '~';
+}
+
+int hexValue(char c) {
+  if (c >= '0' && c <= '9') return c - '0';
+  if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+  if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+  return -1;
+}
+
+// application/x-www-form-urlencoded decoding: '+' is a space, bad escapes pass through.
+std::string percentDecode(std::string_view value) {
+  std::string out;
+  out.reserve(value.size());
+  for (size_t i = 0; i < value.size(); ++i) {
+    const char c = value[i];
+    if (c == '+') {
+      out.push_back(' ');
+    } else if (c == '%' && i + 2 < value.size() && hexValue(value[i + 1]) >= 0 && hexValue(value[i + 2]) >= 0) {
+      out.push_back(static_cast<char>(hexValue(value[i + 1]) * 16 + hexValue(value[i + 2])));
+      i += 2;
+    } else {
+      out.push_back(c);
+    }
+  }
+  return out;
+}
+
+const char* promptValue(MicrosoftPrompt prompt) {
+  switch (prompt) {
+    case MicrosoftPrompt::LOGIN: return "login";
+    case MicrosoftPrompt::CONSENT: return "consent";
+    case MicrosoftPrompt::SELECT_ACCOUNT: return "select_account";
+    case MicrosoftPrompt::NONE: return "none";
+  }
+  return "login";
+}
+
+std::vector<std::string> splitScopes(std::string_view value) {
+  std::vector<std::string> scopes;
+  while (!value.empty()) {
+    const size_t space = value.find(' ');
+    if (space != 0) scopes.emplace_back(value.substr(0, space));
+    if (space == std::string_view::npos) break;
+    value.remove_prefix(space + 1);
+  }
+  return scopes;
+}
+
+std::string joinScopes(const std::vector<std::string>& scopes) {
+  std::string joined;
+  for (const auto& scope : scopes) {
+    if (!joined.empty()) joined.push_back(' ');
+    joined += scope;
+  }
+  return joined;
+}
+
+// Durations arrive as numbers or, from some servers, as numeric strings.
+bool readSeconds(JSONReader& reader, std::optional<double>& field) {
+  if (reader.peek() != '"') return readOptionalNumber(reader, field);
+  std::string value;
+  if (!reader.readString(value)) return false;
+  char* end = nullptr;
+  const double seconds = std::strtod(value.c_str(), &end);
+  if (end != value.c_str() + value.size()) return false;
+  field = seconds;
+  return true;
+}
+
+std::optional<std::string> oauthError(const HttpResponse& response) {
+  std::optional<std::string> error;
+  readJSONObject(response.body, [&](std::string_view key, JSONReader& reader) {
+    if (key == "error") return readOptionalString(reader, error);
+    return reader.skipValue();
+  });
+  return error;
+}
+
+std::string responseErrorCode(const HttpResponse& response) {
+  if (response.status == 0 || response.status >= 500) return "network_error";
+  if (auto error = oauthError(response)) return OidcClient::errorCodeForOAuthError(*error);
+  return response.status >= 400 ? "token_error" : "parse_error";
+}
+
+} // namespace
+
+struct OidcClient::LoginState {
+  std::shared_ptr<Promise<Result<AuthUser>>> promise;
+  std::optional<LoginOptions> options;
+  std::vector<std::string> scopes;
+  OidcAuthorizationRequest request;
+  std::shared_ptr<const OidcMetadata> metadata;
+};
+
+struct OidcClient::DeviceLogin {
+  std::shared_ptr<Promise<Result<AuthUser>>> promise;
+  std::vector<std::string> scopes;
+  std::shared_ptr<const OidcMetadata> metadata;
+  std::shared_ptr<CancellationToken> cancellation;
+  std::mutex mutex;
+  OidcDeviceCode code;
+  std::optional<TimerService::TimerId> timer;
+  CancellationToken::ListenerId cancellationListener = 0;
+  bool finished = false;
+};
+
+OidcClient::OidcClient(OidcProviderConfig config, std::shared_ptr<HttpClient> httpClient,
+                       std::shared_ptr<OidcMetadataCache> metadata, Browser browser, std::shared_ptr<AuthClock> clock,
+                       std::shared_ptr<TimerService> timerService)
+  : _config(std::move(config)),
+    _httpClient(std::move(httpClient)),
+    _metadata(std::move(metadata)),
+    _browser(std::move(browser)),
+    _clock(std::move(clock)),
+    _timerService(std::move(timerService)) {}
+
+std::string OidcClient::percentEncode(std::string_view value) {
+  static constexpr char kHex[] = "0123456789ABCDEF";
+  std::string out;
+  out.reserve(value.size());
+  for (char c : value) {
+    if (isUnreserved(c)) {
+      out.push_back(c);
+    } else {
+      const auto byte = static_cast<uint8_t>(c);
+      out.push_back('%');
+      out.push_back(kHex[byte >> 4]);
+      out.push_back(kHex[byte & 0x0F]);
+    }
+  }
+  return out;
+}
+
+std::string OidcClient::formEncode(const std::vector<std::pair<std::string, std::string>>& fields) {
+  std::string out;
+  for (const auto& [name, value] : fields) {
+    if (!out.empty()) out.push_back('&');
+    out += percentEncode(name);
+    out.push_back('=');
+    out += percentEncode(value);
+  }
+  return out;
+}
+
+std::string OidcClient::randomToken(size_t bytes) {
+  std::random_device device;
+  std::string raw(bytes, '\0');
+  for (size_t i = 0; i < bytes; i += sizeof(uint32_t)) {
+    const uint32_t word = device();
+    for (size_t j = 0; j < sizeof(uint32_t) && i + j < bytes; ++j) {
+      raw[i + j] = static_cast<char>((word >> (8 * j)) & 0xFF);
+    }
+  }
+  return JwsCrypto::base64UrlEncode(raw);
+}
+
+std::string OidcClient::codeChallenge(std::string_view codeVerifier) {
+  const Sha256Digest digest = JwsCrypto::sha256(codeVerifier);
+  return JwsCrypto::base64UrlEncode(std::string_view(reinterpret_cast<const char*>(digest.data()), digest.size()));
+}
+
+std::vector<std::string> OidcClient::scopesFor(const OidcProviderConfig& config,
+                                               const std::optional<std::vector<std::string>>& requested) {
+  std::vector<std::string> candidates;
+  if (requested && !requested->empty()) {
+    candidates = *requested;
+  } else if (config.scopes && !config.scopes->empty()) {
+    candidates = *config.scopes;
+  } else {
+    candidates = splitScopes(kDefaultScopes);
+  }
+  std::vector<std::string> scopes{"openid"};
+  for (auto& scope : candidates) {
+    if (scope.empty() || std::find(scopes.begin(), scopes.end(), scope) != scopes.end()) continue;
+    scopes.push_back(std::move(scope));
+  }
+  return scopes;
+}
+
+OidcAuthorizationRequest OidcClient::authorizationRequest(const OidcProviderConfig& config,
+                                                          const std::string& authorizationEndpoint,
+                                                          const std::vector<std::string>& scopes,
+                                                          const std::optional<LoginOptions>& options) {
+  OidcAuthorizationRequest request;
+  request.state = randomToken(16);
+  request.nonce = options && options->nonce && !options->nonce->empty() ? *options->nonce : randomToken(16);
+  request.codeVerifier = randomToken(32);
+
+  std::vector<std::pair<std::string, std::string>> query{
+      {"response_type", "code"},
+      {"client_id", config.clientId},
+      {"redirect_uri", config.redirectUri},
+      {"scope", joinScopes(scopes)},
+      {"state", request.state},
+      {"nonce", request.nonce},
+      {"code_challenge", codeChallenge(request.codeVerifier)},
+      {"code_challenge_method", "S256"},
+  };
+  if (options && options->loginHint && !options->loginHint->empty()) {
+    query.emplace_back("login_hint", *options->loginHint);
+  }
+  if (options && options->prompt) {
+    query.emplace_back("prompt", promptValue(*options->prompt));
+  }
+  request.url = authorizationEndpoint;
+  request.url.push_back(authorizationEndpoint.find('?') == std::string::npos ? '?' : '&');
+  request.url += formEncode(query);
+  return request;
+}
+
+OidcRedirect OidcClient::parseRedirect(std::string_view url) {
+  OidcRedirect redirect;
+  const size_t query = url.find('?');
+  const size_t fragment = url.find('#');
+  std::string_view parameters;
+  if (query != std::string_view::npos && (fragment == std::string_view::npos || query < fragment)) {
+    parameters = url.substr(query + 1, fragment == std::string_view::npos ? std::string_view::npos : fragment - query - 1);
+  }
+  // Some providers answer in the fragment even for the code flow.
+  if (fragment != std::string_view::npos && parameters.find("code=") == std::string_view::npos &&
+      parameters.find("error=") == std::string_view::npos) {
+    parameters = url.substr(fragment + 1);
+  }
+  while (!parameters.empty()) {
+    const size_t amp = parameters.find('&');
+    const std::string_view pair = parameters.substr(0, amp);
+    const size_t equals = pair.find('=');
+    const std::string_view name = pair.substr(0, equals);
+    const std::string value = equals == std::string_view::npos ? "" : percentDecode(pair.substr(equals + 1));
+    if (name == "code") redirect.code = value;
+    else if (name == "state") redirect.state = value;
+    else if (name == "error") redirect.error = value;
+    if (amp == std::string_view::npos) break;
+    parameters.remove_prefix(amp + 1);
+  }
+  return redirect;
+}
+
+std::optional<OidcTokenResponse> OidcClient::parseTokenResponse(const HttpResponse& response, int64_t nowMs) {
+  OidcTokenResponse result;
+  std::optional<double> expiresIn;
+  const bool ok = readJSONObject(response.body, [&](std::string_view key, JSONReader& reader) {
+    if (key == "access_token") return readOptionalString(reader, result.tokens.accessToken);
+    if (key == "id_token") return readOptionalString(reader, result.tokens.idToken);
+    if (key == "refresh_token") return readOptionalString(reader, result.tokens.refreshToken);
+    if (key == "scope") return readOptionalString(reader, result.scope);
+    if (key == "expires_in") return readSeconds(reader, expiresIn);
+    return reader.skipValue();
+  });
+  if (!ok || !result.tokens.accessToken || result.tokens.accessToken->empty()) return std::nullopt;
+  if (expiresIn && std::isfinite(*expiresIn) && *expiresIn > 0) {
+    result.tokens.expirationTime = static_cast<double>(nowMs) + *expiresIn * 1000.0;
+  }
+  return result;
+}
+
+std::optional<OidcDeviceCode> OidcClient::parseDeviceAuthorization(const HttpResponse& response, int64_t nowMs) {
+  std::optional<std::string> deviceCode;
+  std::optional<std::string> userCode;
+  std::optional<std::string> verificationUri;
+  std::optional<std::string> verificationUriComplete;
+  std::optional<double> expiresIn;
+  std::optional<double> interval;
+  const bool ok = readJSONObject(response.body, [&](std::string_view key, JSONReader& reader) {
+    if (key == "device_code") return readOptionalString(reader, deviceCode);
+    if (key == "user_code") return readOptionalString(reader, userCode);
+    // Google predates the RFC and still says `verification_url`.
+    if (key == "verification_uri" || key == "verification_url") return readOptionalString(reader, verificationUri);
+    if (key == "verification_uri_complete") return readOptionalString(reader, verificationUriComplete);
+    if (key == "expires_in") return readSeconds(reader, expiresIn);
+    if (key == "interval") return readSeconds(reader, interval);
+    return reader.skipValue();
+  });
+  if (!ok || !deviceCode || deviceCode->empty() || !userCode || userCode->empty() || !verificationUri ||
+      verificationUri->empty() || !expiresIn || !std::isfinite(*expiresIn) || *expiresIn <= 0) {
+    return std::nullopt;
+  }
+  OidcDeviceCode code;
+  code.deviceCode = std::move(*deviceCode);
+  code.expiresAtMs = nowMs + static_cast<int64_t>(*expiresIn * 1000.0);
+  code.intervalMs = interval && std::isfinite(*interval) && *interval > 0
+                        ? std::clamp(static_cast<int64_t>(*interval * 1000.0), kMinPollIntervalMs, kMaxPollIntervalMs)
+                        : kDefaultPollIntervalMs;
+  code.authorization = DeviceAuthorization(std::move(*userCode), std::move(*verificationUri),
+                                           std::move(verificationUriComplete), static_cast<double>(code.expiresAtMs),
+                                           static_cast<double>(code.intervalMs) / 1000.0);
+  return code;
+}
+
+const char* OidcClient::errorCodeForOAuthError(std::string_view error) {
+  if (error == "access_denied") return "cancelled";
+  if (error == "invalid_client" || error == "unauthorized_client" || error == "invalid_scope") {
+    return "configuration_error";
+  }
+  if (error == "invalid_grant" || error == "invalid_request") return "token_error";
+  if (error == "temporarily_unavailable" || error == "server_error") return "network_error";
+  if (error == "expired_token") return "timeout";
+  return "unknown";
+}
+
+std::shared_ptr<Promise<Result<AuthUser>>> OidcClient::login(const std::optional<LoginOptions>& options) {
+  auto state = std::make_shared<LoginState>();
+  state->promise = Promise<Result<AuthUser>>::create();
+  state->options = options;
+  state->scopes = scopesFor(_config, options ? options->scopes : std::nullopt);
+  if (!_metadata || !_httpClient || !_browser || _config.issuer.empty() || _config.clientId.empty() ||
+      _config.redirectUri.empty()) {
+    state->promise->resolve(AuthErrorCode::CONFIGURATION_ERROR);
+    return state->promise;
+  }
+  auto self = shared_from_this();
+  auto lookup = _metadata->get(_config.issuer);
+  lookup->addOnResolvedListener([self, state](const Result<std::shared_ptr<const OidcMetadata>>& metadata) {
+    if (!metadata) {
+      state->promise->resolve(metadata.error());
+      return;
+    }
+    self->authorize(state, metadata.value());
+  });
+  return state->promise;
+}
+
+void OidcClient::authorize(const std::shared_ptr<LoginState>& state,
+                           const std::shared_ptr<const OidcMetadata>& metadata) {
+  state->metadata = metadata;
+  state->request = authorizationRequest(_config, metadata->provider.authorizationEndpoint, state->scopes, state->options);
+  auto self = shared_from_this();
+  auto redirect = _browser(state->request.url, _config.redirectUri);
+  redirect->addOnResolvedListener([self, state, metadata](const Result<std::string>& url) {
+    if (!url) {
+      state->promise->resolve(url.error());
+      return;
+    }
+    const OidcRedirect parsed = parseRedirect(url.value());
+    if (parsed.error) {
+      state->promise->resolve(AuthError(errorCodeForOAuthError(*parsed.error)));
+      return;
+    }
+    if (!parsed.state || *parsed.state != state->request.state) {
+      state->promise->resolve(AuthErrorCode::INVALID_STATE);
+      return;
+    }
+    if (!parsed.code || parsed.code->empty()) {
+      state->promise->resolve(AuthErrorCode::PARSE_ERROR);
+      return;
+    }
+    self->exchangeCode(state, metadata, *parsed.code);
+  });
+}
+
+void OidcClient::exchangeCode(const std::shared_ptr<LoginState>& state,
+                              const std::shared_ptr<const OidcMetadata>& metadata, const std::string& code) {
+  auto self = shared_from_this();
+  postToken(metadata->provider.tokenEndpoint,
+            {
+                {"grant_type", "authorization_code"},
+                {"code", code},
+                {"redirect_uri", _config.redirectUri},
+                {"client_id", _config.clientId},
+                {"code_verifier", state->request.codeVerifier},
+            },
+            [self, state](std::optional<OidcTokenResponse> response, const char* error) {
+              if (!response) {
+                state->promise->resolve(AuthError(error));
+                return;
+              }
+              self->finishLogin(state, std::move(*response), false);
+            });
+}
+
+void OidcClient::finishLogin(const std::shared_ptr<LoginState>& state, OidcTokenResponse response, bool retried) {
+  if (!response.tokens.idToken || response.tokens.idToken->empty()) {
+    state->promise->resolve(AuthErrorCode::NO_ID_TOKEN);
+    return;
+  }
+  IdTokenExpectations expectations;
+  expectations.issuers.push_back(state->metadata->provider.issuer);
+  expectations.audience = _config.clientId;
+  // The device grant has no nonce.
+  if (!state->request.nonce.empty()) expectations.nonce = state->request.nonce;
+  auto result = _idTokens.verify(*response.tokens.idToken, *state->metadata, expectations, _clock->nowMs());
+  if (!result.claims && result.unknownKey && !retried) {
+    // The provider may have rotated its signing keys since the JWKS was cached.
+    _metadata->invalidate(_config.issuer);
+    auto self = shared_from_this();
+    auto shared = std::make_shared<OidcTokenResponse>(std::move(response));
+    auto lookup = _metadata->get(_config.issuer);
+    lookup->addOnResolvedListener([self, state, shared](const Result<std::shared_ptr<const OidcMetadata>>& metadata) {
+      if (!metadata) {
+        state->promise->resolve(metadata.error());
+        return;
+      }
+      state->metadata = metadata.value();
+      self->finishLogin(state, std::move(*shared), true);
+    });
+    return;
+  }
+  if (!result.claims) {
+    state->promise->resolve(AuthError(result.error));
+    return;
+  }
+
+  const IdTokenPayload& claims = *result.claims;
+  AuthUser user;
+  user.provider = AuthProvider::OIDC;
+  user.userId = claims.subject;
+  user.email = claims.email;
+  user.name = claims.name;
+  user.photo = claims.picture;
+  user.idToken = std::move(response.tokens.idToken);
+  user.accessToken = std::move(response.tokens.accessToken);
+  user.refreshToken = std::move(response.tokens.refreshToken);
+  user.expirationTime = response.tokens.expirationTime;
+  user.scopes = response.scope ? scopesFor(_config, splitScopes(*response.scope)) : state->scopes;
+  state->promise->resolve(user);
+}
+
+std::shared_ptr<Promise<Result<AuthUser>>> OidcClient::loginWithDeviceCode(
+    const std::optional<LoginOptions>& options, DeviceCodeListener onUserCode,
+    const std::shared_ptr<CancellationToken>& cancellation) {
+  auto login = std::make_shared<DeviceLogin>();
+  login->promise = Promise<Result<AuthUser>>::create();
+  login->scopes = scopesFor(_config, options ? options->scopes : std::nullopt);
+  login->cancellation = cancellation;
+  if (!_metadata || !_httpClient || !_timerService || _config.issuer.empty() || _config.clientId.empty()) {
+    login->promise->resolve(AuthErrorCode::CONFIGURATION_ERROR);
+    return login->promise;
+  }
+  auto self = shared_from_this();
+  if (cancellation) {
+    std::weak_ptr<DeviceLogin> weak = login;
+    auto listener = cancellation->onCancelled([self, weak](const std::string& reason) {
+      if (auto login = weak.lock()) self->finishDeviceLogin(login, AuthError(reason));
+    });
+    std::lock_guard<std::mutex> lock(login->mutex);
+    if (login->finished) return login->promise;
+    login->cancellationListener = listener;
+  }
+  auto lookup = _metadata->get(_config.issuer);
+  lookup->addOnResolvedListener([self, login, onUserCode = std::move(onUserCode)](
+                                    const Result<std::shared_ptr<const OidcMetadata>>& metadata) {
+    if (!metadata) {
+      self->finishDeviceLogin(login, metadata.error());
+      return;
+    }
+    login->metadata = metadata.value();
+    self->requestDeviceCode(login, onUserCode);
+  });
+  return login->promise;
+}
+
+void OidcClient::requestDeviceCode(const std::shared_ptr<DeviceLogin>& login, const DeviceCodeListener& onUserCode) {
+  const auto& endpoint = login->metadata->provider.deviceAuthorizationEndpoint;
+  if (!endpoint || endpoint->empty()) {
+    finishDeviceLogin(login, AuthErrorCode::CONFIGURATION_ERROR);
+    return;
+  }
+  auto self = shared_from_this();
+  postForm(*endpoint, {{"client_id", _config.clientId}, {"scope", joinScopes(login->scopes)}},
+           [self, login, onUserCode](HttpResponse response) {
+             std::optional<OidcDeviceCode> code;
+             if (response.status >= 200 && response.status < 300) {
+               code = parseDeviceAuthorization(response, self->_clock->nowMs());
+             }
+             if (!code) {
+               self->finishDeviceLogin(login, AuthError(responseErrorCode(response)));
+               return;
+             }
+             DeviceAuthorization authorization;
+             {
+               std::lock_guard<std::mutex> lock(login->mutex);
+               if (login->finished) return;
+               login->code = std::move(*code);
+               authorization = login->code.authorization;
+             }
+             if (onUserCode) onUserCode(authorization);
+             self->scheduleDevicePoll(login);
+           });
+}
+
+void OidcClient::scheduleDevicePoll(const std::shared_ptr<DeviceLogin>& login) {
+  std::lock_guard<std::mutex> lock(login->mutex);
+  if (login->finished) return;
+  auto self = shared_from_this();
+  // The last poll lands on the expiry so an unapproved code fails promptly.
+  const int64_t remainingMs = login->code.expiresAtMs - _clock->nowMs();
+  const int64_t delayMs = std::max<int64_t>(0, std::min(login->code.intervalMs, remainingMs));
+  login->timer = _timerService->schedule(delayMs, [self, login]() { self->pollDeviceToken(login); });
+}
+
+void OidcClient::pollDeviceToken(const std::shared_ptr<DeviceLogin>& login) {
+  std::string deviceCode;
+  bool expired = false;
+  {
+    std::lock_guard<std::mutex> lock(login->mutex);
+    if (login->finished) return;
+    login->timer = std::nullopt;
+    expired = _clock->nowMs() >= login->code.expiresAtMs;
+    deviceCode = login->code.deviceCode;
+  }
+  if (expired) {
+    finishDeviceLogin(login, AuthErrorCode::TIMEOUT);
+    return;
+  }
+  auto self = shared_from_this();
+  postForm(login->metadata->provider.tokenEndpoint,
+           {
+               {"grant_type", "urn:ietf:params:oauth:grant-type:device_code"},
+               {"device_code", deviceCode},
+               {"client_id", _config.clientId},
+           },
+           [self, login](HttpResponse response) {
+             if (response.status >= 200 && response.status < 300) {
+               if (auto tokens = parseTokenResponse(response, self->_clock->nowMs())) {
+                 auto state = std::make_shared<LoginState>();
+                 state->promise = Promise<Result<AuthUser>>::create();
+                 state->scopes = login->scopes;
+                 state->metadata = login->metadata;
+                 state->promise->addOnResolvedListener([self, login](const Result<AuthUser>& result) {
+                   self->finishDeviceLogin(login, result);
+                 });
+                 self->finishLogin(state, std::move(*tokens), false);
+                 return;
+               }
+             }
+             const auto error = oauthError(response);
+             const bool unreachable = response.status == 0 || response.status >= 500;
+             if ((error && (*error == "authorization_pending" || *error == "slow_down")) || (!error && unreachable)) {
+               {
+                 std::lock_guard<std::mutex> lock(login->mutex);
+                 if (error && *error == "slow_down") {
+                   login->code.intervalMs = std::min(login->code.intervalMs + kSlowDownStepMs, kMaxPollIntervalMs);
+                 } else if (!error) {
+                   // RFC 8628 3.5: back off while the server cannot be reached.
+                   login->code.intervalMs = std::min(login->code.intervalMs * 2, kMaxPollIntervalMs);
+                 }
+               }
+               self->scheduleDevicePoll(login);
+               return;
+             }
+             self->finishDeviceLogin(login, AuthError(responseErrorCode(response)));
+           });
+}
+
+void OidcClient::finishDeviceLogin(const std::shared_ptr<DeviceLogin>& login, const Result<AuthUser>& result) {
+  std::optional<TimerService::TimerId> timer;
+  CancellationToken::ListenerId listener = 0;
+  {
+    std::lock_guard<std::mutex> lock(login->mutex);
+    if (login->finished) return;
+    login->finished = true;
+    timer = login->timer;
+    listener = login->cancellationListener;
+    login->timer = std::nullopt;
+  }
+  if (timer) _timerService->cancel(*timer);
+  if (listener != 0 && login->cancellation) login->cancellation->removeListener(listener);
+  login->promise->resolve(result);
+}
+
+std::shared_ptr<Promise<Result<AuthTokens>>> OidcClient::refresh(const std::string& refreshToken,
+                                                                 const std::vector<std::string>& scopes) {
+  auto promise = Promise<Result<AuthTokens>>::create();
+  if (!_metadata || !_httpClient || _config.issuer.empty() || _config.clientId.empty()) {
+    promise->resolve(AuthErrorCode::CONFIGURATION_ERROR);
+    return promise;
+  }
+  if (refreshToken.empty()) {
+    promise->resolve(AuthErrorCode::REFRESH_FAILED);
+    return promise;
+  }
+  auto self = shared_from_this();
+  auto lookup = _metadata->get(_config.issuer);
+  lookup->addOnResolvedListener([self, promise, refreshToken, scopes](
+                                    const Result<std::shared_ptr<const OidcMetadata>>& metadata) {
+    if (!metadata) {
+      promise->resolve(metadata.error());
+      return;
+    }
+    std::vector<std::pair<std::string, std::string>> fields{
+        {"grant_type", "refresh_token"},
+        {"refresh_token", refreshToken},
+        {"client_id", self->_config.clientId},
+    };
+    if (!scopes.empty()) fields.emplace_back("scope", joinScopes(scopes));
+    self->postToken(metadata.value()->provider.tokenEndpoint, std::move(fields),
+                    [promise](std::optional<OidcTokenResponse> response, const char* error) {
+                      if (!response) {
+                        promise->resolve(AuthError(error));
+                        return;
+                      }
+                      promise->resolve(response->tokens);
+                    });
+  });
+  return promise;
+}
+
+void OidcClient::postForm(const std::string& endpoint, const std::vector<std::pair<std::string, std::string>>& fields,
+                          std::function<void(HttpResponse)> completion) {
+  HttpRequest request;
+  request.method = "POST";
+  request.url = endpoint;
+  request.headers.emplace_back("Content-Type", "application/x-www-form-urlencoded");
+  request.headers.emplace_back("Accept", "application/json");
+  request.body = formEncode(fields);
+  _httpClient->send(request, std::move(completion));
+}
+
+void OidcClient::postToken(const std::string& tokenEndpoint, std::vector<std::pair<std::string, std::string>> fields,
+                           std::function<void(std::optional<OidcTokenResponse>, const char*)> completion) {
+  auto self = shared_from_this();
+  postForm(tokenEndpoint, fields, [self, completion = std::move(completion)](HttpResponse response) {
+    if (response.status < 200 || response.status >= 300) {
+      const std::string code = responseErrorCode(response);
+      completion(std::nullopt, code.c_str());
+      return;
+    }
+    auto parsed = parseTokenResponse(response, self->_clock->nowMs());
+    if (!parsed) {
+      // Some servers report OAuth errors with a 200.
+      const std::string code = responseErrorCode(response);
+      completion(std::nullopt, code.c_str());
+      return;
+    }
+    completion(std::move(parsed), "");
+  });
+}
+
+} // namespace margelo::nitro::NitroAuth
@@ -0,0 +1,150 @@
+#pragma once
+
+#include "AuthClock.hpp"
+#include "AuthResult.hpp"
+#include "AuthTokens.hpp"
+#include "AuthUser.hpp"
+#include "CancellationToken.hpp"
+#include "DeviceAuthorization.hpp"
+#include "HttpClient.hpp"
+#include "IdTokenVerifier.hpp"
+#include "LoginOptions.hpp"
+#include "OidcMetadataCache.hpp"
+#include "OidcProviderConfig.hpp"
+#include "TimerService.hpp"
+#include <NitroModules/Promise.hpp>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace margelo::nitro::NitroAuth {
+
+using namespace margelo::nitro;
+
+struct OidcAuthorizationRequest {
+  std::string url;
+  std::string state;
+  std::string nonce;
+  std::string codeVerifier;
+};
+
+struct OidcRedirect {
+  std::optional<std::string> code;
+  std::optional<std::string> state;
+  std::optional<std::string> error;
+};
+
+struct OidcTokenResponse {
+  AuthTokens tokens;
+  // Space-separated scopes granted, when the server narrows or widens the request.
+  std::optional<std::string> scope;
+};
+
+// RFC 8628 device authorization response.
+struct OidcDeviceCode {
+  std::string deviceCode;
+  // What the user needs: the code, where to enter it, and until when.
+  DeviceAuthorization authorization;
+  int64_t expiresAtMs = 0;
+  int64_t intervalMs = 0;
+};
+
+// Authorization code + PKCE (RFC 7636) against any OpenID provider, driven
+// entirely from its discovery metadata. The platform only supplies `Browser`,
+// which opens the authorization URL and resolves with the URL the provider
+// redirected to; the token exchange, refresh and id_token checks run here.
+class OidcClient : public std::enable_shared_from_this<OidcClient> {
+public:
+  using Browser =
+      std::function<std::shared_ptr<Promise<Result<std::string>>>(const std::string& url, const std::string& redirectUri)>;
+  using DeviceCodeListener = std::function<void(const DeviceAuthorization& authorization)>;
+
+  static constexpr auto kDefaultScopes = "openid profile email offline_access";
+  // RFC 8628: poll every 5 s unless told otherwise, 5 s slower after each `slow_down`.
+  static constexpr int64_t kDefaultPollIntervalMs = 5000;
+  static constexpr int64_t kSlowDownStepMs = 5000;
+  static constexpr int64_t kMaxPollIntervalMs = 60000;
+  // A server `interval` below this is raised to it, so a bogus value cannot flood the token endpoint.
+  static constexpr int64_t kMinPollIntervalMs = 1000;
+
+  // Must be owned by a shared_ptr: requests in flight keep the client alive.
+  OidcClient(OidcProviderConfig config, std::shared_ptr<HttpClient> httpClient,
+             std::shared_ptr<OidcMetadataCache> metadata, Browser browser,
+             std::shared_ptr<AuthClock> clock = AuthClock::system(),
+             std::shared_ptr<TimerService> timerService = TimerService::shared());
+
+  // RFC 3986 unreserved characters pass through; everything else is %XX.
+  static std::string percentEncode(std::string_view value);
+  static std::string formEncode(const std::vector<std::pair<std::string, std::string>>& fields);
+  // `bytes` of randomness, base64url encoded.
+  static std::string randomToken(size_t bytes = 32);
+  // S256 challenge for `codeVerifier`.
+  static std::string codeChallenge(std::string_view codeVerifier);
+  // The requested scopes, `openid` first and without duplicates.
+  static std::vector<std::string> scopesFor(const OidcProviderConfig& config,
+                                            const std::optional<std::vector<std::string>>& requested);
+  static OidcAuthorizationRequest authorizationRequest(const OidcProviderConfig& config,
+                                                      const std::string& authorizationEndpoint,
+                                                      const std::vector<std::string>& scopes,
+                                                      const std::optional<LoginOptions>& options);
+  // Reads `code`, `state` and `error` from the query or fragment of `url`.
+  static OidcRedirect parseRedirect(std::string_view url);
+  // Token endpoint response; nullopt when the body is not a token response.
+  static std::optional<OidcTokenResponse> parseTokenResponse(const HttpResponse& response, int64_t nowMs);
+  // Device authorization endpoint response; nullopt when required fields are missing.
+  static std::optional<OidcDeviceCode> parseDeviceAuthorization(const HttpResponse& response, int64_t nowMs);
+  // AuthErrorCode for an RFC 6749 `error` value.
+  static const char* errorCodeForOAuthError(std::string_view error);
+
+  // Interactive sign-in. Fails with `cancelled`, `invalid_state`, `network_error`,
+  // `token_error`, `no_id_token`, `invalid_nonce`, `parse_error` or `configuration_error`.
+  // Like the platform's, these promises settle with a Result and never reject.
+  std::shared_ptr<Promise<Result<AuthUser>>> login(const std::optional<LoginOptions>& options);
+  // Device authorization grant for devices without a usable browser. `onUserCode`
+  // gets the code to display; the token endpoint is then polled on the timer
+  // service, honoring `interval` and `slow_down`, until the user approves, denies
+  // (`cancelled`), the code expires (`timeout`) or `cancellation` fires.
+  std::shared_ptr<Promise<Result<AuthUser>>> loginWithDeviceCode(
+      const std::optional<LoginOptions>& options, DeviceCodeListener onUserCode,
+      const std::shared_ptr<CancellationToken>& cancellation = nullptr);
+  // refresh_token grant; a rotated refresh token is returned in the tokens.
+  // Non-empty `scopes` request a down-scoped access token.
+  std::shared_ptr<Promise<Result<AuthTokens>>> refresh(const std::string& refreshToken,
+                                                       const std::vector<std::string>& scopes = {});
+
+  const OidcProviderConfig& config() const { return _config; }
+
+private:
+  struct LoginState;
+  struct DeviceLogin;
+
+  void authorize(const std::shared_ptr<LoginState>& state, const std::shared_ptr<const OidcMetadata>& metadata);
+  void exchangeCode(const std::shared_ptr<LoginState>& state, const std::shared_ptr<const OidcMetadata>& metadata,
+                    const std::string& code);
+  void finishLogin(const std::shared_ptr<LoginState>& state, OidcTokenResponse response, bool retried);
+  void requestDeviceCode(const std::shared_ptr<DeviceLogin>& login, const DeviceCodeListener& onUserCode);
+  void scheduleDevicePoll(const std::shared_ptr<DeviceLogin>& login);
+  void pollDeviceToken(const std::shared_ptr<DeviceLogin>& login);
+  // Settles the device login once; later results (a late poll, a cancel) are dropped.
+  void finishDeviceLogin(const std::shared_ptr<DeviceLogin>& login, const Result<AuthUser>& result);
+  void postForm(const std::string& endpoint, const std::vector<std::pair<std::string, std::string>>& fields,
+                std::function<void(HttpResponse)> completion);
+  void postToken(const std::string& tokenEndpoint, std::vector<std::pair<std::string, std::string>> fields,
+                 std::function<void(std::optional<OidcTokenResponse>, const char*)> completion);
+
+private:
+  const OidcProviderConfig _config;
+  const std::shared_ptr<HttpClient> _httpClient;
+  const std::shared_ptr<OidcMetadataCache> _metadata;
+  const Browser _browser;
+  const std::shared_ptr<AuthClock> _clock;
+  const std::shared_ptr<TimerService> _timerService;
+  IdTokenVerifier _idTokens;
+};
+
+} // namespace margelo::nitro::NitroAuth
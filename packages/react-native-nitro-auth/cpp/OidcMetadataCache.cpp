@@ -0,0 +1,425 @@
+#include "OidcMetadataCache.hpp"
+#include "JSONReader.hpp"
+#include <algorithm>
+#include <cctype>
+#include <cerrno>
+#include <fstream>
+#include <iterator>
+#include <stdexcept>
+#include <sys/stat.h>
+
+namespace margelo::nitro::NitroAuth {
+
+namespace {
+
+constexpr std::string_view kDiscoveryPath = "/.well-known/openid-configuration";
+constexpr std::string_view kTenantPlaceholder = "{tenantid}";
+
+std::string trim(std::string_view value) {
+  size_t start = 0;
+  size_t end = value.size();
+  while (start < end && std::isspace(static_cast<unsigned char>(value[start]))) ++start;
+  while (end > start && std::isspace(static_cast<unsigned char>(value[end - 1]))) --end;
+  return std::string(value.substr(start, end - start));
+}
+
+std::string toLower(std::string value) {
+  std::transform(value.begin(), value.end(), value.begin(),
+                 [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+  return value;
+}
+
+std::optional<int64_t> parseSeconds(std::string_view value) {
+  if (value.empty() || value.size() > 12) return std::nullopt;
+  int64_t seconds = 0;
+  for (char c : value) {
+    if (c < '0' || c > '9') return std::nullopt;
+    seconds = seconds * 10 + (c - '0');
+  }
+  return seconds;
+}
+
+std::optional<std::string> header(const HttpResponse& response, const std::string& name) {
+  auto it = response.headers.find(name);
+  if (it == response.headers.end()) return std::nullopt;
+  return it->second;
+}
+
+// Error code for a failed response, or nullopt for a 2xx.
+std::optional<std::string> responseError(const HttpResponse& response) {
+  if (response.status >= 200 && response.status < 300) return std::nullopt;
+  // A 4xx means the authority or its document is wrong; retrying will not help.
+  if (response.status >= 400 && response.status < 500) return "configuration_error";
+  return "network_error";
+}
+
+bool isLoopbackHttp(std::string_view url) {
+  for (std::string_view prefix : {"http://127.0.0.1", "http://localhost", "http://[::1]"}) {
+    if (url.substr(0, prefix.size()) == prefix &&
+        (url.size() == prefix.size() || url[prefix.size()] == ':' || url[prefix.size()] == '/')) {
+      return true;
+    }
+  }
+  return false;
+}
+
+// Endpoints must be https; plain http is tolerated on loopback for local stand-ins.
+bool isAcceptableEndpoint(std::string_view url) {
+  return url.substr(0, 8) == "https://" || isLoopbackHttp(url);
+}
+
+// Multi-tenant authorities (Microsoft `common`, `organizations`) publish an issuer
+// with a `{tenantid}` placeholder standing in for one path segment.
+bool issuerMatches(const std::string& issuer, const std::string& authority) {
+  const std::string normalized = OidcMetadataCache::normalizeAuthority(issuer);
+  const size_t placeholder = normalized.find(kTenantPlaceholder);
+  if (placeholder == std::string::npos) return normalized == authority;
+  const std::string_view prefix(normalized.data(), placeholder);
+  const std::string_view suffix(normalized.data() + placeholder + kTenantPlaceholder.size(),
+                                normalized.size() - placeholder - kTenantPlaceholder.size());
+  if (authority.size() <= prefix.size() + suffix.size()) return false;
+  if (authority.compare(0, prefix.size(), prefix) != 0) return false;
+  if (authority.compare(authority.size() - suffix.size(), suffix.size(), suffix) != 0) return false;
+  const std::string_view segment(authority.data() + prefix.size(), authority.size() - prefix.size() - suffix.size());
+  return segment.find('/') == std::string_view::npos;
+}
+
+// Discovery field names; the persisted format reuses them so one reader handles both.
+bool readProviderField(std::string_view key, JSONReader& reader, OidcProviderMetadata& provider) {
+  if (key == "issuer") return reader.readString(provider.issuer);
+  if (key == "authorization_endpoint") return reader.readString(provider.authorizationEndpoint);
+  if (key == "token_endpoint") return reader.readString(provider.tokenEndpoint);
+  if (key == "jwks_uri") return reader.readString(provider.jwksUri);
+  if (key == "userinfo_endpoint") return readOptionalString(reader, provider.userinfoEndpoint);
+  if (key == "end_session_endpoint") return readOptionalString(reader, provider.endSessionEndpoint);
+  if (key == "revocation_endpoint") return readOptionalString(reader, provider.revocationEndpoint);
+  if (key == "device_authorization_endpoint") return readOptionalString(reader, provider.deviceAuthorizationEndpoint);
+  return reader.skipValue();
+}
+
+bool isValidProvider(const OidcProviderMetadata& provider, const std::string& authority) {
+  if (!issuerMatches(provider.issuer, authority)) return false;
+  for (const std::string* endpoint : {&provider.authorizationEndpoint, &provider.tokenEndpoint, &provider.jwksUri}) {
+    if (!isAcceptableEndpoint(*endpoint)) return false;
+  }
+  return true;
+}
+
+bool isValidJwks(std::string_view json) {
+  bool hasKeys = false;
+  const bool ok = readJSONObject(json, [&](std::string_view key, JSONReader& reader) {
+    if (key != "keys") return reader.skipValue();
+    hasKeys = true;
+    return reader.readArray([](JSONReader& element) { return element.peek() == '{' && element.skipValue(); });
+  });
+  return ok && hasKeys;
+}
+
+void appendField(std::string& out, std::string_view key, std::string_view value) {
+  if (out.size() > 1) out.push_back(',');
+  appendJSONString(out, key);
+  out.push_back(':');
+  appendJSONString(out, value);
+}
+
+void appendField(std::string& out, std::string_view key, const std::optional<std::string>& value) {
+  if (value) appendField(out, key, std::string_view(*value));
+}
+
+void appendField(std::string& out, std::string_view key, int64_t value) {
+  if (out.size() > 1) out.push_back(',');
+  appendJSONString(out, key);
+  out.push_back(':');
+  out += std::to_string(value);
+}
+
+bool makeDirectories(const std::string& path) {
+  for (size_t slash = path.find('/', 1); ; slash = path.find('/', slash + 1)) {
+    const std::string prefix = path.substr(0, slash);
+    if (::mkdir(prefix.c_str(), 0700) != 0 && errno != EEXIST) return false;
+    if (slash == std::string::npos) return true;
+  }
+}
+
+} // namespace
+
+OidcMetadataCache::OidcMetadataCache(std::shared_ptr<HttpClient> httpClient, OidcMetadataOptions options,
+                                     std::shared_ptr<AuthClock> clock, std::shared_ptr<TimerService> timerService)
+  : _httpClient(std::move(httpClient)),
+    _options(std::move(options)),
+    _clock(std::move(clock)),
+    _timerService(std::move(timerService)) {}
+
+std::string OidcMetadataCache::normalizeAuthority(const std::string& authority) {
+  std::string normalized = trim(authority);
+  while (!normalized.empty() && normalized.back() == '/') normalized.pop_back();
+  return normalized;
+}
+
+std::optional<int64_t> OidcMetadataCache::lifetimeMs(const HttpResponse& response, int64_t nowMs) {
+  if (auto cacheControl = header(response, "cache-control")) {
+    std::optional<int64_t> maxAge;
+    size_t start = 0;
+    while (start <= cacheControl->size()) {
+      size_t end = cacheControl->find(',', start);
+      if (end == std::string::npos) end = cacheControl->size();
+      const std::string directive = toLower(trim(std::string_view(*cacheControl).substr(start, end - start)));
+      if (directive == "no-store" || directive == "no-cache") return 0;
+      if (directive.rfind("max-age=", 0) == 0) maxAge = parseSeconds(std::string_view(directive).substr(8));
+      start = end + 1;
+    }
+    if (maxAge) {
+      auto age = header(response, "age");
+      const int64_t ageSeconds = age ? parseSeconds(trim(*age)).value_or(0) : 0;
+      return std::max<int64_t>(0, *maxAge - ageSeconds) * 1000;
+    }
+  }
+  if (auto expires = header(response, "expires")) {
+    auto expiresMs = parseHttpDateMs(trim(*expires));
+    // RFC 9111: an invalid Expires value means "already expired".
+    if (!expiresMs) return 0;
+    auto date = header(response, "date");
+    const int64_t baseMs = date ? parseHttpDateMs(trim(*date)).value_or(nowMs) : nowMs;
+    return std::max<int64_t>(0, *expiresMs - baseMs);
+  }
+  return std::nullopt;
+}
+
+std::shared_ptr<Promise<Result<std::shared_ptr<const OidcMetadata>>>> OidcMetadataCache::get(const std::string& authority) {
+  const std::string key = normalizeAuthority(authority);
+  if (key.empty()) {
+    auto promise = MetadataPromise::create();
+    promise->resolve(AuthErrorCode::CONFIGURATION_ERROR);
+    return promise;
+  }
+
+  std::shared_ptr<const OidcMetadata> fresh;
+  std::shared_ptr<MetadataPromise> pending;
+  {
+    std::lock_guard<std::mutex> lock(_mutex);
+    Entry& entry = entryLocked(key);
+    if (entry.metadata && _clock->nowMs() < entry.metadata->expiresAtMs) {
+      _stats.hits++;
+      fresh = entry.metadata;
+    } else {
+      _stats.misses++;
+      if (entry.pending) return entry.pending;
+      entry.pending = MetadataPromise::create();
+      pending = entry.pending;
+      _stats.fetches++;
+    }
+  }
+
+  if (fresh) {
+    auto promise = MetadataPromise::create();
+    promise->resolve(fresh);
+    return promise;
+  }
+  fetch(key);
+  return pending;
+}
+
+std::shared_ptr<const OidcMetadata> OidcMetadataCache::peek(const std::string& authority) {
+  std::lock_guard<std::mutex> lock(_mutex);
+  auto it = _entries.find(normalizeAuthority(authority));
+  return it == _entries.end() ? nullptr : it->second.metadata;
+}
+
+void OidcMetadataCache::prefetch(const std::vector<std::string>& authorities) {
+  std::weak_ptr<OidcMetadataCache> weakSelf = weak_from_this();
+  for (const auto& authority : authorities) {
+    _timerService->schedule(0, [weakSelf, authority]() {
+      if (auto self = weakSelf.lock()) self->get(authority);
+    });
+  }
+}
+
+void OidcMetadataCache::invalidate(const std::string& authority) {
+  std::lock_guard<std::mutex> lock(_mutex);
+  auto it = _entries.find(normalizeAuthority(authority));
+  if (it == _entries.end() || !it->second.metadata) return;
+  auto expired = std::make_shared<OidcMetadata>(*it->second.metadata);
+  expired->expiresAtMs = 0;
+  it->second.metadata = std::move(expired);
+}
+
+OidcMetadataStats OidcMetadataCache::stats() {
+  std::lock_guard<std::mutex> lock(_mutex);
+  return _stats;
+}
+
+OidcMetadataCache::Entry& OidcMetadataCache::entryLocked(const std::string& authority) {
+  Entry& entry = _entries[authority];
+  if (!entry.diskChecked) {
+    entry.diskChecked = true;
+    if (auto stored = loadFromDisk(authority)) {
+      _stats.diskLoads++;
+      if (!entry.metadata) entry.metadata = std::move(stored);
+    }
+  }
+  return entry;
+}
+
+void OidcMetadataCache::fetch(const std::string& authority) {
+  if (!_httpClient) {
+    fail(authority, "network_error");
+    return;
+  }
+  HttpRequest request;
+  request.url = authority + std::string(kDiscoveryPath);
+  request.headers.emplace_back("Accept", "application/json");
+  auto self = shared_from_this();
+  _httpClient->send(request, [self, authority](HttpResponse response) {
+    if (auto error = responseError(response)) {
+      self->fail(authority, *error);
+      return;
+    }
+    OidcProviderMetadata provider;
+    const bool parsed = readJSONObject(response.body, [&](std::string_view key, JSONReader& reader) {
+      return readProviderField(key, reader, provider);
+    });
+    if (!parsed) {
+      self->fail(authority, "parse_error");
+      return;
+    }
+    if (!isValidProvider(provider, authority)) {
+      self->fail(authority, "configuration_error");
+      return;
+    }
+    const int64_t ttlMs = self->clampTtl(lifetimeMs(response, self->_clock->nowMs()));
+    self->fetchJwks(authority, std::move(provider), ttlMs);
+  });
+}
+
+void OidcMetadataCache::fetchJwks(const std::string& authority, OidcProviderMetadata provider, int64_t discoveryTtlMs) {
+  HttpRequest request;
+  request.url = provider.jwksUri;
+  request.headers.emplace_back("Accept", "application/json");
+  auto self = shared_from_this();
+  auto shared = std::make_shared<OidcProviderMetadata>(std::move(provider));
+  _httpClient->send(request, [self, authority, shared, discoveryTtlMs](HttpResponse response) {
+    if (auto error = responseError(response)) {
+      self->fail(authority, *error);
+      return;
+    }
+    if (!isValidJwks(response.body)) {
+      self->fail(authority, "parse_error");
+      return;
+    }
+    const int64_t nowMs = self->_clock->nowMs();
+    const int64_t ttlMs = std::min(discoveryTtlMs, self->clampTtl(lifetimeMs(response, nowMs)));
+    auto metadata = std::make_shared<OidcMetadata>();
+    metadata->authority = authority;
+    metadata->provider = std::move(*shared);
+    metadata->jwks = std::move(response.body);
+    metadata->fetchedAtMs = nowMs;
+    metadata->expiresAtMs = nowMs + ttlMs;
+    self->complete(authority, std::move(metadata));
+  });
+}
+
+void OidcMetadataCache::complete(const std::string& authority, std::shared_ptr<const OidcMetadata> metadata) {
+  std::shared_ptr<MetadataPromise> pending;
+  {
+    std::lock_guard<std::mutex> lock(_mutex);
+    Entry& entry = _entries[authority];
+    entry.metadata = metadata;
+    pending = std::move(entry.pending);
+    entry.pending = nullptr;
+  }
+  // Runs on the HTTP completion thread, never the caller's.
+  saveToDisk(*metadata);
+  if (pending) pending->resolve(metadata);
+}
+
+void OidcMetadataCache::fail(const std::string& authority, const std::string& error) {
+  std::shared_ptr<MetadataPromise> pending;
+  std::shared_ptr<const OidcMetadata> stale;
+  {
+    std::lock_guard<std::mutex> lock(_mutex);
+    _stats.fetchErrors++;
+    Entry& entry = _entries[authority];
+    stale = entry.metadata;
+    if (stale) _stats.staleHits++;
+    pending = std::move(entry.pending);
+    entry.pending = nullptr;
+  }
+  if (!pending) return;
+  if (stale) {
+    pending->resolve(stale);
+  } else {
+    pending->resolve(AuthError(error));
+  }
+}
+
+int64_t OidcMetadataCache::clampTtl(std::optional<int64_t> ttlMs) const {
+  return std::clamp(ttlMs.value_or(_options.defaultTtlMs), _options.minTtlMs, _options.maxTtlMs);
+}
+
+std::string OidcMetadataCache::pathFor(const std::string& authority) const {
+  // FNV-1a keeps file names short and filesystem-safe; the stored authority
+  // is compared on load, so a collision only costs a refetch.
+  uint64_t hash = 14695981039346656037ULL;
+  for (char c : authority) {
+    hash ^= static_cast<unsigned char>(c);
+    hash *= 1099511628211ULL;
+  }
+  char name[32];
+  std::snprintf(name, sizeof(name), "oidc-%016llx.json", static_cast<unsigned long long>(hash));
+  return _options.cacheDirectory + "/" + name;
+}
+
+std::shared_ptr<const OidcMetadata> OidcMetadataCache::loadFromDisk(const std::string& authority) const {
+  if (_options.cacheDirectory.empty()) return nullptr;
+  std::ifstream file(pathFor(authority), std::ios::binary);
+  if (!file) return nullptr;
+  const std::string json((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+
+  auto metadata = std::make_shared<OidcMetadata>();
+  double fetchedAt = 0;
+  double expiresAt = 0;
+  const bool ok = readJSONObject(json, [&](std::string_view key, JSONReader& reader) {
+    if (key == "nitro_authority") return reader.readString(metadata->authority);
+    if (key == "nitro_jwks") return reader.readString(metadata->jwks);
+    if (key == "nitro_fetched_at") return reader.readNumber(fetchedAt);
+    if (key == "nitro_expires_at") return reader.readNumber(expiresAt);
+    return readProviderField(key, reader, metadata->provider);
+  });
+  if (!ok || metadata->authority != authority || !isValidProvider(metadata->provider, authority) ||
+      !isValidJwks(metadata->jwks)) {
+    return nullptr;
+  }
+  metadata->fetchedAtMs = static_cast<int64_t>(fetchedAt);
+  metadata->expiresAtMs = static_cast<int64_t>(expiresAt);
+  return metadata;
+}
+
+void OidcMetadataCache::saveToDisk(const OidcMetadata& metadata) const {
+  if (_options.cacheDirectory.empty() || !makeDirectories(_options.cacheDirectory)) return;
+  std::string json = "{";
+  appendField(json, "nitro_authority", std::string_view(metadata.authority));
+  appendField(json, "issuer", std::string_view(metadata.provider.issuer));
+  appendField(json, "authorization_endpoint", std::string_view(metadata.provider.authorizationEndpoint));
+  appendField(json, "token_endpoint", std::string_view(metadata.provider.tokenEndpoint));
+  appendField(json, "jwks_uri", std::string_view(metadata.provider.jwksUri));
+  appendField(json, "userinfo_endpoint", metadata.provider.userinfoEndpoint);
+  appendField(json, "end_session_endpoint", metadata.provider.endSessionEndpoint);
+  appendField(json, "revocation_endpoint", metadata.provider.revocationEndpoint);
+  appendField(json, "device_authorization_endpoint", metadata.provider.deviceAuthorizationEndpoint);
+  appendField(json, "nitro_jwks", std::string_view(metadata.jwks));
+  appendField(json, "nitro_fetched_at", metadata.fetchedAtMs);
+  appendField(json, "nitro_expires_at", metadata.expiresAtMs);
+  json.push_back('}');
+
+  // Write-to-temp + rename so a reader never sees a torn file. No fsync: losing
+  // the cache only costs a refetch.
+  const std::string path = pathFor(metadata.authority);
+  const std::string temporary = path + ".tmp";
+  {
+    std::ofstream file(temporary, std::ios::binary | std::ios::trunc);
+    if (!file.write(json.data(), static_cast<std::streamsize>(json.size()))) return;
+  }
+  std::rename(temporary.c_str(), path.c_str());
+}
+
+} // namespace margelo::nitro::NitroAuth
@@ -0,0 +1,126 @@
+#pragma once
+
+#include "AuthClock.hpp"
+#include "AuthResult.hpp"
+#include "HttpClient.hpp"
+#include "TimerService.hpp"
+#include <NitroModules/Promise.hpp>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace margelo::nitro::NitroAuth {
+
+using namespace margelo::nitro;
+
+struct OidcProviderMetadata {
+  std::string issuer;
+  std::string authorizationEndpoint;
+  std::string tokenEndpoint;
+  std::string jwksUri;
+  std::optional<std::string> userinfoEndpoint;
+  std::optional<std::string> endSessionEndpoint;
+  std::optional<std::string> revocationEndpoint;
+  std::optional<std::string> deviceAuthorizationEndpoint;
+};
+
+struct OidcMetadata {
+  // Normalized authority the entry is keyed by (no trailing '/').
+  std::string authority;
+  OidcProviderMetadata provider;
+  // Raw JWKS document fetched from `provider.jwksUri`.
+  std::string jwks;
+  int64_t fetchedAtMs = 0;
+  // The sooner of the discovery and JWKS lifetimes.
+  int64_t expiresAtMs = 0;
+};
+
+struct OidcMetadataOptions {
+  // Entries are persisted here, one file per authority; empty keeps them in memory only.
+  std::string cacheDirectory;
+  // Used when a response carries no Cache-Control max-age or Expires header.
+  int64_t defaultTtlMs = 24 * 60 * 60 * 1000;
+  // Server lifetimes are clamped into [minTtlMs, maxTtlMs].
+  int64_t minTtlMs = 5 * 60 * 1000;
+  int64_t maxTtlMs = 7 * 24 * 60 * 60 * 1000;
+};
+
+struct OidcMetadataStats {
+  uint64_t hits = 0;
+  uint64_t misses = 0;
+  uint64_t fetches = 0;
+  uint64_t fetchErrors = 0;
+  // Expired entries handed out because a refetch failed.
+  uint64_t staleHits = 0;
+  uint64_t diskLoads = 0;
+};
+
+// Cache of OpenID discovery documents and their JWKS, keyed by authority.
+//
+// Lifetimes follow the HTTP caching headers of both responses. Concurrent
+// lookups of one authority share a single fetch, and a failed refetch falls
+// back to the expired entry rather than failing sign-in while the provider is
+// unreachable. Entries are written through to `cacheDirectory` so a cold start
+// with a fresh entry on disk needs no network at all.
+class OidcMetadataCache : public std::enable_shared_from_this<OidcMetadataCache> {
+public:
+  // Must be owned by a shared_ptr: fetches and prefetches keep the cache alive.
+  OidcMetadataCache(std::shared_ptr<HttpClient> httpClient, OidcMetadataOptions options = {},
+                    std::shared_ptr<AuthClock> clock = AuthClock::system(),
+                    std::shared_ptr<TimerService> timerService = TimerService::shared());
+
+  // Trims whitespace and trailing '/'; the discovery document lives at
+  // `<authority>/.well-known/openid-configuration`.
+  static std::string normalizeAuthority(const std::string& authority);
+  // Lifetime granted by Cache-Control max-age (minus Age) or Expires (relative
+  // to Date, else `nowMs`); nullopt when the response carries neither.
+  static std::optional<int64_t> lifetimeMs(const HttpResponse& response, int64_t nowMs);
+
+  // Resolves immediately for a fresh entry. Fails with `network_error`,
+  // `parse_error` or `configuration_error` when nothing usable is cached.
+  std::shared_ptr<Promise<Result<std::shared_ptr<const OidcMetadata>>>> get(const std::string& authority);
+  // The cached entry, fresh or expired, without touching the network or disk.
+  std::shared_ptr<const OidcMetadata> peek(const std::string& authority);
+  // Loads or fetches each authority on the timer thread.
+  void prefetch(const std::vector<std::string>& authorities);
+  // Marks the entry expired so the next get() refetches, e.g. after a signing
+  // key rotation. The old entry remains the fallback.
+  void invalidate(const std::string& authority);
+
+  OidcMetadataStats stats();
+
+private:
+  using MetadataPromise = Promise<Result<std::shared_ptr<const OidcMetadata>>>;
+
+  struct Entry {
+    std::shared_ptr<const OidcMetadata> metadata;
+    std::shared_ptr<MetadataPromise> pending;
+    bool diskChecked = false;
+  };
+
+  Entry& entryLocked(const std::string& authority);
+  void fetch(const std::string& authority);
+  void fetchJwks(const std::string& authority, OidcProviderMetadata provider, int64_t discoveryTtlMs);
+  void complete(const std::string& authority, std::shared_ptr<const OidcMetadata> metadata);
+  void fail(const std::string& authority, const std::string& error);
+  int64_t clampTtl(std::optional<int64_t> ttlMs) const;
+  std::string pathFor(const std::string& authority) const;
+  std::shared_ptr<const OidcMetadata> loadFromDisk(const std::string& authority) const;
+  void saveToDisk(const OidcMetadata& metadata) const;
+
+private:
+  const std::shared_ptr<HttpClient> _httpClient;
+  const OidcMetadataOptions _options;
+  const std::shared_ptr<AuthClock> _clock;
+  const std::shared_ptr<TimerService> _timerService;
+
+  std::mutex _mutex;
+  std::unordered_map<std::string, Entry> _entries;
+  OidcMetadataStats _stats;
+};
+
+} // namespace margelo::nitro::NitroAuth
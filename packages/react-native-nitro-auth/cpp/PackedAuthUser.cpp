@@ -0,0 +1,249 @@
+#include "PackedAuthUser.hpp"
+#include "MemoryAccounting.hpp"
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <deque>
+#include <mutex>
+#include <new>
+#include <unordered_map>
+
+namespace margelo::nitro::NitroAuth {
+
+namespace {
+
+constexpr uint8_t kHasExpiration = 1 << 0;
+constexpr uint8_t kHasScopes = 1 << 1;
+
+struct ScopeStore {
+  std::mutex mutex;
+  // Deque: interned strings never move, so the map can key on views of them.
+  std::deque<std::string> scopes;
+  std::unordered_map<std::string_view, uint32_t> ids;
+};
+
+ScopeStore& scopeStore() {
+  static ScopeStore store;
+  return store;
+}
+
+std::optional<std::string> copyOf(const std::optional<std::string_view>& view) {
+  return view ? std::make_optional(std::string(*view)) : std::nullopt;
+}
+
+std::optional<std::string_view> viewOf(const std::optional<std::string>& value) {
+  return value ? std::make_optional(std::string_view(*value)) : std::nullopt;
+}
+
+std::optional<std::vector<uint32_t>> internAll(const std::optional<std::vector<std::string>>& scopes) {
+  if (!scopes) return std::nullopt;
+  std::vector<uint32_t> ids;
+  ids.reserve(scopes->size());
+  for (const auto& scope : *scopes) ids.push_back(ScopeTable::intern(scope));
+  return ids;
+}
+
+} // namespace
+
+uint32_t ScopeTable::intern(std::string_view scope) {
+  auto& store = scopeStore();
+  std::lock_guard<std::mutex> lock(store.mutex);
+  if (auto it = store.ids.find(scope); it != store.ids.end()) return it->second;
+  const auto id = static_cast<uint32_t>(store.scopes.size());
+  store.ids.emplace(store.scopes.emplace_back(scope), id);
+  return id;
+}
+
+std::string ScopeTable::scope(uint32_t id) {
+  auto& store = scopeStore();
+  std::lock_guard<std::mutex> lock(store.mutex);
+  return id < store.scopes.size() ? store.scopes[id] : std::string();
+}
+
+size_t ScopeTable::size() {
+  auto& store = scopeStore();
+  std::lock_guard<std::mutex> lock(store.mutex);
+  return store.scopes.size();
+}
+
+struct PackedAuthUser::Header {
+  uint64_t revision = 0;
+  double expirationTime = 0;
+  // End of each field in the byte area; a field starts where the previous one ends.
+  uint32_t ends[kAuthUserFieldCount] = {};
+  // As wide as the scope ids, so no scope list is ever cut short.
+  uint32_t scopeCount = 0;
+  uint16_t present = 0;
+  uint8_t provider = 0;
+  uint8_t flags = 0;
+};
+
+PackedAuthUser::PackedAuthUser(const AuthUser& user) {
+  FieldViews fields = {
+      viewOf(user.email),          viewOf(user.name),           viewOf(user.photo),
+      viewOf(user.idToken),        viewOf(user.accessToken),    viewOf(user.refreshToken),
+      viewOf(user.serverAuthCode), viewOf(user.authorizationCode), viewOf(user.userId),
+      viewOf(user.phoneNumber),    viewOf(user.hostedDomain),   viewOf(user.underlyingError),
+  };
+  *this = build(user.provider, fields, internAll(user.scopes), user.expirationTime);
+}
+
+PackedAuthUser PackedAuthUser::build(AuthProvider provider, const FieldViews& fields,
+                                     const std::optional<std::vector<uint32_t>>& scopeIds,
+                                     std::optional<double> expirationTime) {
+  static std::atomic<uint64_t> nextRevision{1};
+  Header header;
+  header.revision = nextRevision.fetch_add(1, std::memory_order_relaxed);
+  header.provider = static_cast<uint8_t>(provider);
+  if (expirationTime) {
+    header.flags |= kHasExpiration;
+    header.expirationTime = *expirationTime;
+  }
+  if (scopeIds) {
+    header.flags |= kHasScopes;
+    header.scopeCount = static_cast<uint32_t>(scopeIds->size());
+  }
+  uint32_t end = 0;
+  for (size_t i = 0; i < kAuthUserFieldCount; i++) {
+    if (fields[i]) {
+      header.present |= static_cast<uint16_t>(1u << i);
+      end += static_cast<uint32_t>(fields[i]->size());
+    }
+    header.ends[i] = end;
+  }
+
+  const size_t scopeOffset = sizeof(Header);
+  const size_t bytesOffset = scopeOffset + header.scopeCount * sizeof(uint32_t);
+  const size_t bytes = bytesOffset + end;
+  auto words = std::allocate_shared<uint64_t[]>(TrackedAllocator<uint64_t, MemorySubsystem::SESSIONS>(),
+                                               (bytes + sizeof(uint64_t) - 1) / sizeof(uint64_t));
+  auto* base = reinterpret_cast<char*>(words.get());
+  new (base) Header(header);
+  if (header.scopeCount > 0) std::memcpy(base + scopeOffset, scopeIds->data(), header.scopeCount * sizeof(uint32_t));
+  char* out = base + bytesOffset;
+  for (const auto& field : fields) {
+    if (field && !field->empty()) {
+      std::memcpy(out, field->data(), field->size());
+      out += field->size();
+    }
+  }
+
+  PackedAuthUser packed;
+  packed._words = std::move(words);
+  packed._bytes = bytes;
+  return packed;
+}
+
+const PackedAuthUser::Header* PackedAuthUser::header() const {
+  return _words ? std::launder(reinterpret_cast<const Header*>(_words.get())) : nullptr;
+}
+
+AuthProvider PackedAuthUser::provider() const {
+  const auto* h = header();
+  return static_cast<AuthProvider>(h ? h->provider : 0);
+}
+
+bool PackedAuthUser::has(AuthUserField field) const {
+  const auto* h = header();
+  return h && (h->present & (1u << static_cast<size_t>(field))) != 0;
+}
+
+std::optional<std::string_view> PackedAuthUser::view(AuthUserField field) const {
+  if (!has(field)) return std::nullopt;
+  const auto* h = header();
+  const auto index = static_cast<size_t>(field);
+  const uint32_t start = index == 0 ? 0 : h->ends[index - 1];
+  const char* bytes = reinterpret_cast<const char*>(_words.get()) + sizeof(Header) + h->scopeCount * sizeof(uint32_t);
+  return std::string_view(bytes + start, h->ends[index] - start);
+}
+
+std::optional<std::string> PackedAuthUser::get(AuthUserField field) const {
+  return copyOf(view(field));
+}
+
+std::optional<std::vector<uint32_t>> PackedAuthUser::scopeIds() const {
+  const auto* h = header();
+  if (!h || (h->flags & kHasScopes) == 0) return std::nullopt;
+  std::vector<uint32_t> ids(h->scopeCount);
+  if (!ids.empty()) {
+    std::memcpy(ids.data(), reinterpret_cast<const char*>(_words.get()) + sizeof(Header), ids.size() * sizeof(uint32_t));
+  }
+  return ids;
+}
+
+std::optional<std::vector<std::string>> PackedAuthUser::scopes() const {
+  auto ids = scopeIds();
+  if (!ids) return std::nullopt;
+  std::vector<std::string> scopes;
+  scopes.reserve(ids->size());
+  for (uint32_t id : *ids) scopes.push_back(ScopeTable::scope(id));
+  return scopes;
+}
+
+std::optional<double> PackedAuthUser::expirationTime() const {
+  const auto* h = header();
+  if (!h || (h->flags & kHasExpiration) == 0) return std::nullopt;
+  return h->expirationTime;
+}
+
+PackedAuthUser::FieldViews PackedAuthUser::views() const {
+  FieldViews fields;
+  for (size_t i = 0; i < kAuthUserFieldCount; i++) fields[i] = view(static_cast<AuthUserField>(i));
+  return fields;
+}
+
+AuthUser PackedAuthUser::unpack() const {
+  AuthUser user;
+  user.provider = provider();
+  user.email = get(AuthUserField::EMAIL);
+  user.name = get(AuthUserField::NAME);
+  user.photo = get(AuthUserField::PHOTO);
+  user.idToken = get(AuthUserField::ID_TOKEN);
+  user.accessToken = get(AuthUserField::ACCESS_TOKEN);
+  user.refreshToken = get(AuthUserField::REFRESH_TOKEN);
+  user.serverAuthCode = get(AuthUserField::SERVER_AUTH_CODE);
+  user.authorizationCode = get(AuthUserField::AUTHORIZATION_CODE);
+  user.userId = get(AuthUserField::USER_ID);
+  user.phoneNumber = get(AuthUserField::PHONE_NUMBER);
+  user.hostedDomain = get(AuthUserField::HOSTED_DOMAIN);
+  user.scopes = scopes();
+  user.expirationTime = expirationTime();
+  user.underlyingError = get(AuthUserField::UNDERLYING_ERROR);
+  return user;
+}
+
+// Edits read views of this buffer while building the next; `*this` keeps it alive.
+PackedAuthUser PackedAuthUser::with(AuthUserField field, std::optional<std::string_view> value) const {
+  auto fields = views();
+  fields[static_cast<size_t>(field)] = value;
+  return build(provider(), fields, scopeIds(), expirationTime());
+}
+
+PackedAuthUser PackedAuthUser::withScopes(const std::optional<std::vector<std::string>>& scopes) const {
+  return build(provider(), views(), internAll(scopes), expirationTime());
+}
+
+PackedAuthUser PackedAuthUser::withTokens(const AuthTokens& tokens) const {
+  auto fields = views();
+  if (tokens.accessToken) fields[static_cast<size_t>(AuthUserField::ACCESS_TOKEN)] = *tokens.accessToken;
+  if (tokens.idToken) fields[static_cast<size_t>(AuthUserField::ID_TOKEN)] = *tokens.idToken;
+  if (tokens.refreshToken) fields[static_cast<size_t>(AuthUserField::REFRESH_TOKEN)] = *tokens.refreshToken;
+  return build(provider(), fields, scopeIds(), tokens.expirationTime ? tokens.expirationTime : expirationTime());
+}
+
+uint64_t PackedAuthUser::revision() const {
+  const auto* h = header();
+  return h ? h->revision : 0;
+}
+
+size_t PackedAuthUser::packedBytes() const {
+  return _bytes;
+}
+
+bool operator==(const PackedAuthUser& lhs, const PackedAuthUser& rhs) {
+  if (lhs._words == rhs._words) return true;
+  return lhs.provider() == rhs.provider() && lhs.views() == rhs.views() && lhs.scopeIds() == rhs.scopeIds() &&
+         lhs.expirationTime() == rhs.expirationTime();
+}
+
+} // namespace margelo::nitro::NitroAuth
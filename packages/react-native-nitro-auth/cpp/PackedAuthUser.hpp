@@ -0,0 +1,93 @@
+#pragma once
+
+#include "AuthTokens.hpp"
+#include "AuthUser.hpp"
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace margelo::nitro::NitroAuth {
+
+// The string fields of AuthUser, in their generated order.
+enum class AuthUserField : uint8_t {
+  EMAIL,
+  NAME,
+  PHOTO,
+  ID_TOKEN,
+  ACCESS_TOKEN,
+  REFRESH_TOKEN,
+  SERVER_AUTH_CODE,
+  AUTHORIZATION_CODE,
+  USER_ID,
+  PHONE_NUMBER,
+  HOSTED_DOMAIN,
+  UNDERLYING_ERROR,
+};
+
+inline constexpr size_t kAuthUserFieldCount = static_cast<size_t>(AuthUserField::UNDERLYING_ERROR) + 1;
+
+// Process-wide scope interning. Apps request a handful of distinct scopes, so
+// entries are never freed. Thread-safe.
+class ScopeTable {
+public:
+  static uint32_t intern(std::string_view scope);
+  static std::string scope(uint32_t id);
+  static size_t size();
+};
+
+// Immutable session user in one allocation: a fixed header with field end
+// offsets, a presence bitmap and the expiry, then interned scope ids, then the
+// field bytes back to back. Copies share the buffer, so handing a session
+// around is a reference count bump; edits build a new buffer. Convert to
+// AuthUser only where the generated type is required (JSI, platform, stores).
+class PackedAuthUser {
+public:
+  PackedAuthUser() = default;
+  explicit PackedAuthUser(const AuthUser& user);
+
+  AuthUser unpack() const;
+
+  AuthProvider provider() const;
+  bool has(AuthUserField field) const;
+  // Views into the shared buffer; valid while any copy of this user lives.
+  std::optional<std::string_view> view(AuthUserField field) const;
+  std::optional<std::string> get(AuthUserField field) const;
+  std::optional<std::vector<std::string>> scopes() const;
+  std::optional<double> expirationTime() const;
+
+  PackedAuthUser with(AuthUserField field, std::optional<std::string_view> value) const;
+  PackedAuthUser withScopes(const std::optional<std::vector<std::string>>& scopes) const;
+  // Applies a refresh result; fields missing from `tokens` are kept.
+  PackedAuthUser withTokens(const AuthTokens& tokens) const;
+
+  // True for copies of one packed user; edits and separately packed equal users differ.
+  bool isSameSnapshot(const PackedAuthUser& other) const { return _words && _words == other._words; }
+  // Process-wide unique per packed buffer, never reused; 0 for an empty user.
+  uint64_t revision() const;
+  // Bytes of the shared buffer, header included.
+  size_t packedBytes() const;
+
+  friend bool operator==(const PackedAuthUser& lhs, const PackedAuthUser& rhs);
+
+private:
+  struct Header;
+  using FieldViews = std::array<std::optional<std::string_view>, kAuthUserFieldCount>;
+
+  // `scopeIds` nullopt: no scopes field.
+  static PackedAuthUser build(AuthProvider provider, const FieldViews& fields,
+                              const std::optional<std::vector<uint32_t>>& scopeIds, std::optional<double> expirationTime);
+  const Header* header() const;
+  FieldViews views() const;
+  std::optional<std::vector<uint32_t>> scopeIds() const;
+
+private:
+  std::shared_ptr<const uint64_t[]> _words;
+  size_t _bytes = 0;
+};
+
+} // namespace margelo::nitro::NitroAuth
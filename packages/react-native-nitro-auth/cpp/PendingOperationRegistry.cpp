@@ -0,0 +1,97 @@
+#include "PendingOperationRegistry.hpp"
+
+namespace margelo::nitro::NitroAuth {
+
+void PendingOperationRegistry::track(const std::shared_ptr<Promise<void>>& promise) {
+  Handle handle;
+  {
+    std::lock_guard<std::mutex> lock(_mutex);
+    handle = insertLocked(promise);
+  }
+  // Attached outside the lock: a promise that already settled calls back right away.
+  std::weak_ptr<PendingOperationRegistry> weak = weak_from_this();
+  promise->addOnResolvedListener([weak, handle]() {
+    if (auto registry = weak.lock()) registry->remove(handle);
+  });
+  promise->addOnRejectedListener([weak, handle](const std::exception_ptr&) {
+    if (auto registry = weak.lock()) registry->remove(handle);
+  });
+}
+
+std::vector<std::shared_ptr<Promise<void>>> PendingOperationRegistry::takeAll() {
+  std::lock_guard<std::mutex> lock(_mutex);
+  std::vector<std::shared_ptr<Promise<void>>> pending;
+  pending.reserve(_size);
+  for (uint32_t index = _head; index != kNone; index = _slots[index].next) {
+    pending.push_back(std::move(_slots[index].promise));
+  }
+  _head = _tail = kNone;
+  _size = 0;
+  resetIfEmptyLocked();
+  return pending;
+}
+
+size_t PendingOperationRegistry::size() const {
+  std::lock_guard<std::mutex> lock(_mutex);
+  return _size;
+}
+
+PendingOperationRegistry::Handle PendingOperationRegistry::insertLocked(std::shared_ptr<Promise<void>> promise) {
+  uint32_t index = _free;
+  if (index != kNone) {
+    _free = _slots[index].next;
+  } else {
+    index = static_cast<uint32_t>(_slots.size());
+    _slots.emplace_back();
+  }
+  auto& slot = _slots[index];
+  slot.promise = std::move(promise);
+  slot.generation = _nextGeneration++;
+  slot.prev = _tail;
+  slot.next = kNone;
+  if (_tail != kNone) {
+    _slots[_tail].next = index;
+  } else {
+    _head = index;
+  }
+  _tail = index;
+  _size++;
+  return Handle{index, slot.generation};
+}
+
+void PendingOperationRegistry::remove(Handle handle) {
+  std::shared_ptr<Promise<void>> released;
+  std::lock_guard<std::mutex> lock(_mutex);
+  if (handle.index >= _slots.size() || _slots[handle.index].generation != handle.generation) return;
+  auto& slot = _slots[handle.index];
+  if (slot.prev != kNone) {
+    _slots[slot.prev].next = slot.next;
+  } else {
+    _head = slot.next;
+  }
+  if (slot.next != kNone) {
+    _slots[slot.next].prev = slot.prev;
+  } else {
+    _tail = slot.prev;
+  }
+  // The promise is settling right now; its last reference must not drop under the lock.
+  released = std::move(slot.promise);
+  slot.generation = 0;
+  slot.next = _free;
+  _free = handle.index;
+  _size--;
+  resetIfEmptyLocked();
+}
+
+void PendingOperationRegistry::resetIfEmptyLocked() {
+  if (_size > 0) return;
+  _free = kNone;
+  if (_slots.capacity() > kRetainedSlots) {
+    // Returns the memory of a burst once it has drained.
+    decltype(_slots)().swap(_slots);
+  } else {
+    _slots.clear();
+  }
+}
+
+} // namespace margelo::nitro::NitroAuth
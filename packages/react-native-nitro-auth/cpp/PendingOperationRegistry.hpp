@@ -0,0 +1,62 @@
+#pragma once
+
+#include "MemoryAccounting.hpp"
+#include <NitroModules/Promise.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace margelo::nitro::NitroAuth {
+
+using namespace margelo::nitro;
+
+// Session promises that a new session must cancel. Each tracked promise takes a
+// slot in a slab whose prev/next links form a doubly linked list, and leaves it
+// in O(1) when it settles, so a burst of queued calls costs no scans. takeAll()
+// walks only the live slots. Handles carry a generation, so settling after
+// takeAll() is a no-op. Thread-safe on its own; settle listeners only take the
+// registry's leaf lock, never the caller's.
+class PendingOperationRegistry : public std::enable_shared_from_this<PendingOperationRegistry> {
+public:
+  // Keeps `promise` until it settles or takeAll() hands it out.
+  void track(const std::shared_ptr<Promise<void>>& promise);
+  // Oldest first; the caller rejects them outside its own locks.
+  std::vector<std::shared_ptr<Promise<void>>> takeAll();
+  size_t size() const;
+
+private:
+  struct Handle {
+    uint32_t index;
+    uint64_t generation;
+  };
+
+  struct Slot {
+    std::shared_ptr<Promise<void>> promise;
+    uint64_t generation = 0;
+    uint32_t prev;
+    uint32_t next;
+  };
+
+  static constexpr uint32_t kNone = UINT32_MAX;
+  // Capacity kept across drains; anything above is a burst and is released.
+  static constexpr size_t kRetainedSlots = 64;
+
+  Handle insertLocked(std::shared_ptr<Promise<void>> promise);
+  void remove(Handle handle);
+  void resetIfEmptyLocked();
+
+private:
+  mutable std::mutex _mutex;
+  std::vector<Slot, TrackedAllocator<Slot, MemorySubsystem::PENDING_OPERATIONS>> _slots;
+  uint32_t _head = kNone;
+  uint32_t _tail = kNone;
+  // Free slots, chained through `next`.
+  uint32_t _free = kNone;
+  size_t _size = 0;
+  // Never reused, so handles from before a reset cannot match a new slot.
+  uint64_t _nextGeneration = 1;
+};
+
+} // namespace margelo::nitro::NitroAuth
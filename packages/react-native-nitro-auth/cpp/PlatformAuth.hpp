@@ -1,8 +1,10 @@
 #pragma once
 
 #include "AuthProvider.hpp"
+#include "AuthResult.hpp"
 #include "AuthUser.hpp"
 #include "AuthTokens.hpp"
+#include "HttpClient.hpp"
 #include "LoginOptions.hpp"
 #include <NitroModules/Promise.hpp>
 #include <memory>
@@ -13,15 +15,42 @@ namespace margelo::nitro::NitroAuth {
 
 using namespace margelo::nitro;
 
+enum class PlatformOperation {
+  LOGIN,
+  REQUEST_SCOPES,
+  REFRESH_TOKEN,
+  SILENT_RESTORE,
+};
+
+// Every call settles its promise with a Result and never rejects it: failures
+// reach the core as AuthError values.
 class PlatformAuth {
 public:
-  static std::shared_ptr<Promise<AuthUser>> login(AuthProvider provider, const std::optional<LoginOptions>& options = std::nullopt);
-  static std::shared_ptr<Promise<AuthUser>> requestScopes(const std::vector<std::string>& scopes);
-  static std::shared_ptr<Promise<AuthTokens>> refreshToken();
-  static std::shared_ptr<Promise<std::optional<AuthUser>>> silentRestore();
+  static std::shared_ptr<Promise<Result<AuthUser>>> login(AuthProvider provider,
+                                                          const std::optional<LoginOptions>& options = std::nullopt);
+  static std::shared_ptr<Promise<Result<AuthUser>>> requestScopes(const std::vector<std::string>& scopes);
+  // `provider` selects whose session to refresh; nullopt keeps the platform's default order.
+  // Non-empty `scopes` request an access token for exactly those scopes (a resource token)
+  // instead of the session token.
+  static std::shared_ptr<Promise<Result<AuthTokens>>> refreshToken(const std::optional<AuthProvider>& provider,
+                                                                   const std::vector<std::string>& scopes = {});
+  static std::shared_ptr<Promise<Result<std::optional<AuthUser>>>> silentRestore();
   static bool hasPlayServices();
+  // Opens `url` in a browser session that ends when the provider redirects to
+  // `redirectUri`; resolves with the full redirect URL. Backs the core's OIDC client.
+  static std::shared_ptr<Promise<Result<std::string>>> authorizeInBrowser(const std::string& url,
+                                                                          const std::string& redirectUri);
+  // Transport for the core's own HTTP calls (discovery, JWKS).
+  static std::shared_ptr<HttpClient> httpClient();
+  // Directory for native caches the OS may purge; empty when unavailable.
+  static std::string cacheDirectory();
+  // OpenID authorities of the providers configured in the app, prefetched at startup.
+  static std::vector<std::string> discoveryAuthorities();
   static void logout();
-  static std::shared_ptr<Promise<void>> revokeAccess();
+  static std::shared_ptr<Promise<Result<void>>> revokeAccess();
+  // Releases the slot held by `operation` and settles its pending promise with `reason`.
+  // A late platform callback for a cancelled operation is dropped.
+  static void cancel(PlatformOperation operation, const std::string& reason);
 };
 
 } // namespace margelo::nitro::NitroAuth
@@ -0,0 +1,84 @@
+#include "RefreshBackoff.hpp"
+#include <algorithm>
+#include <cmath>
+
+namespace margelo::nitro::NitroAuth {
+
+RefreshBackoff::RefreshBackoff(RefreshBackoffPolicy policy)
+  : RefreshBackoff(policy, std::random_device{}()) {}
+
+RefreshBackoff::RefreshBackoff(RefreshBackoffPolicy policy, uint32_t seed)
+  : _policy(policy), _random(seed == 0 ? 1 : seed) {}
+
+RefreshFailureKind RefreshBackoff::classify(const AuthError& error) {
+  switch (error.code()) {
+    case AuthErrorCode::CANCELLED:
+    case AuthErrorCode::OPERATION_IN_PROGRESS:
+    case AuthErrorCode::DISPOSED:
+      return RefreshFailureKind::IGNORED;
+    case AuthErrorCode::NOT_SIGNED_IN:
+    case AuthErrorCode::TOKEN_ERROR:
+    case AuthErrorCode::CONFIGURATION_ERROR:
+    case AuthErrorCode::UNSUPPORTED_PROVIDER:
+    case AuthErrorCode::INVALID_GRANT:
+    case AuthErrorCode::NO_ID_TOKEN:
+      return RefreshFailureKind::PERMANENT;
+    default:
+      return RefreshFailureKind::TRANSIENT;
+  }
+}
+
+std::optional<AuthError> RefreshBackoff::blockingError(int64_t nowMs) const {
+  if (!_lastError) {
+    return std::nullopt;
+  }
+  if (_permanent || nowMs < _retryAtMs) {
+    return _lastError;
+  }
+  // Half-open: the delay elapsed, so one probe may reach the platform.
+  return std::nullopt;
+}
+
+void RefreshBackoff::recordFailure(const AuthError& error, int64_t nowMs) {
+  switch (classify(error)) {
+    case RefreshFailureKind::IGNORED:
+      return;
+    case RefreshFailureKind::PERMANENT:
+      _permanent = true;
+      _consecutiveFailures++;
+      _lastError = error;
+      return;
+    case RefreshFailureKind::TRANSIENT:
+      _consecutiveFailures++;
+      _lastError = error;
+      _retryAtMs = nowMs + nextDelayMs();
+      return;
+  }
+}
+
+void RefreshBackoff::recordSuccess() {
+  reset();
+}
+
+void RefreshBackoff::reset() {
+  _lastError = std::nullopt;
+  _consecutiveFailures = 0;
+  _retryAtMs = 0;
+  _permanent = false;
+}
+
+int64_t RefreshBackoff::nextDelayMs() {
+  const auto exponent = static_cast<double>(std::min<uint32_t>(_consecutiveFailures - 1, 32));
+  const double base = std::min(
+    static_cast<double>(_policy.initialDelayMs) * std::pow(_policy.multiplier, exponent),
+    static_cast<double>(_policy.maxDelayMs)
+  );
+  const double jitter = std::clamp(_policy.jitterRatio, 0.0, 1.0);
+  if (jitter <= 0.0) {
+    return static_cast<int64_t>(base);
+  }
+  std::uniform_real_distribution<double> distribution(1.0 - jitter, 1.0 + jitter);
+  return static_cast<int64_t>(base * distribution(_random));
+}
+
+} // namespace margelo::nitro::NitroAuth
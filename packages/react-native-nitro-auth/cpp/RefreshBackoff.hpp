@@ -0,0 +1,59 @@
+#pragma once
+
+#include "AuthResult.hpp"
+#include <cstdint>
+#include <optional>
+#include <random>
+
+namespace margelo::nitro::NitroAuth {
+
+enum class RefreshFailureKind {
+  // Not a provider failure (user/session cancellation, local contention); never cached.
+  IGNORED,
+  // Network or server hiccup; retried after an exponential, jittered delay.
+  TRANSIENT,
+  // The grant itself is unusable; fails fast until the next session change.
+  PERMANENT,
+};
+
+struct RefreshBackoffPolicy {
+  int64_t initialDelayMs = 1000;
+  int64_t maxDelayMs = 5 * 60 * 1000;
+  double multiplier = 2.0;
+  // Each delay is scaled by a random factor in [1 - jitterRatio, 1 + jitterRatio].
+  double jitterRatio = 0.2;
+};
+
+// Negative cache for platform refresh failures. While the circuit is open,
+// callers are rejected with the last failure code instead of starting a new
+// platform refresh, so a flaky network cannot turn into a refresh storm.
+class RefreshBackoff {
+public:
+  explicit RefreshBackoff(RefreshBackoffPolicy policy = {});
+  RefreshBackoff(RefreshBackoffPolicy policy, uint32_t seed);
+
+  static RefreshFailureKind classify(const AuthError& error);
+
+  // Returns the cached failure when a refresh must not hit the platform at `nowMs`.
+  std::optional<AuthError> blockingError(int64_t nowMs) const;
+  void recordFailure(const AuthError& error, int64_t nowMs);
+  void recordSuccess();
+  void reset();
+
+  uint32_t consecutiveFailures() const { return _consecutiveFailures; }
+  int64_t retryAtMs() const { return _retryAtMs; }
+  bool isPermanent() const { return _permanent; }
+
+private:
+  int64_t nextDelayMs();
+
+private:
+  RefreshBackoffPolicy _policy;
+  std::minstd_rand _random;
+  std::optional<AuthError> _lastError;
+  uint32_t _consecutiveFailures = 0;
+  int64_t _retryAtMs = 0;
+  bool _permanent = false;
+};
+
+} // namespace margelo::nitro::NitroAuth
@@ -0,0 +1,26 @@
+#include "RefreshTokenLedger.hpp"
+#include <algorithm>
+
+namespace margelo::nitro::NitroAuth {
+
+RefreshTokenUpdate RefreshTokenLedger::apply(std::optional<std::string>& current,
+                                             const std::optional<std::string>& next) {
+  if (!next || next->empty() || next == current) return RefreshTokenUpdate::UNCHANGED;
+  if (isSuperseded(*next)) return RefreshTokenUpdate::REUSED;
+  if (current && !current->empty()) supersede(*current);
+  current = next;
+  return RefreshTokenUpdate::ROTATED;
+}
+
+bool RefreshTokenLedger::isSuperseded(std::string_view token) const {
+  if (_superseded.empty()) return false;
+  auto digest = JwsCrypto::sha256(token);
+  return std::find(_superseded.begin(), _superseded.end(), digest) != _superseded.end();
+}
+
+void RefreshTokenLedger::supersede(std::string_view token) {
+  _superseded.push_back(JwsCrypto::sha256(token));
+  if (_superseded.size() > kMaxSuperseded) _superseded.pop_front();
+}
+
+} // namespace margelo::nitro::NitroAuth
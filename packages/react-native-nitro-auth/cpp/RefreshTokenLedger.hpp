@@ -0,0 +1,49 @@
+#pragma once
+
+#include "JwsCrypto.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <optional>
+#include <string>
+#include <string_view>
+
+namespace margelo::nitro::NitroAuth {
+
+enum class RefreshTokenUpdate {
+  // No refresh token in the result, or the current one again.
+  UNCHANGED,
+  // The result carried a new token; the previous one is now superseded.
+  ROTATED,
+  // The result carried a token this account already rotated away from. Not adopted.
+  REUSED,
+};
+
+struct RefreshTokenStats {
+  uint64_t rotations = 0;
+  uint64_t reusesRejected = 0;
+};
+
+// Refresh tokens one account has rotated away from, kept as SHA-256 digests so
+// the ledger never holds a usable credential. Providers that rotate (Microsoft,
+// most OIDC servers) treat a superseded token presented again as a replay and
+// revoke the whole grant, so one must never be written back into the session.
+// Not thread-safe; HybridAuth guards it with its own mutex.
+class RefreshTokenLedger {
+public:
+  static constexpr size_t kMaxSuperseded = 16;
+
+  // Swaps `next` into `current` when it is a fresh token and records the one it replaces.
+  RefreshTokenUpdate apply(std::optional<std::string>& current, const std::optional<std::string>& next);
+  bool isSuperseded(std::string_view token) const;
+  size_t size() const { return _superseded.size(); }
+
+private:
+  void supersede(std::string_view token);
+
+private:
+  // Oldest first.
+  std::deque<Sha256Digest> _superseded;
+};
+
+} // namespace margelo::nitro::NitroAuth
@@ -0,0 +1,35 @@
+#pragma once
+
+#include "AuthUser.hpp"
+#include "AuthTokens.hpp"
+#include <optional>
+
+namespace margelo::nitro::NitroAuth {
+
+// Applies a refresh result to a user; fields missing from `tokens` are kept.
+inline void mergeTokens(AuthUser& user, const AuthTokens& tokens) {
+  if (tokens.accessToken) user.accessToken = tokens.accessToken;
+  if (tokens.idToken) user.idToken = tokens.idToken;
+  if (tokens.refreshToken) user.refreshToken = tokens.refreshToken;
+  if (tokens.expirationTime) user.expirationTime = tokens.expirationTime;
+}
+
+// Optional native persistence for the current session. HybridAuth reports every
+// session change here; implementations must not block the caller (no I/O on the
+// calling thread). Not exposed to JS, and the iOS/Android bindings never install
+// one: by default the session lives in memory only.
+class SessionStore {
+public:
+  virtual ~SessionStore() = default;
+
+  // Full session change: login, restore, scope changes, logout (std::nullopt).
+  virtual void saveUser(const std::optional<AuthUser>& user) = 0;
+  // Token rotation; merged into the stored user, ignored when signed out.
+  virtual void saveTokens(const AuthTokens& tokens) = 0;
+  // Latest saved session, including writes that are not yet durable.
+  virtual std::optional<AuthUser> load() = 0;
+  // Blocks until everything saved so far is durable.
+  virtual void flush() = 0;
+};
+
+} // namespace margelo::nitro::NitroAuth
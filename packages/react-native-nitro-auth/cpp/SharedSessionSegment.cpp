@@ -0,0 +1,196 @@
+#include "SharedSessionSegment.hpp"
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <fcntl.h>
+#include <stdexcept>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <thread>
+#include <unistd.h>
+
+namespace margelo::nitro::NitroAuth {
+
+namespace {
+
+// "NA" plus the layout version; a segment written by another layout is refused.
+constexpr uint32_t kMagic = 0x4e410001;
+constexpr uint64_t kSignedIn = 1;
+constexpr uint64_t kHasExpiration = 2;
+// flags, lengths (account id low, token high), expiration bits.
+constexpr size_t kHeaderWords = 3;
+constexpr size_t kPayloadWords =
+    kHeaderWords +
+    (SharedSessionSegment::kMaxAccountIdBytes + SharedSessionSegment::kMaxAccessTokenBytes + 7) / 8;
+// A reader gives up on a segment whose writer died mid-publish instead of spinning forever.
+constexpr unsigned kMaxReadAttempts = 100000;
+constexpr unsigned kSpinsBeforeYield = 64;
+
+// One past the last payload word used by `bytes` of account id and token.
+size_t payloadEnd(size_t bytes) {
+  return kHeaderWords + (bytes + 7) / 8;
+}
+
+uint64_t doubleBits(double value) {
+  uint64_t bits;
+  std::memcpy(&bits, &value, sizeof(bits));
+  return bits;
+}
+
+double bitsDouble(uint64_t bits) {
+  double value;
+  std::memcpy(&value, &bits, sizeof(value));
+  return value;
+}
+
+} // namespace
+
+// Lives in the mapping. Every field is an atomic so concurrent access from
+// other processes is well-defined; the payload is copied word by word with
+// relaxed loads and stores, ordered by the fences around `sequence`.
+struct SharedSessionSegment::Layout {
+  std::atomic<uint32_t> magic;
+  // Odd while a publish is in progress; version = sequence / 2.
+  std::atomic<uint64_t> sequence;
+  std::atomic<uint64_t> words[kPayloadWords];
+};
+
+static_assert(std::atomic<uint32_t>::is_always_lock_free && std::atomic<uint64_t>::is_always_lock_free,
+              "the segment is shared between processes, so its atomics must not hide a lock");
+
+std::shared_ptr<SharedSessionSegment> SharedSessionSegment::open(const std::string& path) {
+  // The token sits in a file, so only this user may reach it: the directory
+  // must be ours and closed to others, and the file a regular file we own.
+  const auto slash = path.find_last_of('/');
+  const std::string directory = slash == std::string::npos ? "." : slash == 0 ? "/" : path.substr(0, slash);
+  struct stat directoryInfo {};
+  if (::stat(directory.c_str(), &directoryInfo) != 0 || !S_ISDIR(directoryInfo.st_mode) ||
+      directoryInfo.st_uid != ::geteuid() || (directoryInfo.st_mode & (S_IWGRP | S_IWOTH)) != 0) {
+    throw std::runtime_error("storage_error");
+  }
+  const int fd = ::open(path.c_str(), O_RDWR | O_CREAT | O_CLOEXEC | O_NOFOLLOW, 0600);
+  if (fd < 0) throw std::runtime_error("storage_error");
+  struct stat info {};
+  const size_t size = sizeof(Layout);
+  if (::fstat(fd, &info) != 0 || !S_ISREG(info.st_mode) || info.st_uid != ::geteuid() ||
+      ((info.st_mode & 077) != 0 && ::fchmod(fd, 0600) != 0) ||
+      // Growing the file zero-fills it, which is the empty, signed-out segment.
+      (static_cast<size_t>(info.st_size) < size && ::ftruncate(fd, size) != 0)) {
+    ::close(fd);
+    throw std::runtime_error("storage_error");
+  }
+  void* mapping = ::mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  ::close(fd);
+  if (mapping == MAP_FAILED) throw std::runtime_error("storage_error");
+
+  auto* layout = static_cast<Layout*>(mapping);
+  uint32_t magic = 0;
+  if (!layout->magic.compare_exchange_strong(magic, kMagic) && magic != kMagic) {
+    ::munmap(mapping, size);
+    throw std::runtime_error("storage_error");
+  }
+  return std::shared_ptr<SharedSessionSegment>(new SharedSessionSegment(layout, size));
+}
+
+SharedSessionSegment::SharedSessionSegment(Layout* layout, size_t size) : _layout(layout), _size(size) {}
+
+SharedSessionSegment::~SharedSessionSegment() {
+  ::munmap(_layout, _size);
+}
+
+bool SharedSessionSegment::publish(const SharedSession& session) {
+  if (session.accountId.size() > kMaxAccountIdBytes || session.accessToken.size() > kMaxAccessTokenBytes) {
+    return false;
+  }
+  write(&session);
+  return true;
+}
+
+void SharedSessionSegment::clear() {
+  write(nullptr);
+  // The scrubbed payload reaches the file now rather than at the next writeback.
+  ::msync(_layout, _size, MS_SYNC);
+}
+
+void SharedSessionSegment::write(const SharedSession* session) {
+  std::lock_guard<std::mutex> lock(_writeMutex);
+  auto* words = _layout->words;
+  uint64_t sequence = _layout->sequence.load(std::memory_order_relaxed);
+  // Words the previous publish used; a primary that died mid-publish may have
+  // used any of them.
+  size_t previousEnd = kPayloadWords;
+  if (!(sequence & 1)) {
+    const uint64_t lengths = words[1].load(std::memory_order_relaxed);
+    previousEnd = std::min(kPayloadWords, payloadEnd((lengths & 0xffffffff) + (lengths >> 32)));
+  } else {
+    sequence++;
+  }
+  _layout->sequence.store(sequence + 1, std::memory_order_relaxed);
+  std::atomic_thread_fence(std::memory_order_release);
+
+  size_t end = 0;
+  if (session) {
+    const uint64_t flags = kSignedIn | (session->expirationTime ? kHasExpiration : 0);
+    words[0].store(flags, std::memory_order_relaxed);
+    words[1].store(session->accountId.size() | (static_cast<uint64_t>(session->accessToken.size()) << 32),
+                   std::memory_order_relaxed);
+    words[2].store(doubleBits(session->expirationTime.value_or(0)), std::memory_order_relaxed);
+    const std::string bytes = session->accountId + session->accessToken;
+    for (size_t offset = 0, index = kHeaderWords; offset < bytes.size(); offset += 8, ++index) {
+      uint64_t word = 0;
+      std::memcpy(&word, bytes.data() + offset, std::min<size_t>(8, bytes.size() - offset));
+      words[index].store(word, std::memory_order_relaxed);
+    }
+    end = payloadEnd(bytes.size());
+  }
+  // No byte of an older, longer token or of a cleared session stays behind.
+  for (size_t index = end; index < previousEnd; ++index) words[index].store(0, std::memory_order_relaxed);
+
+  _layout->sequence.store(sequence + 2, std::memory_order_release);
+}
+
+SharedSessionRead SharedSessionSegment::read() const {
+  const auto* words = _layout->words;
+  std::string bytes;
+  for (unsigned attempt = 0; attempt < kMaxReadAttempts; ++attempt) {
+    if (attempt >= kSpinsBeforeYield) std::this_thread::yield();
+    const uint64_t before = _layout->sequence.load(std::memory_order_acquire);
+    if (before & 1) continue;
+
+    const uint64_t flags = words[0].load(std::memory_order_relaxed);
+    const uint64_t lengths = words[1].load(std::memory_order_relaxed);
+    const uint64_t expirationBits = words[2].load(std::memory_order_relaxed);
+    const size_t accountIdSize = lengths & 0xffffffff;
+    const size_t accessTokenSize = lengths >> 32;
+    // Torn lengths are caught by the sequence check; only bound the copy here.
+    const bool isSignedIn = (flags & kSignedIn) && accountIdSize <= kMaxAccountIdBytes &&
+                            accessTokenSize <= kMaxAccessTokenBytes;
+    if (isSignedIn) {
+      bytes.resize(accountIdSize + accessTokenSize);
+      for (size_t offset = 0, index = kHeaderWords; offset < bytes.size(); offset += 8, ++index) {
+        const uint64_t word = words[index].load(std::memory_order_relaxed);
+        std::memcpy(bytes.data() + offset, &word, std::min<size_t>(8, bytes.size() - offset));
+      }
+    }
+    std::atomic_thread_fence(std::memory_order_acquire);
+    if (_layout->sequence.load(std::memory_order_relaxed) != before) continue;
+
+    SharedSessionRead result;
+    result.version = before / 2;
+    if (isSignedIn) {
+      SharedSession session;
+      session.accountId = bytes.substr(0, accountIdSize);
+      session.accessToken = bytes.substr(accountIdSize);
+      if (flags & kHasExpiration) session.expirationTime = bitsDouble(expirationBits);
+      result.session = std::move(session);
+    }
+    return result;
+  }
+  return SharedSessionRead{std::nullopt, version()};
+}
+
+uint64_t SharedSessionSegment::version() const {
+  return _layout->sequence.load(std::memory_order_acquire) / 2;
+}
+
+} // namespace margelo::nitro::NitroAuth
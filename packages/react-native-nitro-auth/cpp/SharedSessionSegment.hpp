@@ -0,0 +1,75 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+
+namespace margelo::nitro::NitroAuth {
+
+struct SharedSession {
+  std::string accountId;
+  std::string accessToken;
+  // Device clock, already corrected for server clock skew.
+  std::optional<double> expirationTime;
+};
+
+struct SharedSessionRead {
+  // nullopt while signed out or before the primary process published anything.
+  std::optional<SharedSession> session;
+  // Bumped by every publish; equal versions mean an unchanged session.
+  uint64_t version = 0;
+};
+
+// The active session's access token in a memory-mapped file, so other
+// processes of the app (a background sync process, an Android widget, an iOS
+// extension sharing an app group container) can use it without running their
+// own restore and refresh against the platform.
+//
+// One primary process publishes; any number of processes read. Access is a
+// seqlock: the writer makes the sequence odd, rewrites the payload and makes
+// it even again, and readers retry until they copied the payload under one
+// even sequence. Reading is plain loads from the mapping, with no locks and
+// no syscalls, and a reader never sees half of a rotated token.
+class SharedSessionSegment {
+public:
+  static constexpr size_t kMaxAccountIdBytes = 256;
+  static constexpr size_t kMaxAccessTokenBytes = 16 * 1024;
+
+  // Maps `path`, creating and sizing the file with mode 0600 when missing. Its
+  // directory must be owned by this user and not writable by anyone else; use
+  // a private or app-group directory, never a shared temp directory. Throws
+  // std::runtime_error("storage_error") if the directory is not private, the
+  // file is not a regular file of ours, it cannot be mapped, or it holds a
+  // segment of another layout.
+  static std::shared_ptr<SharedSessionSegment> open(const std::string& path);
+
+  ~SharedSessionSegment();
+  SharedSessionSegment(const SharedSessionSegment&) = delete;
+  SharedSessionSegment& operator=(const SharedSessionSegment&) = delete;
+
+  // Primary process only. Returns false, leaving the segment untouched, when
+  // the account id or token does not fit.
+  bool publish(const SharedSession& session);
+  // Marks the session signed out and zeroes the published payload in the file.
+  void clear();
+  SharedSessionRead read() const;
+  // Cheap change check: one atomic load.
+  uint64_t version() const;
+
+private:
+  struct Layout;
+
+  SharedSessionSegment(Layout* layout, size_t size);
+  void write(const SharedSession* session);
+
+private:
+  Layout* const _layout;
+  const size_t _size;
+  // Serializes publishers inside the primary process; readers never take it.
+  std::mutex _writeMutex;
+};
+
+} // namespace margelo::nitro::NitroAuth
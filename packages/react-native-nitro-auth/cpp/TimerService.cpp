@@ -0,0 +1,83 @@
+#include "TimerService.hpp"
+#include <algorithm>
+
+namespace margelo::nitro::NitroAuth {
+
+std::shared_ptr<TimerService> TimerService::shared() {
+  static auto service = std::make_shared<ThreadTimerService>();
+  return service;
+}
+
+ThreadTimerService::~ThreadTimerService() {
+  {
+    std::lock_guard<std::mutex> lock(_mutex);
+    _stopping = true;
+    _timers.clear();
+    _deadlines.clear();
+  }
+  _condition.notify_all();
+  if (_thread.joinable()) {
+    if (_thread.get_id() == std::this_thread::get_id()) {
+      _thread.detach();
+    } else {
+      _thread.join();
+    }
+  }
+}
+
+TimerService::TimerId ThreadTimerService::schedule(int64_t delayMs, std::function<void()> callback) {
+  const auto deadline = Clock::now() + std::chrono::milliseconds(std::max<int64_t>(delayMs, 0));
+  TimerId id;
+  {
+    std::lock_guard<std::mutex> lock(_mutex);
+    id = _nextId++;
+    _timers.emplace(TimerKey{deadline, id}, std::move(callback));
+    _deadlines.emplace(id, deadline);
+    if (!_thread.joinable()) {
+      _thread = std::thread([this]() { run(); });
+    }
+  }
+  _condition.notify_all();
+  return id;
+}
+
+void ThreadTimerService::cancel(TimerId id) {
+  std::lock_guard<std::mutex> lock(_mutex);
+  auto deadline = _deadlines.find(id);
+  if (deadline == _deadlines.end()) {
+    return;
+  }
+  _timers.erase(TimerKey{deadline->second, id});
+  _deadlines.erase(deadline);
+}
+
+void ThreadTimerService::run() {
+  std::unique_lock<std::mutex> lock(_mutex);
+  while (!_stopping) {
+    if (_timers.empty()) {
+      _condition.wait(lock);
+      continue;
+    }
+    auto next = _timers.begin();
+    // Copy the deadline: the entry may be cancelled while this thread waits.
+    const auto deadline = next->first.first;
+    if (Clock::now() < deadline) {
+      _condition.wait_until(lock, deadline);
+      continue;
+    }
+    auto callback = std::move(next->second);
+    _deadlines.erase(next->first.second);
+    _timers.erase(next);
+
+    // Callbacks may schedule or cancel timers, so they run without the lock held.
+    lock.unlock();
+    try {
+      callback();
+    } catch (...) {
+      // A failing callback must not take down the shared worker.
+    }
+    lock.lock();
+  }
+}
+
+} // namespace margelo::nitro::NitroAuth
@@ -0,0 +1,59 @@
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <utility>
+
+namespace margelo::nitro::NitroAuth {
+
+// Schedules native callbacks (operation deadlines, retries) without JS timers.
+class TimerService {
+public:
+  using TimerId = uint64_t;
+
+  virtual ~TimerService() = default;
+
+  // Runs `callback` once after `delayMs`. Callbacks run off the caller's thread.
+  virtual TimerId schedule(int64_t delayMs, std::function<void()> callback) = 0;
+  // Cancelling an unknown or already-fired timer is a no-op.
+  virtual void cancel(TimerId id) = 0;
+
+  // Process-wide service backed by a single lazily started worker thread.
+  static std::shared_ptr<TimerService> shared();
+};
+
+class ThreadTimerService final : public TimerService {
+public:
+  ThreadTimerService() = default;
+  ~ThreadTimerService() override;
+
+  ThreadTimerService(const ThreadTimerService&) = delete;
+  ThreadTimerService& operator=(const ThreadTimerService&) = delete;
+
+  TimerId schedule(int64_t delayMs, std::function<void()> callback) override;
+  void cancel(TimerId id) override;
+
+private:
+  using Clock = std::chrono::steady_clock;
+  using TimerKey = std::pair<Clock::time_point, TimerId>;
+
+  void run();
+
+private:
+  std::mutex _mutex;
+  std::condition_variable _condition;
+  std::map<TimerKey, std::function<void()>> _timers;
+  std::unordered_map<TimerId, Clock::time_point> _deadlines;
+  TimerId _nextId = 1;
+  bool _stopping = false;
+  std::thread _thread;
+};
+
+} // namespace margelo::nitro::NitroAuth
@@ -0,0 +1,53 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <string>
+
+namespace margelo::nitro::NitroAuth::bench {
+
+template <typename T>
+inline void doNotOptimize(const T& value) {
+  asm volatile("" : : "r,m"(value) : "memory");
+}
+
+struct Result {
+  std::string name;
+  double nsPerOp = 0;
+  uint64_t iterations = 0;
+};
+
+// Runs `body` in doubling batches until the time budget is spent and reports
+// the mean cost of one call. Enough for relative comparisons between variants.
+template <typename Body>
+Result run(const std::string& name, Body&& body, std::chrono::milliseconds budget = std::chrono::milliseconds(300)) {
+  using Clock = std::chrono::steady_clock;
+  for (int i = 0; i < 100; ++i) body();
+
+  uint64_t iterations = 0;
+  uint64_t batch = 1;
+  Clock::duration elapsed{};
+  while (elapsed < budget) {
+    const auto start = Clock::now();
+    for (uint64_t i = 0; i < batch; ++i) body();
+    elapsed += Clock::now() - start;
+    iterations += batch;
+    batch *= 2;
+  }
+
+  Result result{name, std::chrono::duration<double, std::nano>(elapsed).count() / static_cast<double>(iterations),
+                iterations};
+  std::printf("  %-48s %12.1f ns/op  (%llu iterations)\n", result.name.c_str(), result.nsPerOp,
+              static_cast<unsigned long long>(result.iterations));
+  return result;
+}
+
+inline void compare(const Result& baseline, const Result& candidate) {
+  std::printf("  -> %s is %.2fx %s than %s\n", candidate.name.c_str(),
+              candidate.nsPerOp < baseline.nsPerOp ? baseline.nsPerOp / candidate.nsPerOp
+                                                   : candidate.nsPerOp / baseline.nsPerOp,
+              candidate.nsPerOp < baseline.nsPerOp ? "faster" : "slower", baseline.name.c_str());
+}
+
+} // namespace margelo::nitro::NitroAuth::bench
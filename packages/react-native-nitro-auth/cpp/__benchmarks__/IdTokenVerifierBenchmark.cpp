@@ -0,0 +1,56 @@
+#include <cstdio>
+#include <string>
+#include "../IdTokenVerifier.hpp"
+#include "../JwsCrypto.hpp"
+#include "../__tests__/IdTokenTestVectors.hpp"
+#include "Benchmark.hpp"
+
+using namespace margelo::nitro::NitroAuth;
+using namespace margelo::nitro::NitroAuth::vectors;
+
+namespace {
+
+constexpr int64_t kNowMs = 1700000100000;
+
+OidcMetadata makeMetadata() {
+  OidcMetadata metadata;
+  metadata.authority = "https://issuer.example.com";
+  metadata.provider.issuer = "https://issuer.example.com";
+  metadata.jwks = kJwks;
+  metadata.fetchedAtMs = 1;
+  return metadata;
+}
+
+} // namespace
+
+int main() {
+  const OidcMetadata metadata = makeMetadata();
+  IdTokenExpectations expectations;
+  expectations.issuers = {"https://issuer.example.com"};
+  expectations.audience = "client-123";
+  expectations.nonce = "n-0S6_WzA2Mj";
+
+  std::printf("IdTokenVerifier (%zu byte RS256 token, %zu byte ES256 token)\n", kRs256.size(), kEs256.size());
+  bench::run("sha256 (signing input)", [&]() {
+    bench::doNotOptimize(JwsCrypto::sha256(std::string_view(kRs256).substr(0, kRs256.rfind('.'))));
+  });
+  bench::run("parse JWKS (2x RSA-2048, 1x P-256)", [&]() { bench::doNotOptimize(IdTokenVerifier::parseKeySet(kJwks)); });
+  bench::run("decode claims (unverified)", [&]() { bench::doNotOptimize(IdTokenVerifier::decodeUnverified(kRs256)); });
+
+  // A zero-capacity memo forces the signature check on every call; keys stay parsed.
+  IdTokenVerifier uncached(0);
+  auto rs256 = bench::run("verify RS256 (signature checked)", [&]() {
+    bench::doNotOptimize(uncached.verify(kRs256, metadata, expectations, kNowMs));
+  });
+  auto es256 = bench::run("verify ES256 (signature checked)", [&]() {
+    bench::doNotOptimize(uncached.verify(kEs256, metadata, expectations, kNowMs));
+  });
+
+  IdTokenVerifier memoized;
+  auto memoHit = bench::run("verify (memoized)", [&]() {
+    bench::doNotOptimize(memoized.verify(kRs256, metadata, expectations, kNowMs));
+  });
+  bench::compare(rs256, memoHit);
+  bench::compare(es256, memoHit);
+  return 0;
+}
@@ -0,0 +1,109 @@
+#include <cstdio>
+#include <optional>
+#include <string>
+#include <vector>
+#include "../JSONSerializer.hpp"
+#include "Benchmark.hpp"
+
+using namespace margelo::nitro::NitroAuth;
+
+namespace {
+
+// The previous test-only serializer, kept verbatim as the baseline. It skips
+// escaping and most fields, so it does strictly less work than the codec.
+class LegacyJSONSerializer {
+public:
+    static std::string serialize(const AuthUser& user) {
+        std::string json = "{";
+        json += "\"provider\":\"" + (user.provider == AuthProvider::GOOGLE ? std::string("google") : std::string("apple")) + "\",";
+        if (user.email) json += "\"email\":\"" + *user.email + "\",";
+        if (user.name) json += "\"name\":\"" + *user.name + "\",";
+        if (user.photo) json += "\"photo\":\"" + *user.photo + "\",";
+        if (user.idToken) json += "\"idToken\":\"" + *user.idToken + "\",";
+        if (user.serverAuthCode) json += "\"serverAuthCode\":\"" + *user.serverAuthCode + "\",";
+        if (user.scopes) {
+            json += "\"scopes\":[";
+            for (size_t i = 0; i < user.scopes->size(); ++i) {
+                json += "\"" + (*user.scopes)[i] + "\"";
+                if (i < user.scopes->size() - 1) json += ",";
+            }
+            json += "],";
+        }
+        if (json.back() == ',') json.pop_back();
+        json += "}";
+        return json;
+    }
+
+    static std::optional<AuthUser> deserialize(const std::string& json) {
+        if (json.find("{") == std::string::npos) return std::nullopt;
+
+        AuthUser user;
+        user.provider = (json.find("\"provider\":\"google\"") != std::string::npos) ? AuthProvider::GOOGLE : AuthProvider::APPLE;
+
+        auto extract = [&](const std::string& key) -> std::optional<std::string> {
+            std::string searchKey = "\"" + key + "\":\"";
+            size_t start = json.find(searchKey);
+            if (start == std::string::npos) return std::nullopt;
+            start += searchKey.length();
+            size_t end = json.find("\"", start);
+            if (end == std::string::npos) return std::nullopt;
+            return json.substr(start, end - start);
+        };
+
+        user.email = extract("email");
+        user.name = extract("name");
+        user.photo = extract("photo");
+        user.idToken = extract("idToken");
+        user.serverAuthCode = extract("serverAuthCode");
+
+        return user;
+    }
+};
+
+// Roughly the shape of a Google session: a ~900 byte id_token plus profile data.
+AuthUser makeTypicalUser() {
+  AuthUser user;
+  user.provider = AuthProvider::GOOGLE;
+  user.email = "jane.doe@example.com";
+  user.name = "Jane Doe";
+  user.photo = "https://lh3.googleusercontent.com/a/ACg8ocJ1234567890abcdefghijklmnopqrstuvwxyz=s96-c";
+  std::string jwt = "eyJhbGciOiJSUzI1NiIsImtpZCI6IjFlOWdkazcifQ.";
+  while (jwt.size() < 900) jwt += "eyJpc3MiOiJodHRwczovL2FjY291bnRzLmdvb2dsZS5jb20iLCJzdWIiOiIxMTAxNjk0ODQ0NzQzODYyNzYzMzQifQ";
+  user.idToken = jwt;
+  user.serverAuthCode = "4/0AfJohXn1234567890abcdefghijklmnopqrstuvwxyz";
+  user.scopes = std::vector<std::string>{"openid", "email", "profile", "https://www.googleapis.com/auth/drive.readonly"};
+  return user;
+}
+
+} // namespace
+
+int main() {
+  const AuthUser user = makeTypicalUser();
+  const std::string legacyJson = LegacyJSONSerializer::serialize(user);
+  const std::string json = JSONSerializer::serialize(user);
+  std::printf("JSONSerializer (%zu byte document)\n", json.size());
+
+  auto legacyWrite = bench::run("legacy serialize", [&]() { bench::doNotOptimize(LegacyJSONSerializer::serialize(user)); });
+  auto write = bench::run("codec serialize", [&]() { bench::doNotOptimize(JSONSerializer::serialize(user)); });
+  std::string buffer;
+  auto reusedWrite = bench::run("codec serialize (reused buffer)", [&]() {
+    buffer.clear();
+    JSONSerializer::serialize(user, buffer);
+    bench::doNotOptimize(buffer);
+  });
+  bench::compare(legacyWrite, write);
+  bench::compare(legacyWrite, reusedWrite);
+
+  auto legacyRead = bench::run("legacy deserialize", [&]() { bench::doNotOptimize(LegacyJSONSerializer::deserialize(legacyJson)); });
+  auto read = bench::run("codec deserialize", [&]() { bench::doNotOptimize(JSONSerializer::deserialize(json)); });
+  bench::compare(legacyRead, read);
+
+  AuthUser escaped = user;
+  escaped.name = "Jos\xc3\xa9 \"JD\" D\\oe\n";
+  const std::string escapedJson = JSONSerializer::serialize(escaped);
+  bench::run("codec round trip (escaped fields)", [&]() {
+    bench::doNotOptimize(JSONSerializer::deserialize(JSONSerializer::serialize(escaped)));
+  });
+  bench::doNotOptimize(escapedJson);
+  return 0;
+}
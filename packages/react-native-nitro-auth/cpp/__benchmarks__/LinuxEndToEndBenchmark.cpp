@@ -0,0 +1,59 @@
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include "../HybridAuth.hpp"
+#include "Benchmark.hpp"
+#include "LoopbackOAuthServer.hpp"
+#include "PlatformAuth+Linux.hpp"
+
+using namespace margelo::nitro::NitroAuth;
+
+namespace margelo::nitro::NitroAuth {
+
+void HybridAuthSpec::loadHybridMethods() {}
+
+} // namespace margelo::nitro::NitroAuth
+
+// The whole native pipeline against the loopback provider: HybridAuth, the
+// core OIDC client, real HTTP over 127.0.0.1 and RS256 id_token verification.
+int main() {
+  char directory[] = "/tmp/nitro-auth-bench-XXXXXX";
+  if (::mkdtemp(directory) == nullptr) return 1;
+  auto server = LoopbackOAuthServer::start();
+  LinuxPlatformConfig config;
+  config.issuer = server->issuer();
+  config.cacheDirectory = directory;
+  LinuxPlatformAuth::configure(config);
+
+  auto auth = std::make_shared<HybridAuth>();
+  std::printf("Linux end to end (loopback %s)\n", server->issuer().c_str());
+  bench::run("login (code + PKCE, verified id_token)", [&] {
+    bench::doNotOptimize(auth->login(AuthProvider::GOOGLE, std::nullopt)->isResolved());
+  });
+  bench::run("refreshToken (rotating, new id_token)", [&] {
+    bench::doNotOptimize(auth->refreshToken()->isResolved());
+  });
+  bench::run("getAccessToken (fresh, no platform call)", [&] {
+    bench::doNotOptimize(auth->getAccessToken(std::nullopt)->isResolved());
+  });
+
+  // Without the per-refresh RSA signature, what remains is the client side and the loopback round trip.
+  LoopbackOAuthServerOptions options;
+  options.idTokenOnRefresh = false;
+  auto leanServer = LoopbackOAuthServer::start(options);
+  config.issuer = leanServer->issuer();
+  LinuxPlatformAuth::configure(config);
+  auto lean = std::make_shared<HybridAuth>();
+  lean->login(AuthProvider::GOOGLE, std::nullopt);
+  bench::run("refreshToken (rotating, no id_token)", [&] {
+    bench::doNotOptimize(lean->refreshToken()->isResolved());
+  });
+  leanServer->stop();
+
+  const auto stats = server->stats();
+  std::printf("  server: %llu code exchanges, %llu refreshes, %llu rejected grants\n",
+              static_cast<unsigned long long>(stats.codeExchanges), static_cast<unsigned long long>(stats.refreshes),
+              static_cast<unsigned long long>(stats.rejectedGrants));
+  server->stop();
+  return 0;
+}
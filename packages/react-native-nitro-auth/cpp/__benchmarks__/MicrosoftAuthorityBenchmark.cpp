@@ -0,0 +1,93 @@
+#include <cstdio>
+#include <optional>
+#include <regex>
+#include <string>
+#include "../MicrosoftAuthority.hpp"
+#include "Benchmark.hpp"
+
+using namespace margelo::nitro::NitroAuth;
+
+namespace {
+
+// The adapters' previous implementation: every call builds its regexes from
+// scratch (Kotlin `Regex(...)` / Swift `.regularExpression`), kept as the baseline.
+class LegacyMicrosoftAuthority {
+public:
+  static std::optional<std::string> authBaseUrl(const std::string& tenant, const std::string& b2cDomain) {
+    const std::string trimmedTenant = trim(tenant);
+    std::string domain = trim(b2cDomain);
+    if (!domain.empty()) {
+      for (char& c : domain) c = static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
+      if (!std::regex_match(
+              domain, std::regex("^(?=.{1,253}$)(?:[A-Za-z0-9](?:[A-Za-z0-9-]{0,61}[A-Za-z0-9])?\\.)+[A-Za-z]{2,63}$"))) {
+        return std::nullopt;
+      }
+      auto path = b2cTenantPath(trimmedTenant, domain);
+      if (!path) return std::nullopt;
+      return "https://" + domain + "/" + *path + "/";
+    }
+    if (!std::regex_match(trimmedTenant, std::regex("^(common|organizations|consumers|[0-9a-fA-F]{8}-[0-9a-fA-F]{4}-"
+                                                    "[0-9a-fA-F]{4}-[0-9a-fA-F]{4}-[0-9a-fA-F]{12}|[A-Za-z0-9][A-Za-"
+                                                    "z0-9._-]{0,127})$"))) {
+      return std::nullopt;
+    }
+    return "https://login.microsoftonline.com/" + trimmedTenant + "/";
+  }
+
+private:
+  static std::string trim(const std::string& value) {
+    const size_t first = value.find_first_not_of(" \t\n\r\f\v");
+    if (first == std::string::npos) return "";
+    return value.substr(first, value.find_last_not_of(" \t\n\r\f\v") - first + 1);
+  }
+
+  static std::optional<std::string> b2cTenantPath(const std::string& value, const std::string& domain) {
+    if (std::regex_match(value, std::regex("^([0-9a-fA-F]{8}-[0-9a-fA-F]{4}-[0-9a-fA-F]{4}-[0-9a-fA-F]{4}-[0-9a-fA-F]{"
+                                           "12}|[A-Za-z0-9][A-Za-z0-9._-]{0,127})/[A-Za-z0-9][A-Za-z0-9._-]{0,127}$"))) {
+      return value;
+    }
+    if (!std::regex_match(value, std::regex("^[A-Za-z0-9][A-Za-z0-9._-]{0,127}$"))) return std::nullopt;
+    const std::string suffix = ".b2clogin.com";
+    if (domain.size() < suffix.size() || domain.compare(domain.size() - suffix.size(), suffix.size(), suffix) != 0) {
+      return std::nullopt;
+    }
+    const std::string tenantName = domain.substr(0, domain.size() - suffix.size());
+    if (!std::regex_match(tenantName, std::regex("^[A-Za-z0-9](?:[A-Za-z0-9-]{0,61}[A-Za-z0-9])?$"))) {
+      return std::nullopt;
+    }
+    return tenantName + ".onmicrosoft.com/" + value;
+  }
+};
+
+} // namespace
+
+int main() {
+  const std::string tenant = "9188040d-6c67-4c5b-b112-36a304b66dad";
+  const std::string policy = "B2C_1_signupsignin";
+  const std::string b2cDomain = "contoso.b2clogin.com";
+
+  std::printf("MicrosoftAuthority (tenant ID, B2C policy on %s)\n", b2cDomain.c_str());
+  const auto legacyTenant = bench::run("regex per call (tenant)", [&] {
+    bench::doNotOptimize(LegacyMicrosoftAuthority::authBaseUrl(tenant, ""));
+  });
+  const auto resolvedTenant = bench::run("matcher (tenant)", [&] {
+    bench::doNotOptimize(MicrosoftAuthority::resolveBaseUrl(tenant));
+  });
+  const auto cachedTenant = bench::run("cached (tenant)", [&] {
+    bench::doNotOptimize(MicrosoftAuthority::authBaseUrl(tenant));
+  });
+  const auto legacyB2c = bench::run("regex per call (B2C)", [&] {
+    bench::doNotOptimize(LegacyMicrosoftAuthority::authBaseUrl(policy, b2cDomain));
+  });
+  const auto resolvedB2c = bench::run("matcher (B2C)", [&] {
+    bench::doNotOptimize(MicrosoftAuthority::resolveBaseUrl(policy, b2cDomain));
+  });
+  const auto cachedB2c = bench::run("cached (B2C)", [&] {
+    bench::doNotOptimize(MicrosoftAuthority::authBaseUrl(policy, b2cDomain));
+  });
+  bench::compare(legacyTenant, resolvedTenant);
+  bench::compare(legacyTenant, cachedTenant);
+  bench::compare(legacyB2c, resolvedB2c);
+  bench::compare(legacyB2c, cachedB2c);
+  return 0;
+}
@@ -0,0 +1,110 @@
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+#include <string>
+#include <vector>
+#include "../PackedAuthUser.hpp"
+#include "Benchmark.hpp"
+
+using namespace margelo::nitro::NitroAuth;
+
+namespace {
+
+std::atomic<size_t> gAllocatedBytes{0};
+std::atomic<size_t> gAllocations{0};
+
+// Roughly a Google session: a ~900 byte id_token, a 200 byte access token and profile data.
+AuthUser makeTypicalUser() {
+  AuthUser user;
+  user.provider = AuthProvider::GOOGLE;
+  user.email = "jane.doe@example.com";
+  user.name = "Jane Doe";
+  user.photo = "https://lh3.googleusercontent.com/a/ACg8ocJ1234567890abcdefghijklmnopqrstuvwxyz=s96-c";
+  user.idToken = std::string(900, 'i');
+  user.accessToken = "ya29." + std::string(200, 'a');
+  user.refreshToken = "1//0g" + std::string(100, 'r');
+  user.userId = "110169484474386276334";
+  user.scopes = std::vector<std::string>{"openid", "email", "profile", "https://www.googleapis.com/auth/drive.readonly"};
+  user.expirationTime = 1'700'000'000'000.0;
+  return user;
+}
+
+struct Footprint {
+  size_t bytes = 0;
+  size_t allocations = 0;
+};
+
+template <typename Body>
+Footprint measureHeap(Body&& body) {
+  const size_t bytes = gAllocatedBytes.load();
+  const size_t allocations = gAllocations.load();
+  body();
+  return Footprint{gAllocatedBytes.load() - bytes, gAllocations.load() - allocations};
+}
+
+} // namespace
+
+void* operator new(size_t size) {
+  gAllocatedBytes += size;
+  gAllocations++;
+  if (void* pointer = std::malloc(size == 0 ? 1 : size)) return pointer;
+  throw std::bad_alloc();
+}
+
+void operator delete(void* pointer) noexcept {
+  std::free(pointer);
+}
+
+void operator delete(void* pointer, size_t) noexcept {
+  std::free(pointer);
+}
+
+int main() {
+  const AuthUser user = makeTypicalUser();
+  const PackedAuthUser packed(user);
+  std::printf("PackedAuthUser (%zu byte packed buffer)\n", packed.packedBytes());
+
+  std::vector<AuthUser> users;
+  std::vector<PackedAuthUser> packedUsers;
+  users.reserve(2);
+  packedUsers.reserve(2);
+  const auto generated = measureHeap([&]() { users.push_back(user); });
+  const auto packedCopy = measureHeap([&]() { packedUsers.push_back(PackedAuthUser(user)); });
+  std::printf("  AuthUser:       %4zu inline + %5zu heap bytes in %2zu allocations\n", sizeof(AuthUser),
+              generated.bytes, generated.allocations);
+  std::printf("  PackedAuthUser: %4zu inline + %5zu heap bytes in %2zu allocations\n", sizeof(PackedAuthUser),
+              packedCopy.bytes, packedCopy.allocations);
+  const auto shared = measureHeap([&]() { packedUsers.push_back(packedUsers.front()); });
+  std::printf("  PackedAuthUser copy: %zu heap bytes\n", shared.bytes);
+
+  auto copyGenerated = bench::run("AuthUser copy", [&]() {
+    AuthUser copy = user;
+    bench::doNotOptimize(copy);
+  });
+  auto copyPacked = bench::run("PackedAuthUser copy", [&]() {
+    PackedAuthUser copy = packed;
+    bench::doNotOptimize(copy);
+  });
+  bench::compare(copyGenerated, copyPacked);
+
+  auto readGenerated = bench::run("AuthUser read email", [&]() { bench::doNotOptimize(user.email->size()); });
+  auto readPacked =
+    bench::run("PackedAuthUser view email", [&]() { bench::doNotOptimize(packed.view(AuthUserField::EMAIL)->size()); });
+  bench::compare(readGenerated, readPacked);
+
+  bench::run("pack", [&]() { bench::doNotOptimize(PackedAuthUser(user)); });
+  bench::run("unpack (JSI boundary)", [&]() { bench::doNotOptimize(packed.unpack()); });
+  AuthTokens tokens;
+  tokens.accessToken = "ya29." + std::string(200, 'b');
+  tokens.expirationTime = 1'700'000'360'000.0;
+  AuthUser mutableUser = user;
+  auto mergeGenerated = bench::run("AuthUser merge refresh", [&]() {
+    mutableUser.accessToken = tokens.accessToken;
+    mutableUser.expirationTime = tokens.expirationTime;
+    bench::doNotOptimize(mutableUser);
+  });
+  auto mergePacked = bench::run("PackedAuthUser withTokens", [&]() { bench::doNotOptimize(packed.withTokens(tokens)); });
+  bench::compare(mergeGenerated, mergePacked);
+  return 0;
+}
@@ -0,0 +1,168 @@
+#include <algorithm>
+#include <cstdio>
+#include <memory>
+#include <string>
+#include <vector>
+#include "../HybridAuth.hpp"
+#include "../PendingOperationRegistry.hpp"
+#include "../PlatformAuth.hpp"
+#include "Benchmark.hpp"
+
+// Bursts of queued session operations: the pending-operation registry against
+// the weak_ptr list it replaced, then whole requestScopes/silentRestore bursts
+// through HybridAuth with a platform that never answers until logout.
+
+using namespace margelo::nitro::NitroAuth;
+
+namespace margelo::nitro::NitroAuth {
+
+void HybridAuthSpec::loadHybridMethods() {}
+
+} // namespace margelo::nitro::NitroAuth
+
+namespace {
+
+// The previous tracking: every insert compacts the list, locking each weak_ptr.
+class WeakPromiseList {
+public:
+  void track(const std::shared_ptr<Promise<void>>& promise) {
+    _promises.erase(std::remove_if(_promises.begin(), _promises.end(),
+                                   [](const std::weak_ptr<Promise<void>>& weak) {
+                                     auto promise = weak.lock();
+                                     return !promise || !promise->isPending();
+                                   }),
+                    _promises.end());
+    _promises.push_back(promise);
+  }
+
+  std::vector<std::shared_ptr<Promise<void>>> takeAll() {
+    std::vector<std::shared_ptr<Promise<void>>> pending;
+    for (const auto& weak : _promises) {
+      auto promise = weak.lock();
+      if (promise && promise->isPending()) pending.push_back(promise);
+    }
+    _promises.clear();
+    return pending;
+  }
+
+private:
+  std::vector<std::weak_ptr<Promise<void>>> _promises;
+};
+
+std::vector<std::shared_ptr<Promise<void>>> makePromises(size_t count) {
+  std::vector<std::shared_ptr<Promise<void>>> promises;
+  promises.reserve(count);
+  for (size_t i = 0; i < count; i++) promises.push_back(Promise<void>::create());
+  return promises;
+}
+
+void settleAll(std::vector<std::shared_ptr<Promise<void>>>& promises) {
+  for (auto& promise : promises) {
+    if (promise->isPending()) promise->resolve();
+  }
+}
+
+void compareRegistries(size_t burst) {
+  std::printf("Burst of %zu session operations\n", burst);
+  // Settling in call order: each call is answered after the whole burst was queued.
+  auto settleWeak = bench::run("weak_ptr list: track, settle", [&]() {
+    WeakPromiseList list;
+    auto promises = makePromises(burst);
+    for (const auto& promise : promises) list.track(promise);
+    settleAll(promises);
+    bench::doNotOptimize(list.takeAll());
+  });
+  auto settleRegistry = bench::run("registry: track, settle", [&]() {
+    auto registry = std::make_shared<PendingOperationRegistry>();
+    auto promises = makePromises(burst);
+    for (const auto& promise : promises) registry->track(promise);
+    settleAll(promises);
+    bench::doNotOptimize(registry->takeAll());
+  });
+  bench::compare(settleWeak, settleRegistry);
+
+  // A new session cancels the whole burst.
+  auto cancelWeak = bench::run("weak_ptr list: track, cancel all", [&]() {
+    WeakPromiseList list;
+    auto promises = makePromises(burst);
+    for (const auto& promise : promises) list.track(promise);
+    auto pending = list.takeAll();
+    settleAll(pending);
+  });
+  auto cancelRegistry = bench::run("registry: track, cancel all", [&]() {
+    auto registry = std::make_shared<PendingOperationRegistry>();
+    auto promises = makePromises(burst);
+    for (const auto& promise : promises) registry->track(promise);
+    auto pending = registry->takeAll();
+    settleAll(pending);
+  });
+  bench::compare(cancelWeak, cancelRegistry);
+}
+
+} // namespace
+
+// Platform calls stay pending; logout drops them.
+std::shared_ptr<Promise<Result<AuthUser>>> PlatformAuth::login(AuthProvider, const std::optional<LoginOptions>&) {
+  return Promise<Result<AuthUser>>::create();
+}
+
+std::shared_ptr<Promise<Result<AuthUser>>> PlatformAuth::requestScopes(const std::vector<std::string>&) {
+  return Promise<Result<AuthUser>>::create();
+}
+
+std::shared_ptr<Promise<Result<AuthTokens>>> PlatformAuth::refreshToken(const std::optional<AuthProvider>&,
+                                                                        const std::vector<std::string>&) {
+  return Promise<Result<AuthTokens>>::create();
+}
+
+std::shared_ptr<Promise<Result<std::optional<AuthUser>>>> PlatformAuth::silentRestore() {
+  return Promise<Result<std::optional<AuthUser>>>::create();
+}
+
+bool PlatformAuth::hasPlayServices() {
+  return true;
+}
+
+std::shared_ptr<Promise<Result<std::string>>> PlatformAuth::authorizeInBrowser(const std::string&, const std::string&) {
+  return Promise<Result<std::string>>::create();
+}
+
+std::shared_ptr<HttpClient> PlatformAuth::httpClient() {
+  return nullptr;
+}
+
+std::string PlatformAuth::cacheDirectory() {
+  return "";
+}
+
+std::vector<std::string> PlatformAuth::discoveryAuthorities() {
+  return {};
+}
+
+void PlatformAuth::logout() {}
+
+std::shared_ptr<Promise<Result<void>>> PlatformAuth::revokeAccess() {
+  auto promise = Promise<Result<void>>::create();
+  promise->resolve(Result<void>());
+  return promise;
+}
+
+void PlatformAuth::cancel(PlatformOperation, const std::string&) {}
+
+int main() {
+  for (size_t burst : {1'000, 4'000}) compareRegistries(burst);
+
+  std::printf("HybridAuth\n");
+  auto auth = std::make_shared<HybridAuth>();
+  const std::vector<std::string> scopes{"https://www.googleapis.com/auth/drive.readonly"};
+  for (size_t burst : {1'000, 4'000}) {
+    auto result = bench::run("queue " + std::to_string(burst) + " requestScopes/silentRestore, logout", [&]() {
+      for (size_t i = 0; i < burst; i++) {
+        bench::doNotOptimize(i % 2 == 0 ? auth->requestScopes(scopes) : auth->silentRestore());
+      }
+      auth->logout();
+    });
+    std::printf("  -> %.1f ns per queued call\n", result.nsPerOp / static_cast<double>(burst));
+  }
+  return 0;
+}
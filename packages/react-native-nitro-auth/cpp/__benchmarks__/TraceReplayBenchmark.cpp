@@ -0,0 +1,584 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <deque>
+#include <fstream>
+#include <iterator>
+#include <memory>
+#include <optional>
+#include <random>
+#include <sstream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "../AuthTrace.hpp"
+#include "../HybridAuth.hpp"
+#include "../PlatformAuth.hpp"
+#include "../__tests__/VirtualTime.hpp"
+#if defined(NITRO_AUTH_REPLAY_LOOPBACK)
+#include "LoopbackOAuthServer.hpp"
+#include "PlatformAuth+Linux.hpp"
+#endif
+
+// Replays recorded core traffic for thousands of simulated users and reports
+// throughput, tail latency and platform calls. Each user is a fresh HybridAuth
+// in its own virtual time, running the trace with its inter-event gaps scaled
+// by a seeded random factor, so token expiries fall at different points of the
+// traffic. Latency is the wall time of issuing one call; platform work
+// completes later in virtual time.
+//
+// The default build answers platform calls from the trace's own recorded
+// outcomes (errors and token lifetimes). Built with NITRO_AUTH_REPLAY_LOOPBACK,
+// calls go through the Linux PlatformAuth to a LoopbackOAuthServer instead,
+// which decides outcomes itself apart from scripted consent.
+//
+//   replay [trace-file] [users]
+//
+// Without a trace file, a built-in day of app traffic is recorded first.
+
+using namespace margelo::nitro::NitroAuth;
+
+namespace margelo::nitro::NitroAuth {
+
+void HybridAuthSpec::loadHybridMethods() {}
+
+} // namespace margelo::nitro::NitroAuth
+
+namespace {
+
+constexpr int64_t kMinuteMs = 60 * 1000;
+constexpr int64_t kHourMs = 60 * kMinuteMs;
+// Virtual epoch of every replay, a plausible wall-clock time.
+constexpr int64_t kStartMs = 1'700'000'000'000;
+
+// The user a platform signs in for trace account `ordinal`.
+AuthUser replayUser(AuthProvider provider, uint32_t ordinal) {
+  AuthUser user;
+  user.provider = provider;
+  user.userId = "replay-" + std::to_string(ordinal);
+  return user;
+}
+
+// Account ids of the trace's accounts, from each sign-in call and the outcome that follows it.
+std::unordered_map<uint32_t, std::string> accountIdsOf(const std::vector<AuthTraceEvent>& trace) {
+  std::unordered_map<uint32_t, std::string> ids;
+  std::optional<AuthProvider> provider;
+  for (const auto& event : trace) {
+    if (event.op == AuthTraceOp::LOGIN) provider = event.provider;
+    if (event.op == AuthTraceOp::PLATFORM_LOGIN && event.account && !event.error) {
+      ids.try_emplace(*event.account, AccountRegistry::accountIdFor(replayUser(provider.value_or(AuthProvider::GOOGLE),
+                                                                               *event.account)));
+    }
+  }
+  return ids;
+}
+
+// Forwards to the virtual time of the user being replayed, so a server started
+// once follows every user's clock.
+class ReplayClock final : public AuthClock {
+public:
+  int64_t nowMs() override { return _time ? _time->nowMs() : kStartMs; }
+  void follow(std::shared_ptr<VirtualTime> time) { _time = std::move(time); }
+
+private:
+  std::shared_ptr<VirtualTime> _time;
+};
+
+const auto gClock = std::make_shared<ReplayClock>();
+
+} // namespace
+
+#if !defined(NITRO_AUTH_REPLAY_LOOPBACK)
+
+namespace {
+
+// Answers platform calls after `latencyMs` of virtual time with the next
+// recorded outcome of their kind; success with a one-hour token once those run out.
+struct ReplayPlatform {
+  std::shared_ptr<VirtualTime> time;
+  int64_t latencyMs = 300;
+  std::deque<AuthTraceEvent> logins;
+  std::deque<AuthTraceEvent> refreshes;
+  std::deque<AuthTraceEvent> restores;
+  std::optional<AuthUser> keychain;
+  uint64_t calls = 0;
+  uint64_t nextToken = 0;
+
+  std::shared_ptr<Promise<Result<AuthUser>>> pendingLogin;
+  std::shared_ptr<Promise<Result<AuthUser>>> pendingScopes;
+  std::shared_ptr<Promise<Result<AuthTokens>>> pendingRefresh;
+  std::shared_ptr<Promise<Result<std::optional<AuthUser>>>> pendingRestore;
+
+  void reset(std::shared_ptr<VirtualTime> virtualTime, const std::vector<AuthTraceEvent>& trace) {
+    const uint64_t callsSoFar = calls;
+    *this = ReplayPlatform{};
+    calls = callsSoFar;
+    time = std::move(virtualTime);
+    for (const auto& event : trace) {
+      if (event.op == AuthTraceOp::PLATFORM_LOGIN) logins.push_back(event);
+      if (event.op == AuthTraceOp::PLATFORM_REFRESH) refreshes.push_back(event);
+      if (event.op == AuthTraceOp::PLATFORM_RESTORE) restores.push_back(event);
+    }
+  }
+
+  static AuthTraceEvent next(std::deque<AuthTraceEvent>& outcomes) {
+    if (outcomes.empty()) return AuthTraceEvent{};
+    auto outcome = std::move(outcomes.front());
+    outcomes.pop_front();
+    return outcome;
+  }
+
+  void stamp(const AuthTraceEvent& outcome, std::optional<std::string>& accessToken,
+             std::optional<double>& expirationTime) {
+    accessToken = "access-" + std::to_string(nextToken++);
+    expirationTime = static_cast<double>(time->nowMs() + outcome.lifetimeMs.value_or(kHourMs));
+  }
+
+  std::shared_ptr<Promise<Result<AuthUser>>> signIn(std::shared_ptr<Promise<Result<AuthUser>>>& slot,
+                                                    AuthProvider provider, std::vector<std::string> scopes) {
+    calls++;
+    auto promise = Promise<Result<AuthUser>>::create();
+    slot = promise;
+    auto outcome = next(logins);
+    time->schedule(latencyMs, [this, &slot, promise, provider, outcome, scopes]() {
+      if (!promise->isPending()) return;
+      slot = nullptr;
+      if (outcome.error) {
+        promise->resolve(AuthError(*outcome.error));
+        return;
+      }
+      auto user = replayUser(provider, outcome.account.value_or(0));
+      stamp(outcome, user.accessToken, user.expirationTime);
+      if (!scopes.empty()) user.scopes = scopes;
+      keychain = user;
+      promise->resolve(user);
+    });
+    return promise;
+  }
+};
+
+ReplayPlatform gPlatform;
+
+} // namespace
+
+namespace margelo::nitro::NitroAuth {
+
+std::shared_ptr<Promise<Result<AuthUser>>> PlatformAuth::login(AuthProvider provider,
+                                                               const std::optional<LoginOptions>& options) {
+  std::vector<std::string> scopes;
+  if (options && options->scopes) scopes = *options->scopes;
+  return gPlatform.signIn(gPlatform.pendingLogin, provider, std::move(scopes));
+}
+
+std::shared_ptr<Promise<Result<AuthUser>>> PlatformAuth::requestScopes(const std::vector<std::string>& scopes) {
+  const auto provider = gPlatform.keychain ? gPlatform.keychain->provider : AuthProvider::GOOGLE;
+  return gPlatform.signIn(gPlatform.pendingScopes, provider, scopes);
+}
+
+std::shared_ptr<Promise<Result<AuthTokens>>> PlatformAuth::refreshToken(const std::optional<AuthProvider>&,
+                                                                        const std::vector<std::string>&) {
+  gPlatform.calls++;
+  auto promise = Promise<Result<AuthTokens>>::create();
+  gPlatform.pendingRefresh = promise;
+  auto outcome = ReplayPlatform::next(gPlatform.refreshes);
+  gPlatform.time->schedule(gPlatform.latencyMs, [promise, outcome]() {
+    if (!promise->isPending()) return;
+    gPlatform.pendingRefresh = nullptr;
+    if (outcome.error) {
+      promise->resolve(AuthError(*outcome.error));
+      return;
+    }
+    AuthTokens tokens;
+    gPlatform.stamp(outcome, tokens.accessToken, tokens.expirationTime);
+    promise->resolve(tokens);
+  });
+  return promise;
+}
+
+std::shared_ptr<Promise<Result<std::optional<AuthUser>>>> PlatformAuth::silentRestore() {
+  gPlatform.calls++;
+  auto promise = Promise<Result<std::optional<AuthUser>>>::create();
+  gPlatform.pendingRestore = promise;
+  auto outcome = ReplayPlatform::next(gPlatform.restores);
+  gPlatform.time->schedule(gPlatform.latencyMs, [promise, outcome]() {
+    if (!promise->isPending()) return;
+    gPlatform.pendingRestore = nullptr;
+    if (outcome.error == AuthErrorCode::NOT_SIGNED_IN || (!outcome.error && !gPlatform.keychain)) {
+      promise->resolve(std::optional<AuthUser>());
+    } else if (outcome.error) {
+      promise->resolve(AuthError(*outcome.error));
+    } else {
+      promise->resolve(gPlatform.keychain);
+    }
+  });
+  return promise;
+}
+
+bool PlatformAuth::hasPlayServices() {
+  return true;
+}
+
+std::shared_ptr<Promise<Result<std::string>>> PlatformAuth::authorizeInBrowser(const std::string&, const std::string&) {
+  auto promise = Promise<Result<std::string>>::create();
+  promise->resolve(AuthError(AuthErrorCode::UNSUPPORTED_PROVIDER));
+  return promise;
+}
+
+std::shared_ptr<HttpClient> PlatformAuth::httpClient() {
+  return nullptr;
+}
+
+std::string PlatformAuth::cacheDirectory() {
+  return "";
+}
+
+std::vector<std::string> PlatformAuth::discoveryAuthorities() {
+  return {};
+}
+
+void PlatformAuth::logout() {
+  gPlatform.keychain = std::nullopt;
+}
+
+std::shared_ptr<Promise<Result<void>>> PlatformAuth::revokeAccess() {
+  gPlatform.calls++;
+  gPlatform.keychain = std::nullopt;
+  auto promise = Promise<Result<void>>::create();
+  promise->resolve(Result<void>());
+  return promise;
+}
+
+void PlatformAuth::cancel(PlatformOperation operation, const std::string& reason) {
+  const AuthError error(reason);
+  switch (operation) {
+    case PlatformOperation::LOGIN:
+      if (auto promise = std::exchange(gPlatform.pendingLogin, nullptr)) promise->resolve(error);
+      break;
+    case PlatformOperation::REQUEST_SCOPES:
+      if (auto promise = std::exchange(gPlatform.pendingScopes, nullptr)) promise->resolve(error);
+      break;
+    case PlatformOperation::REFRESH_TOKEN:
+      if (auto promise = std::exchange(gPlatform.pendingRefresh, nullptr)) promise->resolve(error);
+      break;
+    case PlatformOperation::SILENT_RESTORE:
+      if (auto promise = std::exchange(gPlatform.pendingRestore, nullptr)) promise->resolve(std::optional<AuthUser>());
+      break;
+  }
+}
+
+} // namespace margelo::nitro::NitroAuth
+
+namespace {
+
+constexpr const char* kPlatformName = "mock platform";
+constexpr int kDefaultUsers = 2000;
+
+void startPlatform() {}
+
+void beginUser(const std::shared_ptr<VirtualTime>& time, const std::vector<AuthTraceEvent>& trace) {
+  gPlatform.reset(time, trace);
+}
+
+uint64_t platformCalls() {
+  return gPlatform.calls;
+}
+
+// Lets the built-in workload fail one refresh on purpose.
+void failNextRefresh(AuthErrorCode code) {
+  AuthTraceEvent outcome;
+  outcome.op = AuthTraceOp::PLATFORM_REFRESH;
+  outcome.error = code;
+  gPlatform.refreshes.push_back(outcome);
+}
+
+void scriptLogin(const std::optional<AuthTraceEvent>&) {}
+
+void stopPlatform() {}
+
+} // namespace
+
+#else
+
+namespace {
+
+constexpr const char* kPlatformName = "loopback server";
+// Every sign-in RS256-signs an id_token on the server. The platform keeps
+// only the latest sign-in, so once the trace switches back to an earlier
+// account its refreshes fail as not_signed_in, as they would on a device.
+constexpr int kDefaultUsers = 20;
+
+std::shared_ptr<LoopbackOAuthServer> gServer;
+std::string gCacheDirectory;
+uint64_t gCallsAtUserStart = 0;
+
+uint64_t serverCalls() {
+  const auto stats = gServer->stats();
+  return stats.authorizations + stats.refreshes + stats.revocations;
+}
+
+void startPlatform() {
+  char directory[] = "/tmp/nitro-auth-replay-XXXXXX";
+  if (::mkdtemp(directory)) gCacheDirectory = directory;
+  LoopbackOAuthServerOptions options;
+  options.clock = gClock;
+  options.idTokenOnRefresh = false;
+  gServer = LoopbackOAuthServer::start(options);
+}
+
+void beginUser(const std::shared_ptr<VirtualTime>&, const std::vector<AuthTraceEvent>&) {
+  LinuxPlatformConfig config;
+  config.issuer = gServer->issuer();
+  config.cacheDirectory = gCacheDirectory;
+  config.clock = gClock;
+  LinuxPlatformAuth::configure(config);
+}
+
+uint64_t platformCalls() {
+  return serverCalls();
+}
+
+void failNextRefresh(AuthErrorCode) {}
+
+// The server signs in whoever consent says; make it the trace's account.
+void scriptLogin(const std::optional<AuthTraceEvent>& outcome) {
+  ConsentDecision decision;
+  if (outcome && outcome->error) {
+    decision.approve = false;
+  } else {
+    decision.subject = "replay-" + std::to_string(outcome && outcome->account ? *outcome->account : 0);
+  }
+  gServer->scriptConsent(decision);
+}
+
+void stopPlatform() {
+  gServer->stop();
+}
+
+} // namespace
+
+#endif
+
+namespace {
+
+struct ReplayStats {
+  std::vector<int64_t> latenciesNs;
+  uint64_t calls = 0;
+  uint64_t failedCalls = 0;
+  uint64_t skippedCalls = 0;
+};
+
+template <typename P>
+void countFailure(const std::shared_ptr<P>& promise, ReplayStats& stats) {
+  promise->addOnRejectedListener([&stats](const std::exception_ptr&) { stats.failedCalls++; });
+}
+
+std::optional<AccessTokenRequest> requestFor(const AuthTraceEvent& event) {
+  if (event.scopes.empty()) return std::nullopt;
+  AccessTokenRequest request;
+  request.scopes = event.scopes;
+  return request;
+}
+
+// The outcome of the sign-in call at `index`: the next PLATFORM_LOGIN after it.
+std::optional<AuthTraceEvent> loginOutcomeAfter(const std::vector<AuthTraceEvent>& trace, size_t index) {
+  for (size_t i = index + 1; i < trace.size(); i++) {
+    if (trace[i].op == AuthTraceOp::PLATFORM_LOGIN) return trace[i];
+  }
+  return std::nullopt;
+}
+
+void issue(const std::shared_ptr<HybridAuth>& auth, const std::vector<AuthTraceEvent>& trace, size_t index,
+           const std::unordered_map<uint32_t, std::string>& accountIds, ReplayStats& stats) {
+  const auto& event = trace[index];
+  std::optional<std::string> accountId;
+  if (event.account) {
+    auto it = accountIds.find(*event.account);
+    if (it == accountIds.end()) {
+      stats.skippedCalls++;
+      return;
+    }
+    accountId = it->second;
+  }
+  if (event.op == AuthTraceOp::LOGIN || event.op == AuthTraceOp::REQUEST_SCOPES) {
+    scriptLogin(loginOutcomeAfter(trace, index));
+  }
+
+  const auto start = std::chrono::steady_clock::now();
+  switch (event.op) {
+    case AuthTraceOp::LOGIN:
+      countFailure(auth->login(event.provider.value_or(AuthProvider::GOOGLE), std::nullopt), stats);
+      break;
+    case AuthTraceOp::LOGOUT:
+      auth->logout();
+      break;
+    case AuthTraceOp::SILENT_RESTORE:
+      countFailure(auth->silentRestore(), stats);
+      break;
+    case AuthTraceOp::GET_ACCESS_TOKEN:
+      countFailure(accountId ? auth->getAccessTokenForAccount(*accountId, requestFor(event))
+                             : auth->getAccessToken(requestFor(event)),
+                   stats);
+      break;
+    case AuthTraceOp::REFRESH_TOKEN:
+      countFailure(auth->refreshToken(), stats);
+      break;
+    case AuthTraceOp::SWITCH_ACCOUNT:
+      try {
+        if (accountId) auth->switchAccount(*accountId);
+      } catch (const std::exception&) {
+        stats.failedCalls++;
+      }
+      break;
+    case AuthTraceOp::REQUEST_SCOPES:
+      countFailure(auth->requestScopes(event.scopes), stats);
+      break;
+    case AuthTraceOp::REVOKE_ACCESS:
+      countFailure(auth->revokeAccess(), stats);
+      break;
+    case AuthTraceOp::PLATFORM_LOGIN:
+    case AuthTraceOp::PLATFORM_REFRESH:
+    case AuthTraceOp::PLATFORM_RESTORE:
+      return;
+  }
+  stats.latenciesNs.push_back(
+      std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count());
+  stats.calls++;
+}
+
+void replayUser(const std::vector<AuthTraceEvent>& trace, const std::unordered_map<uint32_t, std::string>& accountIds,
+                double timeScale, ReplayStats& stats) {
+  auto time = std::make_shared<VirtualTime>(kStartMs);
+  gClock->follow(time);
+  beginUser(time, trace);
+  auto auth = std::make_shared<HybridAuth>();
+  auth->setClock(time);
+  auth->setTimerService(time);
+
+  const int64_t originMs = trace.front().atMs;
+  for (size_t i = 0; i < trace.size(); i++) {
+    if (isPlatformOutcome(trace[i].op)) continue;
+    time->advanceTo(kStartMs + static_cast<int64_t>(static_cast<double>(trace[i].atMs - originMs) * timeScale));
+    issue(auth, trace, i, accountIds, stats);
+  }
+  // Settle whatever is still in flight.
+  time->advance(kHourMs);
+}
+
+// A day of app traffic: a cold start, then foregrounds every ~2 hours with a
+// burst of token reads as screens load, a steady trickle while the app is
+// open, a second account used now and then, and one failed refresh.
+std::vector<AuthTraceEvent> recordBuiltInTrace() {
+  auto time = std::make_shared<VirtualTime>(kStartMs);
+  gClock->follow(time);
+  beginUser(time, {});
+  auto recorder = std::make_shared<AuthTraceRecorder>();
+  auto auth = std::make_shared<HybridAuth>();
+  auth->setClock(time);
+  auth->setTimerService(time);
+  auth->setTraceRecorder(recorder);
+
+  std::mt19937 random(42);
+  auth->silentRestore();
+  time->advance(2000);
+  scriptLogin(std::nullopt);
+  auth->login(AuthProvider::GOOGLE, std::nullopt);
+  time->advance(5000);
+  std::string personal = auth->getAccounts().front().id;
+  std::optional<std::string> work;
+
+  for (int foreground = 0; foreground < 8; foreground++) {
+    time->advanceTo(kStartMs + foreground * 2 * kHourMs + std::uniform_int_distribution<int64_t>(0, 20 * kMinuteMs)(random));
+    if (foreground == 2) {
+      AuthTraceEvent workAccount;
+      workAccount.account = 1;
+      scriptLogin(workAccount);
+      auth->login(AuthProvider::MICROSOFT, std::nullopt);
+      time->advance(8000);
+      for (const auto& account : auth->getAccounts()) {
+        if (account.id != personal) work = account.id;
+      }
+    }
+    if (work && (foreground == 4 || foreground == 6)) auth->switchAccount(foreground == 4 ? *work : personal);
+    if (foreground == 5) failNextRefresh(AuthErrorCode::NETWORK_ERROR);
+
+    for (int i = 0; i < 6; i++) auth->getAccessToken();
+    time->advance(50);
+    const int64_t openUntil = time->nowMs() + std::uniform_int_distribution<int64_t>(3, 12)(random) * kMinuteMs;
+    while (time->nowMs() < openUntil) {
+      auth->getAccessToken();
+      if (work && foreground == 3) {
+        AccessTokenRequest request;
+        request.scopes = std::vector<std::string>{"email"};
+        auth->getAccessTokenForAccount(*work, request);
+      }
+      time->advance(std::uniform_int_distribution<int64_t>(5, 60)(random) * 1000);
+    }
+  }
+  time->advance(kHourMs);
+  return recorder->events();
+}
+
+std::optional<std::vector<AuthTraceEvent>> loadTrace(const char* path) {
+  std::ifstream file(path, std::ios::binary);
+  if (!file) return std::nullopt;
+  std::string data((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+  return AuthTraceFormat::decode(data);
+}
+
+int64_t percentile(std::vector<int64_t>& values, double fraction) {
+  if (values.empty()) return 0;
+  const auto index = std::min(values.size() - 1, static_cast<size_t>(fraction * static_cast<double>(values.size())));
+  std::nth_element(values.begin(), values.begin() + static_cast<std::ptrdiff_t>(index), values.end());
+  return values[index];
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+  startPlatform();
+  std::vector<AuthTraceEvent> trace;
+  if (argc > 1) {
+    auto loaded = loadTrace(argv[1]);
+    if (!loaded || loaded->empty()) {
+      std::fprintf(stderr, "%s is not a usable trace\n", argv[1]);
+      stopPlatform();
+      return 1;
+    }
+    trace = std::move(*loaded);
+  } else {
+    trace = recordBuiltInTrace();
+  }
+  const int users = argc > 2 ? std::max(1, std::atoi(argv[2])) : kDefaultUsers;
+  const auto encoded = AuthTraceFormat::encode(trace);
+  const auto accountIds = accountIdsOf(trace);
+
+  std::printf("Trace replay against the %s\n", kPlatformName);
+  std::printf("  trace: %zu events over %.1f h, %zu bytes encoded (%.1f bytes/event)\n", trace.size(),
+              static_cast<double>(trace.back().atMs - trace.front().atMs) / kHourMs, encoded.size(),
+              static_cast<double>(encoded.size()) / static_cast<double>(trace.size()));
+
+  ReplayStats stats;
+  std::mt19937 random(7);
+  const uint64_t callsBefore = platformCalls();
+  const auto start = std::chrono::steady_clock::now();
+  for (int user = 0; user < users; user++) {
+    replayUser(trace, accountIds, std::uniform_real_distribution<double>(0.8, 1.25)(random), stats);
+  }
+  const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+  const uint64_t calls = platformCalls() - callsBefore;
+
+  std::printf("  %d users, %llu calls in %.2f s: %.0f calls/s\n", users, static_cast<unsigned long long>(stats.calls),
+              seconds, static_cast<double>(stats.calls) / seconds);
+  const int64_t p50 = percentile(stats.latenciesNs, 0.50);
+  const int64_t p99 = percentile(stats.latenciesNs, 0.99);
+  const int64_t p999 = percentile(stats.latenciesNs, 0.999);
+  const int64_t max = stats.latenciesNs.empty() ? 0 : *std::max_element(stats.latenciesNs.begin(), stats.latenciesNs.end());
+  std::printf("  issue latency: p50 %lld ns, p99 %lld ns, p99.9 %lld ns, max %lld ns\n", static_cast<long long>(p50),
+              static_cast<long long>(p99), static_cast<long long>(p999), static_cast<long long>(max));
+  std::printf("  platform calls: %llu (%.1f per user), failed calls: %llu, skipped: %llu\n",
+              static_cast<unsigned long long>(calls), static_cast<double>(calls) / users,
+              static_cast<unsigned long long>(stats.failedCalls), static_cast<unsigned long long>(stats.skippedCalls));
+  stopPlatform();
+  return 0;
+}
@@ -0,0 +1,62 @@
+#include <memory>
+#include <string>
+#include <vector>
+#include "../AuthUserHostObject.hpp"
+#include "Benchmark.hpp"
+
+using namespace margelo::nitro;
+using namespace margelo::nitro::NitroAuth;
+
+namespace {
+
+// Roughly a Google session: a ~900 byte id_token, a 200 byte access token and profile data.
+AuthUser makeTypicalUser() {
+  AuthUser user;
+  user.provider = AuthProvider::GOOGLE;
+  user.email = "jane.doe@example.com";
+  user.name = "Jane Doe";
+  user.photo = "https://lh3.googleusercontent.com/a/ACg8ocJ1234567890abcdefghijklmnopqrstuvwxyz=s96-c";
+  user.idToken = std::string(900, 'i');
+  user.accessToken = "ya29." + std::string(200, 'a');
+  user.refreshToken = "1//0g" + std::string(100, 'r');
+  user.userId = "110169484474386276334";
+  user.scopes = std::vector<std::string>{"openid", "email", "profile", "https://www.googleapis.com/auth/drive.readonly"};
+  user.expirationTime = 1'700'000'000'000.0;
+  return user;
+}
+
+} // namespace
+
+// Costs are against the in-memory JSI mock, so they compare the conversion work
+// done, not what Hermes would spend on the same objects.
+int main() {
+  jsi::Runtime runtime;
+  const PackedAuthUser packed(makeTypicalUser());
+
+  // A render that reads the two profile fields of a fresh session.
+  auto eager = bench::run("eager AuthUser + read email, name", [&]() {
+    auto object = JSIConverter<AuthUser>::toJSI(runtime, packed.unpack()).asObject(runtime);
+    bench::doNotOptimize(object.getProperty(runtime, "email"));
+    bench::doNotOptimize(object.getProperty(runtime, "name"));
+  });
+  auto lazy = bench::run("host object + read email, name", [&]() {
+    auto object = jsi::Object::createFromHostObject(runtime, std::make_shared<AuthUserHostObject>(packed));
+    bench::doNotOptimize(object.getProperty(runtime, "email"));
+    bench::doNotOptimize(object.getProperty(runtime, "name"));
+  });
+  bench::compare(eager, lazy);
+
+  // Re-renders of an unchanged session: getCurrentUser converts again, the view is reused.
+  auto eagerAgain = bench::run("eager AuthUser per render", [&]() {
+    bench::doNotOptimize(JSIConverter<AuthUser>::toJSI(runtime, packed.unpack()));
+  });
+  auto view = std::make_shared<AuthUserHostObject>(packed);
+  auto cached = jsi::Object::createFromHostObject(runtime, view);
+  cached.getProperty(runtime, "email");
+  auto lazyAgain = bench::run("reused view + read email", [&]() {
+    auto object = jsi::Object::createFromHostObject(runtime, view);
+    bench::doNotOptimize(object.getProperty(runtime, "email"));
+  });
+  bench::compare(eagerAgain, lazyAgain);
+  return 0;
+}
@@ -0,0 +1,122 @@
+#include <cassert>
+#include <iostream>
+#include <string>
+#include <vector>
+#include "../AccessTokenCache.hpp"
+
+using namespace margelo::nitro::NitroAuth;
+
+namespace {
+
+AccessTokenRequest makeRequest(const std::optional<std::string>& resource,
+                               const std::optional<std::vector<std::string>>& scopes = std::nullopt) {
+  AccessTokenRequest request;
+  request.resource = resource;
+  request.scopes = scopes;
+  return request;
+}
+
+void testScopesAreQualifiedAndNormalized() {
+  assert(AccessTokenCache::scopesFor(makeRequest(std::nullopt)).empty());
+  assert(AccessTokenCache::scopesFor(makeRequest(std::nullopt, std::vector<std::string>{})).empty());
+
+  assert(AccessTokenCache::scopesFor(makeRequest("https://graph.microsoft.com/")) ==
+         std::vector<std::string>{"https://graph.microsoft.com/.default"});
+
+  auto scopes = AccessTokenCache::scopesFor(makeRequest(
+    "https://graph.microsoft.com",
+    std::vector<std::string>{"User.Read", "openid", "Mail.Read", "User.Read", "api://custom/Read", ""}));
+  assert((scopes == std::vector<std::string>{
+    "api://custom/Read",
+    "https://graph.microsoft.com/Mail.Read",
+    "https://graph.microsoft.com/User.Read",
+    "openid",
+  }));
+
+  // Scope order never splits the cache.
+  auto a = AccessTokenCache::keyFor("microsoft:a", AccessTokenCache::scopesFor(
+    makeRequest(std::nullopt, std::vector<std::string>{"b", "a"})));
+  auto b = AccessTokenCache::keyFor("microsoft:a", AccessTokenCache::scopesFor(
+    makeRequest(std::nullopt, std::vector<std::string>{"a", "b"})));
+  assert(a == b);
+  assert(a != AccessTokenCache::keyFor("microsoft:b", {"a", "b"}));
+}
+
+void testLeastRecentlyUsedEntryIsEvicted() {
+  AccessTokenCacheLimits limits;
+  limits.maxEntries = 2;
+  AccessTokenCache cache(limits);
+
+  cache.put("acct\ngraph", {"graph-token", 1000.0});
+  cache.put("acct\nsharepoint", {"sharepoint-token", std::nullopt});
+  assert(cache.find("acct\ngraph")->accessToken == "graph-token");
+  cache.put("acct\napi", {"api-token", std::nullopt});
+
+  assert(!cache.find("acct\nsharepoint").has_value());
+  assert(cache.find("acct\ngraph")->expirationTime == 1000.0);
+  assert(cache.find("acct\napi").has_value());
+  auto stats = cache.stats();
+  assert(stats.entries == 2);
+  assert(stats.evictions == 1);
+  assert(stats.hits == 3);
+  assert(stats.misses == 1);
+
+  // Replacing an entry does not count as an eviction or grow the cache.
+  cache.put("acct\napi", {"api-token-2", std::nullopt});
+  assert(cache.stats().entries == 2);
+  assert(cache.stats().evictions == 1);
+  assert(cache.find("acct\napi")->accessToken == "api-token-2");
+}
+
+void testMemoryCapBoundsFootprint() {
+  AccessTokenCacheLimits limits;
+  limits.maxBytes = 1024;
+  AccessTokenCache cache(limits);
+
+  for (int i = 0; i < 50; ++i) {
+    cache.put("acct\nresource-" + std::to_string(i), {std::string(100, 'x'), std::nullopt});
+    assert(cache.stats().bytes <= limits.maxBytes);
+  }
+  assert(cache.stats().entries > 0);
+  assert(cache.find("acct\nresource-49").has_value());
+  assert(!cache.find("acct\nresource-0").has_value());
+
+  // A token larger than the whole budget is not cached and evicts nothing.
+  auto before = cache.stats();
+  cache.put("acct\nhuge", {std::string(4096, 'x'), std::nullopt});
+  assert(!cache.find("acct\nhuge").has_value());
+  assert(cache.stats().entries == before.entries);
+
+  limits.maxBytes = 0;
+  cache.setLimits(limits);
+  assert(cache.stats().entries == 0);
+  assert(cache.stats().bytes == 0);
+}
+
+void testEraseAccountKeepsOtherAccounts() {
+  AccessTokenCache cache;
+  cache.put(AccessTokenCache::keyFor("microsoft:a", {"graph"}), {"a-graph", std::nullopt});
+  cache.put(AccessTokenCache::keyFor("microsoft:a", {"api"}), {"a-api", std::nullopt});
+  cache.put(AccessTokenCache::keyFor("microsoft:ab", {"graph"}), {"ab-graph", std::nullopt});
+
+  cache.eraseAccount("microsoft:a");
+  assert(!cache.find(AccessTokenCache::keyFor("microsoft:a", {"graph"})).has_value());
+  assert(!cache.find(AccessTokenCache::keyFor("microsoft:a", {"api"})).has_value());
+  assert(cache.find(AccessTokenCache::keyFor("microsoft:ab", {"graph"}))->accessToken == "ab-graph");
+
+  cache.clear();
+  assert(cache.stats().entries == 0);
+  assert(cache.stats().bytes == 0);
+}
+
+} // namespace
+
+int main() {
+  testScopesAreQualifiedAndNormalized();
+  testLeastRecentlyUsedEntryIsEvicted();
+  testMemoryCapBoundsFootprint();
+  testEraseAccountKeepsOtherAccounts();
+
+  std::cout << "AccessTokenCache tests passed!" << std::endl;
+  return 0;
+}
@@ -0,0 +1,82 @@
+#include <cassert>
+#include <iostream>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include "../AuthResult.hpp"
+
+using namespace margelo::nitro::NitroAuth;
+
+namespace {
+
+std::string whatOf(const std::exception_ptr& error) {
+  try {
+    std::rethrow_exception(error);
+  } catch (const std::exception& e) {
+    return e.what();
+  }
+}
+
+void testCodesRoundTripThroughTheirNames() {
+  for (size_t i = 0; i < kAuthErrorCodeNames.size(); i++) {
+    const auto code = static_cast<AuthErrorCode>(i);
+    assert(parseAuthErrorCode(toString(code)) == code);
+  }
+  static_assert(toString(AuthErrorCode::NOT_SIGNED_IN) == "not_signed_in");
+  static_assert(parseAuthErrorCode("storage_error") == AuthErrorCode::STORAGE_ERROR);
+  static_assert(!parseAuthErrorCode("Not_Signed_In").has_value());
+}
+
+void testPlatformMessagesKeepTheirText() {
+  AuthError known("network_error");
+  assert(known.code() == AuthErrorCode::NETWORK_ERROR);
+  assert(known.message() == "network_error");
+  assert(known == AuthErrorCode::NETWORK_ERROR);
+
+  AuthError platform("Android Context not initialized");
+  assert(platform.code() == AuthErrorCode::UNKNOWN);
+  assert(platform.message() == "Android Context not initialized");
+  assert(!(platform == AuthErrorCode::UNKNOWN));
+  assert(AuthError("unknown") == AuthErrorCode::UNKNOWN);
+}
+
+void testResultHoldsAValueOrAnError() {
+  Result<std::string> value(std::string("token"));
+  assert(value.ok() && value);
+  assert(value.value() == "token");
+  assert(std::move(value).value() == "token");
+
+  Result<std::string> failed(AuthErrorCode::TOKEN_ERROR);
+  assert(!failed.ok());
+  assert(failed.error().code() == AuthErrorCode::TOKEN_ERROR);
+
+  Result<void> done;
+  assert(done.ok());
+  Result<void> cancelled(AuthError("cancelled"));
+  assert(!cancelled && cancelled.error().code() == AuthErrorCode::CANCELLED);
+}
+
+void testKnownCodesShareOnePreallocatedException() {
+  const auto first = AuthError(AuthErrorCode::CANCELLED).toException();
+  const auto second = AuthError("cancelled").toException();
+  assert(first == second);
+  assert(whatOf(first) == "cancelled");
+  assert(AuthError(AuthErrorCode::TIMEOUT).toException() != first);
+
+  // Unknown messages are not cached; each rejection gets its own.
+  const auto platform = AuthError("JNI call failed").toException();
+  assert(platform != AuthError("JNI call failed").toException());
+  assert(whatOf(platform) == "JNI call failed");
+}
+
+} // namespace
+
+int main() {
+  testCodesRoundTripThroughTheirNames();
+  testPlatformMessagesKeepTheirText();
+  testResultHoldsAValueOrAnError();
+  testKnownCodesShareOnePreallocatedException();
+
+  std::cout << "AuthResult tests passed!" << std::endl;
+  return 0;
+}
@@ -0,0 +1,126 @@
+#include <cassert>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+#include "../AuthTrace.hpp"
+
+using namespace margelo::nitro::NitroAuth;
+
+namespace {
+
+std::vector<AuthTraceEvent> sampleTrace() {
+  std::vector<AuthTraceEvent> events;
+  AuthTraceEvent login;
+  login.atMs = 1'700'000'000'000;
+  login.op = AuthTraceOp::LOGIN;
+  login.provider = AuthProvider::MICROSOFT;
+  events.push_back(login);
+
+  AuthTraceEvent signedIn;
+  signedIn.atMs = login.atMs + 850;
+  signedIn.op = AuthTraceOp::PLATFORM_LOGIN;
+  signedIn.account = 0;
+  signedIn.lifetimeMs = 3'600'000;
+  events.push_back(signedIn);
+
+  AuthTraceEvent resource;
+  resource.atMs = signedIn.atMs + 12;
+  resource.op = AuthTraceOp::GET_ACCESS_TOKEN;
+  resource.account = 1;
+  resource.scopes = {"https://graph.microsoft.com/Mail.Read", "offline_access"};
+  events.push_back(resource);
+
+  AuthTraceEvent failed;
+  // Clocks can step backwards; deltas are signed.
+  failed.atMs = resource.atMs - 5;
+  failed.op = AuthTraceOp::PLATFORM_REFRESH;
+  failed.error = AuthErrorCode::NETWORK_ERROR;
+  events.push_back(failed);
+
+  AuthTraceEvent logout;
+  logout.atMs = failed.atMs + 86'400'000;
+  logout.op = AuthTraceOp::LOGOUT;
+  events.push_back(logout);
+  return events;
+}
+
+void testEventsRoundTrip() {
+  const auto events = sampleTrace();
+  const auto encoded = AuthTraceFormat::encode(events);
+  assert(encoded.compare(0, 4, "NATR") == 0);
+  auto decoded = AuthTraceFormat::decode(encoded);
+  assert(decoded && *decoded == events);
+
+  auto empty = AuthTraceFormat::decode(AuthTraceFormat::encode({}));
+  assert(empty && empty->empty());
+}
+
+void testEncodingIsCompact() {
+  std::vector<AuthTraceEvent> burst;
+  for (int i = 0; i < 1000; i++) {
+    AuthTraceEvent event;
+    event.atMs = 1'700'000'000'000 + i * 40;
+    event.op = AuthTraceOp::GET_ACCESS_TOKEN;
+    burst.push_back(event);
+  }
+  // One byte of delta, the op and an empty field mask.
+  assert(AuthTraceFormat::encode(burst).size() <= 5 + 10 + 3 * burst.size());
+}
+
+void testMalformedTracesAreRejected() {
+  const auto encoded = AuthTraceFormat::encode(sampleTrace());
+  for (size_t size = 0; size < encoded.size(); size++) {
+    auto truncated = AuthTraceFormat::decode(std::string_view(encoded).substr(0, size));
+    // Cutting exactly between events still leaves a valid, shorter trace.
+    assert(!truncated || truncated->size() < sampleTrace().size());
+  }
+  assert(!AuthTraceFormat::decode("NATX\x01"));
+  assert(!AuthTraceFormat::decode(std::string("NATR\x02", 5)));
+  // Unknown op, unknown field bit, provider and error out of range.
+  assert(!AuthTraceFormat::decode(std::string("NATR\x01\x00\x20\x00", 8)));
+  assert(!AuthTraceFormat::decode(std::string("NATR\x01\x00\x00\x40", 8)));
+  assert(!AuthTraceFormat::decode(std::string("NATR\x01\x00\x00\x01\x09", 9)));
+  assert(!AuthTraceFormat::decode(std::string("NATR\x01\x00\x08\x02\x7F", 9)));
+  // A scope list claiming more bytes than remain.
+  assert(!AuthTraceFormat::decode(std::string("NATR\x01\x00\x03\x10\x01\x40x", 11)));
+}
+
+void testRecorderNumbersAccountsAndDropsPastItsCap() {
+  AuthTraceRecorder recorder(3);
+  assert(recorder.accountOrdinal("google:alice@example.com") == 0);
+  assert(recorder.accountOrdinal("microsoft:bob") == 1);
+  assert(recorder.accountOrdinal("google:alice@example.com") == 0);
+
+  std::vector<std::thread> threads;
+  for (int i = 0; i < 4; i++) {
+    threads.emplace_back([&recorder]() {
+      AuthTraceEvent event;
+      event.op = AuthTraceOp::GET_ACCESS_TOKEN;
+      recorder.record(event);
+    });
+  }
+  for (auto& thread : threads) thread.join();
+
+  auto stats = recorder.stats();
+  assert(stats.events == 3);
+  assert(stats.dropped == 1);
+  assert(stats.accounts == 2);
+  assert(AuthTraceFormat::decode(recorder.encode())->size() == 3);
+
+  recorder.clear();
+  assert(recorder.stats().events == 0);
+  assert(recorder.accountOrdinal("microsoft:bob") == 0);
+}
+
+} // namespace
+
+int main() {
+  testEventsRoundTrip();
+  testEncodingIsCompact();
+  testMalformedTracesAreRejected();
+  testRecorderNumbersAccountsAndDropsPastItsCap();
+
+  std::cout << "AuthTrace tests passed!" << std::endl;
+  return 0;
+}
@@ -0,0 +1,93 @@
+#include <cassert>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+#include "../AuthUserHostObject.hpp"
+
+using namespace margelo::nitro;
+using namespace margelo::nitro::NitroAuth;
+
+namespace {
+
+AuthUser fullUser() {
+  AuthUser user;
+  user.provider = AuthProvider::GOOGLE;
+  user.email = "jane@example.com";
+  user.name = "Jane";
+  user.photo = "";
+  user.idToken = std::string(900, 'i');
+  user.accessToken = "access-1";
+  user.refreshToken = "refresh-1";
+  user.userId = "110169484474386276334";
+  user.hostedDomain = "example.com";
+  user.scopes = std::vector<std::string>{"openid", "email"};
+  user.expirationTime = 1'700'000'000'000.0;
+  return user;
+}
+
+bool sameValue(jsi::Runtime& runtime, const jsi::Value& a, const jsi::Value& b) {
+  if (a.isUndefined() || b.isUndefined()) return a.isUndefined() && b.isUndefined();
+  if (a.isNumber() || b.isNumber()) return a.isNumber() && b.isNumber() && a.getNumber() == b.getNumber();
+  if (a.isString() || b.isString()) {
+    return a.isString() && b.isString() && a.getString(runtime).utf8(runtime) == b.getString(runtime).utf8(runtime);
+  }
+  return JSIConverter<std::vector<std::string>>::fromJSI(runtime, a) ==
+         JSIConverter<std::vector<std::string>>::fromJSI(runtime, b);
+}
+
+void testMatchesEagerConversion() {
+  jsi::Runtime runtime;
+  const auto user = fullUser();
+  auto eager = JSIConverter<AuthUser>::toJSI(runtime, user).asObject(runtime);
+  auto host = std::make_shared<AuthUserHostObject>(PackedAuthUser(user));
+  auto lazy = jsi::Object::createFromHostObject(runtime, host);
+
+  const auto names = lazy.getPropertyNames(runtime);
+  assert(names.size() == AuthUserHostObject::kPropertyCount);
+  for (const auto& name : names) {
+    assert(sameValue(runtime, eager.getProperty(runtime, name), lazy.getProperty(runtime, name)));
+  }
+  assert(lazy.getProperty(runtime, "unknown").isUndefined());
+  // Read back through the generated converter as any native call would.
+  assert(JSIConverter<AuthUser>::fromJSI(runtime, jsi::Value(lazy)) == user);
+}
+
+void testConvertsOnlyWhatIsRead() {
+  jsi::Runtime runtime;
+  auto host = std::make_shared<AuthUserHostObject>(PackedAuthUser(fullUser()));
+  auto object = jsi::Object::createFromHostObject(runtime, host);
+  assert(host->materializedCount() == 0);
+
+  const auto email = object.getProperty(runtime, "email");
+  object.getProperty(runtime, "email");
+  assert(host->materializedCount() == 1);
+  assert(email.getString(runtime).utf8(runtime) == "jane@example.com");
+
+  object.getProperty(runtime, "phoneNumber");
+  object.getProperty(runtime, "scopes");
+  assert(host->materializedCount() == 3);
+  // Listing keys converts nothing.
+  object.getPropertyNames(runtime);
+  assert(host->materializedCount() == 3);
+}
+
+void testSnapshotIdentity() {
+  PackedAuthUser packed(fullUser());
+  AuthUserHostObject host(packed);
+  assert(host.user().isSameSnapshot(packed));
+  assert(!host.user().isSameSnapshot(PackedAuthUser(fullUser())));
+  assert(!host.user().isSameSnapshot(packed.with(AuthUserField::ACCESS_TOKEN, std::string_view("access-2"))));
+  assert(!PackedAuthUser().isSameSnapshot(PackedAuthUser()));
+}
+
+} // namespace
+
+int main() {
+  testMatchesEagerConversion();
+  testConvertsOnlyWhatIsRead();
+  testSnapshotIdentity();
+
+  std::cout << "AuthUserHostObject tests passed!" << std::endl;
+  return 0;
+}
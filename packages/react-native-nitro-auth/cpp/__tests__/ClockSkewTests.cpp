@@ -0,0 +1,128 @@
+#include <cassert>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <utility>
+#include "../ClockSkew.hpp"
+#include "VirtualTime.hpp"
+
+using namespace margelo::nitro::NitroAuth;
+
+namespace {
+
+constexpr int64_t kStartMs = 1700000000000;
+
+// Answers every request synchronously with `date` as its Date header, if set.
+class DatedHttpClient : public HttpClient {
+public:
+  void send(const HttpRequest&, Completion completion) override {
+    HttpResponse response;
+    response.status = 200;
+    if (!date.empty()) response.headers["date"] = date;
+    completion(std::move(response));
+  }
+
+  std::string date;
+};
+
+void testNoSamplesMeansNoCorrection() {
+  ClockSkewEstimator skew(std::make_shared<VirtualTime>(kStartMs));
+  assert(skew.skewMs() == 0);
+  auto estimate = skew.estimate();
+  assert(estimate.samples == 0);
+  assert(estimate.rejectedSamples == 0);
+}
+
+void testEstimateIsTheLargestRecentLowerBound() {
+  auto time = std::make_shared<VirtualTime>(kStartMs);
+  ClockSkewEstimator skew(time);
+
+  // Device ten minutes behind: the server stamped its time 300 ms before it arrived.
+  skew.observe(kStartMs + 600000 - 300);
+  assert(skew.skewMs() == 599700);
+  // A cached, hour-old token says less about the clock and must not drag the estimate down.
+  time->advance(1000);
+  skew.observe(kStartMs - 3600000);
+  assert(skew.skewMs() == 599700);
+  // A sample that travelled faster is a tighter bound.
+  skew.observe(time->nowMs() + 600000 - 50);
+  assert(skew.skewMs() == 599950);
+  assert(skew.estimate().samples == 3);
+}
+
+void testDeviceAheadGivesNegativeSkew() {
+  auto time = std::make_shared<VirtualTime>(kStartMs);
+  ClockSkewEstimator skew(time);
+  skew.observe(kStartMs - 900000);
+  assert(skew.skewMs() == -900000);
+}
+
+void testOldSamplesAgeOut() {
+  auto time = std::make_shared<VirtualTime>(kStartMs);
+  ClockSkewEstimator skew(time);
+  skew.observe(kStartMs + 600000);
+  // The device clock was corrected; later samples agree with it.
+  time->advanceTo(kStartMs + 600000);
+  for (size_t i = 0; i < ClockSkewEstimator::kMaxSamples - 1; i++) skew.observe(time->nowMs());
+  assert(skew.skewMs() == 600000);
+  skew.observe(time->nowMs());
+  assert(skew.skewMs() == 0);
+  assert(skew.estimate().samples == ClockSkewEstimator::kMaxSamples);
+}
+
+void testImplausibleSamplesAreRejected() {
+  auto time = std::make_shared<VirtualTime>(kStartMs);
+  ClockSkewEstimator skew(time);
+  skew.observe(kStartMs + ClockSkewEstimator::kMaxSkewMs + 1);
+  skew.observe(kStartMs - ClockSkewEstimator::kMaxSkewMs - 1);
+  assert(skew.skewMs() == 0);
+  assert(skew.estimate().samples == 0);
+  assert(skew.estimate().rejectedSamples == 2);
+}
+
+void testNewClockDropsSamples() {
+  ClockSkewEstimator skew(std::make_shared<VirtualTime>(kStartMs));
+  skew.observe(kStartMs + 60000);
+  assert(skew.skewMs() == 60000);
+  skew.setClock(std::make_shared<VirtualTime>(kStartMs + 60000));
+  assert(skew.skewMs() == 0);
+  assert(skew.estimate().samples == 0);
+}
+
+void testHttpDateHeadersAreSampled() {
+  auto time = std::make_shared<VirtualTime>(kStartMs);
+  auto skew = std::make_shared<ClockSkewEstimator>(time);
+  auto inner = std::make_shared<DatedHttpClient>();
+  assert(!ClockSkewSamplingHttpClient::wrap(nullptr, skew));
+  auto http = ClockSkewSamplingHttpClient::wrap(inner, skew);
+
+  int completions = 0;
+  http->send(HttpRequest{}, [&completions](HttpResponse) { completions++; });
+  inner->date = "not a date";
+  http->send(HttpRequest{}, [&completions](HttpResponse) { completions++; });
+  assert(skew->estimate().samples == 0);
+
+  // kStartMs is 22:13:20 UTC; the server reads ten minutes later.
+  inner->date = "Tue, 14 Nov 2023 22:23:20 GMT";
+  http->send(HttpRequest{}, [&completions](HttpResponse response) {
+    assert(response.headers.count("date") == 1);
+    completions++;
+  });
+  assert(completions == 3);
+  assert(skew->skewMs() == 600000);
+}
+
+} // namespace
+
+int main() {
+  testNoSamplesMeansNoCorrection();
+  testEstimateIsTheLargestRecentLowerBound();
+  testDeviceAheadGivesNegativeSkew();
+  testOldSamplesAgeOut();
+  testImplausibleSamplesAreRejected();
+  testNewClockDropsSamples();
+  testHttpDateHeadersAreSampled();
+
+  std::cout << "ClockSkew tests passed!" << std::endl;
+  return 0;
+}
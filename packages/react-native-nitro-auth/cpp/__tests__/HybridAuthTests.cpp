@@ -1,12 +1,20 @@
+#include <algorithm>
 #include <cassert>
 #include <chrono>
+#include <functional>
 #include <iostream>
+#include <map>
+#include <mutex>
 #include <optional>
 #include <stdexcept>
 #include <string>
+#include <thread>
+#include <unistd.h>
 #include <vector>
 #include "../HybridAuth.hpp"
+#include "../JwsCrypto.hpp"
 #include "../PlatformAuth.hpp"
+#include "VirtualTime.hpp"
 
 using namespace margelo::nitro::NitroAuth;
 
@@ -16,12 +24,101 @@ void HybridAuthSpec::loadHybridMethods() {}
 
 namespace {
 
-std::shared_ptr<Promise<AuthUser>> lastLoginPromise;
-std::shared_ptr<Promise<AuthUser>> lastRequestScopesPromise;
-std::shared_ptr<Promise<AuthTokens>> lastRefreshPromise;
-std::shared_ptr<Promise<std::optional<AuthUser>>> lastSilentRestorePromise;
+std::shared_ptr<Promise<Result<AuthUser>>> lastLoginPromise;
+std::shared_ptr<Promise<Result<AuthUser>>> lastRequestScopesPromise;
+std::shared_ptr<Promise<Result<AuthTokens>>> lastRefreshPromise;
+std::shared_ptr<Promise<Result<std::optional<AuthUser>>>> lastSilentRestorePromise;
+std::shared_ptr<Promise<Result<std::string>>> lastBrowserPromise;
+std::string lastBrowserUrl;
 bool didLogout = false;
 bool didRevokeAccess = false;
+int refreshCalls = 0;
+std::optional<AuthProvider> lastRefreshProvider;
+std::vector<std::string> lastRefreshScopes;
+std::vector<std::string> configuredAuthorities;
+
+// Records request URLs and never completes them.
+class RecordingHttpClient : public HttpClient {
+public:
+  void send(const HttpRequest& request, Completion) override {
+    std::lock_guard<std::mutex> lock(mutex);
+    urls.push_back(request.url);
+  }
+
+  std::vector<std::string> recorded() {
+    std::lock_guard<std::mutex> lock(mutex);
+    return urls;
+  }
+
+private:
+  std::mutex mutex;
+  std::vector<std::string> urls;
+};
+
+std::shared_ptr<HttpClient> platformHttpClient;
+
+// Serves fixed bodies synchronously and counts requests per URL.
+class RoutedHttpClient : public HttpClient {
+public:
+  void send(const HttpRequest& request, Completion completion) override {
+    hits[request.url]++;
+    HttpResponse response;
+    auto route = routes.find(request.url);
+    if (route != routes.end()) {
+      response.status = 200;
+      response.body = route->second;
+      response.headers["cache-control"] = "max-age=3600";
+    } else {
+      response.status = 404;
+    }
+    completion(std::move(response));
+  }
+
+  std::map<std::string, std::string> routes;
+  std::map<std::string, int> hits;
+};
+
+// Microsoft-style tokens for tenant 9188040d-6c67-4c5b-b112-36a304b66dad, aud
+// client-123, nonce n-0S6_WzA2Mj, exp 2000000000. The first is signed by the
+// P-256 key ms-1; the rotated one by the RSA key ms-2, which only the rotated
+// key set publishes.
+const std::string kMicrosoftAuthority = "https://login.microsoftonline.com/9188040d-6c67-4c5b-b112-36a304b66dad/v2.0";
+const std::string kMicrosoftDiscovery =
+    "{\"issuer\":\"https://login.microsoftonline.com/9188040d-6c67-4c5b-b112-36a304b66dad/v2.0\","
+    "\"authorization_endpoint\":\"https://login.microsoftonline.com/9188040d-6c67-4c5b-b112-36a304b66dad/oauth2/v2.0/authorize\","
+    "\"token_endpoint\":\"https://login.microsoftonline.com/9188040d-6c67-4c5b-b112-36a304b66dad/oauth2/v2.0/token\","
+    "\"jwks_uri\":\"https://login.microsoftonline.com/9188040d-6c67-4c5b-b112-36a304b66dad/discovery/v2.0/keys\"}";
+const std::string kMicrosoftJwksUri =
+    "https://login.microsoftonline.com/9188040d-6c67-4c5b-b112-36a304b66dad/discovery/v2.0/keys";
+const std::string kMicrosoftJwks =
+    "{\"keys\":[{\"kty\":\"EC\",\"kid\":\"ms-1\",\"use\":\"sig\",\"crv\":\"P-256\",\"x\":\"4qDpzOd-YML5zU8vp9rfyJoswC0khbp6qQp"
+    "CwRXEBeE\",\"y\":\"SyU9qXKZjXKdTf2zp7gR-PoYT1TnHiR6VZQqXHSs8Z4\"}]}";
+
+const std::string kRotatedMicrosoftJwks =
+    "{\"keys\":[{\"kty\":\"EC\",\"kid\":\"ms-1\",\"use\":\"sig\",\"crv\":\"P-256\",\"x\":\"4qDpzOd-YML5zU8vp9rfyJoswC0khbp6qQp"
+    "CwRXEBeE\",\"y\":\"SyU9qXKZjXKdTf2zp7gR-PoYT1TnHiR6VZQqXHSs8Z4\"},{\"kty\":\"RSA\",\"kid\":\"ms-2\",\"use\":\"sig\",\""
+    "alg\":\"RS256\",\"n\":\"yJVOk81OMaa9G48lyyTXOidOCCxhm1u54eVwnMHnWAXVzUjSy3j4afiW-6DiOgzxO1TAu5hXuiIl9_V-KI"
+    "c-BNqlU1fwjSn8zbWZ5NwztvqmZrQaSFqyIwOe7yaJ4FK3vHFZnIbOVtrD1uzxGuC8RfT0s1R4pmag24Q2A-inn3labTmygeEhUl"
+    "Km87F6fPLrU3ky5P_79Se_s6yy4CIpgCA6Gx7DAYtn1jzKc2h6y4ZviwRdPFp3R1K6ZBs27s1wvtDmJF8DUUHLz7_IGVKXQRzedk"
+    "7E6sJoKCY2tw9UWaB5bj9Mev8J5Z2RIck07QBThibGOnCz85S324aEgUSlUw\",\"e\":\"AQAB\"}]}";
+
+const std::string kMicrosoftIdToken =
+    "eyJhbGciOiJFUzI1NiIsImtpZCI6Im1zLTEiLCJ0eXAiOiJKV1QifQ.eyJpc3MiOiJodHRwczovL2xvZ2luLm1pY3Jvc29mdG9ub"
+    "GluZS5jb20vOTE4ODA0MGQtNmM2Ny00YzViLWIxMTItMzZhMzA0YjY2ZGFkL3YyLjAiLCJ0aWQiOiI5MTg4MDQwZC02YzY3LTRjN"
+    "WItYjExMi0zNmEzMDRiNjZkYWQiLCJzdWIiOiJBQUFBQUFBQUFBQUFBQUFBQUFBQUFJa3pxRlZyU2FTYUZIeTc4MmJidGFRIiwiY"
+    "XVkIjoiY2xpZW50LTEyMyIsImV4cCI6MjAwMDAwMDAwMCwiaWF0IjoxNzAwMDAwMDAwLCJub25jZSI6Im4tMFM2X1d6QTJNaiIsI"
+    "mVtYWlsIjoiYm9iQGV4YW1wbGUuY29tIn0.-vRMFRcaJ6UCuXN_BLlnDtcjRc2z6LPGZ0_6iM5sK-QgGTXtNHekfDwjI3kB9D5Vh"
+    "n80WZdb7KtV0vE8PF8QZA";
+
+const std::string kRotatedMicrosoftIdToken =
+    "eyJhbGciOiJSUzI1NiIsImtpZCI6Im1zLTIiLCJ0eXAiOiJKV1QifQ.eyJpc3MiOiJodHRwczovL2xvZ2luLm1pY3Jvc29mdG9ub"
+    "GluZS5jb20vOTE4ODA0MGQtNmM2Ny00YzViLWIxMTItMzZhMzA0YjY2ZGFkL3YyLjAiLCJ0aWQiOiI5MTg4MDQwZC02YzY3LTRjN"
+    "WItYjExMi0zNmEzMDRiNjZkYWQiLCJzdWIiOiJBQUFBQUFBQUFBQUFBQUFBQUFBQUFJa3pxRlZyU2FTYUZIeTc4MmJidGFRIiwiY"
+    "XVkIjoiY2xpZW50LTEyMyIsImV4cCI6MjAwMDAwMDAwMCwiaWF0IjoxNzAwMDAwMDAwLCJub25jZSI6Im4tMFM2X1d6QTJNaiIsI"
+    "mVtYWlsIjoiYm9iQGV4YW1wbGUuY29tIn0.BQ85W4d3sEz7lpBouVvV36LaDmcuui23qTTjE_sdE6TVwOi68k0U55YPt7STlrz5p"
+    "a3EjI-3WTgTY8WMR6gXrow2fLRIhs66i_4sT4pbuCdkpVUZRLFxU-YE7Fpm3PGp0QXkc3cDcLBnKcCkv8dZhboEwqd2Q-ElK_OKw"
+    "LanjFq2jDlrwN-C3lV1HxFZIaOADIIvP7XQLerbiAdSnkKrnTn_xxde0njsYuarmCxM8ncsfJGQh_sVyABLTEUcalKZ07UoIqD7C"
+    "CNqWXnc-C0oSKJysbSwmZDIppbD8tjx-OGhRrg4d-VkHSRaNokhxw-IWqzZsWJz2h2lHqZpfNQ7Wg";
 
 AuthUser makeUser(
   const std::optional<std::vector<std::string>>& scopes = std::nullopt,
@@ -61,34 +158,68 @@ double expiredTimestampMs() {
   return static_cast<double>(now - 1000);
 }
 
+std::string errorMessage(const std::exception_ptr& error) {
+  try {
+    std::rethrow_exception(error);
+  } catch (const std::exception& e) {
+    return e.what();
+  }
+}
+
+// Platform promises never reject; a failed call resolves with its AuthError.
+template <typename T>
+bool failed(const std::shared_ptr<Promise<Result<T>>>& promise) {
+  return promise->isResolved() && !promise->getResult().ok();
+}
+
 void resetPlatformMocks() {
   lastLoginPromise = nullptr;
   lastRequestScopesPromise = nullptr;
   lastRefreshPromise = nullptr;
   lastSilentRestorePromise = nullptr;
+  lastBrowserPromise = nullptr;
+  lastBrowserUrl.clear();
   didLogout = false;
   didRevokeAccess = false;
+  refreshCalls = 0;
+  lastRefreshProvider = std::nullopt;
+  lastRefreshScopes.clear();
 }
 
 } // namespace
 
-std::shared_ptr<Promise<AuthUser>> PlatformAuth::login(AuthProvider, const std::optional<LoginOptions>&) {
-  lastLoginPromise = Promise<AuthUser>::create();
+// Like the native bridges, one interactive call per slot: another while it is pending fails.
+std::shared_ptr<Promise<Result<AuthUser>>> PlatformAuth::login(AuthProvider, const std::optional<LoginOptions>&) {
+  if (lastLoginPromise && lastLoginPromise->isPending()) {
+    auto busy = Promise<Result<AuthUser>>::create();
+    busy->resolve(AuthErrorCode::OPERATION_IN_PROGRESS);
+    return busy;
+  }
+  lastLoginPromise = Promise<Result<AuthUser>>::create();
   return lastLoginPromise;
 }
 
-std::shared_ptr<Promise<AuthUser>> PlatformAuth::requestScopes(const std::vector<std::string>&) {
-  lastRequestScopesPromise = Promise<AuthUser>::create();
+std::shared_ptr<Promise<Result<AuthUser>>> PlatformAuth::requestScopes(const std::vector<std::string>&) {
+  if (lastRequestScopesPromise && lastRequestScopesPromise->isPending()) {
+    auto busy = Promise<Result<AuthUser>>::create();
+    busy->resolve(AuthErrorCode::OPERATION_IN_PROGRESS);
+    return busy;
+  }
+  lastRequestScopesPromise = Promise<Result<AuthUser>>::create();
   return lastRequestScopesPromise;
 }
 
-std::shared_ptr<Promise<AuthTokens>> PlatformAuth::refreshToken() {
-  lastRefreshPromise = Promise<AuthTokens>::create();
+std::shared_ptr<Promise<Result<AuthTokens>>> PlatformAuth::refreshToken(const std::optional<AuthProvider>& provider,
+                                                                        const std::vector<std::string>& scopes) {
+  refreshCalls++;
+  lastRefreshProvider = provider;
+  lastRefreshScopes = scopes;
+  lastRefreshPromise = Promise<Result<AuthTokens>>::create();
   return lastRefreshPromise;
 }
 
-std::shared_ptr<Promise<std::optional<AuthUser>>> PlatformAuth::silentRestore() {
-  lastSilentRestorePromise = Promise<std::optional<AuthUser>>::create();
+std::shared_ptr<Promise<Result<std::optional<AuthUser>>>> PlatformAuth::silentRestore() {
+  lastSilentRestorePromise = Promise<Result<std::optional<AuthUser>>>::create();
   return lastSilentRestorePromise;
 }
 
@@ -96,17 +227,56 @@ bool PlatformAuth::hasPlayServices() {
   return true;
 }
 
+std::shared_ptr<Promise<Result<std::string>>> PlatformAuth::authorizeInBrowser(const std::string& url,
+                                                                                const std::string&) {
+  lastBrowserUrl = url;
+  lastBrowserPromise = Promise<Result<std::string>>::create();
+  return lastBrowserPromise;
+}
+
+std::shared_ptr<HttpClient> PlatformAuth::httpClient() {
+  return platformHttpClient;
+}
+
+std::string PlatformAuth::cacheDirectory() {
+  return "";
+}
+
+std::vector<std::string> PlatformAuth::discoveryAuthorities() {
+  return configuredAuthorities;
+}
+
 void PlatformAuth::logout() {
   didLogout = true;
 }
 
-std::shared_ptr<Promise<void>> PlatformAuth::revokeAccess() {
+std::shared_ptr<Promise<Result<void>>> PlatformAuth::revokeAccess() {
   didRevokeAccess = true;
-  auto promise = Promise<void>::create();
-  promise->resolve();
+  auto promise = Promise<Result<void>>::create();
+  promise->resolve(Result<void>());
   return promise;
 }
 
+void PlatformAuth::cancel(PlatformOperation operation, const std::string& reason) {
+  const AuthError error(reason);
+  switch (operation) {
+    case PlatformOperation::LOGIN:
+      if (lastLoginPromise && lastLoginPromise->isPending()) lastLoginPromise->resolve(error);
+      if (lastBrowserPromise && lastBrowserPromise->isPending()) lastBrowserPromise->resolve(error);
+      break;
+    case PlatformOperation::REQUEST_SCOPES:
+      if (lastRequestScopesPromise && lastRequestScopesPromise->isPending()) lastRequestScopesPromise->resolve(error);
+      if (lastBrowserPromise && lastBrowserPromise->isPending()) lastBrowserPromise->resolve(error);
+      break;
+    case PlatformOperation::REFRESH_TOKEN:
+      if (lastRefreshPromise && lastRefreshPromise->isPending()) lastRefreshPromise->resolve(error);
+      break;
+    case PlatformOperation::SILENT_RESTORE:
+      if (lastSilentRestorePromise && lastSilentRestorePromise->isPending()) lastSilentRestorePromise->resolve(error);
+      break;
+  }
+}
+
 } // namespace margelo::nitro::NitroAuth
 
 namespace {
@@ -167,11 +337,13 @@ void testRefreshCancelledWhenSessionChanges() {
   auto duplicateRefreshPromise = auth->refreshToken();
   assert(refreshPromise == duplicateRefreshPromise);
 
+  // The account's refresh survives until the replacement sign-in actually lands.
   auto replacementLoginPromise = auth->login(AuthProvider::GOOGLE, std::nullopt);
-  assert(refreshPromise->isRejected());
+  assert(refreshPromise->isPending());
 
   lastLoginPromise->resolve(makeUser(std::vector<std::string>{"profile"}, "new"));
   assert(replacementLoginPromise->isResolved());
+  assert(refreshPromise->isRejected());
 
   lastRefreshPromise->resolve(makeTokens("stale"));
 
@@ -186,7 +358,7 @@ void testLoginStartInvalidatesSilentRestore() {
   auto loginPromise = auth->login(AuthProvider::GOOGLE, std::nullopt);
 
   assert(restorePromise->isRejected());
-  lastSilentRestorePromise->resolve(makeUser(std::vector<std::string>{"profile"}, "restored"));
+  lastSilentRestorePromise->resolve(std::make_optional(makeUser(std::vector<std::string>{"profile"}, "restored")));
   assert(!auth->getCurrentUser().has_value());
 
   lastLoginPromise->resolve(makeUser(std::vector<std::string>{"profile"}, "interactive"));
@@ -208,6 +380,36 @@ void testPendingLoginCancelledWhenSessionChanges() {
   assert(auth->getCurrentUser()->accessToken == "second");
 }
 
+void testSupersededInteractiveCallsReleaseThePlatform() {
+  resetPlatformMocks();
+  auto auth = std::make_shared<HybridAuth>();
+
+  // The platform never answers the first sign-in; the second one cancels it
+  // rather than failing on its slot.
+  auto stuckLogin = auth->login(AuthProvider::GOOGLE, std::nullopt);
+  auto stuckPlatformLogin = lastLoginPromise;
+  auto nextLogin = auth->login(AuthProvider::GOOGLE, std::nullopt);
+  assert(stuckLogin->isRejected() && errorMessage(stuckLogin->getError()) == "cancelled");
+  assert(failed(stuckPlatformLogin) && lastLoginPromise != stuckPlatformLogin);
+  lastLoginPromise->resolve(makeUser(std::vector<std::string>{"profile"}, "second"));
+  assert(nextLogin->isResolved() && auth->getCurrentUser()->accessToken == "second");
+
+  auto stuckScopes = auth->requestScopes({"email"});
+  auto stuckPlatformScopes = lastRequestScopesPromise;
+  auto nextScopes = auth->requestScopes({"drive"});
+  assert(stuckScopes->isRejected() && failed(stuckPlatformScopes));
+  assert(lastRequestScopesPromise != stuckPlatformScopes && lastRequestScopesPromise->isPending());
+
+  // Logout frees both slots too.
+  auth->login(AuthProvider::GOOGLE, std::nullopt);
+  auth->logout();
+  assert(failed(lastLoginPromise) && failed(lastRequestScopesPromise));
+  auto afterLogout = auth->login(AuthProvider::GOOGLE, std::nullopt);
+  assert(lastLoginPromise->isPending());
+  lastLoginPromise->resolve(makeUser(std::vector<std::string>{"profile"}, "third"));
+  assert(afterLogout->isResolved() && auth->getCurrentUser()->accessToken == "third");
+}
+
 void testRevokeAccessCancelsPendingOperationsAndClearsSession() {
   resetPlatformMocks();
   auto auth = std::make_shared<HybridAuth>();
@@ -278,19 +480,19 @@ void testSilentRestoreResolvedEmptyAndRejectedPaths() {
   auto auth = std::make_shared<HybridAuth>();
 
   auto restoreWithUser = auth->silentRestore();
-  lastSilentRestorePromise->resolve(makeUser(std::vector<std::string>{"profile"}, "restored"));
+  lastSilentRestorePromise->resolve(std::make_optional(makeUser(std::vector<std::string>{"profile"}, "restored")));
   assert(restoreWithUser->isResolved());
   assert(auth->getCurrentUser()->accessToken == "restored");
   assert(auth->getGrantedScopes() == std::vector<std::string>{"profile"});
 
   auto restoreWithoutUser = auth->silentRestore();
-  lastSilentRestorePromise->resolve(std::nullopt);
+  lastSilentRestorePromise->resolve(std::optional<AuthUser>());
   assert(restoreWithoutUser->isResolved());
   assert(!auth->getCurrentUser().has_value());
   assert(auth->getGrantedScopes().empty());
 
   auto rejectedRestore = auth->silentRestore();
-  lastSilentRestorePromise->reject(std::make_exception_ptr(std::runtime_error("native failure")));
+  lastSilentRestorePromise->resolve(AuthError("native failure"));
   assert(rejectedRestore->isResolved());
 }
 
@@ -313,7 +515,7 @@ void testLoginScopeFallbackAndRejectionPaths() {
   assert(!auth->getCurrentUser()->scopes.has_value());
 
   auto rejectedLogin = auth->login(AuthProvider::GOOGLE, std::nullopt);
-  lastLoginPromise->reject(std::make_exception_ptr(std::runtime_error("cancelled")));
+  lastLoginPromise->resolve(AuthError("cancelled"));
   assert(rejectedLogin->isRejected());
 }
 
@@ -322,7 +524,7 @@ void testScopeRejectionAndNoUserRevokePaths() {
   auto auth = std::make_shared<HybridAuth>();
 
   auto requestPromise = auth->requestScopes({"email"});
-  lastRequestScopesPromise->reject(std::make_exception_ptr(std::runtime_error("scope failure")));
+  lastRequestScopesPromise->resolve(AuthError("scope failure"));
   assert(requestPromise->isRejected());
 
   auto revokePromise = auth->revokeScopes({"email"});
@@ -373,7 +575,7 @@ void testAccessTokenReadRefreshAndFallbackPaths() {
   assert(failingLogin->isResolved());
 
   auto failedToken = auth->getAccessToken();
-  lastRefreshPromise->reject(std::make_exception_ptr(std::runtime_error("refresh failure")));
+  lastRefreshPromise->resolve(AuthError("refresh failure"));
   assert(failedToken->isRejected());
 }
 
@@ -402,20 +604,1106 @@ void testRefreshTokenSuccessFailureAndTokenListenerPaths() {
   assert(auth->getCurrentUser()->expirationTime.has_value());
 
   auto failedRefresh = auth->refreshToken();
-  lastRefreshPromise->reject(std::make_exception_ptr(std::runtime_error("network")));
+  lastRefreshPromise->resolve(AuthError("network"));
   assert(failedRefresh->isRejected());
 
   auth->setLoggingEnabled(true);
 }
 
+void testRefreshFailuresBackOffAndServeStillValidToken() {
+  resetPlatformMocks();
+  auto auth = std::make_shared<HybridAuth>();
+  auto time = std::make_shared<VirtualTime>(1'000'000);
+  auth->setClock(time);
+  auth->setTimerService(time);
+
+  auto loginPromise = auth->login(AuthProvider::GOOGLE, std::nullopt);
+  lastLoginPromise->resolve(makeUser(std::vector<std::string>{"profile"}, "cached", time->nowMs() + 3000.0));
+  assert(loginPromise->isResolved());
+
+  auto failedToken = auth->getAccessToken();
+  assert(refreshCalls == 1);
+  lastRefreshPromise->resolve(AuthError("network_error"));
+  assert(failedToken->isRejected());
+
+  auto blockedRefresh = auth->refreshToken();
+  assert(blockedRefresh->isRejected());
+  assert(refreshCalls == 1);
+
+  auto cachedToken = auth->getAccessToken();
+  assert(cachedToken->isResolved());
+  assert(cachedToken->getResult() == "cached");
+  assert(refreshCalls == 1);
+
+  time->advance(2000);
+  auto retriedToken = auth->getAccessToken();
+  assert(refreshCalls == 2);
+  lastRefreshPromise->resolve(AuthError("network_error"));
+  assert(retriedToken->isRejected());
+
+  time->advance(1500);
+  auto expiredDuringBackoff = auth->getAccessToken();
+  assert(expiredDuringBackoff->isRejected());
+  assert(refreshCalls == 2);
+
+  auto expiredLogin = auth->login(AuthProvider::GOOGLE, std::nullopt);
+  lastLoginPromise->resolve(makeUser(std::vector<std::string>{"profile"}, "expired", time->nowMs() - 1000.0));
+  assert(expiredLogin->isResolved());
+
+  auto refreshAfterLogin = auth->refreshToken();
+  assert(refreshCalls == 3);
+  lastRefreshPromise->resolve(AuthError("token_error"));
+  assert(refreshAfterLogin->isRejected());
+
+  auto expiredToken = auth->getAccessToken();
+  assert(expiredToken->isRejected());
+  assert(refreshCalls == 3);
+
+  auth->logout();
+  auto relogin = auth->login(AuthProvider::GOOGLE, std::nullopt);
+  lastLoginPromise->resolve(makeUser(std::vector<std::string>{"profile"}, "again", time->nowMs() - 1000.0));
+  assert(relogin->isResolved());
+  auto refreshAfterRelogin = auth->refreshToken();
+  assert(refreshCalls == 4);
+  assert(refreshAfterRelogin->isPending());
+}
+
+void testDeadlinesReleaseStuckPlatformOperations() {
+  resetPlatformMocks();
+  auto auth = std::make_shared<HybridAuth>();
+  auto timers = std::make_shared<VirtualTime>();
+  auth->setTimerService(timers);
+  OperationDeadlines deadlines;
+  deadlines.loginMs = 1000;
+  deadlines.refreshTokenMs = 500;
+  auth->setOperationDeadlines(deadlines);
+
+  auto stuckLogin = auth->login(AuthProvider::GOOGLE, std::nullopt);
+  timers->advance(999);
+  assert(stuckLogin->isPending());
+  timers->advance(1);
+  assert(stuckLogin->isRejected());
+  assert(errorMessage(stuckLogin->getError()) == "timeout");
+  assert(failed(lastLoginPromise));
+
+  auto nextLogin = auth->login(AuthProvider::GOOGLE, std::nullopt);
+  lastLoginPromise->resolve(makeUser(std::vector<std::string>{"profile"}, "token"));
+  assert(nextLogin->isResolved());
+  assert(timers->pending() == 0);
+
+  auto stuckRefresh = auth->refreshToken();
+  timers->advance(500);
+  assert(stuckRefresh->isRejected());
+  assert(errorMessage(stuckRefresh->getError()) == "timeout");
+  assert(auth->refreshToken()->isRejected());
+  assert(refreshCalls == 1);
+}
+
+void testCancellationTokensAbortOperations() {
+  resetPlatformMocks();
+  auto auth = std::make_shared<HybridAuth>();
+  auth->setTimerService(std::make_shared<VirtualTime>());
+
+  auto loginPromise = auth->login(AuthProvider::GOOGLE, std::nullopt);
+  lastLoginPromise->resolve(makeUser(std::vector<std::string>{"profile"}, "token"));
+  assert(loginPromise->isResolved());
+
+  auto scopesToken = CancellationToken::create();
+  auto scopesPromise = auth->requestScopes({"email"}, scopesToken);
+  scopesToken->cancel();
+  assert(scopesPromise->isRejected());
+  assert(errorMessage(scopesPromise->getError()) == "cancelled");
+  assert(failed(lastRequestScopesPromise));
+  assert(auth->getGrantedScopes() == std::vector<std::string>{"profile"});
+
+  auto refreshToken = CancellationToken::create();
+  auto refreshPromise = auth->refreshToken(refreshToken);
+  refreshToken->cancel();
+  assert(refreshPromise->isRejected());
+  auto retriedRefresh = auth->refreshToken();
+  assert(refreshCalls == 2);
+  lastRefreshPromise->resolve(makeTokens("refreshed"));
+  assert(retriedRefresh->isResolved());
+
+  auto restoreToken = CancellationToken::create();
+  auto restorePromise = auth->silentRestore(restoreToken);
+  restoreToken->cancel();
+  assert(restorePromise->isResolved());
+  assert(auth->getCurrentUser()->accessToken == "refreshed");
+
+  auto loginCalls = lastLoginPromise;
+  auto preCancelled = CancellationToken::create();
+  preCancelled->cancel("cancelled");
+  auto skippedLogin = auth->login(AuthProvider::GOOGLE, std::nullopt, preCancelled);
+  assert(skippedLogin->isRejected());
+  assert(lastLoginPromise == loginCalls);
+  assert(auth->getCurrentUser()->accessToken == "refreshed");
+}
+
+
+class RecordingSessionStore final : public SessionStore {
+public:
+  void saveUser(const std::optional<AuthUser>& user) override {
+    users.push_back(user);
+    stored = user;
+  }
+  void saveTokens(const AuthTokens& tokens) override {
+    tokenSaves.push_back(tokens);
+    if (stored) mergeTokens(*stored, tokens);
+  }
+  std::optional<AuthUser> load() override { return stored; }
+  void flush() override {}
+
+  std::vector<std::optional<AuthUser>> users;
+  std::vector<AuthTokens> tokenSaves;
+  std::optional<AuthUser> stored;
+};
+
+void testSessionStoreReceivesSessionChangesInOrder() {
+  resetPlatformMocks();
+  auto store = std::make_shared<RecordingSessionStore>();
+  store->stored = makeUser(std::vector<std::string>{"profile"}, "persisted", futureTimestampMs());
+
+  auto auth = std::make_shared<HybridAuth>();
+  int authStateCalls = 0;
+  auth->onAuthStateChanged([&authStateCalls](const std::optional<AuthUser>&) { authStateCalls++; });
+  auth->setSessionStore(store);
+  assert(authStateCalls == 1);
+  assert(auth->getCurrentUser()->accessToken == "persisted");
+  assert(auth->getGrantedScopes() == std::vector<std::string>{"profile"});
+  assert(store->users.empty());
+
+  auto refreshPromise = auth->refreshToken();
+  lastRefreshPromise->resolve(makeTokens("rotated", std::nullopt, "refresh-2", futureTimestampMs()));
+  assert(refreshPromise->isResolved());
+  assert(store->users.empty());
+  assert(store->tokenSaves.size() == 1);
+  assert(store->stored->accessToken == "rotated");
+  assert(store->stored->refreshToken == "refresh-2");
+
+  auth->revokeScopes({"profile"});
+  assert(store->users.size() == 1);
+  assert(store->users.back()->scopes == std::vector<std::string>{});
+
+  auth->logout();
+  assert(store->users.size() == 2);
+  assert(!store->users.back().has_value());
+
+  auto loginPromise = auth->login(AuthProvider::GOOGLE, std::nullopt);
+  lastLoginPromise->resolve(makeUser(std::nullopt, "fresh"));
+  assert(loginPromise->isResolved());
+  assert(store->users.size() == 3);
+  assert(store->users.back()->accessToken == "fresh");
+
+  // Installing a store while signed in persists the live session instead.
+  auto replacement = std::make_shared<RecordingSessionStore>();
+  auth->setSessionStore(replacement);
+  assert(replacement->users.size() == 1);
+  assert(replacement->users.back()->accessToken == "fresh");
+}
+
+AuthUser makeAccount(AuthProvider provider, const std::string& userId, const std::string& accessToken) {
+  auto user = makeUser(std::vector<std::string>{"profile"}, accessToken, futureTimestampMs());
+  user.provider = provider;
+  user.userId = userId;
+  user.email = userId + "@example.com";
+  return user;
+}
+
+void testAccountsSwitchAndRefreshIndependently() {
+  resetPlatformMocks();
+  auto auth = std::make_shared<HybridAuth>();
+  std::vector<std::optional<std::string>> observedTokens;
+  auth->onAuthStateChanged([&observedTokens](const std::optional<AuthUser>& user) {
+    observedTokens.push_back(user ? user->accessToken : std::nullopt);
+  });
+
+  auth->login(AuthProvider::GOOGLE, std::nullopt);
+  lastLoginPromise->resolve(makeAccount(AuthProvider::GOOGLE, "alice", "alice-1"));
+  auth->login(AuthProvider::MICROSOFT, std::nullopt);
+  lastLoginPromise->resolve(makeAccount(AuthProvider::MICROSOFT, "bob", "bob-1"));
+
+  auto accounts = auth->getAccounts();
+  assert(accounts.size() == 2);
+  assert(accounts[0].id == "google:alice" && !accounts[0].isActive);
+  assert(accounts[1].id == "microsoft:bob" && accounts[1].isActive);
+  assert(auth->getCurrentUser()->accessToken == "bob-1");
+
+  auth->switchAccount("google:alice");
+  assert(auth->getCurrentUser()->accessToken == "alice-1");
+  assert(observedTokens.back() == "alice-1");
+  const auto notifications = observedTokens.size();
+  auth->switchAccount("google:alice");
+  assert(observedTokens.size() == notifications);
+
+  bool threw = false;
+  try {
+    auth->switchAccount("apple:nobody");
+  } catch (const std::runtime_error& error) {
+    threw = std::string(error.what()) == "not_signed_in";
+  }
+  assert(threw);
+  assert(auth->getAccessTokenForAccount("apple:nobody", std::nullopt)->isRejected());
+
+  // Each account has its own single-flight; the platform runs one refresh at a
+  // time, so the second account's refresh queues behind the first.
+  auto aliceRefresh = auth->refreshToken();
+  assert(auth->refreshToken() == aliceRefresh);
+  assert(lastRefreshProvider == AuthProvider::GOOGLE);
+  auth->switchAccount("microsoft:bob");
+  auto bobRefresh = auth->refreshToken();
+  assert(bobRefresh != aliceRefresh);
+  assert(refreshCalls == 1);
+
+  // Held locally: resolving it launches the queued refresh, which replaces lastRefreshPromise.
+  auto alicePlatformRefresh = lastRefreshPromise;
+  alicePlatformRefresh->resolve(makeTokens("alice-2"));
+  assert(aliceRefresh->isResolved());
+  assert(refreshCalls == 2);
+  assert(lastRefreshProvider == AuthProvider::MICROSOFT);
+  // Refreshing an inactive account does not touch the current user.
+  assert(auth->getCurrentUser()->accessToken == "bob-1");
+
+  lastRefreshPromise->resolve(makeTokens("bob-2"));
+  assert(bobRefresh->isResolved());
+  assert(auth->getCurrentUser()->accessToken == "bob-2");
+
+  std::optional<std::string> aliceToken;
+  auth->getAccessTokenForAccount("google:alice", std::nullopt)->addOnResolvedListener(
+    [&aliceToken](const std::optional<std::string>& token) { aliceToken = token; });
+  assert(aliceToken == "alice-2");
+
+  // Signing in to a known account again replaces only that account's session.
+  auth->switchAccount("google:alice");
+  auto staleRefresh = auth->refreshToken();
+  auth->login(AuthProvider::GOOGLE, std::nullopt);
+  lastLoginPromise->resolve(makeAccount(AuthProvider::GOOGLE, "alice", "alice-3"));
+  assert(staleRefresh->isRejected());
+  assert(auth->getAccounts().size() == 2);
+  assert(auth->getAccounts()[0].id == "google:alice");
+  assert(auth->getCurrentUser()->accessToken == "alice-3");
+
+  auth->logout();
+  assert(auth->getAccounts().empty());
+  assert(!auth->getCurrentUser().has_value());
+}
+
+void testQueuedRefreshDroppedWhenAccountRemoved() {
+  resetPlatformMocks();
+  auto auth = std::make_shared<HybridAuth>();
+
+  auth->login(AuthProvider::GOOGLE, std::nullopt);
+  lastLoginPromise->resolve(makeAccount(AuthProvider::GOOGLE, "alice", "alice-1"));
+  auth->login(AuthProvider::MICROSOFT, std::nullopt);
+  lastLoginPromise->resolve(makeAccount(AuthProvider::MICROSOFT, "bob", "bob-1"));
+
+  auto bobRefresh = auth->refreshToken();
+  auth->switchAccount("google:alice");
+  auto aliceRefresh = auth->refreshToken();
+  assert(refreshCalls == 1);
+
+  auto firstPlatformRefresh = lastRefreshPromise;
+  auth->logout();
+  assert(bobRefresh->isRejected());
+  assert(aliceRefresh->isRejected());
+
+  // The queued refresh is never sent to the platform once its account is gone.
+  firstPlatformRefresh->resolve(makeTokens("stale"));
+  assert(refreshCalls == 1);
+  assert(!auth->getCurrentUser().has_value());
+
+  auth->login(AuthProvider::GOOGLE, std::nullopt);
+  lastLoginPromise->resolve(makeAccount(AuthProvider::GOOGLE, "alice", "alice-2"));
+  auto nextRefresh = auth->refreshToken();
+  assert(refreshCalls == 2);
+  lastRefreshPromise->resolve(makeTokens("alice-3"));
+  assert(nextRefresh->isResolved());
+}
+
+std::optional<std::string> resolvedToken(const std::shared_ptr<Promise<std::optional<std::string>>>& promise) {
+  std::optional<std::string> token;
+  promise->addOnResolvedListener([&token](const std::optional<std::string>& value) { token = value; });
+  return token;
+}
+
+void testResourceTokensAreCachedPerScopeSet() {
+  resetPlatformMocks();
+  auto auth = std::make_shared<HybridAuth>();
+  int tokenListenerCalls = 0;
+  auth->onTokensRefreshed([&tokenListenerCalls](const AuthTokens&) { tokenListenerCalls++; });
+
+  auth->login(AuthProvider::MICROSOFT, std::nullopt);
+  lastLoginPromise->resolve(makeAccount(AuthProvider::MICROSOFT, "bob", "session-token"));
+
+  AccessTokenRequest graph;
+  graph.resource = "https://graph.microsoft.com";
+  AccessTokenRequest api;
+  api.scopes = std::vector<std::string>{"api://backend/Read"};
+
+  // Concurrent callers for one key share a single platform refresh.
+  auto graphToken = auth->getAccessToken(graph);
+  auto graphTokenAgain = auth->getAccessToken(graph);
+  assert(refreshCalls == 1);
+  assert(lastRefreshProvider == AuthProvider::MICROSOFT);
+  assert(lastRefreshScopes == std::vector<std::string>{"https://graph.microsoft.com/.default"});
+  // Another resource queues behind it instead of overwriting it.
+  auto apiToken = auth->getAccessToken(api);
+  assert(refreshCalls == 1);
+
+  auto graphRefresh = lastRefreshPromise;
+  graphRefresh->resolve(makeTokens("graph-token", std::nullopt, std::nullopt, futureTimestampMs()));
+  assert(resolvedToken(graphToken) == "graph-token");
+  assert(resolvedToken(graphTokenAgain) == "graph-token");
+  assert(refreshCalls == 2);
+  assert(lastRefreshScopes == std::vector<std::string>{"api://backend/Read"});
+  lastRefreshPromise->resolve(makeTokens("api-token", std::nullopt, std::nullopt, futureTimestampMs()));
+  assert(resolvedToken(apiToken) == "api-token");
+
+  // Resource tokens never replace the session token or fire token listeners.
+  assert(auth->getCurrentUser()->accessToken == "session-token");
+  assert(tokenListenerCalls == 0);
+  assert(resolvedToken(auth->getAccessToken()) == "session-token");
+
+  // Both stay cached side by side.
+  assert(resolvedToken(auth->getAccessToken(graph)) == "graph-token");
+  assert(resolvedToken(auth->getAccessToken(api)) == "api-token");
+  assert(resolvedToken(auth->getAccessTokenForAccount("microsoft:bob", graph)) == "graph-token");
+  assert(refreshCalls == 2);
+  assert(auth->getAccessTokenCacheStats().entries == 2);
+
+  // A token inside the refresh window is fetched again.
+  AccessTokenRequest sharepoint;
+  sharepoint.resource = "https://contoso.sharepoint.com";
+  auth->getAccessToken(sharepoint);
+  lastRefreshPromise->resolve(makeTokens("sharepoint-old", std::nullopt, std::nullopt, expiredTimestampMs()));
+  auto sharepointToken = auth->getAccessToken(sharepoint);
+  assert(refreshCalls == 4);
+  lastRefreshPromise->resolve(makeTokens("sharepoint-new", std::nullopt, std::nullopt, futureTimestampMs()));
+  assert(resolvedToken(sharepointToken) == "sharepoint-new");
+
+  // Logging out drops every cached resource token and rejects those in flight.
+  AccessTokenRequest other;
+  other.resource = "https://other.example.com";
+  auto pending = auth->getAccessToken(other);
+  auto stalePlatformRefresh = lastRefreshPromise;
+  auth->logout();
+  assert(pending->isRejected());
+  assert(auth->getAccessTokenCacheStats().entries == 0);
+  stalePlatformRefresh->resolve(makeTokens("stale", std::nullopt, std::nullopt, futureTimestampMs()));
+  assert(auth->getAccessTokenCacheStats().entries == 0);
+}
+
+void testSharedSessionFollowsTheActiveAccount() {
+  resetPlatformMocks();
+  char directory[] = "/tmp/nitro-auth-shared-XXXXXX";
+  assert(::mkdtemp(directory) != nullptr);
+  const std::string path = std::string(directory) + "/segment";
+  auto auth = std::make_shared<HybridAuth>();
+  auth->setSharedSession(SharedSessionSegment::open(path));
+  // Another process maps the same file.
+  auto reader = SharedSessionSegment::open(path);
+  assert(!reader->read().session.has_value());
+
+  auth->login(AuthProvider::MICROSOFT, std::nullopt);
+  lastLoginPromise->resolve(makeAccount(AuthProvider::MICROSOFT, "bob", "bob-1"));
+  auto published = reader->read();
+  assert(published.session && published.session->accountId == "microsoft:bob");
+  assert(published.session->accessToken == "bob-1");
+  assert(published.session->expirationTime == auth->getCurrentUser()->expirationTime);
+
+  auto refreshed = auth->refreshToken();
+  lastRefreshPromise->resolve(makeTokens("bob-2", std::nullopt, std::nullopt, futureTimestampMs()));
+  assert(refreshed->isResolved());
+  auto rotated = reader->read();
+  assert(rotated.version > published.version);
+  assert(rotated.session->accessToken == "bob-2");
+
+  // Resource tokens stay private to this process.
+  AccessTokenRequest graph;
+  graph.resource = "https://graph.microsoft.com";
+  auth->getAccessToken(graph);
+  lastRefreshPromise->resolve(makeTokens("graph-token", std::nullopt, std::nullopt, futureTimestampMs()));
+  assert(reader->read().session->accessToken == "bob-2");
+
+  auth->login(AuthProvider::GOOGLE, std::nullopt);
+  lastLoginPromise->resolve(makeAccount(AuthProvider::GOOGLE, "alice", "alice-1"));
+  assert(reader->read().session->accountId == "google:alice");
+  auth->switchAccount("microsoft:bob");
+  assert(reader->read().session->accessToken == "bob-2");
+
+  auth->logout();
+  assert(!reader->read().session.has_value());
+  ::unlink(path.c_str());
+  ::rmdir(directory);
+}
+
+// Unsigned: only the claims matter to refresh timing and account matching.
+std::string unsignedIdToken(int64_t issuedAtSeconds, int64_t expiresAtSeconds, const std::string& subject = "alice") {
+  const std::string claims = "{\"iss\":\"https://accounts.google.com\",\"sub\":\"" + subject +
+                             "\",\"aud\":\"client\",\"iat\":" + std::to_string(issuedAtSeconds) +
+                             ",\"exp\":" + std::to_string(expiresAtSeconds) + "}";
+  return JwsCrypto::base64UrlEncode("{\"alg\":\"RS256\"}") + "." + JwsCrypto::base64UrlEncode(claims) + ".c2ln";
+}
+
+// The platform keeps one session per provider, so a refresh only runs for the
+// account it holds, and never lands tokens issued to another user.
+void testRefreshStaysWithItsAccount() {
+  resetPlatformMocks();
+  auto auth = std::make_shared<HybridAuth>();
+  auto alice = makeAccount(AuthProvider::GOOGLE, "alice", "alice-1");
+  alice.idToken = unsignedIdToken(1700000000, 4000000000, "alice");
+  auto carol = makeAccount(AuthProvider::GOOGLE, "carol", "carol-1");
+  carol.idToken = unsignedIdToken(1700000000, 4000000000, "carol");
+  auth->login(AuthProvider::GOOGLE, std::nullopt);
+  lastLoginPromise->resolve(alice);
+  auth->login(AuthProvider::GOOGLE, std::nullopt);
+  lastLoginPromise->resolve(carol);
+
+  // Google now holds carol's session; refreshing alice there would return carol's tokens.
+  const int calls = refreshCalls;
+  auth->switchAccount("google:alice");
+  auto refused = auth->refreshToken();
+  assert(refused->isRejected() && errorMessage(refused->getError()) == "not_signed_in");
+  assert(auth->getAccessTokenForAccount("google:alice", AccessTokenRequest(std::nullopt, std::vector<std::string>{"drive"}))
+           ->isRejected());
+  assert(refreshCalls == calls);
+  assert(auth->getCurrentUser()->accessToken == "alice-1");
+
+  auth->switchAccount("google:carol");
+  auto carolRefresh = auth->refreshToken();
+  assert(refreshCalls == calls + 1);
+  lastRefreshPromise->resolve(makeTokens("carol-2", carol.idToken, std::nullopt, futureTimestampMs()));
+  assert(carolRefresh->isResolved() && auth->getCurrentUser()->accessToken == "carol-2");
+
+  // Signing in to alice again hands the platform session back to her.
+  auth->login(AuthProvider::GOOGLE, std::nullopt);
+  lastLoginPromise->resolve(alice);
+  auto confused = auth->refreshToken();
+  assert(refreshCalls == calls + 2);
+  lastRefreshPromise->resolve(
+    makeTokens("carol-3", unsignedIdToken(1700000000, 4000000000, "carol"), std::nullopt, futureTimestampMs()));
+  assert(confused->isRejected() && errorMessage(confused->getError()) == "token_error");
+  assert(auth->getCurrentUser()->accessToken == "alice-1");
+  assert(auth->getCurrentUser()->idToken == alice.idToken);
+
+  auth->login(AuthProvider::GOOGLE, std::nullopt);
+  lastLoginPromise->resolve(alice);
+  auto refreshed = auth->refreshToken();
+  lastRefreshPromise->resolve(
+    makeTokens("alice-2", unsignedIdToken(1700000000, 4000000001, "alice"), std::nullopt, futureTimestampMs()));
+  assert(refreshed->isResolved() && auth->getCurrentUser()->accessToken == "alice-2");
+
+  // A local refusal is not backed off: once requestScopes hands carol the
+  // platform session again, her next refresh reaches the platform.
+  auth->switchAccount("google:carol");
+  auto carolRefused = auth->refreshToken();
+  assert(carolRefused->isRejected() && errorMessage(carolRefused->getError()) == "not_signed_in");
+  const int beforeScopes = refreshCalls;
+  auto granted = auth->requestScopes({"drive"});
+  lastRequestScopesPromise->resolve(carol);
+  assert(granted->isResolved() && auth->getCurrentUser()->userId == "carol");
+  auto carolRefreshed = auth->refreshToken();
+  assert(refreshCalls == beforeScopes + 1);
+  lastRefreshPromise->resolve(makeTokens("carol-4", carol.idToken, std::nullopt, futureTimestampMs()));
+  assert(carolRefreshed->isResolved() && auth->getCurrentUser()->accessToken == "carol-4");
+}
+
+void testRefreshTimingCorrectsServerClockSkew() {
+  resetPlatformMocks();
+  auto auth = std::make_shared<HybridAuth>();
+  // The device clock runs ten minutes behind the server's.
+  constexpr int64_t kIssuedAtSeconds = 1'700'000'000;
+  constexpr int64_t kExpiresAtMs = (kIssuedAtSeconds + 3600) * 1000;
+  auto time = std::make_shared<VirtualTime>(kIssuedAtSeconds * 1000 - 600000);
+  auth->setClock(time);
+  auth->setTimerService(time);
+
+  // Android copies the id_token `exp` into expirationTime, so it is server time.
+  auto user = makeUser(std::vector<std::string>{"profile"}, "server-stamped", static_cast<double>(kExpiresAtMs));
+  user.idToken = unsignedIdToken(kIssuedAtSeconds, kIssuedAtSeconds + 3600);
+  auth->login(AuthProvider::GOOGLE, std::nullopt);
+  lastLoginPromise->resolve(user);
+  assert(auth->getClockSkewEstimate().skewMs == 600000);
+  assert(auth->getClockSkewEstimate().samples == 1);
+
+  // Four minutes before the token really expires; the device clock says fourteen.
+  time->advanceTo(kExpiresAtMs - 600000 - 4 * 60000);
+  RefreshTimingPolicy uncorrected;
+  uncorrected.correctClockSkew = false;
+  auth->setRefreshTimingPolicy(uncorrected);
+  assert(resolvedToken(auth->getAccessToken()) == "server-stamped");
+  assert(refreshCalls == 0);
+  auth->setRefreshTimingPolicy(RefreshTimingPolicy{});
+  auto refreshed = auth->getAccessToken();
+  assert(refreshCalls == 1);
+  const double deviceExpiryMs = static_cast<double>(time->nowMs() + 3600000);
+  lastRefreshPromise->resolve(makeTokens("device-stamped", std::nullopt, std::nullopt, deviceExpiryMs));
+  assert(resolvedToken(refreshed) == "device-stamped");
+
+  // An expiry computed from `expires_in` is already on the device clock and is not shifted.
+  time->advance(3600000 - 6 * 60000);
+  assert(resolvedToken(auth->getAccessToken()) == "device-stamped");
+  assert(refreshCalls == 1);
+
+  // The refresh window itself is policy.
+  time->advance(4 * 60000);
+  RefreshTimingPolicy narrow;
+  narrow.refreshWindowMs = 60000;
+  auth->setRefreshTimingPolicy(narrow);
+  assert(resolvedToken(auth->getAccessToken()) == "device-stamped");
+  assert(refreshCalls == 1);
+  auth->setRefreshTimingPolicy(RefreshTimingPolicy{});
+  auth->getAccessToken();
+  assert(refreshCalls == 2);
+}
+
+void testRotatedRefreshTokensReplaceTheSessionOnce() {
+  resetPlatformMocks();
+  auto auth = std::make_shared<HybridAuth>();
+  auto store = std::make_shared<RecordingSessionStore>();
+  auth->setSessionStore(store);
+  std::vector<std::optional<std::string>> refreshedTokens;
+  auth->onTokensRefreshed([&refreshedTokens](const AuthTokens& tokens) { refreshedTokens.push_back(tokens.refreshToken); });
+
+  auth->login(AuthProvider::MICROSOFT, std::nullopt);
+  auto user = makeAccount(AuthProvider::MICROSOFT, "bob", "session-1");
+  user.refreshToken = "rt-1";
+  lastLoginPromise->resolve(user);
+  assert(store->stored->refreshToken == "rt-1");
+
+  auto rotated = auth->refreshToken();
+  lastRefreshPromise->resolve(makeTokens("session-2", std::nullopt, "rt-2", futureTimestampMs()));
+  assert(rotated->isResolved());
+  assert(auth->getCurrentUser()->refreshToken == "rt-2");
+  assert(store->tokenSaves.back().refreshToken == "rt-2");
+  assert(store->stored->refreshToken == "rt-2");
+
+  // A resource refresh that rotates the grant moves the session to the new
+  // refresh token without touching its access token.
+  AccessTokenRequest graph;
+  graph.resource = "https://graph.microsoft.com";
+  auto graphToken = auth->getAccessToken(graph);
+  lastRefreshPromise->resolve(makeTokens("graph-token", std::nullopt, "rt-3", futureTimestampMs()));
+  assert(resolvedToken(graphToken) == "graph-token");
+  assert(auth->getCurrentUser()->refreshToken == "rt-3");
+  assert(auth->getCurrentUser()->accessToken == "session-2");
+  assert(!store->tokenSaves.back().accessToken.has_value());
+  assert(store->stored->refreshToken == "rt-3");
+  assert(store->stored->accessToken == "session-2");
+
+  // A result carrying a superseded token keeps its access token but never
+  // writes the old refresh token back into the session, the store or listeners.
+  auto saves = store->tokenSaves.size();
+  auto replayed = auth->refreshToken();
+  lastRefreshPromise->resolve(makeTokens("session-3", std::nullopt, "rt-1", futureTimestampMs()));
+  std::optional<std::string> replayedRefreshToken = "unset";
+  replayed->addOnResolvedListener(
+      [&replayedRefreshToken](const AuthTokens& tokens) { replayedRefreshToken = tokens.refreshToken; });
+  assert(!replayedRefreshToken.has_value());
+  assert(auth->getCurrentUser()->accessToken == "session-3");
+  assert(auth->getCurrentUser()->refreshToken == "rt-3");
+  assert(store->tokenSaves.size() == saves + 1);
+  assert(!store->tokenSaves.back().refreshToken.has_value());
+  assert(store->stored->refreshToken == "rt-3");
+  assert((refreshedTokens == std::vector<std::optional<std::string>>{"rt-2", std::nullopt}));
+
+  auto stats = auth->getRefreshTokenStats();
+  assert(stats.rotations == 2);
+  assert(stats.reusesRejected == 1);
+
+  // A restore that brings back a superseded token keeps the account's ledger,
+  // and the token is refused before it reaches the platform.
+  auto restore = auth->silentRestore();
+  auto stale = makeAccount(AuthProvider::MICROSOFT, "bob", "session-restored");
+  stale.refreshToken = "rt-2";
+  lastSilentRestorePromise->resolve(std::make_optional(stale));
+  assert(restore->isResolved());
+  const int callsBefore = refreshCalls;
+  auto refused = auth->refreshToken();
+  assert(refused->isRejected() && errorMessage(refused->getError()) == "invalid_grant");
+  assert(refreshCalls == callsBefore);
+  assert(auth->getRefreshTokenStats().reusesRejected == 2);
+}
+
+void testConstructionPrefetchesProviderMetadata() {
+  std::cout << "Running testConstructionPrefetchesProviderMetadata..." << std::endl;
+  auto http = std::make_shared<RecordingHttpClient>();
+  platformHttpClient = http;
+  configuredAuthorities = {"https://login.example.com/tenant/v2.0/"};
+
+  auto auth = std::make_shared<HybridAuth>();
+  assert(auth->getMetadataCache() != nullptr);
+  // The prefetch runs on the shared timer thread.
+  for (int attempt = 0; attempt < 200 && http->recorded().empty(); ++attempt) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  }
+  assert(http->recorded() ==
+         std::vector<std::string>{"https://login.example.com/tenant/v2.0/.well-known/openid-configuration"});
+
+  platformHttpClient = nullptr;
+  configuredAuthorities.clear();
+}
+
+void testVerifyIdTokenAgainstCachedKeys() {
+  std::cout << "Running testVerifyIdTokenAgainstCachedKeys..." << std::endl;
+  resetPlatformMocks();
+  auto http = std::make_shared<RoutedHttpClient>();
+  http->routes[kMicrosoftAuthority + "/.well-known/openid-configuration"] = kMicrosoftDiscovery;
+  http->routes[kMicrosoftJwksUri] = kMicrosoftJwks;
+  auto auth = std::make_shared<HybridAuth>();
+  auth->setMetadataCache(std::make_shared<OidcMetadataCache>(http));
+
+  IdTokenVerificationOptions options;
+  options.audience = "client-123";
+  options.nonce = "n-0S6_WzA2Mj";
+  auto signedOut = auth->verifyIdToken(options);
+  assert(signedOut->isRejected() && errorMessage(signedOut->getError()) == "not_signed_in");
+
+  auth->login(AuthProvider::GOOGLE, std::nullopt);
+  lastLoginPromise->resolve(makeAccount(AuthProvider::GOOGLE, "alice", "alice-1"));
+  auto withoutToken = auth->verifyIdToken(options);
+  assert(withoutToken->isRejected() && errorMessage(withoutToken->getError()) == "no_id_token");
+
+  auto microsoft = makeAccount(AuthProvider::MICROSOFT, "bob", "bob-1");
+  microsoft.idToken = kMicrosoftIdToken;
+  auth->login(AuthProvider::MICROSOFT, std::nullopt);
+  lastLoginPromise->resolve(microsoft);
+
+  auto verified = auth->verifyIdToken(options);
+  assert(verified->isResolved());
+  assert(verified->getResult().issuer == kMicrosoftAuthority);
+  assert(verified->getResult().subject == "AAAAAAAAAAAAAAAAAAAAAIkzqFVrSaSaFHy782bbtaQ");
+  assert(verified->getResult().expiresAt == 2000000000000.0);
+  assert(verified->getResult().email == std::optional<std::string>("bob@example.com"));
+
+  // The second check is offline and skips the signature.
+  assert(auth->verifyIdToken(options)->isResolved());
+  assert(http->hits[kMicrosoftJwksUri] == 1);
+  assert(auth->getIdTokenVerifierStats().signatureChecks == 1);
+  assert(auth->getIdTokenVerifierStats().memoHits == 1);
+
+  options.nonce = "replayed";
+  auto nonce = auth->verifyIdToken(options);
+  assert(nonce->isRejected() && errorMessage(nonce->getError()) == "invalid_nonce");
+  options.nonce = std::nullopt;
+  options.audience = "other-client";
+  auto audience = auth->verifyIdToken(options);
+  assert(audience->isRejected() && errorMessage(audience->getError()) == "token_error");
+  options.audience = "client-123";
+
+  // A token signed by a key the cached JWKS does not list refetches the keys once.
+  http->routes[kMicrosoftJwksUri] = kRotatedMicrosoftJwks;
+  microsoft.idToken = kRotatedMicrosoftIdToken;
+  auth->login(AuthProvider::MICROSOFT, std::nullopt);
+  lastLoginPromise->resolve(microsoft);
+  assert(auth->verifyIdToken(options)->isResolved());
+  assert(http->hits[kMicrosoftJwksUri] == 2);
+
+  // A forged signature is rejected without further fetches.
+  std::string forged = kRotatedMicrosoftIdToken;
+  forged[forged.size() - 4] = forged[forged.size() - 4] == 'A' ? 'B' : 'A';
+  microsoft.idToken = forged;
+  auth->login(AuthProvider::MICROSOFT, std::nullopt);
+  lastLoginPromise->resolve(microsoft);
+  auto rejected = auth->verifyIdToken(options);
+  assert(rejected->isRejected() && errorMessage(rejected->getError()) == "token_error");
+  assert(http->hits[kMicrosoftJwksUri] == 2);
+}
+
+void testResourceTokenCacheHonorsLimits() {
+  resetPlatformMocks();
+  auto auth = std::make_shared<HybridAuth>();
+  AccessTokenCacheLimits limits;
+  limits.maxEntries = 2;
+  auth->setAccessTokenCacheLimits(limits);
+
+  auth->login(AuthProvider::MICROSOFT, std::nullopt);
+  lastLoginPromise->resolve(makeAccount(AuthProvider::MICROSOFT, "bob", "session-token"));
+
+  auto fetch = [&auth](const std::string& resource) {
+    AccessTokenRequest request;
+    request.resource = resource;
+    auto token = auth->getAccessToken(request);
+    if (token->isPending()) {
+      lastRefreshPromise->resolve(makeTokens(resource + "-token", std::nullopt, std::nullopt, futureTimestampMs()));
+    }
+    return resolvedToken(token);
+  };
+  fetch("https://a.example.com");
+  fetch("https://b.example.com");
+  fetch("https://a.example.com");
+  fetch("https://c.example.com");
+  assert(refreshCalls == 3);
+  // b was least recently used.
+  assert(fetch("https://a.example.com") == "https://a.example.com-token");
+  assert(refreshCalls == 3);
+  fetch("https://b.example.com");
+  assert(refreshCalls == 4);
+  assert(auth->getAccessTokenCacheStats().evictions == 2);
+
+  // Failures are not cached and do not back off the session refresh.
+  AccessTokenRequest failing;
+  failing.resource = "https://failing.example.com";
+  auto failed = auth->getAccessToken(failing);
+  lastRefreshPromise->resolve(AuthError("network_error"));
+  assert(failed->isRejected());
+  auto sessionRefresh = auth->refreshToken();
+  assert(refreshCalls == 6);
+  lastRefreshPromise->resolve(makeTokens("session-2"));
+  assert(sessionRefresh->isResolved());
+}
+
+void testOidcProviderRunsInTheCore() {
+  std::cout << "Running testOidcProviderRunsInTheCore..." << std::endl;
+  resetPlatformMocks();
+  const std::string tokenEndpoint =
+      "https://login.microsoftonline.com/9188040d-6c67-4c5b-b112-36a304b66dad/oauth2/v2.0/token";
+  auto auth = std::make_shared<HybridAuth>();
+  auto unconfigured = auth->login(AuthProvider::OIDC, std::nullopt);
+  assert(unconfigured->isRejected() && errorMessage(unconfigured->getError()) == "configuration_error");
+
+  OidcProviderConfig config;
+  config.issuer = kMicrosoftAuthority;
+  config.clientId = "client-123";
+  config.redirectUri = "com.example.app:/oauth2redirect";
+  auth->configureOidc(config);
+
+  auto http = std::make_shared<RoutedHttpClient>();
+  http->routes[kMicrosoftAuthority + "/.well-known/openid-configuration"] = kMicrosoftDiscovery;
+  http->routes[kMicrosoftJwksUri] = kMicrosoftJwks;
+  http->routes[tokenEndpoint] = "{\"access_token\":\"at-1\",\"id_token\":\"" + kMicrosoftIdToken +
+                                "\",\"refresh_token\":\"rt-1\",\"expires_in\":3600,\"token_type\":\"Bearer\"}";
+  platformHttpClient = http;
+  auth->setMetadataCache(std::make_shared<OidcMetadataCache>(http));
+
+  LoginOptions options;
+  options.nonce = "n-0S6_WzA2Mj";
+  auto login = auth->login(AuthProvider::OIDC, options);
+  assert(login->isPending() && lastBrowserPromise && !lastLoginPromise);
+  const auto state = OidcClient::parseRedirect(lastBrowserUrl).state;
+  assert(state && !state->empty());
+  lastBrowserPromise->resolve(config.redirectUri + "?code=auth-code&state=" + *state);
+  assert(login->isResolved());
+  assert(http->hits[tokenEndpoint] == 1);
+
+  auto user = auth->getCurrentUser();
+  assert(user && user->provider == AuthProvider::OIDC);
+  assert(user->userId == std::optional<std::string>("AAAAAAAAAAAAAAAAAAAAAIkzqFVrSaSaFHy782bbtaQ"));
+  assert(user->email == std::optional<std::string>("bob@example.com"));
+  assert(user->accessToken == std::optional<std::string>("at-1"));
+  assert(user->refreshToken == std::optional<std::string>("rt-1"));
+  assert(auth->getAccounts().front().id == "oidc:AAAAAAAAAAAAAAAAAAAAAIkzqFVrSaSaFHy782bbtaQ");
+
+  IdTokenVerificationOptions verification;
+  verification.audience = "client-123";
+  assert(auth->verifyIdToken(verification)->isResolved());
+
+  // Refresh goes to the token endpoint, never the platform, and keeps a rotated refresh token.
+  http->routes[tokenEndpoint] = "{\"access_token\":\"at-2\",\"refresh_token\":\"rt-2\",\"expires_in\":3600}";
+  auto refreshed = auth->refreshToken();
+  assert(refreshed->isResolved());
+  assert(refreshCalls == 0);
+  assert(auth->getCurrentUser()->accessToken == std::optional<std::string>("at-2"));
+  assert(auth->getCurrentUser()->refreshToken == std::optional<std::string>("rt-2"));
+
+  http->routes[tokenEndpoint] = "{\"error\":\"invalid_grant\"}";
+  auto revoked = auth->refreshToken();
+  assert(revoked->isRejected() && errorMessage(revoked->getError()) == "token_error");
+
+  // A redirect carrying another request's state is refused and keeps the session.
+  auto forged = auth->login(AuthProvider::OIDC, options);
+  lastBrowserPromise->resolve(config.redirectUri + "?code=auth-code&state=forged");
+  assert(forged->isRejected() && errorMessage(forged->getError()) == "invalid_state");
+
+  // Deadlines and cancellation close the browser session.
+  auto cancellation = std::make_shared<CancellationToken>();
+  auto cancelled = auth->login(AuthProvider::OIDC, options, cancellation);
+  cancellation->cancel();
+  assert(cancelled->isRejected() && errorMessage(cancelled->getError()) == "cancelled");
+  assert(failed(lastBrowserPromise));
+
+  platformHttpClient = nullptr;
+}
+
+void testOidcDeviceCodeLoginPollsNatively() {
+  std::cout << "Running testOidcDeviceCodeLoginPollsNatively..." << std::endl;
+  resetPlatformMocks();
+  const std::string deviceEndpoint =
+      "https://login.microsoftonline.com/9188040d-6c67-4c5b-b112-36a304b66dad/oauth2/v2.0/devicecode";
+  const std::string tokenEndpoint =
+      "https://login.microsoftonline.com/9188040d-6c67-4c5b-b112-36a304b66dad/oauth2/v2.0/token";
+  auto timers = std::make_shared<VirtualTime>();
+  auto auth = std::make_shared<HybridAuth>();
+  auth->setTimerService(timers);
+
+  auto http = std::make_shared<RoutedHttpClient>();
+  http->routes[kMicrosoftAuthority + "/.well-known/openid-configuration"] =
+      kMicrosoftDiscovery.substr(0, kMicrosoftDiscovery.size() - 1) + ",\"device_authorization_endpoint\":\"" +
+      deviceEndpoint + "\"}";
+  http->routes[kMicrosoftJwksUri] = kMicrosoftJwks;
+  http->routes[deviceEndpoint] =
+      "{\"device_code\":\"dc-1\",\"user_code\":\"WDJB-MJHT\",\"verification_uri\":\"https://microsoft.com/devicelogin\","
+      "\"expires_in\":900,\"interval\":5}";
+  http->routes[tokenEndpoint] = "{\"error\":\"authorization_pending\"}";
+  platformHttpClient = http;
+  auth->setMetadataCache(std::make_shared<OidcMetadataCache>(http));
+  OidcProviderConfig config;
+  config.issuer = kMicrosoftAuthority;
+  config.clientId = "client-123";
+  config.redirectUri = "com.example.app:/oauth2redirect";
+  auth->configureOidc(config);
+
+  std::vector<DeviceAuthorization> codes;
+  auto unsubscribe = auth->onDeviceCode([&codes](const DeviceAuthorization& code) { codes.push_back(code); });
+  LoginOptions options;
+  options.useDeviceCode = true;
+  auto login = auth->login(AuthProvider::OIDC, options);
+  assert(login->isPending() && !lastBrowserPromise && !lastLoginPromise);
+  assert(codes.size() == 1 && codes[0].userCode == "WDJB-MJHT");
+  assert(codes[0].verificationUri == "https://microsoft.com/devicelogin");
+
+  timers->advance(5000);
+  assert(http->hits[tokenEndpoint] == 1 && login->isPending());
+  http->routes[tokenEndpoint] = "{\"access_token\":\"at-1\",\"id_token\":\"" + kMicrosoftIdToken +
+                                "\",\"refresh_token\":\"rt-1\",\"expires_in\":3600}";
+  timers->advance(5000);
+  assert(login->isResolved());
+  auto user = auth->getCurrentUser();
+  assert(user && user->provider == AuthProvider::OIDC);
+  assert(user->accessToken == std::optional<std::string>("at-1"));
+  assert(timers->pending() == 0);
+
+  // Logging out stops a device login that is still waiting for approval.
+  http->routes[tokenEndpoint] = "{\"error\":\"authorization_pending\"}";
+  auto abandoned = auth->login(AuthProvider::OIDC, options);
+  assert(codes.size() == 2);
+  timers->advance(5000);
+  auth->logout();
+  assert(abandoned->isRejected() && errorMessage(abandoned->getError()) == "cancelled");
+  assert(timers->pending() == 0);
+  const int polls = http->hits[tokenEndpoint];
+  timers->advance(60000);
+  assert(http->hits[tokenEndpoint] == polls);
+
+  // The device grant is only wired up for the OIDC provider.
+  auto google = auth->login(AuthProvider::GOOGLE, options);
+  assert(google->isRejected() && errorMessage(google->getError()) == "unsupported_provider");
+  assert(!lastLoginPromise);
+
+  unsubscribe();
+  platformHttpClient = nullptr;
+}
+
+void testTraceRecorderCapturesCallsAndPlatformOutcomes() {
+  resetPlatformMocks();
+  auto time = std::make_shared<VirtualTime>(1'000'000);
+  auto auth = std::make_shared<HybridAuth>();
+  auth->setClock(time);
+  auth->setTimerService(time);
+  auto recorder = std::make_shared<AuthTraceRecorder>();
+  auth->setTraceRecorder(recorder);
+
+  auto login = auth->login(AuthProvider::GOOGLE, std::nullopt);
+  time->advance(800);
+  lastLoginPromise->resolve(makeUser(std::nullopt, "first", static_cast<double>(time->nowMs() + 3'600'000)));
+  assert(login->isResolved());
+
+  AccessTokenRequest request;
+  request.scopes = std::vector<std::string>{"b", "a"};
+  auto resource = auth->getAccessToken(request);
+  lastRefreshPromise->resolve(AuthError("network_error"));
+  assert(resource->isRejected());
+  auth->logout();
+
+  auth->setTraceRecorder(nullptr);
+  auth->getAccessToken();
+
+  const auto events = recorder->events();
+  assert(events.size() == 5);
+  assert(events[0].op == AuthTraceOp::LOGIN && events[0].provider == AuthProvider::GOOGLE);
+  assert(events[0].atMs == 1'000'000);
+  assert(events[1].op == AuthTraceOp::PLATFORM_LOGIN);
+  assert(events[1].atMs == 1'000'800);
+  assert(events[1].account == 0u && events[1].lifetimeMs == 3'600'000 && !events[1].error);
+  assert(events[2].op == AuthTraceOp::GET_ACCESS_TOKEN);
+  assert((events[2].scopes == std::vector<std::string>{"a", "b"}));
+  assert(events[3].op == AuthTraceOp::PLATFORM_REFRESH && events[3].error == AuthErrorCode::NETWORK_ERROR);
+  assert(events[4].op == AuthTraceOp::LOGOUT);
+  // Account ids carry emails; the trace only numbers them.
+  assert(recorder->encode().find("test@example.com") == std::string::npos);
+}
+
+void testCurrentUserViewFollowsTheSession() {
+  resetPlatformMocks();
+  auto auth = std::make_shared<HybridAuth>();
+  jsi::Runtime runtime;
+  auth->toObject(runtime);
+  const auto& registered = auth->prototype().rawMethods;
+  assert(std::find(registered.begin(), registered.end(), "getCurrentUserView") != registered.end());
+  assert(auth->getCurrentUserView(runtime, jsi::Value::undefined(), nullptr, 0).isUndefined());
+
+  auto login = auth->login(AuthProvider::GOOGLE, std::nullopt);
+  lastLoginPromise->resolve(makeUser(std::vector<std::string>{"profile"}, "old", futureTimestampMs()));
+  assert(login->isResolved());
+
+  auto first = auth->getCurrentUserView(runtime, jsi::Value::undefined(), nullptr, 0).asObject(runtime);
+  auto host = first.getHostObject<AuthUserHostObject>(runtime);
+  assert(host && first.getProperty(runtime, "accessToken").getString(runtime).utf8(runtime) == "old");
+  auto again = auth->getCurrentUserView(runtime, jsi::Value::undefined(), nullptr, 0).asObject(runtime);
+  assert(again.getHostObject<AuthUserHostObject>(runtime) == host);
+  assert(host->materializedCount() == 1);
+
+  auto refresh = auth->refreshToken();
+  lastRefreshPromise->resolve(makeTokens("new", "id", "refresh", futureTimestampMs()));
+  assert(refresh->isResolved());
+  auto refreshed = auth->getCurrentUserView(runtime, jsi::Value::undefined(), nullptr, 0).asObject(runtime);
+  assert(refreshed.getHostObject<AuthUserHostObject>(runtime) != host);
+  assert(refreshed.getProperty(runtime, "accessToken").getString(runtime).utf8(runtime) == "new");
+  // The superseded view still reads its own snapshot.
+  assert(first.getProperty(runtime, "accessToken").getString(runtime).utf8(runtime) == "old");
+  assert(auth->getCurrentUserSnapshot()->view(AuthUserField::ACCESS_TOKEN) == "new");
+
+  auth->logout();
+  assert(auth->getCurrentUserView(runtime, jsi::Value::undefined(), nullptr, 0).isUndefined());
+  assert(!auth->getCurrentUserSnapshot());
+}
+
+void testSessionSnapshotIsConsistentAndVersioned() {
+  resetPlatformMocks();
+  auto time = std::make_shared<VirtualTime>(1'000'000);
+  auto auth = std::make_shared<HybridAuth>();
+  auth->setClock(time);
+  auth->setTimerService(time);
+
+  auto signedOut = auth->getSessionSnapshot();
+  assert(!signedOut.user && signedOut.scopes.empty() && !signedOut.hasValidAccessToken);
+  assert(!signedOut.accessTokenExpiresIn);
+
+  auto login = auth->login(AuthProvider::GOOGLE, std::nullopt);
+  lastLoginPromise->resolve(makeUser(std::vector<std::string>{"profile"}, "first", 1'000'000 + 3'600'000.0));
+  assert(login->isResolved());
+  auto signedIn = auth->getSessionSnapshot();
+  assert(signedIn.version > signedOut.version);
+  assert(signedIn.user == auth->getCurrentUser());
+  assert(signedIn.scopes == auth->getGrantedScopes());
+  assert(signedIn.hasValidAccessToken && signedIn.accessTokenExpiresIn == 3'600'000.0);
+
+  // Time passing changes token state, not the version.
+  time->advance(3'600'000);
+  auto expired = auth->getSessionSnapshot();
+  assert(expired.version == signedIn.version);
+  assert(!expired.hasValidAccessToken && expired.accessTokenExpiresIn == 0.0);
+
+  auto refresh = auth->refreshToken();
+  lastRefreshPromise->resolve(makeTokens("second", std::nullopt, std::nullopt, 1'000'000 + 7'200'000.0));
+  assert(refresh->isResolved());
+  auto refreshed = auth->getSessionSnapshot();
+  assert(refreshed.version > expired.version);
+  assert(refreshed.user->accessToken == "second" && refreshed.hasValidAccessToken);
+
+  auth->revokeScopes({"profile"});
+  auto narrowed = auth->getSessionSnapshot();
+  assert(narrowed.version > refreshed.version && narrowed.scopes.empty());
+  assert(auth->getSessionSnapshot().version == narrowed.version);
+
+  auth->logout();
+  auto loggedOut = auth->getSessionSnapshot();
+  assert(loggedOut.version > narrowed.version && !loggedOut.user);
+}
+
+void testChangePollingComparesVersionsOnly() {
+  resetPlatformMocks();
+  auto auth = std::make_shared<HybridAuth>();
+  const double signedOut = auth->getSessionVersion();
+  assert(!auth->getCurrentUserIfChanged(signedOut));
+
+  auto login = auth->login(AuthProvider::GOOGLE, std::nullopt);
+  lastLoginPromise->resolve(makeUser(std::vector<std::string>{"profile"}, "first", futureTimestampMs()));
+  assert(login->isResolved());
+  auto change = auth->getCurrentUserIfChanged(signedOut);
+  assert(change && change->user == auth->getCurrentUser());
+  assert(change->version > signedOut && change->version == auth->getSessionVersion());
+  assert(!auth->getCurrentUserIfChanged(change->version));
+
+  // Refreshes keep the session generation but are visible changes.
+  auto refresh = auth->refreshToken();
+  lastRefreshPromise->resolve(makeTokens("second", std::nullopt, std::nullopt, futureTimestampMs()));
+  assert(refresh->isResolved());
+  auto refreshed = auth->getCurrentUserIfChanged(change->version);
+  assert(refreshed && refreshed->user->accessToken == "second");
+
+  // A stale caller version from before a logout reports the signed-out state.
+  auth->logout();
+  auto loggedOut = auth->getCurrentUserIfChanged(change->version);
+  assert(loggedOut && !loggedOut->user && loggedOut->version > refreshed->version);
+  assert(!auth->getCurrentUserIfChanged(loggedOut->version));
+}
+
 } // namespace
 
+void testLogoutCancelsABurstOfQueuedOperations() {
+  resetPlatformMocks();
+  auto auth = std::make_shared<HybridAuth>();
+  const auto before = auth->getMemoryStats().pendingOperations;
+
+  std::vector<std::shared_ptr<Promise<void>>> queued;
+  for (int i = 0; i < 2'000; i++) {
+    queued.push_back(i % 2 == 0 ? auth->requestScopes({"scope-" + std::to_string(i)}) : auth->silentRestore());
+  }
+  // A settled call leaves the registry, so logout does not touch it again.
+  lastSilentRestorePromise->resolve(std::optional<AuthUser>());
+  assert(queued.back()->isResolved());
+  assert(auth->getMemoryStats().pendingOperations.bytes > before.bytes);
+
+  auth->logout();
+  for (size_t i = 0; i + 1 < queued.size(); i++) {
+    assert(queued[i]->isRejected());
+    assert(errorMessage(queued[i]->getError()) == "cancelled");
+  }
+  assert(auth->getMemoryStats().pendingOperations.bytes == before.bytes);
+}
+
+void testMemoryStatsTrackSessionsAndListeners() {
+  resetPlatformMocks();
+  auto auth = std::make_shared<HybridAuth>();
+  const auto before = auth->getMemoryStats();
+
+  auto unsubscribe = auth->onAuthStateChanged([](const std::optional<AuthUser>&) {});
+  auto subscribed = auth->getMemoryStats();
+  assert(subscribed.listeners.allocations == before.listeners.allocations + 1);
+  assert(subscribed.listeners.bytes > before.listeners.bytes);
+
+  auto login = auth->login(AuthProvider::GOOGLE, std::nullopt);
+  auto inFlight = auth->getMemoryStats();
+  assert(inFlight.platformOperations.allocations > before.platformOperations.allocations);
+  assert(inFlight.pendingOperations.bytes > before.pendingOperations.bytes);
+  lastLoginPromise->resolve(makeUser(std::vector<std::string>{"profile"}, "token", std::nullopt));
+  assert(login->isResolved());
+  lastLoginPromise.reset();
+
+  auto signedIn = auth->getMemoryStats();
+  // The account plus its packed user, whose buffer holds the tokens.
+  assert(signedIn.sessions.allocations >= before.sessions.allocations + 2);
+  assert(signedIn.sessions.bytes > before.sessions.bytes + std::string("token").size());
+  assert(signedIn.platformOperations.allocations == before.platformOperations.allocations);
+  assert(signedIn.totalBytes >= signedIn.sessions.bytes + signedIn.listeners.bytes);
+  assert(signedIn.peakBytes >= signedIn.totalBytes);
+
+  unsubscribe();
+  auth->logout();
+  auto loggedOut = auth->getMemoryStats();
+  assert(loggedOut.listeners.bytes == before.listeners.bytes);
+  assert(loggedOut.sessions.bytes == before.sessions.bytes);
+  assert(loggedOut.sessions.peakBytes >= signedIn.sessions.bytes);
+}
+
 int main() {
   testScopeMergesAndRemovals();
   testListenerExceptionsDoNotBlockStateUpdates();
   testRefreshCancelledWhenSessionChanges();
   testLoginStartInvalidatesSilentRestore();
   testPendingLoginCancelledWhenSessionChanges();
+  testSupersededInteractiveCallsReleaseThePlatform();
   testRevokeAccessCancelsPendingOperationsAndClearsSession();
   testLogoutCancelsRefreshAndClearsSession();
   testSynchronousAccessorsAndListenerUnsubscribe();
@@ -424,6 +1712,28 @@ int main() {
   testScopeRejectionAndNoUserRevokePaths();
   testAccessTokenReadRefreshAndFallbackPaths();
   testRefreshTokenSuccessFailureAndTokenListenerPaths();
+  testRefreshFailuresBackOffAndServeStillValidToken();
+  testDeadlinesReleaseStuckPlatformOperations();
+  testCancellationTokensAbortOperations();
+  testSessionStoreReceivesSessionChangesInOrder();
+  testAccountsSwitchAndRefreshIndependently();
+  testQueuedRefreshDroppedWhenAccountRemoved();
+  testResourceTokensAreCachedPerScopeSet();
+  testRotatedRefreshTokensReplaceTheSessionOnce();
+  testRefreshStaysWithItsAccount();
+  testRefreshTimingCorrectsServerClockSkew();
+  testSharedSessionFollowsTheActiveAccount();
+  testResourceTokenCacheHonorsLimits();
+  testConstructionPrefetchesProviderMetadata();
+  testVerifyIdTokenAgainstCachedKeys();
+  testOidcProviderRunsInTheCore();
+  testOidcDeviceCodeLoginPollsNatively();
+  testTraceRecorderCapturesCallsAndPlatformOutcomes();
+  testCurrentUserViewFollowsTheSession();
+  testSessionSnapshotIsConsistentAndVersioned();
+  testChangePollingComparesVersionsOnly();
+  testMemoryStatsTrackSessionsAndListeners();
+  testLogoutCancelsABurstOfQueuedOperations();
 
   std::cout << "HybridAuth tests passed!" << std::endl;
   return 0;
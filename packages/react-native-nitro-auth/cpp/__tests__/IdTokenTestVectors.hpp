@@ -0,0 +1,96 @@
+#pragma once
+
+#include <string>
+
+namespace margelo::nitro::NitroAuth::vectors {
+
+// Generated with OpenSSL: RSA-2048 keys rsa-1..3 and a P-256 key ec-1. Every
+// token carries iss https://issuer.example.com, aud client-123, exp 2000000000,
+// iat 1700000000 and nonce n-0S6_WzA2Mj unless noted. `wrongKey` is signed by
+// rsa-2 but names rsa-1; `rotated` is signed by rsa-3, which only
+// `rotatedJwks` contains; `tenant` is a Microsoft-style token with `tid`.
+inline const std::string kJwks =
+    "{\"keys\":[{\"kty\":\"RSA\",\"kid\":\"rsa-1\",\"use\":\"sig\",\"alg\":\"RS256\",\"n\":\"5cHUpq5dk4KGPBR7_cMzVJogtAxuMgJZP"
+    "o1fj2qnpBaOg7cNJb2R0JZDqRyS5IQPBg_CQkYTrADBBdY7a_qVqVKOgnhk9nVCgkaDLSQHC1oubYN8-XlJMBtEnsMstKOx5Pij5"
+    "ZCOl-QcwAyXjiFLzDw6v6G93Wli6oR978KwsldYCfvSyAB9F3FpFyi57XjBnoOAmG5tNpReFdsBndY4BbcHL-dvWlQp6RSdZHuZ4"
+    "4SA0q1Gu8DllMj9MH2FOmTpLX7TtKKOjKuA_sjZE4NbLJXH8mFX6cxobRKOn4z2ex58iISn7JGAItyzPTwFMNB6zrG7a1uTTY5oa"
+    "XTa1uAZzQ\",\"e\":\"AQAB\"},{\"kty\":\"RSA\",\"kid\":\"rsa-2\",\"use\":\"sig\",\"alg\":\"RS256\",\"n\":\"7RYk_xtGibTsKrg-ywE"
+    "Ljuxaie4nJMiobwOat3iHSgIyOmKtBmNapIZg4mMdKlNYL5NEcZ_yD9Rct-9maS_Y5Dv5lUSDhcbtFhOn-zxm2H8qK1Qw3Vy3Ynh"
+    "pax0_qLsYkAgS4vupqMdYyinmjAvO5zYHO6k_l_XYmM-gpyRMyLftBpPAkpXH_u-ovI1LcOd_y7ImFyEUC4Y-cvoF1fq60hrSI1b"
+    "lpJg-2CSspuuZXUWjuK6P_RBfR1QqSjGlJUTEhPR9B7fsGcU0n2YqbYfQk09zlvhGXJsT7mlYvEHAK4vN0WPR6At3PPNyVZ82erw"
+    "oJ6hYiXLml0x-PTYqSst7XQ\",\"e\":\"AQAB\"},{\"kty\":\"EC\",\"kid\":\"ec-1\",\"use\":\"sig\",\"crv\":\"P-256\",\"x\":\"1sIm4P-"
+    "TsMV4RmQQBXaGCTmec2M-IRNHmVZoYmiUkLg\",\"y\":\"pjoI6xLuuSpV_8SYglZMgSLTrACXr0-5Ch8K2oVqnW0\"},{\"kty\":\"oct"
+    "\",\"kid\":\"hmac\",\"k\":\"c2VjcmV0\"}]}";
+
+inline const std::string kRotatedJwks =
+    "{\"keys\":[{\"kty\":\"RSA\",\"kid\":\"rsa-1\",\"use\":\"sig\",\"alg\":\"RS256\",\"n\":\"5cHUpq5dk4KGPBR7_cMzVJogtAxuMgJZP"
+    "o1fj2qnpBaOg7cNJb2R0JZDqRyS5IQPBg_CQkYTrADBBdY7a_qVqVKOgnhk9nVCgkaDLSQHC1oubYN8-XlJMBtEnsMstKOx5Pij5"
+    "ZCOl-QcwAyXjiFLzDw6v6G93Wli6oR978KwsldYCfvSyAB9F3FpFyi57XjBnoOAmG5tNpReFdsBndY4BbcHL-dvWlQp6RSdZHuZ4"
+    "4SA0q1Gu8DllMj9MH2FOmTpLX7TtKKOjKuA_sjZE4NbLJXH8mFX6cxobRKOn4z2ex58iISn7JGAItyzPTwFMNB6zrG7a1uTTY5oa"
+    "XTa1uAZzQ\",\"e\":\"AQAB\"},{\"kty\":\"RSA\",\"kid\":\"rsa-2\",\"use\":\"sig\",\"alg\":\"RS256\",\"n\":\"7RYk_xtGibTsKrg-ywE"
+    "Ljuxaie4nJMiobwOat3iHSgIyOmKtBmNapIZg4mMdKlNYL5NEcZ_yD9Rct-9maS_Y5Dv5lUSDhcbtFhOn-zxm2H8qK1Qw3Vy3Ynh"
+    "pax0_qLsYkAgS4vupqMdYyinmjAvO5zYHO6k_l_XYmM-gpyRMyLftBpPAkpXH_u-ovI1LcOd_y7ImFyEUC4Y-cvoF1fq60hrSI1b"
+    "lpJg-2CSspuuZXUWjuK6P_RBfR1QqSjGlJUTEhPR9B7fsGcU0n2YqbYfQk09zlvhGXJsT7mlYvEHAK4vN0WPR6At3PPNyVZ82erw"
+    "oJ6hYiXLml0x-PTYqSst7XQ\",\"e\":\"AQAB\"},{\"kty\":\"EC\",\"kid\":\"ec-1\",\"use\":\"sig\",\"crv\":\"P-256\",\"x\":\"1sIm4P-"
+    "TsMV4RmQQBXaGCTmec2M-IRNHmVZoYmiUkLg\",\"y\":\"pjoI6xLuuSpV_8SYglZMgSLTrACXr0-5Ch8K2oVqnW0\"},{\"kty\":\"oct"
+    "\",\"kid\":\"hmac\",\"k\":\"c2VjcmV0\"},{\"kty\":\"RSA\",\"kid\":\"rsa-3\",\"use\":\"sig\",\"alg\":\"RS256\",\"n\":\"nLQpMLs-vId"
+    "zBNb051V0YCQzjKs3T5gTqyhBs-W_Bc9Ge-x7ra9gDG1N77rajJ8UH0b3oRT1SrHIehSo0xaGiiQHYXptWjAydZ2h_eq1ZwiKruJ"
+    "9cLysCKu--hOn_B_5wR_utE3AghF8Xtmxd_nx7E0wEO7_e_bwaVXct_hJFgkAsOXrXGKnWevTStDMiqyQlncaWStrcQGRQ5JRkPe"
+    "EBQrfCoen20yFhbOG68nMENSxSKKMMoE1SwmohI4yd2S37g7MT9mAphork5WpTeHBYTqo8VLB380dMpR4iHUnoJlZQ-RkQ6J_S1H"
+    "tM5q4npu5KUdsKvdGjKlLxaWdtG_cgw\",\"e\":\"AQAB\"}]}";
+
+inline const std::string kRs256 =
+    "eyJhbGciOiJSUzI1NiIsImtpZCI6InJzYS0xIiwidHlwIjoiSldUIn0.eyJpc3MiOiJodHRwczovL2lzc3Vlci5leGFtcGxlLmNv"
+    "bSIsInN1YiI6IjI0ODI4OTc2MTAwMSIsImF1ZCI6ImNsaWVudC0xMjMiLCJleHAiOjIwMDAwMDAwMDAsImlhdCI6MTcwMDAwMDAw"
+    "MCwibm9uY2UiOiJuLTBTNl9XekEyTWoiLCJlbWFpbCI6ImphbmVAZXhhbXBsZS5jb20iLCJlbWFpbF92ZXJpZmllZCI6dHJ1ZX0."
+    "cT_3o2OGYp0L2dEuKgRjCr0mOYViEYFdy3h_36jO4w63e5uWv7A5wrgHIHUKnDE_vojcnhLV1oRMKaBOlmUOdn581W4tQsxyMmr-"
+    "gTIzpr7ln3XQGRUo8DoBNlfvkaSX1T9W_BuipuBN6w5P5TYrAX4Sulx8jEokqJyyf9S-a1I1oXuy1hLH5ZLmNuUR9FRJ_FWcvapJ"
+    "u9AEXg1p1QIInZ6HRYp0s6HKqFZ4cXNbnmYy1VZmL6uDu8JO9T0yvn3gKW0LJ0XnYkKJVMQ7W2nsiL3JrmtNicrvfnM2QhMSF78u"
+    "_eM1cddsDGO5Ob1Xcnf2nB1h89iiNYNHJDHAq6NrVg";
+
+inline const std::string kEs256 =
+    "eyJhbGciOiJFUzI1NiIsImtpZCI6ImVjLTEiLCJ0eXAiOiJKV1QifQ.eyJpc3MiOiJodHRwczovL2lzc3Vlci5leGFtcGxlLmNvb"
+    "SIsInN1YiI6IjI0ODI4OTc2MTAwMSIsImF1ZCI6ImNsaWVudC0xMjMiLCJleHAiOjIwMDAwMDAwMDAsImlhdCI6MTcwMDAwMDAwM"
+    "Cwibm9uY2UiOiJuLTBTNl9XekEyTWoiLCJlbWFpbCI6ImphbmVAZXhhbXBsZS5jb20iLCJlbWFpbF92ZXJpZmllZCI6dHJ1ZX0.Y"
+    "c11xUM0kgQH-4NGsRBBDn7hv0TFgPjPm8w1pwsvrZP3gV6jwJymsjF3YxWr6tQPCx1PCfPNjrtihifjkCDWFA";
+
+inline const std::string kWrongKey =
+    "eyJhbGciOiJSUzI1NiIsImtpZCI6InJzYS0xIiwidHlwIjoiSldUIn0.eyJpc3MiOiJodHRwczovL2lzc3Vlci5leGFtcGxlLmNv"
+    "bSIsInN1YiI6IjI0ODI4OTc2MTAwMSIsImF1ZCI6ImNsaWVudC0xMjMiLCJleHAiOjIwMDAwMDAwMDAsImlhdCI6MTcwMDAwMDAw"
+    "MCwibm9uY2UiOiJuLTBTNl9XekEyTWoiLCJlbWFpbCI6ImphbmVAZXhhbXBsZS5jb20iLCJlbWFpbF92ZXJpZmllZCI6dHJ1ZX0."
+    "51tg2G4BEVxLneqiAgx0BH6fSfo3AAFjI8ZdtqjednrxUTMdPl0n3N_wKmZeWaQ-eiLGsyt64QnQr-THNzns-YZwBwqBOYCyr5fL"
+    "ei53qmy_bU4pMYgUxfTeXUAMx75LF7fQ7NbB0blGmE7Fw1-WvdbEvcXvDmati8Mfmk4NUXxJpU_cA5bYlYxgLEzxdxvbCs7ZLqsr"
+    "1XwoSQOyyM42A4r4a8HSkyiVQmYEP703QCaVkmzD-pCn3akulFdUyoILLMe_pWZ0Bs2AwYKU2K4VX_tL-KM2_x4CjfkBiMO8SEY-"
+    "IaaO1n82wL8sjvRb4h2YYR34mV2yCBm4Pr8jz1gbFQ";
+
+inline const std::string kMultiAudience =
+    "eyJhbGciOiJSUzI1NiIsImtpZCI6InJzYS0yIn0.eyJpc3MiOiJodHRwczovL2lzc3Vlci5leGFtcGxlLmNvbSIsInN1YiI6IjI0"
+    "ODI4OTc2MTAwMSIsImF1ZCI6WyJjbGllbnQtMTIzIiwib3RoZXItY2xpZW50Il0sImV4cCI6MjAwMDAwMDAwMCwiaWF0IjoxNzAw"
+    "MDAwMDAwLCJub25jZSI6Im4tMFM2X1d6QTJNaiIsImVtYWlsIjoiamFuZUBleGFtcGxlLmNvbSIsImVtYWlsX3ZlcmlmaWVkIjp0"
+    "cnVlLCJhenAiOiJjbGllbnQtMTIzIn0.q0FhjNwAOmkJTI8WAaWL73CIR2UqZ6JYjBePopnosxdqPmZK2m9Nqz6m-U2WsCAvXDan"
+    "D51U3kyx7LF3nHzEMiAOK2eKfenKpZf1UJ4GPigIIkeRlcMVbS9ETn93e8Cm6UjhO0SvTvzu2FOLVCBDXxR8xNb7-awYnt0HDK-G"
+    "PwUoCHf4_oDcSSEir46bm29UVVhrK2H2SLcOB_J_xffITQSgkdqQTE6zCKdzlhzRUaF_CDRPEEFx4yRe0pUEwKyrQkzxcUAidSGM"
+    "Cg136gWjcIwO53jcWLLXv9xHsTXt0XMAXJQc6GQBIl6Mp32RzVxKrrB4MYj7uSpHnVz9VWT_uA";
+
+inline const std::string kTenant =
+    "eyJhbGciOiJFUzI1NiIsImtpZCI6ImVjLTEifQ.eyJpc3MiOiJodHRwczovL2xvZ2luLmV4YW1wbGUuY29tLzkxODgwNDBkLTZjN"
+    "jctNGM1Yi1iMTEyLTM2YTMwNGI2NmRhZC92Mi4wIiwic3ViIjoiMjQ4Mjg5NzYxMDAxIiwiYXVkIjoiY2xpZW50LTEyMyIsImV4c"
+    "CI6MjAwMDAwMDAwMCwiaWF0IjoxNzAwMDAwMDAwLCJub25jZSI6Im4tMFM2X1d6QTJNaiIsImVtYWlsIjoiamFuZUBleGFtcGxlL"
+    "mNvbSIsImVtYWlsX3ZlcmlmaWVkIjp0cnVlLCJ0aWQiOiI5MTg4MDQwZC02YzY3LTRjNWItYjExMi0zNmEzMDRiNjZkYWQifQ.bY"
+    "kff7nFFzDATAStSrcEI-lJyY6Es_rRJe2YAkry0QCaLBXG1nEqv94nEAxLMQpBr9sBcYumAs9GL6_R7W4PKg";
+
+inline const std::string kRotated =
+    "eyJhbGciOiJSUzI1NiIsImtpZCI6InJzYS0zIn0.eyJpc3MiOiJodHRwczovL2lzc3Vlci5leGFtcGxlLmNvbSIsInN1YiI6IjI0"
+    "ODI4OTc2MTAwMSIsImF1ZCI6ImNsaWVudC0xMjMiLCJleHAiOjIwMDAwMDAwMDAsImlhdCI6MTcwMDAwMDAwMCwibm9uY2UiOiJu"
+    "LTBTNl9XekEyTWoiLCJlbWFpbCI6ImphbmVAZXhhbXBsZS5jb20iLCJlbWFpbF92ZXJpZmllZCI6dHJ1ZX0.Vygzew27lofkCLVW"
+    "bd9HzP_PrV0JTS_bZAhPOE1wnkVnOaStGEitNV4AAPK7evnS2MKUDcxpXgJxlLVkyBTmbwel4bdn_gHk6mPTE7NyyNNkGiqOgkTp"
+    "iPNF1HHu5hHh96be-zU4VDb2SBuuC-m_3ClgdLXGWo1yovuokeHQHSYJfbAJ04Ttnyo22vTpUeIA0wB2xc0-i_WK-dLL_zgFXVod"
+    "LDqOvWqc47L1dYQc9ORo-eKYWMnwBCZwFDXIoprR9Mw60radZc_5LA7By8oPqRvTD0fu1jzifVUYBYfSlGZk63nhxazcZs7X3KMM"
+    "1LwaSzQ7H3z5CVCV_nays_taAg";
+
+inline const std::string kUnsigned =
+    "eyJhbGciOiJub25lIn0.eyJpc3MiOiJodHRwczovL2lzc3Vlci5leGFtcGxlLmNvbSIsInN1YiI6IjI0ODI4OTc2MTAwMSIsImF1"
+    "ZCI6ImNsaWVudC0xMjMiLCJleHAiOjIwMDAwMDAwMDAsImlhdCI6MTcwMDAwMDAwMCwibm9uY2UiOiJuLTBTNl9XekEyTWoiLCJl"
+    "bWFpbCI6ImphbmVAZXhhbXBsZS5jb20iLCJlbWFpbF92ZXJpZmllZCI6dHJ1ZX0.";
+
+} // namespace margelo::nitro::NitroAuth::vectors
@@ -0,0 +1,245 @@
+#include <cassert>
+#include <iostream>
+#include <string>
+#include <vector>
+#include "../IdTokenVerifier.hpp"
+#include "../JwsCrypto.hpp"
+#include "IdTokenTestVectors.hpp"
+#include "JwsCryptoTestVectors.hpp"
+
+using namespace margelo::nitro::NitroAuth;
+using namespace margelo::nitro::NitroAuth::vectors;
+
+namespace {
+
+constexpr int64_t kNowMs = 1700000100000;
+
+std::string hex(const Sha256Digest& digest) {
+  static const char* digits = "0123456789abcdef";
+  std::string out;
+  for (uint8_t byte : digest) {
+    out.push_back(digits[byte >> 4]);
+    out.push_back(digits[byte & 0xF]);
+  }
+  return out;
+}
+
+std::string fromHex(const std::string& hex) {
+  std::string out;
+  for (size_t i = 0; i + 1 < hex.size(); i += 2) {
+    out.push_back(static_cast<char>(std::stoi(hex.substr(i, 2), nullptr, 16)));
+  }
+  return out;
+}
+
+OidcMetadata makeMetadata(const std::string& jwks, int64_t fetchedAtMs = 1) {
+  OidcMetadata metadata;
+  metadata.authority = "https://issuer.example.com";
+  metadata.provider.issuer = "https://issuer.example.com";
+  metadata.jwks = jwks;
+  metadata.fetchedAtMs = fetchedAtMs;
+  metadata.expiresAtMs = fetchedAtMs + 60 * 60 * 1000;
+  return metadata;
+}
+
+IdTokenExpectations makeExpectations() {
+  IdTokenExpectations expectations;
+  expectations.issuers = {"https://issuer.example.com"};
+  expectations.audience = "client-123";
+  return expectations;
+}
+
+std::string flipCharacter(std::string token, size_t index) {
+  token[index] = token[index] == 'A' ? 'B' : 'A';
+  return token;
+}
+
+void testDigestAndBase64Url() {
+  assert(hex(JwsCrypto::sha256("")) == "e3b0c44298fc1c149afbf4c8996fb92427ae41e4649b934ca495991b7852b855");
+  assert(hex(JwsCrypto::sha256("abc")) == "ba7816bf8f01cfea414140de5dae2223b00361a396177a9cb410ff61f20015ad");
+  assert(hex(JwsCrypto::sha256("abcdbcdecdefdefgefghfghighijhijkijkljklmklmnlmnomnopnopq")) ==
+         "248d6a61d20638b8e5c026930c3e6039a33ce45964ff2167f6ecedd419db06c1");
+  assert(hex(JwsCrypto::sha256(std::string(1000, 'a'))) ==
+         "41edece42d63e8d9bf515a9ba6932e1c20cbc9f5a5d134645adb5db1b9737ea3");
+
+  assert(JwsCrypto::base64UrlDecode("aGVsbG8") == std::string("hello"));
+  assert(JwsCrypto::base64UrlDecode("aGVsbG8=") == std::string("hello"));
+  assert(JwsCrypto::base64UrlDecode("-_8") == std::string("\xfb\xff"));
+  assert(JwsCrypto::base64UrlDecode("") == std::string());
+  assert(!JwsCrypto::base64UrlDecode("a+b/").has_value());
+  assert(JwsCrypto::base64UrlEncode("hello") == "aGVsbG8");
+  assert(JwsCrypto::base64UrlEncode(std::string("\xfb\xff\xfe")) == "-__-");
+  assert(JwsCrypto::base64UrlEncode("") == "");
+  assert(!JwsCrypto::base64UrlDecode("abcde").has_value());
+}
+
+void testRs256KnownAnswers() {
+  const std::string exponent("\x01\x00\x01", 3);
+  for (const auto& vector : kRs256Vectors) {
+    const bool valid = JwsCrypto::verifyRs256(fromHex(vector.modulus), exponent, JwsCrypto::sha256(vector.message),
+                                              fromHex(vector.signature));
+    if (valid != vector.valid) std::cerr << "RS256 vector failed: " << vector.name << std::endl;
+    assert(valid == vector.valid);
+  }
+}
+
+void testEs256NistVectors() {
+  size_t passing = 0;
+  for (const auto& vector : kEs256Vectors) {
+    const bool valid = JwsCrypto::verifyEs256(fromHex(vector.x), fromHex(vector.y),
+                                              JwsCrypto::sha256(fromHex(vector.message)),
+                                              fromHex(vector.r) + fromHex(vector.s));
+    assert(valid == vector.valid);
+    if (valid) passing++;
+  }
+  assert(kEs256Vectors.size() == 15 && passing > 0);
+}
+
+void testKeySetKeepsSupportedSigningKeys() {
+  auto keys = IdTokenVerifier::parseKeySet(kJwks);
+  assert(keys.size() == 3);
+  assert(keys[0].kid == "rsa-1" && keys[0].kty == "RSA" && keys[0].n.size() == 256);
+  assert(keys[0].e == std::string("\x01\x00\x01", 3));
+  assert(keys[2].kid == "ec-1" && keys[2].kty == "EC" && keys[2].x.size() == 32 && keys[2].y.size() == 32);
+
+  assert(IdTokenVerifier::parseKeySet("{\"keys\":[{\"kty\":\"EC\",\"crv\":\"P-384\",\"x\":\"AA\",\"y\":\"AA\"},"
+                                      "{\"kty\":\"RSA\",\"use\":\"enc\",\"n\":\"AQAB\",\"e\":\"AQAB\"}]}")
+           .empty());
+  assert(IdTokenVerifier::parseKeySet("not json").empty());
+}
+
+void testVerifiesRs256AndEs256() {
+  IdTokenVerifier verifier;
+  const auto metadata = makeMetadata(kJwks);
+  auto expectations = makeExpectations();
+  expectations.nonce = "n-0S6_WzA2Mj";
+
+  for (const auto* token : {&kRs256, &kEs256}) {
+    auto result = verifier.verify(*token, metadata, expectations, kNowMs);
+    assert(result.claims.has_value() && result.error.empty());
+    assert(result.claims->subject == "248289761001");
+    assert(result.claims->email == std::optional<std::string>("jane@example.com"));
+    assert(result.claims->audiences == std::vector<std::string>{"client-123"});
+    assert(result.claims->expiresAtMs == 2000000000000);
+    assert(result.claims->issuedAtMs == std::optional<int64_t>(1700000000000));
+  }
+
+  auto unverified = IdTokenVerifier::decodeUnverified(kTenant);
+  assert(unverified && unverified->tenantId == std::optional<std::string>("9188040d-6c67-4c5b-b112-36a304b66dad"));
+  assert(!IdTokenVerifier::decodeUnverified("garbage").has_value());
+}
+
+void testRejectsForgedAndMalformedTokens() {
+  IdTokenVerifier verifier;
+  const auto metadata = makeMetadata(kJwks);
+  const auto expectations = makeExpectations();
+
+  const size_t payloadStart = kRs256.find('.') + 1;
+  const size_t signatureStart = kRs256.rfind('.') + 1;
+  auto expectFailure = [&](const std::string& token, const std::string& reason) {
+    auto result = verifier.verify(token, metadata, expectations, kNowMs);
+    assert(!result.claims.has_value());
+    assert(result.error == "token_error");
+    assert(result.reason == reason);
+  };
+  expectFailure(flipCharacter(kRs256, payloadStart + 10), "bad_signature");
+  expectFailure(flipCharacter(kRs256, signatureStart + 10), "bad_signature");
+  expectFailure(flipCharacter(kEs256, kEs256.rfind('.') + 5), "bad_signature");
+  expectFailure(kWrongKey, "bad_signature");
+  expectFailure(kUnsigned, "unsupported_algorithm");
+  expectFailure("abc", "malformed");
+  expectFailure("a.b.c.d", "malformed");
+  expectFailure(kRs256.substr(0, signatureStart) + "!!", "malformed");
+}
+
+void testChecksIssuerAudienceTimeAndNonce() {
+  IdTokenVerifier verifier;
+  const auto metadata = makeMetadata(kJwks);
+
+  auto expectations = makeExpectations();
+  expectations.issuers = {"https://other.example.com"};
+  assert(verifier.verify(kRs256, metadata, expectations, kNowMs).reason == "issuer_mismatch");
+
+  expectations = makeExpectations();
+  expectations.audience = "other-client";
+  assert(verifier.verify(kRs256, metadata, expectations, kNowMs).reason == "audience_mismatch");
+  expectations.audience = "";
+  assert(verifier.verify(kRs256, metadata, expectations, kNowMs).reason == "audience_mismatch");
+
+  expectations = makeExpectations();
+  const int64_t expiresAtMs = 2000000000000;
+  assert(verifier.verify(kRs256, metadata, expectations, expiresAtMs + expectations.clockSkewMs).claims.has_value());
+  assert(verifier.verify(kRs256, metadata, expectations, expiresAtMs + expectations.clockSkewMs + 1).reason ==
+         "expired");
+  assert(verifier.verify(kRs256, metadata, expectations, 1700000000000 - expectations.clockSkewMs - 1).reason ==
+         "issued_in_future");
+
+  expectations.nonce = "other-nonce";
+  auto nonce = verifier.verify(kRs256, metadata, expectations, kNowMs);
+  assert(nonce.error == "invalid_nonce" && !nonce.claims.has_value());
+
+  // Several audiences: `azp` must name the expected client.
+  expectations = makeExpectations();
+  assert(verifier.verify(kMultiAudience, metadata, expectations, kNowMs).claims.has_value());
+  expectations.audience = "other-client";
+  assert(verifier.verify(kMultiAudience, metadata, expectations, kNowMs).reason == "authorized_party_mismatch");
+
+  // `{tenantid}` in the expected issuer is resolved from `tid`.
+  expectations = makeExpectations();
+  expectations.issuers = {"https://login.example.com/{tenantid}/v2.0"};
+  assert(verifier.verify(kTenant, metadata, expectations, kNowMs).claims.has_value());
+  assert(verifier.verify(kRs256, metadata, expectations, kNowMs).reason == "issuer_mismatch");
+}
+
+void testUnknownKidAsksForFreshKeys() {
+  IdTokenVerifier verifier;
+  const auto expectations = makeExpectations();
+
+  auto stale = verifier.verify(kRotated, makeMetadata(kJwks, 1), expectations, kNowMs);
+  assert(!stale.claims.has_value() && stale.unknownKey && stale.reason == "unknown_key");
+
+  auto refreshed = verifier.verify(kRotated, makeMetadata(kRotatedJwks, 2), expectations, kNowMs);
+  assert(refreshed.claims.has_value() && !refreshed.unknownKey);
+}
+
+void testMemoizesSignatureChecksPerKeySet() {
+  IdTokenVerifier verifier(1);
+  const auto metadata = makeMetadata(kJwks);
+  const auto expectations = makeExpectations();
+
+  for (int i = 0; i < 3; ++i) assert(verifier.verify(kRs256, metadata, expectations, kNowMs).claims.has_value());
+  auto stats = verifier.stats();
+  assert(stats.verifications == 3 && stats.signatureChecks == 1 && stats.memoHits == 2);
+
+  // Memoized tokens still go through the time and audience checks.
+  assert(verifier.verify(kRs256, metadata, expectations, 2100000000000).reason == "expired");
+  assert(verifier.stats().signatureChecks == 1);
+
+  // Failures are memoized too, so a forged token cannot keep the CPU busy.
+  const auto forged = flipCharacter(kRs256, kRs256.rfind('.') + 3);
+  verifier.verify(forged, metadata, expectations, kNowMs);
+  verifier.verify(forged, metadata, expectations, kNowMs);
+  assert(verifier.stats().signatureChecks == 2);
+
+  // A refetched key set, or eviction by the capacity of one, re-checks the signature.
+  assert(verifier.verify(kRs256, metadata, expectations, kNowMs).claims.has_value());
+  assert(verifier.stats().signatureChecks == 3);
+  assert(verifier.verify(kRs256, makeMetadata(kJwks, 2), expectations, kNowMs).claims.has_value());
+  assert(verifier.stats().signatureChecks == 4);
+}
+
+} // namespace
+
+int main() {
+  testDigestAndBase64Url();
+  testRs256KnownAnswers();
+  testEs256NistVectors();
+  testKeySetKeepsSupportedSigningKeys();
+  testVerifiesRs256AndEs256();
+  testRejectsForgedAndMalformedTokens();
+  testChecksIssuerAudienceTimeAndNonce();
+  testUnknownKidAsksForFreshKeys();
+  testMemoizesSignatureChecksPerKeySet();
+  std::cout << "IdTokenVerifier tests passed!" << std::endl;
+  return 0;
+}
@@ -0,0 +1,111 @@
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <random>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "../JSONSerializer.hpp"
+
+// Feeds arbitrary bytes to the JSON reader and checks that anything it accepts
+// re-serializes to a fixed point, and that arbitrary string contents survive a
+// write/read round trip. Built as a libFuzzer target with -DNITRO_AUTH_LIBFUZZER
+// (`test:cpp:fuzz`); otherwise runs seeded mutations of valid documents.
+
+using namespace margelo::nitro::NitroAuth;
+
+#define FUZZ_CHECK(condition)                                                                 \
+  do {                                                                                        \
+    if (!(condition)) {                                                                       \
+      std::fprintf(stderr, "invariant failed: %s (%s:%d)\n", #condition, __FILE__, __LINE__); \
+      std::abort();                                                                           \
+    }                                                                                         \
+  } while (0)
+
+namespace {
+
+void checkUserFixedPoint(std::string_view input) {
+  auto user = JSONSerializer::deserialize(input);
+  if (!user) return;
+  auto json = JSONSerializer::serialize(*user);
+  auto reparsed = JSONSerializer::deserialize(json);
+  FUZZ_CHECK(reparsed.has_value());
+  FUZZ_CHECK(JSONSerializer::serialize(*reparsed) == json);
+}
+
+void checkTokensFixedPoint(std::string_view input) {
+  auto tokens = JSONSerializer::deserializeTokens(input);
+  if (!tokens) return;
+  auto json = JSONSerializer::serialize(*tokens);
+  auto reparsed = JSONSerializer::deserializeTokens(json);
+  FUZZ_CHECK(reparsed.has_value());
+  FUZZ_CHECK(JSONSerializer::serialize(*reparsed) == json);
+}
+
+void checkStringRoundTrip(std::string_view input) {
+  AuthUser user;
+  user.provider = AuthProvider::APPLE;
+  user.name = std::string(input);
+  user.scopes = std::vector<std::string>{std::string(input.substr(0, input.size() / 2)), std::string(input)};
+  auto parsed = JSONSerializer::deserialize(JSONSerializer::serialize(user));
+  FUZZ_CHECK(parsed.has_value());
+  FUZZ_CHECK(parsed->name == user.name);
+  FUZZ_CHECK(parsed->scopes == user.scopes);
+}
+
+void runInput(const uint8_t* data, size_t size) {
+  std::string_view input(reinterpret_cast<const char*>(data), size);
+  checkUserFixedPoint(input);
+  checkTokensFixedPoint(input);
+  checkStringRoundTrip(input);
+}
+
+} // namespace
+
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t* data, size_t size) {
+  runInput(data, size);
+  return 0;
+}
+
+#ifndef NITRO_AUTH_LIBFUZZER
+int main(int argc, char** argv) {
+  for (int i = 1; i < argc; ++i) {
+    std::ifstream file(argv[i], std::ios::binary);
+    std::string bytes((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+    runInput(reinterpret_cast<const uint8_t*>(bytes.data()), bytes.size());
+  }
+  if (argc > 1) {
+    std::cout << "Replayed " << (argc - 1) << " JSON inputs" << std::endl;
+    return 0;
+  }
+
+  const std::vector<std::string> seeds = {
+    R"({"provider":"google","email":"a@b.c","scopes":["x","y"],"expirationTime":1767225600000})",
+    R"({"provider":"microsoft","name":"José 😀","idToken":"e\"y\\J","extra":{"n":[1,2.5e3,true,null]}})",
+    R"({"accessToken":"t","refreshToken":null,"expirationTime":-0.125})",
+  };
+  const char alphabet[] = "{}[]\",:\\u0123456789abcdefnulltrue-+.eE \t\n\x01\xc3\xa9\xf0\x9f\x98\x80";
+
+  constexpr int kIterations = 20000;
+  std::mt19937 random(2024);
+  for (int iteration = 0; iteration < kIterations; ++iteration) {
+    std::string input = seeds[random() % seeds.size()];
+    const int mutations = 1 + static_cast<int>(random() % 4);
+    for (int m = 0; m < mutations && !input.empty(); ++m) {
+      const size_t position = random() % input.size();
+      const char byte = alphabet[random() % (sizeof(alphabet) - 1)];
+      switch (random() % 3) {
+        case 0: input[position] = byte; break;
+        case 1: input.insert(input.begin() + static_cast<std::ptrdiff_t>(position), byte); break;
+        default: input.erase(position, 1 + random() % 4); break;
+      }
+    }
+    runInput(reinterpret_cast<const uint8_t*>(input.data()), input.size());
+  }
+  std::cout << "JSONSerializer fuzz properties passed (" << kIterations << " inputs)" << std::endl;
+  return 0;
+}
+#endif
@@ -7,6 +7,120 @@
 
 using namespace margelo::nitro::NitroAuth;
 
+namespace {
+
+void testEscapingRoundTrip() {
+    AuthUser user;
+    user.provider = AuthProvider::GOOGLE;
+    user.name = std::string("Quote \" Backslash \\ Slash / Tab \t Line \n\r Bell \x07 End");
+    user.email = std::string(40, 'a') + "\"" + std::string(40, 'b');
+
+    std::string json = JSONSerializer::serialize(user);
+    assert(json.find("\\\"") != std::string::npos);
+    assert(json.find("\\u0007") != std::string::npos);
+    assert(json.find('\n') == std::string::npos);
+
+    auto parsed = JSONSerializer::deserialize(json);
+    assert(parsed.has_value());
+    assert(parsed->name == user.name);
+    assert(parsed->email == user.email);
+}
+
+void testUnicodeEscapes() {
+    auto parsed = JSONSerializer::deserialize(
+        "{\"provider\":\"apple\",\"name\":\"Jos\\u00e9 \\u6771\\u4eac \\ud83d\\ude00\",\"email\":\"caf\xc3\xa9@example.com\"}");
+    assert(parsed.has_value());
+    assert(parsed->name == "Jos\xc3\xa9 \xe6\x9d\xb1\xe4\xba\xac \xf0\x9f\x98\x80");
+    assert(parsed->email == "caf\xc3\xa9@example.com");
+
+    // UTF-8 is written verbatim and survives a round trip.
+    std::string json = JSONSerializer::serialize(*parsed);
+    assert(json.find("\xf0\x9f\x98\x80") != std::string::npos);
+    assert(JSONSerializer::deserialize(json)->name == parsed->name);
+
+    assert(!JSONSerializer::deserialize("{\"provider\":\"apple\",\"name\":\"\\ud83d\"}").has_value());
+    assert(!JSONSerializer::deserialize("{\"provider\":\"apple\",\"name\":\"\\ude00\"}").has_value());
+    assert(!JSONSerializer::deserialize("{\"provider\":\"apple\",\"name\":\"\\u12g4\"}").has_value());
+    assert(!JSONSerializer::deserialize("{\"provider\":\"apple\",\"name\":\"\\x\"}").has_value());
+    assert(!JSONSerializer::deserialize("{\"provider\":\"apple\",\"name\":\"raw\ttab\"}").has_value());
+}
+
+void testAllFieldsAndProviders() {
+    AuthUser user(AuthProvider::MICROSOFT, "ms@example.com", "MS User", "https://example.com/p.png", "id", "access",
+                  "refresh", "server", "auth-code", "user-1", "+15550100", "example.com",
+                  std::vector<std::string>{"openid", "User.Read"}, 1767225600000.0, "none");
+    std::string json = JSONSerializer::serialize(user);
+    assert(json.rfind("{\"provider\":\"microsoft\",", 0) == 0);
+
+    auto parsed = JSONSerializer::deserialize(json);
+    assert(parsed.has_value());
+    assert(parsed->provider == AuthProvider::MICROSOFT);
+    assert(parsed->email == user.email);
+    assert(parsed->name == user.name);
+    assert(parsed->photo == user.photo);
+    assert(parsed->idToken == user.idToken);
+    assert(parsed->accessToken == user.accessToken);
+    assert(parsed->refreshToken == user.refreshToken);
+    assert(parsed->serverAuthCode == user.serverAuthCode);
+    assert(parsed->authorizationCode == user.authorizationCode);
+    assert(parsed->userId == user.userId);
+    assert(parsed->phoneNumber == user.phoneNumber);
+    assert(parsed->hostedDomain == user.hostedDomain);
+    assert(parsed->scopes == user.scopes);
+    assert(parsed->expirationTime == user.expirationTime);
+    assert(parsed->underlyingError == user.underlyingError);
+    assert(JSONSerializer::serialize(*parsed) == json);
+
+    AuthUser minimal;
+    minimal.provider = AuthProvider::GOOGLE;
+    minimal.scopes = std::vector<std::string>{};
+    assert(JSONSerializer::serialize(minimal) == "{\"provider\":\"google\",\"scopes\":[]}");
+}
+
+void testTokensRoundTrip() {
+    AuthTokens tokens("access", "id", std::nullopt, 1767225600123.5);
+    std::string json = JSONSerializer::serialize(tokens);
+    assert(json == "{\"accessToken\":\"access\",\"idToken\":\"id\",\"expirationTime\":1767225600123.5}");
+
+    auto parsed = JSONSerializer::deserializeTokens(json);
+    assert(parsed.has_value());
+    assert(parsed->accessToken == "access");
+    assert(parsed->idToken == "id");
+    assert(!parsed->refreshToken.has_value());
+    assert(parsed->expirationTime == 1767225600123.5);
+
+    assert(JSONSerializer::deserializeTokens("{}").has_value());
+    assert(JSONSerializer::deserializeTokens("{\"expirationTime\":-1.5e3}")->expirationTime == -1500.0);
+    assert(!JSONSerializer::deserializeTokens("{\"expirationTime\":\"soon\"}").has_value());
+    assert(!JSONSerializer::deserializeTokens("{\"expirationTime\":01}").has_value());
+    assert(!JSONSerializer::deserializeTokens("{\"expirationTime\":1.}").has_value());
+    assert(!JSONSerializer::deserializeTokens("{\"expirationTime\":1e999}").has_value());
+    assert(JSONSerializer::serialize(AuthTokens("t", std::nullopt, std::nullopt, 1.0 / 0.0)) == "{\"accessToken\":\"t\"}");
+}
+
+void testLenientStructureStrictValues() {
+    auto parsed = JSONSerializer::deserialize(
+        " {\n \"extra\" : {\"nested\":[1, true, false, null, {\"a\":\"b\"}]},\n"
+        " \"provider\" : \"google\", \"email\" : null, \"scopes\" : [ \"a\" , \"b\" ],\n"
+        " \"sc\\u006fpes\": [\"c\"], \"expirationTime\": 42 } ");
+    assert(parsed.has_value());
+    assert(!parsed->email.has_value());
+    assert(parsed->scopes == std::vector<std::string>({"c"}));
+    assert(parsed->expirationTime == 42.0);
+
+    assert(!JSONSerializer::deserialize("{\"provider\":\"google\"} trailing").has_value());
+    assert(!JSONSerializer::deserialize("{\"provider\":\"google\",}").has_value());
+    assert(!JSONSerializer::deserialize("{\"provider\":\"google\",\"email\":5}").has_value());
+    assert(!JSONSerializer::deserialize("{\"provider\":\"google\",\"scopes\":[1]}").has_value());
+    assert(!JSONSerializer::deserialize("[\"provider\"]").has_value());
+    assert(!JSONSerializer::deserialize("").has_value());
+
+    std::string deep = "{\"provider\":\"google\",\"x\":" + std::string(100, '[') + std::string(100, ']') + "}";
+    assert(!JSONSerializer::deserialize(deep).has_value());
+}
+
+} // namespace
+
 int main() {
     AuthUser user;
     user.provider = AuthProvider::GOOGLE;
@@ -42,19 +156,30 @@ int main() {
     assert(fullDeserialized->idToken == "id-token");
     assert(fullDeserialized->serverAuthCode == "server-code");
 
+    assert(fullDeserialized->scopes == std::vector<std::string>({"email", "profile"}));
+
     auto appleWithoutProvider = JSONSerializer::deserialize("{\"email\":\"apple@example.com\"}");
     assert(appleWithoutProvider.has_value());
     assert(appleWithoutProvider->provider == AuthProvider::APPLE);
     assert(appleWithoutProvider->email == "apple@example.com");
     assert(!appleWithoutProvider->name.has_value());
+    // Re-encoding a legacy user writes the provider it decoded to.
+    assert(JSONSerializer::deserialize(JSONSerializer::serialize(*appleWithoutProvider))->provider == AuthProvider::APPLE);
+    assert(!JSONSerializer::deserialize("{\"provider\":\"github\"}").has_value());
 
+    // No writer ever produced an unterminated string; it is rejected rather than half-read.
     auto missingQuote = JSONSerializer::deserialize("{\"email\":\"broken}");
-    assert(missingQuote.has_value());
-    assert(!missingQuote->email.has_value());
+    assert(!missingQuote.has_value());
 
     auto invalid = JSONSerializer::deserialize("not json");
     assert(!invalid.has_value());
-    
+
+    testEscapingRoundTrip();
+    testUnicodeEscapes();
+    testAllFieldsAndProviders();
+    testTokensRoundTrip();
+    testLenientStructureStrictValues();
+
     std::cout << "JSONSerializer tests passed!" << std::endl;
     return 0;
 }
@@ -0,0 +1,279 @@
+#include <cassert>
+#include <csignal>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <optional>
+#include <string>
+#include <vector>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#include "../JournaledSessionStore.hpp"
+
+using namespace margelo::nitro::NitroAuth;
+
+namespace {
+
+std::string makeDirectory() {
+  char pattern[] = "/tmp/nitro-auth-journal-XXXXXX";
+  const char* directory = ::mkdtemp(pattern);
+  assert(directory != nullptr);
+  return directory;
+}
+
+void removeDirectory(const std::string& directory) {
+  for (const char* name : {"session.snapshot", "session.snapshot.tmp", "session.journal"}) {
+    ::unlink((directory + "/" + name).c_str());
+  }
+  ::rmdir(directory.c_str());
+}
+
+std::string readBytes(const std::string& path) {
+  std::ifstream file(path, std::ios::binary);
+  return std::string((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+}
+
+void writeBytes(const std::string& path, const std::string& bytes) {
+  std::ofstream file(path, std::ios::binary | std::ios::trunc);
+  file << bytes;
+}
+
+AuthUser makeUser(const std::string& accessToken) {
+  AuthUser user;
+  user.provider = AuthProvider::GOOGLE;
+  user.email = "test@example.com";
+  user.name = "Jos\xc3\xa9 \"JD\"";
+  user.scopes = std::vector<std::string>{"openid", "email"};
+  user.accessToken = accessToken;
+  user.refreshToken = "refresh-" + accessToken;
+  user.expirationTime = 1767225600000.0;
+  return user;
+}
+
+AuthTokens makeTokens(const std::string& accessToken) {
+  AuthTokens tokens;
+  tokens.accessToken = accessToken;
+  tokens.expirationTime = 1767229200000.0;
+  return tokens;
+}
+
+JournalOptions optionsFor(const std::string& directory) {
+  JournalOptions options;
+  options.directory = directory;
+  return options;
+}
+
+void testRoundTripAcrossReopen() {
+  const auto directory = makeDirectory();
+  {
+    auto store = JournaledSessionStore::open(optionsFor(directory));
+    assert(!store->load().has_value());
+    store->saveUser(makeUser("first"));
+    store->saveTokens(makeTokens("rotated"));
+    // Visible immediately, before the writer has run.
+    assert(store->load()->accessToken == "rotated");
+    store->flush();
+    assert(store->stats().appendedRecords == 2);
+    assert(store->stats().writeErrors == 0);
+  }
+  {
+    auto store = JournaledSessionStore::open(optionsFor(directory));
+    auto user = store->load();
+    assert(user.has_value());
+    assert(user->accessToken == "rotated");
+    assert(user->refreshToken == "refresh-first");
+    assert(user->expirationTime == 1767229200000.0);
+    assert(user->name == makeUser("x").name);
+    assert(user->scopes == makeUser("x").scopes);
+    assert(store->stats().recoveredRecords == 2);
+    assert(store->stats().discardedTailBytes == 0);
+
+    store->saveUser(std::nullopt);
+    // Token rotation without a session is dropped rather than resurrecting one.
+    store->saveTokens(makeTokens("orphan"));
+    assert(!store->load().has_value());
+  }
+  {
+    auto store = JournaledSessionStore::open(optionsFor(directory));
+    assert(!store->load().has_value());
+  }
+  removeDirectory(directory);
+}
+
+void testCompactionFoldsJournalIntoSnapshot() {
+  const auto directory = makeDirectory();
+  auto options = optionsFor(directory);
+  options.compactAfterRecords = 4;
+  {
+    auto store = JournaledSessionStore::open(options);
+    for (int i = 0; i < 10; ++i) {
+      store->saveUser(makeUser("token-" + std::to_string(i)));
+      store->flush();
+    }
+    assert(store->stats().compactions >= 2);
+  }
+  assert(readBytes(directory + "/session.journal").size() < 4 * 256);
+  assert(!readBytes(directory + "/session.snapshot").empty());
+  {
+    auto store = JournaledSessionStore::open(options);
+    assert(store->load()->accessToken == "token-9");
+  }
+
+  // A crash between the snapshot rename and the journal truncate leaves records
+  // the snapshot already covers; replaying them must not roll the session back.
+  const std::string journalBeforeCompaction = [&]() {
+    auto store = JournaledSessionStore::open(optionsFor(directory));
+    store->saveUser(makeUser("stale"));
+    store->saveUser(makeUser("newest"));
+    store->flush();
+    return readBytes(directory + "/session.journal");
+  }();
+  {
+    auto store = JournaledSessionStore::open(options);
+    for (int i = 0; i < 4; ++i) store->saveUser(makeUser("newest"));
+    store->flush();
+    assert(store->stats().compactions >= 1);
+  }
+  writeBytes(directory + "/session.journal", journalBeforeCompaction);
+  {
+    auto store = JournaledSessionStore::open(options);
+    assert(store->load()->accessToken == "newest");
+    assert(store->stats().recoveredRecords == 0);
+  }
+  removeDirectory(directory);
+}
+
+void testTornAndCorruptTailsAreDiscarded() {
+  const auto directory = makeDirectory();
+  const auto journalPath = directory + "/session.journal";
+  {
+    auto store = JournaledSessionStore::open(optionsFor(directory));
+    store->saveUser(makeUser("kept"));
+    store->flush();
+    store->saveUser(makeUser("torn"));
+    store->flush();
+  }
+  const std::string intact = readBytes(journalPath);
+
+  // Torn write: the last record is cut short.
+  writeBytes(journalPath, intact.substr(0, intact.size() - 7));
+  {
+    auto store = JournaledSessionStore::open(optionsFor(directory));
+    assert(store->load()->accessToken == "kept");
+    assert(store->stats().discardedTailBytes > 0);
+    // The store keeps appending after the truncation point.
+    store->saveUser(makeUser("after-torn"));
+  }
+  {
+    auto store = JournaledSessionStore::open(optionsFor(directory));
+    assert(store->load()->accessToken == "after-torn");
+    assert(store->stats().discardedTailBytes == 0);
+  }
+
+  // Bit rot inside the last record fails its CRC.
+  std::string corrupt = intact;
+  corrupt[corrupt.size() - 3] ^= 0x20;
+  writeBytes(journalPath, corrupt);
+  {
+    auto store = JournaledSessionStore::open(optionsFor(directory));
+    assert(store->load()->accessToken == "kept");
+  }
+
+  // Garbage without a valid header is reset instead of failing to open.
+  writeBytes(journalPath, "not a journal");
+  ::unlink((directory + "/session.snapshot").c_str());
+  {
+    auto store = JournaledSessionStore::open(optionsFor(directory));
+    assert(!store->load().has_value());
+    assert(store->stats().discardedTailBytes == 13);
+  }
+  removeDirectory(directory);
+}
+
+void testOpenFailsWithStorageError() {
+  JournalOptions options;
+  options.directory = "/proc/nitro-auth-not-writable/session";
+  bool threw = false;
+  try {
+    JournaledSessionStore::open(options);
+  } catch (const std::runtime_error& error) {
+    threw = std::string(error.what()) == "storage_error";
+  }
+  assert(threw);
+}
+
+// The child writes sessions as fast as it can and reports every flushed
+// sequence over a pipe; the parent SIGKILLs it at a random point and checks
+// that recovery yields a session at least as new as the last acknowledged one.
+void testCrashInjection() {
+  constexpr int kRounds = 24;
+  constexpr int kWrites = 400;
+  std::srand(7);
+  for (int round = 0; round < kRounds; ++round) {
+    const auto directory = makeDirectory();
+    auto options = optionsFor(directory);
+    options.compactAfterRecords = 8;
+
+    int fds[2];
+    assert(::pipe(fds) == 0);
+    const pid_t child = ::fork();
+    assert(child >= 0);
+    if (child == 0) {
+      ::close(fds[0]);
+      auto store = JournaledSessionStore::open(options);
+      for (int i = 1; i <= kWrites; ++i) {
+        store->saveUser(makeUser("token-" + std::to_string(i)));
+        if (i % 3 == 0) store->saveTokens(makeTokens("token-" + std::to_string(i)));
+        if (i % 5 == 0) {
+          store->flush();
+          if (::write(fds[1], &i, sizeof(i)) != sizeof(i)) ::_exit(2);
+        }
+      }
+      store->flush();
+      ::_exit(0);
+    }
+
+    ::close(fds[1]);
+    ::usleep(static_cast<useconds_t>(std::rand() % 20000));
+    ::kill(child, SIGKILL);
+    int status = 0;
+    ::waitpid(child, &status, 0);
+
+    int acknowledged = 0;
+    int value = 0;
+    while (::read(fds[0], &value, sizeof(value)) == sizeof(value)) acknowledged = value;
+    ::close(fds[0]);
+
+    auto store = JournaledSessionStore::open(options);
+    auto user = store->load();
+    if (acknowledged > 0) {
+      assert(user.has_value());
+      const int recovered = std::stoi(user->accessToken->substr(6));
+      assert(recovered >= acknowledged);
+      assert(recovered <= kWrites);
+      assert(user->refreshToken == "refresh-token-" + std::to_string(recovered));
+    }
+    store->saveUser(makeUser("post-crash"));
+    store->flush();
+    store.reset();
+    assert(JournaledSessionStore::open(options)->load()->accessToken == "post-crash");
+    removeDirectory(directory);
+  }
+}
+
+} // namespace
+
+int main() {
+  testRoundTripAcrossReopen();
+  testCompactionFoldsJournalIntoSnapshot();
+  testTornAndCorruptTailsAreDiscarded();
+  testOpenFailsWithStorageError();
+  testCrashInjection();
+
+  std::cout << "JournaledSessionStore tests passed!" << std::endl;
+  return 0;
+}
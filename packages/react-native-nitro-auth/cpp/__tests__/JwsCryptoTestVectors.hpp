@@ -0,0 +1,360 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+namespace margelo::nitro::NitroAuth::vectors {
+
+// Known answers for the signature primitives, independent of this codebase.
+
+struct Rs256Vector {
+  std::string name;
+  std::string modulus;
+  std::string message;
+  std::string signature;
+  bool valid;
+};
+
+struct Es256Vector {
+  std::string message;
+  std::string x;
+  std::string y;
+  std::string r;
+  std::string s;
+  bool valid;
+};
+
+// RS256: RSASSA-PKCS1-v1_5 / SHA-256, hex. Keys and signatures from OpenSSL 3.0 (e = 65537);
+// the malformed encodings are raw RSA over a hand-built EM, after the Wycheproof cases.
+inline const std::vector<Rs256Vector> kRs256Vectors = {
+    {"valid 2048-bit", "8ee5051f4a7e550140d5bfee3c05cf4b35d063ce441e5109323e4a5d56033dd7aa3382ff36641d05bf6d9de833272bab"
+     "1d2dba9f3cc38e7b6404dc9cf2dbc113e4fc82fcc0c2a94ed5a3287bfe7768d5ff855044a794b51c5086047e8db78a86"
+     "25d5255f5bfb3aae7bdd985f4f5247caac867592d4b6304b3d9ded9d2a0b2b1d137d125602cd2fb736a63f85349285c9"
+     "57a1aa5ba532bb764b0c88fa29111ec213f6868fd1a7bd866c5cc17b931647ba33e14a085a4d931b1a64c67f2580bffd"
+     "147bb6bad49aab211893aa9717cd02063a5b0b11bc1ee54127683a233eadb3d8b9555af3ed883348eb722631bed54f1f"
+     "0fe517daf551cd9670f7c062a72ea3eb",
+     "sample",
+     "61b1c77e9279db102af5a0a39f1f7ef14f9c414c654e4f3cd6f25e2f0afcd66ed76066e389582e23191d8f23fe6d43c1"
+     "6c2371f3eb7e9a3390bdf30da9bfbbefc3dd99962badc090e2282dd60b798af4c17470b3e04a07acb05f480e2513689a"
+     "afd9b480e6cdbfe89e3466a6488a37cb9401a19b71da01e19ce630cac3d3bb186d5b54b27cabf159a5c6ae2955488b5e"
+     "981d6795d159a6ba37626f64fba5aa1525f3fcb17f794e83604b55867338565c17802dddefd17e89a180dabde187a83f"
+     "8cb87de4bcd1378e75bbf6cd72a1612bc636634ee7793a51e1d91b5fcfd37a0f9285a3d577b6797d2d679aca27552b6d"
+     "fb56ad5ff25f3ad9a26c35b24cad1649",
+     true},
+    {"valid 3072-bit", "dc715b316654ed3b07b0ef01df765037adedc6831b6b9490d1dedc3fb12fb21a00616412e92debb0e4d9e22b4786e74e"
+     "3af277021d2a3023e57b910a6254b2e9e45cd2974cb7a3673d9c7bd84b44a8d59ad02e0e5d992f2e5f4c0e521bbd8fb5"
+     "5b2fc9b2759057cdca87f2cdb663cd7d27971a7e1051aa366f083a8d753ddaf6b22872985048256a375210065d472fe2"
+     "194fd3baa9993b8cf134a26c391f7ea2e64b7dc2a823be5fb0fe95847b030d4077efb18a59315e0d1857028ada0e7463"
+     "81b8c4e3e72479ef612b5e626546eb75511944ba64022b56933b9a8cd1e6967eb69938038d3ddc6afddedf991af62c4b"
+     "f6b4274c2b8d8cab564119453e89abc7553a4f79f9917dd89a40c97bdf92413f8a80016bab27e44b3a81b3cc54d3e439"
+     "b5cec7733bb7fd17d3ac939921350373d5144a001676c73409579f9e88a7a68c7fe3154dc9285c078e2b9f4fcbca7d0a"
+     "18247e235721f76d411aeeca7bea243658cf1f22f4f740ec2a84963e427e3139dd69932979b0b8be857f34191f6d8627",
+     "sample",
+     "291265143cd4f23d96695972f06d6bea134d932c48a3402b7bcd47fe6cb41df2c27d89dc197ab070ac33d9398b04df71"
+     "4ddd618d2fdf6cf6873b6d0174ed7862e8a1cfe56c561a5a15872d9221f2f09a7739c516538d4573fa3dd784651d696f"
+     "e2b1fcb496b6324cc22fee2c3727e537cc9b600a690ad374f8646adbb49333847a5f8785f04a189d87d34f21a792e074"
+     "e20a13e34496819cfd8b0ab8fb9e42fc2968831e91dc4a5f30b632de523178da51f7f48dcf2a6c41fe13ef7d7a8087e7"
+     "4eba61f2c9b018e027ff82948eddf21f42d834bb771813c58cd2ed283b2e2c6799e48ca995ff6d7b111009138f310935"
+     "a9eb4aa3eaf88df1128b527baada930d2d7d2c7bdb2199b3a894a871e2f94fb694bdc1421d1ee5064504cad97b7c8bf5"
+     "7a263cac6d4757407a7cdf79ad3e98e1d59cc5a172d6cff9fa0d0178ed5c20c97fbf9682c3c696a148f58a2fe343bcd9"
+     "7e1a516a691eb1ff610b788e7b7bb5960d9810cd91d4cf0e740fc4116cf4fb124ce2a993c0daa4f254da41bc74dd7c5d",
+     true},
+    {"valid 4096-bit", "a4ca8a5ceaf911437ed80b7c4ddc7ee4c1f43cfb3a4c7a78e6d220e27227785915a0566763645d0e9420fa6a324fad02"
+     "ef8b0c15cf88b84fd8f72efb2d2893e95c2bfae102764d483a75a42c2f6b5036509e4e0df4495766f5049f844337e453"
+     "e1e2ffa1a89dc0a16fb8fcbc4f122d3348720522fcb4dfccc1d28ee76331120af6a6acf0eeffcb114ab7b853980a1408"
+     "c1d91bc1e5b859aea751f76a26d515d19a4178651568ba16fefbccb10b2aecd199a9200767326501d8c6d3fd794008d7"
+     "f3710b2a956d4263d50abb64a6e56dae9e60b067fd633eefaa3462d870508ffcb7e1f1244ad4d1ce63a5596943226aee"
+     "bbf182a36af07f80fa4eec023e273cae74c1df36f1613f8a930f333c23c51a2964abd2f6a5470a0a1cd56247205d00e3"
+     "b0e3c83ec6889d21a9920336de9fdc9bdca6c3cf85d55faf8634de6b6cbc3281f631d8c09aa90b939ae4a9548608670f"
+     "79d61513c78f17f2cea606a7b1452d1b481685f88a582483bcae9eadf6e7ee8109f08758b5939625992c1da7fb78c0ef"
+     "be95625fbc4be2b53da8074e353f21210db47200b5f749777401308d2cbe0b14205bb5a81d53558ad85d0a2a408e760d"
+     "39cbf1294f9ece76911de00883caa1fa2dd5f0b8161ec886c691f48887e58d2093d21da7fa5b877766fc1a5c2d5bdee7"
+     "bfe428b796529b9fb5dd4bfcc014bd99f9aaf70eb8b8148b217c27be3d0f6a81",
+     "sample",
+     "63d2a2f31932310acab10ccb2b9de1ffd5c2739f174d1c85fda812129e9210053ac44fef4de90ec255d535a8e8656a19"
+     "a3b292838a4389c1b77ece0344de712b8955450d7df032f1ea63cfb2ee9d641dc52b81056b2f3dcf0a76c956a910791b"
+     "4ed65153e193462c2879986c44e50c825646be8dceb35426a56680a41f1c646cf75b315c5ead888ee0dc9986e98ca63b"
+     "f8ca165525a6e8bbe03b75b48afb4f403496cb5419b19515f3800a9ce2aac9634458b4d47ab9a5c1c0773d27fe204281"
+     "8f83b852472483245f61b00311180a51a5b9246907673437a398b0fd048dbd3a07106e0a0f96986ecf886c87371051a9"
+     "29856b033fa8254ba24bd641a99512bf8c5d2ea33d9b220c2a00e2d9eac523851222f121cf7c1923d1143bc7444b109d"
+     "466aa595a498c07ee084918ea7f55dc99ebe811eda33ffa9ca5bfae8476b25d1706df74612560392f6c50a2ac9ae75a0"
+     "a517689f975095830b9b22edc879590449b933d4b090500734286c54c9b7ed432650ee47bd183ba9d9dbdda9ae2e127e"
+     "59e36e76a37509b2d4c6c6082fcebb091bcced68acab0a0f6d83f6af6230ec049ed2674defa26ebf22b13c80bced96df"
+     "ed4e16e7801483e583e7f55498aff14e0b05871c52734b31d232b2307e9c0288487569c74ea2f56ed088d47a8b5f8908"
+     "1f6f91ac240c268785bd1d4a1eb4568954ea37f3677104fac2dd8daf8435bd58",
+     true},
+    {"other message", "8ee5051f4a7e550140d5bfee3c05cf4b35d063ce441e5109323e4a5d56033dd7aa3382ff36641d05bf6d9de833272bab"
+     "1d2dba9f3cc38e7b6404dc9cf2dbc113e4fc82fcc0c2a94ed5a3287bfe7768d5ff855044a794b51c5086047e8db78a86"
+     "25d5255f5bfb3aae7bdd985f4f5247caac867592d4b6304b3d9ded9d2a0b2b1d137d125602cd2fb736a63f85349285c9"
+     "57a1aa5ba532bb764b0c88fa29111ec213f6868fd1a7bd866c5cc17b931647ba33e14a085a4d931b1a64c67f2580bffd"
+     "147bb6bad49aab211893aa9717cd02063a5b0b11bc1ee54127683a233eadb3d8b9555af3ed883348eb722631bed54f1f"
+     "0fe517daf551cd9670f7c062a72ea3eb",
+     "sample.",
+     "61b1c77e9279db102af5a0a39f1f7ef14f9c414c654e4f3cd6f25e2f0afcd66ed76066e389582e23191d8f23fe6d43c1"
+     "6c2371f3eb7e9a3390bdf30da9bfbbefc3dd99962badc090e2282dd60b798af4c17470b3e04a07acb05f480e2513689a"
+     "afd9b480e6cdbfe89e3466a6488a37cb9401a19b71da01e19ce630cac3d3bb186d5b54b27cabf159a5c6ae2955488b5e"
+     "981d6795d159a6ba37626f64fba5aa1525f3fcb17f794e83604b55867338565c17802dddefd17e89a180dabde187a83f"
+     "8cb87de4bcd1378e75bbf6cd72a1612bc636634ee7793a51e1d91b5fcfd37a0f9285a3d577b6797d2d679aca27552b6d"
+     "fb56ad5ff25f3ad9a26c35b24cad1649",
+     false},
+    {"signature bit flipped", "8ee5051f4a7e550140d5bfee3c05cf4b35d063ce441e5109323e4a5d56033dd7aa3382ff36641d05bf6d9de833272bab"
+     "1d2dba9f3cc38e7b6404dc9cf2dbc113e4fc82fcc0c2a94ed5a3287bfe7768d5ff855044a794b51c5086047e8db78a86"
+     "25d5255f5bfb3aae7bdd985f4f5247caac867592d4b6304b3d9ded9d2a0b2b1d137d125602cd2fb736a63f85349285c9"
+     "57a1aa5ba532bb764b0c88fa29111ec213f6868fd1a7bd866c5cc17b931647ba33e14a085a4d931b1a64c67f2580bffd"
+     "147bb6bad49aab211893aa9717cd02063a5b0b11bc1ee54127683a233eadb3d8b9555af3ed883348eb722631bed54f1f"
+     "0fe517daf551cd9670f7c062a72ea3eb",
+     "sample",
+     "61b1c77e9279db102af5a0a39f1f7ef14f9c414c654e4f3cd6f25e2f0afcd66ed76066e389582e23191d8f23fe6d43c1"
+     "6c2371f3eb7e9a3390bdf30da9bfbbefc3dd99962badc090e2282dd60b798af4c17470b3e04a07acb05f480e2513689a"
+     "afd9b480e7cdbfe89e3466a6488a37cb9401a19b71da01e19ce630cac3d3bb186d5b54b27cabf159a5c6ae2955488b5e"
+     "981d6795d159a6ba37626f64fba5aa1525f3fcb17f794e83604b55867338565c17802dddefd17e89a180dabde187a83f"
+     "8cb87de4bcd1378e75bbf6cd72a1612bc636634ee7793a51e1d91b5fcfd37a0f9285a3d577b6797d2d679aca27552b6d"
+     "fb56ad5ff25f3ad9a26c35b24cad1649",
+     false},
+    {"SHA-1 DigestInfo", "8ee5051f4a7e550140d5bfee3c05cf4b35d063ce441e5109323e4a5d56033dd7aa3382ff36641d05bf6d9de833272bab"
+     "1d2dba9f3cc38e7b6404dc9cf2dbc113e4fc82fcc0c2a94ed5a3287bfe7768d5ff855044a794b51c5086047e8db78a86"
+     "25d5255f5bfb3aae7bdd985f4f5247caac867592d4b6304b3d9ded9d2a0b2b1d137d125602cd2fb736a63f85349285c9"
+     "57a1aa5ba532bb764b0c88fa29111ec213f6868fd1a7bd866c5cc17b931647ba33e14a085a4d931b1a64c67f2580bffd"
+     "147bb6bad49aab211893aa9717cd02063a5b0b11bc1ee54127683a233eadb3d8b9555af3ed883348eb722631bed54f1f"
+     "0fe517daf551cd9670f7c062a72ea3eb",
+     "sample",
+     "65f357803b7e95b7c808590f00bfc32284ca5840c918a3493f94a72a39cb7886eea170a0bcf5474acba6ec235048579d"
+     "2add1dee070429324a93253f3dafbeaf68b7d31792e981ae9a8bbd9bdf57d78565d2bcdde3e3aec0621692c498d03438"
+     "a8126f1d8f793b318ad04a4e3ca3af84ba2007532d612eddb59960a767a5e2b3f41dd67d1c7aaed507bf5246c80960f8"
+     "126a56dac94512f622c6b40c59b31f516819863fe1bcecb2d704509169646ccdcd9fbf0f0aa29170053ad592be479aed"
+     "15f75abceacce3180b2afad366a235d0e293240957d9befd62de3a3e7bebc945de4d8c241b48cf870206d4863bbca290"
+     "37762d3981e18f6157ae4c26f8fc5f00",
+     false},
+    {"block type 2", "8ee5051f4a7e550140d5bfee3c05cf4b35d063ce441e5109323e4a5d56033dd7aa3382ff36641d05bf6d9de833272bab"
+     "1d2dba9f3cc38e7b6404dc9cf2dbc113e4fc82fcc0c2a94ed5a3287bfe7768d5ff855044a794b51c5086047e8db78a86"
+     "25d5255f5bfb3aae7bdd985f4f5247caac867592d4b6304b3d9ded9d2a0b2b1d137d125602cd2fb736a63f85349285c9"
+     "57a1aa5ba532bb764b0c88fa29111ec213f6868fd1a7bd866c5cc17b931647ba33e14a085a4d931b1a64c67f2580bffd"
+     "147bb6bad49aab211893aa9717cd02063a5b0b11bc1ee54127683a233eadb3d8b9555af3ed883348eb722631bed54f1f"
+     "0fe517daf551cd9670f7c062a72ea3eb",
+     "sample",
+     "4fa325b57286e8bd666519846505f7495920fbeebd098b5907888a6a1dcff69e9adfb532d60ed464d098309154bcab18"
+     "bc7a32fbfe6de4992ee36022e370503c9cd4da8ce1d39883ad03aca55d8cb3531ec1fbb832d50c52889c4a9475d25ab8"
+     "dcf5787979b6c2e64d05150a585d64c987f73c97a005c96ff4ac9c4b5a3b874795fcaa984088ec9c4f2d92b53cf5a1f7"
+     "1762bed9c07c69ff13cb1fcb3d4d69066db20eacfd60fc1cc8c486bccb2f92bc6a8208110239dee3bf8ab12c8bc18051"
+     "6200a603113a9ce93e2465007fa6a497608fb8bbc588a99afddade21e7be60b106e78217f42371246e2497e36edcd25c"
+     "dea7654953caa25c3aaabd85adcae448",
+     false},
+    {"padding byte not 0xff", "8ee5051f4a7e550140d5bfee3c05cf4b35d063ce441e5109323e4a5d56033dd7aa3382ff36641d05bf6d9de833272bab"
+     "1d2dba9f3cc38e7b6404dc9cf2dbc113e4fc82fcc0c2a94ed5a3287bfe7768d5ff855044a794b51c5086047e8db78a86"
+     "25d5255f5bfb3aae7bdd985f4f5247caac867592d4b6304b3d9ded9d2a0b2b1d137d125602cd2fb736a63f85349285c9"
+     "57a1aa5ba532bb764b0c88fa29111ec213f6868fd1a7bd866c5cc17b931647ba33e14a085a4d931b1a64c67f2580bffd"
+     "147bb6bad49aab211893aa9717cd02063a5b0b11bc1ee54127683a233eadb3d8b9555af3ed883348eb722631bed54f1f"
+     "0fe517daf551cd9670f7c062a72ea3eb",
+     "sample",
+     "4c90a8fe1d7e4267fb82e61c6833aaec5fafd53492346ac9bc7dfd9f26f0f06fc3edc857289f6a01846e9a97028473b0"
+     "cdb5a41632912047d97c844f942364b867b75e23542831f362c0482a114c64789b7487795b4ff016ff6b360d1860b14a"
+     "f7cdec68383613f4f1864092d36550f1b0ec1c335888aadc30da4c031c1baf6c90c798db2b776e080242f14e73d9868c"
+     "c1c232467c370c7517421c0f4d405eb6cd45016cbb60e257b832d81a1aaecbdc372578f0a1c91905afe9b7c5e936642f"
+     "beb956a5f62a4d40da58c57d86eea2374bfa0f58173c8196d5f771a8f82da064259fa3a23cf7693ecef1d6fa87ba1730"
+     "b9ae556907665264f60bac3807eee0a1",
+     false},
+    {"DigestInfo without NULL parameters", "8ee5051f4a7e550140d5bfee3c05cf4b35d063ce441e5109323e4a5d56033dd7aa3382ff36641d05bf6d9de833272bab"
+     "1d2dba9f3cc38e7b6404dc9cf2dbc113e4fc82fcc0c2a94ed5a3287bfe7768d5ff855044a794b51c5086047e8db78a86"
+     "25d5255f5bfb3aae7bdd985f4f5247caac867592d4b6304b3d9ded9d2a0b2b1d137d125602cd2fb736a63f85349285c9"
+     "57a1aa5ba532bb764b0c88fa29111ec213f6868fd1a7bd866c5cc17b931647ba33e14a085a4d931b1a64c67f2580bffd"
+     "147bb6bad49aab211893aa9717cd02063a5b0b11bc1ee54127683a233eadb3d8b9555af3ed883348eb722631bed54f1f"
+     "0fe517daf551cd9670f7c062a72ea3eb",
+     "sample",
+     "5f2697438eaae260453bc525471808cfa88d2c4064e82b01f76352d2b86ebdda998b95726eac4528e3846b618c135782"
+     "c3e077fabaa3e6d87a7988d1eb067ea95f85a13af1a8eac38c46206396b4d976757a03538bad4025c8bd193fb44c7e5b"
+     "98416399d4831a7f9993b6e473e5bf19d7873cd0446718a5912d38b11d8623b454d39769bc3e5d1317ddae5cbb7ae3b4"
+     "127da157d8835011a7430036392cced874b05692c16692902bd4368bac6ca22f46b0707cc314af0c8c5e97f5eefaf2c5"
+     "4dd8197985526fc4d4406ab44bb3fc190bef617e6cee957fbdd2e1785b6e2b945fe9fd6383535fcf07f57ab4a9f8e277"
+     "b3860050de820714ba98601cade8af4e",
+     false},
+    {"trailing garbage after hash", "8ee5051f4a7e550140d5bfee3c05cf4b35d063ce441e5109323e4a5d56033dd7aa3382ff36641d05bf6d9de833272bab"
+     "1d2dba9f3cc38e7b6404dc9cf2dbc113e4fc82fcc0c2a94ed5a3287bfe7768d5ff855044a794b51c5086047e8db78a86"
+     "25d5255f5bfb3aae7bdd985f4f5247caac867592d4b6304b3d9ded9d2a0b2b1d137d125602cd2fb736a63f85349285c9"
+     "57a1aa5ba532bb764b0c88fa29111ec213f6868fd1a7bd866c5cc17b931647ba33e14a085a4d931b1a64c67f2580bffd"
+     "147bb6bad49aab211893aa9717cd02063a5b0b11bc1ee54127683a233eadb3d8b9555af3ed883348eb722631bed54f1f"
+     "0fe517daf551cd9670f7c062a72ea3eb",
+     "sample",
+     "82f806cf910f7e87e0fcfb3ea2a5c9b28887cd2d371fdffbe27fa27dcc3da7de4ff9257da71a9fa34f0a4aaaee778c11"
+     "24622d47f4c8986e65457304c077a5163d376c6b6ae56c55201ea0dee621f042d49022759d7efcf4367758ec697a5636"
+     "4a960b592d9ed047a944f69e6cfd80cca1e58a90e323e9c9f8bfed3a0eeb841aeb3f75b5f11cbc66849bfdc4d54e10f7"
+     "39d1646693e2e1d95490717a04b2695355e9d9fc62a3612b739b4cd0d45faf94d449ae037f0963fd0966c3d73baba729"
+     "b4f55347fb9bfdefce57c6f74b28cf2a13d77f3e75d59a7b43df0edd972483ad3934105634709537af75dc6af169adb5"
+     "822f698f755141a23e71b85ca7c7754e",
+     false},
+    {"EM shorter than the modulus", "8ee5051f4a7e550140d5bfee3c05cf4b35d063ce441e5109323e4a5d56033dd7aa3382ff36641d05bf6d9de833272bab"
+     "1d2dba9f3cc38e7b6404dc9cf2dbc113e4fc82fcc0c2a94ed5a3287bfe7768d5ff855044a794b51c5086047e8db78a86"
+     "25d5255f5bfb3aae7bdd985f4f5247caac867592d4b6304b3d9ded9d2a0b2b1d137d125602cd2fb736a63f85349285c9"
+     "57a1aa5ba532bb764b0c88fa29111ec213f6868fd1a7bd866c5cc17b931647ba33e14a085a4d931b1a64c67f2580bffd"
+     "147bb6bad49aab211893aa9717cd02063a5b0b11bc1ee54127683a233eadb3d8b9555af3ed883348eb722631bed54f1f"
+     "0fe517daf551cd9670f7c062a72ea3eb",
+     "sample",
+     "601be11f4504140cee8e9e0265fa0d8dd2019b53d5db32ae13dde8da2927a356898f2c9c8a175bba22365193e50fd167"
+     "62ad7506923c5313bcc0560975453ba71bff33c3fa1ecb096b2798b9adccecddfa1926e2c17b31e6fdfb594b9102f7dc"
+     "d72921d2e59c81db3f51d719d656f81b4523b4986d64a30698e2980963660c4769f183d63f5913534aa4c0db235c2e1b"
+     "b320655f09823ea2d00ea48cdbf33411ae1613ed8fb6e6590f36c1e8dc6dac802b1a361556af8b000b58025890937649"
+     "6b7269660637aee3a0ed666e328e8ebd848eb52bd9f063a13ef19a383efbfce5a704af804f02e24c16de027df665956c"
+     "eb812b2ccc68a3cce595defa5cd54233",
+     false},
+    {"signature equal to modulus", "8ee5051f4a7e550140d5bfee3c05cf4b35d063ce441e5109323e4a5d56033dd7aa3382ff36641d05bf6d9de833272bab"
+     "1d2dba9f3cc38e7b6404dc9cf2dbc113e4fc82fcc0c2a94ed5a3287bfe7768d5ff855044a794b51c5086047e8db78a86"
+     "25d5255f5bfb3aae7bdd985f4f5247caac867592d4b6304b3d9ded9d2a0b2b1d137d125602cd2fb736a63f85349285c9"
+     "57a1aa5ba532bb764b0c88fa29111ec213f6868fd1a7bd866c5cc17b931647ba33e14a085a4d931b1a64c67f2580bffd"
+     "147bb6bad49aab211893aa9717cd02063a5b0b11bc1ee54127683a233eadb3d8b9555af3ed883348eb722631bed54f1f"
+     "0fe517daf551cd9670f7c062a72ea3eb",
+     "sample",
+     "8ee5051f4a7e550140d5bfee3c05cf4b35d063ce441e5109323e4a5d56033dd7aa3382ff36641d05bf6d9de833272bab"
+     "1d2dba9f3cc38e7b6404dc9cf2dbc113e4fc82fcc0c2a94ed5a3287bfe7768d5ff855044a794b51c5086047e8db78a86"
+     "25d5255f5bfb3aae7bdd985f4f5247caac867592d4b6304b3d9ded9d2a0b2b1d137d125602cd2fb736a63f85349285c9"
+     "57a1aa5ba532bb764b0c88fa29111ec213f6868fd1a7bd866c5cc17b931647ba33e14a085a4d931b1a64c67f2580bffd"
+     "147bb6bad49aab211893aa9717cd02063a5b0b11bc1ee54127683a233eadb3d8b9555af3ed883348eb722631bed54f1f"
+     "0fe517daf551cd9670f7c062a72ea3eb",
+     false},
+    {"signature zero", "8ee5051f4a7e550140d5bfee3c05cf4b35d063ce441e5109323e4a5d56033dd7aa3382ff36641d05bf6d9de833272bab"
+     "1d2dba9f3cc38e7b6404dc9cf2dbc113e4fc82fcc0c2a94ed5a3287bfe7768d5ff855044a794b51c5086047e8db78a86"
+     "25d5255f5bfb3aae7bdd985f4f5247caac867592d4b6304b3d9ded9d2a0b2b1d137d125602cd2fb736a63f85349285c9"
+     "57a1aa5ba532bb764b0c88fa29111ec213f6868fd1a7bd866c5cc17b931647ba33e14a085a4d931b1a64c67f2580bffd"
+     "147bb6bad49aab211893aa9717cd02063a5b0b11bc1ee54127683a233eadb3d8b9555af3ed883348eb722631bed54f1f"
+     "0fe517daf551cd9670f7c062a72ea3eb",
+     "sample",
+     "000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000"
+     "000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000"
+     "000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000"
+     "000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000"
+     "000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000"
+     "00000000000000000000000000000000",
+     false},
+    {"1024-bit modulus", "ba862d9e708d2a08cb3727503038715c5e85a1541de83f8685c95ff7d2b9407b66e6b83103c0b75a47db4bd09b0370ed"
+     "3ad57c56259b22e436d06cf9ff0b1334e084b492e7cd07efb6a4449fc657cf7338de7a9ce4c17bee5974e23ab0969182"
+     "9aa08ba5bf141a7ec39d9e3a94d5903e77520795669cf45c3824e13c345f4e21",
+     "sample",
+     "9d2c165a63e2342f1e127cfd2655e1c84a19e7fabf2efaea2db9615f10b9dcdf233e387de59e9876349a60684660e860"
+     "5a5fb7b3265c2bd86492e88fe5e34444e1f4e343879b3aeaf2672930e5ead49aa927735902aeb3c6f62c840d09076356"
+     "e8f7d3f89e2fe850350e98a8805fd14e1eef2e9182376eee1fd02137e54c0615",
+     false},
+};
+
+// ES256: NIST CAVS 11.0 ECDSA SigVer, [P-256,SHA-256], hex. `Msg` is hashed with SHA-256.
+inline const std::vector<Es256Vector> kEs256Vectors = {
+    {"e4796db5f785f207aa30d311693b3702821dff1168fd2e04c0836825aefd850d9aa60326d88cde1a23c7745351392ca2"
+     "288d632c264f197d05cd424a30336c19fd09bb229654f0222fcb881a4b35c290a093ac159ce13409111ff0358411133c"
+     "24f5b8e2090d6db6558afc36f06ca1f6ef779785adba68db27a409859fc4c4a0",
+     "87f8f2b218f49845f6f10eec3877136269f5c1a54736dbdf69f89940cad41555",
+     "e15f369036f49842fac7a86c8a2b0557609776814448b8f5e84aa9f4395205e9",
+     "d19ff48b324915576416097d2544f7cbdf8768b1454ad20e0baac50e211f23b0",
+     "a3e81e59311cdfff2d4784949f7a2cb50ba6c3a91fa54710568e61aca3e847c6",
+     false}, // F (3 - S changed)
+    {"069a6e6b93dfee6df6ef6997cd80dd2182c36653cef10c655d524585655462d683877f95ecc6d6c81623d8fac4e900ed"
+     "0019964094e7de91f1481989ae1873004565789cbf5dc56c62aedc63f62f3b894c9c6f7788c8ecaadc9bd0e81ad91b2b"
+     "3569ea12260e93924fdddd3972af5273198f5efda0746219475017557616170e",
+     "5cf02a00d205bdfee2016f7421807fc38ae69e6b7ccd064ee689fc1a94a9f7d2",
+     "ec530ce3cc5c9d1af463f264d685afe2b4db4b5828d7e61b748930f3ce622a85",
+     "dc23d130c6117fb5751201455e99f36f59aba1a6a21cf2d0e7481a97451d6693",
+     "d6ce7708c18dbf35d4f8aa7240922dc6823f2e7058cbc1484fcad1599db5018c",
+     false}, // F (2 - R changed)
+    {"df04a346cf4d0e331a6db78cca2d456d31b0a000aa51441defdb97bbeb20b94d8d746429a393ba88840d661615e07def"
+     "615a342abedfa4ce912e562af714959896858af817317a840dcff85a057bb91a3c2bf90105500362754a6dd321cdd861"
+     "28cfc5f04667b57aa78c112411e42da304f1012d48cd6a7052d7de44ebcc01de",
+     "2ddfd145767883ffbb0ac003ab4a44346d08fa2570b3120dcce94562422244cb",
+     "5f70c7d11ac2b7a435ccfbbae02c3df1ea6b532cc0e9db74f93fffca7c6f9a64",
+     "9913111cff6f20c5bf453a99cd2c2019a4e749a49724a08774d14e4c113edda8",
+     "9467cd4cd21ecb56b0cab0a9a453b43386845459127a952421f5c6382866c5cc",
+     false}, // F (4 - Q changed)
+    {"e1130af6a38ccb412a9c8d13e15dbfc9e69a16385af3c3f1e5da954fd5e7c45fd75e2b8c36699228e92840c0562fbf37"
+     "72f07e17f1add56588dd45f7450e1217ad239922dd9c32695dc71ff2424ca0dec1321aa47064a044b7fe3c2b97d03ce4"
+     "70a592304c5ef21eed9f93da56bb232d1eeb0035f9bf0dfafdcc4606272b20a3",
+     "e424dc61d4bb3cb7ef4344a7f8957a0c5134e16f7a67c074f82e6e12f49abf3c",
+     "970eed7aa2bc48651545949de1dddaf0127e5965ac85d1243d6f60e7dfaee927",
+     "bf96b99aa49c705c910be33142017c642ff540c76349b9dab72f981fd9347f4f",
+     "17c55095819089c2e03b9cd415abdf12444e323075d98f31920b9e0f57ec871c",
+     true}, // P (0 )
+    {"73c5f6a67456ae48209b5f85d1e7de7758bf235300c6ae2bdceb1dcb27a7730fb68c950b7fcada0ecc4661d3578230f2"
+     "25a875e69aaa17f1e71c6be5c831f22663bac63d0c7a9635edb0043ff8c6f26470f02a7bc56556f1437f06dfa27b487a"
+     "6c4290d8bad38d4879b334e341ba092dde4e4ae694a9c09302e2dbf443581c08",
+     "e0fc6a6f50e1c57475673ee54e3a57f9a49f3328e743bf52f335e3eeaa3d2864",
+     "7f59d689c91e463607d9194d99faf316e25432870816dde63f5d4b373f12f22a",
+     "1d75830cd36f4c9aa181b2c4221e87f176b7f05b7c87824e82e396c88315c407",
+     "cb2acb01dac96efc53a32d4a0d85d0c2e48955214783ecf50a4f0414a319c05a",
+     true}, // P (0 )
+    {"666036d9b4a2426ed6585a4e0fd931a8761451d29ab04bd7dc6d0c5b9e38e6c2b263ff6cb837bd04399de3d757c6c700"
+     "5f6d7a987063cf6d7e8cb38a4bf0d74a282572bd01d0f41e3fd066e3021575f0fa04f27b700d5b7ddddf50965993c3f9"
+     "c7118ed78888da7cb221849b3260592b8e632d7c51e935a0ceae15207bedd548",
+     "a849bef575cac3c6920fbce675c3b787136209f855de19ffe2e8d29b31a5ad86",
+     "bf5fe4f7858f9b805bd8dcc05ad5e7fb889de2f822f3d8b41694e6c55c16b471",
+     "25acc3aa9d9e84c7abf08f73fa4195acc506491d6fc37cb9074528a7db87b9d6",
+     "9b21d5b5259ed3f2ef07dfec6cc90d3a37855d1ce122a85ba6a333f307d31537",
+     false}, // F (2 - R changed)
+    {"7e80436bce57339ce8da1b5660149a20240b146d108deef3ec5da4ae256f8f894edcbbc57b34ce37089c0daa17f0c46c"
+     "d82b5a1599314fd79d2fd2f446bd5a25b8e32fcf05b76d644573a6df4ad1dfea707b479d97237a346f1ec632ea5660ef"
+     "b57e8717a8628d7f82af50a4e84b11f21bdff6839196a880ae20b2a0918d58cd",
+     "3dfb6f40f2471b29b77fdccba72d37c21bba019efa40c1c8f91ec405d7dcc5df",
+     "f22f953f1e395a52ead7f3ae3fc47451b438117b1e04d613bc8555b7d6e6d1bb",
+     "548886278e5ec26bed811dbb72db1e154b6f17be70deb1b210107decb1ec2a5a",
+     "e93bfebd2f14f3d827ca32b464be6e69187f5edbd52def4f96599c37d58eee75",
+     false}, // F (4 - Q changed)
+    {"1669bfb657fdc62c3ddd63269787fc1c969f1850fb04c933dda063ef74a56ce13e3a649700820f0061efabf849a85d47"
+     "4326c8a541d99830eea8131eaea584f22d88c353965dabcdc4bf6b55949fd529507dfb803ab6b480cd73ca0ba00ca19c"
+     "438849e2cea262a1c57d8f81cd257fb58e19dec7904da97d8386e87b84948169",
+     "69b7667056e1e11d6caf6e45643f8b21e7a4bebda463c7fdbc13bc98efbd0214",
+     "d3f9b12eb46c7c6fda0da3fc85bc1fd831557f9abc902a3be3cb3e8be7d1aa2f",
+     "288f7a1cd391842cce21f00e6f15471c04dc182fe4b14d92dc18910879799790",
+     "247b3c4e89a3bcadfea73c7bfd361def43715fa382b8c3edf4ae15d6e55e9979",
+     false}, // F (1 - Message changed)
+    {"3fe60dd9ad6caccf5a6f583b3ae65953563446c4510b70da115ffaa0ba04c076115c7043ab8733403cd69c7d14c212c6"
+     "55c07b43a7c71b9a4cffe22c2684788ec6870dc2013f269172c822256f9e7cc674791bf2d8486c0f5684283e1649576e"
+     "fc982ede17c7b74b214754d70402fb4bb45ad086cf2cf76b3d63f7fce39ac970",
+     "bf02cbcf6d8cc26e91766d8af0b164fc5968535e84c158eb3bc4e2d79c3cc682",
+     "069ba6cb06b49d60812066afa16ecf7b51352f2c03bd93ec220822b1f3dfba03",
+     "f5acb06c59c2b4927fb852faa07faf4b1852bbb5d06840935e849c4d293d1bad",
+     "049dab79c89cc02f1484c437f523e080a75f134917fda752f2d5ca397addfe5d",
+     false}, // F (3 - S changed)
+    {"983a71b9994d95e876d84d28946a041f8f0a3f544cfcc055496580f1dfd4e312a2ad418fe69dbc61db230cc0c0ed97e3"
+     "60abab7d6ff4b81ee970a7e97466acfd9644f828ffec538abc383d0e92326d1c88c55e1f46a668a039beaa1be631a891"
+     "29938c00a81a3ae46d4aecbf9707f764dbaccea3ef7665e4c4307fa0b0a3075c",
+     "224a4d65b958f6d6afb2904863efd2a734b31798884801fcab5a590f4d6da9de",
+     "178d51fddada62806f097aa615d33b8f2404e6b1479f5fd4859d595734d6d2b9",
+     "87b93ee2fecfda54deb8dff8e426f3c72c8864991f8ec2b3205bb3b416de93d2",
+     "4044a24df85be0cc76f21a4430b75b8e77b932a87f51e4eccbc45c263ebf8f66",
+     false}, // F (2 - R changed)
+    {"4a8c071ac4fd0d52faa407b0fe5dab759f7394a5832127f2a3498f34aac287339e043b4ffa79528faf199dc917f7b066"
+     "ad65505dab0e11e6948515052ce20cfdb892ffb8aa9bf3f1aa5be30a5bbe85823bddf70b39fd7ebd4a93a2f75472c1d4"
+     "f606247a9821f1a8c45a6cb80545de2e0c6c0174e2392088c754e9c8443eb5af",
+     "43691c7795a57ead8c5c68536fe934538d46f12889680a9cb6d055a066228369",
+     "f8790110b3c3b281aa1eae037d4f1234aff587d903d93ba3af225c27ddc9ccac",
+     "8acd62e8c262fa50dd9840480969f4ef70f218ebf8ef9584f199031132c6b1ce",
+     "cfca7ed3d4347fb2a29e526b43c348ae1ce6c60d44f3191b6d8ea3a2d9c92154",
+     false}, // F (3 - S changed)
+    {"0a3a12c3084c865daf1d302c78215d39bfe0b8bf28272b3c0b74beb4b7409db0718239de700785581514321c6440a4bb"
+     "aea4c76fa47401e151e68cb6c29017f0bce4631290af5ea5e2bf3ed742ae110b04ade83a5dbd7358f29a85938e23d87a"
+     "c8233072b79c94670ff0959f9c7f4517862ff829452096c78f5f2e9a7e4e9216",
+     "9157dbfcf8cf385f5bb1568ad5c6e2a8652ba6dfc63bc1753edf5268cb7eb596",
+     "972570f4313d47fc96f7c02d5594d77d46f91e949808825b3d31f029e8296405",
+     "dfaea6f297fa320b707866125c2a7d5d515b51a503bee817de9faa343cc48eeb",
+     "8f780ad713f9c3e5a4f7fa4c519833dfefc6a7432389b1e4af463961f09764f2",
+     false}, // F (1 - Message changed)
+    {"785d07a3c54f63dca11f5d1a5f496ee2c2f9288e55007e666c78b007d95cc28581dce51f490b30fa73dc9e2d45d075d7"
+     "e3a95fb8a9e1465ad191904124160b7c60fa720ef4ef1c5d2998f40570ae2a870ef3e894c2bc617d8a1dc85c3c557749"
+     "28c38789b4e661349d3f84d2441a3b856a76949b9f1f80bc161648a1cad5588e",
+     "072b10c081a4c1713a294f248aef850e297991aca47fa96a7470abe3b8acfdda",
+     "9581145cca04a0fb94cedce752c8f0370861916d2a94e7c647c5373ce6a4c8f5",
+     "09f5483eccec80f9d104815a1be9cc1a8e5b12b6eb482a65c6907b7480cf4f19",
+     "a4f90e560c5e4eb8696cb276e5165b6a9d486345dedfb094a76e8442d026378d",
+     false}, // F (4 - Q changed)
+    {"76f987ec5448dd72219bd30bf6b66b0775c80b394851a43ff1f537f140a6e7229ef8cd72ad58b1d2d20298539d6347dd"
+     "5598812bc65323aceaf05228f738b5ad3e8d9fe4100fd767c2f098c77cb99c2992843ba3eed91d32444f3b6db6cd212d"
+     "d4e5609548f4bb62812a920f6e2bf1581be1ebeebdd06ec4e971862cc42055ca",
+     "09308ea5bfad6e5adf408634b3d5ce9240d35442f7fe116452aaec0d25be8c24",
+     "f40c93e023ef494b1c3079b2d10ef67f3170740495ce2cc57f8ee4b0618b8ee5",
+     "5cc8aa7c35743ec0c23dde88dabd5e4fcd0192d2116f6926fef788cddb754e73",
+     "9c9c045ebaa1b828c32f82ace0d18daebf5e156eb7cbfdc1eff4399a8a900ae7",
+     false}, // F (1 - Message changed)
+    {"60cd64b2cd2be6c33859b94875120361a24085f3765cb8b2bf11e026fa9d8855dbe435acf7882e84f3c7857f96e2baab"
+     "4d9afe4588e4a82e17a78827bfdb5ddbd1c211fbc2e6d884cddd7cb9d90d5bf4a7311b83f352508033812c776a0e00c0"
+     "03c7e0d628e50736c7512df0acfa9f2320bd102229f46495ae6d0857cc452a84",
+     "2d98ea01f754d34bbc3003df5050200abf445ec728556d7ed7d5c54c55552b6d",
+     "9b52672742d637a32add056dfd6d8792f2a33c2e69dafabea09b960bc61e230a",
+     "06108e525f845d0155bf60193222b3219c98e3d49424c2fb2a0987f825c17959",
+     "62b5cdd591e5b507e560167ba8f6f7cda74673eb315680cb89ccbc4eec477dce",
+     true}, // P (0 )
+};
+
+} // namespace margelo::nitro::NitroAuth::vectors
@@ -0,0 +1,222 @@
+#include <cassert>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+#include "../HybridAuth.hpp"
+#include "../PlatformAuth.hpp"
+#include "LoopbackOAuthServer.hpp"
+#include "PlatformAuth+Linux.hpp"
+
+using namespace margelo::nitro::NitroAuth;
+
+namespace margelo::nitro::NitroAuth {
+
+void HybridAuthSpec::loadHybridMethods() {}
+
+} // namespace margelo::nitro::NitroAuth
+
+namespace {
+
+std::string errorMessage(const std::exception_ptr& error) {
+  try {
+    std::rethrow_exception(error);
+  } catch (const std::exception& e) {
+    return e.what();
+  }
+}
+
+std::string cacheDirectory;
+
+// Requests are synchronous, but one may join the metadata prefetch HybridAuth
+// starts on its timer thread and settle there.
+template <typename P>
+std::shared_ptr<P> settled(std::shared_ptr<P> promise) {
+  const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+  while (promise->isPending() && std::chrono::steady_clock::now() < deadline) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+  return promise;
+}
+
+std::shared_ptr<LoopbackOAuthServer> startServer(LoopbackOAuthServerOptions options = {}) {
+  auto server = LoopbackOAuthServer::start(std::move(options));
+  LinuxPlatformConfig config;
+  config.issuer = server->issuer();
+  config.cacheDirectory = cacheDirectory;
+  LinuxPlatformAuth::configure(config);
+  return server;
+}
+
+// The refresh token the platform holds for the signed-in user.
+std::string platformRefreshToken() {
+  auto restore = PlatformAuth::silentRestore();
+  assert(restore->isResolved() && restore->getResult().ok() && restore->getResult().value().has_value());
+  return restore->getResult().value()->refreshToken.value_or("");
+}
+
+void testLoginVerifiesTheSignedIdToken() {
+  auto server = startServer();
+  auto auth = std::make_shared<HybridAuth>();
+
+  auto login = settled(auth->login(AuthProvider::GOOGLE, std::nullopt));
+  assert(login->isResolved());
+  auto user = auth->getCurrentUser();
+  assert(user && user->provider == AuthProvider::GOOGLE);
+  assert(user->email == "user@example.com");
+  assert(user->name == "Loopback User");
+  assert(user->accessToken && server->isAccessTokenActive(*user->accessToken));
+  assert(server->stats().authorizations == 1);
+  assert(server->stats().codeExchanges == 1);
+
+  // The same session comes back from the platform after a restart of the core.
+  auto restored = std::make_shared<HybridAuth>();
+  auto restore = settled(restored->silentRestore());
+  assert(restore->isResolved());
+  assert(restored->getCurrentUser()->email == "user@example.com");
+  server->stop();
+}
+
+void testRefreshRotatesAndDetectsReuse() {
+  auto server = startServer();
+  auto auth = std::make_shared<HybridAuth>();
+  assert(settled(auth->login(AuthProvider::GOOGLE, std::nullopt))->isResolved());
+  const std::string first = platformRefreshToken();
+  assert(server->isRefreshTokenActive(first));
+
+  auto refresh = settled(auth->refreshToken());
+  assert(refresh->isResolved());
+  const std::string second = platformRefreshToken();
+  assert(second != first);
+  assert(!server->isRefreshTokenActive(first));
+  assert(server->isRefreshTokenActive(second));
+  assert(auth->getCurrentUser()->accessToken == refresh->getResult().accessToken);
+
+  // A replayed refresh token revokes the whole grant, rotations included.
+  HttpRequest replay;
+  replay.method = "POST";
+  replay.url = server->issuer() + "/token";
+  replay.headers.emplace_back("Content-Type", "application/x-www-form-urlencoded");
+  replay.body = OidcClient::formEncode({
+      {"grant_type", "refresh_token"},
+      {"refresh_token", first},
+      {"client_id", server->options().clientId},
+  });
+  int status = 0;
+  PlatformAuth::httpClient()->send(replay, [&status](HttpResponse response) { status = response.status; });
+  assert(status == 400);
+  assert(server->stats().reuseDetections == 1);
+  assert(!server->isRefreshTokenActive(second));
+
+  auto rejected = settled(auth->refreshToken());
+  assert(rejected->isRejected());
+  server->stop();
+}
+
+void testDeniedConsentIsCancelled() {
+  auto server = startServer();
+  ConsentDecision deny;
+  deny.approve = false;
+  server->scriptConsent(deny);
+  auto auth = std::make_shared<HybridAuth>();
+
+  auto login = settled(auth->login(AuthProvider::APPLE, std::nullopt));
+  assert(login->isRejected());
+  assert(errorMessage(login->getError()) == "cancelled");
+  assert(!auth->getCurrentUser());
+  assert(server->stats().consentsDenied == 1);
+
+  // The script is used up; the next sign-in gets the default consent.
+  assert(settled(auth->login(AuthProvider::APPLE, std::nullopt))->isResolved());
+  server->stop();
+}
+
+void testRevokeAccessRevokesTheGrant() {
+  auto server = startServer();
+  auto auth = std::make_shared<HybridAuth>();
+  assert(settled(auth->login(AuthProvider::MICROSOFT, std::nullopt))->isResolved());
+  const std::string refreshToken = platformRefreshToken();
+  assert(server->isRefreshTokenActive(refreshToken));
+
+  auto revoke = settled(auth->revokeAccess());
+  assert(revoke->isResolved());
+  assert(!auth->getCurrentUser());
+  assert(!server->isRefreshTokenActive(refreshToken));
+  assert(server->stats().revocations == 1);
+  server->stop();
+}
+
+void testOidcProviderUsesTheHeadlessBrowser() {
+  auto server = startServer();
+  auto auth = std::make_shared<HybridAuth>();
+  OidcProviderConfig config;
+  config.issuer = server->issuer();
+  config.clientId = server->options().clientId;
+  config.redirectUri = LinuxPlatformAuth::config().redirectUri;
+  auth->configureOidc(config);
+
+  auto login = settled(auth->login(AuthProvider::OIDC, std::nullopt));
+  assert(login->isResolved());
+  assert(auth->getCurrentUser()->provider == AuthProvider::OIDC);
+
+  IdTokenVerificationOptions options;
+  options.audience = config.clientId;
+  auto claims = settled(auth->verifyIdToken(options));
+  assert(claims->isResolved());
+  assert(claims->getResult().issuer == server->issuer());
+  assert(claims->getResult().subject == "loopback-user");
+  server->stop();
+}
+
+void testDownScopedRefreshKeepsTheSession() {
+  auto server = startServer();
+  auto auth = std::make_shared<HybridAuth>();
+  assert(settled(auth->login(AuthProvider::GOOGLE, std::nullopt))->isResolved());
+  const auto sessionToken = auth->getCurrentUser()->accessToken;
+
+  AccessTokenRequest request;
+  request.scopes = std::vector<std::string>{"email"};
+  auto token = settled(auth->getAccessToken(request));
+  assert(token->isResolved() && token->getResult().has_value());
+  assert(*token->getResult() != sessionToken);
+  assert(server->isAccessTokenActive(*token->getResult()));
+  assert(auth->getCurrentUser()->accessToken == sessionToken);
+
+  // Scopes the grant never had are refused.
+  request.scopes = std::vector<std::string>{"calendar"};
+  auto refused = settled(auth->getAccessToken(request));
+  assert(refused->isRejected());
+  assert(server->stats().rejectedGrants == 1);
+  server->stop();
+}
+
+void testUnconfiguredIssuerIsAConfigurationError() {
+  LinuxPlatformAuth::configure({});
+  auto login = PlatformAuth::login(AuthProvider::GOOGLE);
+  assert(login->isResolved() && !login->getResult().ok());
+  assert(login->getResult().error() == AuthErrorCode::CONFIGURATION_ERROR);
+  assert(PlatformAuth::discoveryAuthorities().empty());
+}
+
+} // namespace
+
+int main() {
+  char directory[] = "/tmp/nitro-auth-linux-XXXXXX";
+  if (::mkdtemp(directory) == nullptr) return 1;
+  cacheDirectory = directory;
+
+  testLoginVerifiesTheSignedIdToken();
+  testRefreshRotatesAndDetectsReuse();
+  testDeniedConsentIsCancelled();
+  testRevokeAccessRevokesTheGrant();
+  testOidcProviderUsesTheHeadlessBrowser();
+  testDownScopedRefreshKeepsTheSession();
+  testUnconfiguredIssuerIsAConfigurationError();
+
+  std::cout << "Linux platform tests passed!" << std::endl;
+  return 0;
+}
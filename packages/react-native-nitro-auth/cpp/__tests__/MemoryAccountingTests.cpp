@@ -0,0 +1,94 @@
+#include <cassert>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <thread>
+#include <vector>
+#include "../MemoryAccounting.hpp"
+
+using namespace margelo::nitro::NitroAuth;
+
+namespace {
+
+template <typename T>
+using SessionAllocator = TrackedAllocator<T, MemorySubsystem::SESSIONS>;
+
+void testAllocationsAreBookedAndReleased() {
+  const auto before = MemoryAccounting::usage(MemorySubsystem::SESSIONS);
+  const auto otherBefore = MemoryAccounting::usage(MemorySubsystem::LISTENERS);
+  const auto totalBefore = MemoryAccounting::total();
+  {
+    std::vector<uint64_t, SessionAllocator<uint64_t>> words;
+    words.reserve(100);
+    const auto during = MemoryAccounting::usage(MemorySubsystem::SESSIONS);
+    assert(during.bytes == before.bytes + 100 * sizeof(uint64_t));
+    assert(during.allocations == before.allocations + 1);
+    assert(MemoryAccounting::total().bytes == totalBefore.bytes + 100 * sizeof(uint64_t));
+    // Other subsystems are untouched.
+    assert(MemoryAccounting::usage(MemorySubsystem::LISTENERS).bytes == otherBefore.bytes);
+  }
+  const auto after = MemoryAccounting::usage(MemorySubsystem::SESSIONS);
+  assert(after.bytes == before.bytes && after.allocations == before.allocations);
+  assert(after.peakBytes >= before.bytes + 100 * sizeof(uint64_t));
+  assert(MemoryAccounting::total().bytes == totalBefore.bytes);
+}
+
+void testRebindsForNodesAndControlBlocks() {
+  const auto before = MemoryAccounting::usage(MemorySubsystem::LISTENERS);
+  {
+    using Entry = std::pair<const uint64_t, int>;
+    std::map<uint64_t, int, std::less<uint64_t>, TrackedAllocator<Entry, MemorySubsystem::LISTENERS>> listeners;
+    for (uint64_t i = 0; i < 10; i++) listeners[i] = 1;
+    const auto during = MemoryAccounting::usage(MemorySubsystem::LISTENERS);
+    // One node per entry, each larger than the entry itself.
+    assert(during.allocations == before.allocations + 10);
+    assert(during.bytes >= before.bytes + 10 * sizeof(Entry));
+    listeners.erase(3);
+    assert(MemoryAccounting::usage(MemorySubsystem::LISTENERS).allocations == before.allocations + 9);
+
+    // Object and control block share one allocation.
+    auto shared = std::allocate_shared<uint64_t>(TrackedAllocator<uint64_t, MemorySubsystem::LISTENERS>(), 7);
+    assert(MemoryAccounting::usage(MemorySubsystem::LISTENERS).allocations == before.allocations + 10);
+  }
+  assert(MemoryAccounting::usage(MemorySubsystem::LISTENERS).bytes == before.bytes);
+}
+
+void testPeakIsAHighWaterMark() {
+  const auto before = MemoryAccounting::usage(MemorySubsystem::CACHES);
+  MemoryAccounting::allocated(MemorySubsystem::CACHES, 1 << 20);
+  MemoryAccounting::released(MemorySubsystem::CACHES, 1 << 20);
+  MemoryAccounting::allocated(MemorySubsystem::CACHES, 10);
+  const auto after = MemoryAccounting::usage(MemorySubsystem::CACHES);
+  assert(after.bytes == before.bytes + 10);
+  assert(after.peakBytes >= before.bytes + (1 << 20));
+  assert(MemoryAccounting::total().peakBytes >= after.peakBytes);
+  MemoryAccounting::released(MemorySubsystem::CACHES, 10);
+}
+
+void testConcurrentUpdatesBalance() {
+  const auto before = MemoryAccounting::usage(MemorySubsystem::PENDING_OPERATIONS);
+  std::vector<std::thread> threads;
+  for (int i = 0; i < 4; i++) {
+    threads.emplace_back([]() {
+      for (int j = 0; j < 10'000; j++) {
+        std::vector<int, TrackedAllocator<int, MemorySubsystem::PENDING_OPERATIONS>> items(j % 16 + 1);
+      }
+    });
+  }
+  for (auto& thread : threads) thread.join();
+  const auto after = MemoryAccounting::usage(MemorySubsystem::PENDING_OPERATIONS);
+  assert(after.bytes == before.bytes && after.allocations == before.allocations);
+  assert(after.peakBytes >= 16 * sizeof(int));
+}
+
+} // namespace
+
+int main() {
+  testAllocationsAreBookedAndReleased();
+  testRebindsForNodesAndControlBlocks();
+  testPeakIsAHighWaterMark();
+  testConcurrentUpdatesBalance();
+
+  std::cout << "MemoryAccounting tests passed!" << std::endl;
+  return 0;
+}
@@ -0,0 +1,160 @@
+#include <cassert>
+#include <iostream>
+#include <optional>
+#include <random>
+#include <regex>
+#include <string>
+#include "../MicrosoftAuthority.hpp"
+
+using namespace margelo::nitro::NitroAuth;
+
+namespace {
+
+// The patterns AuthAdapter.kt / AuthAdapter.swift compiled on every call; the
+// native matchers must accept exactly the same language.
+const std::regex kTenantPattern(
+    "^(common|organizations|consumers|[0-9a-fA-F]{8}-[0-9a-fA-F]{4}-[0-9a-fA-F]{4}-[0-9a-fA-F]{4}-[0-9a-fA-F]{12}|"
+    "[A-Za-z0-9][A-Za-z0-9._-]{0,127})$");
+const std::regex kB2cTenantPathPattern(
+    "^([0-9a-fA-F]{8}-[0-9a-fA-F]{4}-[0-9a-fA-F]{4}-[0-9a-fA-F]{4}-[0-9a-fA-F]{12}|[A-Za-z0-9][A-Za-z0-9._-]{0,127})/"
+    "[A-Za-z0-9][A-Za-z0-9._-]{0,127}$");
+const std::regex kB2cPolicyPattern("^[A-Za-z0-9][A-Za-z0-9._-]{0,127}$");
+const std::regex kDomainPattern("^(?=.{1,253}$)(?:[A-Za-z0-9](?:[A-Za-z0-9-]{0,61}[A-Za-z0-9])?\\.)+[A-Za-z]{2,63}$");
+const std::regex kLabelPattern("^[A-Za-z0-9](?:[A-Za-z0-9-]{0,61}[A-Za-z0-9])?$");
+
+struct AuthorityCase {
+  const char* tenant;
+  const char* b2cDomain;
+  std::optional<std::string> expected;
+};
+
+const AuthorityCase kAuthorityCases[] = {
+    {"common", "", "https://login.microsoftonline.com/common/"},
+    {"organizations", "", "https://login.microsoftonline.com/organizations/"},
+    {"consumers", "", "https://login.microsoftonline.com/consumers/"},
+    {"9188040d-6c67-4c5b-b112-36a304b66dad", "", "https://login.microsoftonline.com/9188040d-6c67-4c5b-b112-36a304b66dad/"},
+    {"contoso.onmicrosoft.com", "", "https://login.microsoftonline.com/contoso.onmicrosoft.com/"},
+    {"  contoso.com\n", "", "https://login.microsoftonline.com/contoso.com/"},
+    {"common", "   ", "https://login.microsoftonline.com/common/"},
+    {"", "", std::nullopt},
+    {"   ", "", std::nullopt},
+    {"-contoso", "", std::nullopt},
+    {".contoso", "", std::nullopt},
+    {"contoso/evil", "", std::nullopt},
+    {"contoso?x=1", "", std::nullopt},
+    {"cont oso", "", std::nullopt},
+    {"B2C_1_signin", "Contoso.B2CLogin.com", "https://contoso.b2clogin.com/contoso.onmicrosoft.com/B2C_1_signin/"},
+    {" B2C_1_signin ", " contoso.b2clogin.com ", "https://contoso.b2clogin.com/contoso.onmicrosoft.com/B2C_1_signin/"},
+    {"contoso.onmicrosoft.com/B2C_1A_signup_signin", "login.contoso.com",
+     "https://login.contoso.com/contoso.onmicrosoft.com/B2C_1A_signup_signin/"},
+    {"9188040d-6c67-4c5b-b112-36a304b66dad/B2C_1_signin", "auth.contoso.co.uk",
+     "https://auth.contoso.co.uk/9188040d-6c67-4c5b-b112-36a304b66dad/B2C_1_signin/"},
+    // A bare policy needs a *.b2clogin.com domain to derive the tenant from.
+    {"B2C_1_signin", "login.contoso.com", std::nullopt},
+    {"B2C_1_signin", ".b2clogin.com", std::nullopt},
+    {"B2C_1_signin", "-contoso.b2clogin.com", std::nullopt},
+    {"B2C_1_signin", "a.b.b2clogin.com", std::nullopt},
+    {"contoso/B2C_1/extra", "login.contoso.com", std::nullopt},
+    {"/B2C_1_signin", "login.contoso.com", std::nullopt},
+    {"contoso/", "login.contoso.com", std::nullopt},
+    {"B2C_1_signin", "contoso", std::nullopt},
+    {"B2C_1_signin", "contoso.b2clogin.com.", std::nullopt},
+    {"B2C_1_signin", "contoso..b2clogin.com", std::nullopt},
+    {"B2C_1_signin", "contoso.b2clogin.c0m", std::nullopt},
+    {"B2C_1_signin", "https://contoso.b2clogin.com", std::nullopt},
+    {"B2C_1_signin", "contoso.b2clogin.com/path", std::nullopt},
+};
+
+void testConformanceTable() {
+  for (const auto& testCase : kAuthorityCases) {
+    const auto resolved = MicrosoftAuthority::resolveBaseUrl(testCase.tenant, testCase.b2cDomain);
+    if (resolved != testCase.expected) {
+      std::cerr << "tenant='" << testCase.tenant << "' domain='" << testCase.b2cDomain << "' resolved to '"
+                << resolved.value_or("<nullopt>") << "'" << std::endl;
+    }
+    assert(resolved == testCase.expected);
+    assert(MicrosoftAuthority::authBaseUrl(testCase.tenant, testCase.b2cDomain) == testCase.expected);
+  }
+}
+
+void testLengthLimits() {
+  const std::string segment128 = "a" + std::string(127, 'b');
+  assert(MicrosoftAuthority::isValidTenant(segment128));
+  assert(!MicrosoftAuthority::isValidTenant(segment128 + "c"));
+  assert(MicrosoftAuthority::isValidB2cTenantPath(segment128 + "/" + segment128));
+  assert(!MicrosoftAuthority::isValidB2cTenantPath(segment128 + "/" + segment128 + "c"));
+
+  const std::string label63 = "a" + std::string(61, '-') + "z";
+  assert(MicrosoftAuthority::isValidDomain(label63 + ".com"));
+  assert(!MicrosoftAuthority::isValidDomain("a" + label63 + ".com"));
+  assert(MicrosoftAuthority::isValidDomain("a." + std::string(63, 'z')));
+  assert(!MicrosoftAuthority::isValidDomain("a." + std::string(64, 'z')));
+  assert(!MicrosoftAuthority::isValidDomain("a.z"));
+
+  std::string domain253;
+  while (domain253.size() + 4 < 253) domain253 += "abc.";
+  domain253.resize(249, 'a');
+  domain253 += ".com";
+  assert(domain253.size() == 253);
+  assert(MicrosoftAuthority::isValidDomain(domain253));
+  assert(!MicrosoftAuthority::isValidDomain("a" + domain253));
+  assert(MicrosoftAuthority::b2cTenantName(label63 + ".b2clogin.com") == std::string_view(label63));
+}
+
+void testEntraIssuer() {
+  assert(MicrosoftAuthority::isEntraIssuer("https://login.microsoftonline.com/9188040d-6c67-4c5b-b112-36a304b66dad/v2.0"));
+  assert(MicrosoftAuthority::isEntraIssuer("https://login.microsoftonline.com/consumers/v2.0"));
+  assert(!MicrosoftAuthority::isEntraIssuer("https://login.microsoftonline.com//v2.0"));
+  assert(!MicrosoftAuthority::isEntraIssuer("https://login.microsoftonline.com/a/b/v2.0"));
+  assert(!MicrosoftAuthority::isEntraIssuer("https://login.microsoftonline.com/contoso/v2.0/"));
+  assert(!MicrosoftAuthority::isEntraIssuer("https://login.microsoftonline.com.evil.com/contoso/v2.0"));
+  assert(!MicrosoftAuthority::isEntraIssuer("https://sts.windows.net/contoso/"));
+}
+
+// Differential check against the regexes over strings drawn from an alphabet
+// that exercises every character class boundary.
+void testMatchesRegexOracle() {
+  const std::string alphabet = "aZ09f-._/ .B";
+  std::mt19937 random(20260611);
+  std::uniform_int_distribution<size_t> pick(0, alphabet.size() - 1);
+  std::uniform_int_distribution<size_t> length(0, 24);
+
+  for (int i = 0; i < 20000; ++i) {
+    std::string value(length(random), 'a');
+    for (char& c : value) c = alphabet[pick(random)];
+
+    assert(MicrosoftAuthority::isValidTenant(value) == std::regex_match(value, kTenantPattern));
+    assert(MicrosoftAuthority::isValidB2cPolicy(value) == std::regex_match(value, kB2cPolicyPattern));
+    assert(MicrosoftAuthority::isValidB2cTenantPath(value) == std::regex_match(value, kB2cTenantPathPattern));
+    assert(MicrosoftAuthority::isValidDomain(value) == std::regex_match(value, kDomainPattern));
+
+    const std::string domain = value + ".b2clogin.com";
+    const bool expectedTenantName = std::regex_match(value, kLabelPattern);
+    assert(MicrosoftAuthority::b2cTenantName(domain).has_value() == expectedTenantName);
+  }
+}
+
+void testCacheIsBoundedAndConsistent() {
+  for (int i = 0; i < 100; ++i) {
+    const std::string tenant = "tenant" + std::to_string(i);
+    assert(MicrosoftAuthority::authBaseUrl(tenant) == "https://login.microsoftonline.com/" + tenant + "/");
+  }
+  assert(MicrosoftAuthority::authBaseUrl("common") == "https://login.microsoftonline.com/common/");
+  assert(!MicrosoftAuthority::authBaseUrl("bad tenant").has_value());
+  assert(!MicrosoftAuthority::authBaseUrl("bad tenant").has_value());
+  // The separator keeps (tenant, domain) pairs from colliding.
+  assert(MicrosoftAuthority::authBaseUrl("B2C_1_signin", "contoso.b2clogin.com") !=
+         MicrosoftAuthority::authBaseUrl("B2C_1_signincontoso.b2clogin.com"));
+}
+
+} // namespace
+
+int main() {
+  testConformanceTable();
+  testLengthLimits();
+  testEntraIssuer();
+  testMatchesRegexOracle();
+  testCacheIsBoundedAndConsistent();
+  std::cout << "MicrosoftAuthority tests passed!" << std::endl;
+  return 0;
+}
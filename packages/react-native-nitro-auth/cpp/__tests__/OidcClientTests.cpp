@@ -0,0 +1,598 @@
+#include <cassert>
+#include <iostream>
+#include <map>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include "../JwsCrypto.hpp"
+#include "../OidcClient.hpp"
+#include "IdTokenTestVectors.hpp"
+#include "VirtualTime.hpp"
+
+using namespace margelo::nitro::NitroAuth;
+using namespace margelo::nitro::NitroAuth::vectors;
+
+namespace {
+
+const std::string kIssuer = "https://issuer.example.com";
+const std::string kTokenEndpoint = "https://issuer.example.com/token";
+const std::string kJwksUri = "https://issuer.example.com/jwks";
+const std::string kRedirectUri = "com.example.app:/oauth2redirect";
+const std::string kNonce = "n-0S6_WzA2Mj";
+const std::string kDiscovery =
+    "{\"issuer\":\"https://issuer.example.com\",\"authorization_endpoint\":\"https://issuer.example.com/authorize\","
+    "\"token_endpoint\":\"https://issuer.example.com/token\",\"jwks_uri\":\"https://issuer.example.com/jwks\"}";
+
+// Answers synchronously from a route table and records every request.
+class ScriptedHttpClient : public HttpClient {
+public:
+  void send(const HttpRequest& request, Completion completion) override {
+    requests.push_back(request);
+    auto route = routes.find(request.url);
+    if (route == routes.end()) {
+      HttpResponse missing;
+      missing.status = 404;
+      completion(std::move(missing));
+      return;
+    }
+    completion(route->second);
+  }
+
+  void route(const std::string& url, std::string body, int status = 200) {
+    HttpResponse response;
+    response.status = status;
+    response.body = std::move(body);
+    response.headers["cache-control"] = "max-age=3600";
+    routes[url] = std::move(response);
+  }
+
+  int hits(const std::string& url) const {
+    int count = 0;
+    for (const auto& request : requests) {
+      if (request.url == url) count++;
+    }
+    return count;
+  }
+
+  std::map<std::string, HttpResponse> routes;
+  std::vector<HttpRequest> requests;
+};
+
+// Value of `name` in the query string of `url`, or in a form body.
+std::optional<std::string> parameter(const std::string& encoded, const std::string& name) {
+  const size_t query = encoded.find('?');
+  std::string rest = query == std::string::npos ? encoded : encoded.substr(query + 1);
+  while (!rest.empty()) {
+    const size_t amp = rest.find('&');
+    const std::string pair = rest.substr(0, amp);
+    if (pair.compare(0, name.size() + 1, name + "=") == 0) {
+      std::string value;
+      const std::string raw = pair.substr(name.size() + 1);
+      for (size_t i = 0; i < raw.size(); ++i) {
+        if (raw[i] == '%' && i + 2 < raw.size()) {
+          value.push_back(static_cast<char>(std::stoi(raw.substr(i + 1, 2), nullptr, 16)));
+          i += 2;
+        } else {
+          value.push_back(raw[i]);
+        }
+      }
+      return value;
+    }
+    if (amp == std::string::npos) break;
+    rest = rest.substr(amp + 1);
+  }
+  return std::nullopt;
+}
+
+template <typename T>
+bool succeeded(const std::shared_ptr<Promise<Result<T>>>& promise) {
+  return promise->isResolved() && promise->getResult().ok();
+}
+
+// The code a settled call failed with; empty while pending or on success.
+template <typename T>
+std::string failure(const std::shared_ptr<Promise<Result<T>>>& promise) {
+  if (!promise->isResolved() || promise->getResult().ok()) return "";
+  return std::string(promise->getResult().error().message());
+}
+
+OidcProviderConfig makeConfig() {
+  OidcProviderConfig config;
+  config.issuer = kIssuer;
+  config.clientId = "client-123";
+  config.redirectUri = kRedirectUri;
+  return config;
+}
+
+std::optional<LoginOptions> withNonce(const std::string& nonce = kNonce) {
+  LoginOptions options;
+  options.nonce = nonce;
+  return options;
+}
+
+struct Harness {
+  std::shared_ptr<VirtualTime> time = std::make_shared<VirtualTime>(1700000100000);
+  std::shared_ptr<ScriptedHttpClient> http = std::make_shared<ScriptedHttpClient>();
+  std::shared_ptr<OidcMetadataCache> metadata = std::make_shared<OidcMetadataCache>(http, OidcMetadataOptions{}, time, time);
+  std::vector<std::string> opened;
+  // Builds the redirect for an authorization URL; echoes its state by default.
+  std::function<std::string(const std::string&)> redirect = [](const std::string& url) {
+    return kRedirectUri + "?code=auth-code&state=" + *parameter(url, "state");
+  };
+  std::shared_ptr<OidcClient> client;
+
+  explicit Harness(OidcProviderConfig config = makeConfig()) {
+    http->route(kIssuer + "/.well-known/openid-configuration", kDiscovery);
+    http->route(kJwksUri, kJwks);
+    http->route(kTokenEndpoint, "{\"access_token\":\"at-1\",\"id_token\":\"" + kRs256 +
+                                    "\",\"refresh_token\":\"rt-1\",\"expires_in\":3600,\"token_type\":\"Bearer\"}");
+    client = std::make_shared<OidcClient>(
+        std::move(config), http, metadata, [this](const std::string& url, const std::string& redirectUri) {
+          assert(redirectUri == kRedirectUri);
+          opened.push_back(url);
+          auto promise = Promise<Result<std::string>>::create();
+          promise->resolve(redirect(url));
+          return promise;
+        },
+        time, time);
+  }
+};
+
+// Stand-in authorization server for the device grant (RFC 8628). Like a real
+// server it answers `slow_down` (and slows its own pace) when polled faster than
+// the interval it handed out.
+class DeviceFlowServer : public HttpClient {
+public:
+  static constexpr auto kDeviceEndpoint = "https://issuer.example.com/device";
+
+  explicit DeviceFlowServer(std::shared_ptr<VirtualTime> time) : _time(std::move(time)) {}
+
+  void send(const HttpRequest& request, Completion completion) override {
+    HttpResponse response;
+    response.status = 200;
+    response.headers["cache-control"] = "max-age=3600";
+    if (request.url == kIssuer + "/.well-known/openid-configuration") {
+      response.body = advertiseDeviceEndpoint
+                          ? kDiscovery.substr(0, kDiscovery.size() - 1) + ",\"device_authorization_endpoint\":\"" +
+                                kDeviceEndpoint + "\"}"
+                          : kDiscovery;
+    } else if (request.url == kJwksUri) {
+      response.body = kJwks;
+    } else if (request.url == kDeviceEndpoint) {
+      scopes = parameter(request.body, "scope");
+      issuedAtMs = _time->nowMs();
+      response.body = "{\"device_code\":\"dc-1\",\"user_code\":\"WDJB-MJHT\","
+                      "\"verification_uri\":\"https://issuer.example.com/activate\","
+                      "\"verification_uri_complete\":\"https://issuer.example.com/activate?user_code=WDJB-MJHT\","
+                      "\"expires_in\":" + std::to_string(expiresInSeconds) +
+                      ",\"interval\":" + advertisedInterval.value_or(std::to_string(intervalMs / 1000)) + "}";
+    } else if (request.url == kTokenEndpoint) {
+      assert(parameter(request.body, "grant_type") ==
+             std::optional<std::string>("urn:ietf:params:oauth:grant-type:device_code"));
+      assert(parameter(request.body, "device_code") == std::optional<std::string>("dc-1"));
+      assert(parameter(request.body, "client_id") == std::optional<std::string>("client-123"));
+      const int64_t now = _time->nowMs();
+      const bool tooFast = !polls.empty() && now - polls.back() < intervalMs;
+      polls.push_back(now);
+      if (unreachablePolls > 0) {
+        unreachablePolls--;
+        response.status = 0;
+      } else if (tooFast || slowDownNext) {
+        slowDownNext = false;
+        intervalMs += 5000;
+        response.status = 400;
+        response.body = "{\"error\":\"slow_down\"}";
+      } else if (denied) {
+        response.status = 400;
+        response.body = "{\"error\":\"access_denied\"}";
+      } else if (approveAfterPolls > 0 && polls.size() >= approveAfterPolls) {
+        response.body = "{\"access_token\":\"at-device\",\"id_token\":\"" + kRs256 +
+                        "\",\"refresh_token\":\"rt-device\",\"expires_in\":3600}";
+      } else {
+        response.status = 400;
+        response.body = "{\"error\":\"authorization_pending\"}";
+      }
+    } else {
+      response.status = 404;
+    }
+    completion(std::move(response));
+  }
+
+  bool advertiseDeviceEndpoint = true;
+  int64_t expiresInSeconds = 600;
+  int64_t intervalMs = 5000;
+  // Sent instead of `intervalMs` when set.
+  std::optional<std::string> advertisedInterval;
+  // 0 never approves.
+  size_t approveAfterPolls = 0;
+  bool slowDownNext = false;
+  bool denied = false;
+  int unreachablePolls = 0;
+  int64_t issuedAtMs = 0;
+  std::optional<std::string> scopes;
+  std::vector<int64_t> polls;
+
+private:
+  std::shared_ptr<VirtualTime> _time;
+};
+
+struct DeviceHarness {
+  std::shared_ptr<VirtualTime> time = std::make_shared<VirtualTime>(1700000100000);
+  std::shared_ptr<DeviceFlowServer> server = std::make_shared<DeviceFlowServer>(time);
+  std::shared_ptr<OidcClient> client = std::make_shared<OidcClient>(
+      makeConfig(), server, std::make_shared<OidcMetadataCache>(server, OidcMetadataOptions{}, time, time), nullptr,
+      time, time);
+  std::vector<DeviceAuthorization> codes;
+
+  std::shared_ptr<Promise<Result<AuthUser>>> login(const std::shared_ptr<CancellationToken>& cancellation = nullptr) {
+    return client->loginWithDeviceCode(
+        std::nullopt, [this](const DeviceAuthorization& authorization) { codes.push_back(authorization); },
+        cancellation);
+  }
+};
+
+void testEncoding() {
+  assert(OidcClient::percentEncode("aZ09-._~") == "aZ09-._~");
+  assert(OidcClient::percentEncode("a b&c=d/\xc3\xa9") == "a%20b%26c%3Dd%2F%C3%A9");
+  assert(OidcClient::formEncode({{"grant_type", "authorization_code"}, {"scope", "openid email"}}) ==
+         "grant_type=authorization_code&scope=openid%20email");
+
+  // RFC 7636 Appendix B.
+  assert(OidcClient::codeChallenge("dBjftJeZ4CVP-mB92K27uhbUJU1p1r_wW1gFWFOEjXk") ==
+         "E9Melhoa2OwvFrEMTJguCHaoeK1t8URWbuGJSstw-cM");
+  const std::string verifier = OidcClient::randomToken(32);
+  assert(verifier.size() == 43);
+  assert(verifier != OidcClient::randomToken(32));
+  assert(JwsCrypto::base64UrlDecode(verifier)->size() == 32);
+}
+
+void testAuthorizationRequest() {
+  auto config = makeConfig();
+  assert(OidcClient::scopesFor(config, std::nullopt) ==
+         (std::vector<std::string>{"openid", "profile", "email", "offline_access"}));
+  config.scopes = std::vector<std::string>{"email", "openid", "email", "api.read"};
+  assert(OidcClient::scopesFor(config, std::nullopt) == (std::vector<std::string>{"openid", "email", "api.read"}));
+  assert(OidcClient::scopesFor(config, std::vector<std::string>{"profile"}) ==
+         (std::vector<std::string>{"openid", "profile"}));
+
+  LoginOptions options;
+  options.loginHint = "bob@example.com";
+  options.prompt = MicrosoftPrompt::SELECT_ACCOUNT;
+  const auto request =
+      OidcClient::authorizationRequest(config, "https://issuer.example.com/authorize?tenant=x", {"openid", "email"}, options);
+  assert(request.url.rfind("https://issuer.example.com/authorize?tenant=x&response_type=code&", 0) == 0);
+  assert(parameter(request.url, "client_id") == std::optional<std::string>("client-123"));
+  assert(parameter(request.url, "redirect_uri") == std::optional<std::string>(kRedirectUri));
+  assert(parameter(request.url, "scope") == std::optional<std::string>("openid email"));
+  assert(parameter(request.url, "state") == std::optional<std::string>(request.state));
+  assert(parameter(request.url, "nonce") == std::optional<std::string>(request.nonce));
+  assert(parameter(request.url, "code_challenge") == OidcClient::codeChallenge(request.codeVerifier));
+  assert(parameter(request.url, "code_challenge_method") == std::optional<std::string>("S256"));
+  assert(parameter(request.url, "login_hint") == std::optional<std::string>("bob@example.com"));
+  assert(parameter(request.url, "prompt") == std::optional<std::string>("select_account"));
+  assert(request.state != request.nonce && request.codeVerifier.size() >= 43);
+}
+
+void testParsing() {
+  auto redirect = OidcClient::parseRedirect(kRedirectUri + "?code=a%2Bb+c&state=s1#ignored");
+  assert(redirect.code == std::optional<std::string>("a+b c"));
+  assert(redirect.state == std::optional<std::string>("s1"));
+  assert(!redirect.error);
+  redirect = OidcClient::parseRedirect(kRedirectUri + "#state=s2&error=access_denied");
+  assert(redirect.error == std::optional<std::string>("access_denied"));
+  assert(redirect.state == std::optional<std::string>("s2"));
+  assert(!OidcClient::parseRedirect(kRedirectUri).code);
+
+  HttpResponse response;
+  response.status = 200;
+  response.body = "{\"access_token\":\"at\",\"expires_in\":\"60\",\"scope\":\"openid email\",\"extra\":[1,{}]}";
+  auto tokens = OidcClient::parseTokenResponse(response, 1000);
+  assert(tokens && tokens->tokens.accessToken == std::optional<std::string>("at"));
+  assert(tokens->tokens.expirationTime == std::optional<double>(61000));
+  assert(tokens->scope == std::optional<std::string>("openid email"));
+  assert(!tokens->tokens.refreshToken && !tokens->tokens.idToken);
+  response.body = "{\"token_type\":\"Bearer\"}";
+  assert(!OidcClient::parseTokenResponse(response, 0));
+  response.body = "<html>";
+  assert(!OidcClient::parseTokenResponse(response, 0));
+
+  assert(std::string(OidcClient::errorCodeForOAuthError("access_denied")) == "cancelled");
+  assert(std::string(OidcClient::errorCodeForOAuthError("invalid_client")) == "configuration_error");
+  assert(std::string(OidcClient::errorCodeForOAuthError("invalid_scope")) == "configuration_error");
+  assert(std::string(OidcClient::errorCodeForOAuthError("invalid_grant")) == "token_error");
+  assert(std::string(OidcClient::errorCodeForOAuthError("temporarily_unavailable")) == "network_error");
+  assert(std::string(OidcClient::errorCodeForOAuthError("slow_down")) == "unknown");
+}
+
+void testLoginExchangesCodeWithPkce() {
+  Harness harness;
+  auto login = harness.client->login(withNonce());
+  assert(succeeded(login));
+
+  const AuthUser& user = login->getResult().value();
+  assert(user.provider == AuthProvider::OIDC);
+  assert(user.userId == std::optional<std::string>("248289761001"));
+  assert(user.email == std::optional<std::string>("jane@example.com"));
+  assert(user.accessToken == std::optional<std::string>("at-1"));
+  assert(user.refreshToken == std::optional<std::string>("rt-1"));
+  assert(user.idToken == std::optional<std::string>(kRs256));
+  assert(user.expirationTime == std::optional<double>(1700000100000 + 3600 * 1000));
+  assert(user.scopes == (std::vector<std::string>{"openid", "profile", "email", "offline_access"}));
+
+  assert(harness.opened.size() == 1);
+  const auto& token = harness.http->requests.back();
+  assert(token.url == kTokenEndpoint && token.method == "POST");
+  assert(parameter(token.body, "grant_type") == std::optional<std::string>("authorization_code"));
+  assert(parameter(token.body, "code") == std::optional<std::string>("auth-code"));
+  assert(parameter(token.body, "redirect_uri") == std::optional<std::string>(kRedirectUri));
+  assert(parameter(token.body, "client_id") == std::optional<std::string>("client-123"));
+  // The verifier sent to the token endpoint is the one the challenge was derived from.
+  const auto verifier = parameter(token.body, "code_verifier");
+  assert(verifier && OidcClient::codeChallenge(*verifier) == parameter(harness.opened[0], "code_challenge"));
+}
+
+void testLoginRefetchesRotatedKeys() {
+  Harness harness;
+  harness.http->route(kTokenEndpoint, "{\"access_token\":\"at-1\",\"id_token\":\"" + kRotated + "\"}");
+  // Prime the cache with the old key set, then publish the rotated one.
+  assert(succeeded(harness.metadata->get(kIssuer)));
+  harness.http->route(kJwksUri, kRotatedJwks);
+  harness.time->advance(1000);
+  auto login = harness.client->login(withNonce());
+  assert(succeeded(login));
+  assert(harness.http->hits(kJwksUri) == 2);
+}
+
+void testLoginFailures() {
+  {
+    Harness harness;
+    harness.redirect = [](const std::string& url) {
+      return kRedirectUri + "?error=access_denied&state=" + *parameter(url, "state");
+    };
+    auto login = harness.client->login(withNonce());
+    assert(failure(login) == "cancelled");
+    assert(harness.http->hits(kTokenEndpoint) == 0);
+  }
+  {
+    Harness harness;
+    harness.redirect = [](const std::string&) { return kRedirectUri + "?code=auth-code&state=forged"; };
+    auto login = harness.client->login(withNonce());
+    assert(failure(login) == "invalid_state");
+    assert(harness.http->hits(kTokenEndpoint) == 0);
+  }
+  {
+    Harness harness;
+    harness.http->route(kTokenEndpoint, "{\"error\":\"invalid_grant\"}", 400);
+    auto login = harness.client->login(withNonce());
+    assert(failure(login) == "token_error");
+  }
+  {
+    Harness harness;
+    harness.http->route(kTokenEndpoint, "", 0);
+    auto login = harness.client->login(withNonce());
+    assert(failure(login) == "network_error");
+  }
+  {
+    Harness harness;
+    harness.http->route(kTokenEndpoint, "{\"access_token\":\"at-1\"}");
+    auto login = harness.client->login(withNonce());
+    assert(failure(login) == "no_id_token");
+  }
+  {
+    Harness harness;
+    auto login = harness.client->login(withNonce("replayed"));
+    assert(failure(login) == "invalid_nonce");
+  }
+  {
+    auto config = makeConfig();
+    config.clientId = "other-client";
+    Harness harness(config);
+    auto login = harness.client->login(withNonce());
+    assert(failure(login) == "token_error");
+  }
+  {
+    Harness harness;
+    harness.http->routes.clear();
+    auto login = harness.client->login(withNonce());
+    assert(failure(login) == "configuration_error");
+    assert(harness.opened.empty());
+  }
+  {
+    auto config = makeConfig();
+    config.redirectUri.clear();
+    Harness harness(config);
+    auto login = harness.client->login(withNonce());
+    assert(failure(login) == "configuration_error");
+  }
+}
+
+void testRefresh() {
+  Harness harness;
+  harness.http->route(kTokenEndpoint, "{\"access_token\":\"at-2\",\"refresh_token\":\"rt-2\",\"expires_in\":60}");
+  auto refreshed = harness.client->refresh("rt-1", {"api.read"});
+  assert(succeeded(refreshed));
+  assert(refreshed->getResult().value().accessToken == std::optional<std::string>("at-2"));
+  assert(refreshed->getResult().value().refreshToken == std::optional<std::string>("rt-2"));
+  const auto& request = harness.http->requests.back();
+  assert(parameter(request.body, "grant_type") == std::optional<std::string>("refresh_token"));
+  assert(parameter(request.body, "refresh_token") == std::optional<std::string>("rt-1"));
+  assert(parameter(request.body, "scope") == std::optional<std::string>("api.read"));
+  assert(harness.opened.empty());
+
+  // Without a rotated token the caller keeps the one it has.
+  harness.http->route(kTokenEndpoint, "{\"access_token\":\"at-3\"}");
+  auto kept = harness.client->refresh("rt-2");
+  assert(succeeded(kept) && !kept->getResult().value().refreshToken);
+  assert(!parameter(harness.http->requests.back().body, "scope"));
+
+  harness.http->route(kTokenEndpoint, "{\"error\":\"invalid_grant\",\"error_description\":\"revoked\"}", 400);
+  auto revoked = harness.client->refresh("rt-2");
+  assert(failure(revoked) == "token_error");
+  harness.http->route(kTokenEndpoint, "upstream timeout", 503);
+  auto unavailable = harness.client->refresh("rt-2");
+  assert(failure(unavailable) == "network_error");
+  auto missing = harness.client->refresh("");
+  assert(failure(missing) == "refresh_failed");
+}
+
+void testParseDeviceAuthorization() {
+  HttpResponse response;
+  response.status = 200;
+  response.body = "{\"device_code\":\"dc\",\"user_code\":\"ABCD\",\"verification_url\":\"https://g.co/device\","
+                  "\"expires_in\":\"1800\",\"interval\":\"7\"}";
+  auto code = OidcClient::parseDeviceAuthorization(response, 1000);
+  assert(code && code->deviceCode == "dc" && code->authorization.userCode == "ABCD");
+  assert(code->authorization.verificationUri == "https://g.co/device");
+  assert(!code->authorization.verificationUriComplete);
+  assert(code->expiresAtMs == 1000 + 1800000 && code->authorization.expiresAt == 1801000.0);
+  assert(code->intervalMs == 7000 && code->authorization.interval == 7.0);
+
+  response.body = "{\"device_code\":\"dc\",\"user_code\":\"ABCD\",\"verification_uri\":\"https://x\",\"expires_in\":60}";
+  code = OidcClient::parseDeviceAuthorization(response, 0);
+  assert(code && code->intervalMs == OidcClient::kDefaultPollIntervalMs);
+  response.body = "{\"device_code\":\"dc\",\"verification_uri\":\"https://x\",\"expires_in\":60}";
+  assert(!OidcClient::parseDeviceAuthorization(response, 0));
+  response.body = "{\"device_code\":\"dc\",\"user_code\":\"ABCD\",\"verification_uri\":\"https://x\"}";
+  assert(!OidcClient::parseDeviceAuthorization(response, 0));
+}
+
+void testDevicePollIntervalHasAFloor() {
+  HttpResponse response;
+  response.status = 200;
+  response.body = "{\"device_code\":\"dc\",\"user_code\":\"ABCD\",\"verification_uri\":\"https://x\","
+                  "\"expires_in\":60,\"interval\":0.001}";
+  auto code = OidcClient::parseDeviceAuthorization(response, 0);
+  assert(code && code->intervalMs == OidcClient::kMinPollIntervalMs && code->authorization.interval == 1.0);
+
+  // A server asking for a poll every millisecond still gets one per second.
+  DeviceHarness harness;
+  harness.server->intervalMs = 0;
+  harness.server->advertisedInterval = "0.001";
+  auto cancellation = CancellationToken::create();
+  auto login = harness.login(cancellation);
+  harness.time->advance(10000);
+  assert(login->isPending() && harness.server->polls.size() == 10);
+  for (size_t i = 1; i < harness.server->polls.size(); ++i) {
+    assert(harness.server->polls[i] - harness.server->polls[i - 1] == OidcClient::kMinPollIntervalMs);
+  }
+  cancellation->cancel("cancelled");
+  assert(failure(login) == "cancelled" && harness.time->pending() == 0);
+}
+
+void testDeviceCodeLogin() {
+  DeviceHarness harness;
+  harness.server->approveAfterPolls = 3;
+  auto login = harness.login();
+  assert(login->isPending());
+  assert(harness.codes.size() == 1);
+  assert(harness.codes[0].userCode == "WDJB-MJHT");
+  assert(harness.codes[0].verificationUri == "https://issuer.example.com/activate");
+  assert(harness.codes[0].verificationUriComplete ==
+         std::optional<std::string>("https://issuer.example.com/activate?user_code=WDJB-MJHT"));
+  assert(harness.codes[0].interval == 5.0);
+  assert(harness.server->scopes == std::optional<std::string>("openid profile email offline_access"));
+  // Nothing is sent before the first interval has elapsed.
+  harness.time->advance(4999);
+  assert(harness.server->polls.empty());
+
+  harness.time->advance(1);
+  assert(harness.server->polls.size() == 1 && login->isPending());
+  harness.time->advance(60000);
+  assert(succeeded(login));
+  assert(harness.server->polls.size() == 3);
+  for (size_t i = 0; i < harness.server->polls.size(); ++i) {
+    assert(harness.server->polls[i] == harness.server->issuedAtMs + 5000 * static_cast<int64_t>(i + 1));
+  }
+  const AuthUser& user = login->getResult().value();
+  assert(user.provider == AuthProvider::OIDC);
+  assert(user.accessToken == std::optional<std::string>("at-device"));
+  assert(user.refreshToken == std::optional<std::string>("rt-device"));
+  assert(user.idToken == std::optional<std::string>(kRs256));
+  assert(harness.time->pending() == 0);
+}
+
+void testDeviceCodeSlowDown() {
+  DeviceHarness harness;
+  harness.server->approveAfterPolls = 4;
+  harness.server->slowDownNext = true;
+  auto login = harness.login();
+  harness.time->advance(5000);
+  assert(harness.server->polls.size() == 1);
+  // slow_down adds 5 s to every later interval.
+  harness.time->advance(9999);
+  assert(harness.server->polls.size() == 1);
+  harness.time->advance(1);
+  assert(harness.server->polls.size() == 2);
+  harness.time->advance(60000);
+  assert(succeeded(login));
+  const auto& polls = harness.server->polls;
+  assert(polls.size() == 4 && polls[3] - polls[2] == 10000);
+
+  // An unreachable server doubles the interval instead of failing the sign-in.
+  DeviceHarness offline;
+  offline.server->approveAfterPolls = 3;
+  offline.server->unreachablePolls = 1;
+  auto retried = offline.login();
+  offline.time->advance(60000);
+  assert(succeeded(retried));
+  assert(offline.server->polls[1] - offline.server->polls[0] == 10000);
+}
+
+void testDeviceCodeFailures() {
+  {
+    // The code lapses without approval: the last poll lands on the expiry.
+    DeviceHarness harness;
+    harness.server->expiresInSeconds = 12;
+    auto login = harness.login();
+    harness.time->advance(60000);
+    assert(failure(login) == "timeout");
+    assert(harness.server->polls.size() == 2);
+    assert(harness.time->pending() == 0);
+  }
+  {
+    DeviceHarness harness;
+    harness.server->denied = true;
+    auto login = harness.login();
+    harness.time->advance(5000);
+    assert(failure(login) == "cancelled");
+    assert(harness.time->pending() == 0);
+  }
+  {
+    DeviceHarness harness;
+    auto cancellation = CancellationToken::create();
+    auto login = harness.login(cancellation);
+    harness.time->advance(5000);
+    cancellation->cancel("timeout");
+    assert(failure(login) == "timeout");
+    assert(harness.time->pending() == 0);
+    harness.time->advance(60000);
+    assert(harness.server->polls.size() == 1);
+  }
+  {
+    DeviceHarness harness;
+    harness.server->advertiseDeviceEndpoint = false;
+    auto login = harness.login();
+    assert(failure(login) == "configuration_error");
+    assert(harness.codes.empty());
+  }
+}
+
+} // namespace
+
+int main() {
+  testEncoding();
+  testAuthorizationRequest();
+  testParsing();
+  testLoginExchangesCodeWithPkce();
+  testLoginRefetchesRotatedKeys();
+  testLoginFailures();
+  testRefresh();
+  testParseDeviceAuthorization();
+  testDevicePollIntervalHasAFloor();
+  testDeviceCodeLogin();
+  testDeviceCodeSlowDown();
+  testDeviceCodeFailures();
+  std::cout << "OidcClient tests passed!" << std::endl;
+  return 0;
+}
@@ -0,0 +1,454 @@
+#include <atomic>
+#include <cassert>
+#include <cstdlib>
+#include <deque>
+#include <iostream>
+#include <map>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include <arpa/inet.h>
+#include <dirent.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#include "../OidcMetadataCache.hpp"
+#include "VirtualTime.hpp"
+
+using namespace margelo::nitro::NitroAuth;
+
+namespace {
+
+// Minimal HTTP/1.1 stand-in for an identity provider on 127.0.0.1. One request
+// per connection; routes can be swapped while the server runs.
+class LoopbackServer {
+public:
+  struct Route {
+    int status = 200;
+    std::vector<std::pair<std::string, std::string>> headers;
+    std::string body;
+  };
+
+  LoopbackServer() {
+    _socket = ::socket(AF_INET, SOCK_STREAM, 0);
+    assert(_socket >= 0);
+    int reuse = 1;
+    ::setsockopt(_socket, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+    sockaddr_in address{};
+    address.sin_family = AF_INET;
+    address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    address.sin_port = 0;
+    assert(::bind(_socket, reinterpret_cast<sockaddr*>(&address), sizeof(address)) == 0);
+    assert(::listen(_socket, 16) == 0);
+    socklen_t length = sizeof(address);
+    ::getsockname(_socket, reinterpret_cast<sockaddr*>(&address), &length);
+    _port = ntohs(address.sin_port);
+    _thread = std::thread([this]() { run(); });
+  }
+
+  ~LoopbackServer() {
+    _stopping = true;
+    ::shutdown(_socket, SHUT_RDWR);
+    ::close(_socket);
+    _thread.join();
+  }
+
+  std::string url(const std::string& path = "") const { return "http://127.0.0.1:" + std::to_string(_port) + path; }
+
+  void route(const std::string& path, Route route) {
+    std::lock_guard<std::mutex> lock(_mutex);
+    _routes[path] = std::move(route);
+  }
+
+  int hits(const std::string& path) {
+    std::lock_guard<std::mutex> lock(_mutex);
+    return _hits[path];
+  }
+
+private:
+  void run() {
+    while (!_stopping) {
+      const int client = ::accept(_socket, nullptr, nullptr);
+      if (client < 0) continue;
+      std::string request;
+      char buffer[1024];
+      while (request.find("\r\n\r\n") == std::string::npos) {
+        const ssize_t received = ::recv(client, buffer, sizeof(buffer), 0);
+        if (received <= 0) break;
+        request.append(buffer, static_cast<size_t>(received));
+      }
+      const size_t pathStart = request.find(' ') + 1;
+      const std::string path = request.substr(pathStart, request.find(' ', pathStart) - pathStart);
+
+      Route route;
+      route.status = 404;
+      {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _hits[path]++;
+        if (auto it = _routes.find(path); it != _routes.end()) route = it->second;
+      }
+      std::string response = "HTTP/1.1 " + std::to_string(route.status) + " X\r\nConnection: close\r\n";
+      for (const auto& [name, value] : route.headers) response += name + ": " + value + "\r\n";
+      response += "Content-Length: " + std::to_string(route.body.size()) + "\r\n\r\n" + route.body;
+      ::send(client, response.data(), response.size(), 0);
+      ::close(client);
+    }
+  }
+
+  int _socket = -1;
+  uint16_t _port = 0;
+  std::atomic<bool> _stopping{false};
+  std::mutex _mutex;
+  std::map<std::string, Route> _routes;
+  std::map<std::string, int> _hits;
+  std::thread _thread;
+};
+
+// Blocking plain-HTTP client for loopback URLs; completes on the calling thread.
+class SocketHttpClient : public HttpClient {
+public:
+  void send(const HttpRequest& request, Completion completion) override {
+    HttpResponse response;
+    const std::string prefix = "http://127.0.0.1:";
+    if (request.url.rfind(prefix, 0) != 0) {
+      completion(response);
+      return;
+    }
+    const size_t pathStart = request.url.find('/', prefix.size());
+    const int port = std::atoi(request.url.substr(prefix.size(), pathStart - prefix.size()).c_str());
+    const std::string path = pathStart == std::string::npos ? "/" : request.url.substr(pathStart);
+
+    const int fd = ::socket(AF_INET, SOCK_STREAM, 0);
+    sockaddr_in address{};
+    address.sin_family = AF_INET;
+    address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    address.sin_port = htons(static_cast<uint16_t>(port));
+    if (::connect(fd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0) {
+      ::close(fd);
+      completion(response);
+      return;
+    }
+    const std::string message = request.method + " " + path + " HTTP/1.1\r\nHost: 127.0.0.1\r\n\r\n";
+    ::send(fd, message.data(), message.size(), 0);
+    std::string raw;
+    char buffer[4096];
+    ssize_t received;
+    while ((received = ::recv(fd, buffer, sizeof(buffer), 0)) > 0) raw.append(buffer, static_cast<size_t>(received));
+    ::close(fd);
+
+    const size_t headerEnd = raw.find("\r\n\r\n");
+    if (headerEnd == std::string::npos) {
+      completion(response);
+      return;
+    }
+    response.status = std::atoi(raw.substr(raw.find(' ') + 1, 3).c_str());
+    size_t line = raw.find("\r\n") + 2;
+    while (line < headerEnd) {
+      const size_t lineEnd = raw.find("\r\n", line);
+      const size_t colon = raw.find(':', line);
+      std::string name = raw.substr(line, colon - line);
+      for (auto& c : name) c = static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
+      response.headers[name] = raw.substr(colon + 2, lineEnd - colon - 2);
+      line = lineEnd + 2;
+    }
+    response.body = raw.substr(headerEnd + 4);
+    requests++;
+    completion(std::move(response));
+  }
+
+  int requests = 0;
+};
+
+// Holds requests until released, to observe callers that overlap one fetch.
+class DeferredHttpClient : public HttpClient {
+public:
+  explicit DeferredHttpClient(std::shared_ptr<HttpClient> inner) : _inner(std::move(inner)) {}
+
+  void send(const HttpRequest& request, Completion completion) override {
+    _queue.emplace_back(request, std::move(completion));
+  }
+
+  size_t queued() const { return _queue.size(); }
+
+  void releaseNext() {
+    auto [request, completion] = std::move(_queue.front());
+    _queue.pop_front();
+    _inner->send(request, std::move(completion));
+  }
+
+private:
+  std::shared_ptr<HttpClient> _inner;
+  std::deque<std::pair<HttpRequest, Completion>> _queue;
+};
+
+const std::string kJwks = R"({"keys":[{"kty":"RSA","kid":"k1","n":"AQAB","e":"AQAB"}]})";
+
+void serveProvider(LoopbackServer& server, const std::string& discoveryCache = "max-age=3600",
+                   const std::string& jwksCache = "max-age=600") {
+  const std::string issuer = server.url();
+  server.route("/.well-known/openid-configuration",
+               {200,
+                {{"Cache-Control", discoveryCache}},
+                R"({"issuer":")" + issuer + R"(","authorization_endpoint":")" + issuer + R"(/authorize",)"
+                  R"("token_endpoint":")" + issuer + R"(/token","jwks_uri":")" + issuer + R"(/keys",)"
+                  R"("device_authorization_endpoint":")" + issuer + R"(/device","claims_supported":["sub"]})"});
+  server.route("/keys", {200, {{"Cache-Control", jwksCache}}, kJwks});
+}
+
+std::string makeDirectory() {
+  char pattern[] = "/tmp/nitro-auth-oidc-XXXXXX";
+  const char* directory = ::mkdtemp(pattern);
+  assert(directory != nullptr);
+  return directory;
+}
+
+void removeDirectory(const std::string& directory) {
+  if (DIR* dir = ::opendir(directory.c_str())) {
+    while (dirent* entry = ::readdir(dir)) {
+      const std::string name = entry->d_name;
+      if (name != "." && name != "..") ::unlink((directory + "/" + name).c_str());
+    }
+    ::closedir(dir);
+  }
+  ::rmdir(directory.c_str());
+}
+
+using MetadataLookup = std::shared_ptr<Promise<Result<std::shared_ptr<const OidcMetadata>>>>;
+
+std::shared_ptr<const OidcMetadata> resolved(const MetadataLookup& promise) {
+  assert(promise->isResolved() && promise->getResult().ok());
+  return promise->getResult().value();
+}
+
+std::string failure(const MetadataLookup& promise) {
+  assert(promise->isResolved() && !promise->getResult().ok());
+  return std::string(promise->getResult().error().message());
+}
+
+void testLifetimeHeaders() {
+  std::cout << "Running testLifetimeHeaders..." << std::endl;
+  HttpResponse response;
+  assert(!OidcMetadataCache::lifetimeMs(response, 0).has_value());
+
+  response.headers["cache-control"] = "public, Max-Age=120";
+  response.headers["age"] = "20";
+  assert(OidcMetadataCache::lifetimeMs(response, 0) == 100000);
+  response.headers["age"] = "500";
+  assert(OidcMetadataCache::lifetimeMs(response, 0) == 0);
+
+  response.headers["cache-control"] = "max-age=60, no-cache";
+  assert(OidcMetadataCache::lifetimeMs(response, 0) == 0);
+
+  response.headers.clear();
+  response.headers["date"] = "Sun, 06 Nov 1994 08:49:37 GMT";
+  response.headers["expires"] = "Sun, 06 Nov 1994 09:49:37 GMT";
+  assert(OidcMetadataCache::lifetimeMs(response, 0) == 3600000);
+
+  // Without Date the local clock is the base: 784111777000 is the Date above.
+  response.headers.erase("date");
+  assert(OidcMetadataCache::lifetimeMs(response, 784111777000LL) == 3600000);
+
+  response.headers["expires"] = "0";
+  assert(OidcMetadataCache::lifetimeMs(response, 0) == 0);
+  std::cout << "testLifetimeHeaders passed!" << std::endl;
+}
+
+void testFetchesOnceAndHonorsLifetimes() {
+  std::cout << "Running testFetchesOnceAndHonorsLifetimes..." << std::endl;
+  LoopbackServer server;
+  serveProvider(server);
+  auto time = std::make_shared<VirtualTime>(1000000);
+  auto cache = std::make_shared<OidcMetadataCache>(std::make_shared<SocketHttpClient>(), OidcMetadataOptions{}, time, time);
+
+  auto metadata = resolved(cache->get(server.url() + "/"));
+  assert(metadata->authority == server.url());
+  assert(metadata->provider.tokenEndpoint == server.url() + "/token");
+  assert(metadata->provider.deviceAuthorizationEndpoint == server.url() + "/device");
+  assert(!metadata->provider.endSessionEndpoint.has_value());
+  assert(metadata->jwks == kJwks);
+  // The JWKS lifetime (10 minutes) is the shorter one.
+  assert(metadata->expiresAtMs == 1000000 + 600000);
+
+  time->advance(599000);
+  assert(resolved(cache->get(server.url())) == metadata);
+  assert(server.hits("/.well-known/openid-configuration") == 1);
+  assert(server.hits("/keys") == 1);
+
+  time->advance(1000);
+  auto refetched = resolved(cache->get(server.url()));
+  assert(refetched != metadata);
+  assert(server.hits("/.well-known/openid-configuration") == 2);
+
+  auto stats = cache->stats();
+  assert(stats.hits == 1);
+  assert(stats.misses == 2);
+  assert(stats.fetches == 2);
+  std::cout << "testFetchesOnceAndHonorsLifetimes passed!" << std::endl;
+}
+
+void testConcurrentLookupsShareOneFetch() {
+  std::cout << "Running testConcurrentLookupsShareOneFetch..." << std::endl;
+  LoopbackServer server;
+  serveProvider(server);
+  auto time = std::make_shared<VirtualTime>(0);
+  auto http = std::make_shared<DeferredHttpClient>(std::make_shared<SocketHttpClient>());
+  auto cache = std::make_shared<OidcMetadataCache>(http, OidcMetadataOptions{}, time, time);
+
+  auto first = cache->get(server.url());
+  auto second = cache->get(server.url());
+  assert(first == second);
+  assert(first->isPending());
+  assert(http->queued() == 1);
+
+  http->releaseNext(); // Discovery; queues the JWKS request.
+  assert(first->isPending());
+  assert(http->queued() == 1);
+  http->releaseNext();
+  assert(resolved(first)->jwks == kJwks);
+  assert(server.hits("/.well-known/openid-configuration") == 1);
+  assert(cache->stats().fetches == 1);
+  std::cout << "testConcurrentLookupsShareOneFetch passed!" << std::endl;
+}
+
+void testPersistsAcrossInstances() {
+  std::cout << "Running testPersistsAcrossInstances..." << std::endl;
+  const std::string directory = makeDirectory();
+  auto time = std::make_shared<VirtualTime>(0);
+  OidcMetadataOptions options;
+  options.cacheDirectory = directory + "/nested/oidc";
+  std::string authority;
+  {
+    LoopbackServer server;
+    serveProvider(server);
+    authority = server.url();
+    auto cache = std::make_shared<OidcMetadataCache>(std::make_shared<SocketHttpClient>(), options, time, time);
+    resolved(cache->get(authority));
+  }
+
+  // The provider is gone; a cold start still has fresh metadata without any network.
+  auto http = std::make_shared<SocketHttpClient>();
+  auto restarted = std::make_shared<OidcMetadataCache>(http, options, time, time);
+  auto metadata = resolved(restarted->get(authority));
+  assert(metadata->provider.jwksUri == authority + "/keys");
+  assert(metadata->jwks == kJwks);
+  assert(metadata->expiresAtMs == 600000);
+  assert(http->requests == 0);
+  assert(restarted->stats().diskLoads == 1);
+  assert(restarted->stats().fetches == 0);
+
+  removeDirectory(options.cacheDirectory);
+  removeDirectory(directory + "/nested");
+  removeDirectory(directory);
+  std::cout << "testPersistsAcrossInstances passed!" << std::endl;
+}
+
+void testFailedRefetchFallsBackToStaleEntry() {
+  std::cout << "Running testFailedRefetchFallsBackToStaleEntry..." << std::endl;
+  LoopbackServer server;
+  serveProvider(server, "no-store", "max-age=60");
+  auto time = std::make_shared<VirtualTime>(0);
+  auto cache = std::make_shared<OidcMetadataCache>(std::make_shared<SocketHttpClient>(), OidcMetadataOptions{}, time, time);
+
+  auto metadata = resolved(cache->get(server.url()));
+  // Both lifetimes are below the floor, so the 5 minute minimum applies.
+  assert(metadata->expiresAtMs == 300000);
+
+  server.route("/.well-known/openid-configuration", {503, {}, ""});
+  time->advance(300000);
+  assert(resolved(cache->get(server.url())) == metadata);
+  assert(cache->stats().staleHits == 1);
+
+  // invalidate() forces a refetch even while fresh; the old entry stays the fallback.
+  serveProvider(server);
+  resolved(cache->get(server.url()));
+  cache->invalidate(server.url());
+  assert(cache->peek(server.url())->expiresAtMs == 0);
+  resolved(cache->get(server.url()));
+  assert(server.hits("/.well-known/openid-configuration") == 4);
+  std::cout << "testFailedRefetchFallsBackToStaleEntry passed!" << std::endl;
+}
+
+void testRejectsUnusableDocuments() {
+  std::cout << "Running testRejectsUnusableDocuments..." << std::endl;
+  LoopbackServer server;
+  auto time = std::make_shared<VirtualTime>(0);
+  auto cache = std::make_shared<OidcMetadataCache>(std::make_shared<SocketHttpClient>(), OidcMetadataOptions{}, time, time);
+
+  assert(failure(cache->get(server.url())) == "configuration_error"); // 404
+
+  server.route("/.well-known/openid-configuration", {200, {}, "{\"issuer\":"});
+  assert(failure(cache->get(server.url())) == "parse_error");
+
+  // An issuer that does not match the authority is a mix-up, not a provider.
+  server.route("/.well-known/openid-configuration",
+               {200, {}, R"({"issuer":"https://evil.example","authorization_endpoint":"https://evil.example/a",)"
+                         R"("token_endpoint":"https://evil.example/t","jwks_uri":"https://evil.example/k"})"});
+  assert(failure(cache->get(server.url())) == "configuration_error");
+
+  serveProvider(server);
+  server.route("/keys", {200, {}, R"({"keys":"nope"})"});
+  assert(failure(cache->get(server.url())) == "parse_error");
+
+  auto offline = std::make_shared<OidcMetadataCache>(nullptr, OidcMetadataOptions{}, time, time);
+  assert(failure(offline->get("https://login.example.com")) == "network_error");
+  assert(failure(offline->get("  ")) == "configuration_error");
+  std::cout << "testRejectsUnusableDocuments passed!" << std::endl;
+}
+
+void testTenantPlaceholderIssuer() {
+  std::cout << "Running testTenantPlaceholderIssuer..." << std::endl;
+  LoopbackServer server;
+  const std::string base = server.url();
+  server.route("/common/v2.0/.well-known/openid-configuration",
+               {200, {}, R"({"issuer":")" + base + R"(/{tenantid}/v2.0","authorization_endpoint":")" + base +
+                           R"(/common/oauth2/v2.0/authorize","token_endpoint":")" + base +
+                           R"(/common/oauth2/v2.0/token","jwks_uri":")" + base + R"(/common/discovery/v2.0/keys"})"});
+  server.route("/common/discovery/v2.0/keys", {200, {}, kJwks});
+  auto time = std::make_shared<VirtualTime>(0);
+  auto cache = std::make_shared<OidcMetadataCache>(std::make_shared<SocketHttpClient>(), OidcMetadataOptions{}, time, time);
+
+  auto metadata = resolved(cache->get(base + "/common/v2.0"));
+  assert(metadata->provider.issuer == base + "/{tenantid}/v2.0");
+  assert(failure(cache->get(base + "/common/extra/v2.0")) == "configuration_error");
+  std::cout << "testTenantPlaceholderIssuer passed!" << std::endl;
+}
+
+void testPrefetchRunsOnTimerThread() {
+  std::cout << "Running testPrefetchRunsOnTimerThread..." << std::endl;
+  LoopbackServer server;
+  serveProvider(server);
+  auto time = std::make_shared<VirtualTime>(0);
+  auto cache = std::make_shared<OidcMetadataCache>(std::make_shared<SocketHttpClient>(), OidcMetadataOptions{}, time, time);
+
+  cache->prefetch({server.url()});
+  assert(cache->peek(server.url()) == nullptr);
+  assert(time->pending() == 1);
+  time->advance(0);
+  assert(cache->peek(server.url()) != nullptr);
+
+  resolved(cache->get(server.url()));
+  assert(cache->stats().hits == 1);
+  assert(server.hits("/.well-known/openid-configuration") == 1);
+
+  // A prefetch that outlives the cache is dropped.
+  cache->prefetch({server.url()});
+  cache.reset();
+  time->advance(0);
+  std::cout << "testPrefetchRunsOnTimerThread passed!" << std::endl;
+}
+
+} // namespace
+
+int main() {
+  testLifetimeHeaders();
+  testFetchesOnceAndHonorsLifetimes();
+  testConcurrentLookupsShareOneFetch();
+  testPersistsAcrossInstances();
+  testFailedRefetchFallsBackToStaleEntry();
+  testRejectsUnusableDocuments();
+  testTenantPlaceholderIssuer();
+  testPrefetchRunsOnTimerThread();
+  std::cout << "OidcMetadataCache tests passed!" << std::endl;
+  return 0;
+}
@@ -0,0 +1,140 @@
+#include <cassert>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+#include "../PackedAuthUser.hpp"
+
+using namespace margelo::nitro::NitroAuth;
+
+namespace {
+
+AuthUser fullUser() {
+  AuthUser user;
+  user.provider = AuthProvider::MICROSOFT;
+  user.email = "jane@contoso.com";
+  user.name = "Jane";
+  user.photo = "";
+  user.idToken = std::string(900, 'i');
+  user.accessToken = "access-1";
+  user.refreshToken = "refresh-1";
+  user.serverAuthCode = "code";
+  user.authorizationCode = "auth-code";
+  user.userId = "00000000-0000-0000-0000-000000000001";
+  user.phoneNumber = "+15550100";
+  user.hostedDomain = "contoso.com";
+  user.scopes = std::vector<std::string>{"openid", "User.Read", "offline_access"};
+  user.expirationTime = 1'700'000'000'000.0;
+  user.underlyingError = "none";
+  return user;
+}
+
+void testRoundTripsEveryField() {
+  const auto user = fullUser();
+  PackedAuthUser packed(user);
+  assert(packed.unpack() == user);
+  assert(packed.provider() == AuthProvider::MICROSOFT);
+  assert(packed.view(AuthUserField::EMAIL) == "jane@contoso.com");
+  // Present but empty is not absent.
+  assert(packed.has(AuthUserField::PHOTO) && packed.view(AuthUserField::PHOTO)->empty());
+  assert(packed.expirationTime() == 1'700'000'000'000.0);
+
+  AuthUser sparse;
+  sparse.provider = AuthProvider::APPLE;
+  sparse.userId = "apple-1";
+  sparse.scopes = std::vector<std::string>{};
+  PackedAuthUser packedSparse(sparse);
+  assert(packedSparse.unpack() == sparse);
+  assert(!packedSparse.has(AuthUserField::EMAIL));
+  assert(packedSparse.scopes() && packedSparse.scopes()->empty());
+  assert(!packedSparse.expirationTime());
+
+  PackedAuthUser empty;
+  assert(empty.packedBytes() == 0);
+  assert(!empty.has(AuthUserField::ACCESS_TOKEN) && !empty.scopes());
+}
+
+void testEditsLeaveCopiesUntouched() {
+  PackedAuthUser original(fullUser());
+  const PackedAuthUser copy = original;
+  assert(copy == original);
+
+  auto rotated = original.with(AuthUserField::REFRESH_TOKEN, std::string_view("refresh-2"));
+  assert(rotated.view(AuthUserField::REFRESH_TOKEN) == "refresh-2");
+  assert(rotated.view(AuthUserField::USER_ID) == original.view(AuthUserField::USER_ID));
+  assert(copy.view(AuthUserField::REFRESH_TOKEN) == "refresh-1");
+  assert(!(rotated == copy));
+
+  // Revisions follow buffers, not contents.
+  assert(copy.revision() == original.revision() && copy.revision() != 0);
+  assert(rotated.revision() != original.revision());
+  assert(PackedAuthUser(fullUser()).revision() != original.revision());
+  assert(PackedAuthUser().revision() == 0);
+
+  auto cleared = rotated.with(AuthUserField::ID_TOKEN, std::nullopt);
+  assert(!cleared.has(AuthUserField::ID_TOKEN));
+  assert(cleared.packedBytes() + 900 == rotated.packedBytes());
+
+  AuthTokens tokens;
+  tokens.accessToken = "access-2";
+  tokens.expirationTime = 1'700'000'360'000.0;
+  auto refreshed = copy.withTokens(tokens);
+  assert(refreshed.view(AuthUserField::ACCESS_TOKEN) == "access-2");
+  assert(refreshed.view(AuthUserField::REFRESH_TOKEN) == "refresh-1");
+  assert(refreshed.view(AuthUserField::ID_TOKEN) == copy.view(AuthUserField::ID_TOKEN));
+  assert(refreshed.expirationTime() == 1'700'000'360'000.0);
+
+  auto narrowed = refreshed.withScopes(std::vector<std::string>{"openid"});
+  assert(narrowed.scopes() == std::vector<std::string>{"openid"});
+  assert(!narrowed.withScopes(std::nullopt).scopes());
+}
+
+void testScopesAreInternedOnce() {
+  const size_t before = ScopeTable::size();
+  std::vector<std::thread> threads;
+  for (int i = 0; i < 4; i++) {
+    threads.emplace_back([]() {
+      for (int j = 0; j < 100; j++) PackedAuthUser packed(fullUser());
+    });
+  }
+  for (auto& thread : threads) thread.join();
+  PackedAuthUser(fullUser()).withScopes(std::vector<std::string>{"openid", "User.Read"});
+  assert(ScopeTable::size() <= before + 3);
+  assert(ScopeTable::scope(ScopeTable::intern("User.Read")) == "User.Read");
+}
+
+void testPackedLayoutIsOneBuffer() {
+  const auto user = fullUser();
+  PackedAuthUser packed(user);
+  size_t fieldBytes = 0;
+  for (size_t i = 0; i < kAuthUserFieldCount; i++) {
+    fieldBytes += packed.view(static_cast<AuthUserField>(i)).value_or("").size();
+  }
+  // Header, one id per scope, then the field bytes; nothing else.
+  assert(packed.packedBytes() < fieldBytes + 128);
+  assert(packed.packedBytes() >= fieldBytes + 3 * sizeof(uint32_t));
+}
+
+void testLongScopeListsAreKeptWhole() {
+  AuthUser user;
+  user.provider = AuthProvider::GOOGLE;
+  std::vector<std::string> scopes;
+  for (size_t i = 0; i < 70'000; i++) scopes.push_back("scope-" + std::to_string(i % 10));
+  user.scopes = scopes;
+  PackedAuthUser packed(user);
+  assert(packed.scopes() == scopes);
+  assert(packed.unpack() == user);
+}
+
+} // namespace
+
+int main() {
+  testRoundTripsEveryField();
+  testEditsLeaveCopiesUntouched();
+  testScopesAreInternedOnce();
+  testPackedLayoutIsOneBuffer();
+  testLongScopeListsAreKeptWhole();
+
+  std::cout << "PackedAuthUser tests passed!" << std::endl;
+  return 0;
+}
@@ -0,0 +1,114 @@
+#include <cassert>
+#include <iostream>
+#include <memory>
+#include <thread>
+#include <vector>
+#include "../PendingOperationRegistry.hpp"
+
+using namespace margelo::nitro::NitroAuth;
+
+namespace {
+
+std::vector<std::shared_ptr<Promise<void>>> trackMany(PendingOperationRegistry& registry, size_t count) {
+  std::vector<std::shared_ptr<Promise<void>>> promises;
+  for (size_t i = 0; i < count; i++) {
+    promises.push_back(Promise<void>::create());
+    registry.track(promises.back());
+  }
+  return promises;
+}
+
+void testSettledPromisesLeave() {
+  auto registry = std::make_shared<PendingOperationRegistry>();
+  auto promises = trackMany(*registry, 5);
+  assert(registry->size() == 5);
+
+  // Head, middle and tail unlink alike.
+  promises[0]->resolve();
+  promises[2]->reject(std::make_exception_ptr(std::runtime_error("failed")));
+  promises[4]->resolve();
+  assert(registry->size() == 2);
+
+  auto pending = registry->takeAll();
+  assert(pending.size() == 2 && pending[0] == promises[1] && pending[1] == promises[3]);
+  assert(registry->size() == 0 && registry->takeAll().empty());
+}
+
+void testSettledBeforeTrackingIsNotKept() {
+  auto registry = std::make_shared<PendingOperationRegistry>();
+  auto resolved = Promise<void>::create();
+  resolved->resolve();
+  registry->track(resolved);
+  assert(registry->size() == 0);
+}
+
+void testSlotsAreReusedAndStaleHandlesIgnored() {
+  auto registry = std::make_shared<PendingOperationRegistry>();
+  auto first = trackMany(*registry, 3);
+  auto taken = registry->takeAll();
+  assert(taken.size() == 3);
+
+  // New promises land in the slots the taken ones used.
+  auto second = trackMany(*registry, 3);
+  // Settling a taken promise must not unlink its slot's new occupant.
+  for (auto& promise : taken) promise->resolve();
+  assert(registry->size() == 3);
+
+  second[1]->resolve();
+  auto third = trackMany(*registry, 2);
+  assert(registry->size() == 4);
+  auto pending = registry->takeAll();
+  assert(pending.size() == 4);
+  assert(pending[0] == second[0] && pending[1] == second[2] && pending[2] == third[0] && pending[3] == third[1]);
+}
+
+void testBurstsReleaseTheirMemory() {
+  auto registry = std::make_shared<PendingOperationRegistry>();
+  const auto before = MemoryAccounting::usage(MemorySubsystem::PENDING_OPERATIONS);
+  auto promises = trackMany(*registry, 5'000);
+  assert(MemoryAccounting::usage(MemorySubsystem::PENDING_OPERATIONS).bytes > before.bytes);
+  for (auto it = promises.rbegin(); it != promises.rend(); ++it) (*it)->resolve();
+  assert(registry->size() == 0);
+  assert(MemoryAccounting::usage(MemorySubsystem::PENDING_OPERATIONS).bytes == before.bytes);
+}
+
+void testOutlivedRegistryIsIgnored() {
+  auto promise = Promise<void>::create();
+  {
+    auto registry = std::make_shared<PendingOperationRegistry>();
+    registry->track(promise);
+  }
+  promise->resolve();
+  assert(promise->isResolved());
+}
+
+void testConcurrentTracking() {
+  auto registry = std::make_shared<PendingOperationRegistry>();
+  std::vector<std::thread> threads;
+  for (int i = 0; i < 4; i++) {
+    threads.emplace_back([registry]() {
+      for (int j = 0; j < 1'000; j++) {
+        auto promise = Promise<void>::create();
+        registry->track(promise);
+        if (j % 2 == 0) promise->resolve();
+      }
+    });
+  }
+  for (auto& thread : threads) thread.join();
+  assert(registry->size() == 2'000);
+  assert(registry->takeAll().size() == 2'000);
+}
+
+} // namespace
+
+int main() {
+  testSettledPromisesLeave();
+  testSettledBeforeTrackingIsNotKept();
+  testSlotsAreReusedAndStaleHandlesIgnored();
+  testBurstsReleaseTheirMemory();
+  testOutlivedRegistryIsIgnored();
+  testConcurrentTracking();
+
+  std::cout << "PendingOperationRegistry tests passed!" << std::endl;
+  return 0;
+}
@@ -0,0 +1,94 @@
+#include <cassert>
+#include <iostream>
+#include "../RefreshBackoff.hpp"
+
+using namespace margelo::nitro::NitroAuth;
+
+namespace {
+
+RefreshBackoffPolicy deterministicPolicy() {
+  RefreshBackoffPolicy policy;
+  policy.initialDelayMs = 1000;
+  policy.maxDelayMs = 8000;
+  policy.multiplier = 2.0;
+  policy.jitterRatio = 0.0;
+  return policy;
+}
+
+void testClassification() {
+  assert(RefreshBackoff::classify("cancelled") == RefreshFailureKind::IGNORED);
+  assert(RefreshBackoff::classify("operation_in_progress") == RefreshFailureKind::IGNORED);
+  assert(RefreshBackoff::classify("not_signed_in") == RefreshFailureKind::PERMANENT);
+  assert(RefreshBackoff::classify("token_error") == RefreshFailureKind::PERMANENT);
+  assert(RefreshBackoff::classify("configuration_error") == RefreshFailureKind::PERMANENT);
+  assert(RefreshBackoff::classify("network_error") == RefreshFailureKind::TRANSIENT);
+  assert(RefreshBackoff::classify("timeout") == RefreshFailureKind::TRANSIENT);
+  assert(RefreshBackoff::classify("something new") == RefreshFailureKind::TRANSIENT);
+}
+
+void testTransientFailuresBackOffExponentiallyUpToCap() {
+  RefreshBackoff backoff(deterministicPolicy(), 42);
+  assert(!backoff.blockingError(0).has_value());
+
+  backoff.recordFailure("network_error", 0);
+  assert(backoff.blockingError(999) == "network_error");
+  assert(!backoff.blockingError(1000).has_value());
+
+  backoff.recordFailure("network_error", 1000);
+  assert(backoff.retryAtMs() == 3000);
+  backoff.recordFailure("timeout", 3000);
+  assert(backoff.retryAtMs() == 7000);
+  assert(backoff.blockingError(6999) == "timeout");
+  backoff.recordFailure("network_error", 7000);
+  assert(backoff.retryAtMs() == 15000);
+  backoff.recordFailure("network_error", 15000);
+  assert(backoff.retryAtMs() == 23000);
+  assert(backoff.consecutiveFailures() == 5);
+
+  backoff.recordSuccess();
+  assert(backoff.consecutiveFailures() == 0);
+  assert(!backoff.blockingError(15001).has_value());
+}
+
+void testJitterStaysWithinBounds() {
+  RefreshBackoffPolicy policy = deterministicPolicy();
+  policy.jitterRatio = 0.5;
+  RefreshBackoff backoff(policy, 7);
+  for (int i = 0; i < 100; ++i) {
+    backoff.reset();
+    backoff.recordFailure("network_error", 0);
+    assert(backoff.retryAtMs() >= 500);
+    assert(backoff.retryAtMs() <= 1500);
+  }
+}
+
+void testPermanentFailuresFailFastUntilReset() {
+  RefreshBackoff backoff(deterministicPolicy(), 1);
+  backoff.recordFailure("token_error", 0);
+  assert(backoff.isPermanent());
+  assert(backoff.blockingError(1000000000) == "token_error");
+
+  backoff.reset();
+  assert(!backoff.blockingError(0).has_value());
+}
+
+void testIgnoredFailuresDoNotOpenTheCircuit() {
+  RefreshBackoff backoff(deterministicPolicy(), 1);
+  backoff.recordFailure("cancelled", 0);
+  backoff.recordFailure("operation_in_progress", 0);
+  assert(backoff.consecutiveFailures() == 0);
+  assert(!backoff.blockingError(0).has_value());
+}
+
+} // namespace
+
+int main() {
+  testClassification();
+  testTransientFailuresBackOffExponentiallyUpToCap();
+  testJitterStaysWithinBounds();
+  testPermanentFailuresFailFastUntilReset();
+  testIgnoredFailuresDoNotOpenTheCircuit();
+
+  std::cout << "RefreshBackoff tests passed!" << std::endl;
+  return 0;
+}
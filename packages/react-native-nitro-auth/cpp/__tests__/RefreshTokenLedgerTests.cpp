@@ -0,0 +1,70 @@
+#include <cassert>
+#include <iostream>
+#include <string>
+#include "../RefreshTokenLedger.hpp"
+
+using namespace margelo::nitro::NitroAuth;
+
+namespace {
+
+void testRotationSupersedesThePreviousToken() {
+  RefreshTokenLedger ledger;
+  std::optional<std::string> current = "rt-1";
+
+  assert(ledger.apply(current, std::nullopt) == RefreshTokenUpdate::UNCHANGED);
+  assert(ledger.apply(current, std::string()) == RefreshTokenUpdate::UNCHANGED);
+  assert(ledger.apply(current, "rt-1") == RefreshTokenUpdate::UNCHANGED);
+  assert(current == "rt-1");
+  assert(ledger.size() == 0);
+
+  assert(ledger.apply(current, "rt-2") == RefreshTokenUpdate::ROTATED);
+  assert(current == "rt-2");
+  assert(ledger.isSuperseded("rt-1"));
+  assert(!ledger.isSuperseded("rt-2"));
+}
+
+void testSupersededTokenIsNeverAdoptedAgain() {
+  RefreshTokenLedger ledger;
+  std::optional<std::string> current = "rt-1";
+  assert(ledger.apply(current, "rt-2") == RefreshTokenUpdate::ROTATED);
+  assert(ledger.apply(current, "rt-3") == RefreshTokenUpdate::ROTATED);
+
+  assert(ledger.apply(current, "rt-1") == RefreshTokenUpdate::REUSED);
+  assert(ledger.apply(current, "rt-2") == RefreshTokenUpdate::REUSED);
+  assert(current == "rt-3");
+}
+
+void testFirstTokenIsAdoptedWithoutSupersedingAnything() {
+  RefreshTokenLedger ledger;
+  std::optional<std::string> current;
+  assert(ledger.apply(current, "rt-1") == RefreshTokenUpdate::ROTATED);
+  assert(current == "rt-1");
+  assert(ledger.size() == 0);
+}
+
+void testHistoryIsBounded() {
+  RefreshTokenLedger ledger;
+  std::optional<std::string> current = "rt-0";
+  const size_t rotations = RefreshTokenLedger::kMaxSuperseded + 4;
+  for (size_t i = 1; i <= rotations; i++) {
+    assert(ledger.apply(current, "rt-" + std::to_string(i)) == RefreshTokenUpdate::ROTATED);
+  }
+  assert(ledger.size() == RefreshTokenLedger::kMaxSuperseded);
+  // The oldest digests were dropped; the most recent ones are still refused.
+  assert(!ledger.isSuperseded("rt-0"));
+  assert(!ledger.isSuperseded("rt-3"));
+  assert(ledger.isSuperseded("rt-4"));
+  assert(ledger.isSuperseded("rt-" + std::to_string(rotations - 1)));
+}
+
+} // namespace
+
+int main() {
+  testRotationSupersedesThePreviousToken();
+  testSupersededTokenIsNeverAdoptedAgain();
+  testFirstTokenIsAdoptedWithoutSupersedingAnything();
+  testHistoryIsBounded();
+
+  std::cout << "RefreshTokenLedger tests passed!" << std::endl;
+  return 0;
+}
@@ -0,0 +1,491 @@
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <memory>
+#include <optional>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <vector>
+#include "../HybridAuth.hpp"
+#include "../PlatformAuth.hpp"
+#include "VirtualTime.hpp"
+
+// Drives random interleavings of session operations and platform success/failure
+// orderings through HybridAuth, checking invariants after every step:
+//   - no hybrid promise settles twice,
+//   - the current user always matches the last operation that won its generation,
+//   - granted scopes stay consistent with the current user,
+//   - the session version never decreases and moves whenever the user or scopes do,
+//   - once the platform is drained, no hybrid promise or in-flight refresh is left pending.
+//
+// Built as a libFuzzer target with -DNITRO_AUTH_LIBFUZZER -fsanitize=fuzzer
+// (`test:cpp:fuzz`); otherwise runs as a seeded property test, and replays any
+// input files passed on the command line.
+
+using namespace margelo::nitro::NitroAuth;
+
+#define FUZZ_CHECK(condition)                                                                 \
+  do {                                                                                        \
+    if (!(condition)) {                                                                       \
+      std::fprintf(stderr, "invariant failed: %s (%s:%d)\n", #condition, __FILE__, __LINE__); \
+      std::abort();                                                                           \
+    }                                                                                         \
+  } while (0)
+
+namespace margelo::nitro::NitroAuth {
+
+void HybridAuthSpec::loadHybridMethods() {}
+
+namespace {
+
+// Mirror of the single-slot-per-operation platforms: a second call while the
+// slot is held fails with operation_in_progress.
+struct PlatformSlots {
+  std::shared_ptr<Promise<Result<AuthUser>>> login;
+  uint64_t loginGeneration = 0;
+  std::shared_ptr<Promise<Result<AuthUser>>> scopes;
+  uint64_t scopesGeneration = 0;
+  std::shared_ptr<Promise<Result<AuthTokens>>> refresh;
+  uint64_t refreshGeneration = 0;
+  // Refresh results land on the account they were started for, so they are keyed
+  // by account epoch rather than by session generation.
+  uint64_t refreshAccountEpoch = 0;
+  bool refreshForAccount = false;
+  std::shared_ptr<Promise<Result<std::optional<AuthUser>>>> restore;
+  uint64_t restoreGeneration = 0;
+  std::vector<std::shared_ptr<Promise<Result<void>>>> revokes;
+  uint64_t refreshCalls = 0;
+};
+
+PlatformSlots gSlots;
+// Generation the model expects HybridAuth to be in; platform calls capture it.
+uint64_t gModelGeneration = 0;
+// Bumped whenever the signed-in account is replaced or removed.
+uint64_t gModelAccountEpoch = 0;
+
+template <typename T>
+std::shared_ptr<Promise<Result<T>>> claimSlot(std::shared_ptr<Promise<Result<T>>>& slot, uint64_t& generation) {
+  auto promise = Promise<Result<T>>::create();
+  if (slot) {
+    promise->resolve(AuthErrorCode::OPERATION_IN_PROGRESS);
+    return promise;
+  }
+  slot = promise;
+  generation = gModelGeneration;
+  return promise;
+}
+
+} // namespace
+
+std::shared_ptr<Promise<Result<AuthUser>>> PlatformAuth::login(AuthProvider, const std::optional<LoginOptions>&) {
+  return claimSlot(gSlots.login, gSlots.loginGeneration);
+}
+
+std::shared_ptr<Promise<Result<AuthUser>>> PlatformAuth::requestScopes(const std::vector<std::string>&) {
+  return claimSlot(gSlots.scopes, gSlots.scopesGeneration);
+}
+
+std::shared_ptr<Promise<Result<AuthTokens>>> PlatformAuth::refreshToken(const std::optional<AuthProvider>& provider,
+                                                                        const std::vector<std::string>&) {
+  gSlots.refreshCalls++;
+  if (!gSlots.refresh) {
+    gSlots.refreshAccountEpoch = gModelAccountEpoch;
+    gSlots.refreshForAccount = provider.has_value();
+  }
+  return claimSlot(gSlots.refresh, gSlots.refreshGeneration);
+}
+
+std::shared_ptr<Promise<Result<std::optional<AuthUser>>>> PlatformAuth::silentRestore() {
+  return claimSlot(gSlots.restore, gSlots.restoreGeneration);
+}
+
+bool PlatformAuth::hasPlayServices() {
+  return true;
+}
+
+std::shared_ptr<Promise<Result<std::string>>> PlatformAuth::authorizeInBrowser(const std::string&, const std::string&) {
+  auto promise = Promise<Result<std::string>>::create();
+  promise->resolve(AuthErrorCode::UNSUPPORTED_PROVIDER);
+  return promise;
+}
+
+std::shared_ptr<HttpClient> PlatformAuth::httpClient() {
+  return nullptr;
+}
+
+std::string PlatformAuth::cacheDirectory() {
+  return "";
+}
+
+std::vector<std::string> PlatformAuth::discoveryAuthorities() {
+  return {};
+}
+
+void PlatformAuth::logout() {}
+
+std::shared_ptr<Promise<Result<void>>> PlatformAuth::revokeAccess() {
+  auto promise = Promise<Result<void>>::create();
+  gSlots.revokes.push_back(promise);
+  return promise;
+}
+
+void PlatformAuth::cancel(PlatformOperation operation, const std::string& reason) {
+  const AuthError error(reason);
+  auto failSlot = [&](auto& slot) {
+    auto promise = std::move(slot);
+    slot = nullptr;
+    if (promise && promise->isPending()) promise->resolve(error);
+  };
+  switch (operation) {
+    case PlatformOperation::LOGIN: failSlot(gSlots.login); break;
+    case PlatformOperation::REQUEST_SCOPES: failSlot(gSlots.scopes); break;
+    case PlatformOperation::REFRESH_TOKEN: failSlot(gSlots.refresh); break;
+    case PlatformOperation::SILENT_RESTORE: failSlot(gSlots.restore); break;
+  }
+}
+
+} // namespace margelo::nitro::NitroAuth
+
+namespace {
+
+class ByteStream {
+public:
+  ByteStream(const uint8_t* data, size_t size) : _data(data), _size(size) {}
+
+  bool empty() const { return _position >= _size; }
+  uint8_t next() { return empty() ? 0 : _data[_position++]; }
+
+private:
+  const uint8_t* _data;
+  size_t _size;
+  size_t _position = 0;
+};
+
+enum class Action : uint8_t {
+  LOGIN,
+  LOGOUT,
+  REFRESH,
+  GET_ACCESS_TOKEN,
+  SILENT_RESTORE,
+  REQUEST_SCOPES,
+  REVOKE_SCOPES,
+  REVOKE_ACCESS,
+  SETTLE_PLATFORM,
+  ADVANCE_TIME,
+  CANCEL_TOKEN,
+  COUNT,
+};
+
+const char* const kErrorCodes[] = {"network_error", "cancelled", "token_error", "timeout"};
+const char* const kScopes[] = {"profile", "email", "calendar"};
+
+struct Session {
+  std::shared_ptr<HybridAuth> auth;
+  std::shared_ptr<VirtualTime> time;
+  // Access token the model expects on the current user; nullopt means signed out.
+  std::optional<std::string> expectedToken;
+  uint64_t nextToken = 0;
+  std::vector<std::shared_ptr<Promise<void>>> voidPromises;
+  std::vector<std::shared_ptr<Promise<AuthTokens>>> tokenPromises;
+  std::vector<std::shared_ptr<Promise<std::optional<std::string>>>> accessTokenPromises;
+  std::vector<std::shared_ptr<CancellationToken>> tokens;
+  // What the last check saw, for the session version invariant.
+  mutable std::optional<AuthUser> observedUser;
+  mutable std::vector<std::string> observedScopes;
+  mutable double observedVersion = -1;
+};
+
+template <typename T>
+void trackSettlements(const std::shared_ptr<Promise<T>>& promise) {
+  auto settlements = std::make_shared<int>(0);
+  if constexpr (std::is_void_v<T>) {
+    promise->addOnResolvedListener([settlements]() { FUZZ_CHECK(++*settlements == 1); });
+  } else {
+    promise->addOnResolvedListener([settlements](const T&) { FUZZ_CHECK(++*settlements == 1); });
+  }
+  promise->addOnRejectedListener([settlements](const std::exception_ptr&) { FUZZ_CHECK(++*settlements == 1); });
+}
+
+AuthUser makeUser(Session& session, ByteStream& input) {
+  AuthUser user;
+  user.provider = AuthProvider::GOOGLE;
+  user.email = "fuzz@example.com";
+  user.accessToken = "token-" + std::to_string(session.nextToken++);
+  // Mix of missing, already expired, near-expiry and long-lived tokens.
+  switch (input.next() % 4) {
+    case 0: break;
+    case 1: user.expirationTime = static_cast<double>(session.time->nowMs() - 1000); break;
+    case 2: user.expirationTime = static_cast<double>(session.time->nowMs() + 60000); break;
+    default: user.expirationTime = static_cast<double>(session.time->nowMs() + 3600000); break;
+  }
+  if (input.next() % 2) {
+    user.scopes = std::vector<std::string>{kScopes[input.next() % 3]};
+  }
+  return user;
+}
+
+std::shared_ptr<CancellationToken> pickToken(Session& session, ByteStream& input) {
+  auto choice = input.next() % 4;
+  if (choice == 0) return nullptr;
+  auto token = CancellationToken::create();
+  if (choice == 1) token->cancel();
+  session.tokens.push_back(token);
+  return token;
+}
+
+void settleOne(Session& session, ByteStream& input, uint8_t target) {
+  bool reject = input.next() % 3 == 0;
+  const AuthError error(kErrorCodes[input.next() % 4]);
+
+  // A platform result only changes the session if its generation is still current.
+  auto settleUser = [&](std::shared_ptr<Promise<Result<AuthUser>>>& slot, uint64_t generation, bool advances) {
+    if (!slot) return;
+    auto promise = std::move(slot);
+    slot = nullptr;
+    if (reject) {
+      promise->resolve(error);
+      return;
+    }
+    auto user = makeUser(session, input);
+    bool wins = generation == gModelGeneration;
+    if (wins) {
+      session.expectedToken = user.accessToken;
+      if (advances) {
+        gModelGeneration++;
+        gModelAccountEpoch++;
+      }
+    }
+    promise->resolve(user);
+  };
+
+  switch (target % 5) {
+    case 0: settleUser(gSlots.login, gSlots.loginGeneration, true); break;
+    case 1: settleUser(gSlots.scopes, gSlots.scopesGeneration, false); break;
+    case 2: {
+      if (!gSlots.refresh) return;
+      auto promise = std::move(gSlots.refresh);
+      gSlots.refresh = nullptr;
+      if (reject) {
+        promise->resolve(error);
+        return;
+      }
+      AuthTokens tokens;
+      tokens.accessToken = "token-" + std::to_string(session.nextToken++);
+      tokens.expirationTime = static_cast<double>(session.time->nowMs() + 3600000);
+      if (gSlots.refreshForAccount && gSlots.refreshAccountEpoch == gModelAccountEpoch) {
+        session.expectedToken = tokens.accessToken;
+      }
+      promise->resolve(tokens);
+      break;
+    }
+    case 3: {
+      if (!gSlots.restore) return;
+      auto promise = std::move(gSlots.restore);
+      gSlots.restore = nullptr;
+      if (reject) {
+        promise->resolve(error);
+        return;
+      }
+      std::optional<AuthUser> user;
+      if (input.next() % 2) user = makeUser(session, input);
+      if (gSlots.restoreGeneration == gModelGeneration) {
+        session.expectedToken = user ? user->accessToken : std::nullopt;
+        gModelGeneration++;
+        gModelAccountEpoch++;
+      }
+      promise->resolve(user);
+      break;
+    }
+    default: {
+      if (gSlots.revokes.empty()) return;
+      auto index = input.next() % gSlots.revokes.size();
+      auto promise = gSlots.revokes[index];
+      gSlots.revokes.erase(gSlots.revokes.begin() + static_cast<std::ptrdiff_t>(index));
+      promise->resolve(reject ? Result<void>(error) : Result<void>());
+      break;
+    }
+  }
+}
+
+void step(Session& session, ByteStream& input) {
+  auto& auth = session.auth;
+  switch (static_cast<Action>(input.next() % static_cast<uint8_t>(Action::COUNT))) {
+    case Action::LOGIN: {
+      auto token = pickToken(session, input);
+      if (!token || !token->isCancelled()) gModelGeneration++;
+      auto promise = auth->login(AuthProvider::GOOGLE, std::nullopt, token);
+      trackSettlements(promise);
+      session.voidPromises.push_back(promise);
+      break;
+    }
+    case Action::LOGOUT:
+      gModelGeneration++;
+      gModelAccountEpoch++;
+      session.expectedToken = std::nullopt;
+      auth->logout();
+      break;
+    case Action::REFRESH: {
+      auto promise = auth->refreshToken(pickToken(session, input));
+      trackSettlements(promise);
+      session.tokenPromises.push_back(promise);
+      break;
+    }
+    case Action::GET_ACCESS_TOKEN: {
+      auto promise = auth->getAccessToken();
+      trackSettlements(promise);
+      session.accessTokenPromises.push_back(promise);
+      break;
+    }
+    case Action::SILENT_RESTORE: {
+      auto promise = auth->silentRestore(pickToken(session, input));
+      trackSettlements(promise);
+      session.voidPromises.push_back(promise);
+      break;
+    }
+    case Action::REQUEST_SCOPES: {
+      auto promise = auth->requestScopes({kScopes[input.next() % 3]}, pickToken(session, input));
+      trackSettlements(promise);
+      session.voidPromises.push_back(promise);
+      break;
+    }
+    case Action::REVOKE_SCOPES: {
+      auto promise = auth->revokeScopes({kScopes[input.next() % 3]});
+      trackSettlements(promise);
+      session.voidPromises.push_back(promise);
+      break;
+    }
+    case Action::REVOKE_ACCESS: {
+      gModelGeneration++;
+      gModelAccountEpoch++;
+      session.expectedToken = std::nullopt;
+      auto promise = auth->revokeAccess();
+      trackSettlements(promise);
+      session.voidPromises.push_back(promise);
+      break;
+    }
+    case Action::SETTLE_PLATFORM:
+      settleOne(session, input, input.next());
+      break;
+    case Action::ADVANCE_TIME:
+      session.time->advance(static_cast<int64_t>(input.next()) * 50);
+      break;
+    case Action::CANCEL_TOKEN:
+      if (!session.tokens.empty()) {
+        session.tokens[input.next() % session.tokens.size()]->cancel(kErrorCodes[input.next() % 2]);
+      }
+      break;
+    case Action::COUNT:
+      break;
+  }
+}
+
+void checkSessionState(const Session& session) {
+  auto user = session.auth->getCurrentUser();
+  FUZZ_CHECK(user.has_value() == session.expectedToken.has_value());
+  if (user) {
+    FUZZ_CHECK(user->accessToken == session.expectedToken);
+  }
+  auto granted = session.auth->getGrantedScopes();
+  if (!user) {
+    FUZZ_CHECK(granted.empty());
+  } else if (user->scopes) {
+    FUZZ_CHECK(*user->scopes == granted);
+  }
+
+  const double version = session.auth->getSessionVersion();
+  FUZZ_CHECK(version >= session.observedVersion);
+  if (user != session.observedUser || granted != session.observedScopes) {
+    FUZZ_CHECK(version > session.observedVersion);
+  } else if (version == session.observedVersion) {
+    FUZZ_CHECK(!session.auth->getCurrentUserIfChanged(version));
+  }
+  session.observedUser = std::move(user);
+  session.observedScopes = std::move(granted);
+  session.observedVersion = version;
+}
+
+bool platformIdle() {
+  return !gSlots.login && !gSlots.scopes && !gSlots.refresh && !gSlots.restore && gSlots.revokes.empty();
+}
+
+void drain(Session& session, ByteStream& input) {
+  // Settle everything the platform still holds, in input-chosen order, then let deadlines fire.
+  for (uint8_t round = 0; round < 200 && !platformIdle(); ++round) {
+    settleOne(session, input, input.empty() ? round : input.next());
+    checkSessionState(session);
+  }
+  session.time->advance(24 * 60 * 60 * 1000);
+  FUZZ_CHECK(platformIdle());
+  checkSessionState(session);
+
+  for (const auto& promise : session.voidPromises) FUZZ_CHECK(!promise->isPending());
+  for (const auto& promise : session.tokenPromises) FUZZ_CHECK(!promise->isPending());
+  for (const auto& promise : session.accessTokenPromises) FUZZ_CHECK(!promise->isPending());
+
+  // A leaked in-flight refresh would hand out a pending promise without reaching the platform.
+  auto callsBefore = gSlots.refreshCalls;
+  auto refresh = session.auth->refreshToken();
+  FUZZ_CHECK(!refresh->isPending() || gSlots.refreshCalls == callsBefore + 1);
+}
+
+void runInput(const uint8_t* data, size_t size) {
+  gSlots = PlatformSlots{};
+  gModelGeneration = 0;
+  gModelAccountEpoch = 0;
+
+  Session session;
+  session.time = std::make_shared<VirtualTime>(1'000'000);
+  session.auth = std::make_shared<HybridAuth>();
+  session.auth->setClock(session.time);
+  session.auth->setTimerService(session.time);
+  OperationDeadlines deadlines;
+  deadlines.loginMs = 5000;
+  deadlines.requestScopesMs = 5000;
+  deadlines.refreshTokenMs = 2000;
+  deadlines.silentRestoreMs = 2000;
+  session.auth->setOperationDeadlines(deadlines);
+
+  ByteStream input(data, size);
+  for (int steps = 0; steps < 256 && !input.empty(); ++steps) {
+    step(session, input);
+    checkSessionState(session);
+  }
+  drain(session, input);
+}
+
+} // namespace
+
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t* data, size_t size) {
+  runInput(data, size);
+  return 0;
+}
+
+#ifndef NITRO_AUTH_LIBFUZZER
+int main(int argc, char** argv) {
+  for (int i = 1; i < argc; ++i) {
+    std::ifstream file(argv[i], std::ios::binary);
+    std::vector<uint8_t> bytes((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+    runInput(bytes.data(), bytes.size());
+  }
+  if (argc > 1) {
+    std::cout << "Replayed " << (argc - 1) << " session interleaving inputs" << std::endl;
+    return 0;
+  }
+
+  constexpr int kIterations = 5000;
+  for (uint32_t seed = 1; seed <= kIterations; ++seed) {
+    std::mt19937 random(seed);
+    std::vector<uint8_t> bytes(64 + random() % 448);
+    for (auto& byte : bytes) byte = static_cast<uint8_t>(random());
+    runInput(bytes.data(), bytes.size());
+  }
+  std::cout << "Session interleaving property tests passed (" << kIterations << " sequences)" << std::endl;
+  return 0;
+}
+#endif
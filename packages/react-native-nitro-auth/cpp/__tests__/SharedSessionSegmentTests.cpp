@@ -0,0 +1,224 @@
+#include <cassert>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <sys/stat.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#include "../SharedSessionSegment.hpp"
+
+using namespace margelo::nitro::NitroAuth;
+
+namespace {
+
+// A fresh segment path in a private (0700) directory.
+std::string makePath() {
+  char pattern[] = "/tmp/nitro-auth-shared-XXXXXX";
+  assert(::mkdtemp(pattern) != nullptr);
+  return std::string(pattern) + "/segment";
+}
+
+void removePath(const std::string& path) {
+  ::unlink(path.c_str());
+  ::rmdir(path.substr(0, path.find_last_of('/')).c_str());
+}
+
+std::string fileContents(const std::string& path) {
+  std::ifstream file(path, std::ios::binary);
+  return std::string(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+}
+
+bool throwsStorageError(const std::string& path) {
+  try {
+    SharedSessionSegment::open(path);
+  } catch (const std::runtime_error& error) {
+    return std::string(error.what()) == "storage_error";
+  }
+  return false;
+}
+
+// Token and expiry both derive from `round`, so a reader can tell a torn read from a whole one.
+SharedSession sessionFor(int round) {
+  SharedSession session;
+  session.accountId = "microsoft:bob";
+  // Lengths vary too, so a torn read would also mix lengths and bytes.
+  session.accessToken = "token-" + std::to_string(round) + "-" + std::string(static_cast<size_t>(round % 97), 'x');
+  session.expirationTime = 1767225600000.0 + round;
+  return session;
+}
+
+bool isConsistent(const SharedSession& session) {
+  if (session.accountId != "microsoft:bob" || !session.expirationTime) return false;
+  const int round = static_cast<int>(*session.expirationTime - 1767225600000.0);
+  return session.accessToken == sessionFor(round).accessToken;
+}
+
+void testPublishReadAndClear() {
+  const auto path = makePath();
+  auto writer = SharedSessionSegment::open(path);
+  auto reader = SharedSessionSegment::open(path);
+
+  auto empty = reader->read();
+  assert(!empty.session.has_value());
+  assert(empty.version == 0);
+
+  assert(writer->publish(sessionFor(1)));
+  auto first = reader->read();
+  assert(first.session && first.session->accessToken == sessionFor(1).accessToken);
+  assert(first.session->accountId == "microsoft:bob");
+  assert(first.session->expirationTime == sessionFor(1).expirationTime);
+  assert(first.version == 1);
+  assert(reader->version() == 1);
+
+  SharedSession noExpiry;
+  noExpiry.accountId = "google:alice";
+  noExpiry.accessToken = "opaque";
+  assert(writer->publish(noExpiry));
+  auto second = reader->read();
+  assert(second.session && second.session->accessToken == "opaque" && !second.session->expirationTime);
+  assert(second.version == 2);
+
+  writer->clear();
+  auto cleared = reader->read();
+  assert(!cleared.session.has_value());
+  assert(cleared.version == 3);
+
+  // A reopened mapping sees the same segment.
+  assert(writer->publish(sessionFor(7)));
+  writer.reset();
+  reader.reset();
+  auto reopened = SharedSessionSegment::open(path)->read();
+  assert(reopened.session && reopened.session->accessToken == sessionFor(7).accessToken);
+  assert(reopened.version == 4);
+  removePath(path);
+}
+
+void testOversizedSessionsAreRefused() {
+  const auto path = makePath();
+  auto segment = SharedSessionSegment::open(path);
+  assert(segment->publish(sessionFor(1)));
+
+  SharedSession large = sessionFor(2);
+  large.accessToken.assign(SharedSessionSegment::kMaxAccessTokenBytes, 'a');
+  assert(segment->publish(large));
+  assert(segment->read().session->accessToken.size() == SharedSessionSegment::kMaxAccessTokenBytes);
+
+  large.accessToken.push_back('a');
+  assert(!segment->publish(large));
+  SharedSession longId = sessionFor(3);
+  longId.accountId.assign(SharedSessionSegment::kMaxAccountIdBytes + 1, 'a');
+  assert(!segment->publish(longId));
+  assert(segment->version() == 2);
+  removePath(path);
+}
+
+void testForeignFilesAreRejected() {
+  const auto path = makePath();
+  {
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    file << "not a session segment";
+  }
+  assert(throwsStorageError(path));
+  removePath(path);
+
+  assert(throwsStorageError("/nonexistent-directory/segment"));
+}
+
+void testOnlyPrivateFilesAreMapped() {
+  const auto path = makePath();
+  const auto directory = path.substr(0, path.find_last_of('/'));
+
+  // Others could swap or read the file in a directory they can write to.
+  ::chmod(directory.c_str(), 0777);
+  assert(throwsStorageError(path));
+  ::chmod(directory.c_str(), 0700);
+
+  // A symlink could point the token anywhere.
+  const auto target = directory + "/target";
+  assert(::symlink(target.c_str(), path.c_str()) == 0);
+  assert(throwsStorageError(path));
+  ::unlink(path.c_str());
+
+  SharedSessionSegment::open(path);
+  struct stat info {};
+  assert(::stat(path.c_str(), &info) == 0 && (info.st_mode & 0777) == 0600);
+  // A file left readable by others is narrowed on open.
+  ::chmod(path.c_str(), 0644);
+  SharedSessionSegment::open(path);
+  assert(::stat(path.c_str(), &info) == 0 && (info.st_mode & 0777) == 0600);
+  removePath(path);
+}
+
+void testNoTokenBytesOutliveTheirSession() {
+  const auto path = makePath();
+  auto segment = SharedSessionSegment::open(path);
+  SharedSession session;
+  session.accountId = "microsoft:bob";
+  session.accessToken = "long-secret-" + std::string(200, 'q');
+  assert(segment->publish(session));
+  assert(fileContents(path).find("long-secret-") != std::string::npos);
+
+  // A shorter token leaves no tail of the longer one behind.
+  session.accessToken = "short";
+  assert(segment->publish(session));
+  auto contents = fileContents(path);
+  assert(contents.find("qqqqqqqq") == std::string::npos);
+  assert(segment->read().session->accessToken == "short");
+
+  segment->clear();
+  contents = fileContents(path);
+  assert(contents.find("short") == std::string::npos && contents.find("microsoft:bob") == std::string::npos);
+  assert(!segment->read().session.has_value());
+  removePath(path);
+}
+
+// A forked reader hammers the segment while this process rotates the token;
+// every read must be one whole publish, and versions must never go backwards.
+void testForkedReaderNeverSeesATornToken() {
+  constexpr int kRounds = 20000;
+  const auto path = makePath();
+  auto writer = SharedSessionSegment::open(path);
+  assert(writer->publish(sessionFor(0)));
+
+  const pid_t child = ::fork();
+  assert(child >= 0);
+  if (child == 0) {
+    auto reader = SharedSessionSegment::open(path);
+    uint64_t lastVersion = 0;
+    int lastRound = 0;
+    while (true) {
+      auto read = reader->read();
+      if (read.version < lastVersion) ::_exit(2);
+      lastVersion = read.version;
+      if (!read.session) ::_exit(0);
+      if (!isConsistent(*read.session)) ::_exit(3);
+      const int round = static_cast<int>(*read.session->expirationTime - 1767225600000.0);
+      if (round < lastRound) ::_exit(4);
+      lastRound = round;
+    }
+  }
+
+  for (int round = 1; round <= kRounds; ++round) assert(writer->publish(sessionFor(round)));
+  // Signing out tells the reader to stop.
+  writer->clear();
+  int status = 0;
+  ::waitpid(child, &status, 0);
+  assert(WIFEXITED(status) && WEXITSTATUS(status) == 0);
+  removePath(path);
+}
+
+} // namespace
+
+int main() {
+  testPublishReadAndClear();
+  testOversizedSessionsAreRefused();
+  testForeignFilesAreRejected();
+  testOnlyPrivateFilesAreMapped();
+  testNoTokenBytesOutliveTheirSession();
+  testForkedReaderNeverSeesATornToken();
+
+  std::cout << "SharedSessionSegment tests passed!" << std::endl;
+  return 0;
+}
@@ -0,0 +1,113 @@
+#include <atomic>
+#include <cassert>
+#include <chrono>
+#include <condition_variable>
+#include <iostream>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include "../CancellationToken.hpp"
+#include "../TimerService.hpp"
+
+using namespace margelo::nitro::NitroAuth;
+
+namespace {
+
+void testTimersFireInDeadlineOrder() {
+  ThreadTimerService timers;
+  std::mutex mutex;
+  std::condition_variable condition;
+  std::vector<int> fired;
+
+  auto record = [&](int value) {
+    return [&, value]() {
+      std::lock_guard<std::mutex> lock(mutex);
+      fired.push_back(value);
+      condition.notify_all();
+    };
+  };
+
+  timers.schedule(30, record(3));
+  timers.schedule(10, record(1));
+  timers.schedule(20, record(2));
+
+  std::unique_lock<std::mutex> lock(mutex);
+  bool done = condition.wait_for(lock, std::chrono::seconds(5), [&]() { return fired.size() == 3; });
+  assert(done);
+  assert((fired == std::vector<int>{1, 2, 3}));
+}
+
+void testCancelledTimersNeverFire() {
+  ThreadTimerService timers;
+  std::atomic<int> calls{0};
+  std::atomic<bool> sentinel{false};
+
+  auto id = timers.schedule(10, [&]() { calls++; });
+  timers.cancel(id);
+  timers.cancel(id);
+  timers.cancel(12345);
+  timers.schedule(40, [&]() { sentinel = true; });
+
+  for (int i = 0; i < 500 && !sentinel; ++i) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  }
+  assert(sentinel);
+  assert(calls == 0);
+}
+
+void testCallbacksMayRescheduleAndThrow() {
+  ThreadTimerService timers;
+  std::atomic<bool> rescheduled{false};
+
+  timers.schedule(0, [&]() {
+    timers.schedule(0, [&]() { rescheduled = true; });
+    throw std::runtime_error("callback failure");
+  });
+
+  for (int i = 0; i < 500 && !rescheduled; ++i) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  }
+  assert(rescheduled);
+}
+
+void testCancellationTokenNotifiesOnce() {
+  auto token = CancellationToken::create();
+  int calls = 0;
+  std::string lastReason;
+
+  auto id = token->onCancelled([&](const std::string& reason) {
+    calls++;
+    lastReason = reason;
+  });
+  auto removed = token->onCancelled([&](const std::string&) { calls += 100; });
+  token->removeListener(removed);
+  assert(id != 0);
+  assert(!token->isCancelled());
+
+  token->cancel("timeout");
+  token->cancel("cancelled");
+  assert(token->isCancelled());
+  assert(token->reason() == "timeout");
+  assert(calls == 1);
+  assert(lastReason == "timeout");
+
+  auto late = token->onCancelled([&](const std::string& reason) {
+    calls++;
+    lastReason = reason;
+  });
+  assert(late == 0);
+  assert(calls == 2);
+}
+
+} // namespace
+
+int main() {
+  testTimersFireInDeadlineOrder();
+  testCancelledTimersNeverFire();
+  testCallbacksMayRescheduleAndThrow();
+  testCancellationTokenNotifiesOnce();
+
+  std::cout << "TimerService tests passed!" << std::endl;
+  return 0;
+}
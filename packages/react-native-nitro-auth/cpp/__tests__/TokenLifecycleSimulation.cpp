@@ -0,0 +1,355 @@
+#include <cassert>
+#include <cstdint>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <optional>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+#include "../HybridAuth.hpp"
+#include "../PlatformAuth.hpp"
+#include "VirtualTime.hpp"
+
+// Drives HybridAuth through days of virtual time against a simulated provider:
+// token expiry, refresh windows, refresh backoff and silent restore on app
+// restarts. Each scenario reports how many platform refreshes it caused per
+// simulated user-day and checks that an expired token is never served.
+
+using namespace margelo::nitro::NitroAuth;
+
+namespace margelo::nitro::NitroAuth {
+
+void HybridAuthSpec::loadHybridMethods() {}
+
+namespace {
+
+constexpr int64_t kSecondMs = 1000;
+constexpr int64_t kMinuteMs = 60 * kSecondMs;
+constexpr int64_t kHourMs = 60 * kMinuteMs;
+constexpr int64_t kDayMs = 24 * kHourMs;
+
+// Platform SDK model: issues tokens with a fixed lifetime, keeps the signed-in
+// user in its own keychain across app restarts, and fails refreshes during
+// outage windows or at a seeded random rate.
+struct SimulatedProvider {
+  std::shared_ptr<VirtualTime> time;
+  int64_t tokenLifetimeMs = kHourMs;
+  int64_t latencyMs = 300;
+  double failureRate = 0.0;
+  std::vector<std::pair<int64_t, int64_t>> outages;
+  std::mt19937 random{7};
+
+  std::optional<AuthUser> keychain;
+  std::unordered_map<std::string, int64_t> tokenExpiry;
+  uint64_t nextToken = 0;
+  uint64_t refreshCalls = 0;
+  uint64_t restoreCalls = 0;
+
+  std::shared_ptr<Promise<Result<AuthTokens>>> pendingRefresh;
+  std::shared_ptr<Promise<Result<std::optional<AuthUser>>>> pendingRestore;
+
+  bool isFailing(int64_t nowMs) {
+    for (const auto& [start, end] : outages) {
+      if (nowMs >= start && nowMs < end) return true;
+    }
+    return failureRate > 0 && std::uniform_real_distribution<double>(0, 1)(random) < failureRate;
+  }
+
+  AuthTokens mintTokens() {
+    AuthTokens tokens;
+    auto token = "access-" + std::to_string(nextToken++);
+    auto expiry = time->nowMs() + tokenLifetimeMs;
+    tokenExpiry[token] = expiry;
+    tokens.accessToken = token;
+    tokens.expirationTime = static_cast<double>(expiry);
+    return tokens;
+  }
+};
+
+SimulatedProvider gProvider;
+
+} // namespace
+
+std::shared_ptr<Promise<Result<AuthUser>>> PlatformAuth::login(AuthProvider provider,
+                                                               const std::optional<LoginOptions>&) {
+  auto tokens = gProvider.mintTokens();
+  AuthUser user;
+  user.provider = provider;
+  user.email = "simulated@example.com";
+  user.accessToken = tokens.accessToken;
+  user.expirationTime = tokens.expirationTime;
+  gProvider.keychain = user;
+  auto promise = Promise<Result<AuthUser>>::create();
+  promise->resolve(user);
+  return promise;
+}
+
+std::shared_ptr<Promise<Result<AuthUser>>> PlatformAuth::requestScopes(const std::vector<std::string>&) {
+  auto promise = Promise<Result<AuthUser>>::create();
+  promise->resolve(AuthErrorCode::UNSUPPORTED_PROVIDER);
+  return promise;
+}
+
+std::shared_ptr<Promise<Result<AuthTokens>>> PlatformAuth::refreshToken(const std::optional<AuthProvider>&,
+                                                                        const std::vector<std::string>&) {
+  gProvider.refreshCalls++;
+  auto promise = Promise<Result<AuthTokens>>::create();
+  gProvider.pendingRefresh = promise;
+  gProvider.time->schedule(gProvider.latencyMs, [promise]() {
+    if (!promise->isPending()) return;
+    gProvider.pendingRefresh = nullptr;
+    if (gProvider.isFailing(gProvider.time->nowMs())) {
+      promise->resolve(AuthErrorCode::NETWORK_ERROR);
+      return;
+    }
+    auto tokens = gProvider.mintTokens();
+    if (gProvider.keychain) {
+      gProvider.keychain->accessToken = tokens.accessToken;
+      gProvider.keychain->expirationTime = tokens.expirationTime;
+    }
+    promise->resolve(tokens);
+  });
+  return promise;
+}
+
+std::shared_ptr<Promise<Result<std::optional<AuthUser>>>> PlatformAuth::silentRestore() {
+  gProvider.restoreCalls++;
+  auto promise = Promise<Result<std::optional<AuthUser>>>::create();
+  gProvider.pendingRestore = promise;
+  gProvider.time->schedule(gProvider.latencyMs, [promise]() {
+    if (!promise->isPending()) return;
+    gProvider.pendingRestore = nullptr;
+    promise->resolve(gProvider.keychain);
+  });
+  return promise;
+}
+
+bool PlatformAuth::hasPlayServices() {
+  return true;
+}
+
+std::shared_ptr<Promise<Result<std::string>>> PlatformAuth::authorizeInBrowser(const std::string&, const std::string&) {
+  auto promise = Promise<Result<std::string>>::create();
+  promise->resolve(AuthErrorCode::UNSUPPORTED_PROVIDER);
+  return promise;
+}
+
+std::shared_ptr<HttpClient> PlatformAuth::httpClient() {
+  return nullptr;
+}
+
+std::string PlatformAuth::cacheDirectory() {
+  return "";
+}
+
+std::vector<std::string> PlatformAuth::discoveryAuthorities() {
+  return {};
+}
+
+void PlatformAuth::logout() {
+  gProvider.keychain = std::nullopt;
+}
+
+std::shared_ptr<Promise<Result<void>>> PlatformAuth::revokeAccess() {
+  gProvider.keychain = std::nullopt;
+  auto promise = Promise<Result<void>>::create();
+  promise->resolve(Result<void>());
+  return promise;
+}
+
+void PlatformAuth::cancel(PlatformOperation operation, const std::string& reason) {
+  const AuthError error(reason);
+  if (operation == PlatformOperation::REFRESH_TOKEN && gProvider.pendingRefresh) {
+    auto promise = std::move(gProvider.pendingRefresh);
+    if (promise->isPending()) promise->resolve(error);
+  } else if (operation == PlatformOperation::SILENT_RESTORE && gProvider.pendingRestore) {
+    auto promise = std::move(gProvider.pendingRestore);
+    if (promise->isPending()) promise->resolve(std::optional<AuthUser>());
+  }
+}
+
+} // namespace margelo::nitro::NitroAuth
+
+namespace {
+
+struct Workload {
+  int days = 30;
+  // App launches per day; each launch is a cold start followed by silentRestore.
+  int sessionsPerDay = 6;
+  int64_t sessionLengthMs = 10 * kMinuteMs;
+  // Spacing of getAccessToken calls (one per API request) while the app is open.
+  int64_t callIntervalMs = 30 * kSecondMs;
+};
+
+struct Report {
+  uint64_t calls = 0;
+  uint64_t failedCalls = 0;
+  uint64_t expiredServed = 0;
+  uint64_t refreshCalls = 0;
+  uint64_t restoreCalls = 0;
+  int days = 0;
+
+  double refreshesPerDay() const { return static_cast<double>(refreshCalls) / days; }
+};
+
+std::shared_ptr<HybridAuth> launchApp(const std::shared_ptr<VirtualTime>& time, const RefreshBackoffPolicy& policy) {
+  auto auth = std::make_shared<HybridAuth>();
+  auth->setClock(time);
+  auth->setTimerService(time);
+  auth->setRefreshBackoffPolicy(policy);
+  auto restore = auth->silentRestore();
+  while (restore->isPending()) {
+    time->advance(gProvider.latencyMs);
+  }
+  return auth;
+}
+
+void callApi(const std::shared_ptr<HybridAuth>& auth, const std::shared_ptr<VirtualTime>& time, Report& report) {
+  report.calls++;
+  auto token = auth->getAccessToken();
+  while (token->isPending()) {
+    time->advance(gProvider.latencyMs);
+  }
+  if (token->isRejected() || !token->getResult()) {
+    report.failedCalls++;
+    return;
+  }
+  auto expiry = gProvider.tokenExpiry.find(*token->getResult());
+  assert(expiry != gProvider.tokenExpiry.end());
+  if (expiry->second <= time->nowMs()) {
+    report.expiredServed++;
+  }
+}
+
+Report simulate(SimulatedProvider provider, const Workload& workload, const RefreshBackoffPolicy& policy = {}) {
+  auto time = std::make_shared<VirtualTime>();
+  gProvider = std::move(provider);
+  gProvider.time = time;
+
+  Report report;
+  report.days = workload.days;
+
+  // Sign in once; every later session is a cold start that restores the session.
+  {
+    auto auth = launchApp(time, policy);
+    auto login = auth->login(AuthProvider::GOOGLE, std::nullopt);
+    assert(login->isResolved());
+  }
+
+  // Launches are spread evenly over a 16-hour waking day.
+  const int64_t launchSpacingMs = workload.sessionsPerDay > 1
+    ? (16 * kHourMs - workload.sessionLengthMs) / (workload.sessionsPerDay - 1)
+    : 0;
+  for (int day = 0; day < workload.days; ++day) {
+    for (int session = 0; session < workload.sessionsPerDay; ++session) {
+      time->advanceTo(day * kDayMs + 7 * kHourMs + session * launchSpacingMs);
+      auto auth = launchApp(time, policy);
+      auto sessionEnd = time->nowMs() + workload.sessionLengthMs;
+      while (time->nowMs() < sessionEnd) {
+        callApi(auth, time, report);
+        time->advance(workload.callIntervalMs);
+      }
+    }
+  }
+  time->advance(kMinuteMs);
+
+  report.refreshCalls = gProvider.refreshCalls;
+  report.restoreCalls = gProvider.restoreCalls;
+  return report;
+}
+
+void print(const std::string& scenario, const Report& report) {
+  std::cout << std::fixed << std::setprecision(2) << "  " << std::left << std::setw(30) << scenario
+            << " refreshes/user-day " << std::setw(7) << report.refreshesPerDay() << " calls " << std::setw(7)
+            << report.calls << " failed " << report.failedCalls << std::endl;
+}
+
+void testSteadyStateRefreshesOncePerTokenLifetime() {
+  Workload workload;
+  auto report = simulate(SimulatedProvider{}, workload);
+  print("steady, 6 launches/day", report);
+
+  assert(report.failedCalls == 0);
+  assert(report.expiredServed == 0);
+  // Launches are ~3h apart with 1h tokens, so each launch refreshes exactly once.
+  assert(report.refreshCalls == static_cast<uint64_t>(workload.days * workload.sessionsPerDay));
+}
+
+void testAlwaysOnSessionRefreshesOncePerRefreshWindow() {
+  Workload workload;
+  workload.days = 7;
+  workload.sessionsPerDay = 1;
+  workload.sessionLengthMs = kDayMs - kHourMs;
+  workload.callIntervalMs = kMinuteMs;
+  auto report = simulate(SimulatedProvider{}, workload);
+  print("always-on, 1 call/min", report);
+
+  assert(report.failedCalls == 0);
+  assert(report.expiredServed == 0);
+  // A 1h token is refreshed 5 minutes before expiry: at most one refresh per 55 minutes.
+  auto activeMinutes = static_cast<double>(workload.sessionLengthMs) / kMinuteMs;
+  assert(report.refreshesPerDay() <= activeMinutes / 55.0 + 2.0);
+}
+
+void testFlakyNetworkNeverServesExpiredTokens() {
+  SimulatedProvider provider;
+  provider.failureRate = 0.3;
+  Workload workload;
+  workload.callIntervalMs = 5 * kSecondMs;
+  auto report = simulate(std::move(provider), workload);
+  print("30% refresh failures", report);
+
+  assert(report.expiredServed == 0);
+  assert(report.failedCalls > 0);
+  // Backoff keeps most failures local instead of turning every call into a platform refresh.
+  assert(report.refreshCalls < report.calls / 4);
+}
+
+void testDailyOutageIsAbsorbedByBackoff() {
+  Workload workload;
+  workload.days = 7;
+  workload.sessionsPerDay = 1;
+  workload.sessionLengthMs = kDayMs - kHourMs;
+  workload.callIntervalMs = 10 * kSecondMs;
+
+  auto withOutages = [&]() {
+    SimulatedProvider provider;
+    for (int day = 0; day < workload.days; ++day) {
+      provider.outages.emplace_back(day * kDayMs + 12 * kHourMs, day * kDayMs + 14 * kHourMs);
+    }
+    return provider;
+  };
+
+  auto defaults = simulate(withOutages(), workload);
+  print("2h daily outage, default", defaults);
+
+  RefreshBackoffPolicy aggressive;
+  aggressive.maxDelayMs = 10 * kSecondMs;
+  auto capped = simulate(withOutages(), workload, aggressive);
+  print("2h daily outage, 10s cap", capped);
+
+  for (const auto& report : {defaults, capped}) {
+    assert(report.expiredServed == 0);
+    assert(report.failedCalls > 0);
+  }
+  // Each 2h outage costs a bounded number of attempts: ~8 ramp-up retries plus one per 5 minutes.
+  assert(defaults.refreshesPerDay() < 26.0 + 40.0);
+  assert(capped.refreshCalls > defaults.refreshCalls);
+}
+
+} // namespace
+
+int main() {
+  std::cout << "Token lifecycle simulation:" << std::endl;
+  testSteadyStateRefreshesOncePerTokenLifetime();
+  testAlwaysOnSessionRefreshesOncePerRefreshWindow();
+  testFlakyNetworkNeverServesExpiredTokens();
+  testDailyOutageIsAbsorbedByBackoff();
+
+  std::cout << "Token lifecycle simulation passed!" << std::endl;
+  return 0;
+}
@@ -0,0 +1,61 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <unordered_map>
+#include <utility>
+#include "../AuthClock.hpp"
+#include "../TimerService.hpp"
+
+namespace margelo::nitro::NitroAuth {
+
+// Single-threaded virtual clock and timer queue. Advancing fires due timers in
+// deadline order, each at its own timestamp, so days of token lifecycle run
+// deterministically in milliseconds of real time.
+class VirtualTime final : public AuthClock, public TimerService {
+public:
+  explicit VirtualTime(int64_t startMs = 0) : _nowMs(startMs) {}
+
+  int64_t nowMs() override { return _nowMs; }
+
+  TimerId schedule(int64_t delayMs, std::function<void()> callback) override {
+    auto id = _nextId++;
+    auto deadline = _nowMs + (delayMs > 0 ? delayMs : 0);
+    _timers.emplace(std::make_pair(deadline, id), std::move(callback));
+    _deadlines.emplace(id, deadline);
+    return id;
+  }
+
+  void cancel(TimerId id) override {
+    auto deadline = _deadlines.find(id);
+    if (deadline == _deadlines.end()) return;
+    _timers.erase(std::make_pair(deadline->second, id));
+    _deadlines.erase(deadline);
+  }
+
+  void advance(int64_t deltaMs) { advanceTo(_nowMs + deltaMs); }
+
+  void advanceTo(int64_t targetMs) {
+    while (!_timers.empty() && _timers.begin()->first.first <= targetMs) {
+      auto next = _timers.begin();
+      _nowMs = std::max(_nowMs, next->first.first);
+      auto callback = std::move(next->second);
+      _deadlines.erase(next->first.second);
+      _timers.erase(next);
+      callback();
+    }
+    _nowMs = std::max(_nowMs, targetMs);
+  }
+
+  size_t pending() const { return _timers.size(); }
+
+private:
+  int64_t _nowMs;
+  std::map<std::pair<int64_t, TimerId>, std::function<void()>> _timers;
+  std::unordered_map<TimerId, int64_t> _deadlines;
+  TimerId _nextId = 1;
+};
+
+} // namespace margelo::nitro::NitroAuth
@@ -1,8 +1,22 @@
 #pragma once
+    #include <cstddef>
     #include <memory>
     #include <string>
+    #include <vector>
+    #include "JSIConverter.hpp"
 
     namespace margelo { namespace nitro {
+      // Records registrations only; tests call the methods directly.
+      class Prototype {
+      public:
+        template <typename Derived>
+        void registerRawHybridMethod(std::string name, size_t,
+                                     jsi::Value (Derived::*)(jsi::Runtime&, const jsi::Value&, const jsi::Value*, size_t)) {
+          rawMethods.push_back(std::move(name));
+        }
+        std::vector<std::string> rawMethods;
+      };
+
       class HybridObject : public std::enable_shared_from_this<HybridObject> {
       public:
         explicit HybridObject(const char* name) : _name(name) {}
@@ -10,10 +24,27 @@
         HybridObject(const HybridObject&) = delete;
         HybridObject& operator=(const HybridObject&) = delete;
 
+        const Prototype& prototype() const { return _prototype; }
+        // Nitro loads the prototype the first time the object reaches JS.
+        jsi::Value toObject(jsi::Runtime& runtime) {
+          if (!_loaded) {
+            _loaded = true;
+            loadHybridMethods();
+          }
+          return jsi::Object(runtime);
+        }
+
       protected:
         virtual void loadHybridMethods() {}
 
+        template <typename Derived>
+        void registerHybrids(Derived*, void (*registerFunc)(Prototype&)) {
+          registerFunc(_prototype);
+        }
+
       private:
         const char* _name;
+        Prototype _prototype;
+        bool _loaded = false;
       };
     }}
\ No newline at end of file
@@ -1,46 +1,259 @@
 #pragma once
-    #include <string>
-    #include <vector>
-    #include <optional>
     #include <cstdint>
+    #include <memory>
+    #include <optional>
     #include <stdexcept>
-    
-    namespace facebook { 
-      namespace jsi { 
-        class Runtime {}; 
+    #include <string>
+    #include <utility>
+    #include <vector>
+
+    // A small in-memory stand-in for JSI: strings and objects live on the heap
+    // like JS values do, so converters and host objects can be tested and their
+    // relative costs benchmarked without a JS engine.
+    namespace facebook {
+      namespace jsi {
+        class Runtime {};
         class Value;
+        class HostObject;
+
+        class PropNameID {
+        public:
+          static PropNameID forAscii(Runtime&, const char* name) { return PropNameID(name); }
+          static PropNameID forUtf8(Runtime&, const std::string& name) { return PropNameID(name); }
+          std::string utf8(Runtime&) const { return _name; }
+          const std::string& name() const { return _name; }
+
+        private:
+          explicit PropNameID(std::string name) : _name(std::move(name)) {}
+          std::string _name;
+        };
+
+        class String {
+        public:
+          static String createFromUtf8(Runtime&, const std::string& value) {
+            return String(std::make_shared<const std::string>(value));
+          }
+          std::string utf8(Runtime&) const { return *_value; }
+
+        private:
+          friend class Value;
+          explicit String(std::shared_ptr<const std::string> value) : _value(std::move(value)) {}
+          std::shared_ptr<const std::string> _value;
+        };
+
+        struct ObjectData;
+
         class Object {
         public:
-          Object() {}
-          Object(Runtime&) {}
-          Value getProperty(Runtime&, const char*);
-          void setProperty(Runtime&, const char*, Value);
+          Object() : _data(std::make_shared<ObjectData>()) {}
+          Object(Runtime&) : Object() {}
+
+          static Object createFromHostObject(Runtime&, std::shared_ptr<HostObject> host);
+
+          Value getProperty(Runtime& runtime, const char* name) const;
+          Value getProperty(Runtime& runtime, const PropNameID& name) const;
+          void setProperty(Runtime& runtime, const char* name, Value value);
+          void setProperty(Runtime& runtime, const PropNameID& name, Value value);
+          std::vector<PropNameID> getPropertyNames(Runtime& runtime) const;
+
+          bool isHostObject(Runtime&) const;
+          template <typename T>
+          std::shared_ptr<T> getHostObject(Runtime&) const;
+
+        private:
+          friend class Value;
+          explicit Object(std::shared_ptr<ObjectData> data) : _data(std::move(data)) {}
+          std::shared_ptr<ObjectData> _data;
         };
+
         class Value {
         public:
-          Value() {}
-          Value(const Object&) {}
-          Value(const char*) {}
-          bool isString() const { return true; }
-          bool isObject() const { return true; }
-          Object asObject(Runtime&) const { return Object(); }
-          Object getObject(Runtime&) const { return Object(); }
-        };
-        inline Value Object::getProperty(Runtime&, const char*) { return Value(); }
-        inline void Object::setProperty(Runtime&, const char*, Value) {}
+          Value() = default;
+          Value(bool value) : _kind(Kind::BOOL), _number(value ? 1 : 0) {}
+          Value(double value) : _kind(Kind::NUMBER), _number(value) {}
+          Value(int value) : _kind(Kind::NUMBER), _number(value) {}
+          Value(const Object& object) : _kind(Kind::OBJECT), _object(object._data) {}
+          Value(const String& string) : _kind(Kind::STRING), _string(string._value) {}
+          Value(const char* string) : Value(String(std::make_shared<const std::string>(string))) {}
+          Value(Runtime&, const Value& other) : Value(other) {}
+
+          static Value undefined() { return Value(); }
+          static Value null() {
+            Value value;
+            value._kind = Kind::NULL_VALUE;
+            return value;
+          }
+
+          bool isUndefined() const { return _kind == Kind::UNDEFINED; }
+          bool isNull() const { return _kind == Kind::NULL_VALUE; }
+          bool isBool() const { return _kind == Kind::BOOL; }
+          bool isNumber() const { return _kind == Kind::NUMBER; }
+          bool isString() const { return _kind == Kind::STRING; }
+          bool isObject() const { return _kind == Kind::OBJECT; }
+
+          bool getBool() const { return _number != 0; }
+          double getNumber() const { return _number; }
+          String getString(Runtime&) const { return String(_string); }
+          // Non-objects read as an empty object instead of throwing, so targets
+          // built without exceptions can include this.
+          Object asObject(Runtime&) const { return _object ? Object(_object) : Object(); }
+          Object getObject(Runtime& runtime) const { return asObject(runtime); }
+
+        private:
+          enum class Kind { UNDEFINED, NULL_VALUE, BOOL, NUMBER, STRING, OBJECT };
+          Kind _kind = Kind::UNDEFINED;
+          double _number = 0;
+          std::shared_ptr<const std::string> _string;
+          std::shared_ptr<ObjectData> _object;
+        };
+
+        class JSError : public std::runtime_error {
+        public:
+          JSError(Runtime&, std::string message) : std::runtime_error(message) {}
+        };
+
+        class HostObject {
+        public:
+          virtual ~HostObject() = default;
+          virtual Value get(Runtime&, const PropNameID&) { return Value(); }
+          // JSI throws a TypeError here; the mock ignores the write.
+          virtual void set(Runtime&, const PropNameID&, const Value&) {}
+          virtual std::vector<PropNameID> getPropertyNames(Runtime&) { return {}; }
+        };
+
+        struct ObjectData {
+          std::vector<std::pair<std::string, Value>> properties;
+          std::shared_ptr<HostObject> host;
+        };
+
+        inline Object Object::createFromHostObject(Runtime&, std::shared_ptr<HostObject> host) {
+          auto data = std::make_shared<ObjectData>();
+          data->host = std::move(host);
+          return Object(std::move(data));
+        }
+
+        inline Value Object::getProperty(Runtime& runtime, const PropNameID& name) const {
+          if (_data->host) return _data->host->get(runtime, name);
+          for (const auto& [key, value] : _data->properties) {
+            if (key == name.name()) return value;
+          }
+          return Value();
+        }
+
+        inline Value Object::getProperty(Runtime& runtime, const char* name) const {
+          return getProperty(runtime, PropNameID::forAscii(runtime, name));
+        }
+
+        inline void Object::setProperty(Runtime& runtime, const PropNameID& name, Value value) {
+          if (_data->host) {
+            _data->host->set(runtime, name, value);
+            return;
+          }
+          for (auto& [key, existing] : _data->properties) {
+            if (key == name.name()) {
+              existing = std::move(value);
+              return;
+            }
+          }
+          _data->properties.emplace_back(name.name(), std::move(value));
+        }
+
+        inline void Object::setProperty(Runtime& runtime, const char* name, Value value) {
+          setProperty(runtime, PropNameID::forAscii(runtime, name), std::move(value));
+        }
+
+        inline std::vector<PropNameID> Object::getPropertyNames(Runtime& runtime) const {
+          if (_data->host) return _data->host->getPropertyNames(runtime);
+          std::vector<PropNameID> names;
+          for (const auto& [key, value] : _data->properties) names.push_back(PropNameID::forUtf8(runtime, key));
+          return names;
+        }
+
+        inline bool Object::isHostObject(Runtime&) const { return _data->host != nullptr; }
+
+        template <typename T>
+        std::shared_ptr<T> Object::getHostObject(Runtime&) const {
+          return std::dynamic_pointer_cast<T>(_data->host);
+        }
       }
     }
 
-    namespace margelo { 
-      namespace nitro { 
+    namespace margelo {
+      namespace nitro {
         namespace jsi = facebook::jsi;
 
-        template<typename T> struct JSIConverter {
+        template <typename T, typename Enable = void>
+        struct JSIConverter {
           static T fromJSI(jsi::Runtime&, const jsi::Value&) { return T(); }
           static jsi::Value toJSI(jsi::Runtime&, const T&) { return jsi::Value(); }
           static bool canConvert(jsi::Runtime&, const jsi::Value&) { return true; }
         };
-        
-        inline bool isPlainObject(jsi::Runtime&, const jsi::Object&) { return true; }
+
+        template <>
+        struct JSIConverter<std::string> {
+          static std::string fromJSI(jsi::Runtime& runtime, const jsi::Value& value) {
+            return value.isString() ? value.getString(runtime).utf8(runtime) : std::string();
+          }
+          static jsi::Value toJSI(jsi::Runtime& runtime, const std::string& value) {
+            return jsi::String::createFromUtf8(runtime, value);
+          }
+          static bool canConvert(jsi::Runtime&, const jsi::Value& value) { return value.isString(); }
+        };
+
+        template <>
+        struct JSIConverter<double> {
+          static double fromJSI(jsi::Runtime&, const jsi::Value& value) { return value.getNumber(); }
+          static jsi::Value toJSI(jsi::Runtime&, double value) { return jsi::Value(value); }
+          static bool canConvert(jsi::Runtime&, const jsi::Value& value) { return value.isNumber(); }
+        };
+
+        template <>
+        struct JSIConverter<bool> {
+          static bool fromJSI(jsi::Runtime&, const jsi::Value& value) { return value.getBool(); }
+          static jsi::Value toJSI(jsi::Runtime&, bool value) { return jsi::Value(value); }
+          static bool canConvert(jsi::Runtime&, const jsi::Value& value) { return value.isBool(); }
+        };
+
+        template <typename T>
+        struct JSIConverter<std::optional<T>> {
+          static std::optional<T> fromJSI(jsi::Runtime& runtime, const jsi::Value& value) {
+            if (value.isUndefined() || value.isNull()) return std::nullopt;
+            return JSIConverter<T>::fromJSI(runtime, value);
+          }
+          static jsi::Value toJSI(jsi::Runtime& runtime, const std::optional<T>& value) {
+            return value ? JSIConverter<T>::toJSI(runtime, *value) : jsi::Value::undefined();
+          }
+          static bool canConvert(jsi::Runtime& runtime, const jsi::Value& value) {
+            return value.isUndefined() || value.isNull() || JSIConverter<T>::canConvert(runtime, value);
+          }
+        };
+
+        // Arrays are plain objects with index keys and a length.
+        template <typename T>
+        struct JSIConverter<std::vector<T>> {
+          static std::vector<T> fromJSI(jsi::Runtime& runtime, const jsi::Value& value) {
+            auto object = value.asObject(runtime);
+            const auto length = static_cast<size_t>(object.getProperty(runtime, "length").getNumber());
+            std::vector<T> items;
+            items.reserve(length);
+            for (size_t i = 0; i < length; i++) {
+              items.push_back(JSIConverter<T>::fromJSI(runtime, object.getProperty(runtime, std::to_string(i).c_str())));
+            }
+            return items;
+          }
+          static jsi::Value toJSI(jsi::Runtime& runtime, const std::vector<T>& items) {
+            jsi::Object array(runtime);
+            for (size_t i = 0; i < items.size(); i++) {
+              array.setProperty(runtime, std::to_string(i).c_str(), JSIConverter<T>::toJSI(runtime, items[i]));
+            }
+            array.setProperty(runtime, "length", jsi::Value(static_cast<double>(items.size())));
+            return array;
+          }
+          static bool canConvert(jsi::Runtime&, const jsi::Value& value) { return value.isObject(); }
+        };
+
+        inline bool isPlainObject(jsi::Runtime& runtime, const jsi::Object& object) {
+          return !object.isHostObject(runtime);
+        }
       }
     }
\ No newline at end of file
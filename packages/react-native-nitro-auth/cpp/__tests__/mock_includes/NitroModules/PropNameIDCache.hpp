@@ -1,7 +1,15 @@
 #pragma once
-    namespace facebook { namespace jsi { class Runtime; } }
+    #include <unordered_map>
+    #include "JSIConverter.hpp"
+
     namespace margelo { namespace nitro {
+      // Like Nitro's: one PropNameID per name, created on first use.
       struct PropNameIDCache {
-        static inline const char* get(facebook::jsi::Runtime&, const char* name) { return name; }
+        static inline const jsi::PropNameID& get(jsi::Runtime& runtime, const char* name) {
+          static std::unordered_map<const char*, jsi::PropNameID> cache;
+          auto it = cache.find(name);
+          if (it == cache.end()) it = cache.emplace(name, jsi::PropNameID::forAscii(runtime, name)).first;
+          return it->second;
+        }
       };
     }}
\ No newline at end of file
@@ -11,6 +11,7 @@ public class AuthAdapter: NSObject {
   private static var inMemoryMicrosoftScopes: [String] = defaultMicrosoftScopes
   private static var inMemoryGoogleServerAuthCode: String?
   private static var activeMicrosoftWebAuthSession: ASWebAuthenticationSession?
+  private static var activeBrowserAuthSession: ASWebAuthenticationSession?
   private static var activeAppleSignInController: ASAuthorizationController?
   private static let tokenStoreLock = NSLock()
   private static let interactiveAuthLock = NSLock()
@@ -270,6 +271,65 @@ public class AuthAdapter: NSObject {
     }
   }
   
+  // Generic OIDC: the core builds the authorization URL and handles the redirect;
+  // this only presents it and hands back the callback URL.
+  @objc
+  public static func openAuthorizationSession(
+    url: String,
+    redirectUri: String,
+    completion: @escaping (String?, String?) -> Void
+  ) {
+    guard let authUrl = URL(string: url),
+          let callbackScheme = URL(string: redirectUri)?.scheme else {
+      completion(nil, "configuration_error")
+      return
+    }
+
+    DispatchQueue.main.async {
+      guard self.activeBrowserAuthSession == nil else {
+        completion(nil, "operation_in_progress")
+        return
+      }
+
+      let completeAndClearSession = { (callbackUrl: String?, error: String?) in
+        self.activeBrowserAuthSession = nil
+        completion(callbackUrl, error)
+      }
+
+      let session = ASWebAuthenticationSession(url: authUrl, callbackURLScheme: callbackScheme) { callbackURL, error in
+        if let error = error {
+          let nsError = error as NSError
+          if nsError.code == ASWebAuthenticationSessionError.canceledLogin.rawValue {
+            completeAndClearSession(nil, "cancelled")
+          } else if nsError.domain.lowercased().contains("network") || nsError.code == NSURLErrorNotConnectedToInternet {
+            completeAndClearSession(nil, "network_error")
+          } else {
+            completeAndClearSession(nil, "unknown")
+          }
+          return
+        }
+        guard let callbackURL = callbackURL else {
+          completeAndClearSession(nil, "unknown")
+          return
+        }
+        completeAndClearSession(callbackURL.absoluteString, nil)
+      }
+
+      guard let window = activeWindow() else {
+        completeAndClearSession(nil, "configuration_error")
+        return
+      }
+      let contextProvider = WebAuthContextProvider(anchor: window)
+      session.presentationContextProvider = contextProvider
+      objc_setAssociatedObject(session, &contextProviderHandle, contextProvider, .OBJC_ASSOCIATION_RETAIN_NONATOMIC)
+      session.prefersEphemeralWebBrowserSession = false
+      self.activeBrowserAuthSession = session
+      if !session.start() {
+        completeAndClearSession(nil, "unknown")
+      }
+    }
+  }
+
   private static func generateCodeVerifier() -> String? {
     var bytes = [UInt8](repeating: 0, count: 32)
     guard SecRandomCopyBytes(kSecRandomDefault, bytes.count, &bytes) == errSecSuccess else {
@@ -532,7 +592,26 @@ public class AuthAdapter: NSObject {
 
   @objc
   public static func refreshToken(completion: @escaping (NSDictionary?, String?) -> Void) {
-    if let currentUser = GIDSignIn.sharedInstance.currentUser {
+    refreshToken(provider: nil, scopes: nil, completion: completion)
+  }
+
+  // A provider pins the refresh to that account's session; nil keeps the Google-then-Microsoft order.
+  // Explicit scopes request a resource token, which only the Microsoft token endpoint issues.
+  @objc
+  public static func refreshToken(provider: String?, scopes: [String]?, completion: @escaping (NSDictionary?, String?) -> Void) {
+    if provider == "apple" {
+      completion(nil, "unsupported_provider")
+      return
+    }
+    if let scopes = scopes {
+      if provider == "google" {
+        completion(nil, "unsupported_provider")
+        return
+      }
+      tryMicrosoftRefreshForTokenRefresh(resourceScopes: scopes, completion: completion)
+      return
+    }
+    if provider != "microsoft", let currentUser = GIDSignIn.sharedInstance.currentUser {
       currentUser.refreshTokensIfNeeded { user, error in
         if let error = error {
           completion(nil, mapError(error))
@@ -552,9 +631,29 @@ public class AuthAdapter: NSObject {
       }
       return
     }
+    if provider == "google" {
+      completion(nil, "not_signed_in")
+      return
+    }
     tryMicrosoftRefreshForTokenRefresh(completion: completion)
   }
 
+  @objc
+  public static func discoveryAuthorities() -> [String] {
+    var authorities: [String] = []
+    if let clientId = Bundle.main.object(forInfoDictionaryKey: "GIDClientID") as? String, !clientId.isEmpty {
+      authorities.append("https://accounts.google.com")
+    }
+    if let clientId = Bundle.main.object(forInfoDictionaryKey: "MSALClientID") as? String, !clientId.isEmpty {
+      let tenant = Bundle.main.object(forInfoDictionaryKey: "MSALTenant") as? String ?? "common"
+      let b2cDomain = Bundle.main.object(forInfoDictionaryKey: "MSALB2cDomain") as? String
+      if let authBaseUrl = getMicrosoftAuthBaseUrl(tenant: tenant, b2cDomain: b2cDomain) {
+        authorities.append("\(authBaseUrl)v2.0")
+      }
+    }
+    return authorities
+  }
+
   @objc
   public static func initialize(completion: @escaping (NSDictionary?) -> Void) {
     if Bundle.main.object(forInfoDictionaryKey: "GIDClientID") != nil {
@@ -612,11 +711,16 @@ public class AuthAdapter: NSObject {
     request.httpMethod = "POST"
     request.setValue("application/x-www-form-urlencoded", forHTTPHeaderField: "Content-Type")
 
-    let bodyParams = [
+    var bodyParams = [
       "client_id": clientId,
       "grant_type": "refresh_token",
       "refresh_token": refreshToken
     ]
+    if let resourceScopes = resourceScopes {
+      var scopes = resourceScopes
+      if !scopes.contains("offline_access") { scopes.append("offline_access") }
+      bodyParams["scope"] = scopes.joined(separator: " ")
+    }
     
     request.httpBody = formUrlEncodedBody(bodyParams)
     
@@ -674,7 +778,10 @@ public class AuthAdapter: NSObject {
     }.resume()
   }
 
-  private static func tryMicrosoftRefreshForTokenRefresh(completion: @escaping (NSDictionary?, String?) -> Void) {
+  private static func tryMicrosoftRefreshForTokenRefresh(
+    resourceScopes: [String]? = nil,
+    completion: @escaping (NSDictionary?, String?) -> Void
+  ) {
     tokenStoreLock.lock()
     let refreshToken = inMemoryMicrosoftRefreshToken
     tokenStoreLock.unlock()
@@ -735,75 +842,36 @@ public class AuthAdapter: NSObject {
           inMemoryMicrosoftRefreshToken = newRefreshToken
         }
         tokenStoreLock.unlock()
-        let tokensData: [String: Any] = [
+        var tokensData: [String: Any] = [
           "accessToken": accessToken,
           "idToken": idToken,
           "expirationTime": expirationTime,
           "underlyingError": ""
         ]
+        // Rotated by the token endpoint; the core swaps it into the session.
+        if !newRefreshToken.isEmpty {
+          tokensData["refreshToken"] = newRefreshToken
+        }
         completion(tokensData as NSDictionary, nil)
       }
     }.resume()
   }
   
+  // Validated and cached by the shared native implementation (cpp/MicrosoftAuthority).
   private static func getMicrosoftAuthBaseUrl(tenant: String, b2cDomain: String?) -> String? {
-    let trimmedTenant = tenant.trimmingCharacters(in: .whitespacesAndNewlines)
-
-    if let domain = b2cDomain?.trimmingCharacters(in: .whitespacesAndNewlines), !domain.isEmpty {
-      let normalizedDomain = domain.lowercased()
-      guard isValidMicrosoftDomain(normalizedDomain) else { return nil }
-      guard let b2cTenantPath = getMicrosoftB2cTenantPath(trimmedTenant, domain: normalizedDomain) else { return nil }
-      return "https://\(normalizedDomain)/\(b2cTenantPath)/"
-    }
-    guard isValidMicrosoftTenant(trimmedTenant) else { return nil }
-    return "https://login.microsoftonline.com/\(trimmedTenant)/"
-  }
-
-  private static func isValidMicrosoftTenant(_ value: String) -> Bool {
-    return value.range(
-      of: #"^(common|organizations|consumers|[0-9a-fA-F]{8}-[0-9a-fA-F]{4}-[0-9a-fA-F]{4}-[0-9a-fA-F]{4}-[0-9a-fA-F]{12}|[A-Za-z0-9][A-Za-z0-9._-]{0,127})$"#,
-      options: .regularExpression
-    ) != nil
+    return NitroAuthMicrosoftAuthority.authBaseUrl(forTenant: tenant, b2cDomain: b2cDomain)
   }
 
-  private static func getMicrosoftB2cTenantPath(_ value: String, domain: String) -> String? {
-    if isValidMicrosoftB2cTenantPath(value) {
-      return value
+  @objc
+  public static func cancelInteractiveAuth() {
+    DispatchQueue.main.async {
+      self.activeMicrosoftWebAuthSession?.cancel()
+      self.activeMicrosoftWebAuthSession = nil
+      self.activeBrowserAuthSession?.cancel()
+      self.activeBrowserAuthSession = nil
+      self.activeAppleSignInController?.cancel()
     }
-    guard isValidMicrosoftB2cPolicy(value),
-          let tenantName = getMicrosoftB2cTenantName(domain) else { return nil }
-    return "\(tenantName).onmicrosoft.com/\(value)"
-  }
-
-  private static func getMicrosoftB2cTenantName(_ domain: String) -> String? {
-    let suffix = ".b2clogin.com"
-    guard domain.hasSuffix(suffix) else { return nil }
-    let tenantName = String(domain.dropLast(suffix.count))
-    return tenantName.range(
-      of: #"^[A-Za-z0-9](?:[A-Za-z0-9-]{0,61}[A-Za-z0-9])?$"#,
-      options: .regularExpression
-    ) != nil ? tenantName : nil
-  }
-
-  private static func isValidMicrosoftB2cTenantPath(_ value: String) -> Bool {
-    return value.range(
-      of: #"^([0-9a-fA-F]{8}-[0-9a-fA-F]{4}-[0-9a-fA-F]{4}-[0-9a-fA-F]{4}-[0-9a-fA-F]{12}|[A-Za-z0-9][A-Za-z0-9._-]{0,127})/[A-Za-z0-9][A-Za-z0-9._-]{0,127}$"#,
-      options: .regularExpression
-    ) != nil
-  }
-
-  private static func isValidMicrosoftB2cPolicy(_ value: String) -> Bool {
-    return value.range(
-      of: #"^[A-Za-z0-9][A-Za-z0-9._-]{0,127}$"#,
-      options: .regularExpression
-    ) != nil
-  }
-
-  private static func isValidMicrosoftDomain(_ value: String) -> Bool {
-    return value.range(
-      of: #"^(?=.{1,253}$)(?:[A-Za-z0-9](?:[A-Za-z0-9-]{0,61}[A-Za-z0-9])?\.)+[A-Za-z]{2,63}$"#,
-      options: .regularExpression
-    ) != nil
+    finishInteractiveAuth()
   }
 
   @objc
@@ -812,6 +880,8 @@ public class AuthAdapter: NSObject {
     DispatchQueue.main.async {
       self.activeMicrosoftWebAuthSession?.cancel()
       self.activeMicrosoftWebAuthSession = nil
+      self.activeBrowserAuthSession?.cancel()
+      self.activeBrowserAuthSession = nil
     }
     finishInteractiveAuth()
     tokenStoreLock.lock()
@@ -0,0 +1,12 @@
+#import <Foundation/Foundation.h>
+
+NS_ASSUME_NONNULL_BEGIN
+
+// Swift entry point to the shared C++ Microsoft authority validator (cpp/MicrosoftAuthority).
+@interface NitroAuthMicrosoftAuthority : NSObject
+
++ (nullable NSString*)authBaseUrlForTenant:(NSString*)tenant b2cDomain:(nullable NSString*)b2cDomain;
+
+@end
+
+NS_ASSUME_NONNULL_END
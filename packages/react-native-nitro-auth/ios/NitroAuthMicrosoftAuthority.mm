@@ -0,0 +1,15 @@
+#import "NitroAuthMicrosoftAuthority.h"
+#include "MicrosoftAuthority.hpp"
+
+using margelo::nitro::NitroAuth::MicrosoftAuthority;
+
+@implementation NitroAuthMicrosoftAuthority
+
++ (nullable NSString*)authBaseUrlForTenant:(NSString*)tenant b2cDomain:(nullable NSString*)b2cDomain {
+  const char* tenantChars = tenant.UTF8String;
+  const char* domainChars = b2cDomain.UTF8String;
+  auto url = MicrosoftAuthority::authBaseUrl(tenantChars ? tenantChars : "", domainChars ? domainChars : "");
+  return url ? [NSString stringWithUTF8String:url->c_str()] : nil;
+}
+
+@end
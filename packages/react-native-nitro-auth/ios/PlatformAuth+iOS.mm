@@ -11,8 +11,11 @@
 #import "react_native_nitro_auth-Swift.h"
 #endif
 
+#include "AuthResult.hpp"
+#include "HttpClient.hpp"
 #include "LoginOptions.hpp"
 #include "MicrosoftPrompt.hpp"
+#include <mutex>
 
 namespace margelo::nitro::NitroAuth {
  
@@ -23,6 +26,38 @@ namespace margelo::nitro::NitroAuth {
      return value;
  }
 
+ static std::mutex gPendingMutex;
+ static std::shared_ptr<Promise<Result<AuthUser>>> gPendingLogin;
+ static std::shared_ptr<Promise<Result<AuthUser>>> gPendingScopes;
+ static std::shared_ptr<Promise<Result<AuthTokens>>> gPendingRefresh;
+ static std::shared_ptr<Promise<Result<std::optional<AuthUser>>>> gPendingRestore;
+ static std::shared_ptr<Promise<Result<std::string>>> gPendingBrowser;
+
+ template <typename TValue>
+ bool claimPendingSlot(std::shared_ptr<Promise<TValue>>& slot, const std::shared_ptr<Promise<TValue>>& promise) {
+     std::lock_guard<std::mutex> lock(gPendingMutex);
+     if (slot) return false;
+     slot = promise;
+     return true;
+ }
+
+ // Returns false when the operation was cancelled and the adapter result must be dropped.
+ template <typename TValue>
+ bool releasePendingSlot(std::shared_ptr<Promise<TValue>>& slot, const std::shared_ptr<Promise<TValue>>& promise) {
+     std::lock_guard<std::mutex> lock(gPendingMutex);
+     if (slot != promise) return false;
+     slot = nullptr;
+     return true;
+ }
+
+ template <typename TValue>
+ std::shared_ptr<Promise<TValue>> takePendingSlot(std::shared_ptr<Promise<TValue>>& slot) {
+     std::lock_guard<std::mutex> lock(gPendingMutex);
+     auto promise = std::move(slot);
+     slot = nullptr;
+     return promise;
+ }
+
  inline std::optional<std::vector<std::string>> nsArrayToStd(NSArray<NSString*>* _Nullable nsArray) {
      if (nsArray == nil || nsArray.count == 0) return std::nullopt;
 
@@ -37,13 +72,23 @@ namespace margelo::nitro::NitroAuth {
      return values;
  }
 
-std::shared_ptr<Promise<AuthUser>> PlatformAuth::login(AuthProvider provider, const std::optional<LoginOptions>& options) {
-    auto promise = Promise<AuthUser>::create();
+std::shared_ptr<Promise<Result<AuthUser>>> PlatformAuth::login(AuthProvider provider, const std::optional<LoginOptions>& options) {
+    auto promise = Promise<Result<AuthUser>>::create();
+    if (provider == AuthProvider::OIDC) {
+        // Generic OIDC runs in the core through authorizeInBrowser().
+        promise->resolve(AuthErrorCode::UNSUPPORTED_PROVIDER);
+        return promise;
+    }
+    if (!claimPendingSlot(gPendingLogin, promise)) {
+        promise->resolve(AuthErrorCode::OPERATION_IN_PROGRESS);
+        return promise;
+    }
     NSString* providerStr;
     switch (provider) {
         case AuthProvider::GOOGLE: providerStr = @"google"; break;
         case AuthProvider::APPLE: providerStr = @"apple"; break;
         case AuthProvider::MICROSOFT: providerStr = @"microsoft"; break;
+        case AuthProvider::OIDC: break;
     }
     
     NSMutableArray* scopesArray = [NSMutableArray array];
@@ -96,12 +141,13 @@ std::shared_ptr<Promise<AuthUser>> PlatformAuth::login(AuthProvider provider, co
     }
     
     [AuthAdapter loginWithProvider:providerStr scopes:scopesArray loginHint:hintStr nonce:nonceStr useSheet:useSheet forceAccountPicker:forceAccountPicker tenant:tenantStr prompt:promptStr hostedDomain:hostedDomainStr openIDRealm:openIDRealmStr completion:^(NSDictionary* _Nullable data, NSString* _Nullable error) {
+        if (!releasePendingSlot(gPendingLogin, promise)) return;
         if (error != nil) {
-            promise->reject(std::make_exception_ptr(std::runtime_error([error UTF8String])));
+            promise->resolve(AuthError([error UTF8String]));
             return;
         }
         if (data == nil) {
-            promise->reject(std::make_exception_ptr(std::runtime_error("Login cancelled or failed")));
+            promise->resolve(AuthError("Login cancelled or failed"));
             return;
         }
         
@@ -126,18 +172,23 @@ std::shared_ptr<Promise<AuthUser>> PlatformAuth::login(AuthProvider provider, co
     return promise;
 }
 
-std::shared_ptr<Promise<AuthUser>> PlatformAuth::requestScopes(const std::vector<std::string>& scopes) {
-    auto promise = Promise<AuthUser>::create();
+std::shared_ptr<Promise<Result<AuthUser>>> PlatformAuth::requestScopes(const std::vector<std::string>& scopes) {
+    auto promise = Promise<Result<AuthUser>>::create();
+    if (!claimPendingSlot(gPendingScopes, promise)) {
+        promise->resolve(AuthErrorCode::OPERATION_IN_PROGRESS);
+        return promise;
+    }
     NSMutableArray* scopesArray = [NSMutableArray arrayWithCapacity:scopes.size()];
     for (const auto& scope : scopes) [scopesArray addObject:[NSString stringWithUTF8String:scope.c_str()]];
     
     [AuthAdapter addScopesWithScopes:scopesArray completion:^(NSDictionary* _Nullable data, NSString* _Nullable error) {
+        if (!releasePendingSlot(gPendingScopes, promise)) return;
         if (error != nil) {
-            promise->reject(std::make_exception_ptr(std::runtime_error([error UTF8String])));
+            promise->resolve(AuthError([error UTF8String]));
             return;
         }
         if (data == nil) {
-            promise->reject(std::make_exception_ptr(std::runtime_error("Request scopes failed")));
+            promise->resolve(AuthError("Request scopes failed"));
             return;
         }
         
@@ -168,27 +219,59 @@ std::shared_ptr<Promise<AuthUser>> PlatformAuth::requestScopes(const std::vector
     return promise;
 }
 
-std::shared_ptr<Promise<AuthTokens>> PlatformAuth::refreshToken() {
-    auto promise = Promise<AuthTokens>::create();
-    [AuthAdapter refreshTokenWithCompletion:^(NSDictionary* _Nullable data, NSString* _Nullable error) {
+std::shared_ptr<Promise<Result<AuthTokens>>> PlatformAuth::refreshToken(const std::optional<AuthProvider>& provider,
+                                                                        const std::vector<std::string>& scopes) {
+    auto promise = Promise<Result<AuthTokens>>::create();
+    if (provider == AuthProvider::OIDC) {
+        promise->resolve(AuthErrorCode::UNSUPPORTED_PROVIDER);
+        return promise;
+    }
+    if (!claimPendingSlot(gPendingRefresh, promise)) {
+        promise->resolve(AuthErrorCode::OPERATION_IN_PROGRESS);
+        return promise;
+    }
+    NSString* providerStr = nil;
+    if (provider) {
+        switch (*provider) {
+            case AuthProvider::GOOGLE: providerStr = @"google"; break;
+            case AuthProvider::APPLE: providerStr = @"apple"; break;
+            case AuthProvider::MICROSOFT: providerStr = @"microsoft"; break;
+            case AuthProvider::OIDC: break;
+        }
+    }
+    NSMutableArray* scopesArray = nil;
+    if (!scopes.empty()) {
+        scopesArray = [NSMutableArray arrayWithCapacity:scopes.size()];
+        for (const auto& scope : scopes) {
+            [scopesArray addObject:[NSString stringWithUTF8String:scope.c_str()]];
+        }
+    }
+    [AuthAdapter refreshTokenWithProvider:providerStr scopes:scopesArray completion:^(NSDictionary* _Nullable data, NSString* _Nullable error) {
+        if (!releasePendingSlot(gPendingRefresh, promise)) return;
         if (error != nil) {
-            promise->reject(std::make_exception_ptr(std::runtime_error([error UTF8String])));
+            promise->resolve(AuthError([error UTF8String]));
             return;
         }
         AuthTokens tokens;
         if ([data objectForKey:@"accessToken"]) tokens.accessToken = nsToStd([data objectForKey:@"accessToken"]);
         if ([data objectForKey:@"idToken"]) tokens.idToken = nsToStd([data objectForKey:@"idToken"]);
+        if ([data objectForKey:@"refreshToken"]) tokens.refreshToken = nsToStd([data objectForKey:@"refreshToken"]);
         if ([data objectForKey:@"expirationTime"]) tokens.expirationTime = [[data objectForKey:@"expirationTime"] doubleValue];
         promise->resolve(tokens);
     }];
     return promise;
 }
 
-std::shared_ptr<Promise<std::optional<AuthUser>>> PlatformAuth::silentRestore() {
-    auto promise = Promise<std::optional<AuthUser>>::create();
+std::shared_ptr<Promise<Result<std::optional<AuthUser>>>> PlatformAuth::silentRestore() {
+    auto promise = Promise<Result<std::optional<AuthUser>>>::create();
+    if (!claimPendingSlot(gPendingRestore, promise)) {
+        promise->resolve(AuthErrorCode::OPERATION_IN_PROGRESS);
+        return promise;
+    }
     [AuthAdapter initializeWithCompletion:^(NSDictionary* _Nullable data) {
+        if (!releasePendingSlot(gPendingRestore, promise)) return;
         if (data == nil) {
-            promise->resolve(std::nullopt);
+            promise->resolve(std::optional<AuthUser>());
             return;
         }
         AuthUser user;
@@ -213,7 +296,7 @@ std::shared_ptr<Promise<std::optional<AuthUser>>> PlatformAuth::silentRestore()
         if ([data objectForKey:@"scopes"]) user.scopes = nsArrayToStd([data objectForKey:@"scopes"]);
         if ([data objectForKey:@"expirationTime"]) user.expirationTime = [[data objectForKey:@"expirationTime"] doubleValue];
         if ([data objectForKey:@"underlyingError"]) user.underlyingError = nsToStd([data objectForKey:@"underlyingError"]);
-        promise->resolve(user);
+        promise->resolve(std::make_optional(user));
     }];
     return promise;
 }
@@ -222,20 +305,133 @@ bool PlatformAuth::hasPlayServices() {
     return true;
 }
 
+class URLSessionHttpClient final : public HttpClient {
+public:
+    void send(const HttpRequest& request, Completion completion) override {
+        NSURL* url = [NSURL URLWithString:[NSString stringWithUTF8String:request.url.c_str()]];
+        if (url == nil) {
+            completion(HttpResponse{});
+            return;
+        }
+        NSMutableURLRequest* urlRequest = [NSMutableURLRequest requestWithURL:url];
+        urlRequest.HTTPMethod = [NSString stringWithUTF8String:request.method.c_str()];
+        urlRequest.timeoutInterval = static_cast<NSTimeInterval>(request.timeoutMs) / 1000.0;
+        for (const auto& [name, value] : request.headers) {
+            [urlRequest setValue:[NSString stringWithUTF8String:value.c_str()]
+              forHTTPHeaderField:[NSString stringWithUTF8String:name.c_str()]];
+        }
+        if (!request.body.empty()) {
+            urlRequest.HTTPBody = [NSData dataWithBytes:request.body.data() length:request.body.size()];
+        }
+
+        auto callback = std::make_shared<Completion>(std::move(completion));
+        NSURLSessionDataTask* task = [[NSURLSession sharedSession]
+            dataTaskWithRequest:urlRequest
+              completionHandler:^(NSData* _Nullable data, NSURLResponse* _Nullable urlResponse, NSError* _Nullable error) {
+                HttpResponse response;
+                if (error == nil && [urlResponse isKindOfClass:[NSHTTPURLResponse class]]) {
+                    NSHTTPURLResponse* httpResponse = (NSHTTPURLResponse*)urlResponse;
+                    response.status = static_cast<int>(httpResponse.statusCode);
+                    if (data != nil) {
+                        response.body.assign(static_cast<const char*>(data.bytes), data.length);
+                    }
+                    auto* headers = &response.headers;
+                    [httpResponse.allHeaderFields enumerateKeysAndObjectsUsingBlock:^(id key, id value, BOOL*) {
+                        if (![key isKindOfClass:[NSString class]] || ![value isKindOfClass:[NSString class]]) return;
+                        (*headers)[[[(NSString*)key lowercaseString] UTF8String]] = [(NSString*)value UTF8String];
+                    }];
+                }
+                (*callback)(std::move(response));
+              }];
+        [task resume];
+    }
+};
+
+std::shared_ptr<Promise<Result<std::string>>> PlatformAuth::authorizeInBrowser(const std::string& url,
+                                                                               const std::string& redirectUri) {
+    auto promise = Promise<Result<std::string>>::create();
+    if (!claimPendingSlot(gPendingBrowser, promise)) {
+        promise->resolve(AuthErrorCode::OPERATION_IN_PROGRESS);
+        return promise;
+    }
+    [AuthAdapter openAuthorizationSessionWithUrl:[NSString stringWithUTF8String:url.c_str()]
+                                     redirectUri:[NSString stringWithUTF8String:redirectUri.c_str()]
+                                      completion:^(NSString* _Nullable callbackUrl, NSString* _Nullable error) {
+        if (!releasePendingSlot(gPendingBrowser, promise)) return;
+        if (error != nil) {
+            promise->resolve(AuthError([error UTF8String]));
+            return;
+        }
+        promise->resolve(std::string([callbackUrl UTF8String]));
+    }];
+    return promise;
+}
+
+std::shared_ptr<HttpClient> PlatformAuth::httpClient() {
+    static auto client = std::make_shared<URLSessionHttpClient>();
+    return client;
+}
+
+std::string PlatformAuth::cacheDirectory() {
+    NSArray<NSString*>* paths = NSSearchPathForDirectoriesInDomains(NSCachesDirectory, NSUserDomainMask, YES);
+    if (paths.count == 0) return "";
+    return std::string([[paths.firstObject stringByAppendingPathComponent:@"NitroAuth"] UTF8String]);
+}
+
+std::vector<std::string> PlatformAuth::discoveryAuthorities() {
+    std::vector<std::string> authorities;
+    for (NSString* authority in [AuthAdapter discoveryAuthorities]) {
+        authorities.emplace_back([authority UTF8String]);
+    }
+    return authorities;
+}
+
 void PlatformAuth::logout() {
     [AuthAdapter logout];
 }
 
-std::shared_ptr<Promise<void>> PlatformAuth::revokeAccess() {
-    auto promise = Promise<void>::create();
+std::shared_ptr<Promise<Result<void>>> PlatformAuth::revokeAccess() {
+    auto promise = Promise<Result<void>>::create();
     [AuthAdapter revokeAccessWithCompletion:^(NSString* _Nullable error) {
         if (error != nil) {
-            promise->reject(std::make_exception_ptr(std::runtime_error([error UTF8String])));
+            promise->resolve(AuthError([error UTF8String]));
             return;
         }
-        promise->resolve();
+        promise->resolve(Result<void>());
     }];
     return promise;
 }
 
+void PlatformAuth::cancel(PlatformOperation operation, const std::string& reason) {
+    const AuthError error(reason);
+    switch (operation) {
+        case PlatformOperation::LOGIN:
+            if (auto promise = takePendingSlot(gPendingLogin)) {
+                [AuthAdapter cancelInteractiveAuth];
+                promise->resolve(error);
+            }
+            if (auto browser = takePendingSlot(gPendingBrowser)) {
+                [AuthAdapter cancelInteractiveAuth];
+                browser->resolve(error);
+            }
+            break;
+        case PlatformOperation::REQUEST_SCOPES:
+            if (auto promise = takePendingSlot(gPendingScopes)) {
+                [AuthAdapter cancelInteractiveAuth];
+                promise->resolve(error);
+            }
+            if (auto browser = takePendingSlot(gPendingBrowser)) {
+                [AuthAdapter cancelInteractiveAuth];
+                browser->resolve(error);
+            }
+            break;
+        case PlatformOperation::REFRESH_TOKEN:
+            if (auto promise = takePendingSlot(gPendingRefresh)) promise->resolve(error);
+            break;
+        case PlatformOperation::SILENT_RESTORE:
+            if (auto promise = takePendingSlot(gPendingRestore)) promise->resolve(error);
+            break;
+    }
+}
+
 } // namespace margelo::nitro::NitroAuth
@@ -0,0 +1,238 @@
+#include "LoopbackHttp.hpp"
+#include <algorithm>
+#include <cctype>
+#include <cerrno>
+#include <cstdlib>
+#include <netdb.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <unistd.h>
+
+namespace margelo::nitro::NitroAuth {
+
+namespace {
+
+// Headers beyond this are a broken or hostile peer, not an OAuth exchange.
+constexpr size_t kMaxHeaderBytes = 64 * 1024;
+constexpr size_t kMaxBodyBytes = 4 * 1024 * 1024;
+
+std::string lowercase(std::string_view value) {
+  std::string result(value);
+  std::transform(result.begin(), result.end(), result.begin(),
+                 [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+  return result;
+}
+
+std::string_view trim(std::string_view value) {
+  while (!value.empty() && (value.front() == ' ' || value.front() == '\t')) value.remove_prefix(1);
+  while (!value.empty() && (value.back() == ' ' || value.back() == '\t')) value.remove_suffix(1);
+  return value;
+}
+
+int hexValue(char c) {
+  if (c >= '0' && c <= '9') return c - '0';
+  if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+  if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+  return -1;
+}
+
+std::string percentDecode(std::string_view value) {
+  std::string result;
+  result.reserve(value.size());
+  for (size_t i = 0; i < value.size(); i++) {
+    if (value[i] == '+') {
+      result.push_back(' ');
+    } else if (value[i] == '%' && i + 2 < value.size() && hexValue(value[i + 1]) >= 0 &&
+               hexValue(value[i + 2]) >= 0) {
+      result.push_back(static_cast<char>(hexValue(value[i + 1]) * 16 + hexValue(value[i + 2])));
+      i += 2;
+    } else {
+      result.push_back(value[i]);
+    }
+  }
+  return result;
+}
+
+ssize_t readSome(int fd, char* buffer, size_t size) {
+  while (true) {
+    const ssize_t count = ::recv(fd, buffer, size, 0);
+    if (count >= 0 || errno != EINTR) return count;
+  }
+}
+
+int connectTo(const HttpUrl& url) {
+  addrinfo hints{};
+  hints.ai_family = AF_UNSPEC;
+  hints.ai_socktype = SOCK_STREAM;
+  addrinfo* addresses = nullptr;
+  const std::string port = std::to_string(url.port);
+  if (::getaddrinfo(url.host.c_str(), port.c_str(), &hints, &addresses) != 0) return -1;
+  int fd = -1;
+  for (auto* address = addresses; address; address = address->ai_next) {
+    fd = ::socket(address->ai_family, address->ai_socktype | SOCK_CLOEXEC, address->ai_protocol);
+    if (fd < 0) continue;
+    if (::connect(fd, address->ai_addr, address->ai_addrlen) == 0) break;
+    ::close(fd);
+    fd = -1;
+  }
+  ::freeaddrinfo(addresses);
+  return fd;
+}
+
+} // namespace
+
+std::optional<HttpUrl> parseHttpUrl(std::string_view url) {
+  constexpr std::string_view kScheme = "http://";
+  if (url.substr(0, kScheme.size()) != kScheme) return std::nullopt;
+  url.remove_prefix(kScheme.size());
+  const size_t slash = url.find('/');
+  std::string_view authority = url.substr(0, slash);
+  HttpUrl result;
+  result.target = slash == std::string_view::npos ? "/" : std::string(url.substr(slash));
+
+  size_t colon = std::string_view::npos;
+  if (!authority.empty() && authority.front() == '[') {
+    const size_t close = authority.find(']');
+    if (close == std::string_view::npos) return std::nullopt;
+    result.host = std::string(authority.substr(1, close - 1));
+    if (close + 1 < authority.size()) {
+      if (authority[close + 1] != ':') return std::nullopt;
+      colon = close + 1;
+    }
+  } else {
+    colon = authority.find(':');
+    result.host = std::string(authority.substr(0, colon));
+  }
+  if (result.host.empty()) return std::nullopt;
+  if (colon != std::string_view::npos) {
+    const std::string port(authority.substr(colon + 1));
+    char* end = nullptr;
+    const long value = std::strtol(port.c_str(), &end, 10);
+    if (port.empty() || *end != '\0' || value <= 0 || value > 65535) return std::nullopt;
+    result.port = static_cast<uint16_t>(value);
+  }
+  return result;
+}
+
+std::vector<std::pair<std::string, std::string>> parseFormEncoded(std::string_view body) {
+  std::vector<std::pair<std::string, std::string>> fields;
+  while (!body.empty()) {
+    const size_t amp = body.find('&');
+    const std::string_view field = body.substr(0, amp);
+    body = amp == std::string_view::npos ? std::string_view() : body.substr(amp + 1);
+    if (field.empty()) continue;
+    const size_t equals = field.find('=');
+    if (equals == std::string_view::npos) {
+      fields.emplace_back(percentDecode(field), "");
+    } else {
+      fields.emplace_back(percentDecode(field.substr(0, equals)), percentDecode(field.substr(equals + 1)));
+    }
+  }
+  return fields;
+}
+
+std::optional<HttpMessage> readHttpMessage(int fd, bool bodyUntilClose) {
+  std::string data;
+  char buffer[4096];
+  size_t headerEnd = std::string::npos;
+  while ((headerEnd = data.find("\r\n\r\n")) == std::string::npos) {
+    if (data.size() > kMaxHeaderBytes) return std::nullopt;
+    const ssize_t count = readSome(fd, buffer, sizeof(buffer));
+    if (count <= 0) return std::nullopt;
+    data.append(buffer, static_cast<size_t>(count));
+  }
+
+  HttpMessage message;
+  std::string_view head(data.data(), headerEnd);
+  size_t lineEnd = head.find("\r\n");
+  message.startLine = std::string(head.substr(0, lineEnd));
+  while (lineEnd != std::string_view::npos) {
+    head.remove_prefix(lineEnd + 2);
+    lineEnd = head.find("\r\n");
+    const std::string_view line = head.substr(0, lineEnd);
+    const size_t colon = line.find(':');
+    if (colon == std::string_view::npos) return std::nullopt;
+    message.headers[lowercase(trim(line.substr(0, colon)))] = std::string(trim(line.substr(colon + 1)));
+  }
+
+  message.body = data.substr(headerEnd + 4);
+  auto length = message.headers.find("content-length");
+  if (length != message.headers.end()) {
+    char* end = nullptr;
+    const unsigned long long expected = std::strtoull(length->second.c_str(), &end, 10);
+    if (*end != '\0' || expected > kMaxBodyBytes) return std::nullopt;
+    while (message.body.size() < expected) {
+      const ssize_t count = readSome(fd, buffer, sizeof(buffer));
+      if (count <= 0) return std::nullopt;
+      message.body.append(buffer, static_cast<size_t>(count));
+    }
+    message.body.resize(static_cast<size_t>(expected));
+  } else if (bodyUntilClose) {
+    while (true) {
+      const ssize_t count = readSome(fd, buffer, sizeof(buffer));
+      if (count < 0) return std::nullopt;
+      if (count == 0) break;
+      if (message.body.size() + static_cast<size_t>(count) > kMaxBodyBytes) return std::nullopt;
+      message.body.append(buffer, static_cast<size_t>(count));
+    }
+  }
+  return message;
+}
+
+bool writeAll(int fd, std::string_view data) {
+  while (!data.empty()) {
+    const ssize_t count = ::send(fd, data.data(), data.size(), MSG_NOSIGNAL);
+    if (count < 0 && errno == EINTR) continue;
+    if (count <= 0) return false;
+    data.remove_prefix(static_cast<size_t>(count));
+  }
+  return true;
+}
+
+void setSocketTimeouts(int fd, int64_t timeoutMs) {
+  timeval timeout{};
+  timeout.tv_sec = static_cast<time_t>(timeoutMs / 1000);
+  timeout.tv_usec = static_cast<suseconds_t>((timeoutMs % 1000) * 1000);
+  ::setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+  ::setsockopt(fd, SOL_SOCKET, SO_SNDTIMEO, &timeout, sizeof(timeout));
+}
+
+void PosixHttpClient::send(const HttpRequest& request, Completion completion) {
+  auto url = parseHttpUrl(request.url);
+  if (!url) {
+    completion(HttpResponse{});
+    return;
+  }
+  const int fd = connectTo(*url);
+  if (fd < 0) {
+    completion(HttpResponse{});
+    return;
+  }
+  setSocketTimeouts(fd, request.timeoutMs);
+
+  const bool isDefaultPort = url->port == 80;
+  std::string wire = request.method + " " + url->target + " HTTP/1.1\r\n";
+  wire += "Host: " + (url->host.find(':') != std::string::npos ? "[" + url->host + "]" : url->host) +
+          (isDefaultPort ? "" : ":" + std::to_string(url->port)) + "\r\n";
+  wire += "Connection: close\r\n";
+  for (const auto& [name, value] : request.headers) wire += name + ": " + value + "\r\n";
+  if (!request.body.empty() || request.method == "POST") {
+    wire += "Content-Length: " + std::to_string(request.body.size()) + "\r\n";
+  }
+  wire += "\r\n";
+  wire += request.body;
+
+  HttpResponse response;
+  std::optional<HttpMessage> message;
+  if (writeAll(fd, wire)) message = readHttpMessage(fd, true);
+  ::close(fd);
+  // "HTTP/1.1 200 OK"
+  if (message && message->startLine.size() >= 12 && message->startLine.compare(0, 5, "HTTP/") == 0) {
+    response.status = std::atoi(message->startLine.c_str() + message->startLine.find(' ') + 1);
+    response.body = std::move(message->body);
+    response.headers = std::move(message->headers);
+  }
+  completion(std::move(response));
+}
+
+} // namespace margelo::nitro::NitroAuth
@@ -0,0 +1,53 @@
+#pragma once
+
+#include "HttpClient.hpp"
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace margelo::nitro::NitroAuth {
+
+struct HttpUrl {
+  std::string host;
+  uint16_t port = 80;
+  // Path and query, always starting with '/'.
+  std::string target;
+};
+
+// `http://host[:port][/target]`; nullopt for any other scheme.
+std::optional<HttpUrl> parseHttpUrl(std::string_view url);
+
+// Splits `a=1&b=2` into decoded pairs ('+' is a space).
+std::vector<std::pair<std::string, std::string>> parseFormEncoded(std::string_view body);
+
+// One HTTP/1.1 request or response as read off a socket.
+struct HttpMessage {
+  std::string startLine;
+  // Names are lower-cased.
+  std::unordered_map<std::string, std::string> headers;
+  std::string body;
+};
+
+// Reads headers, then `Content-Length` bytes of body (or everything up to EOF
+// when `bodyUntilClose`). nullopt on a malformed message, timeout or early close.
+std::optional<HttpMessage> readHttpMessage(int fd, bool bodyUntilClose);
+bool writeAll(int fd, std::string_view data);
+// Applies `timeoutMs` to every later read and write on `fd`.
+void setSocketTimeouts(int fd, int64_t timeoutMs);
+
+// Plain HTTP/1.1 over POSIX sockets, one connection per request. It blocks the
+// calling thread for the whole exchange and calls `completion` before
+// returning, which suits a headless process that may block (a CLI, a test, a
+// benchmark) and keeps every exchange on the caller's stack for profiling.
+// Redirects are returned, not followed. Only `http://` URLs; TLS is out of
+// scope for a loopback stand-in, and any other URL completes with status 0.
+class PosixHttpClient final : public HttpClient {
+public:
+  void send(const HttpRequest& request, Completion completion) override;
+};
+
+} // namespace margelo::nitro::NitroAuth
@@ -0,0 +1,403 @@
+#include "LoopbackOAuthServer.hpp"
+#include "JwsCrypto.hpp"
+#include "LoopbackSigner.hpp"
+#include <algorithm>
+#include <arpa/inet.h>
+#include <cctype>
+#include <cstdio>
+#include <cstring>
+#include <ctime>
+#include <netinet/in.h>
+#include <random>
+#include <sstream>
+#include <stdexcept>
+#include <sys/socket.h>
+#include <unistd.h>
+#include <vector>
+
+namespace margelo::nitro::NitroAuth {
+
+namespace {
+
+constexpr auto kKeyId = "loopback-1";
+// RSA-2048, e = 65537. Published on purpose: see the class comment.
+constexpr auto kModulus =
+    "icf9rC-eNXQyNuSL8p0QAR1HkAans3D4u4tDnftBcxfc7eBVYbeAFL9WgiRn_V5UxGm92F_x6PYLo537zZgAoCO3NH17Nw5HvDdbN_bsN9XH"
+    "r3-vbd1IOLSLlFhTiXvbAV4a1Z-52oX9BdlM-TZLAXRLAaBrfInwKzHfCGDOheNWnlMxM4jl8anpDKm2YoVxMfJQLTyt_5J7fI6NJc7MEX2p"
+    "F-7bnv4BEwebaW5lNut1TafpqYFdo9g2h4Hi3E7Ovm5F0xQ-ixPPFA34rVYlE96mEXpbV5puF0MuK9BJDgSmeZZiW_wGXQ9-wrCjNv_ZmByZ"
+    "NiGUnwHsx65-cOUBqQ";
+constexpr auto kPrivateExponent =
+    "AhiEjWtSgd_k-SSIE-5LbWbpfSF6yM4XvHuRcVxeah6jbctfJRu-UyJ3cYaV_drC2ZN9r6ZC9t8SPYCEUWPl44mzilT7zDI3iV-Cr9Ld1DoY"
+    "Xd0oeRh39iPZ6S1gROu5QLeymwwBTteBqiZ8ZyCKKske8HUFGYl8GZ4aNUWKsqrlQfbAH9yuR97muNkvA4p7jrXMR3VkjkqFxbzhJcjwT2js"
+    "qq4Gy5J-hZ9GXDsk4hbJuOF2kBphaANRgp6UnVoFMLcUa-TjF5-g6XBAqivjiT7ug-6CpsiUW790CRd2AXsoGKWu1CU9FRv0InBb8jpwhsgy"
+    "iROId9mW22F7EQDkkQ";
+constexpr int64_t kCodeLifetimeMs = 60 * 1000;
+constexpr int64_t kRequestTimeoutMs = 5000;
+
+std::string jsonString(std::string_view value) {
+  std::string result = "\"";
+  for (const char c : value) {
+    switch (c) {
+      case '"': result += "\\\""; break;
+      case '\\': result += "\\\\"; break;
+      case '\n': result += "\\n"; break;
+      case '\r': result += "\\r"; break;
+      case '\t': result += "\\t"; break;
+      default:
+        if (static_cast<unsigned char>(c) < 0x20) {
+          char escaped[8];
+          std::snprintf(escaped, sizeof(escaped), "\\u%04x", c);
+          result += escaped;
+        } else {
+          result.push_back(c);
+        }
+    }
+  }
+  return result + "\"";
+}
+
+std::string percentEncode(std::string_view value) {
+  static constexpr char kHex[] = "0123456789ABCDEF";
+  std::string result;
+  for (const char c : value) {
+    const auto byte = static_cast<unsigned char>(c);
+    if (std::isalnum(byte) || c == '-' || c == '.' || c == '_' || c == '~') {
+      result.push_back(c);
+    } else {
+      result.push_back('%');
+      result.push_back(kHex[byte >> 4]);
+      result.push_back(kHex[byte & 0xF]);
+    }
+  }
+  return result;
+}
+
+std::string httpDate(int64_t nowMs) {
+  const std::time_t seconds = static_cast<std::time_t>(nowMs / 1000);
+  std::tm utc{};
+  ::gmtime_r(&seconds, &utc);
+  char buffer[64];
+  std::strftime(buffer, sizeof(buffer), "%a, %d %b %Y %H:%M:%S GMT", &utc);
+  return buffer;
+}
+
+std::string field(const std::vector<std::pair<std::string, std::string>>& fields, std::string_view name) {
+  for (const auto& [key, value] : fields) {
+    if (key == name) return value;
+  }
+  return {};
+}
+
+bool hasField(const std::vector<std::pair<std::string, std::string>>& fields, std::string_view name) {
+  for (const auto& entry : fields) {
+    if (entry.first == name) return true;
+  }
+  return false;
+}
+
+// True when every space-separated scope in `requested` is in `granted`.
+bool isScopeSubset(const std::string& requested, const std::string& granted) {
+  std::istringstream grantedStream(granted);
+  std::vector<std::string> grantedScopes;
+  for (std::string scope; grantedStream >> scope;) grantedScopes.push_back(scope);
+  std::istringstream requestedStream(requested);
+  for (std::string scope; requestedStream >> scope;) {
+    if (std::find(grantedScopes.begin(), grantedScopes.end(), scope) == grantedScopes.end()) return false;
+  }
+  return true;
+}
+
+std::string randomToken() {
+  thread_local std::mt19937_64 random{std::random_device{}()};
+  std::string bytes(32, '\0');
+  for (size_t i = 0; i < bytes.size(); i += 8) {
+    const uint64_t word = random();
+    std::memcpy(bytes.data() + i, &word, 8);
+  }
+  return JwsCrypto::base64UrlEncode(bytes);
+}
+
+std::string response(int status, std::string_view reason, const std::string& date, std::string_view contentType,
+                     const std::string& body, const std::string& extraHeaders = {}) {
+  std::string wire = "HTTP/1.1 " + std::to_string(status) + " " + std::string(reason) + "\r\n";
+  wire += "Date: " + date + "\r\n";
+  wire += "Connection: close\r\n";
+  if (!contentType.empty()) wire += "Content-Type: " + std::string(contentType) + "\r\n";
+  wire += "Content-Length: " + std::to_string(body.size()) + "\r\n";
+  wire += extraHeaders;
+  wire += "\r\n";
+  return wire + body;
+}
+
+std::string oauthError(int status, const std::string& date, std::string_view error) {
+  return response(status, status == 401 ? "Unauthorized" : "Bad Request", date, "application/json",
+                  "{\"error\":" + jsonString(error) + "}", "Cache-Control: no-store\r\n");
+}
+
+} // namespace
+
+std::shared_ptr<LoopbackOAuthServer> LoopbackOAuthServer::start(LoopbackOAuthServerOptions options) {
+  const int fd = ::socket(AF_INET, SOCK_STREAM | SOCK_CLOEXEC, 0);
+  if (fd < 0) throw std::runtime_error("network_error");
+  sockaddr_in address{};
+  address.sin_family = AF_INET;
+  address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+  address.sin_port = 0;
+  socklen_t length = sizeof(address);
+  if (::bind(fd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0 || ::listen(fd, 64) != 0 ||
+      ::getsockname(fd, reinterpret_cast<sockaddr*>(&address), &length) != 0) {
+    ::close(fd);
+    throw std::runtime_error("network_error");
+  }
+  auto server = std::shared_ptr<LoopbackOAuthServer>(
+      new LoopbackOAuthServer(fd, ntohs(address.sin_port), std::move(options)));
+  server->_thread = std::thread([raw = server.get()] { raw->serve(); });
+  return server;
+}
+
+LoopbackOAuthServer::LoopbackOAuthServer(int listenFd, uint16_t port, LoopbackOAuthServerOptions options)
+    : _options(std::move(options)), _issuer("http://127.0.0.1:" + std::to_string(port)), _listenFd(listenFd) {}
+
+LoopbackOAuthServer::~LoopbackOAuthServer() {
+  stop();
+}
+
+void LoopbackOAuthServer::stop() {
+  if (_stopped.exchange(true)) return;
+  // Wakes the blocking accept().
+  ::shutdown(_listenFd, SHUT_RDWR);
+  if (_thread.joinable()) _thread.join();
+  ::close(_listenFd);
+}
+
+void LoopbackOAuthServer::scriptConsent(ConsentDecision decision) {
+  std::lock_guard<std::mutex> lock(_mutex);
+  _consentScript.push_back(std::move(decision));
+}
+
+void LoopbackOAuthServer::setDefaultConsent(ConsentDecision decision) {
+  std::lock_guard<std::mutex> lock(_mutex);
+  _defaultConsent = std::move(decision);
+}
+
+bool LoopbackOAuthServer::isRefreshTokenActive(const std::string& refreshToken) {
+  std::lock_guard<std::mutex> lock(_mutex);
+  auto it = _refreshTokens.find(refreshToken);
+  if (it == _refreshTokens.end()) return false;
+  const auto& grant = _grants.at(it->second);
+  return !grant.revoked && grant.refreshToken == refreshToken;
+}
+
+bool LoopbackOAuthServer::isAccessTokenActive(const std::string& accessToken) {
+  std::lock_guard<std::mutex> lock(_mutex);
+  auto it = _accessTokens.find(accessToken);
+  return it != _accessTokens.end() && !_grants.at(it->second.grantId).revoked &&
+         nowMs() < it->second.expiresAtMs;
+}
+
+LoopbackOAuthServerStats LoopbackOAuthServer::stats() {
+  std::lock_guard<std::mutex> lock(_mutex);
+  return _stats;
+}
+
+int64_t LoopbackOAuthServer::nowMs() const {
+  return _options.clock->nowMs() + _options.clockOffsetMs;
+}
+
+void LoopbackOAuthServer::serve() {
+  while (!_stopped) {
+    const int client = ::accept4(_listenFd, nullptr, nullptr, SOCK_CLOEXEC);
+    if (client < 0) {
+      if (_stopped) return;
+      continue;
+    }
+    setSocketTimeouts(client, kRequestTimeoutMs);
+    if (auto request = readHttpMessage(client, false)) writeAll(client, handle(*request));
+    ::close(client);
+  }
+}
+
+std::string LoopbackOAuthServer::handle(const HttpMessage& request) {
+  const std::string date = httpDate(nowMs());
+  std::istringstream startLine(request.startLine);
+  std::string method;
+  std::string target;
+  startLine >> method >> target;
+  const size_t question = target.find('?');
+  const std::string path = target.substr(0, question);
+  const std::string query = question == std::string::npos ? "" : target.substr(question + 1);
+
+  if (method == "GET" && path == "/.well-known/openid-configuration") {
+    const std::string body =
+        "{\"issuer\":" + jsonString(_issuer) + ",\"authorization_endpoint\":" + jsonString(_issuer + "/authorize") +
+        ",\"token_endpoint\":" + jsonString(_issuer + "/token") + ",\"jwks_uri\":" + jsonString(_issuer + "/jwks") +
+        ",\"revocation_endpoint\":" + jsonString(_issuer + "/revoke") +
+        ",\"response_types_supported\":[\"code\"],\"grant_types_supported\":[\"authorization_code\","
+        "\"refresh_token\"],\"code_challenge_methods_supported\":[\"S256\"],"
+        "\"id_token_signing_alg_values_supported\":[\"RS256\"]}";
+    return response(200, "OK", date, "application/json", body, "Cache-Control: max-age=3600\r\n");
+  }
+  if (method == "GET" && path == "/jwks") {
+    const std::string body = std::string("{\"keys\":[{\"kty\":\"RSA\",\"kid\":\"") + kKeyId +
+                             "\",\"use\":\"sig\",\"alg\":\"RS256\",\"n\":\"" + kModulus + "\",\"e\":\"AQAB\"}]}";
+    return response(200, "OK", date, "application/json", body, "Cache-Control: max-age=3600\r\n");
+  }
+  if (method == "GET" && path == "/authorize") return authorize(query);
+  if (method == "POST" && path == "/token") return token(request.body);
+  if (method == "POST" && path == "/revoke") return revoke(request.body);
+  return response(404, "Not Found", date, "", "");
+}
+
+std::string LoopbackOAuthServer::authorize(const std::string& query) {
+  const auto fields = parseFormEncoded(query);
+  const std::string date = httpDate(nowMs());
+  // Without a known client and a redirect URI there is nobody to redirect to.
+  if (field(fields, "client_id") != _options.clientId) return oauthError(400, date, "invalid_client");
+  const std::string redirectUri = field(fields, "redirect_uri");
+  if (redirectUri.empty()) return oauthError(400, date, "invalid_request");
+
+  std::string result;
+  std::lock_guard<std::mutex> lock(_mutex);
+  _stats.authorizations++;
+  if (field(fields, "response_type") != "code") {
+    result = "error=unsupported_response_type";
+  } else if (field(fields, "code_challenge").empty() || field(fields, "code_challenge_method") != "S256") {
+    // PKCE is mandatory, and only S256 is accepted.
+    result = "error=invalid_request";
+  } else {
+    ConsentDecision consent = _defaultConsent;
+    if (!_consentScript.empty()) {
+      consent = std::move(_consentScript.front());
+      _consentScript.pop_front();
+    }
+    if (!consent.approve) {
+      _stats.consentsDenied++;
+      result = "error=access_denied";
+    } else {
+      AuthorizationCode code;
+      code.redirectUri = redirectUri;
+      code.codeChallenge = field(fields, "code_challenge");
+      code.scope = field(fields, "scope");
+      if (hasField(fields, "nonce")) code.nonce = field(fields, "nonce");
+      code.user = std::move(consent);
+      code.expiresAtMs = nowMs() + kCodeLifetimeMs;
+      const std::string value = randomToken();
+      _codes.emplace(value, std::move(code));
+      result = "code=" + value;
+    }
+  }
+  if (hasField(fields, "state")) result += "&state=" + percentEncode(field(fields, "state"));
+  const std::string location = redirectUri + (redirectUri.find('?') == std::string::npos ? "?" : "&") + result;
+  return response(302, "Found", date, "", "", "Location: " + location + "\r\n");
+}
+
+std::string LoopbackOAuthServer::token(const std::string& body) {
+  const auto fields = parseFormEncoded(body);
+  const std::string date = httpDate(nowMs());
+  std::lock_guard<std::mutex> lock(_mutex);
+  auto reject = [this, &date](int status, std::string_view error) {
+    _stats.rejectedGrants++;
+    return oauthError(status, date, error);
+  };
+  if (field(fields, "client_id") != _options.clientId) return reject(401, "invalid_client");
+
+  const std::string grantType = field(fields, "grant_type");
+  if (grantType == "authorization_code") {
+    auto it = _codes.find(field(fields, "code"));
+    if (it == _codes.end()) return reject(400, "invalid_grant");
+    // Codes are single-use, whether or not this exchange succeeds.
+    AuthorizationCode code = std::move(it->second);
+    _codes.erase(it);
+    const auto digest = JwsCrypto::sha256(field(fields, "code_verifier"));
+    const std::string challenge =
+        JwsCrypto::base64UrlEncode(std::string_view(reinterpret_cast<const char*>(digest.data()), digest.size()));
+    if (nowMs() >= code.expiresAtMs || field(fields, "redirect_uri") != code.redirectUri ||
+        challenge != code.codeChallenge) {
+      return reject(400, "invalid_grant");
+    }
+    _stats.codeExchanges++;
+    const std::string grantId = std::to_string(_nextGrant++);
+    Grant grant;
+    grant.user = std::move(code.user);
+    grant.scope = std::move(code.scope);
+    _grants.emplace(grantId, std::move(grant));
+    return issueTokensLocked(grantId, true, code.nonce);
+  }
+
+  if (grantType == "refresh_token") {
+    const std::string refreshToken = field(fields, "refresh_token");
+    auto it = _refreshTokens.find(refreshToken);
+    if (it == _refreshTokens.end()) return reject(400, "invalid_grant");
+    auto& grant = _grants.at(it->second);
+    if (grant.revoked) return reject(400, "invalid_grant");
+    if (grant.refreshToken != refreshToken) {
+      // A superseded token is a replay; nothing issued from this grant can be trusted now.
+      _stats.reuseDetections++;
+      grant.revoked = true;
+      return reject(400, "invalid_grant");
+    }
+    const std::string scope = field(fields, "scope");
+    if (!scope.empty() && !isScopeSubset(scope, grant.scope)) return reject(400, "invalid_scope");
+    _stats.refreshes++;
+    return issueTokensLocked(it->second, false, std::nullopt, scope);
+  }
+  return reject(400, "unsupported_grant_type");
+}
+
+std::string LoopbackOAuthServer::revoke(const std::string& body) {
+  const auto fields = parseFormEncoded(body);
+  const std::string token = field(fields, "token");
+  std::lock_guard<std::mutex> lock(_mutex);
+  // RFC 7009: unknown tokens are not an error.
+  if (auto it = _refreshTokens.find(token); it != _refreshTokens.end()) {
+    _grants.at(it->second).revoked = true;
+    _stats.revocations++;
+  } else if (auto access = _accessTokens.find(token); access != _accessTokens.end()) {
+    _accessTokens.erase(access);
+    _stats.revocations++;
+  }
+  return response(200, "OK", httpDate(nowMs()), "", "");
+}
+
+std::string LoopbackOAuthServer::issueTokensLocked(const std::string& grantId, bool isSignIn,
+                                                   const std::optional<std::string>& nonce, const std::string& scope) {
+  auto& grant = _grants.at(grantId);
+  const int64_t now = nowMs();
+  const std::string accessToken = randomToken();
+  _accessTokens[accessToken] = AccessToken{grantId, now + _options.accessTokenLifetimeMs};
+
+  const bool issuesRefreshToken = grant.refreshToken.empty() || _options.rotateRefreshTokens;
+  if (issuesRefreshToken) {
+    grant.refreshToken = randomToken();
+    _refreshTokens[grant.refreshToken] = grantId;
+  }
+
+  std::string body = "{\"access_token\":" + jsonString(accessToken) + ",\"token_type\":\"Bearer\",\"expires_in\":" +
+                     std::to_string(_options.accessTokenLifetimeMs / 1000) +
+                     ",\"scope\":" + jsonString(scope.empty() ? grant.scope : scope);
+  if (isSignIn || _options.idTokenOnRefresh) body += ",\"id_token\":" + jsonString(idTokenLocked(grant, nonce));
+  if (issuesRefreshToken) body += ",\"refresh_token\":" + jsonString(grant.refreshToken);
+  body += "}";
+  return response(200, "OK", httpDate(now), "application/json", body, "Cache-Control: no-store\r\n");
+}
+
+std::string LoopbackOAuthServer::idTokenLocked(const Grant& grant, const std::optional<std::string>& nonce) {
+  const int64_t nowSeconds = nowMs() / 1000;
+  const std::string header = std::string("{\"alg\":\"RS256\",\"kid\":\"") + kKeyId + "\",\"typ\":\"JWT\"}";
+  std::string payload = "{\"iss\":" + jsonString(_issuer) + ",\"sub\":" + jsonString(grant.user.subject) +
+                        ",\"aud\":" + jsonString(_options.clientId) +
+                        ",\"iat\":" + std::to_string(nowSeconds) +
+                        ",\"exp\":" + std::to_string(nowSeconds + _options.idTokenLifetimeMs / 1000);
+  if (nonce) payload += ",\"nonce\":" + jsonString(*nonce);
+  if (grant.user.email) payload += ",\"email\":" + jsonString(*grant.user.email);
+  if (grant.user.name) payload += ",\"name\":" + jsonString(*grant.user.name);
+  payload += "}";
+
+  const std::string signingInput = JwsCrypto::base64UrlEncode(header) + "." + JwsCrypto::base64UrlEncode(payload);
+  static const std::string modulus = *JwsCrypto::base64UrlDecode(kModulus);
+  static const std::string privateExponent = *JwsCrypto::base64UrlDecode(kPrivateExponent);
+  const std::string signature = signRs256WithTestKey(modulus, privateExponent, JwsCrypto::sha256(signingInput));
+  return signingInput + "." + JwsCrypto::base64UrlEncode(signature);
+}
+
+} // namespace margelo::nitro::NitroAuth
@@ -0,0 +1,141 @@
+#pragma once
+
+#include "AuthClock.hpp"
+#include "LoopbackHttp.hpp"
+#include <atomic>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <thread>
+#include <unordered_map>
+
+namespace margelo::nitro::NitroAuth {
+
+// What the "user" does on the consent screen of one authorization request.
+struct ConsentDecision {
+  bool approve = true;
+  std::string subject = "loopback-user";
+  std::optional<std::string> email = "user@example.com";
+  std::optional<std::string> name = "Loopback User";
+};
+
+struct LoopbackOAuthServerOptions {
+  // The only client the server knows; other client ids get `invalid_client`.
+  std::string clientId = "nitro-auth-linux";
+  int64_t accessTokenLifetimeMs = 60 * 60 * 1000;
+  int64_t idTokenLifetimeMs = 60 * 60 * 1000;
+  // Every refresh returns a new refresh token and supersedes the presented one.
+  bool rotateRefreshTokens = true;
+  // Refresh responses carry a new id_token, as Google's and Microsoft's do.
+  // Signing one costs tens of milliseconds here, which dominates load runs.
+  bool idTokenOnRefresh = true;
+  // Added to the server's clock for `iat`, `exp` and the Date header, to
+  // stand in for a server whose clock disagrees with the device.
+  int64_t clockOffsetMs = 0;
+  // The server's time source; share a virtual clock with the client to replay
+  // long traces. Read from the server thread.
+  std::shared_ptr<AuthClock> clock = AuthClock::system();
+};
+
+struct LoopbackOAuthServerStats {
+  uint64_t authorizations = 0;
+  uint64_t consentsDenied = 0;
+  uint64_t codeExchanges = 0;
+  uint64_t refreshes = 0;
+  uint64_t revocations = 0;
+  // Token requests answered with an OAuth error.
+  uint64_t rejectedGrants = 0;
+  // A superseded refresh token came back; its whole grant was revoked.
+  uint64_t reuseDetections = 0;
+};
+
+// An OpenID provider on 127.0.0.1 for running the native pipeline end to end
+// without a device or a real identity provider: discovery, JWKS, an
+// authorization endpoint whose consent screen is scripted, and a token
+// endpoint for authorization-code + PKCE (S256 only) and refresh_token grants
+// with rotation and reuse detection, plus RFC 7009 revocation.
+//
+// id_tokens are RS256-signed with a fixed key whose private half ships in the
+// source, so they verify through the real JWKS path and mean nothing anywhere
+// else. One connection is served at a time on the server's own thread.
+class LoopbackOAuthServer {
+public:
+  // Binds 127.0.0.1 on an ephemeral port. Throws
+  // std::runtime_error("network_error") if no socket can be bound.
+  static std::shared_ptr<LoopbackOAuthServer> start(LoopbackOAuthServerOptions options = {});
+
+  ~LoopbackOAuthServer();
+  LoopbackOAuthServer(const LoopbackOAuthServer&) = delete;
+  LoopbackOAuthServer& operator=(const LoopbackOAuthServer&) = delete;
+
+  // `http://127.0.0.1:<port>`; also the `iss` of every id_token.
+  const std::string& issuer() const { return _issuer; }
+  const LoopbackOAuthServerOptions& options() const { return _options; }
+
+  // Queues the answer to the next authorization request; requests beyond the
+  // script get the default decision.
+  void scriptConsent(ConsentDecision decision);
+  void setDefaultConsent(ConsentDecision decision);
+
+  bool isRefreshTokenActive(const std::string& refreshToken);
+  bool isAccessTokenActive(const std::string& accessToken);
+  LoopbackOAuthServerStats stats();
+  void stop();
+
+private:
+  struct AuthorizationCode {
+    std::string redirectUri;
+    std::string codeChallenge;
+    std::string scope;
+    std::optional<std::string> nonce;
+    ConsentDecision user;
+    int64_t expiresAtMs = 0;
+  };
+  // One sign-in and every token issued from it.
+  struct Grant {
+    ConsentDecision user;
+    std::string scope;
+    std::string refreshToken;
+    bool revoked = false;
+  };
+  struct AccessToken {
+    std::string grantId;
+    int64_t expiresAtMs = 0;
+  };
+
+  LoopbackOAuthServer(int listenFd, uint16_t port, LoopbackOAuthServerOptions options);
+  void serve();
+  std::string handle(const HttpMessage& request);
+  std::string authorize(const std::string& query);
+  std::string token(const std::string& body);
+  std::string revoke(const std::string& body);
+  // `scope` narrows the response's scope on a down-scoped refresh.
+  std::string issueTokensLocked(const std::string& grantId, bool isSignIn, const std::optional<std::string>& nonce,
+                                const std::string& scope = {});
+  std::string idTokenLocked(const Grant& grant, const std::optional<std::string>& nonce);
+  int64_t nowMs() const;
+
+private:
+  const LoopbackOAuthServerOptions _options;
+  const std::string _issuer;
+  int _listenFd;
+  std::atomic<bool> _stopped{false};
+  std::thread _thread;
+
+  std::mutex _mutex;
+  ConsentDecision _defaultConsent;
+  std::deque<ConsentDecision> _consentScript;
+  std::unordered_map<std::string, AuthorizationCode> _codes;
+  std::unordered_map<std::string, Grant> _grants;
+  // Every refresh token ever issued -> its grant. Only the grant's current one
+  // is usable; a superseded one coming back revokes the grant.
+  std::unordered_map<std::string, std::string> _refreshTokens;
+  std::unordered_map<std::string, AccessToken> _accessTokens;
+  uint64_t _nextGrant = 1;
+  LoopbackOAuthServerStats _stats;
+};
+
+} // namespace margelo::nitro::NitroAuth
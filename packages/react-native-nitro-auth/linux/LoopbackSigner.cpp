@@ -0,0 +1,157 @@
+#include "LoopbackSigner.hpp"
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+namespace margelo::nitro::NitroAuth {
+
+namespace {
+
+using Limb = uint32_t;
+using Wide = uint64_t;
+using Number = std::vector<Limb>;
+
+constexpr size_t kMaxLimbs = 4096 / 32;
+
+constexpr uint8_t kSha256DigestInfo[] = {0x30, 0x31, 0x30, 0x0d, 0x06, 0x09, 0x60, 0x86, 0x48, 0x01,
+                                         0x65, 0x03, 0x04, 0x02, 0x01, 0x05, 0x00, 0x04, 0x20};
+
+std::string_view stripLeadingZeros(std::string_view value) {
+  while (!value.empty() && value.front() == '\0') value.remove_prefix(1);
+  return value;
+}
+
+// Little-endian limbs from big-endian bytes; `bytes` must fit in `limbs`.
+Number load(std::string_view bytes, size_t limbs) {
+  Number out(limbs, 0);
+  for (size_t index = 0; index < bytes.size(); ++index) {
+    out[index / 4] |= Limb(static_cast<uint8_t>(bytes[bytes.size() - 1 - index])) << (8 * (index % 4));
+  }
+  return out;
+}
+
+bool isAtLeast(const Limb* a, const Number& b) {
+  for (size_t i = b.size(); i-- > 0;) {
+    if (a[i] != b[i]) return a[i] > b[i];
+  }
+  return true;
+}
+
+void subtract(Limb* a, const Number& b) {
+  Limb borrow = 0;
+  for (size_t i = 0; i < b.size(); ++i) {
+    const Wide difference = Wide(a[i]) - b[i] - borrow;
+    a[i] = Limb(difference);
+    borrow = Limb(difference >> 63);
+  }
+}
+
+// Modular arithmetic in Montgomery form, R = 2^(32 * limbs).
+class Montgomery {
+public:
+  explicit Montgomery(Number modulus) : _n(std::move(modulus)), _r2(_n.size(), 0) {
+    // -n^-1 mod 2^32 by Newton iteration.
+    Limb inverse = _n[0];
+    for (int i = 0; i < 4; ++i) inverse *= 2 - _n[0] * inverse;
+    _n0inv = 0u - inverse;
+    // R^2 mod n by doubling 1 up 2 * 32 * limbs times.
+    _r2[0] = 1;
+    for (size_t i = 0; i < 64 * _n.size(); ++i) {
+      Limb carry = 0;
+      for (auto& limb : _r2) {
+        const Limb next = limb >> 31;
+        limb = (limb << 1) | carry;
+        carry = next;
+      }
+      if (carry != 0 || isAtLeast(_r2.data(), _n)) subtract(_r2.data(), _n);
+    }
+  }
+
+  // out = a * b * R^-1 mod n, for a and b below n; out may alias either input.
+  void multiply(Limb* out, const Limb* a, const Limb* b) const {
+    const size_t k = _n.size();
+    const Limb* n = _n.data();
+    Limb t[kMaxLimbs + 2] = {};
+    for (size_t i = 0; i < k; ++i) {
+      Wide carry = 0;
+      for (size_t j = 0; j < k; ++j) {
+        const Wide sum = Wide(t[j]) + Wide(a[j]) * b[i] + carry;
+        t[j] = Limb(sum);
+        carry = sum >> 32;
+      }
+      Wide sum = Wide(t[k]) + carry;
+      t[k] = Limb(sum);
+      t[k + 1] = Limb(sum >> 32);
+
+      const Limb m = t[0] * _n0inv;
+      carry = (Wide(t[0]) + Wide(m) * n[0]) >> 32;
+      for (size_t j = 1; j < k; ++j) {
+        sum = Wide(t[j]) + Wide(m) * n[j] + carry;
+        t[j - 1] = Limb(sum);
+        carry = sum >> 32;
+      }
+      sum = Wide(t[k]) + carry;
+      t[k - 1] = Limb(sum);
+      t[k] = t[k + 1] + Limb(sum >> 32);
+      t[k + 1] = 0;
+    }
+    if (t[k] != 0 || isAtLeast(t, _n)) subtract(t, _n);
+    std::copy(t, t + k, out);
+  }
+
+  // base^exponent mod n, in and out of Montgomery form.
+  Number power(const Number& base, const Number& exponent) const {
+    Number montgomeryBase(_n.size());
+    multiply(montgomeryBase.data(), base.data(), _r2.data());
+    Number one(_n.size(), 0);
+    one[0] = 1;
+    Number accumulator(_n.size());
+    multiply(accumulator.data(), one.data(), _r2.data());
+    for (size_t bit = 32 * exponent.size(); bit-- > 0;) {
+      multiply(accumulator.data(), accumulator.data(), accumulator.data());
+      if ((exponent[bit / 32] >> (bit % 32)) & 1) {
+        multiply(accumulator.data(), accumulator.data(), montgomeryBase.data());
+      }
+    }
+    multiply(accumulator.data(), accumulator.data(), one.data());
+    return accumulator;
+  }
+
+private:
+  Number _n;
+  Number _r2;
+  Limb _n0inv;
+};
+
+} // namespace
+
+std::string signRs256WithTestKey(std::string_view modulus, std::string_view privateExponent,
+                                 const Sha256Digest& digest) {
+  modulus = stripLeadingZeros(modulus);
+  privateExponent = stripLeadingZeros(privateExponent);
+  const size_t size = modulus.size();
+  if (size < 256 || size > 512 || (static_cast<uint8_t>(modulus.back()) & 1) == 0) return {};
+  if (privateExponent.empty() || privateExponent.size() > size) return {};
+
+  // EM = 0x00 || 0x01 || PS (0xFF...) || 0x00 || DigestInfo || H
+  const size_t suffix = sizeof(kSha256DigestInfo) + digest.size();
+  std::string encoded(size, '\xFF');
+  encoded[0] = '\x00';
+  encoded[1] = '\x01';
+  encoded[size - suffix - 1] = '\x00';
+  std::memcpy(encoded.data() + size - suffix, kSha256DigestInfo, sizeof(kSha256DigestInfo));
+  std::memcpy(encoded.data() + size - digest.size(), digest.data(), digest.size());
+
+  const size_t limbs = (size + 3) / 4;
+  const Montgomery mont(load(modulus, limbs));
+  const Number signature = mont.power(load(encoded, limbs), load(privateExponent, limbs));
+
+  std::string out(size, '\0');
+  for (size_t index = 0; index < size; ++index) {
+    out[size - 1 - index] = static_cast<char>(signature[index / 4] >> (8 * (index % 4)));
+  }
+  return out;
+}
+
+} // namespace margelo::nitro::NitroAuth
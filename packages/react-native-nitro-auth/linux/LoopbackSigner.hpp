@@ -0,0 +1,17 @@
+#pragma once
+
+#include "JwsCrypto.hpp"
+#include <string>
+#include <string_view>
+
+namespace margelo::nitro::NitroAuth {
+
+// RSASSA-PKCS1-v1_5 with SHA-256 under the private exponent `privateExponent`,
+// for the loopback stand-in server's published test key. Lives next to the
+// server because nothing that ships needs to sign: it is not constant-time, so
+// never hand it a key that protects anything. Integers are unsigned big-endian
+// byte strings. Empty for an unusable key.
+std::string signRs256WithTestKey(std::string_view modulus, std::string_view privateExponent,
+                                 const Sha256Digest& digest);
+
+} // namespace margelo::nitro::NitroAuth
@@ -0,0 +1,369 @@
+#include "PlatformAuth.hpp"
+#include "PlatformAuth+Linux.hpp"
+#include "AuthResult.hpp"
+#include "LoopbackHttp.hpp"
+#include "OidcClient.hpp"
+#include "OidcMetadataCache.hpp"
+#include <algorithm>
+#include <cstdlib>
+#include <mutex>
+#include <optional>
+
+namespace margelo::nitro::NitroAuth {
+
+namespace {
+
+std::mutex gMutex;
+std::optional<LinuxPlatformConfig> gConfig;
+std::shared_ptr<OidcMetadataCache> gMetadata;
+std::shared_ptr<OidcClient> gClient;
+// The signed-in user, including the refresh token the platform keeps for itself.
+std::optional<AuthUser> gSession;
+std::shared_ptr<Promise<Result<AuthUser>>> gLoginPromise;
+std::shared_ptr<Promise<Result<AuthUser>>> gScopesPromise;
+std::shared_ptr<Promise<Result<AuthTokens>>> gRefreshPromise;
+
+std::shared_ptr<HttpClient> sharedHttpClient() {
+  static const auto client = std::make_shared<PosixHttpClient>();
+  return client;
+}
+
+LinuxPlatformConfig configLocked() {
+  if (!gConfig) {
+    LinuxPlatformConfig config;
+    if (const char* issuer = std::getenv("NITRO_AUTH_ISSUER")) config.issuer = issuer;
+    if (const char* clientId = std::getenv("NITRO_AUTH_CLIENT_ID")) config.clientId = clientId;
+    gConfig = config;
+  }
+  return *gConfig;
+}
+
+std::string cacheDirectoryFor(const LinuxPlatformConfig& config) {
+  if (!config.cacheDirectory.empty()) return config.cacheDirectory;
+  if (const char* xdg = std::getenv("XDG_CACHE_HOME"); xdg && *xdg) return std::string(xdg) + "/nitro-auth";
+  if (const char* home = std::getenv("HOME"); home && *home) return std::string(home) + "/.cache/nitro-auth";
+  return {};
+}
+
+// nullptr until an issuer is configured.
+std::shared_ptr<OidcClient> clientLocked() {
+  if (gClient) return gClient;
+  const auto config = configLocked();
+  if (config.issuer.empty()) return nullptr;
+  OidcMetadataOptions options;
+  options.cacheDirectory = cacheDirectoryFor(config);
+  gMetadata = std::make_shared<OidcMetadataCache>(sharedHttpClient(), options, config.clock);
+  OidcProviderConfig provider;
+  provider.issuer = config.issuer;
+  provider.clientId = config.clientId;
+  provider.redirectUri = config.redirectUri;
+  gClient = std::make_shared<OidcClient>(provider, sharedHttpClient(), gMetadata, &PlatformAuth::authorizeInBrowser,
+                                         config.clock);
+  return gClient;
+}
+
+// Releases `slot` if it still holds `promise`; false when the operation was
+// cancelled and its result must be dropped.
+template <typename T>
+bool releaseSlot(std::shared_ptr<Promise<T>>& slot, const std::shared_ptr<Promise<T>>& promise) {
+  std::lock_guard<std::mutex> lock(gMutex);
+  if (slot != promise) return false;
+  slot = nullptr;
+  return true;
+}
+
+// Runs an OIDC sign-in for the slot `slot` and keeps the result as the session under `provider`.
+void runLogin(const std::shared_ptr<OidcClient>& client, std::shared_ptr<Promise<Result<AuthUser>>>& slot,
+       const std::shared_ptr<Promise<Result<AuthUser>>>& promise, AuthProvider provider,
+       const std::optional<LoginOptions>& options) {
+  auto flow = client->login(options);
+  flow->addOnResolvedListener([&slot, promise, provider](const Result<AuthUser>& result) {
+    if (!result) {
+      if (releaseSlot(slot, promise)) promise->resolve(result);
+      return;
+    }
+    AuthUser user = result.value();
+    user.provider = provider;
+    {
+      std::lock_guard<std::mutex> lock(gMutex);
+      if (slot != promise) return;
+      slot = nullptr;
+      gSession = user;
+    }
+    promise->resolve(user);
+  });
+}
+
+} // namespace
+
+void LinuxPlatformAuth::configure(LinuxPlatformConfig config) {
+  std::lock_guard<std::mutex> lock(gMutex);
+  gConfig = std::move(config);
+  gClient = nullptr;
+  gMetadata = nullptr;
+  gSession = std::nullopt;
+}
+
+LinuxPlatformConfig LinuxPlatformAuth::config() {
+  std::lock_guard<std::mutex> lock(gMutex);
+  return configLocked();
+}
+
+std::shared_ptr<Promise<Result<AuthUser>>> PlatformAuth::login(AuthProvider provider,
+                                                               const std::optional<LoginOptions>& options) {
+  auto promise = Promise<Result<AuthUser>>::create();
+  // Generic OIDC runs in the core; only authorizeInBrowser() reaches the platform.
+  if (provider == AuthProvider::OIDC) {
+    promise->resolve(AuthErrorCode::UNSUPPORTED_PROVIDER);
+    return promise;
+  }
+  std::shared_ptr<OidcClient> client;
+  {
+    std::lock_guard<std::mutex> lock(gMutex);
+    if (gLoginPromise) {
+      promise->resolve(AuthErrorCode::OPERATION_IN_PROGRESS);
+      return promise;
+    }
+    client = clientLocked();
+    if (!client) {
+      promise->resolve(AuthErrorCode::CONFIGURATION_ERROR);
+      return promise;
+    }
+    gLoginPromise = promise;
+  }
+  runLogin(client, gLoginPromise, promise, provider, options);
+  return promise;
+}
+
+std::shared_ptr<Promise<Result<AuthUser>>> PlatformAuth::requestScopes(const std::vector<std::string>& scopes) {
+  auto promise = Promise<Result<AuthUser>>::create();
+  std::shared_ptr<OidcClient> client;
+  AuthProvider provider;
+  LoginOptions options;
+  {
+    std::lock_guard<std::mutex> lock(gMutex);
+    if (!gSession) {
+      promise->resolve(AuthErrorCode::NOT_SIGNED_IN);
+      return promise;
+    }
+    if (gScopesPromise) {
+      promise->resolve(AuthErrorCode::OPERATION_IN_PROGRESS);
+      return promise;
+    }
+    client = clientLocked();
+    if (!client) {
+      promise->resolve(AuthErrorCode::CONFIGURATION_ERROR);
+      return promise;
+    }
+    // Incremental consent: a new sign-in for the union of the granted and requested scopes.
+    auto merged = gSession->scopes.value_or(std::vector<std::string>{});
+    for (const auto& scope : scopes) {
+      if (std::find(merged.begin(), merged.end(), scope) == merged.end()) merged.push_back(scope);
+    }
+    options.scopes = merged;
+    options.loginHint = gSession->email;
+    provider = gSession->provider;
+    gScopesPromise = promise;
+  }
+  runLogin(client, gScopesPromise, promise, provider, options);
+  return promise;
+}
+
+std::shared_ptr<Promise<Result<AuthTokens>>> PlatformAuth::refreshToken(const std::optional<AuthProvider>& provider,
+                                    const std::vector<std::string>& scopes) {
+  auto promise = Promise<Result<AuthTokens>>::create();
+  std::shared_ptr<OidcClient> client;
+  std::string refreshToken;
+  {
+    std::lock_guard<std::mutex> lock(gMutex);
+    if (!gSession || (provider && *provider != gSession->provider)) {
+      promise->resolve(AuthErrorCode::NOT_SIGNED_IN);
+      return promise;
+    }
+    if (!gSession->refreshToken || gSession->refreshToken->empty()) {
+      promise->resolve(AuthErrorCode::REFRESH_FAILED);
+      return promise;
+    }
+    if (gRefreshPromise) {
+      promise->resolve(AuthErrorCode::OPERATION_IN_PROGRESS);
+      return promise;
+    }
+    client = clientLocked();
+    if (!client) {
+      promise->resolve(AuthErrorCode::CONFIGURATION_ERROR);
+      return promise;
+    }
+    refreshToken = *gSession->refreshToken;
+    gRefreshPromise = promise;
+  }
+
+  auto flow = client->refresh(refreshToken, scopes);
+  const bool isSessionRefresh = scopes.empty();
+  flow->addOnResolvedListener([promise, refreshToken, isSessionRefresh](const Result<AuthTokens>& result) {
+    if (!result) {
+      if (releaseSlot(gRefreshPromise, promise)) promise->resolve(result);
+      return;
+    }
+    const AuthTokens& tokens = result.value();
+    {
+      std::lock_guard<std::mutex> lock(gMutex);
+      if (gRefreshPromise != promise) return;
+      gRefreshPromise = nullptr;
+      // The server rotates on every refresh, down-scoped ones included.
+      if (gSession && gSession->refreshToken == refreshToken) {
+        if (tokens.refreshToken) gSession->refreshToken = tokens.refreshToken;
+        if (isSessionRefresh) {
+          if (tokens.idToken) gSession->idToken = tokens.idToken;
+          if (tokens.accessToken) gSession->accessToken = tokens.accessToken;
+          if (tokens.expirationTime) gSession->expirationTime = tokens.expirationTime;
+        }
+      }
+    }
+    promise->resolve(tokens);
+  });
+  return promise;
+}
+
+std::shared_ptr<Promise<Result<std::optional<AuthUser>>>> PlatformAuth::silentRestore() {
+  auto promise = Promise<Result<std::optional<AuthUser>>>::create();
+  std::optional<AuthUser> session;
+  {
+    std::lock_guard<std::mutex> lock(gMutex);
+    session = gSession;
+  }
+  promise->resolve(session);
+  return promise;
+}
+
+bool PlatformAuth::hasPlayServices() {
+  return false;
+}
+
+// The headless "browser": one request to the authorization endpoint, whose
+// redirect back to `redirectUri` is the result. Consent is the provider's to script.
+std::shared_ptr<Promise<Result<std::string>>> PlatformAuth::authorizeInBrowser(const std::string& url,
+                                       const std::string& redirectUri) {
+  auto promise = Promise<Result<std::string>>::create();
+  HttpRequest request;
+  request.url = url;
+  sharedHttpClient()->send(request, [promise, redirectUri](HttpResponse response) {
+    auto location = response.headers.find("location");
+    if (response.status == 0) {
+      promise->resolve(AuthErrorCode::NETWORK_ERROR);
+    } else if (response.status >= 300 && response.status < 400 && location != response.headers.end() &&
+         location->second.compare(0, redirectUri.size(), redirectUri) == 0) {
+      promise->resolve(location->second);
+    } else if (response.status >= 500) {
+      promise->resolve(AuthErrorCode::NETWORK_ERROR);
+    } else {
+      // The provider refused to redirect at all: an unknown client or redirect URI.
+      promise->resolve(AuthErrorCode::CONFIGURATION_ERROR);
+    }
+  });
+  return promise;
+}
+
+std::shared_ptr<HttpClient> PlatformAuth::httpClient() {
+  return sharedHttpClient();
+}
+
+std::string PlatformAuth::cacheDirectory() {
+  std::lock_guard<std::mutex> lock(gMutex);
+  return cacheDirectoryFor(configLocked());
+}
+
+std::vector<std::string> PlatformAuth::discoveryAuthorities() {
+  std::lock_guard<std::mutex> lock(gMutex);
+  const auto config = configLocked();
+  if (config.issuer.empty()) return {};
+  return {config.issuer};
+}
+
+void PlatformAuth::logout() {
+  std::lock_guard<std::mutex> lock(gMutex);
+  gSession = std::nullopt;
+}
+
+// Signs out locally first, then revokes the grant (RFC 7009) so its refresh
+// token and every rotation of it stop working on the server.
+std::shared_ptr<Promise<Result<void>>> PlatformAuth::revokeAccess() {
+  auto promise = Promise<Result<void>>::create();
+  std::optional<AuthUser> session;
+  std::shared_ptr<OidcMetadataCache> metadata;
+  LinuxPlatformConfig config;
+  {
+    std::lock_guard<std::mutex> lock(gMutex);
+    session = std::move(gSession);
+    gSession = std::nullopt;
+    config = configLocked();
+    clientLocked();
+    metadata = gMetadata;
+  }
+  if (!session || !session->refreshToken || !metadata) {
+    promise->resolve(Result<void>());
+    return promise;
+  }
+  auto lookup = metadata->get(config.issuer);
+  lookup->addOnResolvedListener([promise, config, refreshToken = *session->refreshToken](
+                   const Result<std::shared_ptr<const OidcMetadata>>& entry) {
+    if (!entry) {
+      promise->resolve(entry.error());
+      return;
+    }
+    const auto& revocationEndpoint = entry.value()->provider.revocationEndpoint;
+    if (!revocationEndpoint) {
+      promise->resolve(Result<void>());
+      return;
+    }
+    HttpRequest request;
+    request.method = "POST";
+    request.url = *revocationEndpoint;
+    request.headers.emplace_back("Content-Type", "application/x-www-form-urlencoded");
+    request.body = OidcClient::formEncode({
+      {"token", refreshToken},
+      {"token_type_hint", "refresh_token"},
+      {"client_id", config.clientId},
+    });
+    sharedHttpClient()->send(request, [promise](HttpResponse response) {
+      if (response.status >= 200 && response.status < 300) {
+        promise->resolve(Result<void>());
+      } else {
+        const auto code = response.status == 0 || response.status >= 500 ? AuthErrorCode::NETWORK_ERROR
+                                         : AuthErrorCode::TOKEN_ERROR;
+        promise->resolve(code);
+      }
+    });
+  });
+  return promise;
+}
+
+void PlatformAuth::cancel(PlatformOperation operation, const std::string& reason) {
+  std::shared_ptr<Promise<Result<AuthUser>>> userPromise;
+  std::shared_ptr<Promise<Result<AuthTokens>>> refreshPromise;
+  {
+    std::lock_guard<std::mutex> lock(gMutex);
+    switch (operation) {
+      case PlatformOperation::LOGIN:
+        userPromise = std::move(gLoginPromise);
+        gLoginPromise = nullptr;
+        break;
+      case PlatformOperation::REQUEST_SCOPES:
+        userPromise = std::move(gScopesPromise);
+        gScopesPromise = nullptr;
+        break;
+      case PlatformOperation::REFRESH_TOKEN:
+        refreshPromise = std::move(gRefreshPromise);
+        gRefreshPromise = nullptr;
+        break;
+      case PlatformOperation::SILENT_RESTORE:
+        // Restores resolve synchronously from memory; nothing is ever pending.
+        break;
+    }
+  }
+  // A late OidcClient result finds an empty slot and is dropped.
+  const AuthError error(reason);
+  if (userPromise) userPromise->resolve(error);
+  if (refreshPromise) refreshPromise->resolve(error);
+}
+
+} // namespace margelo::nitro::NitroAuth
@@ -0,0 +1,36 @@
+#pragma once
+
+#include "AuthClock.hpp"
+#include <memory>
+#include <string>
+
+namespace margelo::nitro::NitroAuth {
+
+struct LinuxPlatformConfig {
+  // OpenID issuer that every native provider (Google, Apple, Microsoft) signs
+  // in against; on a development machine, a LoopbackOAuthServer's issuer().
+  std::string issuer;
+  std::string clientId = "nitro-auth-linux";
+  // Never loaded: the headless browser stops at the redirect to it.
+  std::string redirectUri = "http://127.0.0.1/oauth2/callback";
+  // Empty picks $XDG_CACHE_HOME/nitro-auth, then $HOME/.cache/nitro-auth.
+  std::string cacheDirectory;
+  // Checks id_token `iat`/`exp` and stamps `expirationTime`.
+  std::shared_ptr<AuthClock> clock = AuthClock::system();
+};
+
+// Headless Linux PlatformAuth, for running, profiling and benchmarking the
+// native pipeline without a device. Sign-in is authorization code + PKCE
+// through the core's OidcClient, with a "browser" that requests the
+// authorization URL and takes the provider's redirect as the result, so it
+// needs a provider that decides consent without a human, such as
+// LoopbackOAuthServer. The session lives in process memory only.
+class LinuxPlatformAuth {
+public:
+  // Replaces the configuration and signs out. Before the first call, the
+  // issuer and client id come from NITRO_AUTH_ISSUER and NITRO_AUTH_CLIENT_ID.
+  static void configure(LinuxPlatformConfig config);
+  static LinuxPlatformConfig config();
+};
+
+} // namespace margelo::nitro::NitroAuth
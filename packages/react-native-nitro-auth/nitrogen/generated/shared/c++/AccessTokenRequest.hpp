@@ -0,0 +1,89 @@
+///
+/// AccessTokenRequest.hpp
+/// This file was generated by nitrogen. DO NOT MODIFY THIS FILE.
+/// https://github.com/mrousavy/nitro
+/// Copyright © Marc Rousavy @ Margelo
+///
+
+#pragma once
+
+#if __has_include(<NitroModules/JSIConverter.hpp>)
+#include <NitroModules/JSIConverter.hpp>
+#else
+#error NitroModules cannot be found! Are you sure you installed NitroModules properly?
+#endif
+#if __has_include(<NitroModules/NitroDefines.hpp>)
+#include <NitroModules/NitroDefines.hpp>
+#else
+#error NitroModules cannot be found! Are you sure you installed NitroModules properly?
+#endif
+#if __has_include(<NitroModules/JSIHelpers.hpp>)
+#include <NitroModules/JSIHelpers.hpp>
+#else
+#error NitroModules cannot be found! Are you sure you installed NitroModules properly?
+#endif
+#if __has_include(<NitroModules/PropNameIDCache.hpp>)
+#include <NitroModules/PropNameIDCache.hpp>
+#else
+#error NitroModules cannot be found! Are you sure you installed NitroModules properly?
+#endif
+
+
+
+#include <string>
+#include <optional>
+#include <vector>
+
+namespace margelo::nitro::NitroAuth {
+
+  /**
+   * A struct which can be represented as a JavaScript object (AccessTokenRequest).
+   */
+  struct AccessTokenRequest final {
+  public:
+    std::optional<std::string> resource     SWIFT_PRIVATE;
+    std::optional<std::vector<std::string>> scopes     SWIFT_PRIVATE;
+
+  public:
+    AccessTokenRequest() = default;
+    explicit AccessTokenRequest(std::optional<std::string> resource, std::optional<std::vector<std::string>> scopes): resource(resource), scopes(scopes) {}
+
+  public:
+    friend bool operator==(const AccessTokenRequest& lhs, const AccessTokenRequest& rhs) = default;
+  };
+
+} // namespace margelo::nitro::NitroAuth
+
+namespace margelo::nitro {
+
+  // C++ AccessTokenRequest <> JS AccessTokenRequest (object)
+  template <>
+  struct JSIConverter<margelo::nitro::NitroAuth::AccessTokenRequest> final {
+    static inline margelo::nitro::NitroAuth::AccessTokenRequest fromJSI(jsi::Runtime& runtime, const jsi::Value& arg) {
+      jsi::Object obj = arg.asObject(runtime);
+      return margelo::nitro::NitroAuth::AccessTokenRequest(
+        JSIConverter<std::optional<std::string>>::fromJSI(runtime, obj.getProperty(runtime, PropNameIDCache::get(runtime, "resource"))),
+        JSIConverter<std::optional<std::vector<std::string>>>::fromJSI(runtime, obj.getProperty(runtime, PropNameIDCache::get(runtime, "scopes")))
+      );
+    }
+    static inline jsi::Value toJSI(jsi::Runtime& runtime, const margelo::nitro::NitroAuth::AccessTokenRequest& arg) {
+      jsi::Object obj(runtime);
+      obj.setProperty(runtime, PropNameIDCache::get(runtime, "resource"), JSIConverter<std::optional<std::string>>::toJSI(runtime, arg.resource));
+      obj.setProperty(runtime, PropNameIDCache::get(runtime, "scopes"), JSIConverter<std::optional<std::vector<std::string>>>::toJSI(runtime, arg.scopes));
+      return obj;
+    }
+    static inline bool canConvert(jsi::Runtime& runtime, const jsi::Value& value) {
+      if (!value.isObject()) {
+        return false;
+      }
+      jsi::Object obj = value.getObject(runtime);
+      if (!nitro::isPlainObject(runtime, obj)) {
+        return false;
+      }
+      if (!JSIConverter<std::optional<std::string>>::canConvert(runtime, obj.getProperty(runtime, PropNameIDCache::get(runtime, "resource")))) return false;
+      if (!JSIConverter<std::optional<std::vector<std::string>>>::canConvert(runtime, obj.getProperty(runtime, PropNameIDCache::get(runtime, "scopes")))) return false;
+      return true;
+    }
+  };
+
+} // namespace margelo::nitro
@@ -0,0 +1,104 @@
+///
+/// AuthAccount.hpp
+/// This file was generated by nitrogen. DO NOT MODIFY THIS FILE.
+/// https://github.com/mrousavy/nitro
+/// Copyright © Marc Rousavy @ Margelo
+///
+
+#pragma once
+
+#if __has_include(<NitroModules/JSIConverter.hpp>)
+#include <NitroModules/JSIConverter.hpp>
+#else
+#error NitroModules cannot be found! Are you sure you installed NitroModules properly?
+#endif
+#if __has_include(<NitroModules/NitroDefines.hpp>)
+#include <NitroModules/NitroDefines.hpp>
+#else
+#error NitroModules cannot be found! Are you sure you installed NitroModules properly?
+#endif
+#if __has_include(<NitroModules/JSIHelpers.hpp>)
+#include <NitroModules/JSIHelpers.hpp>
+#else
+#error NitroModules cannot be found! Are you sure you installed NitroModules properly?
+#endif
+#if __has_include(<NitroModules/PropNameIDCache.hpp>)
+#include <NitroModules/PropNameIDCache.hpp>
+#else
+#error NitroModules cannot be found! Are you sure you installed NitroModules properly?
+#endif
+
+
+
+// Forward declaration of `AuthProvider` to properly resolve imports.
+namespace margelo::nitro::NitroAuth { enum class AuthProvider; }
+
+#include <string>
+#include "AuthProvider.hpp"
+#include <optional>
+
+namespace margelo::nitro::NitroAuth {
+
+  /**
+   * A struct which can be represented as a JavaScript object (AuthAccount).
+   */
+  struct AuthAccount final {
+  public:
+    std::string id     SWIFT_PRIVATE;
+    AuthProvider provider     SWIFT_PRIVATE;
+    std::optional<std::string> email     SWIFT_PRIVATE;
+    std::optional<std::string> name     SWIFT_PRIVATE;
+    bool isActive     SWIFT_PRIVATE;
+
+  public:
+    AuthAccount() = default;
+    explicit AuthAccount(std::string id, AuthProvider provider, std::optional<std::string> email, std::optional<std::string> name, bool isActive): id(id), provider(provider), email(email), name(name), isActive(isActive) {}
+
+  public:
+    friend bool operator==(const AuthAccount& lhs, const AuthAccount& rhs) = default;
+  };
+
+} // namespace margelo::nitro::NitroAuth
+
+namespace margelo::nitro {
+
+  // C++ AuthAccount <> JS AuthAccount (object)
+  template <>
+  struct JSIConverter<margelo::nitro::NitroAuth::AuthAccount> final {
+    static inline margelo::nitro::NitroAuth::AuthAccount fromJSI(jsi::Runtime& runtime, const jsi::Value& arg) {
+      jsi::Object obj = arg.asObject(runtime);
+      return margelo::nitro::NitroAuth::AuthAccount(
+        JSIConverter<std::string>::fromJSI(runtime, obj.getProperty(runtime, PropNameIDCache::get(runtime, "id"))),
+        JSIConverter<margelo::nitro::NitroAuth::AuthProvider>::fromJSI(runtime, obj.getProperty(runtime, PropNameIDCache::get(runtime, "provider"))),
+        JSIConverter<std::optional<std::string>>::fromJSI(runtime, obj.getProperty(runtime, PropNameIDCache::get(runtime, "email"))),
+        JSIConverter<std::optional<std::string>>::fromJSI(runtime, obj.getProperty(runtime, PropNameIDCache::get(runtime, "name"))),
+        JSIConverter<bool>::fromJSI(runtime, obj.getProperty(runtime, PropNameIDCache::get(runtime, "isActive")))
+      );
+    }
+    static inline jsi::Value toJSI(jsi::Runtime& runtime, const margelo::nitro::NitroAuth::AuthAccount& arg) {
+      jsi::Object obj(runtime);
+      obj.setProperty(runtime, PropNameIDCache::get(runtime, "id"), JSIConverter<std::string>::toJSI(runtime, arg.id));
+      obj.setProperty(runtime, PropNameIDCache::get(runtime, "provider"), JSIConverter<margelo::nitro::NitroAuth::AuthProvider>::toJSI(runtime, arg.provider));
+      obj.setProperty(runtime, PropNameIDCache::get(runtime, "email"), JSIConverter<std::optional<std::string>>::toJSI(runtime, arg.email));
+      obj.setProperty(runtime, PropNameIDCache::get(runtime, "name"), JSIConverter<std::optional<std::string>>::toJSI(runtime, arg.name));
+      obj.setProperty(runtime, PropNameIDCache::get(runtime, "isActive"), JSIConverter<bool>::toJSI(runtime, arg.isActive));
+      return obj;
+    }
+    static inline bool canConvert(jsi::Runtime& runtime, const jsi::Value& value) {
+      if (!value.isObject()) {
+        return false;
+      }
+      jsi::Object obj = value.getObject(runtime);
+      if (!nitro::isPlainObject(runtime, obj)) {
+        return false;
+      }
+      if (!JSIConverter<std::string>::canConvert(runtime, obj.getProperty(runtime, PropNameIDCache::get(runtime, "id")))) return false;
+      if (!JSIConverter<margelo::nitro::NitroAuth::AuthProvider>::canConvert(runtime, obj.getProperty(runtime, PropNameIDCache::get(runtime, "provider")))) return false;
+      if (!JSIConverter<std::optional<std::string>>::canConvert(runtime, obj.getProperty(runtime, PropNameIDCache::get(runtime, "email")))) return false;
+      if (!JSIConverter<std::optional<std::string>>::canConvert(runtime, obj.getProperty(runtime, PropNameIDCache::get(runtime, "name")))) return false;
+      if (!JSIConverter<bool>::canConvert(runtime, obj.getProperty(runtime, PropNameIDCache::get(runtime, "isActive")))) return false;
+      return true;
+    }
+  };
+
+} // namespace margelo::nitro
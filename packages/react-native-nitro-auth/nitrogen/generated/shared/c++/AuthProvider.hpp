@@ -32,6 +32,7 @@ namespace margelo::nitro::NitroAuth {
     GOOGLE      SWIFT_NAME(google) = 0,
     APPLE      SWIFT_NAME(apple) = 1,
     MICROSOFT      SWIFT_NAME(microsoft) = 2,
+    OIDC      SWIFT_NAME(oidc) = 3,
   } CLOSED_ENUM;
 
 } // namespace margelo::nitro::NitroAuth
@@ -47,6 +48,7 @@ namespace margelo::nitro {
         case hashString("google"): return margelo::nitro::NitroAuth::AuthProvider::GOOGLE;
         case hashString("apple"): return margelo::nitro::NitroAuth::AuthProvider::APPLE;
         case hashString("microsoft"): return margelo::nitro::NitroAuth::AuthProvider::MICROSOFT;
+        case hashString("oidc"): return margelo::nitro::NitroAuth::AuthProvider::OIDC;
         default: [[unlikely]]
           throw std::invalid_argument("Cannot convert \"" + unionValue + "\" to enum AuthProvider - invalid value!");
       }
@@ -56,6 +58,7 @@ namespace margelo::nitro {
         case margelo::nitro::NitroAuth::AuthProvider::GOOGLE: return JSIConverter<std::string>::toJSI(runtime, "google");
         case margelo::nitro::NitroAuth::AuthProvider::APPLE: return JSIConverter<std::string>::toJSI(runtime, "apple");
         case margelo::nitro::NitroAuth::AuthProvider::MICROSOFT: return JSIConverter<std::string>::toJSI(runtime, "microsoft");
+        case margelo::nitro::NitroAuth::AuthProvider::OIDC: return JSIConverter<std::string>::toJSI(runtime, "oidc");
         default: [[unlikely]]
           throw std::invalid_argument("Cannot convert AuthProvider to JS - invalid value: "
                                     + std::to_string(static_cast<int>(arg)) + "!");
@@ -70,6 +73,7 @@ namespace margelo::nitro {
         case hashString("google"):
         case hashString("apple"):
         case hashString("microsoft"):
+        case hashString("oidc"):
           return true;
         default:
           return false;
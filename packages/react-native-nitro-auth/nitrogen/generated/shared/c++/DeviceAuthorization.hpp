@@ -0,0 +1,100 @@
+///
+/// DeviceAuthorization.hpp
+/// This file was generated by nitrogen. DO NOT MODIFY THIS FILE.
+/// https://github.com/mrousavy/nitro
+/// Copyright © Marc Rousavy @ Margelo
+///
+
+#pragma once
+
+#if __has_include(<NitroModules/JSIConverter.hpp>)
+#include <NitroModules/JSIConverter.hpp>
+#else
+#error NitroModules cannot be found! Are you sure you installed NitroModules properly?
+#endif
+#if __has_include(<NitroModules/NitroDefines.hpp>)
+#include <NitroModules/NitroDefines.hpp>
+#else
+#error NitroModules cannot be found! Are you sure you installed NitroModules properly?
+#endif
+#if __has_include(<NitroModules/JSIHelpers.hpp>)
+#include <NitroModules/JSIHelpers.hpp>
+#else
+#error NitroModules cannot be found! Are you sure you installed NitroModules properly?
+#endif
+#if __has_include(<NitroModules/PropNameIDCache.hpp>)
+#include <NitroModules/PropNameIDCache.hpp>
+#else
+#error NitroModules cannot be found! Are you sure you installed NitroModules properly?
+#endif
+
+
+
+#include <string>
+#include <optional>
+
+namespace margelo::nitro::NitroAuth {
+
+  /**
+   * A struct which can be represented as a JavaScript object (DeviceAuthorization).
+   */
+  struct DeviceAuthorization final {
+  public:
+    std::string userCode     SWIFT_PRIVATE;
+    std::string verificationUri     SWIFT_PRIVATE;
+    std::optional<std::string> verificationUriComplete     SWIFT_PRIVATE;
+    double expiresAt     SWIFT_PRIVATE;
+    double interval     SWIFT_PRIVATE;
+
+  public:
+    DeviceAuthorization() = default;
+    explicit DeviceAuthorization(std::string userCode, std::string verificationUri, std::optional<std::string> verificationUriComplete, double expiresAt, double interval): userCode(userCode), verificationUri(verificationUri), verificationUriComplete(verificationUriComplete), expiresAt(expiresAt), interval(interval) {}
+
+  public:
+    friend bool operator==(const DeviceAuthorization& lhs, const DeviceAuthorization& rhs) = default;
+  };
+
+} // namespace margelo::nitro::NitroAuth
+
+namespace margelo::nitro {
+
+  // C++ DeviceAuthorization <> JS DeviceAuthorization (object)
+  template <>
+  struct JSIConverter<margelo::nitro::NitroAuth::DeviceAuthorization> final {
+    static inline margelo::nitro::NitroAuth::DeviceAuthorization fromJSI(jsi::Runtime& runtime, const jsi::Value& arg) {
+      jsi::Object obj = arg.asObject(runtime);
+      return margelo::nitro::NitroAuth::DeviceAuthorization(
+        JSIConverter<std::string>::fromJSI(runtime, obj.getProperty(runtime, PropNameIDCache::get(runtime, "userCode"))),
+        JSIConverter<std::string>::fromJSI(runtime, obj.getProperty(runtime, PropNameIDCache::get(runtime, "verificationUri"))),
+        JSIConverter<std::optional<std::string>>::fromJSI(runtime, obj.getProperty(runtime, PropNameIDCache::get(runtime, "verificationUriComplete"))),
+        JSIConverter<double>::fromJSI(runtime, obj.getProperty(runtime, PropNameIDCache::get(runtime, "expiresAt"))),
+        JSIConverter<double>::fromJSI(runtime, obj.getProperty(runtime, PropNameIDCache::get(runtime, "interval")))
+      );
+    }
+    static inline jsi::Value toJSI(jsi::Runtime& runtime, const margelo::nitro::NitroAuth::DeviceAuthorization& arg) {
+      jsi::Object obj(runtime);
+      obj.setProperty(runtime, PropNameIDCache::get(runtime, "userCode"), JSIConverter<std::string>::toJSI(runtime, arg.userCode));
+      obj.setProperty(runtime, PropNameIDCache::get(runtime, "verificationUri"), JSIConverter<std::string>::toJSI(runtime, arg.verificationUri));
+      obj.setProperty(runtime, PropNameIDCache::get(runtime, "verificationUriComplete"), JSIConverter<std::optional<std::string>>::toJSI(runtime, arg.verificationUriComplete));
+      obj.setProperty(runtime, PropNameIDCache::get(runtime, "expiresAt"), JSIConverter<double>::toJSI(runtime, arg.expiresAt));
+      obj.setProperty(runtime, PropNameIDCache::get(runtime, "interval"), JSIConverter<double>::toJSI(runtime, arg.interval));
+      return obj;
+    }
+    static inline bool canConvert(jsi::Runtime& runtime, const jsi::Value& value) {
+      if (!value.isObject()) {
+        return false;
+      }
+      jsi::Object obj = value.getObject(runtime);
+      if (!nitro::isPlainObject(runtime, obj)) {
+        return false;
+      }
+      if (!JSIConverter<std::string>::canConvert(runtime, obj.getProperty(runtime, PropNameIDCache::get(runtime, "userCode")))) return false;
+      if (!JSIConverter<std::string>::canConvert(runtime, obj.getProperty(runtime, PropNameIDCache::get(runtime, "verificationUri")))) return false;
+      if (!JSIConverter<std::optional<std::string>>::canConvert(runtime, obj.getProperty(runtime, PropNameIDCache::get(runtime, "verificationUriComplete")))) return false;
+      if (!JSIConverter<double>::canConvert(runtime, obj.getProperty(runtime, PropNameIDCache::get(runtime, "expiresAt")))) return false;
+      if (!JSIConverter<double>::canConvert(runtime, obj.getProperty(runtime, PropNameIDCache::get(runtime, "interval")))) return false;
+      return true;
+    }
+  };
+
+} // namespace margelo::nitro
@@ -17,6 +17,11 @@ namespace margelo::nitro::NitroAuth {
       prototype.registerHybridGetter("currentUser", &HybridAuthSpec::getCurrentUser);
       prototype.registerHybridGetter("grantedScopes", &HybridAuthSpec::getGrantedScopes);
       prototype.registerHybridGetter("hasPlayServices", &HybridAuthSpec::getHasPlayServices);
+      prototype.registerHybridGetter("accounts", &HybridAuthSpec::getAccounts);
+      prototype.registerHybridGetter("sessionVersion", &HybridAuthSpec::getSessionVersion);
+      prototype.registerHybridMethod("getSessionSnapshot", &HybridAuthSpec::getSessionSnapshot);
+      prototype.registerHybridMethod("getCurrentUserIfChanged", &HybridAuthSpec::getCurrentUserIfChanged);
+      prototype.registerHybridMethod("getMemoryStats", &HybridAuthSpec::getMemoryStats);
       prototype.registerHybridMethod("login", &HybridAuthSpec::login);
       prototype.registerHybridMethod("requestScopes", &HybridAuthSpec::requestScopes);
       prototype.registerHybridMethod("revokeScopes", &HybridAuthSpec::revokeScopes);
@@ -28,6 +33,11 @@ namespace margelo::nitro::NitroAuth {
       prototype.registerHybridMethod("onAuthStateChanged", &HybridAuthSpec::onAuthStateChanged);
       prototype.registerHybridMethod("onTokensRefreshed", &HybridAuthSpec::onTokensRefreshed);
       prototype.registerHybridMethod("setLoggingEnabled", &HybridAuthSpec::setLoggingEnabled);
+      prototype.registerHybridMethod("switchAccount", &HybridAuthSpec::switchAccount);
+      prototype.registerHybridMethod("getAccessTokenForAccount", &HybridAuthSpec::getAccessTokenForAccount);
+      prototype.registerHybridMethod("verifyIdToken", &HybridAuthSpec::verifyIdToken);
+      prototype.registerHybridMethod("configureOidc", &HybridAuthSpec::configureOidc);
+      prototype.registerHybridMethod("onDeviceCode", &HybridAuthSpec::onDeviceCode);
     });
   }
 
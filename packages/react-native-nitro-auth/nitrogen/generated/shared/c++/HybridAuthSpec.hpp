@@ -21,6 +21,24 @@ namespace margelo::nitro::NitroAuth { enum class AuthProvider; }
 namespace margelo::nitro::NitroAuth { struct LoginOptions; }
 // Forward declaration of `AuthTokens` to properly resolve imports.
 namespace margelo::nitro::NitroAuth { struct AuthTokens; }
+// Forward declaration of `AccessTokenRequest` to properly resolve imports.
+namespace margelo::nitro::NitroAuth { struct AccessTokenRequest; }
+// Forward declaration of `AuthAccount` to properly resolve imports.
+namespace margelo::nitro::NitroAuth { struct AuthAccount; }
+// Forward declaration of `SessionSnapshot` to properly resolve imports.
+namespace margelo::nitro::NitroAuth { struct SessionSnapshot; }
+// Forward declaration of `UserChange` to properly resolve imports.
+namespace margelo::nitro::NitroAuth { struct UserChange; }
+// Forward declaration of `MemoryStats` to properly resolve imports.
+namespace margelo::nitro::NitroAuth { struct MemoryStats; }
+// Forward declaration of `IdTokenClaims` to properly resolve imports.
+namespace margelo::nitro::NitroAuth { struct IdTokenClaims; }
+// Forward declaration of `IdTokenVerificationOptions` to properly resolve imports.
+namespace margelo::nitro::NitroAuth { struct IdTokenVerificationOptions; }
+// Forward declaration of `OidcProviderConfig` to properly resolve imports.
+namespace margelo::nitro::NitroAuth { struct OidcProviderConfig; }
+// Forward declaration of `DeviceAuthorization` to properly resolve imports.
+namespace margelo::nitro::NitroAuth { struct DeviceAuthorization; }
 
 #include "AuthUser.hpp"
 #include <optional>
@@ -29,7 +47,16 @@ namespace margelo::nitro::NitroAuth { struct AuthTokens; }
 #include <NitroModules/Promise.hpp>
 #include "AuthProvider.hpp"
 #include "LoginOptions.hpp"
+#include "AccessTokenRequest.hpp"
 #include "AuthTokens.hpp"
+#include "AuthAccount.hpp"
+#include "SessionSnapshot.hpp"
+#include "UserChange.hpp"
+#include "MemoryStats.hpp"
+#include "IdTokenClaims.hpp"
+#include "IdTokenVerificationOptions.hpp"
+#include "OidcProviderConfig.hpp"
+#include "DeviceAuthorization.hpp"
 #include <functional>
 
 namespace margelo::nitro::NitroAuth {
@@ -62,20 +89,30 @@ namespace margelo::nitro::NitroAuth {
       virtual std::optional<AuthUser> getCurrentUser() = 0;
       virtual std::vector<std::string> getGrantedScopes() = 0;
       virtual bool getHasPlayServices() = 0;
+      virtual std::vector<AuthAccount> getAccounts() = 0;
+      virtual double getSessionVersion() = 0;
 
     public:
       // Methods
+      virtual SessionSnapshot getSessionSnapshot() = 0;
+      virtual std::optional<UserChange> getCurrentUserIfChanged(double sinceVersion) = 0;
+      virtual MemoryStats getMemoryStats() = 0;
       virtual std::shared_ptr<Promise<void>> login(AuthProvider provider, const std::optional<LoginOptions>& options) = 0;
       virtual std::shared_ptr<Promise<void>> requestScopes(const std::vector<std::string>& scopes) = 0;
       virtual std::shared_ptr<Promise<void>> revokeScopes(const std::vector<std::string>& scopes) = 0;
       virtual std::shared_ptr<Promise<void>> revokeAccess() = 0;
-      virtual std::shared_ptr<Promise<std::optional<std::string>>> getAccessToken() = 0;
+      virtual std::shared_ptr<Promise<std::optional<std::string>>> getAccessToken(const std::optional<AccessTokenRequest>& request) = 0;
       virtual std::shared_ptr<Promise<AuthTokens>> refreshToken() = 0;
       virtual void logout() = 0;
       virtual std::shared_ptr<Promise<void>> silentRestore() = 0;
       virtual std::function<void()> onAuthStateChanged(const std::function<void(const std::optional<AuthUser>& /* user */)>& callback) = 0;
       virtual std::function<void()> onTokensRefreshed(const std::function<void(const AuthTokens& /* tokens */)>& callback) = 0;
       virtual void setLoggingEnabled(bool enabled) = 0;
+      virtual void switchAccount(const std::string& accountId) = 0;
+      virtual std::shared_ptr<Promise<std::optional<std::string>>> getAccessTokenForAccount(const std::string& accountId, const std::optional<AccessTokenRequest>& request) = 0;
+      virtual std::shared_ptr<Promise<IdTokenClaims>> verifyIdToken(const IdTokenVerificationOptions& options) = 0;
+      virtual void configureOidc(const OidcProviderConfig& config) = 0;
+      virtual std::function<void()> onDeviceCode(const std::function<void(const DeviceAuthorization& /* authorization */)>& callback) = 0;
 
     protected:
       // Hybrid Setup
@@ -0,0 +1,109 @@
+///
+/// IdTokenClaims.hpp
+/// This file was generated by nitrogen. DO NOT MODIFY THIS FILE.
+/// https://github.com/mrousavy/nitro
+/// Copyright © Marc Rousavy @ Margelo
+///
+
+#pragma once
+
+#if __has_include(<NitroModules/JSIConverter.hpp>)
+#include <NitroModules/JSIConverter.hpp>
+#else
+#error NitroModules cannot be found! Are you sure you installed NitroModules properly?
+#endif
+#if __has_include(<NitroModules/NitroDefines.hpp>)
+#include <NitroModules/NitroDefines.hpp>
+#else
+#error NitroModules cannot be found! Are you sure you installed NitroModules properly?
+#endif
+#if __has_include(<NitroModules/JSIHelpers.hpp>)
+#include <NitroModules/JSIHelpers.hpp>
+#else
+#error NitroModules cannot be found! Are you sure you installed NitroModules properly?
+#endif
+#if __has_include(<NitroModules/PropNameIDCache.hpp>)
+#include <NitroModules/PropNameIDCache.hpp>
+#else
+#error NitroModules cannot be found! Are you sure you installed NitroModules properly?
+#endif
+
+
+
+#include <string>
+#include <vector>
+#include <optional>
+
+namespace margelo::nitro::NitroAuth {
+
+  /**
+   * A struct which can be represented as a JavaScript object (IdTokenClaims).
+   */
+  struct IdTokenClaims final {
+  public:
+    std::string issuer     SWIFT_PRIVATE;
+    std::string subject     SWIFT_PRIVATE;
+    std::vector<std::string> audience     SWIFT_PRIVATE;
+    double expiresAt     SWIFT_PRIVATE;
+    std::optional<double> issuedAt     SWIFT_PRIVATE;
+    std::optional<std::string> nonce     SWIFT_PRIVATE;
+    std::optional<std::string> email     SWIFT_PRIVATE;
+
+  public:
+    IdTokenClaims() = default;
+    explicit IdTokenClaims(std::string issuer, std::string subject, std::vector<std::string> audience, double expiresAt, std::optional<double> issuedAt, std::optional<std::string> nonce, std::optional<std::string> email): issuer(issuer), subject(subject), audience(audience), expiresAt(expiresAt), issuedAt(issuedAt), nonce(nonce), email(email) {}
+
+  public:
+    friend bool operator==(const IdTokenClaims& lhs, const IdTokenClaims& rhs) = default;
+  };
+
+} // namespace margelo::nitro::NitroAuth
+
+namespace margelo::nitro {
+
+  // C++ IdTokenClaims <> JS IdTokenClaims (object)
+  template <>
+  struct JSIConverter<margelo::nitro::NitroAuth::IdTokenClaims> final {
+    static inline margelo::nitro::NitroAuth::IdTokenClaims fromJSI(jsi::Runtime& runtime, const jsi::Value& arg) {
+      jsi::Object obj = arg.asObject(runtime);
+      return margelo::nitro::NitroAuth::IdTokenClaims(
+        JSIConverter<std::string>::fromJSI(runtime, obj.getProperty(runtime, PropNameIDCache::get(runtime, "issuer"))),
+        JSIConverter<std::string>::fromJSI(runtime, obj.getProperty(runtime, PropNameIDCache::get(runtime, "subject"))),
+        JSIConverter<std::vector<std::string>>::fromJSI(runtime, obj.getProperty(runtime, PropNameIDCache::get(runtime, "audience"))),
+        JSIConverter<double>::fromJSI(runtime, obj.getProperty(runtime, PropNameIDCache::get(runtime, "expiresAt"))),
+        JSIConverter<std::optional<double>>::fromJSI(runtime, obj.getProperty(runtime, PropNameIDCache::get(runtime, "issuedAt"))),
+        JSIConverter<std::optional<std::string>>::fromJSI(runtime, obj.getProperty(runtime, PropNameIDCache::get(runtime, "nonce"))),
+        JSIConverter<std::optional<std::string>>::fromJSI(runtime, obj.getProperty(runtime, PropNameIDCache::get(runtime, "email")))
+      );
+    }
+    static inline jsi::Value toJSI(jsi::Runtime& runtime, const margelo::nitro::NitroAuth::IdTokenClaims& arg) {
+      jsi::Object obj(runtime);
+      obj.setProperty(runtime, PropNameIDCache::get(runtime, "issuer"), JSIConverter<std::string>::toJSI(runtime, arg.issuer));
+      obj.setProperty(runtime, PropNameIDCache::get(runtime, "subject"), JSIConverter<std::string>::toJSI(runtime, arg.subject));
+      obj.setProperty(runtime, PropNameIDCache::get(runtime, "audience"), JSIConverter<std::vector<std::string>>::toJSI(runtime, arg.audience));
+      obj.setProperty(runtime, PropNameIDCache::get(runtime, "expiresAt"), JSIConverter<double>::toJSI(runtime, arg.expiresAt));
+      obj.setProperty(runtime, PropNameIDCache::get(runtime, "issuedAt"), JSIConverter<std::optional<double>>::toJSI(runtime, arg.issuedAt));
+      obj.setProperty(runtime, PropNameIDCache::get(runtime, "nonce"), JSIConverter<std::optional<std::string>>::toJSI(runtime, arg.nonce));
+      obj.setProperty(runtime, PropNameIDCache::get(runtime, "email"), JSIConverter<std::optional<std::string>>::toJSI(runtime, arg.email));
+      return obj;
+    }
+    static inline bool canConvert(jsi::Runtime& runtime, const jsi::Value& value) {
+      if (!value.isObject()) {
+        return false;
+      }
+      jsi::Object obj = value.getObject(runtime);
+      if (!nitro::isPlainObject(runtime, obj)) {
+        return false;
+      }
+      if (!JSIConverter<std::string>::canConvert(runtime, obj.getProperty(runtime, PropNameIDCache::get(runtime, "issuer")))) return false;
+      if (!JSIConverter<std::string>::canConvert(runtime, obj.getProperty(runtime, PropNameIDCache::get(runtime, "subject")))) return false;
+      if (!JSIConverter<std::vector<std::string>>::canConvert(runtime, obj.getProperty(runtime, PropNameIDCache::get(runtime, "audience")))) return false;
+      if (!JSIConverter<double>::canConvert(runtime, obj.getProperty(runtime, PropNameIDCache::get(runtime, "expiresAt")))) return false;
+      if (!JSIConverter<std::optional<double>>::canConvert(runtime, obj.getProperty(runtime, PropNameIDCache::get(runtime, "issuedAt")))) return false;
+      if (!JSIConverter<std::optional<std::string>>::canConvert(runtime, obj.getProperty(runtime, PropNameIDCache::get(runtime, "nonce")))) return false;
+      if (!JSIConverter<std::optional<std::string>>::canConvert(runtime, obj.getProperty(runtime, PropNameIDCache::get(runtime, "email")))) return false;
+      return true;
+    }
+  };
+
+} // namespace margelo::nitro
@@ -0,0 +1,88 @@
+///
+/// IdTokenVerificationOptions.hpp
+/// This file was generated by nitrogen. DO NOT MODIFY THIS FILE.
+/// https://github.com/mrousavy/nitro
+/// Copyright © Marc Rousavy @ Margelo
+///
+
+#pragma once
+
+#if __has_include(<NitroModules/JSIConverter.hpp>)
+#include <NitroModules/JSIConverter.hpp>
+#else
+#error NitroModules cannot be found! Are you sure you installed NitroModules properly?
+#endif
+#if __has_include(<NitroModules/NitroDefines.hpp>)
+#include <NitroModules/NitroDefines.hpp>
+#else
+#error NitroModules cannot be found! Are you sure you installed NitroModules properly?
+#endif
+#if __has_include(<NitroModules/JSIHelpers.hpp>)
+#include <NitroModules/JSIHelpers.hpp>
+#else
+#error NitroModules cannot be found! Are you sure you installed NitroModules properly?
+#endif
+#if __has_include(<NitroModules/PropNameIDCache.hpp>)
+#include <NitroModules/PropNameIDCache.hpp>
+#else
+#error NitroModules cannot be found! Are you sure you installed NitroModules properly?
+#endif
+
+
+
+#include <string>
+#include <optional>
+
+namespace margelo::nitro::NitroAuth {
+
+  /**
+   * A struct which can be represented as a JavaScript object (IdTokenVerificationOptions).
+   */
+  struct IdTokenVerificationOptions final {
+  public:
+    std::string audience     SWIFT_PRIVATE;
+    std::optional<std::string> nonce     SWIFT_PRIVATE;
+
+  public:
+    IdTokenVerificationOptions() = default;
+    explicit IdTokenVerificationOptions(std::string audience, std::optional<std::string> nonce): audience(audience), nonce(nonce) {}
+
+  public:
+    friend bool operator==(const IdTokenVerificationOptions& lhs, const IdTokenVerificationOptions& rhs) = default;
+  };
+
+} // namespace margelo::nitro::NitroAuth
+
+namespace margelo::nitro {
+
+  // C++ IdTokenVerificationOptions <> JS IdTokenVerificationOptions (object)
+  template <>
+  struct JSIConverter<margelo::nitro::NitroAuth::IdTokenVerificationOptions> final {
+    static inline margelo::nitro::NitroAuth::IdTokenVerificationOptions fromJSI(jsi::Runtime& runtime, const jsi::Value& arg) {
+      jsi::Object obj = arg.asObject(runtime);
+      return margelo::nitro::NitroAuth::IdTokenVerificationOptions(
+        JSIConverter<std::string>::fromJSI(runtime, obj.getProperty(runtime, PropNameIDCache::get(runtime, "audience"))),
+        JSIConverter<std::optional<std::string>>::fromJSI(runtime, obj.getProperty(runtime, PropNameIDCache::get(runtime, "nonce")))
+      );
+    }
+    static inline jsi::Value toJSI(jsi::Runtime& runtime, const margelo::nitro::NitroAuth::IdTokenVerificationOptions& arg) {
+      jsi::Object obj(runtime);
+      obj.setProperty(runtime, PropNameIDCache::get(runtime, "audience"), JSIConverter<std::string>::toJSI(runtime, arg.audience));
+      obj.setProperty(runtime, PropNameIDCache::get(runtime, "nonce"), JSIConverter<std::optional<std::string>>::toJSI(runtime, arg.nonce));
+      return obj;
+    }
+    static inline bool canConvert(jsi::Runtime& runtime, const jsi::Value& value) {
+      if (!value.isObject()) {
+        return false;
+      }
+      jsi::Object obj = value.getObject(runtime);
+      if (!nitro::isPlainObject(runtime, obj)) {
+        return false;
+      }
+      if (!JSIConverter<std::string>::canConvert(runtime, obj.getProperty(runtime, PropNameIDCache::get(runtime, "audience")))) return false;
+      if (!JSIConverter<std::optional<std::string>>::canConvert(runtime, obj.getProperty(runtime, PropNameIDCache::get(runtime, "nonce")))) return false;
+      return true;
+    }
+  };
+
+} // namespace margelo::nitro
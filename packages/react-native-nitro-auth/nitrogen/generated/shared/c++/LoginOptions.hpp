@@ -57,10 +57,11 @@ namespace margelo::nitro::NitroAuth {
     std::optional<bool> requestVerifiedPhoneNumber     SWIFT_PRIVATE;
     std::optional<std::string> tenant     SWIFT_PRIVATE;
     std::optional<MicrosoftPrompt> prompt     SWIFT_PRIVATE;
+    std::optional<bool> useDeviceCode     SWIFT_PRIVATE;
 
   public:
     LoginOptions() = default;
-    explicit LoginOptions(std::optional<std::vector<std::string>> scopes, std::optional<std::string> loginHint, std::optional<std::string> nonce, std::optional<bool> useOneTap, std::optional<bool> useSheet, std::optional<bool> forceAccountPicker, std::optional<bool> filterByAuthorizedAccounts, std::optional<bool> useLegacyGoogleSignIn, std::optional<bool> forceCodeForRefreshToken, std::optional<std::string> hostedDomain, std::optional<std::string> openIDRealm, std::optional<bool> requestVerifiedPhoneNumber, std::optional<std::string> tenant, std::optional<MicrosoftPrompt> prompt): scopes(scopes), loginHint(loginHint), nonce(nonce), useOneTap(useOneTap), useSheet(useSheet), forceAccountPicker(forceAccountPicker), filterByAuthorizedAccounts(filterByAuthorizedAccounts), useLegacyGoogleSignIn(useLegacyGoogleSignIn), forceCodeForRefreshToken(forceCodeForRefreshToken), hostedDomain(hostedDomain), openIDRealm(openIDRealm), requestVerifiedPhoneNumber(requestVerifiedPhoneNumber), tenant(tenant), prompt(prompt) {}
+    explicit LoginOptions(std::optional<std::vector<std::string>> scopes, std::optional<std::string> loginHint, std::optional<std::string> nonce, std::optional<bool> useOneTap, std::optional<bool> useSheet, std::optional<bool> forceAccountPicker, std::optional<bool> filterByAuthorizedAccounts, std::optional<bool> useLegacyGoogleSignIn, std::optional<bool> forceCodeForRefreshToken, std::optional<std::string> hostedDomain, std::optional<std::string> openIDRealm, std::optional<bool> requestVerifiedPhoneNumber, std::optional<std::string> tenant, std::optional<MicrosoftPrompt> prompt, std::optional<bool> useDeviceCode): scopes(scopes), loginHint(loginHint), nonce(nonce), useOneTap(useOneTap), useSheet(useSheet), forceAccountPicker(forceAccountPicker), filterByAuthorizedAccounts(filterByAuthorizedAccounts), useLegacyGoogleSignIn(useLegacyGoogleSignIn), forceCodeForRefreshToken(forceCodeForRefreshToken), hostedDomain(hostedDomain), openIDRealm(openIDRealm), requestVerifiedPhoneNumber(requestVerifiedPhoneNumber), tenant(tenant), prompt(prompt), useDeviceCode(useDeviceCode) {}
 
   public:
     friend bool operator==(const LoginOptions& lhs, const LoginOptions& rhs) = default;
@@ -89,7 +90,8 @@ namespace margelo::nitro {
         JSIConverter<std::optional<std::string>>::fromJSI(runtime, obj.getProperty(runtime, PropNameIDCache::get(runtime, "openIDRealm"))),
         JSIConverter<std::optional<bool>>::fromJSI(runtime, obj.getProperty(runtime, PropNameIDCache::get(runtime, "requestVerifiedPhoneNumber"))),
         JSIConverter<std::optional<std::string>>::fromJSI(runtime, obj.getProperty(runtime, PropNameIDCache::get(runtime, "tenant"))),
-        JSIConverter<std::optional<margelo::nitro::NitroAuth::MicrosoftPrompt>>::fromJSI(runtime, obj.getProperty(runtime, PropNameIDCache::get(runtime, "prompt")))
+        JSIConverter<std::optional<margelo::nitro::NitroAuth::MicrosoftPrompt>>::fromJSI(runtime, obj.getProperty(runtime, PropNameIDCache::get(runtime, "prompt"))),
+        JSIConverter<std::optional<bool>>::fromJSI(runtime, obj.getProperty(runtime, PropNameIDCache::get(runtime, "useDeviceCode")))
       );
     }
     static inline jsi::Value toJSI(jsi::Runtime& runtime, const margelo::nitro::NitroAuth::LoginOptions& arg) {
@@ -108,6 +110,7 @@ namespace margelo::nitro {
       obj.setProperty(runtime, PropNameIDCache::get(runtime, "requestVerifiedPhoneNumber"), JSIConverter<std::optional<bool>>::toJSI(runtime, arg.requestVerifiedPhoneNumber));
       obj.setProperty(runtime, PropNameIDCache::get(runtime, "tenant"), JSIConverter<std::optional<std::string>>::toJSI(runtime, arg.tenant));
       obj.setProperty(runtime, PropNameIDCache::get(runtime, "prompt"), JSIConverter<std::optional<margelo::nitro::NitroAuth::MicrosoftPrompt>>::toJSI(runtime, arg.prompt));
+      obj.setProperty(runtime, PropNameIDCache::get(runtime, "useDeviceCode"), JSIConverter<std::optional<bool>>::toJSI(runtime, arg.useDeviceCode));
       return obj;
     }
     static inline bool canConvert(jsi::Runtime& runtime, const jsi::Value& value) {
@@ -132,6 +135,7 @@ namespace margelo::nitro {
       if (!JSIConverter<std::optional<bool>>::canConvert(runtime, obj.getProperty(runtime, PropNameIDCache::get(runtime, "requestVerifiedPhoneNumber")))) return false;
       if (!JSIConverter<std::optional<std::string>>::canConvert(runtime, obj.getProperty(runtime, PropNameIDCache::get(runtime, "tenant")))) return false;
       if (!JSIConverter<std::optional<margelo::nitro::NitroAuth::MicrosoftPrompt>>::canConvert(runtime, obj.getProperty(runtime, PropNameIDCache::get(runtime, "prompt")))) return false;
+      if (!JSIConverter<std::optional<bool>>::canConvert(runtime, obj.getProperty(runtime, PropNameIDCache::get(runtime, "useDeviceCode")))) return false;
       return true;
     }
   };
@@ -0,0 +1,110 @@
+///
+/// MemoryStats.hpp
+/// This file was generated by nitrogen. DO NOT MODIFY THIS FILE.
+/// https://github.com/mrousavy/nitro
+/// Copyright © Marc Rousavy @ Margelo
+///
+
+#pragma once
+
+#if __has_include(<NitroModules/JSIConverter.hpp>)
+#include <NitroModules/JSIConverter.hpp>
+#else
+#error NitroModules cannot be found! Are you sure you installed NitroModules properly?
+#endif
+#if __has_include(<NitroModules/NitroDefines.hpp>)
+#include <NitroModules/NitroDefines.hpp>
+#else
+#error NitroModules cannot be found! Are you sure you installed NitroModules properly?
+#endif
+#if __has_include(<NitroModules/JSIHelpers.hpp>)
+#include <NitroModules/JSIHelpers.hpp>
+#else
+#error NitroModules cannot be found! Are you sure you installed NitroModules properly?
+#endif
+#if __has_include(<NitroModules/PropNameIDCache.hpp>)
+#include <NitroModules/PropNameIDCache.hpp>
+#else
+#error NitroModules cannot be found! Are you sure you installed NitroModules properly?
+#endif
+
+
+
+// Forward declaration of `MemoryUsage` to properly resolve imports.
+namespace margelo::nitro::NitroAuth { struct MemoryUsage; }
+
+#include "MemoryUsage.hpp"
+
+namespace margelo::nitro::NitroAuth {
+
+  /**
+   * A struct which can be represented as a JavaScript object (MemoryStats).
+   */
+  struct MemoryStats final {
+  public:
+    MemoryUsage sessions     SWIFT_PRIVATE;
+    MemoryUsage listeners     SWIFT_PRIVATE;
+    MemoryUsage pendingOperations     SWIFT_PRIVATE;
+    MemoryUsage platformOperations     SWIFT_PRIVATE;
+    MemoryUsage accessTokenCache     SWIFT_PRIVATE;
+    double totalBytes     SWIFT_PRIVATE;
+    double peakBytes     SWIFT_PRIVATE;
+
+  public:
+    MemoryStats() = default;
+    explicit MemoryStats(MemoryUsage sessions, MemoryUsage listeners, MemoryUsage pendingOperations, MemoryUsage platformOperations, MemoryUsage accessTokenCache, double totalBytes, double peakBytes): sessions(sessions), listeners(listeners), pendingOperations(pendingOperations), platformOperations(platformOperations), accessTokenCache(accessTokenCache), totalBytes(totalBytes), peakBytes(peakBytes) {}
+
+  public:
+    friend bool operator==(const MemoryStats& lhs, const MemoryStats& rhs) = default;
+  };
+
+} // namespace margelo::nitro::NitroAuth
+
+namespace margelo::nitro {
+
+  // C++ MemoryStats <> JS MemoryStats (object)
+  template <>
+  struct JSIConverter<margelo::nitro::NitroAuth::MemoryStats> final {
+    static inline margelo::nitro::NitroAuth::MemoryStats fromJSI(jsi::Runtime& runtime, const jsi::Value& arg) {
+      jsi::Object obj = arg.asObject(runtime);
+      return margelo::nitro::NitroAuth::MemoryStats(
+        JSIConverter<margelo::nitro::NitroAuth::MemoryUsage>::fromJSI(runtime, obj.getProperty(runtime, PropNameIDCache::get(runtime, "sessions"))),
+        JSIConverter<margelo::nitro::NitroAuth::MemoryUsage>::fromJSI(runtime, obj.getProperty(runtime, PropNameIDCache::get(runtime, "listeners"))),
+        JSIConverter<margelo::nitro::NitroAuth::MemoryUsage>::fromJSI(runtime, obj.getProperty(runtime, PropNameIDCache::get(runtime, "pendingOperations"))),
+        JSIConverter<margelo::nitro::NitroAuth::MemoryUsage>::fromJSI(runtime, obj.getProperty(runtime, PropNameIDCache::get(runtime, "platformOperations"))),
+        JSIConverter<margelo::nitro::NitroAuth::MemoryUsage>::fromJSI(runtime, obj.getProperty(runtime, PropNameIDCache::get(runtime, "accessTokenCache"))),
+        JSIConverter<double>::fromJSI(runtime, obj.getProperty(runtime, PropNameIDCache::get(runtime, "totalBytes"))),
+        JSIConverter<double>::fromJSI(runtime, obj.getProperty(runtime, PropNameIDCache::get(runtime, "peakBytes")))
+      );
+    }
+    static inline jsi::Value toJSI(jsi::Runtime& runtime, const margelo::nitro::NitroAuth::MemoryStats& arg) {
+      jsi::Object obj(runtime);
+      obj.setProperty(runtime, PropNameIDCache::get(runtime, "sessions"), JSIConverter<margelo::nitro::NitroAuth::MemoryUsage>::toJSI(runtime, arg.sessions));
+      obj.setProperty(runtime, PropNameIDCache::get(runtime, "listeners"), JSIConverter<margelo::nitro::NitroAuth::MemoryUsage>::toJSI(runtime, arg.listeners));
+      obj.setProperty(runtime, PropNameIDCache::get(runtime, "pendingOperations"), JSIConverter<margelo::nitro::NitroAuth::MemoryUsage>::toJSI(runtime, arg.pendingOperations));
+      obj.setProperty(runtime, PropNameIDCache::get(runtime, "platformOperations"), JSIConverter<margelo::nitro::NitroAuth::MemoryUsage>::toJSI(runtime, arg.platformOperations));
+      obj.setProperty(runtime, PropNameIDCache::get(runtime, "accessTokenCache"), JSIConverter<margelo::nitro::NitroAuth::MemoryUsage>::toJSI(runtime, arg.accessTokenCache));
+      obj.setProperty(runtime, PropNameIDCache::get(runtime, "totalBytes"), JSIConverter<double>::toJSI(runtime, arg.totalBytes));
+      obj.setProperty(runtime, PropNameIDCache::get(runtime, "peakBytes"), JSIConverter<double>::toJSI(runtime, arg.peakBytes));
+      return obj;
+    }
+    static inline bool canConvert(jsi::Runtime& runtime, const jsi::Value& value) {
+      if (!value.isObject()) {
+        return false;
+      }
+      jsi::Object obj = value.getObject(runtime);
+      if (!nitro::isPlainObject(runtime, obj)) {
+        return false;
+      }
+      if (!JSIConverter<margelo::nitro::NitroAuth::MemoryUsage>::canConvert(runtime, obj.getProperty(runtime, PropNameIDCache::get(runtime, "sessions")))) return false;
+      if (!JSIConverter<margelo::nitro::NitroAuth::MemoryUsage>::canConvert(runtime, obj.getProperty(runtime, PropNameIDCache::get(runtime, "listeners")))) return false;
+      if (!JSIConverter<margelo::nitro::NitroAuth::MemoryUsage>::canConvert(runtime, obj.getProperty(runtime, PropNameIDCache::get(runtime, "pendingOperations")))) return false;
+      if (!JSIConverter<margelo::nitro::NitroAuth::MemoryUsage>::canConvert(runtime, obj.getProperty(runtime, PropNameIDCache::get(runtime, "platformOperations")))) return false;
+      if (!JSIConverter<margelo::nitro::NitroAuth::MemoryUsage>::canConvert(runtime, obj.getProperty(runtime, PropNameIDCache::get(runtime, "accessTokenCache")))) return false;
+      if (!JSIConverter<double>::canConvert(runtime, obj.getProperty(runtime, PropNameIDCache::get(runtime, "totalBytes")))) return false;
+      if (!JSIConverter<double>::canConvert(runtime, obj.getProperty(runtime, PropNameIDCache::get(runtime, "peakBytes")))) return false;
+      return true;
+    }
+  };
+
+} // namespace margelo::nitro
@@ -0,0 +1,97 @@
+///
+/// OidcProviderConfig.hpp
+/// This file was generated by nitrogen. DO NOT MODIFY THIS FILE.
+/// https://github.com/mrousavy/nitro
+/// Copyright © Marc Rousavy @ Margelo
+///
+
+#pragma once
+
+#if __has_include(<NitroModules/JSIConverter.hpp>)
+#include <NitroModules/JSIConverter.hpp>
+#else
+#error NitroModules cannot be found! Are you sure you installed NitroModules properly?
+#endif
+#if __has_include(<NitroModules/NitroDefines.hpp>)
+#include <NitroModules/NitroDefines.hpp>
+#else
+#error NitroModules cannot be found! Are you sure you installed NitroModules properly?
+#endif
+#if __has_include(<NitroModules/JSIHelpers.hpp>)
+#include <NitroModules/JSIHelpers.hpp>
+#else
+#error NitroModules cannot be found! Are you sure you installed NitroModules properly?
+#endif
+#if __has_include(<NitroModules/PropNameIDCache.hpp>)
+#include <NitroModules/PropNameIDCache.hpp>
+#else
+#error NitroModules cannot be found! Are you sure you installed NitroModules properly?
+#endif
+
+
+
+#include <string>
+#include <vector>
+#include <optional>
+
+namespace margelo::nitro::NitroAuth {
+
+  /**
+   * A struct which can be represented as a JavaScript object (OidcProviderConfig).
+   */
+  struct OidcProviderConfig final {
+  public:
+    std::string issuer     SWIFT_PRIVATE;
+    std::string clientId     SWIFT_PRIVATE;
+    std::string redirectUri     SWIFT_PRIVATE;
+    std::optional<std::vector<std::string>> scopes     SWIFT_PRIVATE;
+
+  public:
+    OidcProviderConfig() = default;
+    explicit OidcProviderConfig(std::string issuer, std::string clientId, std::string redirectUri, std::optional<std::vector<std::string>> scopes): issuer(issuer), clientId(clientId), redirectUri(redirectUri), scopes(scopes) {}
+
+  public:
+    friend bool operator==(const OidcProviderConfig& lhs, const OidcProviderConfig& rhs) = default;
+  };
+
+} // namespace margelo::nitro::NitroAuth
+
+namespace margelo::nitro {
+
+  // C++ OidcProviderConfig <> JS OidcProviderConfig (object)
+  template <>
+  struct JSIConverter<margelo::nitro::NitroAuth::OidcProviderConfig> final {
+    static inline margelo::nitro::NitroAuth::OidcProviderConfig fromJSI(jsi::Runtime& runtime, const jsi::Value& arg) {
+      jsi::Object obj = arg.asObject(runtime);
+      return margelo::nitro::NitroAuth::OidcProviderConfig(
+        JSIConverter<std::string>::fromJSI(runtime, obj.getProperty(runtime, PropNameIDCache::get(runtime, "issuer"))),
+        JSIConverter<std::string>::fromJSI(runtime, obj.getProperty(runtime, PropNameIDCache::get(runtime, "clientId"))),
+        JSIConverter<std::string>::fromJSI(runtime, obj.getProperty(runtime, PropNameIDCache::get(runtime, "redirectUri"))),
+        JSIConverter<std::optional<std::vector<std::string>>>::fromJSI(runtime, obj.getProperty(runtime, PropNameIDCache::get(runtime, "scopes")))
+      );
+    }
+    static inline jsi::Value toJSI(jsi::Runtime& runtime, const margelo::nitro::NitroAuth::OidcProviderConfig& arg) {
+      jsi::Object obj(runtime);
+      obj.setProperty(runtime, PropNameIDCache::get(runtime, "issuer"), JSIConverter<std::string>::toJSI(runtime, arg.issuer));
+      obj.setProperty(runtime, PropNameIDCache::get(runtime, "clientId"), JSIConverter<std::string>::toJSI(runtime, arg.clientId));
+      obj.setProperty(runtime, PropNameIDCache::get(runtime, "redirectUri"), JSIConverter<std::string>::toJSI(runtime, arg.redirectUri));
+      obj.setProperty(runtime, PropNameIDCache::get(runtime, "scopes"), JSIConverter<std::optional<std::vector<std::string>>>::toJSI(runtime, arg.scopes));
+      return obj;
+    }
+    static inline bool canConvert(jsi::Runtime& runtime, const jsi::Value& value) {
+      if (!value.isObject()) {
+        return false;
+      }
+      jsi::Object obj = value.getObject(runtime);
+      if (!nitro::isPlainObject(runtime, obj)) {
+        return false;
+      }
+      if (!JSIConverter<std::string>::canConvert(runtime, obj.getProperty(runtime, PropNameIDCache::get(runtime, "issuer")))) return false;
+      if (!JSIConverter<std::string>::canConvert(runtime, obj.getProperty(runtime, PropNameIDCache::get(runtime, "clientId")))) return false;
+      if (!JSIConverter<std::string>::canConvert(runtime, obj.getProperty(runtime, PropNameIDCache::get(runtime, "redirectUri")))) return false;
+      if (!JSIConverter<std::optional<std::vector<std::string>>>::canConvert(runtime, obj.getProperty(runtime, PropNameIDCache::get(runtime, "scopes")))) return false;
+      return true;
+    }
+  };
+
+} // namespace margelo::nitro
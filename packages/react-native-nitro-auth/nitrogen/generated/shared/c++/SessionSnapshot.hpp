@@ -0,0 +1,105 @@
+///
+/// SessionSnapshot.hpp
+/// This file was generated by nitrogen. DO NOT MODIFY THIS FILE.
+/// https://github.com/mrousavy/nitro
+/// Copyright © Marc Rousavy @ Margelo
+///
+
+#pragma once
+
+#if __has_include(<NitroModules/JSIConverter.hpp>)
+#include <NitroModules/JSIConverter.hpp>
+#else
+#error NitroModules cannot be found! Are you sure you installed NitroModules properly?
+#endif
+#if __has_include(<NitroModules/NitroDefines.hpp>)
+#include <NitroModules/NitroDefines.hpp>
+#else
+#error NitroModules cannot be found! Are you sure you installed NitroModules properly?
+#endif
+#if __has_include(<NitroModules/JSIHelpers.hpp>)
+#include <NitroModules/JSIHelpers.hpp>
+#else
+#error NitroModules cannot be found! Are you sure you installed NitroModules properly?
+#endif
+#if __has_include(<NitroModules/PropNameIDCache.hpp>)
+#include <NitroModules/PropNameIDCache.hpp>
+#else
+#error NitroModules cannot be found! Are you sure you installed NitroModules properly?
+#endif
+
+
+
+// Forward declaration of `AuthUser` to properly resolve imports.
+namespace margelo::nitro::NitroAuth { struct AuthUser; }
+
+#include "AuthUser.hpp"
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace margelo::nitro::NitroAuth {
+
+  /**
+   * A struct which can be represented as a JavaScript object (SessionSnapshot).
+   */
+  struct SessionSnapshot final {
+  public:
+    std::optional<AuthUser> user     SWIFT_PRIVATE;
+    std::vector<std::string> scopes     SWIFT_PRIVATE;
+    bool hasValidAccessToken     SWIFT_PRIVATE;
+    std::optional<double> accessTokenExpiresIn     SWIFT_PRIVATE;
+    double version     SWIFT_PRIVATE;
+
+  public:
+    SessionSnapshot() = default;
+    explicit SessionSnapshot(std::optional<AuthUser> user, std::vector<std::string> scopes, bool hasValidAccessToken, std::optional<double> accessTokenExpiresIn, double version): user(user), scopes(scopes), hasValidAccessToken(hasValidAccessToken), accessTokenExpiresIn(accessTokenExpiresIn), version(version) {}
+
+  public:
+    friend bool operator==(const SessionSnapshot& lhs, const SessionSnapshot& rhs) = default;
+  };
+
+} // namespace margelo::nitro::NitroAuth
+
+namespace margelo::nitro {
+
+  // C++ SessionSnapshot <> JS SessionSnapshot (object)
+  template <>
+  struct JSIConverter<margelo::nitro::NitroAuth::SessionSnapshot> final {
+    static inline margelo::nitro::NitroAuth::SessionSnapshot fromJSI(jsi::Runtime& runtime, const jsi::Value& arg) {
+      jsi::Object obj = arg.asObject(runtime);
+      return margelo::nitro::NitroAuth::SessionSnapshot(
+        JSIConverter<std::optional<margelo::nitro::NitroAuth::AuthUser>>::fromJSI(runtime, obj.getProperty(runtime, PropNameIDCache::get(runtime, "user"))),
+        JSIConverter<std::vector<std::string>>::fromJSI(runtime, obj.getProperty(runtime, PropNameIDCache::get(runtime, "scopes"))),
+        JSIConverter<bool>::fromJSI(runtime, obj.getProperty(runtime, PropNameIDCache::get(runtime, "hasValidAccessToken"))),
+        JSIConverter<std::optional<double>>::fromJSI(runtime, obj.getProperty(runtime, PropNameIDCache::get(runtime, "accessTokenExpiresIn"))),
+        JSIConverter<double>::fromJSI(runtime, obj.getProperty(runtime, PropNameIDCache::get(runtime, "version")))
+      );
+    }
+    static inline jsi::Value toJSI(jsi::Runtime& runtime, const margelo::nitro::NitroAuth::SessionSnapshot& arg) {
+      jsi::Object obj(runtime);
+      obj.setProperty(runtime, PropNameIDCache::get(runtime, "user"), JSIConverter<std::optional<margelo::nitro::NitroAuth::AuthUser>>::toJSI(runtime, arg.user));
+      obj.setProperty(runtime, PropNameIDCache::get(runtime, "scopes"), JSIConverter<std::vector<std::string>>::toJSI(runtime, arg.scopes));
+      obj.setProperty(runtime, PropNameIDCache::get(runtime, "hasValidAccessToken"), JSIConverter<bool>::toJSI(runtime, arg.hasValidAccessToken));
+      obj.setProperty(runtime, PropNameIDCache::get(runtime, "accessTokenExpiresIn"), JSIConverter<std::optional<double>>::toJSI(runtime, arg.accessTokenExpiresIn));
+      obj.setProperty(runtime, PropNameIDCache::get(runtime, "version"), JSIConverter<double>::toJSI(runtime, arg.version));
+      return obj;
+    }
+    static inline bool canConvert(jsi::Runtime& runtime, const jsi::Value& value) {
+      if (!value.isObject()) {
+        return false;
+      }
+      jsi::Object obj = value.getObject(runtime);
+      if (!nitro::isPlainObject(runtime, obj)) {
+        return false;
+      }
+      if (!JSIConverter<std::optional<margelo::nitro::NitroAuth::AuthUser>>::canConvert(runtime, obj.getProperty(runtime, PropNameIDCache::get(runtime, "user")))) return false;
+      if (!JSIConverter<std::vector<std::string>>::canConvert(runtime, obj.getProperty(runtime, PropNameIDCache::get(runtime, "scopes")))) return false;
+      if (!JSIConverter<bool>::canConvert(runtime, obj.getProperty(runtime, PropNameIDCache::get(runtime, "hasValidAccessToken")))) return false;
+      if (!JSIConverter<std::optional<double>>::canConvert(runtime, obj.getProperty(runtime, PropNameIDCache::get(runtime, "accessTokenExpiresIn")))) return false;
+      if (!JSIConverter<double>::canConvert(runtime, obj.getProperty(runtime, PropNameIDCache::get(runtime, "version")))) return false;
+      return true;
+    }
+  };
+
+} // namespace margelo::nitro
@@ -0,0 +1,209 @@
+/* eslint-disable no-console */
+const { spawnSync } = require("child_process");
+const os = require("os");
+const path = require("path");
+
+const includeDir = path.join(__dirname, "../cpp");
+const nitrogenDir = path.join(__dirname, "../nitrogen/generated/shared/c++");
+const linuxDir = path.join(__dirname, "../linux");
+const mockIncludeDir = path.join(__dirname, "../cpp/__tests__/mock_includes");
+const filter = process.argv[2];
+const benchmarks = [
+  {
+    name: "json-serializer",
+    sources: [
+      path.join(__dirname, "../cpp/JSONSerializer.cpp"),
+      path.join(__dirname, "../cpp/__benchmarks__/JSONSerializerBenchmark.cpp"),
+    ],
+  },
+  {
+    name: "id-token-verifier",
+    sources: [
+      path.join(__dirname, "../cpp/IdTokenVerifier.cpp"),
+      path.join(__dirname, "../cpp/JwsCrypto.cpp"),
+      path.join(
+        __dirname,
+        "../cpp/__benchmarks__/IdTokenVerifierBenchmark.cpp",
+      ),
+    ],
+  },
+  {
+    name: "linux-end-to-end",
+    flags: ["-I" + linuxDir],
+    sources: [
+      path.join(__dirname, "../cpp/HybridAuth.cpp"),
+      path.join(__dirname, "../cpp/AuthUserHostObject.cpp"),
+      path.join(__dirname, "../cpp/AccountRegistry.cpp"),
+      path.join(__dirname, "../cpp/PackedAuthUser.cpp"),
+      path.join(__dirname, "../cpp/AccessTokenCache.cpp"),
+      path.join(__dirname, "../cpp/MemoryAccounting.cpp"),
+      path.join(__dirname, "../cpp/PendingOperationRegistry.cpp"),
+      path.join(__dirname, "../cpp/OidcMetadataCache.cpp"),
+      path.join(__dirname, "../cpp/OidcClient.cpp"),
+      path.join(__dirname, "../cpp/IdTokenVerifier.cpp"),
+      path.join(__dirname, "../cpp/JwsCrypto.cpp"),
+      path.join(__dirname, "../cpp/MicrosoftAuthority.cpp"),
+      path.join(__dirname, "../cpp/AuthClock.cpp"),
+      path.join(__dirname, "../cpp/ClockSkew.cpp"),
+      path.join(__dirname, "../cpp/RefreshBackoff.cpp"),
+      path.join(__dirname, "../cpp/RefreshTokenLedger.cpp"),
+      path.join(__dirname, "../cpp/SharedSessionSegment.cpp"),
+      path.join(__dirname, "../cpp/TimerService.cpp"),
+      path.join(__dirname, "../cpp/CancellationToken.cpp"),
+      path.join(__dirname, "../cpp/AuthResult.cpp"),
+      path.join(__dirname, "../cpp/AuthTrace.cpp"),
+      path.join(__dirname, "../linux/LoopbackHttp.cpp"),
+      path.join(__dirname, "../linux/LoopbackOAuthServer.cpp"),
+      path.join(__dirname, "../linux/LoopbackSigner.cpp"),
+      path.join(__dirname, "../linux/PlatformAuth+Linux.cpp"),
+      path.join(__dirname, "../cpp/__benchmarks__/LinuxEndToEndBenchmark.cpp"),
+    ],
+  },
+  {
+    name: "microsoft-authority",
+    sources: [
+      path.join(__dirname, "../cpp/MicrosoftAuthority.cpp"),
+      path.join(
+        __dirname,
+        "../cpp/__benchmarks__/MicrosoftAuthorityBenchmark.cpp",
+      ),
+    ],
+  },
+  {
+    name: "packed-auth-user",
+    sources: [
+      path.join(__dirname, "../cpp/PackedAuthUser.cpp"),
+      path.join(__dirname, "../cpp/MemoryAccounting.cpp"),
+      path.join(__dirname, "../cpp/__benchmarks__/PackedAuthUserBenchmark.cpp"),
+    ],
+  },
+  {
+    name: "user-view",
+    sources: [
+      path.join(__dirname, "../cpp/PackedAuthUser.cpp"),
+      path.join(__dirname, "../cpp/MemoryAccounting.cpp"),
+      path.join(__dirname, "../cpp/AuthUserHostObject.cpp"),
+      path.join(__dirname, "../cpp/__benchmarks__/UserViewBenchmark.cpp"),
+    ],
+  },
+  {
+    name: "pending-operations",
+    sources: [
+      path.join(__dirname, "../cpp/HybridAuth.cpp"),
+      path.join(__dirname, "../cpp/AuthUserHostObject.cpp"),
+      path.join(__dirname, "../cpp/AccountRegistry.cpp"),
+      path.join(__dirname, "../cpp/PackedAuthUser.cpp"),
+      path.join(__dirname, "../cpp/AccessTokenCache.cpp"),
+      path.join(__dirname, "../cpp/MemoryAccounting.cpp"),
+      path.join(__dirname, "../cpp/PendingOperationRegistry.cpp"),
+      path.join(__dirname, "../cpp/OidcMetadataCache.cpp"),
+      path.join(__dirname, "../cpp/OidcClient.cpp"),
+      path.join(__dirname, "../cpp/IdTokenVerifier.cpp"),
+      path.join(__dirname, "../cpp/JwsCrypto.cpp"),
+      path.join(__dirname, "../cpp/MicrosoftAuthority.cpp"),
+      path.join(__dirname, "../cpp/AuthClock.cpp"),
+      path.join(__dirname, "../cpp/ClockSkew.cpp"),
+      path.join(__dirname, "../cpp/RefreshBackoff.cpp"),
+      path.join(__dirname, "../cpp/RefreshTokenLedger.cpp"),
+      path.join(__dirname, "../cpp/SharedSessionSegment.cpp"),
+      path.join(__dirname, "../cpp/TimerService.cpp"),
+      path.join(__dirname, "../cpp/CancellationToken.cpp"),
+      path.join(__dirname, "../cpp/AuthResult.cpp"),
+      path.join(__dirname, "../cpp/AuthTrace.cpp"),
+      path.join(__dirname, "../cpp/__benchmarks__/PendingOperationsBenchmark.cpp"),
+    ],
+  },
+  {
+    name: "trace-replay",
+    sources: [
+      path.join(__dirname, "../cpp/HybridAuth.cpp"),
+      path.join(__dirname, "../cpp/AuthUserHostObject.cpp"),
+      path.join(__dirname, "../cpp/AccountRegistry.cpp"),
+      path.join(__dirname, "../cpp/PackedAuthUser.cpp"),
+      path.join(__dirname, "../cpp/AccessTokenCache.cpp"),
+      path.join(__dirname, "../cpp/MemoryAccounting.cpp"),
+      path.join(__dirname, "../cpp/PendingOperationRegistry.cpp"),
+      path.join(__dirname, "../cpp/OidcMetadataCache.cpp"),
+      path.join(__dirname, "../cpp/OidcClient.cpp"),
+      path.join(__dirname, "../cpp/IdTokenVerifier.cpp"),
+      path.join(__dirname, "../cpp/JwsCrypto.cpp"),
+      path.join(__dirname, "../cpp/MicrosoftAuthority.cpp"),
+      path.join(__dirname, "../cpp/AuthClock.cpp"),
+      path.join(__dirname, "../cpp/ClockSkew.cpp"),
+      path.join(__dirname, "../cpp/RefreshBackoff.cpp"),
+      path.join(__dirname, "../cpp/RefreshTokenLedger.cpp"),
+      path.join(__dirname, "../cpp/SharedSessionSegment.cpp"),
+      path.join(__dirname, "../cpp/TimerService.cpp"),
+      path.join(__dirname, "../cpp/CancellationToken.cpp"),
+      path.join(__dirname, "../cpp/AuthResult.cpp"),
+      path.join(__dirname, "../cpp/AuthTrace.cpp"),
+      path.join(__dirname, "../cpp/__benchmarks__/TraceReplayBenchmark.cpp"),
+    ],
+  },
+  {
+    name: "trace-replay-loopback",
+    flags: ["-I" + linuxDir, "-DNITRO_AUTH_REPLAY_LOOPBACK"],
+    sources: [
+      path.join(__dirname, "../cpp/HybridAuth.cpp"),
+      path.join(__dirname, "../cpp/AuthUserHostObject.cpp"),
+      path.join(__dirname, "../cpp/AccountRegistry.cpp"),
+      path.join(__dirname, "../cpp/PackedAuthUser.cpp"),
+      path.join(__dirname, "../cpp/AccessTokenCache.cpp"),
+      path.join(__dirname, "../cpp/MemoryAccounting.cpp"),
+      path.join(__dirname, "../cpp/PendingOperationRegistry.cpp"),
+      path.join(__dirname, "../cpp/OidcMetadataCache.cpp"),
+      path.join(__dirname, "../cpp/OidcClient.cpp"),
+      path.join(__dirname, "../cpp/IdTokenVerifier.cpp"),
+      path.join(__dirname, "../cpp/JwsCrypto.cpp"),
+      path.join(__dirname, "../cpp/MicrosoftAuthority.cpp"),
+      path.join(__dirname, "../cpp/AuthClock.cpp"),
+      path.join(__dirname, "../cpp/ClockSkew.cpp"),
+      path.join(__dirname, "../cpp/RefreshBackoff.cpp"),
+      path.join(__dirname, "../cpp/RefreshTokenLedger.cpp"),
+      path.join(__dirname, "../cpp/SharedSessionSegment.cpp"),
+      path.join(__dirname, "../cpp/TimerService.cpp"),
+      path.join(__dirname, "../cpp/CancellationToken.cpp"),
+      path.join(__dirname, "../cpp/AuthResult.cpp"),
+      path.join(__dirname, "../cpp/AuthTrace.cpp"),
+      path.join(__dirname, "../linux/LoopbackHttp.cpp"),
+      path.join(__dirname, "../linux/LoopbackOAuthServer.cpp"),
+      path.join(__dirname, "../linux/LoopbackSigner.cpp"),
+      path.join(__dirname, "../linux/PlatformAuth+Linux.cpp"),
+      path.join(__dirname, "../cpp/__benchmarks__/TraceReplayBenchmark.cpp"),
+    ],
+  },
+];
+
+for (const benchmark of benchmarks) {
+  if (filter && !benchmark.name.includes(filter)) {
+    continue;
+  }
+  const output = path.join(os.tmpdir(), `nitro-auth-bench-${benchmark.name}`);
+  console.log(`Compiling ${benchmark.name} benchmark...`);
+  const compile = spawnSync(
+    "clang++",
+    [
+      "-std=c++20",
+      "-O2",
+      "-DNDEBUG",
+      ...(benchmark.flags ?? []),
+      "-I" + includeDir,
+      "-I" + nitrogenDir,
+      "-I" + mockIncludeDir,
+      ...benchmark.sources,
+      "-o",
+      output,
+    ],
+    { stdio: "inherit" },
+  );
+  if (compile.status !== 0) {
+    console.error(`${benchmark.name} benchmark compilation failed`);
+    process.exit(1);
+  }
+
+  const run = spawnSync(output, [], { stdio: "inherit" });
+  if (run.status !== 0) {
+    console.error(`${benchmark.name} benchmark failed`);
+    process.exit(1);
+  }
+}
@@ -1,30 +1,348 @@
 /* eslint-disable no-console */
 const { spawnSync } = require("child_process");
 const fs = require("fs");
+const os = require("os");
 const path = require("path");
 
 const coverageEnabled = process.argv.includes("--coverage");
+const fuzzEnabled = process.argv.includes("--fuzz");
+const fuzzSeconds = Number(process.env.FUZZ_SECONDS ?? 60);
 const coverageThreshold = 90;
 const includeDir = path.join(__dirname, "../cpp");
 const nitrogenDir = path.join(__dirname, "../nitrogen/generated/shared/c++");
+const linuxDir = path.join(__dirname, "../linux");
 const mockIncludeDir = path.join(__dirname, "../cpp/__tests__/mock_includes");
 const coverageDir = path.join(__dirname, "../cpp/__tests__/.coverage");
 const tests = [
   {
     name: "serializer",
-    sources: [path.join(__dirname, "../cpp/__tests__/JSONSerializerTests.cpp")],
+    sources: [
+      path.join(__dirname, "../cpp/JSONSerializer.cpp"),
+      path.join(__dirname, "../cpp/__tests__/JSONSerializerTests.cpp"),
+    ],
     output: path.join(__dirname, "../cpp/__tests__/serializer_tests"),
-    coverageSources: [path.join(__dirname, "../cpp/JSONSerializer.hpp")],
+    coverageSources: [path.join(__dirname, "../cpp/JSONSerializer.cpp")],
+  },
+  {
+    name: "serializer-fuzz",
+    fuzz: true,
+    sources: [
+      path.join(__dirname, "../cpp/JSONSerializer.cpp"),
+      path.join(__dirname, "../cpp/__tests__/JSONSerializerFuzzer.cpp"),
+    ],
+    output: path.join(__dirname, "../cpp/__tests__/serializer_fuzz_tests"),
+    coverageSources: [path.join(__dirname, "../cpp/JSONSerializer.cpp")],
+  },
+  {
+    name: "journaled-session-store",
+    sources: [
+      path.join(__dirname, "../cpp/JournaledSessionStore.cpp"),
+      path.join(__dirname, "../cpp/JSONSerializer.cpp"),
+      path.join(__dirname, "../cpp/__tests__/JournaledSessionStoreTests.cpp"),
+    ],
+    output: path.join(__dirname, "../cpp/__tests__/journaled_session_store_tests"),
+    coverageSources: [path.join(__dirname, "../cpp/JournaledSessionStore.cpp")],
   },
   {
     name: "hybrid-auth",
     sources: [
       path.join(__dirname, "../cpp/HybridAuth.cpp"),
+      path.join(__dirname, "../cpp/AuthUserHostObject.cpp"),
+      path.join(__dirname, "../cpp/AccountRegistry.cpp"),
+      path.join(__dirname, "../cpp/PackedAuthUser.cpp"),
+      path.join(__dirname, "../cpp/AccessTokenCache.cpp"),
+      path.join(__dirname, "../cpp/MemoryAccounting.cpp"),
+      path.join(__dirname, "../cpp/PendingOperationRegistry.cpp"),
+      path.join(__dirname, "../cpp/OidcMetadataCache.cpp"),
+      path.join(__dirname, "../cpp/OidcClient.cpp"),
+      path.join(__dirname, "../cpp/IdTokenVerifier.cpp"),
+      path.join(__dirname, "../cpp/JwsCrypto.cpp"),
+      path.join(__dirname, "../cpp/MicrosoftAuthority.cpp"),
+      path.join(__dirname, "../cpp/AuthClock.cpp"),
+      path.join(__dirname, "../cpp/ClockSkew.cpp"),
+      path.join(__dirname, "../cpp/RefreshBackoff.cpp"),
+      path.join(__dirname, "../cpp/RefreshTokenLedger.cpp"),
+      path.join(__dirname, "../cpp/SharedSessionSegment.cpp"),
+      path.join(__dirname, "../cpp/TimerService.cpp"),
+      path.join(__dirname, "../cpp/CancellationToken.cpp"),
+      path.join(__dirname, "../cpp/AuthResult.cpp"),
+      path.join(__dirname, "../cpp/AuthTrace.cpp"),
       path.join(__dirname, "../cpp/__tests__/HybridAuthTests.cpp"),
     ],
     output: path.join(__dirname, "../cpp/__tests__/hybrid_auth_tests"),
+    coverageSources: [
+      path.join(__dirname, "../cpp/HybridAuth.cpp"),
+      path.join(__dirname, "../cpp/AuthUserHostObject.cpp"),
+      path.join(__dirname, "../cpp/AccountRegistry.cpp"),
+    ],
+  },
+  {
+    name: "token-lifecycle-simulation",
+    sources: [
+      path.join(__dirname, "../cpp/HybridAuth.cpp"),
+      path.join(__dirname, "../cpp/AuthUserHostObject.cpp"),
+      path.join(__dirname, "../cpp/AccountRegistry.cpp"),
+      path.join(__dirname, "../cpp/PackedAuthUser.cpp"),
+      path.join(__dirname, "../cpp/AccessTokenCache.cpp"),
+      path.join(__dirname, "../cpp/MemoryAccounting.cpp"),
+      path.join(__dirname, "../cpp/PendingOperationRegistry.cpp"),
+      path.join(__dirname, "../cpp/OidcMetadataCache.cpp"),
+      path.join(__dirname, "../cpp/OidcClient.cpp"),
+      path.join(__dirname, "../cpp/IdTokenVerifier.cpp"),
+      path.join(__dirname, "../cpp/JwsCrypto.cpp"),
+      path.join(__dirname, "../cpp/MicrosoftAuthority.cpp"),
+      path.join(__dirname, "../cpp/AuthClock.cpp"),
+      path.join(__dirname, "../cpp/ClockSkew.cpp"),
+      path.join(__dirname, "../cpp/RefreshBackoff.cpp"),
+      path.join(__dirname, "../cpp/RefreshTokenLedger.cpp"),
+      path.join(__dirname, "../cpp/SharedSessionSegment.cpp"),
+      path.join(__dirname, "../cpp/TimerService.cpp"),
+      path.join(__dirname, "../cpp/CancellationToken.cpp"),
+      path.join(__dirname, "../cpp/AuthResult.cpp"),
+      path.join(__dirname, "../cpp/AuthTrace.cpp"),
+      path.join(__dirname, "../cpp/__tests__/TokenLifecycleSimulation.cpp"),
+    ],
+    output: path.join(__dirname, "../cpp/__tests__/token_lifecycle_simulation"),
+    coverageSources: [path.join(__dirname, "../cpp/HybridAuth.cpp")],
+  },
+  {
+    name: "session-interleaving",
+    fuzz: true,
+    sources: [
+      path.join(__dirname, "../cpp/HybridAuth.cpp"),
+      path.join(__dirname, "../cpp/AuthUserHostObject.cpp"),
+      path.join(__dirname, "../cpp/AccountRegistry.cpp"),
+      path.join(__dirname, "../cpp/PackedAuthUser.cpp"),
+      path.join(__dirname, "../cpp/AccessTokenCache.cpp"),
+      path.join(__dirname, "../cpp/MemoryAccounting.cpp"),
+      path.join(__dirname, "../cpp/PendingOperationRegistry.cpp"),
+      path.join(__dirname, "../cpp/OidcMetadataCache.cpp"),
+      path.join(__dirname, "../cpp/OidcClient.cpp"),
+      path.join(__dirname, "../cpp/IdTokenVerifier.cpp"),
+      path.join(__dirname, "../cpp/JwsCrypto.cpp"),
+      path.join(__dirname, "../cpp/MicrosoftAuthority.cpp"),
+      path.join(__dirname, "../cpp/AuthClock.cpp"),
+      path.join(__dirname, "../cpp/ClockSkew.cpp"),
+      path.join(__dirname, "../cpp/RefreshBackoff.cpp"),
+      path.join(__dirname, "../cpp/RefreshTokenLedger.cpp"),
+      path.join(__dirname, "../cpp/SharedSessionSegment.cpp"),
+      path.join(__dirname, "../cpp/TimerService.cpp"),
+      path.join(__dirname, "../cpp/CancellationToken.cpp"),
+      path.join(__dirname, "../cpp/AuthResult.cpp"),
+      path.join(__dirname, "../cpp/AuthTrace.cpp"),
+      path.join(__dirname, "../cpp/__tests__/SessionInterleavingFuzzer.cpp"),
+    ],
+    output: path.join(__dirname, "../cpp/__tests__/session_interleaving_tests"),
     coverageSources: [path.join(__dirname, "../cpp/HybridAuth.cpp")],
   },
+  {
+    name: "access-token-cache",
+    flags: ["-fno-exceptions"],
+    sources: [
+      path.join(__dirname, "../cpp/AccessTokenCache.cpp"),
+      path.join(__dirname, "../cpp/MemoryAccounting.cpp"),
+      path.join(__dirname, "../cpp/__tests__/AccessTokenCacheTests.cpp"),
+    ],
+    output: path.join(__dirname, "../cpp/__tests__/access_token_cache_tests"),
+    coverageSources: [path.join(__dirname, "../cpp/AccessTokenCache.cpp")],
+  },
+  {
+    name: "auth-result",
+    sources: [
+      path.join(__dirname, "../cpp/AuthResult.cpp"),
+      path.join(__dirname, "../cpp/__tests__/AuthResultTests.cpp"),
+    ],
+    output: path.join(__dirname, "../cpp/__tests__/auth_result_tests"),
+    coverageSources: [path.join(__dirname, "../cpp/AuthResult.cpp")],
+  },
+  {
+    name: "auth-trace",
+    sources: [
+      path.join(__dirname, "../cpp/AuthTrace.cpp"),
+      path.join(__dirname, "../cpp/__tests__/AuthTraceTests.cpp"),
+    ],
+    output: path.join(__dirname, "../cpp/__tests__/auth_trace_tests"),
+    coverageSources: [path.join(__dirname, "../cpp/AuthTrace.cpp")],
+  },
+  {
+    name: "clock-skew",
+    flags: ["-fno-exceptions"],
+    sources: [
+      path.join(__dirname, "../cpp/ClockSkew.cpp"),
+      path.join(__dirname, "../cpp/AuthClock.cpp"),
+      path.join(__dirname, "../cpp/__tests__/ClockSkewTests.cpp"),
+    ],
+    output: path.join(__dirname, "../cpp/__tests__/clock_skew_tests"),
+    coverageSources: [path.join(__dirname, "../cpp/ClockSkew.cpp")],
+  },
+  {
+    name: "id-token-verifier",
+    sources: [
+      path.join(__dirname, "../cpp/IdTokenVerifier.cpp"),
+      path.join(__dirname, "../cpp/JwsCrypto.cpp"),
+      path.join(__dirname, "../cpp/__tests__/IdTokenVerifierTests.cpp"),
+    ],
+    output: path.join(__dirname, "../cpp/__tests__/id_token_verifier_tests"),
+    coverageSources: [
+      path.join(__dirname, "../cpp/IdTokenVerifier.cpp"),
+      path.join(__dirname, "../cpp/JwsCrypto.cpp"),
+    ],
+  },
+  {
+    name: "linux-platform",
+    flags: ["-I" + linuxDir],
+    sources: [
+      path.join(__dirname, "../cpp/HybridAuth.cpp"),
+      path.join(__dirname, "../cpp/AuthUserHostObject.cpp"),
+      path.join(__dirname, "../cpp/AccountRegistry.cpp"),
+      path.join(__dirname, "../cpp/PackedAuthUser.cpp"),
+      path.join(__dirname, "../cpp/AccessTokenCache.cpp"),
+      path.join(__dirname, "../cpp/MemoryAccounting.cpp"),
+      path.join(__dirname, "../cpp/PendingOperationRegistry.cpp"),
+      path.join(__dirname, "../cpp/OidcMetadataCache.cpp"),
+      path.join(__dirname, "../cpp/OidcClient.cpp"),
+      path.join(__dirname, "../cpp/IdTokenVerifier.cpp"),
+      path.join(__dirname, "../cpp/JwsCrypto.cpp"),
+      path.join(__dirname, "../cpp/MicrosoftAuthority.cpp"),
+      path.join(__dirname, "../cpp/AuthClock.cpp"),
+      path.join(__dirname, "../cpp/ClockSkew.cpp"),
+      path.join(__dirname, "../cpp/RefreshBackoff.cpp"),
+      path.join(__dirname, "../cpp/RefreshTokenLedger.cpp"),
+      path.join(__dirname, "../cpp/SharedSessionSegment.cpp"),
+      path.join(__dirname, "../cpp/TimerService.cpp"),
+      path.join(__dirname, "../cpp/CancellationToken.cpp"),
+      path.join(__dirname, "../cpp/AuthResult.cpp"),
+      path.join(__dirname, "../cpp/AuthTrace.cpp"),
+      path.join(__dirname, "../linux/LoopbackHttp.cpp"),
+      path.join(__dirname, "../linux/LoopbackOAuthServer.cpp"),
+      path.join(__dirname, "../linux/LoopbackSigner.cpp"),
+      path.join(__dirname, "../linux/PlatformAuth+Linux.cpp"),
+      path.join(__dirname, "../cpp/__tests__/LinuxPlatformTests.cpp"),
+    ],
+    output: path.join(__dirname, "../cpp/__tests__/linux_platform_tests"),
+    coverageSources: [path.join(__dirname, "../linux/PlatformAuth+Linux.cpp")],
+  },
+  {
+    name: "microsoft-authority",
+    flags: ["-fno-exceptions"],
+    sources: [
+      path.join(__dirname, "../cpp/MicrosoftAuthority.cpp"),
+      path.join(__dirname, "../cpp/__tests__/MicrosoftAuthorityTests.cpp"),
+    ],
+    output: path.join(__dirname, "../cpp/__tests__/microsoft_authority_tests"),
+    coverageSources: [path.join(__dirname, "../cpp/MicrosoftAuthority.cpp")],
+  },
+  {
+    name: "oidc-client",
+    sources: [
+      path.join(__dirname, "../cpp/OidcClient.cpp"),
+      path.join(__dirname, "../cpp/OidcMetadataCache.cpp"),
+      path.join(__dirname, "../cpp/IdTokenVerifier.cpp"),
+      path.join(__dirname, "../cpp/JwsCrypto.cpp"),
+      path.join(__dirname, "../cpp/AuthClock.cpp"),
+      path.join(__dirname, "../cpp/TimerService.cpp"),
+      path.join(__dirname, "../cpp/CancellationToken.cpp"),
+      path.join(__dirname, "../cpp/AuthResult.cpp"),
+      path.join(__dirname, "../cpp/__tests__/OidcClientTests.cpp"),
+    ],
+    output: path.join(__dirname, "../cpp/__tests__/oidc_client_tests"),
+    coverageSources: [path.join(__dirname, "../cpp/OidcClient.cpp")],
+  },
+  {
+    name: "oidc-metadata-cache",
+    sources: [
+      path.join(__dirname, "../cpp/OidcMetadataCache.cpp"),
+      path.join(__dirname, "../cpp/AuthClock.cpp"),
+      path.join(__dirname, "../cpp/TimerService.cpp"),
+      path.join(__dirname, "../cpp/AuthResult.cpp"),
+      path.join(__dirname, "../cpp/__tests__/OidcMetadataCacheTests.cpp"),
+    ],
+    output: path.join(__dirname, "../cpp/__tests__/oidc_metadata_cache_tests"),
+    coverageSources: [path.join(__dirname, "../cpp/OidcMetadataCache.cpp")],
+  },
+  {
+    name: "packed-auth-user",
+    sources: [
+      path.join(__dirname, "../cpp/PackedAuthUser.cpp"),
+      path.join(__dirname, "../cpp/MemoryAccounting.cpp"),
+      path.join(__dirname, "../cpp/__tests__/PackedAuthUserTests.cpp"),
+    ],
+    output: path.join(__dirname, "../cpp/__tests__/packed_auth_user_tests"),
+    coverageSources: [path.join(__dirname, "../cpp/PackedAuthUser.cpp")],
+  },
+  {
+    name: "auth-user-host-object",
+    sources: [
+      path.join(__dirname, "../cpp/PackedAuthUser.cpp"),
+      path.join(__dirname, "../cpp/MemoryAccounting.cpp"),
+      path.join(__dirname, "../cpp/AuthUserHostObject.cpp"),
+      path.join(__dirname, "../cpp/__tests__/AuthUserHostObjectTests.cpp"),
+    ],
+    output: path.join(__dirname, "../cpp/__tests__/auth_user_host_object_tests"),
+    coverageSources: [path.join(__dirname, "../cpp/AuthUserHostObject.cpp")],
+  },
+  {
+    name: "memory-accounting",
+    sources: [
+      path.join(__dirname, "../cpp/MemoryAccounting.cpp"),
+      path.join(__dirname, "../cpp/__tests__/MemoryAccountingTests.cpp"),
+    ],
+    output: path.join(__dirname, "../cpp/__tests__/memory_accounting_tests"),
+    coverageSources: [path.join(__dirname, "../cpp/MemoryAccounting.cpp")],
+  },
+  {
+    name: "pending-operation-registry",
+    sources: [
+      path.join(__dirname, "../cpp/PendingOperationRegistry.cpp"),
+      path.join(__dirname, "../cpp/MemoryAccounting.cpp"),
+      path.join(__dirname, "../cpp/__tests__/PendingOperationRegistryTests.cpp"),
+    ],
+    output: path.join(__dirname, "../cpp/__tests__/pending_operation_registry_tests"),
+    coverageSources: [path.join(__dirname, "../cpp/PendingOperationRegistry.cpp")],
+  },
+  {
+    name: "refresh-backoff",
+    flags: ["-fno-exceptions"],
+    sources: [
+      path.join(__dirname, "../cpp/RefreshBackoff.cpp"),
+      path.join(__dirname, "../cpp/__tests__/RefreshBackoffTests.cpp"),
+    ],
+    output: path.join(__dirname, "../cpp/__tests__/refresh_backoff_tests"),
+    coverageSources: [path.join(__dirname, "../cpp/RefreshBackoff.cpp")],
+  },
+  {
+    name: "refresh-token-ledger",
+    flags: ["-fno-exceptions"],
+    sources: [
+      path.join(__dirname, "../cpp/RefreshTokenLedger.cpp"),
+      path.join(__dirname, "../cpp/JwsCrypto.cpp"),
+      path.join(__dirname, "../cpp/__tests__/RefreshTokenLedgerTests.cpp"),
+    ],
+    output: path.join(__dirname, "../cpp/__tests__/refresh_token_ledger_tests"),
+    coverageSources: [path.join(__dirname, "../cpp/RefreshTokenLedger.cpp")],
+  },
+  {
+    name: "shared-session-segment",
+    sources: [
+      path.join(__dirname, "../cpp/SharedSessionSegment.cpp"),
+      path.join(__dirname, "../cpp/__tests__/SharedSessionSegmentTests.cpp"),
+    ],
+    output: path.join(__dirname, "../cpp/__tests__/shared_session_segment_tests"),
+    coverageSources: [path.join(__dirname, "../cpp/SharedSessionSegment.cpp")],
+  },
+  {
+    name: "timer-service",
+    sources: [
+      path.join(__dirname, "../cpp/TimerService.cpp"),
+      path.join(__dirname, "../cpp/CancellationToken.cpp"),
+      path.join(__dirname, "../cpp/__tests__/TimerServiceTests.cpp"),
+    ],
+    output: path.join(__dirname, "../cpp/__tests__/timer_service_tests"),
+    coverageSources: [
+      path.join(__dirname, "../cpp/TimerService.cpp"),
+      path.join(__dirname, "../cpp/CancellationToken.cpp"),
+    ],
+  },
 ];
 
 function resolveTool(name) {
@@ -111,58 +429,285 @@ if (!fs.existsSync(nitroModulesDir)) {
 const mocks = {
   "JSIConverter.hpp": `
     #pragma once
-    #include <string>
-    #include <vector>
-    #include <optional>
     #include <cstdint>
+    #include <memory>
+    #include <optional>
     #include <stdexcept>
-    
-    namespace facebook { 
-      namespace jsi { 
-        class Runtime {}; 
+    #include <string>
+    #include <utility>
+    #include <vector>
+
+    // A small in-memory stand-in for JSI: strings and objects live on the heap
+    // like JS values do, so converters and host objects can be tested and their
+    // relative costs benchmarked without a JS engine.
+    namespace facebook {
+      namespace jsi {
+        class Runtime {};
         class Value;
+        class HostObject;
+
+        class PropNameID {
+        public:
+          static PropNameID forAscii(Runtime&, const char* name) { return PropNameID(name); }
+          static PropNameID forUtf8(Runtime&, const std::string& name) { return PropNameID(name); }
+          std::string utf8(Runtime&) const { return _name; }
+          const std::string& name() const { return _name; }
+
+        private:
+          explicit PropNameID(std::string name) : _name(std::move(name)) {}
+          std::string _name;
+        };
+
+        class String {
+        public:
+          static String createFromUtf8(Runtime&, const std::string& value) {
+            return String(std::make_shared<const std::string>(value));
+          }
+          std::string utf8(Runtime&) const { return *_value; }
+
+        private:
+          friend class Value;
+          explicit String(std::shared_ptr<const std::string> value) : _value(std::move(value)) {}
+          std::shared_ptr<const std::string> _value;
+        };
+
+        struct ObjectData;
+
         class Object {
         public:
-          Object() {}
-          Object(Runtime&) {}
-          Value getProperty(Runtime&, const char*);
-          void setProperty(Runtime&, const char*, Value);
+          Object() : _data(std::make_shared<ObjectData>()) {}
+          Object(Runtime&) : Object() {}
+
+          static Object createFromHostObject(Runtime&, std::shared_ptr<HostObject> host);
+
+          Value getProperty(Runtime& runtime, const char* name) const;
+          Value getProperty(Runtime& runtime, const PropNameID& name) const;
+          void setProperty(Runtime& runtime, const char* name, Value value);
+          void setProperty(Runtime& runtime, const PropNameID& name, Value value);
+          std::vector<PropNameID> getPropertyNames(Runtime& runtime) const;
+
+          bool isHostObject(Runtime&) const;
+          template <typename T>
+          std::shared_ptr<T> getHostObject(Runtime&) const;
+
+        private:
+          friend class Value;
+          explicit Object(std::shared_ptr<ObjectData> data) : _data(std::move(data)) {}
+          std::shared_ptr<ObjectData> _data;
         };
+
         class Value {
         public:
-          Value() {}
-          Value(const Object&) {}
-          Value(const char*) {}
-          bool isString() const { return true; }
-          bool isObject() const { return true; }
-          Object asObject(Runtime&) const { return Object(); }
-          Object getObject(Runtime&) const { return Object(); }
+          Value() = default;
+          Value(bool value) : _kind(Kind::BOOL), _number(value ? 1 : 0) {}
+          Value(double value) : _kind(Kind::NUMBER), _number(value) {}
+          Value(int value) : _kind(Kind::NUMBER), _number(value) {}
+          Value(const Object& object) : _kind(Kind::OBJECT), _object(object._data) {}
+          Value(const String& string) : _kind(Kind::STRING), _string(string._value) {}
+          Value(const char* string) : Value(String(std::make_shared<const std::string>(string))) {}
+          Value(Runtime&, const Value& other) : Value(other) {}
+
+          static Value undefined() { return Value(); }
+          static Value null() {
+            Value value;
+            value._kind = Kind::NULL_VALUE;
+            return value;
+          }
+
+          bool isUndefined() const { return _kind == Kind::UNDEFINED; }
+          bool isNull() const { return _kind == Kind::NULL_VALUE; }
+          bool isBool() const { return _kind == Kind::BOOL; }
+          bool isNumber() const { return _kind == Kind::NUMBER; }
+          bool isString() const { return _kind == Kind::STRING; }
+          bool isObject() const { return _kind == Kind::OBJECT; }
+
+          bool getBool() const { return _number != 0; }
+          double getNumber() const { return _number; }
+          String getString(Runtime&) const { return String(_string); }
+          // Non-objects read as an empty object instead of throwing, so targets
+          // built without exceptions can include this.
+          Object asObject(Runtime&) const { return _object ? Object(_object) : Object(); }
+          Object getObject(Runtime& runtime) const { return asObject(runtime); }
+
+        private:
+          enum class Kind { UNDEFINED, NULL_VALUE, BOOL, NUMBER, STRING, OBJECT };
+          Kind _kind = Kind::UNDEFINED;
+          double _number = 0;
+          std::shared_ptr<const std::string> _string;
+          std::shared_ptr<ObjectData> _object;
+        };
+
+        class JSError : public std::runtime_error {
+        public:
+          JSError(Runtime&, std::string message) : std::runtime_error(message) {}
         };
-        inline Value Object::getProperty(Runtime&, const char*) { return Value(); }
-        inline void Object::setProperty(Runtime&, const char*, Value) {}
+
+        class HostObject {
+        public:
+          virtual ~HostObject() = default;
+          virtual Value get(Runtime&, const PropNameID&) { return Value(); }
+          // JSI throws a TypeError here; the mock ignores the write.
+          virtual void set(Runtime&, const PropNameID&, const Value&) {}
+          virtual std::vector<PropNameID> getPropertyNames(Runtime&) { return {}; }
+        };
+
+        struct ObjectData {
+          std::vector<std::pair<std::string, Value>> properties;
+          std::shared_ptr<HostObject> host;
+        };
+
+        inline Object Object::createFromHostObject(Runtime&, std::shared_ptr<HostObject> host) {
+          auto data = std::make_shared<ObjectData>();
+          data->host = std::move(host);
+          return Object(std::move(data));
+        }
+
+        inline Value Object::getProperty(Runtime& runtime, const PropNameID& name) const {
+          if (_data->host) return _data->host->get(runtime, name);
+          for (const auto& [key, value] : _data->properties) {
+            if (key == name.name()) return value;
+          }
+          return Value();
+        }
+
+        inline Value Object::getProperty(Runtime& runtime, const char* name) const {
+          return getProperty(runtime, PropNameID::forAscii(runtime, name));
+        }
+
+        inline void Object::setProperty(Runtime& runtime, const PropNameID& name, Value value) {
+          if (_data->host) {
+            _data->host->set(runtime, name, value);
+            return;
+          }
+          for (auto& [key, existing] : _data->properties) {
+            if (key == name.name()) {
+              existing = std::move(value);
+              return;
+            }
+          }
+          _data->properties.emplace_back(name.name(), std::move(value));
+        }
+
+        inline void Object::setProperty(Runtime& runtime, const char* name, Value value) {
+          setProperty(runtime, PropNameID::forAscii(runtime, name), std::move(value));
+        }
+
+        inline std::vector<PropNameID> Object::getPropertyNames(Runtime& runtime) const {
+          if (_data->host) return _data->host->getPropertyNames(runtime);
+          std::vector<PropNameID> names;
+          for (const auto& [key, value] : _data->properties) names.push_back(PropNameID::forUtf8(runtime, key));
+          return names;
+        }
+
+        inline bool Object::isHostObject(Runtime&) const { return _data->host != nullptr; }
+
+        template <typename T>
+        std::shared_ptr<T> Object::getHostObject(Runtime&) const {
+          return std::dynamic_pointer_cast<T>(_data->host);
+        }
       }
     }
 
-    namespace margelo { 
-      namespace nitro { 
+    namespace margelo {
+      namespace nitro {
         namespace jsi = facebook::jsi;
 
-        template<typename T> struct JSIConverter {
+        template <typename T, typename Enable = void>
+        struct JSIConverter {
           static T fromJSI(jsi::Runtime&, const jsi::Value&) { return T(); }
           static jsi::Value toJSI(jsi::Runtime&, const T&) { return jsi::Value(); }
           static bool canConvert(jsi::Runtime&, const jsi::Value&) { return true; }
         };
-        
-        inline bool isPlainObject(jsi::Runtime&, const jsi::Object&) { return true; }
+
+        template <>
+        struct JSIConverter<std::string> {
+          static std::string fromJSI(jsi::Runtime& runtime, const jsi::Value& value) {
+            return value.isString() ? value.getString(runtime).utf8(runtime) : std::string();
+          }
+          static jsi::Value toJSI(jsi::Runtime& runtime, const std::string& value) {
+            return jsi::String::createFromUtf8(runtime, value);
+          }
+          static bool canConvert(jsi::Runtime&, const jsi::Value& value) { return value.isString(); }
+        };
+
+        template <>
+        struct JSIConverter<double> {
+          static double fromJSI(jsi::Runtime&, const jsi::Value& value) { return value.getNumber(); }
+          static jsi::Value toJSI(jsi::Runtime&, double value) { return jsi::Value(value); }
+          static bool canConvert(jsi::Runtime&, const jsi::Value& value) { return value.isNumber(); }
+        };
+
+        template <>
+        struct JSIConverter<bool> {
+          static bool fromJSI(jsi::Runtime&, const jsi::Value& value) { return value.getBool(); }
+          static jsi::Value toJSI(jsi::Runtime&, bool value) { return jsi::Value(value); }
+          static bool canConvert(jsi::Runtime&, const jsi::Value& value) { return value.isBool(); }
+        };
+
+        template <typename T>
+        struct JSIConverter<std::optional<T>> {
+          static std::optional<T> fromJSI(jsi::Runtime& runtime, const jsi::Value& value) {
+            if (value.isUndefined() || value.isNull()) return std::nullopt;
+            return JSIConverter<T>::fromJSI(runtime, value);
+          }
+          static jsi::Value toJSI(jsi::Runtime& runtime, const std::optional<T>& value) {
+            return value ? JSIConverter<T>::toJSI(runtime, *value) : jsi::Value::undefined();
+          }
+          static bool canConvert(jsi::Runtime& runtime, const jsi::Value& value) {
+            return value.isUndefined() || value.isNull() || JSIConverter<T>::canConvert(runtime, value);
+          }
+        };
+
+        // Arrays are plain objects with index keys and a length.
+        template <typename T>
+        struct JSIConverter<std::vector<T>> {
+          static std::vector<T> fromJSI(jsi::Runtime& runtime, const jsi::Value& value) {
+            auto object = value.asObject(runtime);
+            const auto length = static_cast<size_t>(object.getProperty(runtime, "length").getNumber());
+            std::vector<T> items;
+            items.reserve(length);
+            for (size_t i = 0; i < length; i++) {
+              items.push_back(JSIConverter<T>::fromJSI(runtime, object.getProperty(runtime, std::to_string(i).c_str())));
+            }
+            return items;
+          }
+          static jsi::Value toJSI(jsi::Runtime& runtime, const std::vector<T>& items) {
+            jsi::Object array(runtime);
+            for (size_t i = 0; i < items.size(); i++) {
+              array.setProperty(runtime, std::to_string(i).c_str(), JSIConverter<T>::toJSI(runtime, items[i]));
+            }
+            array.setProperty(runtime, "length", jsi::Value(static_cast<double>(items.size())));
+            return array;
+          }
+          static bool canConvert(jsi::Runtime&, const jsi::Value& value) { return value.isObject(); }
+        };
+
+        inline bool isPlainObject(jsi::Runtime& runtime, const jsi::Object& object) {
+          return !object.isHostObject(runtime);
+        }
       }
     }
   `,
   "HybridObject.hpp": `
     #pragma once
+    #include <cstddef>
     #include <memory>
     #include <string>
+    #include <vector>
+    #include "JSIConverter.hpp"
 
     namespace margelo { namespace nitro {
+      // Records registrations only; tests call the methods directly.
+      class Prototype {
+      public:
+        template <typename Derived>
+        void registerRawHybridMethod(std::string name, size_t,
+                                     jsi::Value (Derived::*)(jsi::Runtime&, const jsi::Value&, const jsi::Value*, size_t)) {
+          rawMethods.push_back(std::move(name));
+        }
+        std::vector<std::string> rawMethods;
+      };
+
       class HybridObject : public std::enable_shared_from_this<HybridObject> {
       public:
         explicit HybridObject(const char* name) : _name(name) {}
@@ -170,11 +715,28 @@ const mocks = {
         HybridObject(const HybridObject&) = delete;
         HybridObject& operator=(const HybridObject&) = delete;
 
+        const Prototype& prototype() const { return _prototype; }
+        // Nitro loads the prototype the first time the object reaches JS.
+        jsi::Value toObject(jsi::Runtime& runtime) {
+          if (!_loaded) {
+            _loaded = true;
+            loadHybridMethods();
+          }
+          return jsi::Object(runtime);
+        }
+
       protected:
         virtual void loadHybridMethods() {}
 
+        template <typename Derived>
+        void registerHybrids(Derived*, void (*registerFunc)(Prototype&)) {
+          registerFunc(_prototype);
+        }
+
       private:
         const char* _name;
+        Prototype _prototype;
+        bool _loaded = false;
       };
     }}
   `,
@@ -212,10 +774,18 @@ const mocks = {
   `,
   "PropNameIDCache.hpp": `
     #pragma once
-    namespace facebook { namespace jsi { class Runtime; } }
+    #include <unordered_map>
+    #include "JSIConverter.hpp"
+
     namespace margelo { namespace nitro {
+      // Like Nitro's: one PropNameID per name, created on first use.
       struct PropNameIDCache {
-        static inline const char* get(facebook::jsi::Runtime&, const char* name) { return name; }
+        static inline const jsi::PropNameID& get(jsi::Runtime& runtime, const char* name) {
+          static std::unordered_map<const char*, jsi::PropNameID> cache;
+          auto it = cache.find(name);
+          if (it == cache.end()) it = cache.emplace(name, jsi::PropNameID::forAscii(runtime, name)).first;
+          return it->second;
+        }
       };
     }}
   `,
@@ -336,6 +906,55 @@ for (const [file, content] of Object.entries(mocks)) {
   fs.writeFileSync(path.join(nitroModulesDir, file), content.trim());
 }
 
+// libFuzzer builds of the targets marked `fuzz`; needs clang with -fsanitize=fuzzer.
+function runFuzzers() {
+  for (const target of tests.filter((test) => test.fuzz)) {
+    const output = path.join(os.tmpdir(), `nitro-auth-${target.name}`);
+    const corpusDir = path.join(os.tmpdir(), `nitro-auth-${target.name}-corpus`);
+    fs.mkdirSync(corpusDir, { recursive: true });
+
+    console.log(`Compiling ${target.name} fuzzer...`);
+    const compile = spawnSync(
+      "clang++",
+      [
+        "-std=c++20",
+        "-g",
+        "-O1",
+        "-fsanitize=fuzzer,address,undefined",
+        "-DNITRO_AUTH_LIBFUZZER",
+        ...(target.flags ?? []),
+        "-I" + includeDir,
+        "-I" + nitrogenDir,
+        "-I" + mockIncludeDir,
+        ...target.sources,
+        "-o",
+        output,
+      ],
+      { stdio: "inherit" },
+    );
+    if (compile.status !== 0) {
+      console.error(`${target.name} fuzzer compilation failed`);
+      process.exit(1);
+    }
+
+    console.log(`Fuzzing ${target.name} for ${fuzzSeconds}s...`);
+    const run = spawnSync(
+      output,
+      [`-max_total_time=${fuzzSeconds}`, "-max_len=4096", corpusDir],
+      { stdio: "inherit" },
+    );
+    if (run.status !== 0) {
+      console.error(`${target.name} fuzzer found a failure`);
+      process.exit(1);
+    }
+  }
+  process.exit(0);
+}
+
+if (fuzzEnabled) {
+  runFuzzers();
+}
+
 if (coverageEnabled) {
   cleanupCoverageDir();
 }
@@ -354,6 +973,7 @@ for (const test of tests) {
     [
       "-std=c++20",
       ...coverageFlags,
+      ...(test.flags ?? []),
       "-I" + includeDir,
       "-I" + nitrogenDir,
       "-I" + mockIncludeDir,
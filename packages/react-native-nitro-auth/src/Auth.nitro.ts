@@ -1,6 +1,6 @@
 import type { HybridObject } from "react-native-nitro-modules";
 
-export type AuthProvider = "google" | "apple" | "microsoft";
+export type AuthProvider = "google" | "apple" | "microsoft" | "oidc";
 
 export type AuthErrorCode =
   | "cancelled"
@@ -41,6 +41,8 @@ export interface LoginOptions {
   tenant?: string;
   /** (Microsoft only) Prompt behavior for login */
   prompt?: MicrosoftPrompt;
+  /** (OIDC only) Sign in with the device authorization grant; the code arrives through `onDeviceCode`. */
+  useDeviceCode?: boolean;
 }
 
 export interface AuthTokens {
@@ -69,17 +71,151 @@ export interface AuthUser {
   underlyingError?: string;
 }
 
+export interface AuthAccount {
+  /** Stable id, `"<provider>:<userId or email>"` */
+  id: string;
+  provider: AuthProvider;
+  email?: string;
+  name?: string;
+  isActive: boolean;
+}
+
+/**
+ * Selects a per-resource access token. Scopes are qualified with `resource`
+ * unless already absolute; a bare `resource` requests `<resource>/.default`.
+ */
+export interface AccessTokenRequest {
+  resource?: string;
+  scopes?: string[];
+}
+
+/** Expected claims for `verifyIdToken`. */
+export interface IdTokenVerificationOptions {
+  /** The OAuth client ID the token must be issued to (`aud`). */
+  audience: string;
+  /** Checked against the `nonce` claim when set. */
+  nonce?: string;
+}
+
+export interface IdTokenClaims {
+  issuer: string;
+  subject: string;
+  audience: string[];
+  /** Milliseconds since the epoch. */
+  expiresAt: number;
+  issuedAt?: number;
+  nonce?: string;
+  email?: string;
+}
+
+/** Any OpenID provider, signed in with authorization code + PKCE. */
+export interface OidcProviderConfig {
+  /** Issuer URL; endpoints come from its discovery document. */
+  issuer: string;
+  clientId: string;
+  /** Custom-scheme redirect registered with the provider. */
+  redirectUri: string;
+  /** Defaults to `openid profile email offline_access`. */
+  scopes?: string[];
+}
+
+/** What to show the user during a device-code sign-in. */
+export interface DeviceAuthorization {
+  userCode: string;
+  verificationUri: string;
+  /** `verificationUri` with the code filled in, suitable for a QR code. */
+  verificationUriComplete?: string;
+  /** Milliseconds since the epoch. */
+  expiresAt: number;
+  /** Seconds between polls. */
+  interval: number;
+}
+
+/** The session as of one instant, read in a single native call. */
+export interface SessionSnapshot {
+  user?: AuthUser;
+  scopes: string[];
+  /** An access token is present and has not reached its expiry. */
+  hasValidAccessToken: boolean;
+  /** Milliseconds until the access token expires, 0 once it has; absent without an expiry. */
+  accessTokenExpiresIn?: number;
+  /** Changes whenever `user` or `scopes` change; equal versions mean equal sessions. */
+  version: number;
+}
+
+/** Returned by `getCurrentUserIfChanged` when the session moved past a version. */
+export interface UserChange {
+  /** Absent when signed out. */
+  user?: AuthUser;
+  version: number;
+}
+
+/** Native memory held by one part of the module. */
+export interface MemoryUsage {
+  bytes: number;
+  allocations: number;
+  /** High-water mark of `bytes` since the app started. */
+  peakBytes: number;
+}
+
+/** Returned by `getMemoryStats`; counters are shared by every Auth instance. */
+export interface MemoryStats {
+  /** Accounts and their users, tokens included. */
+  sessions: MemoryUsage;
+  /** Auth state, token and device-code listeners. */
+  listeners: MemoryUsage;
+  /** Session promises and refreshes waiting on the platform. */
+  pendingOperations: MemoryUsage;
+  /** Platform calls in flight. */
+  platformOperations: MemoryUsage;
+  accessTokenCache: MemoryUsage;
+  totalBytes: number;
+  peakBytes: number;
+}
+
 export interface Auth extends HybridObject<{ ios: "c++"; android: "c++" }> {
   readonly currentUser: AuthUser | undefined;
   readonly grantedScopes: string[];
   readonly hasPlayServices: boolean;
+  /** Signed-in accounts in sign-in order; `currentUser` is the active one. */
+  readonly accounts: AuthAccount[];
+  /**
+   * Increases whenever `currentUser` or `grantedScopes` change, including
+   * token refreshes, scope changes and account switches.
+   */
+  readonly sessionVersion: number;
+
+  /** `currentUser`, `grantedScopes` and token state under one lock. */
+  getSessionSnapshot(): SessionSnapshot;
+  /**
+   * `undefined` while `sessionVersion` still equals `sinceVersion`, so pollers
+   * pay for a user conversion only after a change.
+   */
+  getCurrentUserIfChanged(sinceVersion: number): UserChange | undefined;
+  /** Native heap held by the module; web reports counts with zero bytes. */
+  getMemoryStats(): MemoryStats;
 
   login(provider: AuthProvider, options?: LoginOptions): Promise<void>;
   requestScopes(scopes: string[]): Promise<void>;
   revokeScopes(scopes: string[]): Promise<void>;
   revokeAccess(): Promise<void>;
-  getAccessToken(): Promise<string | undefined>;
+  /** Without a request, the session access token of the active account. */
+  getAccessToken(request?: AccessTokenRequest): Promise<string | undefined>;
   refreshToken(): Promise<AuthTokens>;
+  switchAccount(accountId: string): void;
+  getAccessTokenForAccount(
+    accountId: string,
+    request?: AccessTokenRequest,
+  ): Promise<string | undefined>;
+  /**
+   * Verifies the active account's `idToken` on device: the signature against
+   * the provider's published keys, plus `iss`, `aud`, `exp` and `nonce`.
+   * Rejects with `token_error`, `invalid_nonce`, `no_id_token` or
+   * `not_signed_in`.
+   */
+  verifyIdToken(options: IdTokenVerificationOptions): Promise<IdTokenClaims>;
+  /** Enables `login("oidc")`; the token exchange and refresh run natively. */
+  configureOidc(config: OidcProviderConfig): void;
 
   logout(): void;
   silentRestore(): Promise<void>;
@@ -88,5 +224,8 @@ export interface Auth extends HybridObject<{ ios: "c++"; android: "c++" }> {
     callback: (user: AuthUser | undefined) => void,
   ): () => void;
   onTokensRefreshed(callback: (tokens: AuthTokens) => void): () => void;
+  onDeviceCode(
+    callback: (authorization: DeviceAuthorization) => void,
+  ): () => void;
   setLoggingEnabled(enabled: boolean): void;
 }
@@ -1,10 +1,19 @@
 import type {
+  AccessTokenRequest,
   Auth,
+  AuthAccount,
   AuthUser,
   AuthProvider,
   LoginOptions,
   AuthTokens,
   AuthErrorCode,
+  IdTokenClaims,
+  IdTokenVerificationOptions,
+  OidcProviderConfig,
+  MemoryStats,
+  MemoryUsage,
+  SessionSnapshot,
+  UserChange,
 } from "./Auth.nitro";
 import type { JSStorageAdapter } from "./js-storage-adapter";
 import { logger } from "./utils/logger";
@@ -14,6 +23,9 @@ const SCOPES_KEY = "nitro_auth_scopes";
 const MS_REFRESH_TOKEN_KEY = "nitro_auth_microsoft_refresh_token";
 const DEFAULT_SCOPES = ["openid", "email", "profile"];
 const MS_DEFAULT_SCOPES = ["openid", "email", "profile", "User.Read"];
+const MAX_RESOURCE_TOKENS = 32;
+const MAX_VERIFIED_ID_TOKENS = 8;
+const ID_TOKEN_CLOCK_SKEW_MS = 5 * 60 * 1000;
 const STORAGE_MODE_SESSION = "session";
 const STORAGE_MODE_LOCAL = "local";
 const STORAGE_MODE_MEMORY = "memory";
@@ -124,6 +136,11 @@ const getOptionalNumber = (
     : undefined;
 };
 
+// The JS heap cannot be measured per object, so web reports counts only.
+function countOnly(allocations: number): MemoryUsage {
+  return { bytes: 0, allocations, peakBytes: 0 };
+}
+
 function setIfDefined<T extends object, K extends keyof T>(
   target: T,
   key: K,
@@ -283,6 +300,70 @@ const getConfig = (): AuthWebExtraConfig => {
   }
 };
 
+type ResourceToken = { accessToken: string; expirationTime?: number };
+
+// Mirrors the native cache key: qualified, sorted and deduplicated scopes.
+const resourceScopesFor = (request: AccessTokenRequest): string[] => {
+  const resource = (request.resource ?? "").replace(/\/+$/, "");
+  const scopes = (request.scopes ?? [])
+    .filter((scope) => scope.length > 0)
+    .map((scope) =>
+      !resource ||
+      ["openid", "profile", "email", "offline_access"].includes(scope) ||
+      scope.includes("://")
+        ? scope
+        : `${resource}/${scope}`,
+    );
+  if (resource && scopes.length === 0) {
+    scopes.push(`${resource}/.default`);
+  }
+  return [...new Set(scopes)].sort();
+};
+
+type VerifiedIdToken = {
+  payload: JsonObject;
+  issuers: string[];
+};
+
+type OidcKeys = { issuer: string; keys: JsonObject[] };
+
+// The authority publishing the keys for `provider`'s id_tokens; Microsoft's is
+// per tenant, so it comes from the (not yet verified) `iss` claim.
+const idTokenAuthorityFor = (
+  provider: AuthProvider,
+  issuer: string | undefined,
+): string | undefined => {
+  switch (provider) {
+    case "google":
+      return "https://accounts.google.com";
+    case "apple":
+      return "https://appleid.apple.com";
+    case "microsoft":
+      return issuer?.startsWith("https://login.microsoftonline.com/") &&
+        issuer.endsWith("/v2.0")
+        ? issuer
+        : undefined;
+    case "oidc":
+      return undefined;
+  }
+};
+
+const base64UrlToBytes = (value: string) => {
+  if (value.length % 4 === 1 || !JWT_BASE64_URL_RE.test(value)) {
+    throw new AuthWebError("token_error", "malformed");
+  }
+  const normalized = value.replace(/-/g, "+").replace(/_/g, "/");
+  const padding = "=".repeat((4 - (normalized.length % 4)) % 4);
+  return Uint8Array.from(atob(`${normalized}${padding}`), (char) =>
+    char.charCodeAt(0),
+  );
+};
+
+const webAccountId = (user: AuthUser): string => {
+  const subject = user.userId || user.email;
+  return subject ? `${user.provider}:${subject}` : user.provider;
+};
+
 class AuthWeb implements Auth {
   private readonly _config: AuthWebExtraConfig;
   private _currentUser: AuthUser | undefined;
@@ -293,9 +374,17 @@ class AuthWeb implements Auth {
   private _browserStorageResolved = false;
   private _browserStorageCache: Storage | undefined;
   private _refreshPromise: Promise<AuthTokens> | undefined;
+  // Least recently used first.
+  private _resourceTokens = new Map<string, ResourceToken>();
+  private _resourceRefreshes = new Map<string, Promise<ResourceToken>>();
+  // Least recently used first.
+  private _verifiedIdTokens = new Map<string, VerifiedIdToken>();
+  private _oidcKeys = new Map<string, Promise<OidcKeys>>();
   private _pendingGoogleNonce: string | undefined;
   private _loginInFlight: boolean = false;
   private _sessionGeneration = 0;
+  // Every visible change goes through notify(), which advances this.
+  private _sessionVersion = 0;
   private _disposed = false;
 
   constructor() {
@@ -540,6 +629,337 @@ class AuthWeb implements Auth {
     return true;
   }
 
+  get sessionVersion(): number {
+    return this._sessionVersion;
+  }
+
+  getCurrentUserIfChanged(sinceVersion: number): UserChange | undefined {
+    if (sinceVersion === this._sessionVersion) return undefined;
+    const change: UserChange = { version: this._sessionVersion };
+    setIfDefined(change, "user", this._currentUser);
+    return change;
+  }
+
+  getMemoryStats(): MemoryStats {
+    return {
+      sessions: countOnly(this._currentUser ? 1 : 0),
+      listeners: countOnly(
+        this._listeners.length + this._tokenListeners.length,
+      ),
+      pendingOperations: countOnly(
+        this._resourceRefreshes.size + (this._refreshPromise ? 1 : 0),
+      ),
+      platformOperations: countOnly(this._loginInFlight ? 1 : 0),
+      accessTokenCache: countOnly(this._resourceTokens.size),
+      totalBytes: 0,
+      peakBytes: 0,
+    };
+  }
+
+  getSessionSnapshot(): SessionSnapshot {
+    const user = this._currentUser;
+    const snapshot: SessionSnapshot = {
+      scopes: this._grantedScopes,
+      hasValidAccessToken: false,
+      version: this._sessionVersion,
+    };
+    setIfDefined(snapshot, "user", user);
+    if (user?.accessToken !== undefined) {
+      if (user.expirationTime === undefined) {
+        snapshot.hasValidAccessToken = true;
+      } else {
+        const remaining = user.expirationTime - Date.now();
+        snapshot.hasValidAccessToken = remaining > 0;
+        snapshot.accessTokenExpiresIn = Math.max(remaining, 0);
+      }
+    }
+    return snapshot;
+  }
+
+  // The web session holds a single account; it is always the active one.
+  get accounts(): AuthAccount[] {
+    const user = this._currentUser;
+    if (!user) return [];
+    return [
+      {
+        id: webAccountId(user),
+        provider: user.provider,
+        email: user.email,
+        name: user.name,
+        isActive: true,
+      },
+    ];
+  }
+
+  switchAccount(accountId: string): void {
+    if (!this._currentUser || webAccountId(this._currentUser) !== accountId) {
+      throw new AuthWebError("not_signed_in");
+    }
+  }
+
+  async getAccessTokenForAccount(
+    accountId: string,
+    request?: AccessTokenRequest,
+  ): Promise<string | undefined> {
+    this.switchAccount(accountId);
+    return this.getAccessToken(request);
+  }
+
+  // The generic OIDC flow runs in the native core; on web `login("oidc")`
+  // rejects with `unsupported_provider`.
+  configureOidc(config: OidcProviderConfig): void {
+    logger.warn("OIDC provider is not supported on web", {
+      issuer: config.issuer,
+    });
+  }
+
+  async verifyIdToken(
+    options: IdTokenVerificationOptions,
+  ): Promise<IdTokenClaims> {
+    const user = this._currentUser;
+    if (!user) {
+      throw new AuthWebError("not_signed_in");
+    }
+    const token = user.idToken;
+    if (!token) {
+      throw new AuthWebError("no_id_token");
+    }
+
+    let verified = this._verifiedIdTokens.get(token);
+    if (verified) {
+      this._verifiedIdTokens.delete(token);
+    } else {
+      verified = await this.checkIdTokenSignature(user.provider, token);
+    }
+    this._verifiedIdTokens.set(token, verified);
+    while (this._verifiedIdTokens.size > MAX_VERIFIED_ID_TOKENS) {
+      const oldest = this._verifiedIdTokens.keys().next().value;
+      if (oldest === undefined) break;
+      this._verifiedIdTokens.delete(oldest);
+    }
+    return this.checkIdTokenClaims(verified, options);
+  }
+
+  private async checkIdTokenSignature(
+    provider: AuthProvider,
+    token: string,
+  ): Promise<VerifiedIdToken> {
+    const [encodedHeader, encodedPayload, encodedSignature, ...rest] =
+      token.split(".");
+    if (!encodedHeader || !encodedPayload || !encodedSignature || rest.length) {
+      throw new AuthWebError("token_error", "malformed");
+    }
+    let header: JsonObject;
+    let payload: JsonObject;
+    try {
+      header = this.parseJwtSegment(encodedHeader);
+      payload = this.parseJwtSegment(encodedPayload);
+    } catch {
+      throw new AuthWebError("token_error", "malformed");
+    }
+
+    const alg = getOptionalString(header, "alg");
+    const kid = getOptionalString(header, "kid");
+    if ((alg !== "RS256" && alg !== "ES256") || header["crit"] !== undefined) {
+      throw new AuthWebError("token_error", "unsupported_algorithm");
+    }
+    const authority = idTokenAuthorityFor(
+      provider,
+      getOptionalString(payload, "iss"),
+    );
+    if (!authority) {
+      throw new AuthWebError("token_error", "issuer_mismatch");
+    }
+
+    const kty = alg === "RS256" ? "RSA" : "EC";
+    const findKey = (keys: OidcKeys) => {
+      const candidates = keys.keys.filter(
+        (key) =>
+          key["kty"] === kty &&
+          (kty === "RSA" || key["crv"] === "P-256") &&
+          (key["alg"] === undefined || key["alg"] === alg) &&
+          (key["use"] === undefined || key["use"] === "sig") &&
+          (kid === undefined || key["kid"] === kid),
+      );
+      return kid === undefined && candidates.length > 1
+        ? undefined
+        : candidates[0];
+    };
+    let keys = await this.getOidcKeys(authority);
+    let jwk = findKey(keys);
+    if (!jwk && kid !== undefined) {
+      // The provider may have rotated its signing keys since the last fetch.
+      this._oidcKeys.delete(authority);
+      keys = await this.getOidcKeys(authority);
+      jwk = findKey(keys);
+    }
+    if (!jwk) {
+      throw new AuthWebError("token_error", "unknown_key");
+    }
+
+    let valid = false;
+    try {
+      const keyData: JsonWebKey =
+        kty === "RSA"
+          ? {
+              kty,
+              n: getOptionalString(jwk, "n"),
+              e: getOptionalString(jwk, "e"),
+            }
+          : {
+              kty,
+              crv: "P-256",
+              x: getOptionalString(jwk, "x"),
+              y: getOptionalString(jwk, "y"),
+            };
+      const key = await crypto.subtle.importKey(
+        "jwk",
+        keyData,
+        alg === "RS256"
+          ? { name: "RSASSA-PKCS1-v1_5", hash: "SHA-256" }
+          : { name: "ECDSA", namedCurve: "P-256" },
+        false,
+        ["verify"],
+      );
+      valid = await crypto.subtle.verify(
+        alg === "RS256"
+          ? { name: "RSASSA-PKCS1-v1_5" }
+          : { name: "ECDSA", hash: "SHA-256" },
+        key,
+        base64UrlToBytes(encodedSignature),
+        new TextEncoder().encode(`${encodedHeader}.${encodedPayload}`),
+      );
+    } catch (error) {
+      throw new AuthWebError("token_error", String(error));
+    }
+    if (!valid) {
+      throw new AuthWebError("token_error", "bad_signature");
+    }
+
+    const issuers = [keys.issuer];
+    const tenantId = getOptionalString(payload, "tid");
+    if (tenantId) {
+      issuers[0] = keys.issuer.replace("{tenantid}", tenantId);
+    }
+    if (provider === "google") {
+      issuers.push("accounts.google.com");
+    }
+    return { payload, issuers };
+  }
+
+  private checkIdTokenClaims(
+    { payload, issuers }: VerifiedIdToken,
+    options: IdTokenVerificationOptions,
+  ): IdTokenClaims {
+    const issuer = getOptionalString(payload, "iss");
+    const subject = getOptionalString(payload, "sub");
+    const expiresAt = getOptionalNumber(payload, "exp");
+    const issuedAt = getOptionalNumber(payload, "iat");
+    const notBefore = getOptionalNumber(payload, "nbf");
+    const rawAudience = payload["aud"];
+    const audience =
+      typeof rawAudience === "string"
+        ? [rawAudience]
+        : Array.isArray(rawAudience)
+          ? rawAudience.filter(
+              (value): value is string => typeof value === "string",
+            )
+          : [];
+    if (!issuer || !subject || expiresAt === undefined || !audience.length) {
+      throw new AuthWebError("token_error", "malformed_claims");
+    }
+    if (!issuers.includes(issuer)) {
+      throw new AuthWebError("token_error", "issuer_mismatch");
+    }
+    if (!options.audience || !audience.includes(options.audience)) {
+      throw new AuthWebError("token_error", "audience_mismatch");
+    }
+    if (
+      audience.length > 1 &&
+      getOptionalString(payload, "azp") !== options.audience
+    ) {
+      throw new AuthWebError("token_error", "authorized_party_mismatch");
+    }
+    const now = Date.now();
+    if (now > expiresAt * 1000 + ID_TOKEN_CLOCK_SKEW_MS) {
+      throw new AuthWebError("token_error", "expired");
+    }
+    if (
+      notBefore !== undefined &&
+      now + ID_TOKEN_CLOCK_SKEW_MS < notBefore * 1000
+    ) {
+      throw new AuthWebError("token_error", "not_yet_valid");
+    }
+    if (
+      issuedAt !== undefined &&
+      now + ID_TOKEN_CLOCK_SKEW_MS < issuedAt * 1000
+    ) {
+      throw new AuthWebError("token_error", "issued_in_future");
+    }
+    const nonce = getOptionalString(payload, "nonce");
+    if (options.nonce !== undefined && nonce !== options.nonce) {
+      throw new AuthWebError("invalid_nonce");
+    }
+
+    return {
+      issuer,
+      subject,
+      audience,
+      expiresAt: expiresAt * 1000,
+      issuedAt: issuedAt === undefined ? undefined : issuedAt * 1000,
+      nonce,
+      email: getOptionalString(payload, "email"),
+    };
+  }
+
+  private getOidcKeys(authority: string): Promise<OidcKeys> {
+    const cached = this._oidcKeys.get(authority);
+    if (cached) {
+      return cached;
+    }
+    const pending = (async () => {
+      const fetchJson = async (url: string): Promise<JsonObject> => {
+        let response: Response;
+        try {
+          response = await fetch(url);
+        } catch (error) {
+          throw new AuthWebError("network_error", String(error));
+        }
+        if (!response.ok) {
+          throw new AuthWebError(
+            response.status >= 500 ? "network_error" : "configuration_error",
+            `HTTP ${response.status} from ${url}`,
+          );
+        }
+        const json: unknown = await response.json();
+        if (!isJsonObject(json)) {
+          throw new AuthWebError("parse_error", url);
+        }
+        return json;
+      };
+      const discovery = await fetchJson(
+        `${authority}/.well-known/openid-configuration`,
+      );
+      const issuer = getOptionalString(discovery, "issuer");
+      const jwksUri = getOptionalString(discovery, "jwks_uri");
+      if (!issuer || !jwksUri?.startsWith("https://")) {
+        throw new AuthWebError("parse_error", "Invalid discovery document");
+      }
+      const jwks = await fetchJson(jwksUri);
+      const keys = Array.isArray(jwks["keys"])
+        ? jwks["keys"].filter(isJsonObject)
+        : [];
+      return { issuer, keys };
+    })();
+    this._oidcKeys.set(authority, pending);
+    pending.catch(() => {
+      if (this._oidcKeys.get(authority) === pending) {
+        this._oidcKeys.delete(authority);
+      }
+    });
+    return pending;
+  }
+
   onAuthStateChanged(
     callback: (user: AuthUser | undefined) => void,
   ): () => void {
@@ -557,7 +977,13 @@ class AuthWeb implements Auth {
     };
   }
 
+  // Device-code sign-in is OIDC only, which web does not support.
+  onDeviceCode(): () => void {
+    return () => {};
+  }
+
   private notify() {
+    this._sessionVersion += 1;
     for (const listener of [...this._listeners]) {
       listener(this._currentUser);
     }
@@ -689,7 +1115,13 @@ class AuthWeb implements Auth {
     this.logout();
   }
 
-  async getAccessToken(): Promise<string | undefined> {
+  async getAccessToken(
+    request?: AccessTokenRequest,
+  ): Promise<string | undefined> {
+    const scopes = request ? resourceScopesFor(request) : [];
+    if (scopes.length > 0) {
+      return this.getResourceAccessToken(scopes);
+    }
     if (this._currentUser?.expirationTime) {
       const now = Date.now();
       if (now + 300000 > this._currentUser.expirationTime) {
@@ -700,6 +1132,104 @@ class AuthWeb implements Auth {
     return this._currentUser?.accessToken;
   }
 
+  private async getResourceAccessToken(scopes: string[]): Promise<string> {
+    const user = this._currentUser;
+    if (!user) {
+      throw new AuthWebError("not_signed_in");
+    }
+    if (user.provider !== "microsoft") {
+      throw new AuthWebError("unsupported_provider");
+    }
+    const key = `${webAccountId(user)}\n${scopes.join(" ")}`;
+    const cached = this._resourceTokens.get(key);
+    if (
+      cached &&
+      (cached.expirationTime === undefined ||
+        Date.now() + 300000 <= cached.expirationTime)
+    ) {
+      this._resourceTokens.delete(key);
+      this._resourceTokens.set(key, cached);
+      return cached.accessToken;
+    }
+
+    let pending = this._resourceRefreshes.get(key);
+    if (!pending) {
+      pending = this.fetchResourceToken(scopes, this._sessionGeneration);
+      this._resourceRefreshes.set(key, pending);
+    }
+    try {
+      const token = await pending;
+      this._resourceTokens.delete(key);
+      this._resourceTokens.set(key, token);
+      while (this._resourceTokens.size > MAX_RESOURCE_TOKENS) {
+        const oldest = this._resourceTokens.keys().next().value;
+        if (oldest === undefined) break;
+        this._resourceTokens.delete(oldest);
+      }
+      return token.accessToken;
+    } finally {
+      if (this._resourceRefreshes.get(key) === pending) {
+        this._resourceRefreshes.delete(key);
+      }
+    }
+  }
+
+  // Redeems the refresh token for a token scoped to another resource; the
+  // session tokens and the signed-in user are left untouched.
+  private async fetchResourceToken(
+    scopes: string[],
+    generation: number,
+  ): Promise<ResourceToken> {
+    const refreshToken = this.loadRefreshToken();
+    if (!refreshToken) {
+      throw new AuthWebError("refresh_failed", "No refresh token available");
+    }
+    const clientId = this._config.microsoftClientId;
+    if (!clientId) {
+      throw new AuthWebError("configuration_error");
+    }
+    const authBaseUrl = this.getMicrosoftAuthBaseUrl(
+      this._config.microsoftTenant ?? "common",
+      this._config.microsoftB2cDomain,
+    );
+    const body = new URLSearchParams({
+      client_id: clientId,
+      grant_type: "refresh_token",
+      refresh_token: refreshToken,
+      scope: [...scopes, "offline_access"].join(" "),
+    });
+    const response = await fetch(`${authBaseUrl}oauth2/v2.0/token`, {
+      method: "POST",
+      headers: {
+        "Content-Type": "application/x-www-form-urlencoded",
+      },
+      body: body.toString(),
+    });
+
+    const json = await this.parseResponseObject(response);
+    this.assertActiveGeneration(generation);
+    const accessToken = getOptionalString(json, "access_token");
+    if (!response.ok || !accessToken) {
+      throw new AuthWebError(
+        "refresh_failed",
+        getOptionalString(json, "error_description") ??
+          getOptionalString(json, "error") ??
+          "Token refresh failed",
+      );
+    }
+    const newRefreshToken = getOptionalString(json, "refresh_token");
+    if (newRefreshToken) {
+      this.saveRefreshToken(newRefreshToken);
+    }
+    const token: ResourceToken = { accessToken };
+    setIfDefined(
+      token,
+      "expirationTime",
+      this.getExpirationTime(json["expires_in"]),
+    );
+    return token;
+  }
+
   async refreshToken(): Promise<AuthTokens> {
     if (this._refreshPromise) {
       return this._refreshPromise;
@@ -905,9 +1435,14 @@ class AuthWeb implements Auth {
 
   private parseJwtPayload(token: string): JsonObject {
     const parts = token.split(".");
-    const payload = parts[1];
+    if (parts.length < 2) {
+      throw new AuthWebError("parse_error", "Invalid JWT payload");
+    }
+    return this.parseJwtSegment(parts[1]);
+  }
+
+  private parseJwtSegment(payload: string | undefined): JsonObject {
     if (
-      parts.length < 2 ||
       !payload ||
       payload.length % 4 === 1 ||
       !JWT_BASE64_URL_RE.test(payload)
@@ -1621,6 +2156,9 @@ class AuthWeb implements Auth {
     this._currentUser = undefined;
     this._grantedScopes = [];
     this._refreshPromise = undefined;
+    this._resourceTokens.clear();
+    this._resourceRefreshes.clear();
+    this._verifiedIdTokens.clear();
     this._pendingGoogleNonce = undefined;
     this._loginInFlight = false;
     this.removeFromCache(CACHE_KEY);
@@ -14,9 +14,35 @@ type TestAuthUser = {
   expirationTime?: number;
 };
 
+type TestMemoryUsage = {
+  bytes: number;
+  allocations: number;
+  peakBytes: number;
+};
+
 type TestAuthModule = {
   currentUser: TestAuthUser | undefined;
   grantedScopes: string[];
+  getSessionSnapshot: () => {
+    user?: TestAuthUser;
+    scopes: string[];
+    hasValidAccessToken: boolean;
+    accessTokenExpiresIn?: number;
+    version: number;
+  };
+  sessionVersion: number;
+  getCurrentUserIfChanged: (
+    sinceVersion: number,
+  ) => { user?: TestAuthUser; version: number } | undefined;
+  getMemoryStats: () => {
+    sessions: TestMemoryUsage;
+    listeners: TestMemoryUsage;
+    pendingOperations: TestMemoryUsage;
+    platformOperations: TestMemoryUsage;
+    accessTokenCache: TestMemoryUsage;
+    totalBytes: number;
+    peakBytes: number;
+  };
   logout: () => void;
   login: (
     provider: "google" | "apple" | "microsoft",
@@ -33,7 +59,10 @@ type TestAuthModule = {
       expirationTime?: number;
     }) => void,
   ) => () => void;
-  getAccessToken: () => Promise<string | undefined>;
+  getAccessToken: (request?: {
+    resource?: string;
+    scopes?: string[];
+  }) => Promise<string | undefined>;
   refreshToken: () => Promise<{
     accessToken?: string;
     idToken?: string;
@@ -173,6 +202,67 @@ describe("AuthModule (web)", () => {
     expect(localStorage.getItem(MS_REFRESH_TOKEN_KEY)).toBeNull();
   });
 
+  it("returns a versioned session snapshot", async () => {
+    const expirationTime = Date.now() + 60_000;
+    localStorage.setItem(
+      CACHE_KEY,
+      JSON.stringify({
+        provider: "google",
+        email: "test@example.com",
+        accessToken: "persisted-access-token",
+        expirationTime,
+      }),
+    );
+    localStorage.setItem(SCOPES_KEY, JSON.stringify(["openid"]));
+
+    const auth = await loadAuthModule({
+      nitroAuthWebStorage: "local",
+      nitroAuthPersistTokensOnWeb: true,
+    });
+
+    const snapshot = auth.getSessionSnapshot();
+    expect(snapshot.user).toBe(auth.currentUser);
+    expect(snapshot.scopes).toEqual(["openid"]);
+    expect(snapshot.hasValidAccessToken).toBe(true);
+    expect(snapshot.accessTokenExpiresIn).toBeGreaterThan(0);
+    expect(snapshot.accessTokenExpiresIn).toBeLessThanOrEqual(60_000);
+    expect(auth.getSessionSnapshot().version).toBe(snapshot.version);
+
+    expect(auth.sessionVersion).toBe(snapshot.version);
+    expect(auth.getCurrentUserIfChanged(snapshot.version)).toBeUndefined();
+
+    auth.logout();
+    const signedOut = auth.getSessionSnapshot();
+    expect(signedOut.version).toBeGreaterThan(snapshot.version);
+    expect(signedOut.user).toBeUndefined();
+    expect(signedOut.hasValidAccessToken).toBe(false);
+    expect(auth.getCurrentUserIfChanged(snapshot.version)).toEqual({
+      version: signedOut.version,
+    });
+  });
+
+  it("reports memory stats as counts", async () => {
+    localStorage.setItem(
+      CACHE_KEY,
+      JSON.stringify({ provider: "google", email: "test@example.com" }),
+    );
+    const auth = await loadAuthModule({ nitroAuthWebStorage: "local" });
+
+    const before = auth.getMemoryStats();
+    expect(before.sessions.allocations).toBe(1);
+    const unsubscribe = auth.onAuthStateChanged(() => {});
+    expect(auth.getMemoryStats().listeners.allocations).toBe(
+      before.listeners.allocations + 1,
+    );
+    unsubscribe();
+
+    auth.logout();
+    const after = auth.getMemoryStats();
+    expect(after.sessions.allocations).toBe(0);
+    expect(after.listeners).toEqual(before.listeners);
+    expect(after.totalBytes).toBe(0);
+  });
+
   it("keeps persisted tokens when explicitly enabled", async () => {
     localStorage.setItem(
       CACHE_KEY,
@@ -366,6 +456,65 @@ describe("AuthModule (web)", () => {
     expect(fetchMock).toHaveBeenCalledTimes(1);
   });
 
+  it("caches resource tokens per scope set without touching the session", async () => {
+    localStorage.setItem(
+      CACHE_KEY,
+      JSON.stringify({
+        provider: "microsoft",
+        email: "user@example.com",
+        accessToken: "session-token",
+        expirationTime: Date.now() + 3_600_000,
+      }),
+    );
+    localStorage.setItem(MS_REFRESH_TOKEN_KEY, "refresh-token");
+
+    const auth = await loadAuthModule({
+      nitroAuthWebStorage: "local",
+      nitroAuthPersistTokensOnWeb: true,
+      microsoftClientId: "test-client-id",
+    });
+
+    const fetchMock = jest.fn(
+      async (_url: string, init?: RequestInit) =>
+        ({
+          ok: true,
+          json: async () => ({
+            access_token: `token:${new URLSearchParams(
+              String(init?.body),
+            ).get("scope")}`,
+            expires_in: 3600,
+          }),
+        }) as Response,
+    );
+    Object.defineProperty(globalThis, "fetch", {
+      configurable: true,
+      writable: true,
+      value: fetchMock,
+    });
+
+    const graph = {
+      resource: "https://graph.microsoft.com/",
+      scopes: ["Mail.Read"],
+    };
+    const [first, second] = await Promise.all([
+      auth.getAccessToken(graph),
+      auth.getAccessToken(graph),
+    ]);
+    expect(first).toBe(
+      "token:https://graph.microsoft.com/Mail.Read offline_access",
+    );
+    expect(second).toBe(first);
+    expect(await auth.getAccessToken(graph)).toBe(first);
+    expect(fetchMock).toHaveBeenCalledTimes(1);
+
+    expect(await auth.getAccessToken({ resource: "api://custom" })).toBe(
+      "token:api://custom/.default offline_access",
+    );
+    expect(fetchMock).toHaveBeenCalledTimes(2);
+    expect(await auth.getAccessToken()).toBe("session-token");
+    expect(auth.currentUser?.accessToken).toBe("session-token");
+  });
+
   it("keeps token listener notifications stable while listeners unsubscribe", async () => {
     const expSoon = Date.now() + 60_000;
 
@@ -22,4 +22,13 @@ describe("Expo config plugin", () => {
       { name: "RecaptchaInterop", modular_headers: true },
     ]);
   });
+
+  it("routes the OIDC redirect scheme to the redirect activity", () => {
+    const activity = _internal.getOidcRedirectActivity("com.example.app");
+
+    expect(activity.$["android:name"]).toBe("com.auth.OidcRedirectActivity");
+    expect(activity["intent-filter"][0].data).toEqual([
+      { $: { "android:scheme": "com.example.app" } },
+    ]);
+  });
 });
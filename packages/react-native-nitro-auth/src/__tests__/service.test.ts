@@ -2,7 +2,7 @@ import { NitroModules } from "react-native-nitro-modules";
 import { createAuthService } from "../create-auth-service";
 import { AuthService } from "../service";
 import { AuthError } from "../utils/auth-error";
-import type { AuthTokens, AuthUser } from "../Auth.nitro";
+import type { AuthAccount, AuthTokens, AuthUser } from "../Auth.nitro";
 
 let mockCurrentUser: AuthUser | undefined;
 const mockGetCurrentUser = jest.fn(() => mockCurrentUser);
@@ -13,6 +13,11 @@ type MockHybridObject = {
   readonly currentUser: AuthUser | undefined;
   grantedScopes: string[];
   hasPlayServices: boolean;
+  accounts: AuthAccount[];
+  sessionVersion: number;
+  getSessionSnapshot: jest.Mock;
+  getCurrentUserIfChanged: jest.Mock;
+  getMemoryStats: jest.Mock;
   login: jest.Mock;
   logout: jest.Mock;
   requestScopes: jest.Mock;
@@ -20,6 +25,8 @@ type MockHybridObject = {
   revokeAccess: jest.Mock;
   getAccessToken: jest.Mock;
   refreshToken: jest.Mock;
+  switchAccount: jest.Mock;
+  getAccessTokenForAccount: jest.Mock;
   onAuthStateChanged: jest.Mock;
   onTokensRefreshed: jest.Mock;
   silentRestore: jest.Mock;
@@ -41,6 +48,11 @@ jest.mock("react-native-nitro-modules", () => {
     },
     grantedScopes: [],
     hasPlayServices: true,
+    accounts: [],
+    sessionVersion: 0,
+    getSessionSnapshot: jest.fn(),
+    getCurrentUserIfChanged: jest.fn(),
+    getMemoryStats: jest.fn(),
     login: jest.fn(),
     logout: jest.fn(),
     requestScopes: jest.fn(),
@@ -48,6 +60,8 @@ jest.mock("react-native-nitro-modules", () => {
     revokeAccess: jest.fn(),
     getAccessToken: jest.fn(),
     refreshToken: jest.fn(),
+    switchAccount: jest.fn(),
+    getAccessTokenForAccount: jest.fn(),
     silentRestore: jest.fn(),
     onAuthStateChanged: jest.fn(
       (callback: (user: AuthUser | undefined) => void) => {
@@ -98,6 +112,8 @@ describe("AuthService", () => {
       hybridObject.revokeAccess.mockReset();
       hybridObject.getAccessToken.mockReset();
       hybridObject.refreshToken.mockReset();
+      hybridObject.switchAccount.mockReset();
+      hybridObject.getAccessTokenForAccount.mockReset();
       hybridObject.silentRestore.mockReset();
       hybridObject.onAuthStateChanged.mockReset();
       hybridObject.onTokensRefreshed.mockReset();
@@ -201,6 +217,26 @@ describe("AuthService", () => {
       expect((error as AuthError).code).toBe("refresh_failed");
     });
 
+    it("getAccessTokenForAccount wraps native error in AuthError", async () => {
+      native().getAccessTokenForAccount.mockRejectedValueOnce(
+        new Error("not_signed_in"),
+      );
+      const error = await AuthService.getAccessTokenForAccount(
+        "google:missing",
+      ).catch((e: unknown) => e);
+      expect(error).toBeInstanceOf(AuthError);
+      expect((error as AuthError).code).toBe("not_signed_in");
+    });
+
+    it("switchAccount wraps native error in AuthError", () => {
+      native().switchAccount.mockImplementationOnce(() => {
+        throw new Error("not_signed_in");
+      });
+      expect(() => AuthService.switchAccount("google:missing")).toThrow(
+        AuthError,
+      );
+    });
+
     it("silentRestore wraps native error in AuthError", async () => {
       native().silentRestore.mockRejectedValueOnce(
         new Error("configuration_error"),
@@ -348,6 +384,69 @@ describe("AuthService", () => {
     expect(auth.equals).toHaveBeenCalledWith(auth);
   });
 
+  it("reads the lazy user view when native provides it", () => {
+    const auth = native();
+    const view: AuthUser = { provider: "google", email: "view@example.com" };
+    const withView = {
+      ...auth,
+      getCurrentUserView: jest.fn(() => view),
+    } as unknown as MockHybridObject;
+
+    expect(createAuthService(() => withView).currentUserView).toBe(view);
+
+    mockCurrentUser = { provider: "apple", email: "eager@example.com" };
+    expect(createAuthService(() => auth).currentUserView).toEqual(
+      mockCurrentUser,
+    );
+  });
+
+  it("reads the session snapshot in one native call", () => {
+    const auth = native();
+    const snapshot = {
+      user: { provider: "google", email: "snap@example.com" },
+      scopes: ["email"],
+      hasValidAccessToken: true,
+      accessTokenExpiresIn: 1000,
+      version: 3,
+    };
+    auth.getSessionSnapshot.mockReturnValueOnce(snapshot);
+
+    expect(createAuthService(() => auth).getSessionSnapshot()).toBe(snapshot);
+    expect(auth.getSessionSnapshot).toHaveBeenCalledTimes(1);
+  });
+
+  it("forwards version-gated user polling", () => {
+    const auth = native();
+    auth.sessionVersion = 7;
+    const change = { user: { provider: "apple" }, version: 7 };
+    auth.getCurrentUserIfChanged
+      .mockReturnValueOnce(change)
+      .mockReturnValueOnce(undefined);
+    const service = createAuthService(() => auth);
+
+    expect(service.sessionVersion).toBe(7);
+    expect(service.getCurrentUserIfChanged(6)).toBe(change);
+    expect(service.getCurrentUserIfChanged(7)).toBeUndefined();
+    expect(auth.getCurrentUserIfChanged).toHaveBeenLastCalledWith(7);
+  });
+
+  it("forwards native memory stats", () => {
+    const auth = native();
+    const usage = { bytes: 64, allocations: 1, peakBytes: 128 };
+    const stats = {
+      sessions: usage,
+      listeners: usage,
+      pendingOperations: usage,
+      platformOperations: usage,
+      accessTokenCache: usage,
+      totalBytes: 320,
+      peakBytes: 640,
+    };
+    auth.getMemoryStats.mockReturnValueOnce(stats);
+
+    expect(createAuthService(() => auth).getMemoryStats()).toBe(stats);
+  });
+
   it("normalizes optional native members that older native builds may omit", () => {
     const auth = native();
     const partialAuth = {
@@ -14,6 +14,33 @@ import type {
 // Module-level mock state
 let mockCurrentUser: AuthUser | undefined = undefined;
 let mockScopes: string[] = [];
+let mockSnapshotCalls = 0;
+// Native converts the user again on every read.
+let mockConvertsUserPerRead = false;
+// Like native: the version moves whenever the user or scopes it last saw changed.
+let mockSession = {
+  user: undefined as AuthUser | undefined,
+  scopes: [] as string[],
+  version: 0,
+};
+function mockGetSessionSnapshot() {
+  mockSnapshotCalls += 1;
+  if (
+    mockSession.user !== mockCurrentUser ||
+    mockSession.scopes !== mockScopes
+  ) {
+    mockSession = {
+      user: mockCurrentUser,
+      scopes: mockScopes,
+      version: mockSession.version + 1,
+    };
+  }
+  const user =
+    mockConvertsUserPerRead && mockSession.user
+      ? { ...mockSession.user }
+      : mockSession.user;
+  return { ...mockSession, user, hasValidAccessToken: false };
+}
 
 type LoginFn = (
   provider: AuthProvider,
@@ -75,6 +102,7 @@ jest.mock("../service", () => ({
     get hasPlayServices() {
       return true;
     },
+    getSessionSnapshot: () => mockGetSessionSnapshot(),
     login: (...args: Parameters<LoginFn>) => mockLogin(...args),
     logout: (...args: []) => mockLogout(...args),
     requestScopes: (...args: Parameters<RequestScopesFn>) =>
@@ -99,6 +127,8 @@ describe("useAuth", () => {
   beforeEach(() => {
     mockCurrentUser = undefined;
     mockScopes = [];
+    mockSnapshotCalls = 0;
+    mockConvertsUserPerRead = false;
     mockLogin.mockReset();
     mockLogout.mockReset();
     mockRequestScopes.mockReset();
@@ -127,6 +157,39 @@ describe("useAuth", () => {
     expect(result.current.user).toEqual(user);
   });
 
+  it("reads user and scopes through one session snapshot", async () => {
+    const user: AuthUser = { provider: "google", email: "test@example.com" };
+    mockLogin.mockImplementation(async () => {
+      mockCurrentUser = user;
+      mockScopes = ["email"];
+    });
+    const { result } = renderHook(() => useAuth());
+    expect(mockSnapshotCalls).toBe(1);
+
+    await act(async () => {
+      await result.current.login("google");
+    });
+
+    expect(mockSnapshotCalls).toBe(2);
+    expect(result.current.user).toBe(user);
+    expect(result.current.scopes).toEqual(["email"]);
+  });
+
+  it("keeps user identity while the session version is unchanged", async () => {
+    mockCurrentUser = { provider: "google", email: "same@example.com" };
+    mockConvertsUserPerRead = true;
+    const { result } = renderHook(() => useAuth());
+    const initialUser = result.current.user;
+    mockRefreshToken.mockResolvedValue({ accessToken: "token" });
+
+    await act(async () => {
+      await result.current.refreshToken();
+    });
+
+    expect(result.current.user).toBe(initialUser);
+    expect(result.current.loading).toBe(false);
+  });
+
   it("should expose hasPlayServices", () => {
     const { result } = renderHook(() => useAuth());
     expect(result.current.hasPlayServices).toBe(true);
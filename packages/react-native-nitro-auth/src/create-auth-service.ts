@@ -1,4 +1,13 @@
-import type { Auth, AuthProvider, AuthTokens, AuthUser } from "./Auth.nitro";
+import type {
+  AccessTokenRequest,
+  Auth,
+  AuthProvider,
+  AuthTokens,
+  AuthUser,
+  DeviceAuthorization,
+  IdTokenVerificationOptions,
+  OidcProviderConfig,
+} from "./Auth.nitro";
 import type { ProviderLoginOptions, TypedAuth } from "./provider-options";
 import { AuthError } from "./utils/auth-error";
 
@@ -10,6 +19,7 @@ type AuthWithOptionalNativeMembers = Auth & {
   onTokensRefreshed?: (callback: (tokens: AuthTokens) => void) => () => void;
   revokeAccess?: () => Promise<void>;
   setLoggingEnabled?: (enabled: boolean) => void;
+  getCurrentUserView?: () => AuthUser | undefined;
 };
 
 async function wrapAuthOperation<T>(operation: () => Promise<T>): Promise<T> {
@@ -38,6 +48,15 @@ export function createAuthService(getAuth: AuthSource): TypedAuth {
       return wrapSyncAuthOperation(() => getAuth().currentUser);
     },
 
+    get currentUserView() {
+      return wrapSyncAuthOperation(() => {
+        const auth = getAuth() as AuthWithOptionalNativeMembers;
+        return auth.getCurrentUserView
+          ? auth.getCurrentUserView()
+          : auth.currentUser;
+      });
+    },
+
     get grantedScopes() {
       return wrapSyncAuthOperation(() => {
         const scopes = getAuth().grantedScopes;
@@ -49,6 +68,31 @@ export function createAuthService(getAuth: AuthSource): TypedAuth {
       return wrapSyncAuthOperation(() => getAuth().hasPlayServices);
     },
 
+    get accounts() {
+      return wrapSyncAuthOperation(() => {
+        const accounts = getAuth().accounts;
+        return Array.isArray(accounts) ? accounts : [];
+      });
+    },
+
+    get sessionVersion() {
+      return wrapSyncAuthOperation(() => getAuth().sessionVersion);
+    },
+
+    getSessionSnapshot() {
+      return wrapSyncAuthOperation(() => getAuth().getSessionSnapshot());
+    },
+
+    getCurrentUserIfChanged(sinceVersion: number) {
+      return wrapSyncAuthOperation(() =>
+        getAuth().getCurrentUserIfChanged(sinceVersion),
+      );
+    },
+
+    getMemoryStats() {
+      return wrapSyncAuthOperation(() => getAuth().getMemoryStats());
+    },
+
     login<Provider extends AuthProvider>(
       provider: Provider,
       options?: ProviderLoginOptions<Provider>,
@@ -75,14 +119,39 @@ export function createAuthService(getAuth: AuthSource): TypedAuth {
       });
     },
 
-    getAccessToken() {
-      return wrapAuthOperation(() => getAuth().getAccessToken());
+    getAccessToken(request?: AccessTokenRequest) {
+      return wrapAuthOperation(() => getAuth().getAccessToken(request));
     },
 
     refreshToken() {
       return wrapAuthOperation(() => getAuth().refreshToken());
     },
 
+    switchAccount(accountId: string) {
+      wrapSyncAuthOperation(() => {
+        getAuth().switchAccount(accountId);
+      });
+    },
+
+    getAccessTokenForAccount(
+      accountId: string,
+      request?: AccessTokenRequest,
+    ) {
+      return wrapAuthOperation(() =>
+        getAuth().getAccessTokenForAccount(accountId, request),
+      );
+    },
+
+    verifyIdToken(options: IdTokenVerificationOptions) {
+      return wrapAuthOperation(() => getAuth().verifyIdToken(options));
+    },
+
+    configureOidc(config: OidcProviderConfig) {
+      wrapSyncAuthOperation(() => {
+        getAuth().configureOidc(config);
+      });
+    },
+
     logout() {
       wrapSyncAuthOperation(() => {
         getAuth().logout();
@@ -107,6 +176,10 @@ export function createAuthService(getAuth: AuthSource): TypedAuth {
       });
     },
 
+    onDeviceCode(callback: (authorization: DeviceAuthorization) => void) {
+      return wrapSyncAuthOperation(() => getAuth().onDeviceCode(callback));
+    },
+
     setLoggingEnabled(enabled: boolean) {
       wrapSyncAuthOperation(() => {
         const auth = getAuth() as AuthWithOptionalNativeMembers;
@@ -1,4 +1,9 @@
-import type { Auth, AuthProvider, LoginOptions } from "./Auth.nitro";
+import type {
+  Auth,
+  AuthProvider,
+  AuthUser,
+  LoginOptions,
+} from "./Auth.nitro";
 
 type StrictLoginOptions<AllowedKeys extends keyof LoginOptions> = Pick<
   LoginOptions,
@@ -43,10 +48,15 @@ export type MicrosoftLoginOptions = StrictLoginOptions<
   "scopes" | "loginHint" | "tenant" | "prompt"
 >;
 
+export type OidcLoginOptions = StrictLoginOptions<
+  "scopes" | "loginHint" | "nonce" | "prompt" | "useDeviceCode"
+>;
+
 export type LoginOptionsByProvider = {
   google: GoogleLoginOptions;
   apple: AppleLoginOptions;
   microsoft: MicrosoftLoginOptions;
+  oidc: OidcLoginOptions;
 };
 
 export type ProviderLoginOptions<Provider extends AuthProvider> =
@@ -59,4 +69,10 @@ export type AuthLogin = <Provider extends AuthProvider>(
 
 export type TypedAuth = Omit<Auth, "login"> & {
   login: AuthLogin;
+  /**
+   * The current user as a read-only object whose fields are converted when
+   * first read. Unchanged sessions return views sharing one native object.
+   * Falls back to `currentUser` where the native view is unavailable.
+   */
+  readonly currentUserView: AuthUser | undefined;
 };
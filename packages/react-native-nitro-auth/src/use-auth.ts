@@ -17,6 +17,9 @@ type AuthState = {
   error: AuthError | undefined;
 };
 
+// `version` is the native session version `user` and `scopes` were read at.
+type HookState = AuthState & { version: number };
+
 const areScopesEqual = (left: string[], right: string[]): boolean => {
   if (left === right) return true;
   if (left.length !== right.length) return false;
@@ -52,32 +55,40 @@ export type UseAuthReturn = AuthState & {
 };
 
 export function useAuth(): UseAuthReturn {
-  const [state, setState] = useState<AuthState>({
-    user: AuthService.currentUser,
-    scopes: normalizeScopes(AuthService.grantedScopes),
-    loading: false,
-    error: undefined,
+  const [state, setState] = useState<HookState>(() => {
+    const session = AuthService.getSessionSnapshot();
+    return {
+      user: session.user,
+      scopes: normalizeScopes(session.scopes),
+      version: session.version,
+      loading: false,
+      error: undefined,
+    };
   });
 
   const syncStateFromService = useCallback(
     (nextLoading: boolean, nextError: AuthError | undefined) => {
-      const nextUser = AuthService.currentUser;
-      const nextScopes = normalizeScopes(AuthService.grantedScopes);
+      // One native call: user and scopes come from the same session state.
+      const session = AuthService.getSessionSnapshot();
+      const nextScopes = normalizeScopes(session.scopes);
       setState((prev) => {
-        if (
-          prev.loading === nextLoading &&
-          prev.error === nextError &&
-          prev.user === nextUser &&
-          areScopesEqual(prev.scopes, nextScopes)
-        ) {
+        const isSameSession =
+          prev.version === session.version ||
+          (prev.user === session.user &&
+            areScopesEqual(prev.scopes, nextScopes));
+        if (!isSameSession) {
+          return {
+            user: session.user,
+            scopes: nextScopes,
+            version: session.version,
+            loading: nextLoading,
+            error: nextError,
+          };
+        }
+        if (prev.loading === nextLoading && prev.error === nextError) {
           return prev;
         }
-        return {
-          user: nextUser,
-          scopes: nextScopes,
-          loading: nextLoading,
-          error: nextError,
-        };
+        return { ...prev, loading: nextLoading, error: nextError };
       });
     },
     [],
@@ -115,6 +126,7 @@ export function useAuth(): UseAuthReturn {
       return {
         user: undefined,
         scopes: EMPTY_SCOPES,
+        version: prev.version,
         loading: false,
         error: undefined,
       };
@@ -220,7 +232,10 @@ export function useAuth(): UseAuthReturn {
 
   return useMemo(
     () => ({
-      ...state,
+      user: state.user,
+      scopes: state.scopes,
+      loading: state.loading,
+      error: state.error,
       hasPlayServices: AuthService.hasPlayServices,
       login,
       logout,